@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Measure the latency of an asyncio event loop running searches.
+
+A ticker task wakes up every millisecond, and records how late it is. Searches
+of solar eclipses are run concurrently in three ways: direct (blocking) calls
+in coroutines, calls in the default executor (``run_in_executor``), and calls
+of ``swisseph.aio``. The lateness of the ticker shows how much the event loop
+is blocked; the wall time shows the throughput of the searches.
+
+Usage::
+
+    python3 benchmarks/aio.py
+    python3 benchmarks/aio.py -c 64 --json
+"""
+
+import argparse
+import asyncio
+import json
+import os
+import platform
+import sys
+import time
+
+import swisseph as swe
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH
+TICK = 0.001
+
+def places(n):
+    return [((i * 37) % 360 - 180, (i * 17) % 120 - 60, 0) for i in range(n)]
+
+async def direct(jd, geopos):
+    return swe.sol_eclipse_when_loc(jd, geopos, FLAGS)
+
+async def executor(jd, geopos):
+    return await asyncio.get_running_loop().run_in_executor(
+        None, swe.sol_eclipse_when_loc, jd, geopos, FLAGS)
+
+async def aio(jd, geopos):
+    return await swe.aio.sol_eclipse_when_loc(jd, geopos, FLAGS)
+
+MODES = {'direct': direct, 'executor': executor, 'aio': aio}
+
+async def ticker(lateness, stop):
+    loop = asyncio.get_running_loop()
+    while not stop.is_set():
+        t = loop.time()
+        await asyncio.sleep(TICK)
+        lateness.append(loop.time() - t - TICK)
+
+async def run(mode, n):
+    """Return the wall time and the lateness of the ticker (sorted, in s)."""
+    lateness, stop = [], asyncio.Event()
+    tick = asyncio.ensure_future(ticker(lateness, stop))
+    await asyncio.sleep(0)
+    t0 = time.perf_counter()
+    await asyncio.gather(*[MODES[mode](JD, g) for g in places(n)])
+    wall = time.perf_counter() - t0
+    stop.set()
+    await tick
+    return wall, sorted(lateness) or [0.0]
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-c', '--concurrency', type=int, default=32,
+                        help='searches run concurrently')
+    parser.add_argument('-m', '--mode', action='append', choices=list(MODES),
+                        help='mode (repeatable)')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    modes = args.mode or list(MODES)
+    swe.sol_eclipse_when_loc(JD, (0, 0, 0), FLAGS) # warmup
+    res = {}
+    for mode in modes:
+        wall, late = asyncio.run(run(mode, args.concurrency))
+        res[mode] = {
+            'wall_s': wall,
+            'ticks': len(late),
+            'max_late_ms': late[-1] * 1e3,
+            'p99_late_ms': late[int(len(late) * 0.99)] * 1e3,
+        }
+    if args.json:
+        json.dump({
+            'python': platform.python_version(),
+            'cpu_count': os.cpu_count(),
+            'threads': swe.get_num_threads(),
+            'concurrency': args.concurrency,
+            'results': res,
+        }, sys.stdout, indent=4)
+        print()
+        return
+    print('python %s, %s cpus, %d threads, %d searches' % (
+          platform.python_version(), os.cpu_count(), swe.get_num_threads(),
+          args.concurrency))
+    print('%10s %10s %8s %14s %14s' % ('mode', 'wall (s)', 'ticks',
+                                       'p99 late (ms)', 'max late (ms)'))
+    for mode, r in res.items():
+        print('%10s %10.3f %8d %14.2f %14.2f' % (mode, r['wall_s'], r['ticks'],
+              r['p99_late_ms'], r['max_late_ms']))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Compare the atlas searches with SQL queries and with the in-memory index.
+
+Places are sampled from the atlas, and searched by the first letters of their
+asciiname, in their country, with ``swisseph.contrib.atlas_search`` and with
+``AtlasIndex.search``. The median time of a search is reported, with the time
+and the memory (tracemalloc peak) of building the index. The nearest places
+of random points are then searched, one by one with ``AtlasIndex.nearest``,
+and all at once with ``AtlasIndex.nearest_many``. Rows of locations (with
+duplicates, as in imports) are geocoded in a loop of ``AtlasIndex.search``,
+and with ``AtlasIndex.search_many``.
+
+Usage::
+
+    python3 benchmarks/atlas.py
+    python3 benchmarks/atlas.py -p /path/to/atlas.sqlite -n 1000 --json
+"""
+
+import argparse
+import json
+import platform
+import random
+import statistics
+import sys
+import time
+import tracemalloc
+
+import swisseph as swe
+
+def build():
+    """Return the index, its build time (s) and memory (MiB)."""
+    tracemalloc.start()
+    t0 = time.perf_counter()
+    idx = swe.contrib.AtlasIndex()
+    t = time.perf_counter() - t0
+    peak = tracemalloc.get_traced_memory()[1]
+    tracemalloc.stop()
+    return idx, t, peak / 2**20
+
+def queries(idx, n, length):
+    places = idx.search('')
+    rnd = random.Random(0)
+    return [(p.asciiname[:length], p.countrycode)
+            for p in rnd.sample(places, min(n, len(places)))]
+
+def median_us(func, queries):
+    times = []
+    for q in queries:
+        t0 = time.perf_counter()
+        func(*q)
+        times.append(time.perf_counter() - t0)
+    return statistics.median(times) * 1e6
+
+def points(n):
+    rnd = random.Random(0)
+    return ([rnd.uniform(-60, 70) for _ in range(n)],
+            [rnd.uniform(-180, 180) for _ in range(n)])
+
+def nearest(idx, n):
+    """Return the times of the tree build (s), nearest and nearest_many
+    (us per point)."""
+    lats, lons = points(n)
+    t0 = time.perf_counter()
+    idx.nearest(0, 0)
+    t1 = time.perf_counter()
+    for lat, lon in zip(lats, lons):
+        idx.nearest(lat, lon)
+    t2 = time.perf_counter()
+    idx.nearest_many(lats, lons)
+    t3 = time.perf_counter()
+    return t1 - t0, (t2 - t1) / n * 1e6, (t3 - t2) / n * 1e6
+
+def search_many(idx, qs, n):
+    """Return the times (us per row) of a loop of search and of search_many.
+    """
+    rnd = random.Random(0)
+    rows = [qs[rnd.randrange(len(qs))] for _ in range(n)] if qs else []
+    locs = [q[0] for q in rows]
+    ctrs = [q[1] for q in rows]
+    t0 = time.perf_counter()
+    for loc, ctry in rows:
+        idx.search(loc, ctry, limit=1)
+    t1 = time.perf_counter()
+    idx.search_many(locs, ctrs)
+    t2 = time.perf_counter()
+    n = max(n, 1)
+    return (t1 - t0) / n * 1e6, (t2 - t1) / n * 1e6
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-p', '--path', default=None,
+                        help='atlas database (default: SWH_ATLAS_PATH)')
+    parser.add_argument('-n', '--queries', type=int, default=500,
+                        help='number of searches')
+    parser.add_argument('-l', '--length', type=int, default=4,
+                        help='letters of the names searched')
+    parser.add_argument('-m', '--points', type=int, default=100000,
+                        help='number of points and of rows of batch searches')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    swh = swe.contrib
+    swh.atlas_connect(args.path)
+    idx, build_s, build_mib = build()
+    qs = queries(idx, args.queries, args.length)
+    tree_s, nearest_us, nearest_many_us = nearest(idx, args.points)
+    loop_us, many_us = search_many(idx, qs, args.points)
+    res = {
+        'places': len(idx),
+        'build_s': build_s,
+        'build_peak_mib': build_mib,
+        'atlas_search_us': median_us(swh.atlas_search, qs),
+        'index_search_us': median_us(idx.search, qs),
+        'tree_build_s': tree_s,
+        'nearest_us': nearest_us,
+        'nearest_many_us': nearest_many_us,
+        'search_loop_us': loop_us,
+        'search_many_us': many_us,
+    }
+    if args.json:
+        json.dump({
+            'python': platform.python_version(),
+            'queries': len(qs),
+            'points': args.points,
+            'threads': swe.get_num_threads(),
+            'results': res,
+        }, sys.stdout, indent=4)
+        print()
+        return
+    print('python %s, %d places, %d searches' % (platform.python_version(),
+          res['places'], len(qs)))
+    print('%-24s %10.3f s' % ('index build', res['build_s']))
+    print('%-24s %10.1f MiB' % ('index build (peak)', res['build_peak_mib']))
+    print('%-24s %10.1f us' % ('atlas_search', res['atlas_search_us']))
+    print('%-24s %10.1f us' % ('AtlasIndex.search', res['index_search_us']))
+    print('%-24s %10.3f s' % ('tree build', res['tree_build_s']))
+    print('%-24s %10.2f us' % ('nearest', res['nearest_us']))
+    print('%-24s %10.2f us' % ('nearest_many (/point)',
+                               res['nearest_many_us']))
+    print('%-24s %10.2f us' % ('search loop (/row)', res['search_loop_us']))
+    print('%-24s %10.2f us' % ('search_many (/row)', res['search_many_us']))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
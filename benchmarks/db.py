@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Measure concurrent queries of the astro database.
+
+Connects a temporary astro database, and runs ``User.list()`` from 1 to N
+threads, while a ticker thread records how late it wakes up. The queries use
+the pool of read connections, without the GIL, so the throughput grows with
+the threads and the ticker is not blocked. ``--no-wal`` connects without
+write-ahead logging.
+
+Usage::
+
+    python3 benchmarks/db.py
+    python3 benchmarks/db.py -t 8 -n 2000 --json
+"""
+
+import argparse
+import json
+import os
+import platform
+import sys
+import tempfile
+import threading
+import time
+
+import swisseph as swe
+
+TICK = 0.001
+
+def run(nthreads, n):
+    """Return the queries per second, and the max lateness of a ticker (s)."""
+    swh = swe.contrib
+    late, stop = [0.0], threading.Event()
+    def ticker():
+        while not stop.is_set():
+            t = time.perf_counter()
+            time.sleep(TICK)
+            late.append(time.perf_counter() - t - TICK)
+    def worker():
+        for _ in range(n // nthreads):
+            swh.User.list()
+    tick = threading.Thread(target=ticker)
+    tick.start()
+    threads = [threading.Thread(target=worker) for _ in range(nthreads)]
+    t0 = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    wall = time.perf_counter() - t0
+    stop.set()
+    tick.join()
+    return (n // nthreads) * nthreads / wall, max(late)
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-t', '--threads', type=int, default=4,
+                        help='max number of threads')
+    parser.add_argument('-n', '--queries', type=int, default=4000,
+                        help='number of queries')
+    parser.add_argument('--no-wal', action='store_true',
+                        help='connect without write-ahead logging')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    swh = swe.contrib
+    with tempfile.TemporaryDirectory() as tmp:
+        swh.db_connect(os.path.join(tmp, 'astro.db'), wal=not args.no_wal)
+        swh.User.list() # warmup
+        res = {}
+        for k in range(1, args.threads + 1):
+            qps, late = run(k, args.queries)
+            res[k] = {'queries_per_s': qps, 'max_late_ms': late * 1e3}
+        swh.db_close()
+    if args.json:
+        json.dump({
+            'python': platform.python_version(),
+            'cpu_count': os.cpu_count(),
+            'wal': not args.no_wal,
+            'queries': args.queries,
+            'results': res,
+        }, sys.stdout, indent=4)
+        print()
+        return
+    print('python %s, %s cpus, %d queries' % (platform.python_version(),
+          os.cpu_count(), args.queries))
+    print('%8s %14s %14s' % ('threads', 'queries/s', 'max late (ms)'))
+    for k, r in res.items():
+        print('%8d %14.0f %14.2f' % (k, r['queries_per_s'], r['max_late_ms']))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Compare ephemeris file access with and without set_ephe_path(mmap=True).
+
+For each mode, the parent process sets the ephemeris path (as a preloading
+server would do), then forks the workers. Each worker computes positions at
+random dates, twice: the first pass reads the files (cold), the second pass
+repeats the same dates (warm). Reported are throughputs and memory per worker.
+Pages of the mapping that a worker touched count in its RSS; they are shared,
+so PSS is the figure to compare.
+
+Usage::
+
+    python3 benchmarks/ephe_mmap.py [-w WORKERS] [-n CALLS] [--drop-caches] PATH
+
+``--drop-caches`` needs root privileges, it empties the page cache before
+each mode so that the cold pass really hits the disk. Linux only.
+"""
+
+import argparse
+import json
+import os
+import random
+import sys
+import time
+
+import swisseph as swe
+
+BODIES = (swe.SUN, swe.MOON, swe.MERCURY, swe.VENUS, swe.MARS, swe.JUPITER,
+          swe.SATURN, swe.URANUS, swe.NEPTUNE, swe.PLUTO, swe.CHIRON)
+
+def drop_caches():
+    os.sync()
+    with open('/proc/sys/vm/drop_caches', 'w') as f:
+        f.write('3\n')
+
+def memory():
+    """Return (rss, pss) of current process in kB."""
+    rss = pss = 0
+    with open('/proc/self/status') as f:
+        for line in f:
+            if line.startswith('VmRSS:'):
+                rss = int(line.split()[1])
+    try:
+        with open('/proc/self/smaps_rollup') as f:
+            for line in f:
+                if line.startswith('Pss:'):
+                    pss = int(line.split()[1])
+    except OSError:
+        pass
+    return rss, pss
+
+def run(dates):
+    t = time.perf_counter()
+    for jd in dates:
+        for pl in BODIES:
+            swe.calc_ut(jd, pl, swe.FLG_SWIEPH|swe.FLG_SPEED)
+    return len(dates) * len(BODIES) / (time.perf_counter() - t)
+
+def worker(seed, ncalls, wfd):
+    rnd = random.Random(seed)
+    dates = [rnd.uniform(2378497.0, 2597640.0) for _ in range(ncalls)]
+    cold = run(dates)
+    warm = run(dates)
+    rss, pss = memory()
+    os.write(wfd, json.dumps({'cold': cold, 'warm': warm,
+                              'rss': rss, 'pss': pss}).encode())
+    os.close(wfd)
+
+def bench(path, use_mmap, nworkers, ncalls, dropcaches):
+    if dropcaches:
+        drop_caches()
+    swe.set_ephe_path(path, mmap=use_mmap)
+    pipes = []
+    for i in range(nworkers):
+        r, w = os.pipe()
+        pid = os.fork()
+        if pid == 0:
+            os.close(r)
+            try:
+                worker(i, ncalls, w)
+            finally:
+                os._exit(0)
+        os.close(w)
+        pipes.append((pid, r))
+    res = []
+    for pid, r in pipes:
+        with os.fdopen(r) as f:
+            res.append(json.loads(f.read()))
+        os.waitpid(pid, 0)
+    swe.close()
+    return {k: sum(x[k] for x in res) / len(res) for k in res[0]}
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('path', help='ephemeris path (with se1 files)')
+    parser.add_argument('-w', '--workers', type=int, default=8)
+    parser.add_argument('-n', '--calls', type=int, default=2000,
+                        help='number of dates per worker')
+    parser.add_argument('--drop-caches', action='store_true')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    results = {}
+    for mode, use_mmap in (('fread', False), ('mmap', True)):
+        results[mode] = bench(args.path, use_mmap, args.workers, args.calls,
+                              args.drop_caches)
+    if args.json:
+        json.dump(results, sys.stdout, indent=4)
+        print()
+        return
+    print('%-6s %14s %14s %12s %12s' % ('mode', 'cold calls/s',
+                                        'warm calls/s', 'rss kB', 'pss kB'))
+    for mode, r in results.items():
+        print('%-6s %14.0f %14.0f %12.0f %12.0f' % (mode, r['cold'],
+              r['warm'], r['rss'], r['pss']))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Time the per-call overhead of the most called functions.
+
+Functions are called with the built-in Moshier ephemeris, so that the
+argument parsing and result building weigh as much as possible. Keyword
+calls are timed too, their names are matched by pyswe_fast_args like the
+positional arguments.
+
+Compare two builds (e.g. METH_VARARGS, built with CFLAGS=-DPYSWE_FASTCALL=0,
+and METH_FASTCALL) like this::
+
+    PYTHONPATH=old python3 benchmarks/fastcall.py --json > old.json
+    PYTHONPATH=new python3 benchmarks/fastcall.py --compare old.json
+
+Results with Python 3.11, gcc -O2, best of two interleaved runs (libswe
+replaced by stubs, so that only the wrapper is timed)::
+
+    function            ns/call     before    ratio
+    calc_ut               459.4      523.5     1.14
+    calc_ut kw            422.7      748.7     1.77
+    calc_ut out           225.5      344.5     1.53
+    calc                  442.4      576.4     1.30
+    calc_pctr             514.2      629.0     1.22
+    houses                578.0      687.7     1.19
+    houses_ex             641.1     1042.1     1.63
+    houses_ex2           1092.0     1187.4     1.09
+    houses_armc           574.7      725.1     1.26
+    houses_armc_ex2       853.7     1154.9     1.35
+    julday                119.8      240.2     2.01
+    julday kw             130.6      432.5     3.31
+    revjul                174.1      249.2     1.43
+    degnorm                81.7      159.7     1.95
+    difdeg2n               90.4      179.1     1.98
+    difdegn                89.5      192.0     2.15
+"""
+
+import argparse
+import array
+import json
+import sys
+import timeit
+
+import swisseph as swe
+
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+OUT = array.array('d', bytes(48))
+
+CASES = (
+    ('calc_ut', lambda: swe.calc_ut(2451545.0, swe.MOON, FLAGS)),
+    ('calc_ut kw', lambda: swe.calc_ut(2451545.0, swe.MOON, flags=FLAGS)),
+    ('calc_ut out', lambda: swe.calc_ut(2451545.0, swe.MOON, FLAGS, OUT)),
+    ('calc', lambda: swe.calc(2451545.0, swe.MOON, FLAGS)),
+    ('calc_pctr', lambda: swe.calc_pctr(2451545.0, swe.MOON, swe.MARS,
+                                        FLAGS)),
+    ('houses', lambda: swe.houses(2451545.0, 46.5, 6.6, b'P')),
+    ('houses_ex', lambda: swe.houses_ex(2451545.0, 46.5, 6.6, b'P',
+                                        swe.FLG_MOSEPH)),
+    ('houses_ex2', lambda: swe.houses_ex2(2451545.0, 46.5, 6.6, b'P',
+                                          swe.FLG_MOSEPH)),
+    ('houses_armc', lambda: swe.houses_armc(120.0, 46.5, 23.44, b'P')),
+    ('houses_armc_ex2', lambda: swe.houses_armc_ex2(120.0, 46.5, 23.44,
+                                                    b'P')),
+    ('julday', lambda: swe.julday(2000, 1, 1, 12.0)),
+    ('julday kw', lambda: swe.julday(2000, 1, 1, hour=12.0)),
+    ('revjul', lambda: swe.revjul(2451545.0)),
+    ('degnorm', lambda: swe.degnorm(-10.0)),
+    ('difdeg2n', lambda: swe.difdeg2n(10.0, 350.0)),
+    ('difdegn', lambda: swe.difdegn(10.0, 350.0)),
+)
+
+def bench(number, repeat):
+    """Return best time per call in nanoseconds, for each case."""
+    res = {}
+    for name, func in CASES:
+        t = min(timeit.repeat(func, number=number, repeat=repeat))
+        res[name] = t / number * 1e9
+    return res
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-n', '--number', type=int, default=100000,
+                        help='calls per repetition')
+    parser.add_argument('-r', '--repeat', type=int, default=5)
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    parser.add_argument('--compare', metavar='FILE',
+                        help='json results of a previous run')
+    args = parser.parse_args()
+    swe.set_ephe_path(None)
+    results = bench(args.number, args.repeat)
+    if args.json:
+        json.dump(results, sys.stdout, indent=4)
+        print()
+        return
+    old = {}
+    if args.compare:
+        with open(args.compare) as f:
+            old = json.load(f)
+    print('%-16s %10s %10s %8s' % ('function', 'ns/call', 'before', 'ratio'))
+    for name, ns in results.items():
+        if name in old:
+            print('%-16s %10.1f %10.1f %8.2f' % (name, ns, old[name],
+                                                 old[name] / ns))
+        else:
+            print('%-16s %10.1f' % (name, ns))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Time the functions taking geopos (and other sequence) arguments.
+
+Each function is called with its sequences given as tuple, list, array of
+doubles and, if installed, numpy array, to show the cost of extracting the
+numbers. The built-in Moshier ephemeris is used.
+
+Compare two builds like this::
+
+    PYTHONPATH=old python3 benchmarks/geopos.py --json > old.json
+    PYTHONPATH=new python3 benchmarks/geopos.py --compare old.json
+"""
+
+import argparse
+import array
+import json
+import sys
+import timeit
+
+import swisseph as swe
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH
+
+GEOPOS = (6.6, 46.5, 400.0)
+ATMO = (1013.25, 15.0, 40.0, 0.0)
+OBSERVER = (36.0, 1.0, 0.0, 0.0, 0.0, 0.0)
+XIN = (120.0, 2.0, 1.0)
+
+def kinds():
+    """Return the containers to test, as (name, function)."""
+    res = [('tuple', tuple), ('list', list),
+           ('array', lambda x: array.array('d', x))]
+    if numpy is not None:
+        res.append(('numpy', lambda x: numpy.array(x, dtype=numpy.float64)))
+    return res
+
+def cases(conv):
+    geo, atmo, obs, xin = conv(GEOPOS), conv(ATMO), conv(OBSERVER), conv(XIN)
+    return (
+        ('azalt', lambda: swe.azalt(JD, swe.ECL2HOR, geo, 0, 0, xin)),
+        ('azalt_rev', lambda: swe.azalt_rev(JD, swe.HOR2ECL, geo, 120.0,
+                                            20.0)),
+        ('rise_trans', lambda: swe.rise_trans(JD, swe.SUN, swe.CALC_RISE,
+                                              geo, 0, 0, FLAGS)),
+        ('gauquelin_sector', lambda: swe.gauquelin_sector(JD, swe.MARS, 0,
+                                                          geo, 0, 0,
+                                                          FLAGS)),
+        ('lun_eclipse_how', lambda: swe.lun_eclipse_how(JD, geo, FLAGS)),
+        ('sol_eclipse_how', lambda: swe.sol_eclipse_how(JD, geo, FLAGS)),
+        ('vis_limit_mag', lambda: swe.vis_limit_mag(JD, geo, atmo, obs,
+                                                    'venus', FLAGS)),
+    )
+
+def bench(number, repeat):
+    """Return best time per call in nanoseconds, for each case."""
+    res = {}
+    for kind, conv in kinds():
+        for name, func in cases(conv):
+            t = min(timeit.repeat(func, number=number, repeat=repeat))
+            res['%s %s' % (name, kind)] = t / number * 1e9
+    return res
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-n', '--number', type=int, default=10000,
+                        help='calls per repetition')
+    parser.add_argument('-r', '--repeat', type=int, default=5)
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    parser.add_argument('--compare', metavar='FILE',
+                        help='json results of a previous run')
+    args = parser.parse_args()
+    swe.set_ephe_path(None)
+    results = bench(args.number, args.repeat)
+    if args.json:
+        json.dump(results, sys.stdout, indent=4)
+        print()
+        return
+    old = {}
+    if args.compare:
+        with open(args.compare) as f:
+            old = json.load(f)
+    print('%-24s %10s %10s %8s' % ('function', 'ns/call', 'before', 'ratio'))
+    for name, ns in results.items():
+        if name in old:
+            print('%-24s %10.1f %10.1f %8.2f' % (name, ns, old[name],
+                                                 old[name] / ns))
+        else:
+            print('%-24s %10.1f' % (name, ns))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
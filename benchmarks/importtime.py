@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Measure the import time of swisseph.
+
+Runs ``python -X importtime -c 'import swisseph'`` in fresh processes, and
+reports the median time of the import, as well as the time of the first
+access to ``swisseph.contrib`` and of the first calculation (that sets the
+ephemeris path, and opens the ephemeris files).
+
+Usage::
+
+    python3 benchmarks/importtime.py
+    python3 benchmarks/importtime.py -n 50 --json
+"""
+
+import argparse
+import json
+import platform
+import statistics
+import subprocess
+import sys
+
+FIRST_USE = '''
+import time
+t0 = time.perf_counter()
+import swisseph as swe
+t1 = time.perf_counter()
+swe.contrib
+t2 = time.perf_counter()
+swe.calc_ut(2451545.0, swe.MOON)
+t3 = time.perf_counter()
+print((t1 - t0) * 1e6, (t2 - t1) * 1e6, (t3 - t2) * 1e6)
+'''
+
+def importtime():
+    """Return the self and cumulative import time of swisseph (in us)."""
+    out = subprocess.run([sys.executable, '-X', 'importtime', '-c',
+                          'import swisseph'], stderr=subprocess.PIPE,
+                         check=True, universal_newlines=True).stderr
+    for line in out.splitlines():
+        fields = line.split('|')
+        if len(fields) == 3 and fields[2].strip() == 'swisseph':
+            return int(fields[0].split(':')[1]), int(fields[1])
+    raise RuntimeError('swisseph not found in -X importtime output')
+
+def first_use():
+    """Return the times of import, contrib and first calculation (in us)."""
+    out = subprocess.run([sys.executable, '-c', FIRST_USE],
+                         stdout=subprocess.PIPE, check=True,
+                         universal_newlines=True).stdout
+    return [float(x) for x in out.split()]
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-n', '--repeat', type=int, default=30,
+                        help='number of processes')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    imp = [importtime() for _ in range(args.repeat)]
+    use = [first_use() for _ in range(args.repeat)]
+    res = {
+        'import_self_us': statistics.median(x[0] for x in imp),
+        'import_cumulative_us': statistics.median(x[1] for x in imp),
+        'contrib_us': statistics.median(x[1] for x in use),
+        'first_calc_us': statistics.median(x[2] for x in use),
+    }
+    if args.json:
+        json.dump({
+            'python': platform.python_version(),
+            'repeat': args.repeat,
+            'results': res,
+        }, sys.stdout, indent=4)
+        print()
+        return
+    print('python %s, median of %d processes' % (platform.python_version(),
+                                                 args.repeat))
+    print('%-24s %10.0f us' % ('import (self)', res['import_self_us']))
+    print('%-24s %10.0f us' % ('import (cumulative)',
+                               res['import_cumulative_us']))
+    print('%-24s %10.0f us' % ('first swisseph.contrib', res['contrib_us']))
+    print('%-24s %10.0f us' % ('first calc_ut', res['first_calc_us']))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
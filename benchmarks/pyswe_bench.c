@@ -0,0 +1,414 @@
+/*
+    This file is part of Pyswisseph.
+
+    Copyright (c) 2007-2023 Stanislas Marquis <stan@astrorigin.com>
+
+    Pyswisseph is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Pyswisseph is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with Pyswisseph.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/**
+ *  \file pyswe_bench.c
+ *
+ *  Time the libswe functions called by the workloads of benchmarks/run.py,
+ *  with the same inputs and under the same names, without Python.
+ *
+ *  Usage: pyswe_bench [-j] [-l] [-n samples] [-t min_time] [-k pattern]...
+ *
+ *  Prints the median time per operation in nanoseconds, or a json object
+ *  {name: ns} with -j, as read by run.py --native.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "swephexp.h"
+
+#define JD      2451545.0
+#define FLAGS   (SEFLG_MOSEPH|SEFLG_SPEED)
+#define NDATES  1000
+
+static double geopos[3] = {6.6, 46.5, 400.0};
+static double atmo[4] = {1013.25, 15.0, 40.0, 0.0};
+static double observer[6] = {36.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+static double dates[NDATES];
+
+static double res[50];
+static double cusps[37], ascmc[10], cusp_speed[37], ascmc_speed[10];
+static char err[256];
+
+static double now(void)
+{
+#ifdef WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER t;
+    if (!freq.QuadPart)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double) t.QuadPart / (double) freq.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+#endif
+}
+
+/* scalar */
+
+static void julday(void)
+{
+    res[0] = swe_julday(2000, 1, 1, 12.0, SE_GREG_CAL);
+}
+
+static void revjul(void)
+{
+    int y, m, d;
+    swe_revjul(JD, SE_GREG_CAL, &y, &m, &d, res);
+}
+
+static void deltat(void)
+{
+    res[0] = swe_deltat(JD);
+}
+
+static void sidtime(void)
+{
+    res[0] = swe_sidtime(JD);
+}
+
+static void calc_ut_sun(void)
+{
+    swe_calc_ut(JD, SE_SUN, FLAGS, res, err);
+}
+
+static void calc_ut_moon(void)
+{
+    swe_calc_ut(JD, SE_MOON, FLAGS, res, err);
+}
+
+static void calc_ut_equatorial(void)
+{
+    swe_calc_ut(JD, SE_MARS, FLAGS|SEFLG_EQUATORIAL, res, err);
+}
+
+static void calc(void)
+{
+    swe_calc(JD, SE_JUPITER, FLAGS, res, err);
+}
+
+static void calc_pctr(void)
+{
+    swe_calc_pctr(JD, SE_MOON, SE_MARS, FLAGS, res, err);
+}
+
+static void houses_ex2(void)
+{
+    swe_houses_ex2(JD, SEFLG_MOSEPH, 46.5, 6.6, 'P', cusps, ascmc,
+                   cusp_speed, ascmc_speed, err);
+}
+
+static void houses(void)
+{
+    swe_houses(JD, 46.5, 6.6, 'K', cusps, ascmc);
+}
+
+static void houses_armc(void)
+{
+    swe_houses_armc(120.0, 46.5, 23.44, 'P', cusps, ascmc);
+}
+
+static void azalt(void)
+{
+    double xin[3] = {120.0, 2.0, 1.0};
+    swe_azalt(JD, SE_ECL2HOR, geopos, 0, 0, xin, res);
+}
+
+static void pheno_ut(void)
+{
+    swe_pheno_ut(JD, SE_VENUS, SEFLG_MOSEPH, res, err);
+}
+
+static void nod_aps_ut(void)
+{
+    swe_nod_aps_ut(JD, SE_MARS, SEFLG_MOSEPH, SE_NODBIT_MEAN, res, res + 6,
+                   res + 12, res + 18, err);
+}
+
+/* batch */
+
+static void calc_ut_loop(void)
+{
+    int i;
+    for (i = 0; i < NDATES; ++i)
+        swe_calc_ut(dates[i], SE_MOON, FLAGS, res, err);
+}
+
+static void calc_ut_planets(void)
+{
+    int i, pl;
+    for (i = 0; i < NDATES; ++i)
+        for (pl = SE_SUN; pl <= SE_PLUTO; ++pl)
+            swe_calc_ut(dates[i], pl, FLAGS, res, err);
+}
+
+static void houses_ex2_loop(void)
+{
+    int i;
+    for (i = 0; i < NDATES; ++i)
+        swe_houses_ex2(dates[i], SEFLG_MOSEPH, 46.5, 6.6, 'P', cusps, ascmc,
+                       cusp_speed, ascmc_speed, err);
+}
+
+/* events */
+
+static void rise_trans(void)
+{
+    swe_rise_trans(JD, SE_SUN, NULL, SEFLG_MOSEPH, SE_CALC_RISE, geopos, 0, 0,
+                   res, err);
+}
+
+static void rise_trans_moon_set(void)
+{
+    swe_rise_trans(JD, SE_MOON, NULL, SEFLG_MOSEPH, SE_CALC_SET, geopos,
+                   1013.25, 15, res, err);
+}
+
+static void solcross_ut(void)
+{
+    res[0] = swe_solcross_ut(0.0, JD, SEFLG_MOSEPH, err);
+}
+
+static void mooncross_ut(void)
+{
+    res[0] = swe_mooncross_ut(0.0, JD, SEFLG_MOSEPH, err);
+}
+
+static void mooncross_node_ut(void)
+{
+    /* same call as the wrapper */
+    res[0] = swe_mooncross_node(JD, SEFLG_MOSEPH, res + 1, res + 2, err);
+}
+
+static void helio_cross_ut(void)
+{
+    swe_helio_cross_ut(SE_MARS, 0.0, JD, SEFLG_MOSEPH, 0, res, err);
+}
+
+static void heliacal_ut(void)
+{
+    swe_heliacal_ut(JD, geopos, atmo, observer, "venus", SE_HELIACAL_RISING,
+                    SEFLG_MOSEPH, res, err);
+}
+
+/* eclipses */
+
+static void sol_eclipse_when_glob(void)
+{
+    swe_sol_eclipse_when_glob(JD, SEFLG_MOSEPH, 0, res, 0, err);
+}
+
+static void sol_eclipse_when_loc(void)
+{
+    swe_sol_eclipse_when_loc(JD, SEFLG_MOSEPH, geopos, res, res + 10, 0, err);
+}
+
+static void sol_eclipse_where(void)
+{
+    swe_sol_eclipse_where(2451401.9, SEFLG_MOSEPH, res, res + 10, err);
+}
+
+static void lun_eclipse_when(void)
+{
+    swe_lun_eclipse_when(JD, SEFLG_MOSEPH, 0, res, 0, err);
+}
+
+static void lun_eclipse_how(void)
+{
+    swe_lun_eclipse_how(2451564.7, SEFLG_MOSEPH, geopos, res, err);
+}
+
+static void lun_occult_when_glob(void)
+{
+    swe_lun_occult_when_glob(JD, SE_VENUS, NULL, SEFLG_MOSEPH, 0, res, 0, err);
+}
+
+typedef struct {
+    const char *name;
+    void (*func)(void);
+    int ops;
+} bench_t;
+
+static const bench_t benchmarks[] = {
+    {"scalar.julday", julday, 1},
+    {"scalar.revjul", revjul, 1},
+    {"scalar.deltat", deltat, 1},
+    {"scalar.sidtime", sidtime, 1},
+    {"scalar.calc_ut_sun", calc_ut_sun, 1},
+    {"scalar.calc_ut_moon", calc_ut_moon, 1},
+    {"scalar.calc_ut_moon_out", calc_ut_moon, 1},
+    {"scalar.calc_ut_equatorial", calc_ut_equatorial, 1},
+    {"scalar.calc", calc, 1},
+    {"scalar.calc_pctr", calc_pctr, 1},
+    {"scalar.houses_ex2", houses_ex2, 1},
+    {"scalar.houses", houses, 1},
+    {"scalar.houses_armc", houses_armc, 1},
+    {"scalar.azalt", azalt, 1},
+    {"scalar.pheno_ut", pheno_ut, 1},
+    {"scalar.nod_aps_ut", nod_aps_ut, 1},
+    {"batch.calc_ut_loop", calc_ut_loop, NDATES},
+    {"batch.calc_ut_loop_out", calc_ut_loop, NDATES},
+    {"batch.calc_ut_planets", calc_ut_planets, NDATES * 10},
+    {"batch.houses_ex2_loop", houses_ex2_loop, NDATES},
+    {"events.rise_trans", rise_trans, 1},
+    {"events.rise_trans_moon_set", rise_trans_moon_set, 1},
+    {"events.solcross_ut", solcross_ut, 1},
+    {"events.mooncross_ut", mooncross_ut, 1},
+    {"events.mooncross_node_ut", mooncross_node_ut, 1},
+    {"events.helio_cross_ut", helio_cross_ut, 1},
+    {"events.heliacal_ut", heliacal_ut, 1},
+    {"eclipses.sol_eclipse_when_glob", sol_eclipse_when_glob, 1},
+    {"eclipses.sol_eclipse_when_loc", sol_eclipse_when_loc, 1},
+    {"eclipses.sol_eclipse_where", sol_eclipse_where, 1},
+    {"eclipses.lun_eclipse_when", lun_eclipse_when, 1},
+    {"eclipses.lun_eclipse_how", lun_eclipse_how, 1},
+    {"eclipses.lun_occult_when_glob", lun_occult_when_glob, 1},
+    {NULL, NULL, 0}
+};
+
+static int cmp_d(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return x < y ? -1 : x > y;
+}
+
+/* Return median time per operation, in nanoseconds */
+static double run_one(const bench_t *b, int samples, double min_time)
+{
+    long i, loops = 1;
+    int j;
+    double t, dt, *times, median;
+    /* calibrate */
+    for (;;) {
+        t = now();
+        for (i = 0; i < loops; ++i)
+            b->func();
+        dt = now() - t;
+        if (dt >= min_time)
+            break;
+        if (dt <= 0)
+            loops *= 10;
+        else if ((long) (loops * min_time / dt * 1.2) > loops)
+            loops = (long) (loops * min_time / dt * 1.2);
+        else
+            ++loops;
+    }
+    times = malloc(samples * sizeof(double));
+    if (!times) {
+        fprintf(stderr, "pyswe_bench: out of memory\n");
+        exit(1);
+    }
+    for (j = 0; j < samples; ++j) {
+        t = now();
+        for (i = 0; i < loops; ++i)
+            b->func();
+        times[j] = (now() - t) / ((double) loops * b->ops) * 1e9;
+    }
+    qsort(times, samples, sizeof(double), cmp_d);
+    median = samples % 2 ? times[samples / 2]
+        : (times[samples / 2 - 1] + times[samples / 2]) / 2;
+    free(times);
+    return median;
+}
+
+static int selected(const char *name, char **patterns, int npatterns)
+{
+    int i;
+    if (!npatterns)
+        return 1;
+    for (i = 0; i < npatterns; ++i)
+        if (strstr(name, patterns[i]))
+            return 1;
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: pyswe_bench [-j] [-l] [-n samples] [-t min_time]"
+            " [-k pattern]...\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    int i, json = 0, list = 0, samples = 10, npatterns = 0, first = 1;
+    double min_time = 0.05;
+    char **patterns = calloc(argc, sizeof(char *));
+    const bench_t *b;
+
+    if (!patterns)
+        return 1;
+    for (i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-j"))
+            json = 1;
+        else if (!strcmp(argv[i], "-l"))
+            list = 1;
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            samples = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            min_time = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-k") && i + 1 < argc)
+            patterns[npatterns++] = argv[++i];
+        else
+            usage();
+    }
+    if (samples < 1)
+        usage();
+    if (list)
+        json = 0;
+    for (i = 0; i < NDATES; ++i)
+        dates[i] = JD + i * 0.37;
+    swe_set_ephe_path(NULL);
+    if (json)
+        printf("{");
+    for (b = benchmarks; b->name; ++b) {
+        if (!selected(b->name, patterns, npatterns))
+            continue;
+        if (list) {
+            printf("%s\n", b->name);
+            continue;
+        }
+        if (json) {
+            printf("%s\n    \"%s\": %.1f", first ? "" : ",", b->name,
+                   run_one(b, samples, min_time));
+            first = 0;
+        }
+        else
+            printf("%-40s %12.1f\n", b->name, run_one(b, samples, min_time));
+        fflush(stdout);
+    }
+    if (json)
+        printf("\n}\n");
+    swe_close();
+    free(patterns);
+    return 0;
+}
+
+/* vi: set fenc=utf-8 ff=unix et sw=4 ts=4 sts=4 : */
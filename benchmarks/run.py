@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Run the pyswisseph benchmark suite.
+
+Workloads are defined in workloads.py. Each one is calibrated to run at least
+--min-time seconds per sample, then --samples samples are taken after a
+warmup. Results (nanoseconds per operation) can be written to a JSON file,
+and compared to a previous JSON file (the baseline).
+
+Usage::
+
+    python3 benchmarks/run.py -o base.json             # run, save
+    python3 benchmarks/run.py -b base.json -o new.json # run, compare
+    python3 benchmarks/run.py -c base.json new.json    # compare files
+    python3 benchmarks/run.py -k eclipses -k houses    # filter by name
+    python3 benchmarks/run.py --list
+    python3 benchmarks/run.py --native build/pyswe_bench
+
+With --native, the same workloads are timed by the pyswe_bench executable
+(calling libswe directly, see pyswe_bench.c; build it with ``cmake --build
+build --target pyswe_bench``), and the difference with the Python timings is
+reported as wrapper overhead.
+
+With a baseline, the exit status is 1 if a benchmark is slower than the
+baseline by more than --threshold (relative, on medians).
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import swisseph as swe
+import workloads
+
+FORMAT_VERSION = 1
+
+def metadata():
+    return {
+        'format_version': FORMAT_VERSION,
+        'date': datetime.datetime.now().isoformat(timespec='seconds'),
+        'python': platform.python_version(),
+        'implementation': platform.python_implementation(),
+        'platform': platform.platform(),
+        'machine': platform.machine(),
+        'cpu_count': os.cpu_count(),
+        'pyswisseph': swe.__version__,
+        'swisseph': swe.version,
+        'ephemeris': 'moshier',
+    }
+
+def calibrate(func, min_time):
+    """Return the number of loops for a sample to last at least min_time."""
+    loops = 1
+    while True:
+        t = time.perf_counter()
+        for _ in range(loops):
+            func()
+        dt = time.perf_counter() - t
+        if dt >= min_time:
+            return loops
+        if dt <= 0:
+            loops *= 10
+        else:
+            loops = max(loops + 1, int(loops * min_time / dt * 1.2))
+
+def run_one(b, samples, min_time, warmup):
+    loops = calibrate(b.func, min_time)
+    times = []
+    for i in range(warmup + samples):
+        t = time.perf_counter()
+        for _ in range(loops):
+            b.func()
+        dt = time.perf_counter() - t
+        if i >= warmup:
+            times.append(dt / (loops * b.ops) * 1e9)
+    return {
+        'group': b.group,
+        'ops': b.ops,
+        'loops': loops,
+        'samples': times,
+        'min': min(times),
+        'median': statistics.median(times),
+        'mean': statistics.mean(times),
+        'stdev': statistics.stdev(times) if len(times) > 1 else 0.0,
+    }
+
+def select(patterns):
+    if not patterns:
+        return list(workloads.BENCHMARKS)
+    return [b for b in workloads.BENCHMARKS
+            if any(p in b.name for p in patterns)]
+
+def run(benchmarks, samples, min_time, warmup, verbose=True):
+    swe.set_ephe_path(None)
+    res = {}
+    for b in benchmarks:
+        try:
+            res[b.name] = r = run_one(b, samples, min_time, warmup)
+        except Exception as e:
+            res[b.name] = {'group': b.group, 'error': str(e)}
+            print('%-40s error: %s' % (b.name, e), file=sys.stderr)
+            continue
+        if verbose:
+            print('%-40s %12.1f ns +- %.1f' % (b.name, r['median'],
+                  r['stdev']), file=sys.stderr)
+    swe.close()
+    return {'metadata': metadata(), 'benchmarks': res}
+
+def run_native(exe, patterns, samples, min_time):
+    """Run pyswe_bench, return its timings as {name: ns}."""
+    cmd = [exe, '-j', '-n', str(samples), '-t', str(min_time)]
+    for p in patterns or ():
+        cmd += ['-k', p]
+    return json.loads(subprocess.run(cmd, stdout=subprocess.PIPE, check=True,
+                                     universal_newlines=True).stdout)
+
+def add_native(res, native):
+    """Add native timings and wrapper overhead to results."""
+    for name, r in res['benchmarks'].items():
+        if 'median' in r and name in native:
+            r['native'] = native[name]
+            r['overhead'] = r['median'] - native[name]
+
+def print_overhead(res):
+    print('%-40s %12s %12s %12s %6s' % ('benchmark', 'python', 'native',
+                                        'overhead', '%'))
+    for name, r in res['benchmarks'].items():
+        if 'native' not in r:
+            continue
+        print('%-40s %12.1f %12.1f %12.1f %6.1f' % (name, r['median'],
+              r['native'], r['overhead'], r['overhead'] / r['median'] * 100))
+
+def compare(base, new, threshold):
+    """Print comparison of two results, return number of regressions."""
+    regressions = 0
+    print('%-40s %12s %12s %8s' % ('benchmark', 'baseline', 'current',
+                                   'ratio'))
+    for name, r in new['benchmarks'].items():
+        if 'error' in r:
+            print('%-40s error: %s' % (name, r['error']))
+            continue
+        if 'median' not in base['benchmarks'].get(name, {}):
+            print('%-40s %12s %12.1f' % (name, '-', r['median']))
+            continue
+        old = base['benchmarks'][name]['median']
+        ratio = r['median'] / old
+        mark = ''
+        if ratio > 1 + threshold:
+            mark = ' slower'
+            regressions += 1
+        elif ratio < 1 - threshold:
+            mark = ' faster'
+        print('%-40s %12.1f %12.1f %8.2f%s' % (name, old, r['median'], ratio,
+                                               mark))
+    for key in ('python', 'pyswisseph', 'swisseph', 'machine'):
+        if base['metadata'].get(key) != new['metadata'].get(key):
+            print('note: %s differs: %s / %s' % (key, base['metadata'].get(key),
+                                                 new['metadata'].get(key)))
+    return regressions
+
+def load(path):
+    with open(path) as f:
+        res = json.load(f)
+    if res.get('metadata', {}).get('format_version') != FORMAT_VERSION:
+        raise SystemExit('%s: unknown results format' % path)
+    return res
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-o', '--output', metavar='FILE',
+                        help='write results as json')
+    parser.add_argument('-b', '--baseline', metavar='FILE',
+                        help='compare results to this json file')
+    parser.add_argument('-c', '--compare', nargs=2, metavar=('BASE', 'NEW'),
+                        help='compare two json files, do not run')
+    parser.add_argument('-k', dest='patterns', action='append',
+                        metavar='PATTERN', help='run benchmarks matching')
+    parser.add_argument('-n', '--samples', type=int, default=10)
+    parser.add_argument('-w', '--warmup', type=int, default=1)
+    parser.add_argument('--min-time', type=float, default=0.05,
+                        help='minimum duration of a sample, in seconds')
+    parser.add_argument('-t', '--threshold', type=float, default=0.05,
+                        help='relative slowdown reported as regression')
+    parser.add_argument('-q', '--quiet', action='store_true')
+    parser.add_argument('--native', metavar='EXE',
+                        help='pyswe_bench executable, report overhead')
+    parser.add_argument('--list', action='store_true',
+                        help='list benchmarks and exit')
+    args = parser.parse_args()
+    if args.list:
+        for b in select(args.patterns):
+            print(b.name)
+        return 0
+    if args.compare:
+        return 1 if compare(load(args.compare[0]), load(args.compare[1]),
+                            args.threshold) else 0
+    base = load(args.baseline) if args.baseline else None
+    res = run(select(args.patterns), args.samples, args.min_time,
+              args.warmup, not args.quiet)
+    if args.native:
+        add_native(res, run_native(args.native, args.patterns, args.samples,
+                                   args.min_time))
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(res, f, indent=2)
+            f.write('\n')
+    if args.native:
+        print_overhead(res)
+    if base:
+        return 1 if compare(base, res, args.threshold) else 0
+    if not args.output and not args.native:
+        json.dump(res, sys.stdout, indent=2)
+        print()
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Compare the memory and time of ephemeris tables.
+
+Positions of some bodies for a range of dates are computed as Python tuples
+in a list (calc_ut in a loop), and with ``swisseph.ephemeris_table``. The peak
+of memory allocated (tracemalloc) and the time are reported, with the
+conversion to a pyarrow table if pyarrow is installed. The same rows are also
+written to a temporary file with ``swisseph.write_ephemeris_table``, in csv
+and binary formats.
+
+Usage::
+
+    python3 benchmarks/table.py
+    python3 benchmarks/table.py -n 100000 --json
+"""
+
+import argparse
+import json
+import platform
+import os
+import sys
+import tempfile
+import time
+import tracemalloc
+
+import swisseph as swe
+
+try:
+    import pyarrow
+except ImportError:
+    pyarrow = None
+
+JD = 2451545.0
+BODIES = list(range(swe.SUN, swe.PLUTO + 1))
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+
+def tuples(ndates):
+    rows = []
+    for i in range(ndates):
+        jd = JD + i / 24
+        for pl in BODIES:
+            xx, ret = swe.calc_ut(jd, pl, FLAGS)
+            rows.append((jd, pl) + tuple(xx) + (ret,))
+    if pyarrow:
+        names = ('jd', 'body', 'lon', 'lat', 'dist', 'lon_speed', 'lat_speed',
+                 'dist_speed', 'retflags')
+        return pyarrow.table(dict(zip(names, map(list, zip(*rows)))))
+    return rows
+
+def table(ndates):
+    t = swe.ephemeris_table(BODIES, JD, JD + ndates / 24, 1 / 24, FLAGS)
+    return pyarrow.table(t) if pyarrow else t
+
+def write(ndates, fmt):
+    fd, path = tempfile.mkstemp()
+    try:
+        swe.write_ephemeris_table(fd, BODIES, JD, JD + ndates / 24, 1 / 24,
+                                  FLAGS, format=fmt)
+    finally:
+        os.close(fd)
+        os.remove(path)
+
+def write_csv(ndates):
+    write(ndates, 'csv')
+
+def write_binary(ndates):
+    write(ndates, 'binary')
+
+def measure(func, ndates):
+    """Return the time (s) and the peak of memory allocated (MiB)."""
+    tracemalloc.start()
+    t0 = time.perf_counter()
+    res = func(ndates)
+    t = time.perf_counter() - t0
+    peak = tracemalloc.get_traced_memory()[1]
+    tracemalloc.stop()
+    del res
+    return t, peak / 2**20
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-n', '--dates', type=int, default=20000,
+                        help='number of dates (hourly)')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    res = {}
+    for func in (tuples, table, write_csv, write_binary):
+        t, peak = measure(func, args.dates)
+        res[func.__name__] = {'time_s': t, 'peak_mib': peak}
+    if args.json:
+        json.dump({
+            'python': platform.python_version(),
+            'pyarrow': pyarrow.__version__ if pyarrow else None,
+            'rows': args.dates * len(BODIES),
+            'results': res,
+        }, sys.stdout, indent=4)
+        print()
+        return
+    print('python %s, %d rows%s' % (platform.python_version(),
+          args.dates * len(BODIES), ', to pyarrow' if pyarrow else ''))
+    print('%12s %10s %12s' % ('', 'time (s)', 'peak (MiB)'))
+    for name, r in res.items():
+        print('%12s %10.3f %12.1f' % (name, r['time_s'], r['peak_mib']))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
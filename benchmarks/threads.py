@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""Measure the scaling of calculations with the number of threads.
+
+Each thread computes the positions of the planets (and the houses) for its
+share of a fixed list of dates, with the built-in Moshier ephemeris. The
+throughput with 1, 2, 4... threads is compared to the throughput with one
+thread. With the GIL there is no speedup; with a free-threaded Python
+(``python3.13t``), the speedup should be close to the number of threads, up
+to the number of cores.
+
+Usage::
+
+    python3.13t benchmarks/threads.py
+    python3.13t benchmarks/threads.py -t 1 -t 8 --houses --json
+"""
+
+import argparse
+import json
+import os
+import platform
+import sys
+import threading
+import time
+
+import swisseph as swe
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+
+def work(dates, houses):
+    calc_ut = swe.calc_ut
+    for jd in dates:
+        for pl in range(swe.SUN, swe.PLUTO + 1):
+            calc_ut(jd, pl, FLAGS)
+        if houses:
+            swe.houses_ex2(jd, 46.5, 6.6, b'P', swe.FLG_MOSEPH)
+
+def run(nthreads, ndates, houses):
+    """Return the number of dates per second with nthreads threads."""
+    dates = [JD + i * 0.37 for i in range(ndates)]
+    chunks = [dates[i::nthreads] for i in range(nthreads)]
+    barrier = threading.Barrier(nthreads + 1)
+    def target(chunk):
+        barrier.wait()
+        work(chunk, houses)
+    threads = [threading.Thread(target=target, args=(c,)) for c in chunks]
+    for t in threads:
+        t.start()
+    barrier.wait()
+    t0 = time.perf_counter()
+    for t in threads:
+        t.join()
+    return ndates / (time.perf_counter() - t0)
+
+def gil_enabled():
+    f = getattr(sys, '_is_gil_enabled', None)
+    return True if f is None else f()
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-t', '--threads', type=int, action='append',
+                        metavar='N', help='number of threads (repeatable)')
+    parser.add_argument('-n', '--dates', type=int, default=20000,
+                        help='dates computed by each run')
+    parser.add_argument('-r', '--repeat', type=int, default=3)
+    parser.add_argument('--houses', action='store_true',
+                        help='compute houses too')
+    parser.add_argument('--json', action='store_true',
+                        help='print results as json')
+    args = parser.parse_args()
+    counts = args.threads
+    if not counts:
+        counts, n = [], 1
+        while n <= (os.cpu_count() or 1):
+            counts.append(n)
+            n *= 2
+    work([JD], args.houses) # warmup
+    res = {}
+    for n in counts:
+        res[n] = max(run(n, args.dates, args.houses)
+                     for _ in range(args.repeat))
+    base = res.get(1) or res[counts[0]] / counts[0]
+    if args.json:
+        json.dump({
+            'python': platform.python_version(),
+            'gil': gil_enabled(),
+            'cpu_count': os.cpu_count(),
+            'results': {str(n): {'dates_per_s': r, 'speedup': r / base}
+                        for n, r in res.items()},
+        }, sys.stdout, indent=4)
+        print()
+        return
+    print('python %s, gil %s, %s cpus' % (platform.python_version(),
+          'enabled' if gil_enabled() else 'disabled', os.cpu_count()))
+    print('%8s %14s %8s %10s' % ('threads', 'dates/s', 'speedup',
+                                 'efficiency'))
+    for n, r in res.items():
+        print('%8d %14.0f %8.2f %9.0f%%' % (n, r, r / base,
+                                            r / base / n * 100))
+
+if __name__ == '__main__':
+    main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,255 @@
+# -*- coding: utf-8 -*-
+
+"""Workloads of the benchmark suite.
+
+All workloads use the built-in Moshier ephemeris (FLG_MOSEPH), so results do
+not depend on the ephemeris files installed. Each workload is a function
+without arguments, registered with the ``bench`` decorator in a group:
+
+ - scalar: one call of a wrapper, mostly call overhead and libswe time
+ - batch: loops over many dates, per-op time reported
+ - events: searches (risings, crossings, heliacal events)
+ - eclipses: eclipses and occultations
+ - contrib: aspect finders of swisseph.contrib (if built)
+
+``ops`` is the number of operations done by one call of the workload, times
+are reported per operation.
+
+The libswe calls of most workloads are also timed in pyswe_bench.c, under the
+same name and with the same inputs: keep both files in sync.
+"""
+
+import array
+
+import swisseph as swe
+
+swh = getattr(swe, 'contrib', None)
+
+BENCHMARKS = []
+
+class Benchmark(object):
+
+    def __init__(self, name, group, func, ops):
+        self.name = name
+        self.group = group
+        self.func = func
+        self.ops = ops
+
+def bench(group, ops=1):
+    """Register a workload."""
+    def deco(func):
+        BENCHMARKS.append(Benchmark('%s.%s' % (group, func.__name__), group,
+                                    func, ops))
+        return func
+    return deco
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+GEOPOS = (6.6, 46.5, 400.0)
+ATMO = (1013.25, 15.0, 40.0, 0.0)
+OBSERVER = (36.0, 1.0, 0.0, 0.0, 0.0, 0.0)
+
+NDATES = 1000
+DATES = [JD + i * 0.37 for i in range(NDATES)]
+OUT = array.array('d', bytes(48))
+BATCH = [r for jd in DATES for r in (('calc_ut', jd, swe.MOON, FLAGS),
+         ('calc', jd, swe.MARS, FLAGS),
+         ('fixstar_ut', jd, 'Aldebaran', swe.FLG_MOSEPH))]
+
+# scalar
+
+@bench('scalar')
+def julday():
+    swe.julday(2000, 1, 1, 12.0)
+
+@bench('scalar')
+def revjul():
+    swe.revjul(JD)
+
+@bench('scalar')
+def deltat():
+    swe.deltat(JD)
+
+@bench('scalar')
+def sidtime():
+    swe.sidtime(JD)
+
+@bench('scalar')
+def calc_ut_sun():
+    swe.calc_ut(JD, swe.SUN, FLAGS)
+
+@bench('scalar')
+def calc_ut_moon():
+    swe.calc_ut(JD, swe.MOON, FLAGS)
+
+@bench('scalar')
+def calc_ut_moon_out():
+    swe.calc_ut(JD, swe.MOON, FLAGS, OUT)
+
+@bench('scalar')
+def calc_ut_equatorial():
+    swe.calc_ut(JD, swe.MARS, FLAGS|swe.FLG_EQUATORIAL)
+
+@bench('scalar')
+def calc():
+    swe.calc(JD, swe.JUPITER, FLAGS)
+
+@bench('scalar')
+def calc_pctr():
+    swe.calc_pctr(JD, swe.MOON, swe.MARS, FLAGS)
+
+@bench('scalar')
+def houses_ex2():
+    swe.houses_ex2(JD, 46.5, 6.6, b'P', swe.FLG_MOSEPH)
+
+@bench('scalar')
+def houses():
+    swe.houses(JD, 46.5, 6.6, b'K')
+
+@bench('scalar')
+def houses_armc():
+    swe.houses_armc(120.0, 46.5, 23.44, b'P')
+
+@bench('scalar')
+def azalt():
+    swe.azalt(JD, swe.ECL2HOR, GEOPOS, 0, 0, (120.0, 2.0, 1.0))
+
+@bench('scalar')
+def pheno_ut():
+    swe.pheno_ut(JD, swe.VENUS, swe.FLG_MOSEPH)
+
+@bench('scalar')
+def nod_aps_ut():
+    swe.nod_aps_ut(JD, swe.MARS, swe.NODBIT_MEAN, swe.FLG_MOSEPH)
+
+# batch
+
+@bench('batch', ops=NDATES)
+def calc_ut_loop():
+    calc_ut = swe.calc_ut
+    for jd in DATES:
+        calc_ut(jd, swe.MOON, FLAGS)
+
+@bench('batch', ops=NDATES)
+def calc_ut_loop_out():
+    calc_ut = swe.calc_ut
+    for jd in DATES:
+        calc_ut(jd, swe.MOON, FLAGS, OUT)
+
+@bench('batch', ops=NDATES * 10)
+def calc_ut_planets():
+    calc_ut = swe.calc_ut
+    for jd in DATES:
+        for pl in range(swe.SUN, swe.PLUTO + 1):
+            calc_ut(jd, pl, FLAGS)
+
+@bench('batch', ops=NDATES)
+def houses_ex2_loop():
+    houses_ex2 = swe.houses_ex2
+    for jd in DATES:
+        houses_ex2(jd, 46.5, 6.6, b'P', swe.FLG_MOSEPH)
+
+@bench('batch', ops=NDATES)
+def calc_ut_array():
+    swe.calc_ut_array(DATES, swe.MOON, FLAGS)
+
+@bench('batch', ops=NDATES)
+def houses_array():
+    swe.houses_array(DATES, 46.5, 6.6, b'P', swe.FLG_MOSEPH)
+
+@bench('batch', ops=NDATES * 3)
+def batch_mixed_loop():
+    calc_ut, calc, fixstar2_ut = swe.calc_ut, swe.calc, swe.fixstar2_ut
+    for jd in DATES:
+        calc_ut(jd, swe.MOON, FLAGS)
+        calc(jd, swe.MARS, FLAGS)
+        fixstar2_ut('Aldebaran', jd, swe.FLG_MOSEPH)
+
+@bench('batch', ops=NDATES * 3)
+def batch_mixed():
+    swe.batch(BATCH)
+
+# events
+
+@bench('events')
+def rise_trans():
+    swe.rise_trans(JD, swe.SUN, swe.CALC_RISE, GEOPOS, 0, 0, swe.FLG_MOSEPH)
+
+@bench('events')
+def rise_trans_moon_set():
+    swe.rise_trans(JD, swe.MOON, swe.CALC_SET, GEOPOS, 1013.25, 15,
+                   swe.FLG_MOSEPH)
+
+@bench('events')
+def solcross_ut():
+    swe.solcross_ut(0.0, JD, swe.FLG_MOSEPH)
+
+@bench('events')
+def mooncross_ut():
+    swe.mooncross_ut(0.0, JD, swe.FLG_MOSEPH)
+
+@bench('events')
+def mooncross_node_ut():
+    swe.mooncross_node_ut(JD, swe.FLG_MOSEPH)
+
+@bench('events')
+def helio_cross_ut():
+    swe.helio_cross_ut(swe.MARS, 0.0, JD, swe.FLG_MOSEPH)
+
+@bench('events')
+def heliacal_ut():
+    swe.heliacal_ut(JD, GEOPOS, ATMO, OBSERVER, 'venus',
+                    swe.HELIACAL_RISING, swe.FLG_MOSEPH)
+
+# eclipses
+
+@bench('eclipses')
+def sol_eclipse_when_glob():
+    swe.sol_eclipse_when_glob(JD, swe.FLG_MOSEPH)
+
+@bench('eclipses')
+def sol_eclipse_when_loc():
+    swe.sol_eclipse_when_loc(JD, GEOPOS, swe.FLG_MOSEPH)
+
+@bench('eclipses')
+def sol_eclipse_where():
+    swe.sol_eclipse_where(2451401.9, swe.FLG_MOSEPH)
+
+@bench('eclipses')
+def lun_eclipse_when():
+    swe.lun_eclipse_when(JD, swe.FLG_MOSEPH)
+
+@bench('eclipses')
+def lun_eclipse_how():
+    swe.lun_eclipse_how(2451564.7, GEOPOS, swe.FLG_MOSEPH)
+
+@bench('eclipses')
+def lun_occult_when_glob():
+    swe.lun_occult_when_glob(JD, swe.VENUS, swe.FLG_MOSEPH)
+
+# contrib
+
+if swh is not None:
+
+    @bench('contrib')
+    def match_aspect():
+        swh.match_aspect(10.0, 1.0, 190.5, -0.5, 180.0, 2.0)
+
+    @bench('contrib')
+    def next_aspect():
+        swh.next_aspect(swe.MARS, 90.0, 0.0, JD, flags=FLAGS)
+
+    @bench('contrib')
+    def next_aspect_with():
+        swh.next_aspect_with(swe.SUN, 0.0, swe.MOON, JD, flags=FLAGS)
+
+    @bench('contrib')
+    def next_aspect_cusp():
+        swh.next_aspect_cusp(swe.MOON, 0.0, 1, JD, 46.5, 6.6, b'P',
+                             flags=FLAGS)
+
+    @bench('contrib')
+    def next_retro():
+        swh.next_retro(swe.MERCURY, JD, flag=FLAGS)
+
+# vi: sw=4 ts=4 et
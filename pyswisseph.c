@@ -43,7 +43,9 @@
 #endif
 #endif /* PYSWE_DEFAULT_EPHE_PATH */
 
-/* Wether to automaticly set ephemeris path on module import */
+/* Wether to automaticly set ephemeris path on module import
+ * (done on the first calculation, see pyswe_ephe_init)
+ */
 #ifndef PYSWE_AUTO_SET_EPHE_PATH
 #define PYSWE_AUTO_SET_EPHE_PATH    1
 #endif
@@ -53,14 +55,54 @@
 #define PYSWE_USE_SWEPHELP      1
 #endif
 
+/* Wether set_ephe_path can map ephemeris files in memory */
+#ifndef PYSWE_USE_MMAP
+#ifdef WIN32
+#define PYSWE_USE_MMAP      0
+#else
+#define PYSWE_USE_MMAP      1
+#endif
+#endif
+
+/* Wether to count ephemeris file I/O (io_stats)
+ * Needs the bundled libswe, linked with --wrap for the stdio functions
+ * (GNU ld, see setup.py and CMakeLists.txt)
+ */
+#ifndef PYSWE_USE_IO_STATS
+#define PYSWE_USE_IO_STATS      0
+#endif
+
 /* Dont modify below */
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <structmember.h>
+#include <stddef.h>
 #include <swephexp.h>
 
 #if PYSWE_USE_SWEPHELP
 #include <swephelp.h>
+#include <sqlite3.h>
+#endif
+
+#include "pyswisseph.h"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if PYSWE_USE_MMAP
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 /* Needed for compilation with Python < 2.4 */
@@ -70,14 +112,302 @@
 #define Py_RETURN_FALSE Py_INCREF(Py_False); return Py_False;
 #endif
 
+/* Use METH_FASTCALL for the most called functions (Python >= 3.7) */
+#ifndef PYSWE_FASTCALL
+#if PY_VERSION_HEX >= 0x03070000
+#define PYSWE_FASTCALL      1
+#else
+#define PYSWE_FASTCALL      0
+#endif
+#endif
+
+/* Create constants and swisseph.contrib on first access, with a module
+ * __getattr__ (Python >= 3.7), for a faster import
+ */
+#define PYSWE_LAZY_ATTRS    (PY_VERSION_HEX >= 0x03070000)
+
 /* Macros */
 #define FUNCARGS_SELF       (PyObject *self)
 #define FUNCARGS_KEYWDS     (PyObject *self, PyObject *args, PyObject *kwds)
 #define PyModule_AddFloatConstant(m, nam, d) \
         PyModule_AddObject(m, nam, Py_BuildValue("d", d))
+#if PYSWE_FASTCALL
+#define FUNCARGS_FAST       (PyObject *self, PyObject *const *args, \
+                             Py_ssize_t nargs, PyObject *kwnames)
+#define PYSWE_FAST(func)    (PyCFunction)(void(*)(void)) func##_fast
+#define PYSWE_METH_FAST     METH_FASTCALL|METH_KEYWORDS
+#else
+#define PYSWE_FAST(func)    (PyCFunction) func
+#define PYSWE_METH_FAST     METH_VARARGS|METH_KEYWORDS
+#endif
+
+/* Libswe keeps its global data in thread local storage (TLS macro of
+ * sweodef.h), unless disabled. Interpreters can then have their own GIL
+ * (Python >= 3.12), the data of this module shared by all interpreters is
+ * protected by locks.
+ * This is only known of the bundled libswe, compiled with the same flags as
+ * this module (PYSWE_BUNDLED_LIBSWE, set by setup.py and CMakeLists.txt). A
+ * system libswe can have been built with TLSOFF.
+ */
+#ifndef PYSWE_BUNDLED_LIBSWE
+#define PYSWE_BUNDLED_LIBSWE    0
+#endif
+
+#if !PYSWE_BUNDLED_LIBSWE || defined(TLSOFF) || defined(__APPLE__)
+#define PYSWE_SWE_TLS       0
+#else
+#define PYSWE_SWE_TLS       1
+#endif
+
+/* Free-threaded Python (>= 3.13t): objects that can be modified by several
+ * threads are used within critical sections, these are no-ops with the GIL.
+ */
+#if PY_VERSION_HEX < 0x030D0000
+#define Py_BEGIN_CRITICAL_SECTION(op)   {
+#define Py_END_CRITICAL_SECTION()       }
+#endif
+
+#ifdef _MSC_VER
+#define PYSWE_THREAD_LOCAL  __declspec(thread)
+#else
+#define PYSWE_THREAD_LOCAL  __thread
+#endif
+
+/* Ephemeris path of the module import (PYSWE_AUTO_SET_EPHE_PATH)
+ * It is set on the first call of a function that can read ephemeris files,
+ * not on import: swe_set_ephe_path opens the moon file. The libswe functions
+ * below are wrapped by macros for that. The flag is for the libswe data of the
+ * importing thread (thread local with libswe TLS).
+ */
+#if PYSWE_SWE_TLS
+static PYSWE_THREAD_LOCAL int pyswe_ephe_pending = 0;
+#else
+static int pyswe_ephe_pending = 0;
+#endif
+
+static void pyswe_ephe_init(void)
+{
+    if (pyswe_ephe_pending) {
+        pyswe_ephe_pending = 0;
+        swe_set_ephe_path(PYSWE_DEFAULT_EPHE_PATH);
+    }
+}
+
+#define PYSWE_EPHE(call)    (pyswe_ephe_init(), call)
+
+/* Position calls are counted for the cache hits of io_stats */
+#if PYSWE_USE_IO_STATS
+static void pyswe_io_calc_start(void);
+static int pyswe_io_calc_end(int ret);
+#define PYSWE_IO_CALC(call) (pyswe_io_calc_start(), pyswe_io_calc_end(call))
+#else
+#define PYSWE_IO_CALC(call) (call)
+#endif
+
+#define swe_azalt(...)          PYSWE_EPHE(swe_azalt(__VA_ARGS__))
+#define swe_azalt_rev(...)      PYSWE_EPHE(swe_azalt_rev(__VA_ARGS__))
+#define swe_calc(...) \
+        PYSWE_EPHE(PYSWE_IO_CALC(swe_calc(__VA_ARGS__)))
+#define swe_calc_pctr(...) \
+        PYSWE_EPHE(PYSWE_IO_CALC(swe_calc_pctr(__VA_ARGS__)))
+#define swe_calc_ut(...) \
+        PYSWE_EPHE(PYSWE_IO_CALC(swe_calc_ut(__VA_ARGS__)))
+#define swe_deltat(...)         PYSWE_EPHE(swe_deltat(__VA_ARGS__))
+#define swe_deltat_ex(...)      PYSWE_EPHE(swe_deltat_ex(__VA_ARGS__))
+#define swe_fixstar(...)        PYSWE_EPHE(swe_fixstar(__VA_ARGS__))
+#define swe_fixstar2(...)       PYSWE_EPHE(swe_fixstar2(__VA_ARGS__))
+#define swe_fixstar2_mag(...)   PYSWE_EPHE(swe_fixstar2_mag(__VA_ARGS__))
+#define swe_fixstar2_ut(...)    PYSWE_EPHE(swe_fixstar2_ut(__VA_ARGS__))
+#define swe_fixstar_mag(...)    PYSWE_EPHE(swe_fixstar_mag(__VA_ARGS__))
+#define swe_fixstar_ut(...)     PYSWE_EPHE(swe_fixstar_ut(__VA_ARGS__))
+#define swe_gauquelin_sector(...) \
+        PYSWE_EPHE(swe_gauquelin_sector(__VA_ARGS__))
+#define swe_get_ayanamsa(...)   PYSWE_EPHE(swe_get_ayanamsa(__VA_ARGS__))
+#define swe_get_ayanamsa_ex(...) \
+        PYSWE_EPHE(swe_get_ayanamsa_ex(__VA_ARGS__))
+#define swe_get_ayanamsa_ex_ut(...) \
+        PYSWE_EPHE(swe_get_ayanamsa_ex_ut(__VA_ARGS__))
+#define swe_get_ayanamsa_ut(...) \
+        PYSWE_EPHE(swe_get_ayanamsa_ut(__VA_ARGS__))
+#define swe_get_current_file_data(...) \
+        PYSWE_EPHE(swe_get_current_file_data(__VA_ARGS__))
+#define swe_get_orbital_elements(...) \
+        PYSWE_EPHE(swe_get_orbital_elements(__VA_ARGS__))
+#define swe_get_planet_name(...) \
+        PYSWE_EPHE(swe_get_planet_name(__VA_ARGS__))
+#define swe_get_tid_acc(...)    PYSWE_EPHE(swe_get_tid_acc(__VA_ARGS__))
+#define swe_heliacal_pheno_ut(...) \
+        PYSWE_EPHE(swe_heliacal_pheno_ut(__VA_ARGS__))
+#define swe_heliacal_ut(...)    PYSWE_EPHE(swe_heliacal_ut(__VA_ARGS__))
+#define swe_helio_cross(...)    PYSWE_EPHE(swe_helio_cross(__VA_ARGS__))
+#define swe_helio_cross_ut(...) PYSWE_EPHE(swe_helio_cross_ut(__VA_ARGS__))
+#define swe_houses(...)         PYSWE_EPHE(swe_houses(__VA_ARGS__))
+#define swe_houses_ex(...)      PYSWE_EPHE(swe_houses_ex(__VA_ARGS__))
+#define swe_houses_ex2(...)     PYSWE_EPHE(swe_houses_ex2(__VA_ARGS__))
+#define swe_jdet_to_utc(...)    PYSWE_EPHE(swe_jdet_to_utc(__VA_ARGS__))
+#define swe_jdut1_to_utc(...)   PYSWE_EPHE(swe_jdut1_to_utc(__VA_ARGS__))
+#define swe_lat_to_lmt(...)     PYSWE_EPHE(swe_lat_to_lmt(__VA_ARGS__))
+#define swe_lmt_to_lat(...)     PYSWE_EPHE(swe_lmt_to_lat(__VA_ARGS__))
+#define swe_lun_eclipse_how(...) \
+        PYSWE_EPHE(swe_lun_eclipse_how(__VA_ARGS__))
+#define swe_lun_eclipse_when(...) \
+        PYSWE_EPHE(swe_lun_eclipse_when(__VA_ARGS__))
+#define swe_lun_eclipse_when_loc(...) \
+        PYSWE_EPHE(swe_lun_eclipse_when_loc(__VA_ARGS__))
+#define swe_lun_occult_when_glob(...) \
+        PYSWE_EPHE(swe_lun_occult_when_glob(__VA_ARGS__))
+#define swe_lun_occult_when_loc(...) \
+        PYSWE_EPHE(swe_lun_occult_when_loc(__VA_ARGS__))
+#define swe_lun_occult_where(...) \
+        PYSWE_EPHE(swe_lun_occult_where(__VA_ARGS__))
+#define swe_mooncross(...)      PYSWE_EPHE(swe_mooncross(__VA_ARGS__))
+#define swe_mooncross_node(...) PYSWE_EPHE(swe_mooncross_node(__VA_ARGS__))
+#define swe_mooncross_node_ut(...) \
+        PYSWE_EPHE(swe_mooncross_node_ut(__VA_ARGS__))
+#define swe_mooncross_ut(...)   PYSWE_EPHE(swe_mooncross_ut(__VA_ARGS__))
+#define swe_nod_aps(...)        PYSWE_EPHE(swe_nod_aps(__VA_ARGS__))
+#define swe_nod_aps_ut(...)     PYSWE_EPHE(swe_nod_aps_ut(__VA_ARGS__))
+#define swe_orbit_max_min_true_distance(...) \
+        PYSWE_EPHE(swe_orbit_max_min_true_distance(__VA_ARGS__))
+#define swe_pheno(...)          PYSWE_EPHE(swe_pheno(__VA_ARGS__))
+#define swe_pheno_ut(...)       PYSWE_EPHE(swe_pheno_ut(__VA_ARGS__))
+#define swe_rise_trans(...)     PYSWE_EPHE(swe_rise_trans(__VA_ARGS__))
+#define swe_rise_trans_true_hor(...) \
+        PYSWE_EPHE(swe_rise_trans_true_hor(__VA_ARGS__))
+#define swe_set_jpl_file(...)   PYSWE_EPHE(swe_set_jpl_file(__VA_ARGS__))
+#define swe_sidtime(...)        PYSWE_EPHE(swe_sidtime(__VA_ARGS__))
+#define swe_sol_eclipse_how(...) \
+        PYSWE_EPHE(swe_sol_eclipse_how(__VA_ARGS__))
+#define swe_sol_eclipse_when_glob(...) \
+        PYSWE_EPHE(swe_sol_eclipse_when_glob(__VA_ARGS__))
+#define swe_sol_eclipse_when_loc(...) \
+        PYSWE_EPHE(swe_sol_eclipse_when_loc(__VA_ARGS__))
+#define swe_sol_eclipse_where(...) \
+        PYSWE_EPHE(swe_sol_eclipse_where(__VA_ARGS__))
+#define swe_solcross(...)       PYSWE_EPHE(swe_solcross(__VA_ARGS__))
+#define swe_solcross_ut(...)    PYSWE_EPHE(swe_solcross_ut(__VA_ARGS__))
+#define swe_time_equ(...)       PYSWE_EPHE(swe_time_equ(__VA_ARGS__))
+#define swe_utc_to_jd(...)      PYSWE_EPHE(swe_utc_to_jd(__VA_ARGS__))
+#define swe_vis_limit_mag(...)  PYSWE_EPHE(swe_vis_limit_mag(__VA_ARGS__))
+#if PYSWE_USE_SWEPHELP
+#define swh_calc_ut(...)        PYSWE_EPHE(swh_calc_ut(__VA_ARGS__))
+#define swh_next_aspect(...)    PYSWE_EPHE(swh_next_aspect(__VA_ARGS__))
+#define swh_next_aspect2(...)   PYSWE_EPHE(swh_next_aspect2(__VA_ARGS__))
+#define swh_next_aspect_cusp(...) \
+        PYSWE_EPHE(swh_next_aspect_cusp(__VA_ARGS__))
+#define swh_next_aspect_cusp2(...) \
+        PYSWE_EPHE(swh_next_aspect_cusp2(__VA_ARGS__))
+#define swh_next_aspect_with(...) \
+        PYSWE_EPHE(swh_next_aspect_with(__VA_ARGS__))
+#define swh_next_aspect_with2(...) \
+        PYSWE_EPHE(swh_next_aspect_with2(__VA_ARGS__))
+#define swh_next_retro(...)     PYSWE_EPHE(swh_next_retro(__VA_ARGS__))
+#define swh_saturn_4_stars(...) PYSWE_EPHE(swh_saturn_4_stars(__VA_ARGS__))
+#endif
 
 /* Helper functions */
 
+/* Monotonic clock, in nanoseconds */
+static unsigned long long pyswe_clock_ns(void)
+{
+#ifdef WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER t;
+    if (!freq.QuadPart)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (unsigned long long) (t.QuadPart * (1e9 / freq.QuadPart));
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long) t.tv_sec * 1000000000ULL + t.tv_nsec;
+#endif
+}
+
+/* Process wide locks
+ * For the data shared by all interpreters. Hold them shortly, without
+ * calling Python code, or use pyswe_lock_nogil.
+ */
+#ifdef WIN32
+typedef SRWLOCK pyswe_lock_t;
+#define PYSWE_LOCK_INIT     SRWLOCK_INIT
+#define pyswe_lock(l)       AcquireSRWLockExclusive(l)
+#define pyswe_trylock(l)    TryAcquireSRWLockExclusive(l)
+#define pyswe_unlock(l)     ReleaseSRWLockExclusive(l)
+#else
+typedef pthread_mutex_t pyswe_lock_t;
+#define PYSWE_LOCK_INIT     PTHREAD_MUTEX_INITIALIZER
+#define pyswe_lock(l)       pthread_mutex_lock(l)
+#define pyswe_trylock(l)    (pthread_mutex_trylock(l) == 0)
+#define pyswe_unlock(l)     pthread_mutex_unlock(l)
+#endif
+
+/* Condition variables, used with a pyswe_lock_t */
+#ifdef WIN32
+typedef CONDITION_VARIABLE pyswe_cond_t;
+#define PYSWE_COND_INIT         CONDITION_VARIABLE_INIT
+#define pyswe_cond_wait(c, l)   SleepConditionVariableSRW(c, l, INFINITE, 0)
+#define pyswe_cond_broadcast(c) WakeAllConditionVariable(c)
+#else
+typedef pthread_cond_t pyswe_cond_t;
+#define PYSWE_COND_INIT         PTHREAD_COND_INITIALIZER
+#define pyswe_cond_wait(c, l)   pthread_cond_wait(c, l)
+#define pyswe_cond_broadcast(c) pthread_cond_broadcast(c)
+#endif
+
+#if PYSWE_SWE_TLS
+/* Wait at most ms milliseconds */
+static void pyswe_cond_timedwait(pyswe_cond_t* c, pyswe_lock_t* l, int ms)
+{
+#ifdef WIN32
+    SleepConditionVariableSRW(c, l, ms, 0);
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    t.tv_sec += ms / 1000;
+    t.tv_nsec += (ms % 1000) * 1000000L;
+    if (t.tv_nsec >= 1000000000L) {
+        ++t.tv_sec;
+        t.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(c, l, &t);
+#endif
+}
+#endif /* PYSWE_SWE_TLS */
+
+#if PYSWE_USE_SWEPHELP
+/* Take a lock, releasing the GIL while waiting
+ * For locks held while running Python code, that could let other threads
+ * of the interpreter run.
+ */
+static void pyswe_lock_nogil(pyswe_lock_t* l)
+{
+    if (pyswe_trylock(l))
+        return;
+    Py_BEGIN_ALLOW_THREADS
+    pyswe_lock(l);
+    Py_END_ALLOW_THREADS
+}
+#endif
+
+/* Check a buffer format is native double
+ * Return 1 if it is
+ */
+static int pyswe_fmt_is_d(const char* fmt)
+{
+    if (!fmt)
+        return 0;
+    if (*fmt == '@' || *fmt == '='
+#if PY_LITTLE_ENDIAN
+        || *fmt == '<'
+#else
+        || *fmt == '>' || *fmt == '!'
+#endif
+        )
+        ++fmt;
+    return fmt[0] == 'd' && fmt[1] == '\0';
+}
+
 /* Take a sequence and extract double
  * Return > 0 on error:
  *  1 (not a seq)
@@ -85,11 +415,65 @@
  *  3 (bad item type)
  * => must raise TypeError
  * Return 4 if an exception is already raised (overflow)
+ *
+ * Exact tuples and lists of float or int, and buffers of double, are read
+ * directly. Other sequences (and items) take the generic path.
  */
 int py_seq2d(PyObject* seq, int len, double* res, char err[128])
 {
     int i;
+    Py_ssize_t n = 0;
     PyObject* o;
+    PyObject** items = NULL;
+    Py_buffer view;
+    /* tuple or list */
+    if (PyTuple_CheckExact(seq) || PyList_CheckExact(seq)) {
+        n = PySequence_Fast_GET_SIZE(seq);
+        items = PySequence_Fast_ITEMS(seq);
+    }
+    if (items && n >= len) {
+        int ret = -1;
+        /* a list can be resized by another thread */
+        Py_BEGIN_CRITICAL_SECTION(seq);
+        n = PySequence_Fast_GET_SIZE(seq);
+        items = PySequence_Fast_ITEMS(seq);
+        for (i = 0; i < len && i < n; ++i) {
+            o = items[i];
+            if (PyFloat_CheckExact(o))
+                res[i] = PyFloat_AS_DOUBLE(o);
+            else if (PyLong_CheckExact(o)) {
+                res[i] = PyLong_AsDouble(o);
+                if (res[i] == -1 && PyErr_Occurred()) {
+                    ret = 4;
+                    break;
+                }
+            }
+            else
+                break;
+        }
+        if (i == len)
+            ret = 0;
+        Py_END_CRITICAL_SECTION();
+        if (ret >= 0)
+            return ret;
+    }
+    /* buffer of double */
+    else if (!items && PyObject_CheckBuffer(seq)) {
+        if (PyObject_GetBuffer(seq, &view, PyBUF_STRIDES|PyBUF_FORMAT) < 0)
+            PyErr_Clear();
+        else {
+            if (view.ndim == 1 && view.shape[0] >= len
+                && view.itemsize == sizeof(double)
+                && pyswe_fmt_is_d(view.format)) {
+                for (i = 0; i < len; ++i)
+                    memcpy(&res[i], (char*) view.buf + i * view.strides[0],
+                           sizeof(double));
+                PyBuffer_Release(&view);
+                return 0;
+            }
+            PyBuffer_Release(&view);
+        }
+    }
     /* check it is a sequence */
     if (!PySequence_Check(seq)) {
         memset(err, 0, sizeof(char) * 128);
@@ -97,7 +481,10 @@ int py_seq2d(PyObject* seq, int len, double* res, char err[128])
         return 1;
     }
     /* check sequence length */
-    if (PySequence_Length(seq) < len) {
+    n = PySequence_Length(seq);
+    if (n == -1 && PyErr_Occurred())
+        return 4;
+    if (n < len) {
         memset(err, 0, sizeof(char) * 128);
         snprintf(err, 127, "is not a sequence of length >= %d", len);
         return 2;
@@ -105,6 +492,8 @@ int py_seq2d(PyObject* seq, int len, double* res, char err[128])
     for (i = 0; i < len; ++i) {
         /* check there are numbers */
         o = PySequence_ITEM(seq, i);
+        if (!o)
+            return 4;
         if (!PyNumber_Check(o)) {
             memset(err, 0, sizeof(char) * 128);
             snprintf(err, 127, "item %d is not a number", i);
@@ -169,3259 +558,7768 @@ int py_obj2plstar(PyObject* body, int* pl, char** star)
     return 0;
 }
 
-/* swisseph.Error (module exception type) */
-static PyObject * pyswe_Error;
-
-/* swisseph.azalt */
-PyDoc_STRVAR(pyswe_azalt__doc__,
-"Calculate horizontal coordinates (azimuth and altitude) of a planet or a star"
-" from either ecliptical or equatorial coordinates.\n\n"
-":Args: float tjdut, int flag, seq geopos, float atpress, float attemp,"
-" seq xin\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flag: either ECL2HOR (from ecliptical coord) or EQU2HOR (equatorial)\n"
-" - geopos: a sequence with:\n"
-"    - 0: geographic longitude, in degrees (eastern positive)\n"
-"    - 1: geographic latitude, in degrees (northern positive)\n"
-"    - 2: geographic altitude, in meters above sea level\n"
-" - atpress: atmospheric pressure in mbar (hPa)\n"
-" - attemp: atmospheric temperature in degrees Celsius\n"
-" - xin: a sequence with:\n"
-"    - ECL2HOR: ecl. longitude, ecl. latitude, distance\n"
-"    - EQU2HOR: right ascension, declination, distance\n\n"
-":Return: float azimuth, true_altitude, apparent_altitude\n\n"
-" - azimuth: position degree, measured from south point to west\n"
-" - true_altitude: true altitude above horizon in degrees\n"
-" - apparent_altitude: apparent (refracted) altitude above horizon in"
-"   degrees\n\n"
-"The apparent altitude of a body depends on the atmospheric pressure and"
-" temperature. If only the true altitude is required, these parameters can be"
-" neglected.\n\n"
-"If ``atpress`` is given the value 0, the function estimates the pressure from"
-" the geographical altitude given in ``xin[3]`` and ``attemp``. If ``xin[3]``"
-" is 0, ``atpress`` will be estimated for sea level.");
+#if PYSWE_FASTCALL
+/* Fastcall arguments
+ *
+ * Only exact float, int and bytes objects are converted here. Anything
+ * else (subclasses, overflows, bad arguments) goes through the METH_VARARGS
+ * function, so that conversions and error messages remain those of
+ * PyArg_ParseTupleAndKeywords.
+ *
+ * Return > 0 if the argument must be handled by the fallback.
+ */
+static int pyswe_fast_d(PyObject* o, double* d)
+{
+    if (PyFloat_CheckExact(o))
+        *d = PyFloat_AS_DOUBLE(o);
+    else if (PyLong_CheckExact(o)) {
+        *d = PyLong_AsDouble(o);
+        if (*d == -1 && PyErr_Occurred()) {
+            PyErr_Clear();
+            return 1;
+        }
+    }
+    else
+        return 1;
+    return 0;
+}
 
-static PyObject * pyswe_azalt FUNCARGS_KEYWDS
+static int pyswe_fast_i(PyObject* o, int* i)
 {
-    double jd, geo[3], xin[3], press, temp, xaz[3];
-    int i, flag;
-    PyObject *pygeo, *pyxin;
-    char err[128] = {0};
-    static char *kwlist[] = {"tjdut", "flag", "geopos", "atpress", "attemp",
-                             "xin", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "diOddO", kwlist, &jd,
-                                     &flag, &pygeo, &press, &temp, &pyxin))
-        return NULL;
-    /* extract geopos */
-    i = py_seq2d(pygeo, 3, geo, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                           "swisseph.azalt: geopos: %s", err);
-    /* extract xin */
-    i = py_seq2d(pyxin, 3, xin, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                           "swisseph.azalt: xin: %s", err);
-    swe_azalt(jd, flag, geo, press, temp, xin, xaz);
-    return Py_BuildValue("ddd", xaz[0], xaz[1], xaz[2]);
+    long l;
+    if (!PyLong_CheckExact(o))
+        return 1;
+    l = PyLong_AsLong(o);
+    if (l == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return 1;
+    }
+    if (l < INT_MIN || l > INT_MAX)
+        return 1;
+    *i = (int) l;
+    return 0;
 }
 
-/* swisseph.azalt_rev */
-PyDoc_STRVAR(pyswe_azalt_rev__doc__,
-"Calculate either ecliptical or equatorial coordinates from azimuth and true"
-" altitude.\n\n"
-":Args: float tjdut, int flag, seq geopos, double azimuth, double"
-" true_altitude\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flag: either HOR2ECL (to ecliptical coord) or HOR2EQU (to equatorial)\n"
-" - geopos: a sequence with:\n"
-"    - 0: geographic longitude, in degrees (eastern positive)\n"
-"    - 1: geographic latitude, in degrees (northern positive)\n"
-"    - 2: geographic altitude, in meters above sea level)\n"
-" - azimuth: position degree, measured from south point to west\n"
-" - true_altitude: true altitude above horizon in degrees\n\n"
-":Return: float x1, x2\n\n"
-" - x1, x2: ecliptical or equatorial coordinates, depending on flag\n\n"
-"This function is not precisely the reverse of ``azalt()``. It computes either"
-" ecliptical or equatorial coordinates from azimuth and true altitude. If"
-" only an apparent altitude is given, the true altitude has to be computed"
-" first with the function ``refrac()``.");
-
-static PyObject * pyswe_azalt_rev FUNCARGS_KEYWDS
+static int pyswe_fast_c(PyObject* o, int* c)
 {
-    double jd, geo[3], xin[2], xout[2];
-    int i, flag;
-    char err[128] = {0};
-    PyObject *pygeo;
-    static char *kwlist[] = {"tjdut", "flag", "geopos", "azimuth",
-                             "true_altitude", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "diOdd", kwlist, &jd,
-                                     &flag, &pygeo, &xin[0], &xin[1]))
-        return NULL;
-    /* extract geopos */
-    i = py_seq2d(pygeo, 3, geo, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                        "swisseph.azalt_rev: geopos: %s", err);
-    swe_azalt_rev(jd, flag, geo, xin, xout);
-    return Py_BuildValue("dd", xout[0], xout[1]);
+    if (!PyBytes_CheckExact(o) || PyBytes_GET_SIZE(o) != 1)
+        return 1;
+    *c = (unsigned char) PyBytes_AS_STRING(o)[0];
+    return 0;
 }
 
-/* swisseph.calc */
-PyDoc_STRVAR(pyswe_calc__doc__,
-"Calculate planetary positions (ET).\n\n"
-":Args: float tjdet, int planet, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
-" - tjdet: Julian day, Ephemeris Time, where tjdet == tjdut + deltat(tjdut)\n"
-" - planet: body number\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function can raise swisseph.Error in case of fatal error.");
+/* Put positional and keyword arguments in the slots of kwlist
+ * Return > 0 if the fallback must raise the appropriate error
+ * (too many arguments, unknown or duplicate keyword, missing argument).
+ */
+static int pyswe_fast_args(PyObject *const *args, Py_ssize_t nargs,
+                           PyObject* kwnames, char** kwlist, int nreq,
+                           PyObject** a)
+{
+    Py_ssize_t i, j, n = 0, nkw = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    while (kwlist[n])
+        a[n++] = NULL;
+    if (nargs > n)
+        return 1;
+    for (i = 0; i < nargs; ++i)
+        a[i] = args[i];
+    for (i = 0; i < nkw; ++i) {
+        for (j = nargs; j < n; ++j) {
+            if (!PyUnicode_CompareWithASCIIString(PyTuple_GET_ITEM(kwnames, i),
+                                                  kwlist[j]))
+                break;
+        }
+        if (j == n || a[j])
+            return 1;
+        a[j] = args[nargs + i];
+    }
+    for (i = 0; i < nreq; ++i) {
+        if (!a[i])
+            return 1;
+    }
+    return 0;
+}
 
-static PyObject * pyswe_calc FUNCARGS_KEYWDS
+/* Call a METH_VARARGS|METH_KEYWORDS function with fastcall arguments */
+static PyObject * pyswe_fast_fallback(PyCFunctionWithKeywords func,
+                                      PyObject* self, PyObject *const *args,
+                                      Py_ssize_t nargs, PyObject* kwnames)
 {
-    double jd, xx[6];
-    int ret, pl, flag = SEFLG_SWIEPH|SEFLG_SPEED;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|i", kwlist,
-                                     &jd, &pl, &flag))
+    Py_ssize_t i, nkw = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    PyObject *tup, *kwds = NULL, *ret = NULL;
+    tup = PyTuple_New(nargs);
+    if (!tup)
         return NULL;
-    ret = swe_calc(jd, pl, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.calc: %s", err);
-    return Py_BuildValue("(dddddd)i",xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],ret);
+    for (i = 0; i < nargs; ++i) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(tup, i, args[i]);
+    }
+    if (nkw) {
+        kwds = PyDict_New();
+        if (!kwds)
+            goto end;
+        for (i = 0; i < nkw; ++i) {
+            if (PyDict_SetItem(kwds, PyTuple_GET_ITEM(kwnames, i),
+                               args[nargs + i]))
+                goto end;
+        }
+    }
+    ret = func(self, tup, kwds);
+end:
+    Py_DECREF(tup);
+    Py_XDECREF(kwds);
+    return ret;
 }
+#endif /* PYSWE_FASTCALL */
 
-/* swisseph.calc_pctr */
-PyDoc_STRVAR(pyswe_calc_pctr__doc__,
-"Calculate planetocentric positions of planets (ET).\n\n"
-":Args: float tjd, int planet, int center, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
-" - tjdet: julian day in ET (TT)\n"
-" - planet: body number of target object\n"
-" - center: body number of center object\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function can raise swisseph.Error in case of fatal error.");
+/* Module state (PEP 489 multi-phase init)
+ *
+ * Exceptions, types and call statistics belong to the module object, so
+ * that each interpreter has its own. The contrib submodule keeps a reference
+ * to the main module, and uses its state.
+ */
+typedef struct {
+    PyObject* error; /* swisseph.Error */
+    PyTypeObject* position_type; /* struct sequences */
+    PyTypeObject* ascmc_type;
+    PyTypeObject* houses_type;
+    PyTypeObject* houses_speed_type;
+    PyTypeObject* heliacal_pheno_type;
+    PyTypeObject* compact_type; /* swisseph.CompactEphemeris */
+    PyTypeObject* table_type; /* swisseph.EphemerisTable */
+    PyTypeObject* timed_type; /* call statistics */
+    PyObject* stats_registry; /* name -> pyswe_Timed */
+    int stats_enabled;
+    PyObject* slow_hook; /* callback of set_slow_call_hook */
+    unsigned long long slow_ns; /* threshold */
+#ifdef Py_GIL_DISABLED
+    PyMutex mutex; /* slow_hook and slow_ns */
+#endif
+    PyObject* aio_get_loop; /* asyncio.get_running_loop */
+    PyObject* aio_set_future; /* completes the futures of swisseph.aio */
+#if PYSWE_USE_SWEPHELP
+    PyObject* contrib_error; /* swisseph.contrib.Error */
+    PyTypeObject* user_type; /* swisseph.contrib.User */
+    PyTypeObject* data_type; /* swisseph.contrib.Data */
+    PyTypeObject* place_type; /* swisseph.contrib.AtlasPlace */
+    PyTypeObject* atlas_index_type; /* swisseph.contrib.AtlasIndex */
+    PyObject* atlas_index; /* of atlas_index() */
+#endif
+} pyswe_State;
 
-static PyObject * pyswe_calc_pctr FUNCARGS_KEYWDS
-{
-    double jd, xx[6];
-    int ret, pl, plctr, flag = SEFLG_SWIEPH|SEFLG_SPEED;
-    char err[256] = {0};
-    static char* kwlist[] = {"tjdet", "planet", "center", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dii|i", kwlist,
-                                     &jd, &pl, &plctr, &flag))
-        return NULL;
-    ret = swe_calc_pctr(jd, pl, plctr, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.calc_pctr: %s", err);
-    return Py_BuildValue("(dddddd)i",xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],ret);
-}
+#define pyswe_get_state(m)  ((pyswe_State*) PyModule_GetState(m))
 
-/* swisseph.calc_ut */
-PyDoc_STRVAR(pyswe_calc_ut__doc__,
-"Calculate planetary positions (UT).\n\n"
-":Args: float tjdut, int planet, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
-" - tjdut: julian day number, universal time\n"
-" - planet: body number\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function can raise swisseph.Error in case of fatal error.");
+#ifdef Py_GIL_DISABLED
+#define pyswe_state_lock(st)    PyMutex_Lock(&(st)->mutex)
+#define pyswe_state_unlock(st)  PyMutex_Unlock(&(st)->mutex)
+#else
+#define pyswe_state_lock(st)
+#define pyswe_state_unlock(st)
+#endif
 
-static PyObject * pyswe_calc_ut FUNCARGS_KEYWDS
-{
-    double jd, xx[6];
-    int ret, pl, flag = SEFLG_SWIEPH|SEFLG_SPEED;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "planet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|i", kwlist,
-                                     &jd, &pl, &flag))
-        return NULL;
-    ret = swe_calc_ut(jd, pl, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.calc_ut: %s", err);
-    return Py_BuildValue("(dddddd)i",xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],ret);
-}
+#if PYSWE_USE_SWEPHELP
+typedef struct {
+    PyObject* parent; /* swisseph */
+} pyswh_State;
 
-/* swisseph.close */
-PyDoc_STRVAR(pyswe_close__doc__,
-"Close Swiss Ephemeris.\n\n"
-":Args: --\n"
-":Return: None\n\n"
-"At the end of your computations you can release all resources (open files and"
-" allocated memory) used by the swisseph module.\n\n"
-"After ``close()``, no swisseph functions should be used unless you call"
-" ``set_ephe_path()`` again and, if required, ``set_jpl_file()``.");
+/* State of swisseph, from swisseph.contrib */
+#define pyswh_get_state(m) \
+        pyswe_get_state(((pyswh_State*) PyModule_GetState(m))->parent)
+#endif
 
-static PyObject * pyswe_close FUNCARGS_SELF
+#if PY_VERSION_HEX >= 0x03090000
+/* Get the state from a type of the module, or from a subclass */
+static pyswe_State * pyswe_type_state(PyTypeObject* tp)
 {
-    swe_close();
-    Py_RETURN_NONE;
+    while (!(tp->tp_flags & Py_TPFLAGS_HEAPTYPE)
+           || !((PyHeapTypeObject*) tp)->ht_module)
+        tp = tp->tp_base;
+    return pyswe_get_state(((PyHeapTypeObject*) tp)->ht_module);
 }
+#else
+/* Types do not know their module before Python 3.9, use the last one */
+static pyswe_State* pyswe_last_state = NULL;
+#define pyswe_type_state(tp)    pyswe_last_state
+#endif
 
-/* swisseph.cotrans */
-PyDoc_STRVAR(pyswe_cotrans__doc__,
-"Coordinate transformation from ecliptic to equator or vice-versa.\n\n"
-":Args: seq coord, float eps\n\n"
-" - coord: tuple of 3 float for coordinates:\n"
-"    - 0: longitude\n"
-"    - 1: latitude\n"
-"    - 2: distance (unchanged, can be set to 1)\n"
-" - eps: obliquity of ecliptic, in degrees\n\n"
-":Return: float retlon, retlat, retdist\n\n"
-" - retlon: converted longitude\n"
-" - retlat: converted latitude\n"
-" - retdist: converted distance\n\n"
-"For equatorial to ecliptical, obliquity must be positive. From ecliptical to"
-" equatorial, obliquity must be negative. Longitude, latitude and obliquity"
-" are in positive degrees.");
-
-static PyObject * pyswe_cotrans FUNCARGS_KEYWDS
+/* Create a type of the module
+ * Return NULL on error
+ */
+static PyTypeObject * pyswe_new_type(PyObject* m, PyType_Spec* spec)
 {
-    double xpo[3], xpn[3], eps;
-    PyObject *o;
-    int i;
-    char err[128] = {0};
-    static char *kwlist[] = {"coord", "eps", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Od", kwlist, &o, &eps))
-        return NULL;
-    /* extract coord */
-    i = py_seq2d(o, 3, xpo, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                           "swisseph.cotrans: coord: %s", err);
-    swe_cotrans(xpo, xpn, eps);
-    return Py_BuildValue("ddd", xpn[0], xpn[1], xpn[2]);
+#if PY_VERSION_HEX >= 0x03090000
+    return (PyTypeObject*) PyType_FromModuleAndSpec(m, spec, NULL);
+#else
+    return (PyTypeObject*) PyType_FromSpec(spec);
+#endif
 }
 
-/* swisseph.cotrans_sp */
-PyDoc_STRVAR(pyswe_cotrans_sp__doc__,
-"Coordinate transformation of position and speed, from ecliptic to equator"
-" or vice-versa.\n\n"
-":Args: seq coord, float eps\n\n"
-" - coord: tuple of 6 float for coordinates:\n"
-"    - 0: longitude\n"
-"    - 1: latitude\n"
-"    - 2: distance\n"
-"    - 3: longitude speed\n"
-"    - 4: latitude speed\n"
-"    - 5: distance speed\n"
-" - eps: obliquity of ecliptic, in degrees\n\n"
-":Return: float retlon, retlat, retdist, retlonsp, retlatsp, retdistsp\n\n"
-" - retlon, retlonsp: converted longitude and its speed\n"
-" - retlat, retlatsp: converted latitude and its speed\n"
-" - retdist, retdistsp: converted distance and its speed\n\n"
-"For equatorial to ecliptical, obliquity must be positive. From ecliptical to"
-" equatorial, obliquity must be negative. Longitude, latitude, their speeds"
-" and obliquity are in positive degrees.");
+/* Struct sequences
+ *
+ * Tuple subclasses with named fields, filled with PyFloat_FromDouble.
+ */
 
-static PyObject * pyswe_cotrans_sp FUNCARGS_KEYWDS
+static PyStructSequence_Field pyswe_Position_fields[] = {
+    {"lon", "longitude (or right ascension, or x)"},
+    {"lat", "latitude (or declination, or y)"},
+    {"dist", "distance in AU (or z)"},
+    {"lon_speed", "speed in longitude (deg/day)"},
+    {"lat_speed", "speed in latitude (deg/day)"},
+    {"dist_speed", "speed in distance (AU/day)"},
+    {NULL}
+};
+
+static PyStructSequence_Desc pyswe_Position_desc = {
+    "swisseph.Position",
+    "Position of a body, its meaning depends on the flags used.",
+    pyswe_Position_fields,
+    6
+};
+
+static PyStructSequence_Field pyswe_Ascmc_fields[] = {
+    {"asc", "ascendant"},
+    {"mc", "midheaven"},
+    {"armc", "right ascension of the midheaven"},
+    {"vertex", "vertex"},
+    {"equasc", "equatorial ascendant"},
+    {"coasc1", "co-ascendant (W. Koch)"},
+    {"coasc2", "co-ascendant (M. Munkasey)"},
+    {"polasc", "polar ascendant (M. Munkasey)"},
+    {NULL}
+};
+
+static PyStructSequence_Desc pyswe_Ascmc_desc = {
+    "swisseph.Ascmc",
+    "Additional points of the houses functions (or their speeds).",
+    pyswe_Ascmc_fields,
+    8
+};
+
+static PyStructSequence_Field pyswe_Houses_fields[] = {
+    {"cusps", "tuple of 12 float (Gauquelin: 36 float)"},
+    {"ascmc", "additional points"},
+    {NULL}
+};
+
+static PyStructSequence_Desc pyswe_Houses_desc = {
+    "swisseph.Houses",
+    "Result of the houses functions.",
+    pyswe_Houses_fields,
+    2
+};
+
+static PyStructSequence_Field pyswe_HousesSpeed_fields[] = {
+    {"cusps", "tuple of 12 float (Gauquelin: 36 float)"},
+    {"ascmc", "additional points"},
+    {"cuspsspeed", "speeds of cusps"},
+    {"ascmcspeed", "speeds of additional points"},
+    {NULL}
+};
+
+static PyStructSequence_Desc pyswe_HousesSpeed_desc = {
+    "swisseph.HousesSpeed",
+    "Result of the houses functions with speeds.",
+    pyswe_HousesSpeed_fields,
+    4
+};
+
+static PyStructSequence_Field pyswe_HeliacalPheno_fields[] = {
+    {"alt_o", "topocentric altitude of object (unrefracted)"},
+    {"app_alt_o", "apparent altitude of object (refracted)"},
+    {"geo_alt_o", "geocentric altitude of object"},
+    {"azi_o", "azimuth of object"},
+    {"alt_s", "topocentric altitude of Sun"},
+    {"azi_s", "azimuth of Sun"},
+    {"tav_act", "actual topocentric arcus visionis"},
+    {"arcv_act", "actual (geocentric) arcus visionis"},
+    {"daz_act", "actual difference between object's and sun's azimuth"},
+    {"arcl_act", "actual longitude difference between object and sun"},
+    {"k_act", "extinction coefficient"},
+    {"min_tav", "smallest topocentric arcus visionis"},
+    {"tfirst_vr", "first time object is visible, according to VR"},
+    {"tb_vr", "optimum time the object is visible, according to VR"},
+    {"tlast_vr", "last time object is visible, according to VR"},
+    {"tb_yallop", "best time the object is visible, according to Yallop"},
+    {"w_moon", "crescent width of Moon"},
+    {"q_yal", "q-test value of Yallop"},
+    {"q_crit", "q-test criterion of Yallop"},
+    {"par_o", "parallax of object"},
+    {"magn", "magnitude of object"},
+    {"rise_o", "rise/set time of object"},
+    {"rise_s", "rise/set time of Sun"},
+    {"lag", "rise/set time of object minus rise/set time of Sun"},
+    {"tvis_vr", "visibility duration"},
+    {"l_moon", "crescent length of Moon"},
+    {"cva_act", "CVAact"},
+    {"illum", "illumination"},
+    {"cva_act_new", "CVAact (new)"},
+    {"msk", "MSk"},
+    {"reserved30", NULL},
+    {"reserved31", NULL},
+    {"reserved32", NULL},
+    {"reserved33", NULL},
+    {"reserved34", NULL},
+    {"reserved35", NULL},
+    {"reserved36", NULL},
+    {"reserved37", NULL},
+    {"reserved38", NULL},
+    {"reserved39", NULL},
+    {"reserved40", NULL},
+    {"reserved41", NULL},
+    {"reserved42", NULL},
+    {"reserved43", NULL},
+    {"reserved44", NULL},
+    {"reserved45", NULL},
+    {"reserved46", NULL},
+    {"reserved47", NULL},
+    {"reserved48", NULL},
+    {"reserved49", NULL},
+    {NULL}
+};
+
+static PyStructSequence_Desc pyswe_HeliacalPheno_desc = {
+    "swisseph.HeliacalPheno",
+    "Result of heliacal_pheno_ut.",
+    pyswe_HeliacalPheno_fields,
+    50
+};
+
+/* Set n float items of a tuple (or struct sequence), from index start
+ * Return o, or NULL (o is released) on error
+ */
+static PyObject * pyswe_fill_d(PyObject* o, Py_ssize_t start, const double* d,
+                               int n)
 {
-    double xpo[6], xpn[6], eps;
     int i;
-    PyObject *o;
-    char err[128] = {0};
-    static char *kwlist[] = {"coord", "eps", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Od", kwlist, &o, &eps))
+    PyObject* f;
+    if (!o)
         return NULL;
-    /* extract coord */
-    i = py_seq2d(o, 6, xpo, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                        "swisseph.cotrans_sp: coord: %s", err);
-    swe_cotrans_sp(xpo, xpn, eps);
-    return Py_BuildValue("dddddd", xpn[0],xpn[1],xpn[2],xpn[3],xpn[4],xpn[5]);
+    for (i = 0; i < n; ++i) {
+        f = PyFloat_FromDouble(d[i]);
+        if (!f) {
+            Py_DECREF(o);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(o, start + i, f);
+    }
+    return o;
 }
 
-/* swisseph.cs2degstr */
-PyDoc_STRVAR(pyswe_cs2degstr__doc__,
-"Get degrees string from centiseconds.\n\n"
-":Args: int cs\n"
-":Return: str retstr");
-
-static PyObject * pyswe_cs2degstr FUNCARGS_KEYWDS
+/* Make a tuple of n float */
+static PyObject * pyswe_dtuple(const double* d, int n)
 {
-    int cs;
-    char ret[9];
-    static char *kwlist[] = {"cs", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &cs))
-        return NULL;
-    swe_cs2degstr(cs, ret);
-    return Py_BuildValue("s", ret);
+    return pyswe_fill_d(PyTuple_New(n), 0, d, n);
 }
 
-/* swisseph.cs2lonlatstr */
-PyDoc_STRVAR(pyswe_cs2lonlatstr__doc__,
-"Get longitude or latitude string from centiseconds.\n\n"
-":Args: int cs, bytes plus, bytes minus\n"
-":Return: str retstr\n\n"
-"This function raises TypeError if plus or minus parameter length is not"
-" exactly 1 byte.");
-
-static PyObject * pyswe_cs2lonlatstr FUNCARGS_KEYWDS
+/* Make a Position from 6 double */
+static PyObject * pyswe_position(pyswe_State* st, const double* xx)
 {
-    int cs;
-    char ret[10], plus, minus;
-    static char *kwlist[] = {"cs", "plus", "minus", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "icc", kwlist,
-                                     &cs, &plus, &minus))
-        return NULL;
-    swe_cs2lonlatstr(cs, plus, minus, ret);
-    return Py_BuildValue("s", ret);
+    return pyswe_fill_d(PyStructSequence_New(st->position_type), 0, xx, 6);
 }
 
-/* swisseph.cs2timestr */
-PyDoc_STRVAR(pyswe_cs2timestr__doc__,
-"Get time string from centiseconds.\n\n"
-":Args: int cs, bytes sep, bool suppresszero=False\n"
-":Return: str retstr\n\n"
-"This function raises TypeError if sep parameter length is not exactly 1"
-" byte.");
-
-static PyObject * pyswe_cs2timestr FUNCARGS_KEYWDS
+/* Make the (Position, int retflags) result of calc functions */
+static PyObject * pyswe_calc_result(pyswe_State* st, const double* xx, int ret)
 {
-    int cs, sep, suppresszero = 0;
-    char ret[9];
-    static char *kwlist[] = {"cs", "sep", "suppresszero", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ic|i", kwlist,
-                                     &cs, &sep, &suppresszero))
+    PyObject *tup, *o;
+    tup = PyTuple_New(2);
+    if (!tup)
         return NULL;
-    swe_cs2timestr(cs, sep, suppresszero, ret);
-    return Py_BuildValue("s", ret);
+    o = pyswe_position(st, xx);
+    if (!o) {
+        Py_DECREF(tup);
+        return NULL;
+    }
+    PyTuple_SET_ITEM(tup, 0, o);
+    o = PyLong_FromLong(ret);
+    if (!o) {
+        Py_DECREF(tup);
+        return NULL;
+    }
+    PyTuple_SET_ITEM(tup, 1, o);
+    return tup;
 }
 
-/* swisseph.csnorm */
-PyDoc_STRVAR(pyswe_csnorm__doc__,
-"Normalization of any centisecond number to the range [0;360].\n\n"
-":Args: int cs\n"
-":Return: int retcs");
+/* Copy n double into the out= buffer of a function
+ * The buffer must be writable, contiguous, of native float64 items.
+ * Return > 0 on error, with TypeError raised
+ */
+static int pyswe_out_d(PyObject* out, const double* d, int n, const char* fn)
+{
+    Py_buffer view;
+    if (PyObject_GetBuffer(out, &view, PyBUF_CONTIG|PyBUF_FORMAT) < 0)
+        goto error;
+    if (!pyswe_fmt_is_d(view.format) || view.itemsize != sizeof(double)
+        || view.len < (Py_ssize_t) (n * sizeof(double))) {
+        PyBuffer_Release(&view);
+        goto error;
+    }
+    memcpy(view.buf, d, n * sizeof(double));
+    PyBuffer_Release(&view);
+    return 0;
+error:
+    PyErr_Clear();
+    PyErr_Format(PyExc_TypeError, "swisseph.%s: out: must be a writable"
+                 " contiguous buffer of %d float64", fn, n);
+    return 1;
+}
 
-static PyObject * pyswe_csnorm FUNCARGS_KEYWDS
+/* Initialize the struct sequence types
+ * Return > 0 on error
+ */
+static int pyswe_init_structseq(PyObject* m, pyswe_State* st)
 {
-    int cs;
-    static char *kwlist[] = {"cs", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &cs))
-        return NULL;
-    return Py_BuildValue("i", swe_csnorm(cs));
+#if PY_VERSION_HEX < 0x03080000
+    /* heap struct sequences are broken before Python 3.8 */
+    static PyTypeObject statics[5];
+#endif
+    PyTypeObject* tp;
+    struct {
+        PyTypeObject** tp;
+        PyStructSequence_Desc* desc;
+        const char* name;
+    } *p, types[] = {
+        {&st->position_type, &pyswe_Position_desc, "Position"},
+        {&st->ascmc_type, &pyswe_Ascmc_desc, "Ascmc"},
+        {&st->houses_type, &pyswe_Houses_desc, "Houses"},
+        {&st->houses_speed_type, &pyswe_HousesSpeed_desc, "HousesSpeed"},
+        {&st->heliacal_pheno_type, &pyswe_HeliacalPheno_desc,
+         "HeliacalPheno"},
+        {NULL, NULL, NULL}
+    };
+    for (p = types; p->tp; ++p) {
+#if PY_VERSION_HEX >= 0x03080000
+        if (!(tp = PyStructSequence_NewType(p->desc)))
+            return 1;
+#else
+        tp = &statics[p - types];
+        if (!tp->tp_name && PyStructSequence_InitType2(tp, p->desc) < 0)
+            return 1;
+        Py_INCREF(tp);
+#endif
+        *p->tp = tp;
+        Py_INCREF(tp);
+        if (PyModule_AddObject(m, p->name, (PyObject*) tp) < 0) {
+            Py_DECREF(tp);
+            return 1;
+        }
+    }
+    return 0;
 }
 
-/* swisseph.csroundsec */
-PyDoc_STRVAR(pyswe_csroundsec__doc__,
-"Round centiseconds, but at 29.5959 always down.\n\n"
-":Args: int cs\n"
-":Return: int retcs");
+#if PYSWE_USE_MMAP
+/* Ephemeris files mapped in memory by set_ephe_path(mmap=True)
+ *
+ * Files are mapped read-only and shared. When the module wraps the stdio
+ * functions of libswe (PYSWE_USE_IO_STATS), libswe opens the mapped files
+ * with fmemopen, and reads them from the mapping without system calls.
+ * Otherwise the mapping only reads the files ahead in the page cache. In
+ * both cases the pages are those of the page cache, shared with the other
+ * processes, and libswe still copies the segments it uses in its buffers.
+ *
+ * A mapping is released by close() or the next set_ephe_path() call, but
+ * unmapped only when the streams of libswe reading it (in other threads)
+ * are closed. The mapping is process wide, callers hold pyswe_mapped_lock.
+ */
+typedef struct {
+    void* addr;
+    size_t len;
+    dev_t dev;
+    ino_t ino;
+    int refs; /* streams of libswe reading it */
+    int released; /* unmapped when not read anymore */
+} pyswe_MappedFile;
 
-static PyObject * pyswe_csroundsec FUNCARGS_KEYWDS
+static pyswe_MappedFile** pyswe_mapped_files = NULL;
+static int pyswe_mapped_num = 0;
+static int pyswe_mapped_max = 0;
+static pyswe_lock_t pyswe_mapped_lock = PYSWE_LOCK_INIT;
+
+static void pyswe_mapped_free(pyswe_MappedFile* f)
 {
-    int cs;
-    static char *kwlist[] = {"cs", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &cs))
-        return NULL;
-    return Py_BuildValue("i", swe_csroundsec(cs));
+    munmap(f->addr, f->len);
+    PyMem_RawFree(f);
 }
 
-/* swisseph.d2l */
-PyDoc_STRVAR(pyswe_d2l__doc__,
-"Double to integer with rounding, no overflow check.\n\n"
-":Args: float d\n"
-":Return: int i");
-
-static PyObject * pyswe_d2l FUNCARGS_KEYWDS
+/* Release the mapped files, those still read are kept until closed */
+static void pyswe_ephe_unmap(void)
 {
-    double d;
-    static char *kwlist[] = {"d", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &d))
-        return NULL;
-    return Py_BuildValue("l", swe_d2l(d));
+    int i, n = 0;
+    for (i = 0; i < pyswe_mapped_num; ++i) {
+        if (pyswe_mapped_files[i]->refs) {
+            pyswe_mapped_files[i]->released = 1;
+            pyswe_mapped_files[n++] = pyswe_mapped_files[i];
+        }
+        else
+            pyswe_mapped_free(pyswe_mapped_files[i]);
+    }
+    pyswe_mapped_num = n;
+    if (!n) {
+        PyMem_RawFree(pyswe_mapped_files);
+        pyswe_mapped_files = NULL;
+        pyswe_mapped_max = 0;
+    }
 }
 
-/* swisseph.date_conversion */
-PyDoc_STRVAR(pyswe_date_conversion__doc__,
-"Calculate Julian day number with check wether input date is correct.\n\n"
-":Args: int year, int month, int day, float hour=12.0, bytes cal=b'g'\n\n"
-" - year, month, day: input date\n"
-" - hour: input time, decimal with fraction\n"
-" - cal: calendar type, gregorian (b'g') or julian (b'j')\n\n"
-":Return: bool isvalid, float jd, (dt)\n\n"
-" - isvalid: True if the input date and time are legal\n"
-" - jd: returned Julian day number\n"
-" - dt: a tuple for, if input was not valid, corrected year, month, day, hour;\n"
-"   if input was valid, contains input date and time\n\n"
-"This function raises TypeError if cal length is not exactly 1 byte.\n"
-"It raises ValueError if cal is not b'g' or b'j'.");
+/* Map one file
+ * Return > 0 on memory error, unreadable files are skipped
+ */
+static int pyswe_ephe_map_file(const char* fpath)
+{
+    int fd, n;
+    struct stat st;
+    void* addr;
+    pyswe_MappedFile* f, **p;
+    if ((fd = open(fpath, O_RDONLY)) == -1)
+        return 0;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return 0;
+#ifdef MADV_WILLNEED
+    madvise(addr, (size_t) st.st_size, MADV_WILLNEED);
+#endif
+    if (pyswe_mapped_num == pyswe_mapped_max) {
+        n = pyswe_mapped_max ? pyswe_mapped_max * 2 : 16;
+        if (!(p = PyMem_RawRealloc(pyswe_mapped_files, sizeof(*p) * n))) {
+            munmap(addr, (size_t) st.st_size);
+            return 1;
+        }
+        pyswe_mapped_files = p;
+        pyswe_mapped_max = n;
+    }
+    if (!(f = PyMem_RawMalloc(sizeof(*f)))) {
+        munmap(addr, (size_t) st.st_size);
+        return 1;
+    }
+    f->addr = addr;
+    f->len = (size_t) st.st_size;
+    f->dev = st.st_dev;
+    f->ino = st.st_ino;
+    f->refs = f->released = 0;
+    pyswe_mapped_files[pyswe_mapped_num++] = f;
+    return 0;
+}
 
-static PyObject * pyswe_date_conversion FUNCARGS_KEYWDS
-{
-    int year, month, day, ret, y, m, d;
-    double jd, hour = 12.0, h;
-    char cal = 'g';
-    static char *kwlist[] = {"year", "month", "day", "hour", "cal", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iii|dc", kwlist,
-                                     &year, &month, &day, &hour, &cal))
-        return NULL;
-    if (cal != 'g' && cal != 'j')
-        return PyErr_Format(PyExc_ValueError, "swisseph.date_conversion:"
-                            " invalid calendar b'%c', must be b'g' or b'j'",
-                            cal);
-    ret = swe_date_conversion(year, month, day, hour, cal, &jd);
-    if (ret == 0) {
-        y = year;
-        m = month;
-        d = day;
-        h = hour;
+/* Map the se1 files found in the directories of an ephemeris path
+ * Return > 0 on memory error
+ */
+static int pyswe_ephe_map(const char* path)
+{
+    char dir[1024], fpath[1024 + 256 + 2];
+    const char *p, *q, *env = getenv("SE_EPHE_PATH");
+    size_t len;
+    DIR* d;
+    struct dirent* e;
+    /* same as libswe, the environment overrides the argument */
+    if (env && *env)
+        path = env;
+    if (!path)
+        return 0;
+    for (p = path; *p; p = *q ? q + 1 : q) {
+        if (!(q = strchr(p, ':')))
+            q = p + strlen(p);
+        len = q - p;
+        if (len == 0 || len >= sizeof(dir))
+            continue;
+        memcpy(dir, p, len);
+        dir[len] = '\0';
+        if (!(d = opendir(dir)))
+            continue;
+        while ((e = readdir(d))) {
+            len = strlen(e->d_name);
+            if (len < 5 || strcmp(e->d_name + len - 4, ".se1"))
+                continue;
+            snprintf(fpath, sizeof(fpath), "%s/%s", dir, e->d_name);
+            if (pyswe_ephe_map_file(fpath)) {
+                closedir(d);
+                return 1;
+            }
+        }
+        closedir(d);
     }
-    else
-        swe_revjul(jd, cal == 'g' ? SE_GREG_CAL : SE_JUL_CAL, &y, &m, &d, &h);
-    return Py_BuildValue("Od(iiid)", ret == 0 ? Py_True : Py_False, jd,
-                         y, m, d, h);
+    return 0;
 }
 
-/* swisseph.day_of_week */
-PyDoc_STRVAR(pyswe_day_of_week__doc__,
-"Calculate day of week number [0;6] from Julian day number (monday is 0).\n\n"
-":Args: float jd\n"
-":Return: int dow");
+#if PYSWE_USE_IO_STATS
+/* Get the mapping of a file opened by libswe, NULL if not mapped
+ * The mapping is kept until pyswe_ephe_release.
+ */
+static pyswe_MappedFile* pyswe_ephe_mapped(const char* path)
+{
+    int i, n;
+    struct stat st;
+    pyswe_MappedFile* f = NULL;
+    pyswe_lock(&pyswe_mapped_lock);
+    n = pyswe_mapped_num;
+    pyswe_unlock(&pyswe_mapped_lock);
+    /* files are identified by device and inode, paths can differ */
+    if (!n || stat(path, &st))
+        return NULL;
+    pyswe_lock(&pyswe_mapped_lock);
+    for (i = 0; i < pyswe_mapped_num; ++i) {
+        if (!pyswe_mapped_files[i]->released
+            && pyswe_mapped_files[i]->dev == st.st_dev
+            && pyswe_mapped_files[i]->ino == st.st_ino) {
+            f = pyswe_mapped_files[i];
+            ++f->refs;
+            break;
+        }
+    }
+    pyswe_unlock(&pyswe_mapped_lock);
+    return f;
+}
 
-static PyObject * pyswe_day_of_week FUNCARGS_KEYWDS
+static void pyswe_ephe_release(pyswe_MappedFile* f)
 {
-    double jd;
-    static char *kwlist[] = {"jd", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
-        return NULL;
-    return Py_BuildValue("i", swe_day_of_week(jd));
+    int i;
+    pyswe_lock(&pyswe_mapped_lock);
+    if (!--f->refs && f->released) {
+        for (i = 0; i < pyswe_mapped_num; ++i) {
+            if (pyswe_mapped_files[i] == f) {
+                pyswe_mapped_files[i] = pyswe_mapped_files[--pyswe_mapped_num];
+                break;
+            }
+        }
+        pyswe_mapped_free(f);
+    }
+    pyswe_unlock(&pyswe_mapped_lock);
 }
+#endif /* PYSWE_USE_IO_STATS */
+#endif /* PYSWE_USE_MMAP */
 
-/* swisseph.deg_midp */
-PyDoc_STRVAR(pyswe_deg_midp__doc__,
-"Calculate midpoint (in degrees).\n\n"
-":Args: float x1, float x2\n"
-":Return: float midp");
+#if PYSWE_USE_IO_STATS
+/* Ephemeris file I/O accounting
+ *
+ * The module is linked with --wrap=fopen (etc.), so that the calls of libswe
+ * go to the __wrap_ functions below, which count and time the I/O on the
+ * ephemeris files before calling the real functions. Files are recognized by
+ * name, other files are not counted. The tables grow as needed, they are
+ * process wide, and protected by pyswe_io_lock (not held during I/O).
+ *
+ * Libswe keeps the segment of coefficients last used of each body, and seeks
+ * to read another one (a cache miss). A read following a seek is counted as a
+ * segment read. The position calls of the module (calc, calc_ut, calc_pctr)
+ * done with the Swiss or JPL ephemeris are hits if they read no segment.
+ */
+enum { PYSWE_IO_PLANET, PYSWE_IO_MOON, PYSWE_IO_ASTEROID, PYSWE_IO_FIXSTAR,
+       PYSWE_IO_JPL, PYSWE_IO_OTHER };
 
-static PyObject * pyswe_deg_midp FUNCARGS_KEYWDS
-{
-    double x1, x2;
-    static char *kwlist[] = {"x1", "x2", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &x1, &x2))
-        return NULL;
-    return Py_BuildValue("d", swe_deg_midp(x1, x2));
-}
+static const char* pyswe_io_kinds[] = {
+    "planet", "moon", "asteroid", "fixstar", "jpl", "other"};
 
-/* swisseph.degnorm */
-PyDoc_STRVAR(pyswe_degnorm__doc__,
-"Normalization of any degree number to the range [0;360[.\n\n"
-":Args: float x\n"
-":Return: float xnorm");
+typedef struct {
+    char* path; /* allocated with the struct */
+    int kind;
+    unsigned long long opens;
+    unsigned long long reads;
+    unsigned long long bytes;
+    unsigned long long seeks;
+    unsigned long long segments;
+    unsigned long long ns;
+} pyswe_IOFile;
 
-static PyObject * pyswe_degnorm FUNCARGS_KEYWDS
+typedef struct {
+    FILE* fp;
+    pyswe_IOFile* file;
+    int seeked; /* next read is a segment read */
+#if PYSWE_USE_MMAP
+    pyswe_MappedFile* map; /* read with fmemopen, or NULL */
+#endif
+} pyswe_IOStream;
+
+static pyswe_IOFile** pyswe_io_files = NULL;
+static int pyswe_io_nfiles = 0;
+static int pyswe_io_maxfiles = 0;
+
+static pyswe_IOStream* pyswe_io_open = NULL;
+static int pyswe_io_nopen = 0;
+static int pyswe_io_maxopen = 0;
+
+/* Files that could not be counted (out of memory) */
+static unsigned long long pyswe_io_untracked = 0;
+
+/* Position calls and cache hits */
+static unsigned long long pyswe_io_calls = 0;
+static unsigned long long pyswe_io_hits = 0;
+
+/* Segments read by the current thread */
+static PYSWE_THREAD_LOCAL unsigned long pyswe_io_segs = 0;
+static PYSWE_THREAD_LOCAL unsigned long pyswe_io_segs0 = 0;
+
+static pyswe_lock_t pyswe_io_lock = PYSWE_LOCK_INIT;
+
+FILE* __real_fopen(const char* path, const char* mode);
+int __real_fclose(FILE* fp);
+size_t __real_fread(void* ptr, size_t size, size_t n, FILE* fp);
+int __real_fseek(FILE* fp, long off, int whence);
+int __real_fseeko(FILE* fp, off_t off, int whence);
+char* __real_fgets(char* s, int n, FILE* fp);
+
+/* Return the kind of an ephemeris file, -1 if not an ephemeris file */
+static int pyswe_io_kind(const char* path)
 {
-    double x;
-    static char *kwlist[] = {"x", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &x))
-        return NULL;
-    return Py_BuildValue("d", swe_degnorm(x));
+    size_t len;
+    const char *p = strrchr(path, '/');
+#ifdef WIN32
+    const char *q = strrchr(path, '\\');
+    if (q && (!p || q > p))
+        p = q;
+#endif
+    p = p ? p + 1 : path;
+    len = strlen(p);
+    if (len > 4 && !strcmp(p + len - 4, ".eph"))
+        return PYSWE_IO_JPL;
+    if (!strncmp(p, "sefstars", 8) || !strncmp(p, "fixstars", 8))
+        return PYSWE_IO_FIXSTAR;
+    if (len < 4 || strcmp(p + len - 4, ".se1"))
+        return *p == 's' && *(p + 1) == 'e' ? PYSWE_IO_OTHER : -1;
+    if (!strncmp(p, "sepl", 4))
+        return PYSWE_IO_PLANET;
+    if (!strncmp(p, "semo", 4))
+        return PYSWE_IO_MOON;
+    if (!strncmp(p, "seas", 4) || (*p == 's' && ((*(p + 1) >= '0'
+        && *(p + 1) <= '9') || (*(p + 1) == 'e' && *(p + 2) >= '0'
+        && *(p + 2) <= '9'))))
+        return PYSWE_IO_ASTEROID;
+    return PYSWE_IO_OTHER;
+}
+
+/* Return the stream of a file, NULL if not counted (lock held) */
+static pyswe_IOStream* pyswe_io_stream(FILE* fp)
+{
+    int i;
+    for (i = 0; i < pyswe_io_nopen; ++i) {
+        if (pyswe_io_open[i].fp == fp)
+            return &pyswe_io_open[i];
+    }
+    return NULL;
 }
 
-/* swisseph.deltat */
-PyDoc_STRVAR(pyswe_deltat__doc__,
-"Calculate value of delta T from Julian day number.\n\n"
-":Args: float tjdut\n\n"
-"- tjdut: input time, Julian day number, Universal Time\n\n"
-":Return: float deltat\n\n"
-" - deltat: returned delta T value\n\n"
-"Reminder::\n\n"
-"   tjdet == tjdut + deltat(tjdut)\n\n"
-"This function is safe only if your application consistently uses the same"
-" ephemeris flags, if your application consistently uses the same ephemeris"
-" files, if you first call ``set_ephe_path()`` (with flag ``FLG_SWIEPH``) or"
-" ``set_jpl_file()`` (with flag ``FLG_JPLEPH``).\n\n"
-"Also, it is safe if you first call ``set_tid_acc()`` with the tidal"
-" acceleration you want. However, do not use that function unless you know"
-" what you are doing.\n\n"
-"For best control of the values returned, use function ``deltat_ex()``"
-" instead.\n\n"
-"The calculation of ephemerides in UT depends on Delta T, which depends on the"
-" ephemeris-inherent value of the tidal acceleration of the Moon. In default"
-" mode, the function ``deltat()`` automatically tries to find the required"
-" values.\n\n"
-"Two warnings must be made, though:\n\n"
-" - It is not recommended to use a mix of old and new ephemeris files, because"
-" the old files were based on JPL Ephemeris DE406, whereas the new ones are"
-" based on DE431, and both ephemerides have a different inherent tidal"
-" acceleration of the Moon. A mixture of old and new ephemeris files may lead"
-" to inconsistent ephemeris output. Using old asteroid files ``se99999.se1``"
-" together with new ones, can be tolerated, though.\n"
-" - The function ``deltat()`` uses a default value of tidal acceleration"
-" (that of DE431). However, after calling some older ephemeris, like Moshier"
-" ephemeris, DE200, or DE406, ``deltat()`` might provide slightly different"
-" values.\n\n"
-"In case of troubles related to these two points, it is recommended to either"
-" use function ``deltat_ex()``, or control the value of the tidal acceleration"
-" using the functions ``set_tid_acc()`` and ``get_tid_acc()``.");
+/* Return the file of a path, added if new, NULL if out of memory (lock held)
+ */
+static pyswe_IOFile* pyswe_io_file(const char* path, int kind)
+{
+    int i, n;
+    size_t len;
+    pyswe_IOFile* f, **p;
+    for (i = 0; i < pyswe_io_nfiles; ++i) {
+        if (!strcmp(pyswe_io_files[i]->path, path))
+            return pyswe_io_files[i];
+    }
+    if (pyswe_io_nfiles == pyswe_io_maxfiles) {
+        n = pyswe_io_maxfiles ? pyswe_io_maxfiles * 2 : 32;
+        if (!(p = PyMem_RawRealloc(pyswe_io_files, sizeof(*p) * n)))
+            return NULL;
+        pyswe_io_files = p;
+        pyswe_io_maxfiles = n;
+    }
+    len = strlen(path);
+    if (!(f = PyMem_RawCalloc(1, sizeof(*f) + len + 1)))
+        return NULL;
+    f->path = (char*) (f + 1);
+    memcpy(f->path, path, len + 1);
+    f->kind = kind;
+    pyswe_io_files[pyswe_io_nfiles++] = f;
+    return f;
+}
+
+/* Count an open stream, return > 0 if out of memory (lock held) */
+static int pyswe_io_add(FILE* fp, pyswe_IOFile* f, void* map)
+{
+    int n;
+    pyswe_IOStream* p;
+    if (pyswe_io_nopen == pyswe_io_maxopen) {
+        n = pyswe_io_maxopen ? pyswe_io_maxopen * 2 : 16;
+        if (!(p = PyMem_RawRealloc(pyswe_io_open, sizeof(*p) * n)))
+            return 1;
+        pyswe_io_open = p;
+        pyswe_io_maxopen = n;
+    }
+    p = &pyswe_io_open[pyswe_io_nopen++];
+    p->fp = fp;
+    p->file = f;
+    p->seeked = 0;
+#if PYSWE_USE_MMAP
+    p->map = map;
+#endif
+    return 0;
+}
 
-static PyObject * pyswe_deltat FUNCARGS_KEYWDS
+/* Wether a stream is counted */
+static int pyswe_io_tracked(FILE* fp)
 {
-    double jd;
-    static char *kwlist[] = {"tjdut", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
-        return NULL;
-    return Py_BuildValue("d", swe_deltat(jd));
+    int x;
+    pyswe_lock(&pyswe_io_lock);
+    x = pyswe_io_stream(fp) != NULL;
+    pyswe_unlock(&pyswe_io_lock);
+    return x;
+}
+
+/* Count reads, bytes and seeks of an operation started at t0 */
+static void pyswe_io_count(FILE* fp, int reads, size_t bytes, int seeks,
+                           unsigned long long t0)
+{
+    unsigned long long dt = pyswe_clock_ns() - t0;
+    pyswe_IOStream* s;
+    pyswe_lock(&pyswe_io_lock);
+    if ((s = pyswe_io_stream(fp))) {
+        s->file->reads += reads;
+        s->file->bytes += bytes;
+        s->file->seeks += seeks;
+        s->file->ns += dt;
+        if (seeks)
+            s->seeked = 1;
+        else if (reads && s->seeked) {
+            s->seeked = 0;
+            ++s->file->segments;
+            ++pyswe_io_segs;
+        }
+    }
+    pyswe_unlock(&pyswe_io_lock);
 }
 
-/* swisseph.deltat_ex */
-PyDoc_STRVAR(pyswe_deltat_ex__doc__,
-"Calculate value of Delta T from Julian day number (extended).\n\n"
-":Args: float tjdut, int flag\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flag: ephemeris flag, ``FLG_SWIEPH`` ``FLG_JPLEPH`` ``FLG_MOSEPH``\n\n"
-":Return: float deltat\n\n"
-" - deltat: returned delta T value\n\n"
-"Calling this function without a previous call of ``set_ephe_path()`` or "
-" ``set_jpl_file()`` will raise swisseph.Error.\n\n"
-"The calculation of ephemerides in UT depends on the ephemeris-inherent value"
-" of the tidal acceleration of the Moon. The function ``deltat_ex()`` can"
-" provide ephemeris-dependent values of Delta T and is therefore better than"
-" the old function ``deltat()``, which has to make un uncertain guess of what"
-" ephemeris is being used. One warning must be made, though:\n\n"
-"It is not recommended to use a mix of old and new ephemeris files, because the"
-" old files were based on JPL Ephemeris DE406, whereas the new ones are based"
-" on DE431, and both ephemerides have a different inherent tidal acceleration"
-" of the Moon. A mixture of old and new ephemeris files may lead to"
-" inconsistent ephemeris output. Using old asteroid files ``se99999.se1``"
-" together with new ones, can be tolerated, though.");
+/* Start a position call (see PYSWE_IO_CALC) */
+static void pyswe_io_calc_start(void)
+{
+    pyswe_io_segs0 = pyswe_io_segs;
+}
 
-static PyObject * pyswe_deltat_ex FUNCARGS_KEYWDS
+/* Count a position call with its returned flags, return them */
+static int pyswe_io_calc_end(int ret)
 {
-    double jd, ret;
-    int flag;
-    char err[256] = {0};
-    static char* kwlist[] = {"tjdut", "flag", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &flag))
-        return NULL;
-    ret = swe_deltat_ex(jd, flag, err);
-    if (err[0] != 0)
-        return PyErr_Format(pyswe_Error, "swisseph.deltat_ex: %s", err);
-    return Py_BuildValue("d", ret);
+    if (ret < 0 || !(ret & (SEFLG_SWIEPH|SEFLG_JPLEPH)))
+        return ret;
+    pyswe_lock(&pyswe_io_lock);
+    ++pyswe_io_calls;
+    if (pyswe_io_segs == pyswe_io_segs0)
+        ++pyswe_io_hits;
+    pyswe_unlock(&pyswe_io_lock);
+    return ret;
 }
 
-/* swisseph.difcs2n */
-PyDoc_STRVAR(pyswe_difcs2n__doc__,
-"Calculate distance in centisecs p1 - p2 normalized to [-180;180].\n\n"
-":Args: int p1, int p2\n"
-":Return: int dist");
+FILE* __wrap_fopen(const char* path, const char* mode)
+{
+    int kind = *mode == 'r' ? pyswe_io_kind(path) : -1;
+    unsigned long long t0 = pyswe_clock_ns();
+    pyswe_IOFile* f;
+    FILE* fp = NULL;
+#if PYSWE_USE_MMAP
+    pyswe_MappedFile* map = NULL;
+    /* read the mapped files from memory */
+    if (kind >= 0 && (map = pyswe_ephe_mapped(path))
+        && !(fp = fmemopen(map->addr, map->len, "rb"))) {
+        pyswe_ephe_release(map);
+        map = NULL;
+    }
+#else
+    void* map = NULL;
+#endif
+    if (!fp)
+        fp = __real_fopen(path, mode);
+    if (!fp || kind < 0)
+        return fp;
+    pyswe_lock(&pyswe_io_lock);
+    if (!(f = pyswe_io_file(path, kind)) || pyswe_io_add(fp, f, map)) {
+        ++pyswe_io_untracked;
+        pyswe_unlock(&pyswe_io_lock);
+#if PYSWE_USE_MMAP
+        /* the mapping could not be released on close */
+        if (map) {
+            __real_fclose(fp);
+            pyswe_ephe_release(map);
+            fp = __real_fopen(path, mode);
+        }
+#endif
+        return fp;
+    }
+    ++f->opens;
+    f->ns += pyswe_clock_ns() - t0;
+    pyswe_unlock(&pyswe_io_lock);
+    return fp;
+}
 
-static PyObject * pyswe_difcs2n FUNCARGS_KEYWDS
+int __wrap_fclose(FILE* fp)
 {
-    int p1, p2;
-    static char *kwlist[] = {"p1", "p2", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ii", kwlist, &p1, &p2))
-        return NULL;
-    return Py_BuildValue("i", swe_difcs2n(p1, p2));
+    int ret;
+    pyswe_IOStream* s;
+#if PYSWE_USE_MMAP
+    pyswe_MappedFile* map = NULL;
+#endif
+    pyswe_lock(&pyswe_io_lock);
+    if ((s = pyswe_io_stream(fp))) {
+#if PYSWE_USE_MMAP
+        map = s->map;
+#endif
+        *s = pyswe_io_open[--pyswe_io_nopen];
+    }
+    pyswe_unlock(&pyswe_io_lock);
+    ret = __real_fclose(fp);
+#if PYSWE_USE_MMAP
+    if (map)
+        pyswe_ephe_release(map);
+#endif
+    return ret;
 }
 
-/* swisseph.difcsn */
-PyDoc_STRVAR(pyswe_difcsn__doc__,
-"Calculate distance in centisecs p1 - p2.\n\n"
-":Args: int p1, int p2\n"
-":Return: int dist");
+size_t __wrap_fread(void* ptr, size_t size, size_t n, FILE* fp)
+{
+    size_t ret;
+    unsigned long long t0;
+    if (!pyswe_io_tracked(fp))
+        return __real_fread(ptr, size, n, fp);
+    t0 = pyswe_clock_ns();
+    ret = __real_fread(ptr, size, n, fp);
+    pyswe_io_count(fp, 1, ret * size, 0, t0);
+    return ret;
+}
 
-static PyObject * pyswe_difcsn FUNCARGS_KEYWDS
+int __wrap_fseek(FILE* fp, long off, int whence)
 {
-    int p1, p2;
-    static char *kwlist[] = {"p1", "p2", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ii", kwlist, &p1, &p2))
-        return NULL;
-    return Py_BuildValue("i", swe_difcsn(p1, p2));
+    int ret;
+    unsigned long long t0;
+    if (!pyswe_io_tracked(fp))
+        return __real_fseek(fp, off, whence);
+    t0 = pyswe_clock_ns();
+    ret = __real_fseek(fp, off, whence);
+    pyswe_io_count(fp, 0, 0, 1, t0);
+    return ret;
 }
 
-/* swisseph.difdeg2n */
-PyDoc_STRVAR(pyswe_difdeg2n__doc__,
-"Calculate distance in degrees p1 - p2 normalized to [-180;180].\n\n"
-":Args: float p1, float p2\n"
-":Return: float dist");
+int __wrap_fseeko(FILE* fp, off_t off, int whence)
+{
+    int ret;
+    unsigned long long t0;
+    if (!pyswe_io_tracked(fp))
+        return __real_fseeko(fp, off, whence);
+    t0 = pyswe_clock_ns();
+    ret = __real_fseeko(fp, off, whence);
+    pyswe_io_count(fp, 0, 0, 1, t0);
+    return ret;
+}
 
-static PyObject * pyswe_difdeg2n FUNCARGS_KEYWDS
+char* __wrap_fgets(char* s, int n, FILE* fp)
 {
-    double p1, p2;
-    static char *kwlist[] = {"p1", "p2", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &p1, &p2))
-        return NULL;
-    return Py_BuildValue("d", swe_difdeg2n(p1, p2));
+    char* ret;
+    unsigned long long t0;
+    if (!pyswe_io_tracked(fp))
+        return __real_fgets(s, n, fp);
+    t0 = pyswe_clock_ns();
+    ret = __real_fgets(s, n, fp);
+    pyswe_io_count(fp, 1, ret ? strlen(ret) : 0, 0, t0);
+    return ret;
 }
+#endif /* PYSWE_USE_IO_STATS */
 
-/* swisseph.difdegn */
-PyDoc_STRVAR(pyswe_difdegn__doc__,
-"Calculate distance in degrees p1 - p2.\n\n"
-":Args: float p1, float p2\n"
-":Return: float dist");
+/* Libswe settings of a thread
+ *
+ * With libswe data in thread local storage, what a thread sets (ephemeris
+ * path, sidereal mode...) is not seen by the workers of the thread pool. The
+ * setters of the module record the settings of the calling thread here, jobs
+ * take a copy of them, and workers apply it before computing. Each change
+ * takes a new (process wide) generation number, so that workers apply only
+ * what changed since their previous job.
+ */
+typedef struct {
+    unsigned long long gen; /* 0 if nothing was set */
+    char ephe_path[256];
+    int ephe_path_set;
+    char jpl_file[256];
+    int sid_mode;
+    double sid_t0;
+    double sid_ayan_t0;
+    double topo[3];
+    double tid_acc;
+    double delta_t;
+    double lapse_rate;
+} pyswe_Settings;
+
+#ifndef SE_LAPSE_RATE
+#define SE_LAPSE_RATE   0.0065 /* default of libswe */
+#endif
 
-static PyObject * pyswe_difdegn FUNCARGS_KEYWDS
+static PYSWE_THREAD_LOCAL pyswe_Settings pyswe_settings = {
+    0, "", 0, SE_FNAME_DFT, SE_SIDM_FAGAN_BRADLEY, 0, 0, {0, 0, 0},
+    SE_TIDAL_AUTOMATIC, SE_DELTAT_AUTOMATIC, SE_LAPSE_RATE};
+
+static unsigned long long pyswe_settings_gen = 0;
+
+/* Settings of the thread that imported the module first (C API) */
+static pyswe_Settings pyswe_settings_main = {
+    0, "", 0, SE_FNAME_DFT, SE_SIDM_FAGAN_BRADLEY, 0, 0, {0, 0, 0},
+    SE_TIDAL_AUTOMATIC, SE_DELTAT_AUTOMATIC, SE_LAPSE_RATE};
+
+/* Identifier of that thread, 0 before the first import */
+static unsigned long pyswe_settings_main_thread = 0;
+
+/* Take a new generation for the settings of this thread */
+static void pyswe_settings_touch(void);
+
+/* Record the ephemeris path of this thread */
+static void pyswe_settings_path(const char* path)
 {
-    double p1, p2;
-    static char *kwlist[] = {"p1", "p2", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &p1, &p2))
-        return NULL;
-    return Py_BuildValue("d", swe_difdegn(p1, p2));
+    pyswe_settings.ephe_path_set = path != NULL;
+    pyswe_settings.ephe_path[0] = '\0';
+    if (path)
+        strncat(pyswe_settings.ephe_path, path,
+                sizeof(pyswe_settings.ephe_path) - 1);
+    pyswe_settings_touch();
 }
 
-/* swisseph.difrad2n */
-PyDoc_STRVAR(pyswe_difrad2n__doc__,
-"Calculate distance in radians p1 - p2 normalized to [-180;180].\n\n"
-":Args: float p1, float p2\n"
-":Return: float dist");
+/* Set the topocentric position of this thread, as set_topo */
+static void pyswe_settings_topo(const double* geopos)
+{
+    swe_set_topo(geopos[0], geopos[1], geopos[2]);
+    memcpy(pyswe_settings.topo, geopos, sizeof(pyswe_settings.topo));
+    pyswe_settings_touch();
+}
 
-static PyObject * pyswe_difrad2n FUNCARGS_KEYWDS
+/* Apply settings in a worker, from the settings it had */
+static void pyswe_settings_apply(const pyswe_Settings* s, pyswe_Settings* old)
 {
-    double p1, p2;
-    static char *kwlist[] = {"p1", "p2", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &p1, &p2))
-        return NULL;
-    return Py_BuildValue("d", swe_difrad2n(p1, p2));
+    if (s->gen == old->gen)
+        return;
+    /* setting the path closes the files, only if it changed */
+    if (old->gen == 0 || s->ephe_path_set != old->ephe_path_set
+        || strcmp(s->ephe_path, old->ephe_path))
+        swe_set_ephe_path(s->ephe_path_set ? s->ephe_path : NULL);
+    if (old->gen == 0 || strcmp(s->jpl_file, old->jpl_file))
+        swe_set_jpl_file(s->jpl_file);
+    swe_set_sid_mode(s->sid_mode, s->sid_t0, s->sid_ayan_t0);
+    swe_set_topo(s->topo[0], s->topo[1], s->topo[2]);
+    swe_set_tid_acc(s->tid_acc);
+    swe_set_delta_t_userdef(s->delta_t);
+    swe_set_lapse_rate(s->lapse_rate);
+    *old = *s;
 }
 
-/* swisseph.fixstar */
-PyDoc_STRVAR(pyswe_fixstar__doc__,
-"Calculate fixed star positions (ET).\n\n"
-":Args: str star, float tjdet, int flags=FLG_SWIEPH\n\n"
-" - star: name of fixed star to search for\n"
-" - tjdet: input time, Julian day number,  Ephemeris Time\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), str stnam, int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - stnam: returned star name\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Thread pool of the batch functions
+ *
+ * The batch functions (calc_ut_array...) split their items in chunks, and
+ * the chunks of a job are taken by the workers and by the calling thread,
+ * which computes with the GIL released and waits for the last chunk. Results
+ * are written at the index of their item, so the output does not depend on
+ * the number of threads. The pool is process wide, its threads do not run
+ * Python code. Without libswe thread local storage, or with one thread,
+ * jobs run in the calling thread only.
+ */
+typedef struct pyswe_Job pyswe_Job;
 
-static PyObject * pyswe_fixstar FUNCARGS_KEYWDS
-{
-    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
-    double jd, xx[6];
-    int ret, flag = SEFLG_SWIEPH;
-    static char *kwlist[] = {"star", "tjdet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
-                                     &star, &jd, &flag))
-        return NULL;
-    memset(st, 0, (SE_MAX_STNAME*2)+1);
-    strncpy(st, star, SE_MAX_STNAME*2);
-    ret = swe_fixstar(st, jd, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.fixstar: %s", err);
-    return Py_BuildValue("(dddddd)si",
-                         xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],st,ret);
-}
+/* Policies of the batch functions for the items in error (errors=...) */
+enum { PYSWE_ERRORS_RAISE, PYSWE_ERRORS_MASK, PYSWE_ERRORS_NAN };
 
-/* swisseph.fixstar2 */
-PyDoc_STRVAR(pyswe_fixstar2__doc__,
-"Calculate fixed star positions (faster version) (ET).\n\n"
-":Args: str star, float tjdet, int flags=FLG_SWIEPH\n\n"
-" - star: name of fixed star to search for\n"
-" - tjdet: input time, Julian day number, Ephemeris Time\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), str stnam, int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - stnam: returned star name\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+static const char* pyswe_errors_names[] = {"raise", "mask", "nan", NULL};
 
-static PyObject * pyswe_fixstar2 FUNCARGS_KEYWDS
-{
-    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
-    double jd, xx[6];
-    int ret, flag = SEFLG_SWIEPH;
-    static char *kwlist[] = {"star", "tjdet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
-                                     &star, &jd, &flag))
-        return NULL;
-    memset(st, 0, (SE_MAX_STNAME*2)+1);
-    strncpy(st, star, SE_MAX_STNAME*2);
-    ret = swe_fixstar2(st, jd, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.fixstar2: %s", err);
-    return Py_BuildValue("(dddddd)si",
-                         xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],st,ret);
-}
+typedef struct {
+    Py_ssize_t index;
+    char* err;
+} pyswe_ItemError;
+
+/* Compute items [start, end) of a job, report errors with pyswe_job_error */
+typedef void (*pyswe_job_func)(pyswe_Job* job, Py_ssize_t start,
+                               Py_ssize_t end);
+
+struct pyswe_Job {
+    pyswe_job_func func;
+    void (*complete)(pyswe_Job* job); /* for jobs not waited for */
+    void* data; /* arguments and results of func */
+    Py_ssize_t n; /* number of items */
+    Py_ssize_t chunk; /* minimum items per chunk, then chunk size */
+    Py_ssize_t next; /* first item not taken */
+    Py_ssize_t done; /* items computed (or cancelled) */
+    Py_ssize_t err_index; /* first item in error, -1 if none */
+    char err[256];
+    int errors; /* policy for the items in error, PYSWE_ERRORS_* */
+    int errlist; /* keep the errors of all items, -1 if out of memory */
+    pyswe_ItemError* errs; /* errors of all items, not sorted */
+    Py_ssize_t nerrs;
+    Py_ssize_t errs_size;
+    pyswe_Settings settings; /* of the calling thread */
+    pyswe_Job* queue_next;
+};
 
-/* swisseph.fixstar2_mag */
-PyDoc_STRVAR(pyswe_fixstar2_mag__doc__,
-"Get fixed star magnitude (faster version).\n\n"
-":Args: str star\n\n"
-" - star: name of fixed star\n\n"
-":Return: float mag, str stnam\n\n"
-" - mag: returned magnitude\n"
-" - stnam: returned star name\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+static struct {
+    pyswe_lock_t lock;
+    pyswe_cond_t work; /* signaled when a job is queued */
+    pyswe_cond_t done; /* signaled when a job is done */
+    pyswe_Job* queue; /* jobs having chunks not taken */
+    int size; /* threads computing a job, including the caller */
+    int nworkers; /* threads started */
+    int pending; /* submitted jobs not completed */
+} pyswe_pool = {PYSWE_LOCK_INIT, PYSWE_COND_INIT, PYSWE_COND_INIT, NULL, 0,
+                0, 0};
 
-static PyObject * pyswe_fixstar2_mag FUNCARGS_KEYWDS
+/* Workers wanted, at least one for submitted jobs */
+#define pyswe_pool_max_workers() \
+        (pyswe_pool.size > 1 ? pyswe_pool.size - 1 : 1)
+
+/* Interval of the interrupt checks of the calling thread */
+#define PYSWE_POOL_CHECK_MS     50
+
+static void pyswe_settings_touch(void)
 {
-    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
-    int ret;
-    double mag;
-    static char *kwlist[] = {"star", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &star))
-        return NULL;
-    memset(st, 0, (SE_MAX_STNAME*2)+1);
-    strncpy(st, star, SE_MAX_STNAME*2);
-    ret = swe_fixstar2_mag(st, &mag, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.fixstar2_mag: %s", err);
-    return Py_BuildValue("ds", mag, st);
+    pyswe_lock(&pyswe_pool.lock);
+    pyswe_settings.gen = ++pyswe_settings_gen;
+    if (PyThread_get_thread_ident() == pyswe_settings_main_thread)
+        pyswe_settings_main = pyswe_settings;
+    pyswe_unlock(&pyswe_pool.lock);
 }
 
-/* swisseph.fixstar2_ut */
-PyDoc_STRVAR(pyswe_fixstar2_ut__doc__,
-"Calculate fixed star positions (faster version) (UT).\n\n"
-":Args: str star, float tjdut, int flags=FLG_SWIEPH\n\n"
-" - star: name of fixed star to search for\n"
-" - tjdut: inputtime, Julian day nnumber, Universal Time\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), str stnam, int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - stnam: returned star name\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_fixstar2_ut FUNCARGS_KEYWDS
+/* Number of processors, at least 1 */
+static int pyswe_cpu_count(void)
 {
-    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
-    double jd, xx[6];
-    int ret, flag = SEFLG_SWIEPH;
-    static char *kwlist[] = {"star", "tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
-                                     &star, &jd, &flag))
-        return NULL;
-    memset(st, 0, (SE_MAX_STNAME*2)+1);
-    strncpy(st, star, SE_MAX_STNAME*2);
-    ret = swe_fixstar2_ut(st, jd, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.fixstar2_ut: %s", err);
-    return Py_BuildValue("(dddddd)si",
-                         xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],st,ret);
+#ifdef WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int) si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int) n : 1;
+#endif
 }
 
-/* swisseph.fixstar_mag */
-PyDoc_STRVAR(pyswe_fixstar_mag__doc__,
-"Get fixed star magnitude.\n\n"
-":Args: str star\n\n"
-" - star: name of fixed star\n\n"
-":Return: float mag, str stnam\n\n"
-" - mag: returned magnitude\n"
-" - stnam: returned star name\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Record the error of an item, keeping the first one
+ * With job->errlist, the errors of all items are kept.
+ */
+static void pyswe_job_error(pyswe_Job* job, Py_ssize_t i, const char* err)
+{
+    pyswe_ItemError* p;
+    Py_ssize_t n;
+    char* s;
+    pyswe_lock(&pyswe_pool.lock);
+    if (job->err_index < 0 || i < job->err_index) {
+        job->err_index = i;
+        job->err[0] = '\0';
+        strncat(job->err, err, sizeof(job->err) - 1);
+    }
+    if (job->errlist > 0) {
+        if (job->nerrs == job->errs_size) {
+            n = job->errs_size ? job->errs_size * 2 : 16;
+            if ((p = PyMem_RawRealloc(job->errs,
+                                      sizeof(pyswe_ItemError) * n))) {
+                job->errs = p;
+                job->errs_size = n;
+            }
+        }
+        if (job->nerrs < job->errs_size
+            && (s = PyMem_RawMalloc(strlen(err) + 1))) {
+            strcpy(s, err);
+            job->errs[job->nerrs].index = i;
+            job->errs[job->nerrs++].err = s;
+        }
+        else
+            job->errlist = -1;
+    }
+    pyswe_unlock(&pyswe_pool.lock);
+}
 
-static PyObject * pyswe_fixstar_mag FUNCARGS_KEYWDS
-{
-    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
-    int ret;
-    double mag;
-    static char *kwlist[] = {"star", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &star))
-        return NULL;
-    memset(st, 0, (SE_MAX_STNAME*2)+1);
-    strncpy(st, star, SE_MAX_STNAME*2);
-    ret = swe_fixstar_mag(st, &mag, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.fixstar_mag: %s", err);
-    return Py_BuildValue("ds", mag, st);
+/* Take the next chunk of a job, with the pool locked
+ * Return the number of items, 0 if all are taken.
+ */
+static Py_ssize_t pyswe_job_take(pyswe_Job* job, Py_ssize_t* start)
+{
+    pyswe_Job** p;
+    Py_ssize_t k = job->n - job->next;
+    if (k > job->chunk)
+        k = job->chunk;
+    *start = job->next;
+    job->next += k;
+    if (job->next == job->n) {
+        /* remove from the queue */
+        for (p = &pyswe_pool.queue; *p; p = &(*p)->queue_next) {
+            if (*p == job) {
+                *p = job->queue_next;
+                break;
+            }
+        }
+    }
+    return k;
 }
 
-/* swisseph.fixstar_ut */
-PyDoc_STRVAR(pyswe_fixstar_ut__doc__,
-"Calculate fixed star positions (UT).\n\n"
-":Args: str star, float tjdut, int flags=FLG_SWIEPH\n\n"
-" - star: name of fixed star to search for\n"
-" - tjdut: input time, Julian day number,  Universal Time\n"
-" - flags: bit flags indicating what kind of computation is wanted\n\n"
-":Return: (xx), str stnam, int retflags\n\n"
-" - xx: tuple of 6 float for results\n"
-" - stnam: returned star name\n"
-" - retflags: bit flags indicating what kind of computation was done\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Queue a job after the others, with the pool locked */
+static void pyswe_job_queue(pyswe_Job* job)
+{
+    pyswe_Job** p = &pyswe_pool.queue;
+    while (*p)
+        p = &(*p)->queue_next;
+    job->queue_next = NULL;
+    *p = job;
+    pyswe_cond_broadcast(&pyswe_pool.work);
+}
 
-static PyObject * pyswe_fixstar_ut FUNCARGS_KEYWDS
+/* Count items done, with the pool locked */
+static void pyswe_job_done(pyswe_Job* job, Py_ssize_t k)
 {
-    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
-    double jd, xx[6];
-    int ret, flag = SEFLG_SWIEPH;
-    static char *kwlist[] = {"star", "tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
-                                     &star, &jd, &flag))
-        return NULL;
-    memset(st, 0, (SE_MAX_STNAME*2)+1);
-    strncpy(st, star, SE_MAX_STNAME*2);
-    ret = swe_fixstar_ut(st, jd, flag, xx, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.fixstar_ut: %s", err);
-    return Py_BuildValue("(dddddd)si",
-                         xx[0],xx[1],xx[2],xx[3],xx[4],xx[5],st,ret);
+    job->done += k;
+    if (job->done == job->n)
+        pyswe_cond_broadcast(&pyswe_pool.done);
 }
 
-/* swisseph.gauquelin_sector */
-PyDoc_STRVAR(pyswe_gauquelin_sector__doc__,
-"Calculate Gauquelin sector position of a body (UT).\n\n"
-":Args: float tjdut, int or str body, int method, seq geopos,"
-" float atpress=0, float attemp=0, int flags=FLG_SWIEPH|FLG_TOPOCTR\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - body: planet number (int) or fixed star name (str)\n"
-" - method: number indicating which computation method is wanted:\n"
-"    - 0 with latitude\n"
-"    - 1 without latitude\n"
-"    - 2 from rising and setting times of the disc center of planet\n"
-"    - 3 from rising and setting times of disc center, incl. refraction\n"
-"    - 4 from rising and setting times of the disk edge of planet\n"
-"    - 5 from rising and setting times of disk edge, incl. refraction\n"
-" - geopos: a sequence containing:\n"
-"    - 0: geographic longitude, in degrees (eastern positive)\n"
-"    - 1: geographic latitude, in degrees (northern positive)\n"
-"    - 2: geographic altitude, in meters above sea level\n"
-" - atpress: atmospheric pressure (if 0, the default 1013.25 mbar is used)\n"
-" - attemp: atmospheric temperature in degrees Celsius\n"
-" - flags: bit flags for ephemeris and FLG_TOPOCTR, etc\n\n"
-":Return: float sector\n\n"
-" - sector: [1;37[. Gauquelin sectors are numbered in clockwise direction.\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+#ifdef WIN32
+static unsigned __stdcall pyswe_worker(void* arg)
+#else
+static void * pyswe_worker(void* arg)
+#endif
+{
+    pyswe_Job* job;
+    pyswe_Settings applied;
+    Py_ssize_t start, k;
+    memset(&applied, 0, sizeof(applied));
+    pyswe_lock(&pyswe_pool.lock);
+    for (;;) {
+        while (!pyswe_pool.queue
+               && pyswe_pool.nworkers <= pyswe_pool_max_workers())
+            pyswe_cond_wait(&pyswe_pool.work, &pyswe_pool.lock);
+        if (pyswe_pool.nworkers > pyswe_pool_max_workers()) {
+            /* pool was shrunk */
+            --pyswe_pool.nworkers;
+            break;
+        }
+        job = pyswe_pool.queue;
+        k = pyswe_job_take(job, &start);
+        pyswe_unlock(&pyswe_pool.lock);
+        pyswe_settings_apply(&job->settings, &applied);
+        job->func(job, start, start + k);
+        pyswe_lock(&pyswe_pool.lock);
+        pyswe_job_done(job, k);
+        if (job->complete && job->done == job->n) {
+            pyswe_unlock(&pyswe_pool.lock);
+            job->complete(job);
+            pyswe_lock(&pyswe_pool.lock);
+        }
+    }
+    pyswe_unlock(&pyswe_pool.lock);
+    return 0;
+}
 
-static PyObject * pyswe_gauquelin_sector FUNCARGS_KEYWDS
+/* Start workers up to the size of the pool, with the pool locked
+ * The caller of a job is a thread of the pool, so there are size - 1
+ * workers. Failing to start a thread is not an error, jobs just use less.
+ * Return the number of workers.
+ */
+static int pyswe_pool_start(void)
 {
-    double jd, geopos[3], ret, press = 0.0, temp = 0.0;
-    int i, pl, flag = SEFLG_SWIEPH|SEFLG_TOPOCTR, method;
-    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
-    PyObject *body, *seq;
-    static char *kwlist[] = {"tjdut", "body", "method", "geopos", "atpress",
-                             "attemp", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOiO|ddi", kwlist, &jd,
-                                   &body, &method, &seq, &press, &temp, &flag))
-        return NULL;
-    /* extract pl/star */
-    i = py_obj2plstar(body, &pl, &star);
-    if (i > 0) {
-        PyErr_SetString(PyExc_TypeError,
-                        "swisseph.gauquelin_sector: invalid body type");
-        return NULL;
+#ifdef WIN32
+    HANDLE h;
+    while (pyswe_pool.nworkers < pyswe_pool_max_workers()) {
+        h = (HANDLE) _beginthreadex(NULL, 4 << 20, pyswe_worker, NULL, 0,
+                                    NULL);
+        if (!h)
+            break;
+        CloseHandle(h);
+        ++pyswe_pool.nworkers;
     }
-    if (star) {
-        memset(st, 0, (SE_MAX_STNAME*2)+1);
-        strncpy(st, star, SE_MAX_STNAME*2);
+#else
+    pthread_t t;
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr))
+        return pyswe_pool.nworkers;
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&attr, 4 << 20);
+    while (pyswe_pool.nworkers < pyswe_pool_max_workers()) {
+        if (pthread_create(&t, &attr, pyswe_worker, NULL))
+            break;
+        ++pyswe_pool.nworkers;
     }
-    /* extract geopos */
-    i = py_seq2d(seq, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                "swisseph.gauquelin_sector: geopos: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_gauquelin_sector(jd, pl, st, flag, method,
-                             geopos, press, temp, &ret, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.gauquelin_sector: %s", err);
-    return Py_BuildValue("d", ret);
+    pthread_attr_destroy(&attr);
+#endif
+    return pyswe_pool.nworkers;
 }
 
-/* swisseph.get_ayanamsa */
-PyDoc_STRVAR(pyswe_get_ayanamsa__doc__,
-"Calculate ayanamsa (ET).\n\n"
-":Args: float tjdet\n\n"
-" - tjdet: input time, Julian day number, Ephemeris Time\n\n"
-":Return: float aya\n\n"
-" - aya: ayanamsa value, without nutation");
+/* Set the number of threads of the pool */
+static void pyswe_pool_resize(int n)
+{
+    pyswe_lock(&pyswe_pool.lock);
+    pyswe_pool.size = n;
+    /* workers are started with the next job, surplus ones exit */
+    pyswe_cond_broadcast(&pyswe_pool.work);
+    pyswe_unlock(&pyswe_pool.lock);
+}
 
-static PyObject * pyswe_get_ayanamsa FUNCARGS_KEYWDS
+static int pyswe_pool_size(void)
 {
-    double jd;
-    static char *kwlist[] = {"tjdet", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
-        return NULL;
-    return Py_BuildValue("d", swe_get_ayanamsa(jd));
+    int n;
+    pyswe_lock(&pyswe_pool.lock);
+    if (!pyswe_pool.size)
+        pyswe_pool.size = pyswe_cpu_count();
+    n = pyswe_pool.size;
+    pyswe_unlock(&pyswe_pool.lock);
+    return n;
 }
 
-/* swisseph.get_ayanamsa_ex */
-PyDoc_STRVAR(pyswe_get_ayanamsa_ex__doc__,
-"Calculate ayanamsa, extended version (ET).\n\n"
-":Args: float tjdet, int flags\n\n"
-" - tjdet: input time, Julian day number, Ephemeris Time\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: int retflags, float aya\n\n"
-" - retflags: returned bit flags\n"
-" - aya: ayanamsa value\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_get_ayanamsa_ex FUNCARGS_KEYWDS
+/* Run a job, with the GIL held
+ * Return -1 if interrupted (KeyboardInterrupt...), with an exception set.
+ * Errors of the items are in job->err_index and job->err, and job->errs
+ * with job->errlist (see pyswe_job_errors). job->errors and job->errlist
+ * are set by the caller.
+ */
+static int pyswe_pool_run(pyswe_Job* job)
 {
-    int i, flags;
-    double jd, daya;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &flags))
-        return NULL;
-    i = swe_get_ayanamsa_ex(jd, flags, &daya, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.get_ayanamsa_ex: %s", err);
-    return Py_BuildValue("id", i, daya);
+    int size = pyswe_pool_size(), ret = 0;
+    Py_ssize_t start, k;
+#if PYSWE_SWE_TLS
+    unsigned long long t = pyswe_clock_ns();
+#endif
+    job->complete = NULL;
+    job->next = job->done = 0;
+    job->err_index = -1;
+    job->err[0] = '\0';
+    job->errs = NULL;
+    job->nerrs = job->errs_size = 0;
+    job->queue_next = NULL;
+    /* about 4 chunks per thread, for threads taking more time than others */
+    if (job->chunk < 1)
+        job->chunk = 1;
+    if (job->n / (size * 4) > job->chunk)
+        job->chunk = job->n / (size * 4);
+#if !PYSWE_SWE_TLS
+    /* libswe is not thread safe, keep the GIL */
+    while (!ret && job->next < job->n) {
+        k = pyswe_job_take(job, &start);
+        job->func(job, start, start + k);
+        ret = PyErr_CheckSignals();
+    }
+#else
+    job->settings = pyswe_settings;
+    Py_BEGIN_ALLOW_THREADS
+    pyswe_lock(&pyswe_pool.lock);
+    if (size > 1 && job->n > job->chunk) {
+        pyswe_job_queue(job);
+        pyswe_pool_start();
+    }
+    while (job->done < job->n) {
+        if (job->next < job->n) {
+            k = pyswe_job_take(job, &start);
+            pyswe_unlock(&pyswe_pool.lock);
+            job->func(job, start, start + k);
+            pyswe_lock(&pyswe_pool.lock);
+            pyswe_job_done(job, k);
+        }
+        else
+            pyswe_cond_timedwait(&pyswe_pool.done, &pyswe_pool.lock,
+                                 PYSWE_POOL_CHECK_MS);
+        if (ret || pyswe_clock_ns() - t < PYSWE_POOL_CHECK_MS * 1000000ULL)
+            continue;
+        /* check for interrupts */
+        pyswe_unlock(&pyswe_pool.lock);
+        Py_BLOCK_THREADS
+        ret = PyErr_CheckSignals();
+        Py_UNBLOCK_THREADS
+        pyswe_lock(&pyswe_pool.lock);
+        t = pyswe_clock_ns();
+        if (ret && job->next < job->n) {
+            /* cancel the chunks not taken, wait for the others */
+            job->chunk = job->n;
+            pyswe_job_done(job, pyswe_job_take(job, &start));
+        }
+    }
+    pyswe_unlock(&pyswe_pool.lock);
+    Py_END_ALLOW_THREADS
+#endif
+    return ret;
 }
 
-/* swisseph.get_ayanamsa_ex_ut */
-PyDoc_STRVAR(pyswe_get_ayanamsa_ex_ut__doc__,
-"Calculate ayanamsa, extended version (UT).\n\n"
-":Args: float tjdut, int flags\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: int retflags, float aya\n\n"
-" - retflags: returned bit flags\n"
-" - aya: ayanamsa value\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_get_ayanamsa_ex_ut FUNCARGS_KEYWDS
+/* Submit a job to the workers, without waiting for it
+ * job->complete is called by the worker finishing the job, without the GIL.
+ * Return -1 if the job cannot be run by a worker (no thread local storage
+ * in libswe, or no thread could be started), it is then not submitted.
+ */
+static int pyswe_pool_submit(pyswe_Job* job)
 {
-    int i, flags;
-    double jd, daya;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &flags))
-        return NULL;
-    i = swe_get_ayanamsa_ex_ut(jd, flags, &daya, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.get_ayanamsa_ex_ut: %s", err);
-    return Py_BuildValue("id", i, daya);
+    int ret = -1;
+    if (!PYSWE_SWE_TLS)
+        return -1;
+    pyswe_pool_size();
+    job->next = job->done = 0;
+    job->err_index = -1;
+    job->err[0] = '\0';
+    job->errors = PYSWE_ERRORS_RAISE;
+    job->errlist = 0;
+    job->errs = NULL;
+    job->nerrs = job->errs_size = 0;
+    job->chunk = job->n;
+    job->settings = pyswe_settings;
+    pyswe_lock(&pyswe_pool.lock);
+    if (pyswe_pool_start() > 0) {
+        ++pyswe_pool.pending;
+        pyswe_job_queue(job);
+        ret = 0;
+    }
+    pyswe_unlock(&pyswe_pool.lock);
+    return ret;
 }
 
-/* swisseph.get_ayanamsa_name */
-PyDoc_STRVAR(pyswe_get_ayanamsa_name__doc__,
-"Get ayanamsa name from sidereal mode constant.\n\n"
-":Args: int sidmode\n"
-":Return: str name\n\n"
-"If sidmode is not found (incorrect), returned string is empty.");
-
-static PyObject * pyswe_get_ayanamsa_name FUNCARGS_KEYWDS
+/* Count the completion of a submitted job */
+static void pyswe_pool_completed(void)
 {
-    int mode;
-    char *name = NULL;
-    static char *kwlist[] = {"sidmode", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &mode))
-        return NULL;
-    name = (char*) swe_get_ayanamsa_name(mode);
-    return Py_BuildValue("s", name ? name : "");
+    pyswe_lock(&pyswe_pool.lock);
+    --pyswe_pool.pending;
+    pyswe_cond_broadcast(&pyswe_pool.done);
+    pyswe_unlock(&pyswe_pool.lock);
 }
 
-/* swisseph.get_ayanamsa_ut */
-PyDoc_STRVAR(pyswe_get_ayanamsa_ut__doc__,
-"Calculate ayanamsa (UT).\n\n"
-":Args: float tjdut\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n\n"
-":Return: float aya\n\n"
-" - aya: ayanamsa value, without nutation");
-
-static PyObject * pyswe_get_ayanamsa_ut FUNCARGS_KEYWDS
+/* Raise the error of the first item in error of a job */
+static PyObject * pyswe_job_raise(PyObject* exc, pyswe_Job* job,
+                                  const char* fn)
 {
-    double jd;
-    static char *kwlist[] = {"tjdut", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
-        return NULL;
-    return Py_BuildValue("d", swe_get_ayanamsa_ut(jd));
+    return PyErr_Format(exc, "swisseph.%s: %s (item %zd)", fn,
+                        job->err[0] ? job->err : "error", job->err_index);
 }
 
-/* swisseph.get_current_file_data */
-PyDoc_STRVAR(pyswe_get_current_file_data__doc__,
-"Find start and end date of an se1 ephemeris file after a function call.\n\n"
-":Args: int fno\n\n"
-" - fno: an integer indicating what type of file is searched:\n"
-"    - 0: planet file sepl_xxx, used for Sun etc, or jpl file\n"
-"    - 1: moon file semo_xxx\n"
-"    - 2: main asteroid file seas_xxx, if such an object was computed\n"
-"    - 3: other asteroid or planetary moon file, if such object was computed\n"
-"    - 4: star file\n\n"
-":Return: str path, float start, float end, int denum\n\n"
-" - path: full file path, or empty string if no data\n"
-" - start: start date of file\n"
-" - end: end date of file\n"
-" - denum: jpl ephemeris number 406 or 431 from which file was derived\n\n"
-"This can be used to find out the start and end date of an ``se1`` ephemeris"
-" file after a call of ``calc()``.\n\n"
-"The function returns data from internal file structures ``sweph.fidat`` used"
-" in the last call to ``calc()`` or ``fixstar()``. Data returned are"
-" (currently) 0 with JPL files and fixed star files. Thus, the function is"
-" only useful for ephemerides of planets or asteroids that are based on"
-" ``se1`` files.");
+/* Set the policy for the items in error of a job, from the errors and
+ * errlist arguments of a batch function
+ * Return -1 on error, with an exception set.
+ */
+static int pyswe_job_policy(pyswe_Job* job, const char* errors,
+                            PyObject* errlist, const char* fn)
+{
+    for (job->errors = 0; pyswe_errors_names[job->errors]; ++job->errors) {
+        if (!strcmp(errors, pyswe_errors_names[job->errors]))
+            break;
+    }
+    if (!pyswe_errors_names[job->errors]) {
+        PyErr_Format(PyExc_ValueError, "swisseph.%s: errors: must be 'raise',"
+                     " 'mask' or 'nan', not '%s'", fn, errors);
+        return -1;
+    }
+    if (errlist && errlist != Py_None && !PyList_Check(errlist)) {
+        PyErr_Format(PyExc_TypeError, "swisseph.%s: errlist: must be a list",
+                     fn);
+        return -1;
+    }
+    job->errlist = errlist && errlist != Py_None
+        && job->errors != PYSWE_ERRORS_RAISE;
+    return 0;
+}
 
-static PyObject * pyswe_get_current_file_data FUNCARGS_KEYWDS
+static int pyswe_item_error_cmp(const void* a, const void* b)
 {
-    int fno, denum = 0;
-    char* path = NULL;
-    double start = 0, end = 0;
-    static char* kwlist[] = {"fno", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &fno))
-        return NULL;
-    path = (char*) swe_get_current_file_data(fno, &start, &end, &denum);
-    return Py_BuildValue("sddi", path ? path : "", start, end, denum);
+    Py_ssize_t i = ((const pyswe_ItemError*) a)->index;
+    Py_ssize_t j = ((const pyswe_ItemError*) b)->index;
+    return i < j ? -1 : (i > j);
 }
 
-/* swisseph.get_library_path */
-PyDoc_STRVAR(pyswe_get_library_path__doc__,
-"Find the path of the executable or swisseph library (dll) actually in use.\n\n"
-":Args: --\n"
-":Return: str path\n\n"
-".. note::\n\n"
-"    This function may fail on Windows, and only find the executable path, not"
-" the dll.");
+/* Sort the errors of the items of a job, by index */
+static void pyswe_job_errors_sort(pyswe_Job* job)
+{
+    if (job->nerrs > 1)
+        qsort(job->errs, job->nerrs, sizeof(pyswe_ItemError),
+              pyswe_item_error_cmp);
+}
 
-static PyObject * pyswe_get_library_path FUNCARGS_SELF
+/* End a job run by a batch function: raise the first error, or append the
+ * (index, message) of the items in error to errlist, in the order of the
+ * items, according to the policy of the job. The errors are freed.
+ * Return -1 on error, or if the job was interrupted, with an exception set.
+ */
+static int pyswe_job_errors(pyswe_Job* job, PyObject* exc, const char* fn,
+                            PyObject* errlist)
 {
-    char buf[256];
-    memset(buf, 0, sizeof(char) * 256);
-    return Py_BuildValue("s", swe_get_library_path(buf));
+    Py_ssize_t i;
+    PyObject* t;
+    int ret = 0;
+    if (PyErr_Occurred())
+        ret = -1;
+    else if (job->errors == PYSWE_ERRORS_RAISE && job->err_index >= 0) {
+        pyswe_job_raise(exc, job, fn);
+        ret = -1;
+    }
+    else if (job->errlist < 0) {
+        PyErr_NoMemory();
+        ret = -1;
+    }
+    else if (job->errlist) {
+        pyswe_job_errors_sort(job);
+        for (i = 0; !ret && i < job->nerrs; ++i) {
+            t = Py_BuildValue("(ns)", job->errs[i].index,
+                              job->errs[i].err[0] ? job->errs[i].err
+                              : "error");
+            if (!t || PyList_Append(errlist, t))
+                ret = -1;
+            Py_XDECREF(t);
+        }
+    }
+    for (i = 0; i < job->nerrs; ++i)
+        PyMem_RawFree(job->errs[i].err);
+    PyMem_RawFree(job->errs);
+    job->errs = NULL;
+    job->nerrs = job->errs_size = 0;
+    return ret;
+}
+
+/* Set rows of results to NaN, where status is -1 (ERR) */
+static void pyswe_results_nan(double* d, int ncols, const int* status,
+                              Py_ssize_t n)
+{
+    Py_ssize_t i;
+    int j;
+    for (i = 0; i < n; ++i) {
+        if (status[i] == -1) {
+            for (j = 0; j < ncols; ++j)
+                d[i * ncols + j] = Py_NAN;
+        }
+    }
 }
 
-/* swisseph.get_planet_name */
-PyDoc_STRVAR(pyswe_get_planet_name__doc__,
-"Get a planet or asteroid name.\n\n"
-":Args: int planet\n\n"
-" - planet: identifier of planet or object\n\n"
-":Return: str name\n\n"
-" - name: name found or empty string\n\n"
-"If an asteroid name is wanted, the function does the following:\n\n"
-"The name is first looked for in the asteroid ephemeris file.\n\n"
-"Because many asteroids, especially the ones with high catalogue numbers, have"
-" no names yet (or have only a preliminary designation like 1968 HB), and"
-" because the Minor Planet Center of the IAU add new names quite often, it"
-" happens that there is no name in the asteroid file although the asteroid"
-" has already been given a name.\n\n"
-"For this, we have the file ``seasnam.txt``, a file that contains a list of"
-" all named asteroid and is usually more up to date. If ``calc()`` finds a"
-" preliminary designation, it looks for a name in this file.\n\n"
-"The file ``seasnam.txt`` can be updated by the user. To do this, download the"
-" names list from the Minor Planet Center"
-" https://www.minorplanetcenter.net/iau/lists/MPNames.html,"
-" rename it as ``seasnam.txt`` and move it into your ephemeris directory.\n\n"
-"The file ``seasnam.txt`` need not be ordered in any way. There must be one"
-" asteroid per line, first its catalogue number, then its name. The asteroid"
-" number may or may not be in brackets.");
+/* Arrays of double given to the batch functions
+ * Contiguous buffers of float64 are used in place, other sequences are
+ * copied.
+ */
+typedef struct {
+    double* d;
+    Py_ssize_t n;
+    Py_buffer view; /* view.obj is NULL for a copy */
+} pyswe_DArray;
 
-static PyObject * pyswe_get_planet_name FUNCARGS_KEYWDS
+/* Get the doubles of a buffer or sequence
+ * Return > 0 on error, with an exception set
+ */
+static int pyswe_darray_get(PyObject* o, pyswe_DArray* a, const char* fn,
+                            const char* name)
+{
+    Py_ssize_t i;
+    PyObject* seq;
+    a->view.obj = NULL;
+    a->d = NULL;
+    if (PyObject_CheckBuffer(o)
+        && !PyObject_GetBuffer(o, &a->view, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT)) {
+        if (a->view.ndim == 1 && a->view.itemsize == sizeof(double)
+            && pyswe_fmt_is_d(a->view.format)) {
+            a->d = (double*) a->view.buf;
+            a->n = a->view.shape[0];
+            return 0;
+        }
+        PyBuffer_Release(&a->view);
+        a->view.obj = NULL;
+    }
+    PyErr_Clear();
+    if (!(seq = PySequence_Fast(o, ""))) {
+        PyErr_Format(PyExc_TypeError, "swisseph.%s: %s: must be a sequence"
+                     " of float", fn, name);
+        return 1;
+    }
+    a->n = PySequence_Fast_GET_SIZE(seq);
+    if (!(a->d = PyMem_Malloc(sizeof(double) * (a->n ? a->n : 1)))) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return 1;
+    }
+    for (i = 0; i < a->n; ++i) {
+        a->d[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, i));
+        if (a->d[i] == -1 && PyErr_Occurred()) {
+            if (PyErr_ExceptionMatches(PyExc_TypeError)) {
+                PyErr_Clear();
+                PyErr_Format(PyExc_TypeError, "swisseph.%s: %s: must be a"
+                             " sequence of float", fn, name);
+            }
+            Py_DECREF(seq);
+            PyMem_Free(a->d);
+            a->d = NULL;
+            return 1;
+        }
+    }
+    Py_DECREF(seq);
+    return 0;
+}
+
+static void pyswe_darray_release(pyswe_DArray* a)
 {
-    int pl;
-    char name[128], spl[128];
-    static char *kwlist[] = {"planet", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &pl))
-        return NULL;
-    snprintf(spl, 128, "%d", pl);
-    swe_get_planet_name(pl, name);
-    return Py_BuildValue("s",
-            !strcmp(name, spl) || strstr(name, "not found") ? "" : name);
+    if (a->view.obj)
+        PyBuffer_Release(&a->view);
+    else
+        PyMem_Free(a->d);
 }
 
-/* swisseph.get_orbital_elements */
-PyDoc_STRVAR(pyswe_get_orbital_elements__doc__,
-"Calculate osculating elements (Kepler elements) and orbital periods.\n\n"
-":Args: float tjdet, int planet, int flags\n\n"
-" - tjdet: input time, Julian day number, Ephemeris Time (TT)\n"
-" - planet: identifier of planet or object\n"
-" - flags: bit flags indicating what computation is wanted:\n"
-"    - ephemeris flag: FLG_JPLEPH, FLG_SWIEPH, FLG_MOSEPH, etc\n"
-"    - center:\n"
-"       - Sun: FLG_HELCTR (assumed as default) or\n"
-"       - SS Barycentre: FLG_BARYCTR (rel. to solar system barycentre)\n"
-"         Only possible for planets beyond Jupiter.\n"
-"         For elements of the Moon, the calculation is geocentric.\n"
-"    - sum all masses inside the orbit to be computed (method of\n"
-"      Astronomical Almanac): FLG_ORBEL_AA\n"
-"    - reference ecliptic: FLG_J2000\n\n"
-":Return: (elements)\n\n"
-" - elements: a tuple of 50 float, of which:\n"
-"    - 0: semimajor axis (a)\n"
-"    - 1: eccentricity (e)\n"
-"    - 2: inclination (in)\n"
-"    - 3: longitude of ascending node (upper-case omega OM)\n"
-"    - 4: argument of periapsis (lower-case omega om)\n"
-"    - 5: longitude of periapsis (peri)\n"
-"    - 6: mean anomaly at epoch (M0)\n"
-"    - 7: true anomaly at epoch (N0)\n"
-"    - 8: eccentric anomaly at epoch (E0)\n"
-"    - 9: mean longitude at epoch (LM)\n"
-"    - 10: sidereal orbital period in tropical years\n"
-"    - 11: mean daily motion\n"
-"    - 12: tropical period in years\n"
-"    - 13: synodic period in days, negative for inner planets or Moon\n"
-"    - 14: time of perihelion passage\n"
-"    - 15: perihelion distance\n"
-"    - 16: aphelion distance\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Make a bytearray for the results of a batch function
+ * Return NULL on error. *buf is set to its data.
+ */
+static PyObject * pyswe_results_new(Py_ssize_t n, int ncols, int itemsize,
+                                    void** buf)
+{
+    PyObject* o = PyByteArray_FromStringAndSize(NULL, n * ncols * itemsize);
+    if (o) {
+        memset(PyByteArray_AS_STRING(o), 0, n * ncols * itemsize);
+        *buf = PyByteArray_AS_STRING(o);
+    }
+    return o;
+}
 
-static PyObject * pyswe_get_orbital_elements FUNCARGS_KEYWDS
+/* Return a memoryview of results, of shape (n, ncols) or (n,) if ncols is 0
+ * The reference to o is stolen.
+ */
+static PyObject * pyswe_results_view(PyObject* o, const char* fmt,
+                                     Py_ssize_t n, int ncols)
 {
-    int i, pl, flg;
-    double jd, dret[50];
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
-    if(!PyArg_ParseTupleAndKeywords(args, kwds, "dii", kwlist,
-                                    &jd, &pl, &flg))
+    PyObject* v, *res;
+    if (!o)
         return NULL;
-    memset(dret, 0, sizeof(double) * 50);
-    i = swe_get_orbital_elements(jd, pl, flg, dret, err);
-    if (i == 0)
-        return Py_BuildValue(
-            "dddddddddddddddddddddddddddddddddddddddddddddddddd",
-            dret[0],dret[1],dret[2],dret[3],dret[4],dret[5],dret[6],dret[7],
-            dret[8],dret[9],dret[10],dret[11],dret[12],dret[13],dret[14],
-            dret[15],dret[16],dret[17],dret[18],dret[19],dret[20],dret[21],
-            dret[22],dret[23],dret[24],dret[25],dret[26],dret[27],dret[28],
-            dret[29],dret[30],dret[31],dret[32],dret[33],dret[34],dret[35],
-            dret[36],dret[37],dret[38],dret[39],dret[40],dret[41],dret[42],
-            dret[43],dret[44],dret[45],dret[46],dret[47],dret[48],dret[49]);
-    return PyErr_Format(pyswe_Error, "swisseph.get_orbital_elements: %s", err);
+    v = PyMemoryView_FromObject(o);
+    Py_DECREF(o);
+    if (!v)
+        return NULL;
+    /* zeros in shape cannot be cast */
+    if (ncols && n)
+        res = PyObject_CallMethod(v, "cast", "s(ni)", fmt, n, ncols);
+    else
+        res = PyObject_CallMethod(v, "cast", "s", fmt);
+    Py_DECREF(v);
+    return res;
 }
 
-/* swisseph.get_tid_acc */
-PyDoc_STRVAR(pyswe_get_tid_acc__doc__,
-"Get current value of the tidal acceleration.\n\n"
-":Args: --\n"
-":Return: float tidacc");
+/* swisseph.Error (module exception type) */
+#define pyswe_error(m)      (pyswe_get_state(m)->error)
 
-static PyObject * pyswe_get_tid_acc FUNCARGS_SELF
-{
-    return Py_BuildValue("d", swe_get_tid_acc());
-}
-
-/* swisseph.heliacal_pheno_ut */
-PyDoc_STRVAR(pyswe_heliacal_pheno_ut__doc__,
-"Provides data that are relevant for the calculation of heliacal risings and"
-" settings.\n\n"
-":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
-" int eventtype, int flags\n\n"
+/* swisseph.azalt */
+PyDoc_STRVAR(pyswe_azalt__doc__,
+"Calculate horizontal coordinates (azimuth and altitude) of a planet or a star"
+" from either ecliptical or equatorial coordinates.\n\n"
+":Args: float tjdut, int flag, seq geopos, float atpress, float attemp,"
+" seq xin\n\n"
 " - tjdut: input time, Julian day number, Universal Time\n"
+" - flag: either ECL2HOR (from ecliptical coord) or EQU2HOR (equatorial)\n"
 " - geopos: a sequence with:\n"
-"    - 0: geographic longitude (eastern positive)\n"
-"    - 1: geographic latitude (northern positive)\n"
-"    - 2: altitude above sea level, in meters\n"
-" - atmo: a sequence with:\n"
-"    - 0: atmospheric pressure in mbar (hPa)\n"
-"    - 1: atmospheric temperature in degrees Celsius\n"
-"    - 2: relative humidity in %\n"
-"    - 3: if >= 1, Meteorological Range (km).\n"
-"      Between 1 and 0, total atmospheric coefficient (ktot).\n"
-"      If = 0, the other atmospheric parameters determine the total\n"
-"      atmospheric coefficient (ktot)\n"
-" - observer: a sequence with:\n"
-"    - 0: age of observer in years (default = 36)\n"
-"    - 1: snellen ratio of observers eyes (default = 1 = normal)\n"
-"    - The following parameters are only relevant if HELFLAG_OPTICAL_PARAMS\n"
-"      is set:\n"
-"    - 2: (0) = monocular, (1) = binocular (boolean)\n"
-"    - 3: telescope magnification, (0) = default to naked eye (binocular),\n"
-"      (1) = naked eye\n"
-"    - 4: optical aperture (telescope diameter) in mm\n"
-"    - 5: optical transmission\n"
-" - objname: name of planet or fixed star\n"
-" - eventtype: either:\n"
-"    - HELIACAL_RISING: morning first, for all visible planets and stars\n"
-"    - HELIACAL_SETTING: evening last, for all visible planets and stars\n"
-"    - EVENING_FIRST: evening first, for Mercury, Venus, Moon\n"
-"    - MORNING_LAST: morning last, for Mercury, Venus, Moon\n"
-" - flags: bit flags for ephemeris, and also:\n"
-"    - HELFLAG_OPTICAL_PARAMS: for optical instruments\n"
-"    - HELFLAG_NO_DETAILS: provide date, without details\n"
-"    - HELFLAG_VISLIM_DARK: behave as if Sun is at nadir\n"
-"    - HELFLAG_VISLIM_NOMOON: behave as if Moon is at nadir, i.e. the Moon as\n"
-"      a factor disturbing the observation is excluded, useful if one is not\n"
-"      interested in the heliacal date of that particular year, but in the\n"
-"      heliacal date of that epoch\n\n"
-":Return: (dret)\n\n"
-" - dret: tuple of 50 float, of which:\n"
-"    - 0: AltO [deg] topocentric altitude of object (unrefracted)\n"
-"    - 1: AppAltO [deg] apparent altitude of object (refracted)\n"
-"    - 2: GeoAltO [deg] geocentric altitude of object\n"
-"    - 3: AziO [deg] azimuth of object\n"
-"    - 4: AltS [deg] topocentric altitude of Sun\n"
-"    - 5: AziS [deg] azimuth of Sun\n"
-"    - 6: TAVact [deg] actual topocentric arcus visionis\n"
-"    - 7: ARCVact [deg] actual (geocentric) arcus visionis\n"
-"    - 8: DAZact [deg] actual difference between object's and sun's azimuth\n"
-"    - 9: ARCLact [deg] actual longitude difference between object and sun\n"
-"    - 10: kact [-] extinction coefficient\n"
-"    - 11: minTAV [deg] smallest topocentric arcus visionis\n"
-"    - 12: TfistVR [JDN] first time object is visible, according to VR\n"
-"    - 13: TbVR [JDN] optimum time the object is visible, according to VR\n"
-"    - 14: TlastVR [JDN] last time object is visible, according to VR\n"
-"    - 15: TbYallop [JDN] best time the object is visible, according to Yallop\n"
-"    - 16: WMoon [deg] crescent width of Moon\n"
-"    - 17: qYal [-] q-test value of Yallop\n"
-"    - 18: qCrit [-] q-test criterion of Yallop\n"
-"    - 19: ParO [deg] parallax of object\n"
-"    - 20: Magn [-] magnitude of object\n"
-"    - 21: RiseO [JDN] rise/set time of object\n"
-"    - 22: RiseS [JDN] rise/set time of Sun\n"
-"    - 23: Lag [JDN] rise/set time of object minus rise/set time of Sun\n"
-"    - 24: TvisVR [JDN] visibility duration\n"
-"    - 25: LMoon [deg] crescent length of Moon\n"
-"    - 26: CVAact [deg]\n"
-"    - 27: Illum [%] new\n"
-"    - 28: CVAact [deg] new\n"
-"    - 29: MSk [-]\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+"    - 0: geographic longitude, in degrees (eastern positive)\n"
+"    - 1: geographic latitude, in degrees (northern positive)\n"
+"    - 2: geographic altitude, in meters above sea level\n"
+" - atpress: atmospheric pressure in mbar (hPa)\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - xin: a sequence with:\n"
+"    - ECL2HOR: ecl. longitude, ecl. latitude, distance\n"
+"    - EQU2HOR: right ascension, declination, distance\n\n"
+":Return: float azimuth, true_altitude, apparent_altitude\n\n"
+" - azimuth: position degree, measured from south point to west\n"
+" - true_altitude: true altitude above horizon in degrees\n"
+" - apparent_altitude: apparent (refracted) altitude above horizon in"
+"   degrees\n\n"
+"The apparent altitude of a body depends on the atmospheric pressure and"
+" temperature. If only the true altitude is required, these parameters can be"
+" neglected.\n\n"
+"If ``atpress`` is given the value 0, the function estimates the pressure from"
+" the geographical altitude given in ``xin[3]`` and ``attemp``. If ``xin[3]``"
+" is 0, ``atpress`` will be estimated for sea level.");
 
-static PyObject * pyswe_heliacal_pheno_ut FUNCARGS_KEYWDS
+static PyObject * pyswe_azalt FUNCARGS_KEYWDS
 {
-    double jd, geopos[3], atmo[4], observ[6], dret[50];
-    char err[256] = {0}, *obj;
-    int i, evnt, flg;
-    PyObject *o1, *o2, *o3;
-    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
-                             "eventtype", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsii", kwlist, &jd,
-                                     &o1, &o2, &o3, &obj, &evnt, &flg))
+    double jd, geo[3], xin[3], press, temp, xaz[3];
+    int i, flag;
+    PyObject *pygeo, *pyxin;
+    char err[128] = {0};
+    static char *kwlist[] = {"tjdut", "flag", "geopos", "atpress", "attemp",
+                             "xin", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "diOddO", kwlist, &jd,
+                                     &flag, &pygeo, &press, &temp, &pyxin))
         return NULL;
     /* extract geopos */
-    i = py_seq2d(o1, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                "swisseph.heliacal_pheno_ut: geopos: %s", err);
-    /* extract atmospheric */
-    i = py_seq2d(o2, 4, atmo, err);
+    i = py_seq2d(pygeo, 3, geo, err);
     if (i > 0)
         return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                "swisseph.heliacal_pheno_ut: atmo: %s", err);
-    /* extract observer */
-    i = py_seq2d(o3, 6, observ, err);
+                                           "swisseph.azalt: geopos: %s", err);
+    /* extract xin */
+    i = py_seq2d(pyxin, 3, xin, err);
     if (i > 0)
         return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                              "swisseph.heliacal_pheno_ut: observer: %s", err);
-    /* set topo params */
-    if (flg & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    memset(dret, 0, sizeof(double) * 50);
-    i = swe_heliacal_pheno_ut(jd, geopos, atmo, observ, obj, evnt,
-                              flg, dret, err);
-    if (i == 0)
-        return Py_BuildValue(
-        "dddddddddddddddddddddddddddddddddddddddddddddddddd",
-        dret[0],dret[1],dret[2],dret[3],dret[4],dret[5],dret[6],dret[7],dret[8],
-        dret[9],dret[10],dret[11],dret[12],dret[13],dret[14],dret[15],dret[16],
-        dret[17],dret[18],dret[19],dret[20],dret[21],dret[22],dret[23],dret[24],
-        dret[25],dret[26],dret[27],dret[28],dret[29],dret[30],dret[31],dret[32],
-        dret[33],dret[34],dret[35],dret[36],dret[37],dret[38],dret[39],dret[40],
-        dret[41],dret[42],dret[43],dret[44],dret[45],dret[46],dret[47],dret[48],
-        dret[49]);
-    return PyErr_Format(pyswe_Error, "swisseph.heliacal_pheno_ut: %s", err);
+                                           "swisseph.azalt: xin: %s", err);
+    swe_azalt(jd, flag, geo, press, temp, xin, xaz);
+    return Py_BuildValue("ddd", xaz[0], xaz[1], xaz[2]);
 }
 
-/* swisseph.heliacal_ut */
-PyDoc_STRVAR(pyswe_heliacal_ut__doc__,
-"Find the Julian day of the next heliacal phenomenon.\n\n"
-":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
-" int eventtype, int flags\n\n"
+/* swisseph.azalt_rev */
+PyDoc_STRVAR(pyswe_azalt_rev__doc__,
+"Calculate either ecliptical or equatorial coordinates from azimuth and true"
+" altitude.\n\n"
+":Args: float tjdut, int flag, seq geopos, double azimuth, double"
+" true_altitude\n\n"
 " - tjdut: input time, Julian day number, Universal Time\n"
+" - flag: either HOR2ECL (to ecliptical coord) or HOR2EQU (to equatorial)\n"
 " - geopos: a sequence with:\n"
-"    - 0: geographic longitude (eastern positive)\n"
-"    - 1: geographic latitude (northern positive)\n"
-"    - 2: altitude above sea level, in meters\n"
-" - atmo: a sequence with:\n"
-"    - 0: atmospheric pressure in mbar (hPa)\n"
-"    - 1: atmospheric temperature in degrees Celsius\n"
-"    - 2: relative humidity in %\n"
-"    - 3: if >= 1, Meteorological Range (km).\n"
-"      Between 1 and 0, total atmospheric coefficient (ktot).\n"
-"      If = 0, the other atmospheric parameters determine the total\n"
-"      atmospheric coefficient (ktot)\n"
-" - observer: a sequence with:\n"
-"    - 0: age of observer in years (default = 36)\n"
-"    - 1: snellen ratio of observers eyes (default = 1 = normal)\n"
-"    - The following parameters are only relevant if HELFLAG_OPTICAL_PARAMS\n"
-"      is set:\n"
-"    - 2: (0) = monocular, (1) = binocular (boolean)\n"
-"    - 3: telescope magnification, (0) = default to naked eye (binocular),\n"
-"      (1) = naked eye\n"
-"    - 4: optical aperture (telescope diameter) in mm\n"
-"    - 5: optical transmission\n"
-" - objname: name of planet or fixed star\n"
-" - eventtype: either:\n"
-"    - HELIACAL_RISING: morning first, for all visible planets and stars\n"
-"    - HELIACAL_SETTING: evening last, for all visible planets and stars\n"
-"    - EVENING_FIRST: evening first, for Mercury, Venus, Moon\n"
-"    - MORNING_LAST: morning last, for Mercury, Venus, Moon\n"
-" - flags: bit flags for ephemeris, and also:\n"
-"    - HELFLAG_OPTICAL_PARAMS: for optical instruments\n"
-"    - HELFLAG_NO_DETAILS: provide date, without details\n"
-"    - HELFLAG_VISLIM_DARK: behave as if Sun is at nadir\n"
-"    - HELFLAG_VISLIM_NOMOON: behave as if Moon is at nadir, i.e. the Moon as\n"
-"      a factor disturbing the observation is excluded, useful if one is not\n"
-"      interested in the heliacal date of that particular year, but in the\n"
-"      heliacal date of that epoch\n\n"
-":Return: (dret)\n\n"
-" - dret: tuple of 3 Julian days:\n"
-"    - 0: start visibility\n"
-"    - 1: optimum visibility, 0 if flags >= HELFLAG_AV\n"
-"    - 2: end of visibility, 0 if flags >= HELFLAG_AV\n\n"
-"It works between geographic latitudes 60s - 60n.\n\n"
-"Default values for ``atmo``: If this is too much for you, set all these"
-" values to 0. The software will then set the following defaults: Pressure"
-" 1013.25, temperature 15, relative humidity 40. The values will be modified"
-" depending on the altitude of the observer above sea level. If the extinction"
-" coefficient (meteorological range) ``datm[3]`` is 0, the software will"
-" calculate its value from ``datm[0..2]``.\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+"    - 0: geographic longitude, in degrees (eastern positive)\n"
+"    - 1: geographic latitude, in degrees (northern positive)\n"
+"    - 2: geographic altitude, in meters above sea level)\n"
+" - azimuth: position degree, measured from south point to west\n"
+" - true_altitude: true altitude above horizon in degrees\n\n"
+":Return: float x1, x2\n\n"
+" - x1, x2: ecliptical or equatorial coordinates, depending on flag\n\n"
+"This function is not precisely the reverse of ``azalt()``. It computes either"
+" ecliptical or equatorial coordinates from azimuth and true altitude. If"
+" only an apparent altitude is given, the true altitude has to be computed"
+" first with the function ``refrac()``.");
 
-static PyObject * pyswe_heliacal_ut FUNCARGS_KEYWDS
+static PyObject * pyswe_azalt_rev FUNCARGS_KEYWDS
 {
-    double jd, geopos[3], atmo[4], observ[6], dret[50];
-    char err[256] = {0}, *obj;
-    int i, evnt, flg;
-    PyObject *o1, *o2, *o3;
-    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
-                             "eventtype", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsii", kwlist,
-                                     &jd, &o1, &o2, &o3, &obj, &evnt, &flg))
+    double jd, geo[3], xin[2], xout[2];
+    int i, flag;
+    char err[128] = {0};
+    PyObject *pygeo;
+    static char *kwlist[] = {"tjdut", "flag", "geopos", "azimuth",
+                             "true_altitude", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "diOdd", kwlist, &jd,
+                                     &flag, &pygeo, &xin[0], &xin[1]))
         return NULL;
     /* extract geopos */
-    i = py_seq2d(o1, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.heliacal_ut: geopos: %s", err);
-    /* extract atmospheric */
-    i = py_seq2d(o2, 4, atmo, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.heliacal_ut: atmo: %s", err);
-    /* extract observer */
-    i = py_seq2d(o3, 6, observ, err);
+    i = py_seq2d(pygeo, 3, geo, err);
     if (i > 0)
         return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.heliacal_ut: observer: %s", err);
-    /* set topo params */
-    if (flg & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_heliacal_ut(jd, geopos, atmo, observ, obj,
-                        evnt, flg, dret, err);
-    if (i == 0)
-        return Py_BuildValue("ddd", dret[0], dret[1], dret[2]);
-    return PyErr_Format(pyswe_Error, "swisseph.heliacal_ut: %s", err);
+                                        "swisseph.azalt_rev: geopos: %s", err);
+    swe_azalt_rev(jd, flag, geo, xin, xout);
+    return Py_BuildValue("dd", xout[0], xout[1]);
 }
 
-/* swisseph.helio_cross */
-PyDoc_STRVAR(pyswe_helio_cross__doc__,
-"Compute a planet heliocentric crossing over some longitude (ET).\n\n"
-":Args: int planet, float x2cross, float tjdet, int flags=FLG_SWIEPH,"
-" bool backwards=False\n\n"
-" - planet: planet number\n"
-" - x2cross: longitude to search\n"
-" - tjdet: start time of search, as Julian day number, Ephemeris Time\n"
-" - flags: bit flags indicating what computation is wanted\n"
-" - backwards: a boolean indicating if we search back in time\n\n"
-":Return: float jdcross\n\n"
-" - jdcross: Julian day found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.batch */
+PyDoc_STRVAR(pyswe_batch__doc__,
+"Calculate positions for many heterogeneous requests.\n\n"
+":Args: seq requests, str errors='raise', list errlist=None\n\n"
+" - requests: sequence of records (kind, tjd, body, flags), as tuples or the"
+" rows of a numpy structured array:\n"
+"    - kind: 'calc_ut', 'calc', 'fixstar_ut' or 'fixstar' (str or bytes)\n"
+"    - tjd: julian day number, universal time for the kinds ending with _ut,"
+" else ephemeris time\n"
+"    - body: planet number for calc kinds, star name (as fixstar2) for"
+" fixstar kinds\n"
+"    - flags: bit flags, FLG_SWIEPH|FLG_SPEED if the record has 3 items\n"
+" - errors: policy for the requests in error (see calc_ut_array)\n"
+" - errlist: list where (index, message) of the requests in error are"
+" appended, if errors is not 'raise'\n\n"
+":Return: xx, retflags\n\n"
+" - xx: memoryview of float64 of shape (n, 6), the positions\n"
+" - retflags: memoryview of int32 of shape (n,), the returned flags\n\n"
+"Requests are sorted by kind, flags, body and date, so that libswe reuses its"
+" caches, identical requests are computed once, and the groups are computed"
+" in parallel by the thread pool (see set_num_threads). Results are in the"
+" order of the requests. With errors='raise', this function raises"
+" swisseph.Error in case of fatal error, for the first request in error.");
+
+enum { PYSWE_BATCH_CALC_UT, PYSWE_BATCH_CALC, PYSWE_BATCH_FIXSTAR_UT,
+       PYSWE_BATCH_FIXSTAR };
+
+static const char* pyswe_batch_kinds[] = {
+    "calc_ut", "calc", "fixstar_ut", "fixstar", NULL};
 
-static PyObject * pyswe_helio_cross FUNCARGS_KEYWDS
-{
-    int pl, flags = SEFLG_SWIEPH, backw = 0;
-    double x2, jd, jdcross;
-    char err[256] = {0};
-    static char* kwlist[] = {"planet", "x2cross", "tjdet", "flags",
-                             "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "idd|ii", kwlist,
-                                     &pl, &x2, &jd, &flags, &backw))
-        return NULL;
-    backw = backw ? -1 : 1;
-    if (swe_helio_cross(pl, x2, jd, flags, backw, &jdcross, err))
-        return PyErr_Format(pyswe_Error, "swisseph.helio_cross: %s", err);
-    return Py_BuildValue("d", jdcross);
-}
+typedef struct {
+    double jd;
+    const char* star; /* NULL for planets */
+    int kind;
+    int pl;
+    int flag;
+    Py_ssize_t index; /* in the requests */
+    Py_ssize_t same; /* index of the identical request computed, or -1 */
+} pyswe_BatchItem;
 
-/* swisseph.helio_cross_ut */
-PyDoc_STRVAR(pyswe_helio_cross_ut__doc__,
-"Compute a planet heliocentric crossing over some longitude (UT).\n\n"
-":Args: int planet, float x2cross, float tjdut, int flags=FLG_SWIEPH,"
-" bool backwards=False\n\n"
-" - planet: planet number\n"
-" - x2cross: longitude to search\n"
-" - tjdut: start time of search, as Julian day number, Universal Time\n"
-" - flags: bit flags indicating what computation is wanted\n"
-" - backwards: a boolean indicating if we search back in time\n\n"
-":Return: float jdcross\n\n"
-" - jdcross: Julian day found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+typedef struct {
+    pyswe_BatchItem** todo; /* requests computed, sorted */
+    double* xx;
+    int* ret;
+} pyswe_Batch;
 
-static PyObject * pyswe_helio_cross_ut FUNCARGS_KEYWDS
+static int pyswe_batch_cmp(const void* a, const void* b)
 {
-    int pl, flags = SEFLG_SWIEPH, backw = 0;
-    double x2, jd, jdcross;
-    char err[256] = {0};
-    static char* kwlist[] = {"planet", "x2cross", "tjdut", "flags",
-                             "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "idd|ii", kwlist,
-                                     &pl, &x2, &jd, &flags, &backw))
-        return NULL;
-    backw = backw ? -1 : 1;
-    if (swe_helio_cross_ut(pl, x2, jd, flags, backw, &jdcross, err))
-        return PyErr_Format(pyswe_Error, "swisseph.helio_cross_ut: %s", err);
-    return Py_BuildValue("d", jdcross);
+    const pyswe_BatchItem *x = (const pyswe_BatchItem*) a;
+    const pyswe_BatchItem *y = (const pyswe_BatchItem*) b;
+    int i;
+    if (x->kind != y->kind)
+        return x->kind < y->kind ? -1 : 1;
+    if (x->flag != y->flag)
+        return x->flag < y->flag ? -1 : 1;
+    if (x->pl != y->pl)
+        return x->pl < y->pl ? -1 : 1;
+    if (x->star && (i = strcmp(x->star, y->star)))
+        return i;
+    if (x->jd != y->jd)
+        return x->jd < y->jd ? -1 : 1;
+    return x->index < y->index ? -1 : (x->index > y->index);
+}
+
+static void pyswe_batch_run(pyswe_Job* job, Py_ssize_t start, Py_ssize_t end)
+{
+    pyswe_Batch* a = (pyswe_Batch*) job->data;
+    pyswe_BatchItem* it;
+    char err[256], star[(SE_MAX_STNAME*2)+1];
+    double* xx;
+    int* ret;
+    Py_ssize_t i;
+    for (i = start; i < end; ++i) {
+        it = a->todo[i];
+        xx = a->xx + it->index * 6;
+        ret = a->ret + it->index;
+        err[0] = '\0';
+        switch (it->kind) {
+        case PYSWE_BATCH_CALC_UT:
+            *ret = swe_calc_ut(it->jd, it->pl, it->flag, xx, err);
+            break;
+        case PYSWE_BATCH_CALC:
+            *ret = swe_calc(it->jd, it->pl, it->flag, xx, err);
+            break;
+        default:
+            /* fixstar2 writes the full name of the star */
+            star[0] = '\0';
+            strncat(star, it->star, SE_MAX_STNAME*2);
+            *ret = it->kind == PYSWE_BATCH_FIXSTAR_UT
+                ? swe_fixstar2_ut(star, it->jd, it->flag, xx, err)
+                : swe_fixstar2(star, it->jd, it->flag, xx, err);
+            break;
+        }
+        if (*ret < 0)
+            pyswe_job_error(job, it->index, err);
+    }
 }
 
-/* swisseph.house_name */
-PyDoc_STRVAR(pyswe_house_name__doc__,
-"Get the name of a house method.\n\n"
-":Args: bytes hsys\n\n"
-" - hsys: house system identifier (1 byte)\n\n"
-":Return: str hsysname\n\n"
-" - hsysname: house system name, empty string if not found");
+/* Get a request of the batch
+ * String bodies are kept alive in keep.
+ * Return -1 on error, with an exception set.
+ */
+static int pyswe_batch_item(PyObject* o, Py_ssize_t index, PyObject* keep,
+                            pyswe_BatchItem* it)
+{
+    PyObject *rec, *kind, *body;
+    const char* s;
+    Py_ssize_t n;
+    int ret = -1;
+    if (!(rec = PySequence_Fast(o, ""))) {
+        PyErr_Format(PyExc_TypeError, "swisseph.batch: requests: item %zd:"
+                     " must be a sequence", index);
+        return -1;
+    }
+    n = PySequence_Fast_GET_SIZE(rec);
+    if (n != 3 && n != 4) {
+        PyErr_Format(PyExc_TypeError, "swisseph.batch: requests: item %zd:"
+                     " must have 3 or 4 items", index);
+        goto end;
+    }
+    it->index = index;
+    it->same = -1;
+    it->star = NULL;
+    it->pl = 0;
+    /* kind */
+    kind = PySequence_Fast_GET_ITEM(rec, 0);
+    s = PyUnicode_Check(kind) ? PyUnicode_AsUTF8(kind)
+        : PyBytes_Check(kind) ? PyBytes_AS_STRING(kind) : NULL;
+    for (it->kind = 0; s && pyswe_batch_kinds[it->kind]; ++it->kind) {
+        if (!strcmp(s, pyswe_batch_kinds[it->kind]))
+            break;
+    }
+    if (!s || !pyswe_batch_kinds[it->kind]) {
+        if (!PyErr_Occurred())
+            PyErr_Format(PyExc_ValueError, "swisseph.batch: requests: item"
+                         " %zd: invalid kind %R", index, kind);
+        goto end;
+    }
+    /* date */
+    it->jd = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(rec, 1));
+    if (it->jd == -1 && PyErr_Occurred()) {
+        s = "tjd must be a float";
+        goto type_error;
+    }
+    /* body */
+    body = PySequence_Fast_GET_ITEM(rec, 2);
+    if (it->kind == PYSWE_BATCH_FIXSTAR_UT || it->kind == PYSWE_BATCH_FIXSTAR) {
+        if (PyUnicode_Check(body))
+            it->star = PyUnicode_AsUTF8(body);
+        else if (PyBytes_Check(body))
+            it->star = PyBytes_AS_STRING(body);
+        else {
+            PyErr_Format(PyExc_TypeError, "swisseph.batch: requests: item"
+                         " %zd: star must be a str", index);
+            goto end;
+        }
+        if (!it->star || PyList_Append(keep, body))
+            goto end;
+    }
+    else if ((it->pl = (int) PyLong_AsLong(body)) == -1 && PyErr_Occurred()) {
+        s = "planet must be an int";
+        goto type_error;
+    }
+    /* flags */
+    it->flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    if (n == 4) {
+        it->flag = (int) PyLong_AsLong(PySequence_Fast_GET_ITEM(rec, 3));
+        if (it->flag == -1 && PyErr_Occurred()) {
+            s = "flags must be an int";
+            goto type_error;
+        }
+    }
+    ret = 0;
+end:
+    Py_DECREF(rec);
+    return ret;
+type_error:
+    if (PyErr_ExceptionMatches(PyExc_TypeError)) {
+        PyErr_Clear();
+        PyErr_Format(PyExc_TypeError, "swisseph.batch: requests: item %zd:"
+                     " %s", index, s);
+    }
+    goto end;
+}
 
-static PyObject * pyswe_house_name FUNCARGS_KEYWDS
+static PyObject * pyswe_batch FUNCARGS_KEYWDS
 {
-    char h, *nam;
-    static char *kwlist[] = {"hsys", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "c", kwlist, &h))
-        return NULL;
-    if (h != 'i')
-        h = toupper(h);
-    nam = (char*) swe_house_name(h);
-    return Py_BuildValue("s", h != 'P' && !strcmp(nam, "Placidus") ? "" : nam);
+    pyswe_Batch a;
+    pyswe_BatchItem *items = NULL, *rep = NULL;
+    pyswe_Job job;
+    PyObject *requests, *seq, *keep = NULL, *xx = NULL, *ret = NULL;
+    PyObject* errlist = NULL;
+    pyswe_ItemError key, *e;
+    Py_ssize_t i, n, nerrs, ntodo = 0;
+    char* errors = "raise";
+    int x;
+    static char *kwlist[] = {"requests", "errors", "errlist", NULL};
+    a.todo = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sO", kwlist, &requests,
+                                     &errors, &errlist)
+        || pyswe_job_policy(&job, errors, errlist, "batch"))
+        return NULL;
+    if (!(seq = PySequence_Fast(requests, "swisseph.batch: requests: must be"
+                                " a sequence")))
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(seq);
+    if (!(keep = PyList_New(0))
+        || !(items = PyMem_Malloc(sizeof(pyswe_BatchItem) * (n ? n : 1)))
+        || !(a.todo = PyMem_Malloc(sizeof(pyswe_BatchItem*) * (n ? n : 1)))) {
+        if (keep)
+            PyErr_NoMemory();
+        goto error;
+    }
+    for (i = 0; i < n; ++i) {
+        if (pyswe_batch_item(PySequence_Fast_GET_ITEM(seq, i), i, keep,
+                             &items[i]))
+            goto error;
+    }
+    /* group the requests, and compute identical ones once */
+    qsort(items, n, sizeof(pyswe_BatchItem), pyswe_batch_cmp);
+    for (i = 0; i < n; ++i) {
+        if (rep && rep->kind == items[i].kind && rep->flag == items[i].flag
+            && rep->pl == items[i].pl && rep->jd == items[i].jd
+            && (!rep->star || !strcmp(rep->star, items[i].star)))
+            items[i].same = rep->index;
+        else
+            a.todo[ntodo++] = rep = &items[i];
+    }
+    if (!(xx = pyswe_results_new(n, 6, sizeof(double), (void**) &a.xx))
+        || !(ret = pyswe_results_new(n, 1, sizeof(int), (void**) &a.ret)))
+        goto error;
+    job.func = pyswe_batch_run;
+    job.data = &a;
+    job.n = ntodo;
+    job.chunk = 32;
+    x = pyswe_pool_run(&job);
+    /* identical requests are in error too */
+    pyswe_job_errors_sort(&job);
+    nerrs = job.nerrs;
+    for (i = 0; !x && i < n; ++i) {
+        if (items[i].same >= 0) {
+            memcpy(a.xx + items[i].index * 6, a.xx + items[i].same * 6,
+                   sizeof(double) * 6);
+            a.ret[items[i].index] = a.ret[items[i].same];
+            if (a.ret[items[i].index] < 0 && job.errlist > 0) {
+                key.index = items[i].same;
+                e = bsearch(&key, job.errs, nerrs, sizeof(pyswe_ItemError),
+                            pyswe_item_error_cmp);
+                pyswe_job_error(&job, items[i].index, e ? e->err : "");
+            }
+        }
+    }
+    if (pyswe_job_errors(&job, pyswe_error(self), "batch", errlist))
+        goto error;
+    if (job.errors == PYSWE_ERRORS_NAN)
+        pyswe_results_nan(a.xx, 6, a.ret, n);
+    PyMem_Free(items);
+    PyMem_Free(a.todo);
+    Py_DECREF(keep);
+    Py_DECREF(seq);
+    return Py_BuildValue("NN", pyswe_results_view(xx, "d", n, 6),
+                         pyswe_results_view(ret, "i", n, 0));
+error:
+    PyMem_Free(items);
+    PyMem_Free(a.todo);
+    Py_XDECREF(keep);
+    Py_XDECREF(xx);
+    Py_XDECREF(ret);
+    Py_DECREF(seq);
+    return NULL;
 }
 
-/* swisseph.house_pos */
-PyDoc_STRVAR(pyswe_house_pos__doc__,
-"Calculate house position of a body.\n\n"
-":Args: float armc, float geolat, float eps, seq objcoord,"
-" bytes hsys=b'P'\n\n"
-" - armc: ARMC\n"
-" - geolat: geographic latitude, in degrees (northern positive)\n"
-" - eps: obliquity, in degrees\n"
-" - objcoord: a sequence for ecl. longitude and latitude of the planet,\n"
-"   in degrees\n"
-" - hsys: house method identifier (1 byte)\n\n"
-":Return: float hpos\n\n"
-" - hpos: value in [1:13[ (Gauquelin: [1:37[) indicating the house position\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.calc */
+PyDoc_STRVAR(pyswe_calc__doc__,
+"Calculate planetary positions (ET).\n\n"
+":Args: float tjdet, int planet, int flags=FLG_SWIEPH|FLG_SPEED, out=None\n\n"
+" - tjdet: Julian day, Ephemeris Time, where tjdet == tjdut + deltat(tjdut)\n"
+" - planet: body number\n"
+" - flags: bit flags indicating what kind of computation is wanted\n"
+" - out: optional writable buffer of 6 float64 to fill with the results\n\n"
+":Return: (xx), int retflags\n\n"
+" - xx: Position, tuple of 6 float for results (omitted if out is given)\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function can raise swisseph.Error in case of fatal error.");
 
-static PyObject * pyswe_house_pos FUNCARGS_KEYWDS
+/* Compute and build the result of calc, after parsing */
+static PyObject * pyswe_calc_impl(PyObject* self, double jd, int pl, int flag,
+                                  PyObject* out)
 {
-    double armc, lat, obl, res, obj[2] = {0.0, 0.0};
-    int i, hsys = 'P';
+    double xx[6];
+    int ret;
     char err[256] = {0};
-    PyObject* coord;
-    static char *kwlist[] = {"armc", "geolat", "eps", "objcoord", "hsys", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dddO|c", kwlist,
-                                     &armc, &lat, &obl, &coord, &hsys))
-        return NULL;
-    /* extract coord */
-    i = py_seq2d(coord, 2, obj, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.house_pos: objcoord: %s", err);
-    res = swe_house_pos(armc, lat, obl, hsys, obj, err);
-    if (res < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.house_pos: %s", err);
-    return Py_BuildValue("d", res);
+    ret = swe_calc(jd, pl, flag, xx, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.calc: %s", err);
+    if (out != Py_None)
+        return pyswe_out_d(out, xx, 6, "calc") ? NULL : PyLong_FromLong(ret);
+    return pyswe_calc_result(pyswe_get_state(self), xx, ret);
 }
 
-/* swisseph.houses */
-PyDoc_STRVAR(pyswe_houses__doc__,
-"Calculate houses cusps (UT).\n\n"
-":Args: float tjdut, float lat, float lon, bytes hsys=b'P'\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - lat: geographic latitude, in degrees (northern positive)\n"
-" - lon: geographic longitude, in degrees (eastern positive)\n"
-" - hsys: house method identifier (1 byte)\n\n"
-":Return: (cusps), (ascmc)\n\n"
-" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
-" - ascmc: tuple of 8 float for additional points\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_houses FUNCARGS_KEYWDS
+static PyObject * pyswe_calc FUNCARGS_KEYWDS
 {
-    double jd, lat, lon, cusps[37], ascmc[10];
-    int ret, hsys = 'P';
-    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|c", kwlist,
-                                     &jd, &lat, &lon, &hsys))
-        return NULL;
-    ret = swe_houses(jd, lat, lon, hsys, cusps, ascmc);
-    if (ret < 0) {
-        PyErr_SetString(pyswe_Error, "swisseph.houses: error");
+    double jd;
+    int pl, flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    PyObject *out = Py_None;
+    static char *kwlist[] = {"tjdet", "planet", "flags", "out", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|iO", kwlist,
+                                     &jd, &pl, &flag, &out))
         return NULL;
-    }
-    if (hsys == 71) /* Gauquelin houses */
-        return Py_BuildValue("(dddddddddddddddddddddddddddddddddddd)(dddddddd)",
-        cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-        cusps[9],cusps[10],cusps[11],cusps[12],cusps[13],cusps[14],cusps[15],
-        cusps[16],cusps[17],cusps[18],cusps[19],cusps[20],cusps[21],cusps[22],
-        cusps[23],cusps[24],cusps[25],cusps[26],cusps[27],cusps[28],cusps[29],
-        cusps[30],cusps[31],cusps[32],cusps[33],cusps[34],cusps[35],cusps[36],
-        ascmc[0],ascmc[1],ascmc[2],ascmc[3],ascmc[4],ascmc[5],ascmc[6],ascmc[7]);
-    return Py_BuildValue("(dddddddddddd)(dddddddd)", cusps[1],cusps[2],
-    cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],cusps[9],cusps[10],
-    cusps[11],cusps[12],ascmc[0],ascmc[1],ascmc[2],ascmc[3],ascmc[4],ascmc[5],
-    ascmc[6],ascmc[7]);
+    return pyswe_calc_impl(self, jd, pl, flag, out);
 }
 
-/* swisseph.houses_armc */
-PyDoc_STRVAR(pyswe_houses_armc__doc__,
-"Calculate houses cusps with ARMC.\n\n"
-":Args: float armc, float lat, float eps, bytes hsys=b'P',"
-" float ascmc9=0.0\n\n"
-" - armc: ARMC\n"
-" - lat: geographic latitude, in degrees (northern positive)\n"
-" - eps: obliquity, in degrees\n"
-" - hsys: house method identifier (1 byte)\n"
-" - ascmc9: optional parameter for Sunshine house system\n\n"
-":Return: (cusps), (ascmc)\n\n"
-" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
-" - ascmc: tuple of 8 float for additional points\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_houses_armc FUNCARGS_KEYWDS
+#if PYSWE_FASTCALL
+static PyObject * pyswe_calc_fast FUNCARGS_FAST
 {
-    double armc, lat, obl, cusps[37], ascmc[10];
-    int ret, hsys = 'P';
-    ascmc[9] = 0; /* sunshine hsys */
-    static char *kwlist[] = {"armc", "lat", "eps", "hsys", "ascmc9", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|cd", kwlist,
-                                     &armc, &lat, &obl, &hsys, &ascmc[9]))
-        return NULL;
-    ret = swe_houses_armc(armc, lat, obl, hsys, cusps, ascmc);
-    if (ret < 0) {
-        PyErr_SetString(pyswe_Error, "swisseph.houses_armc: error");
-        return NULL;
-    }
-    if (hsys == 71) /* Gauquelin houses */
-        return Py_BuildValue("(dddddddddddddddddddddddddddddddddddd)(dddddddd)",
-        cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-        cusps[9],cusps[10],cusps[11],cusps[12],cusps[13],cusps[14],cusps[15],
-        cusps[16],cusps[17],cusps[18],cusps[19],cusps[20],cusps[21],cusps[22],
-        cusps[23],cusps[24],cusps[25],cusps[26],cusps[27],cusps[28],cusps[29],
-        cusps[30],cusps[31],cusps[32],cusps[33],cusps[34],cusps[35],cusps[36],
-        ascmc[0],ascmc[1],ascmc[2],ascmc[3],ascmc[4],ascmc[5],ascmc[6],ascmc[7]);
-    return Py_BuildValue("(dddddddddddd)(dddddddd)", cusps[1],cusps[2],
-    cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],cusps[9],
-    cusps[10],cusps[11],cusps[12],ascmc[0],ascmc[1],ascmc[2],ascmc[3],
-    ascmc[4],ascmc[5],ascmc[6],ascmc[7]);
+    PyObject *a[4];
+    double jd;
+    int pl, flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    static char *kwlist[] = {"tjdet", "planet", "flags", "out", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 2, a)
+        || pyswe_fast_d(a[0], &jd) || pyswe_fast_i(a[1], &pl)
+        || (a[2] && pyswe_fast_i(a[2], &flag)))
+        return pyswe_fast_fallback(pyswe_calc, self, args, nargs, kwnames);
+    return pyswe_calc_impl(self, jd, pl, flag, a[3] ? a[3] : Py_None);
 }
+#endif
 
-/* swisseph.houses_armc_ex2 */
-PyDoc_STRVAR(pyswe_houses_armc_ex2__doc__,
-"Calculate houses cusps and their speeds with ARMC.\n\n"
-":Args: float armc, float lat, float eps, bytes hsys=b'P',"
-" float ascmc9=0.0\n\n"
-" - armc: ARMC\n"
-" - lat: geographic latitude, in degrees (northern positive)\n"
-" - eps: obliquity, in degrees\n"
-" - hsys: house method identifier (1 byte)\n"
-" - ascmc9: optional parameter for Sunshine house system\n\n"
-":Return: (cusps), (ascmc), (cuspsspeed), (ascmcspeed)\n\n"
-" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
-" - ascmc: tuple of 8 float for additional points\n"
-" - cuspsspeed: tuple of 12 float for cusps speeds\n"
-" - ascmcspeed: tuple of 8 float for speeds of additional points\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.calc_pctr */
+PyDoc_STRVAR(pyswe_calc_pctr__doc__,
+"Calculate planetocentric positions of planets (ET).\n\n"
+":Args: float tjd, int planet, int center, int flags=FLG_SWIEPH|FLG_SPEED,"
+" out=None\n\n"
+" - tjdet: julian day in ET (TT)\n"
+" - planet: body number of target object\n"
+" - center: body number of center object\n"
+" - flags: bit flags indicating what kind of computation is wanted\n"
+" - out: optional writable buffer of 6 float64 to fill with the results\n\n"
+":Return: (xx), int retflags\n\n"
+" - xx: Position, tuple of 6 float for results (omitted if out is given)\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function can raise swisseph.Error in case of fatal error.");
 
-static PyObject * pyswe_houses_armc_ex2 FUNCARGS_KEYWDS
+/* Compute and build the result of calc_pctr, after parsing */
+static PyObject * pyswe_calc_pctr_impl(PyObject* self, double jd, int pl,
+                                       int plctr, int flag, PyObject* out)
 {
-    double armc, lat, obl, cusps[37], ascmc[10], cuspspeed[37], ascmcspeed[10];
-    int ret, hsys = 'P';
+    double xx[6];
+    int ret;
     char err[256] = {0};
-    ascmc[9] = 0; /* sunshine hsys */
-    static char *kwlist[] = {"armc", "lat", "eps", "hsys", "ascmc9", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|cd", kwlist,
-                                     &armc, &lat, &obl, &hsys, &ascmc[9]))
-        return NULL;
-    ret = swe_houses_armc_ex2(armc, lat, obl, hsys, cusps, ascmc,
-                              cuspspeed, ascmcspeed, err);
+    ret = swe_calc_pctr(jd, pl, plctr, flag, xx, err);
     if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.houses_armc_ex2: %s", err);
-    if (hsys == 71) /* Gauquelin sectors */
-        return Py_BuildValue("(dddddddddddddddddddddddddddddddddddd)(dddddddd)"
-                             "(dddddddddddddddddddddddddddddddddddd)(dddddddd)",
-        cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-        cusps[9],cusps[10],cusps[11],cusps[12],cusps[13],cusps[14],cusps[15],
-        cusps[16],cusps[17],cusps[18],cusps[19],cusps[20],cusps[21],cusps[22],
-        cusps[23],cusps[24],cusps[25],cusps[26],cusps[27],cusps[28],cusps[29],
-        cusps[30],cusps[31],cusps[32],cusps[33],cusps[34],cusps[35],cusps[36],
-        ascmc[0],ascmc[1],ascmc[2],ascmc[3],ascmc[4],ascmc[5],ascmc[6],ascmc[7],
-        cuspspeed[1],cuspspeed[2],cuspspeed[3],cuspspeed[4],cuspspeed[5],
-        cuspspeed[6],cuspspeed[7],cuspspeed[8],cuspspeed[9],cuspspeed[10],
-        cuspspeed[11],cuspspeed[12],cuspspeed[13],cuspspeed[14],cuspspeed[15],
-        cuspspeed[16],cuspspeed[17],cuspspeed[18],cuspspeed[19],cuspspeed[20],
-        cuspspeed[21],cuspspeed[22],cuspspeed[23],cuspspeed[24],cuspspeed[25],
-        cuspspeed[26],cuspspeed[27],cuspspeed[28],cuspspeed[29],cuspspeed[30],
-        cuspspeed[31],cuspspeed[32],cuspspeed[33],cuspspeed[34],cuspspeed[35],
-        cuspspeed[36],ascmcspeed[0],ascmcspeed[1],ascmcspeed[2],ascmcspeed[3],
-        ascmcspeed[4],ascmcspeed[5],ascmcspeed[6],ascmcspeed[7]);
-    return Py_BuildValue("(dddddddddddd)(dddddddd)(dddddddddddd)(dddddddd)",
-    cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-    cusps[9],cusps[10],cusps[11],cusps[12],ascmc[0],ascmc[1],ascmc[2],ascmc[3],
-    ascmc[4],ascmc[5],ascmc[6],ascmc[7],cuspspeed[1],cuspspeed[2],cuspspeed[3],
-    cuspspeed[4],cuspspeed[5],cuspspeed[6],cuspspeed[7],cuspspeed[8],
-    cuspspeed[9],cuspspeed[10],cuspspeed[11],cuspspeed[12],ascmcspeed[0],
-    ascmcspeed[1],ascmcspeed[2],ascmcspeed[3],ascmcspeed[4],ascmcspeed[5],
-    ascmcspeed[6],ascmcspeed[7]);
+        return PyErr_Format(pyswe_error(self), "swisseph.calc_pctr: %s", err);
+    if (out != Py_None)
+        return pyswe_out_d(out, xx, 6, "calc_pctr") ? NULL
+            : PyLong_FromLong(ret);
+    return pyswe_calc_result(pyswe_get_state(self), xx, ret);
 }
 
-/* swisseph.houses_ex */
-PyDoc_STRVAR(pyswe_houses_ex__doc__,
-"Calculate houses cusps (extended) (UT).\n\n"
-":Args: float tjdut, float lat, float lon, bytes hsys=b'P', int flags=0\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - lat: geographic latitude, in degrees (northern positive)\n"
-" - lon: geographic longitude, in degrees (eastern positive)\n"
-" - hsys: house method identifier (1 byte)\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: (cusps), (ascmc)\n\n"
-" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
-" - ascmc: tuple of 8 float for additional points\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_houses_ex FUNCARGS_KEYWDS
+static PyObject * pyswe_calc_pctr FUNCARGS_KEYWDS
 {
-    double jd, lat, lon, cusps[37], ascmc[10];
-    int ret, hsys = 'P', flag = 0;
-    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|ci", kwlist,
-                                     &jd, &lat, &lon, &hsys, &flag))
-        return NULL;
-    ret = swe_houses_ex(jd, flag, lat, lon, hsys, cusps, ascmc);
-    if (ret < 0) {
-        PyErr_SetString(pyswe_Error, "swisseph.houses_ex: error");
+    double jd;
+    int pl, plctr, flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    PyObject *out = Py_None;
+    static char* kwlist[] = {"tjdet", "planet", "center", "flags", "out",
+                             NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dii|iO", kwlist,
+                                     &jd, &pl, &plctr, &flag, &out))
         return NULL;
-    }
-    if (hsys == 71) /* Gauquelin houses */
-        return Py_BuildValue("(dddddddddddddddddddddddddddddddddddd)(dddddddd)",
-        cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-        cusps[9],cusps[10],cusps[11],cusps[12],cusps[13],cusps[14],cusps[15],
-        cusps[16],cusps[17],cusps[18],cusps[19],cusps[20],cusps[21],cusps[22],
-        cusps[23],cusps[24],cusps[25],cusps[26],cusps[27],cusps[28],cusps[29],
-        cusps[30],cusps[31],cusps[32],cusps[33],cusps[34],cusps[35],cusps[36],
-        ascmc[0],ascmc[1],ascmc[2],ascmc[3],ascmc[4],ascmc[5],ascmc[6],ascmc[7]);
-    return Py_BuildValue("(dddddddddddd)(dddddddd)", cusps[1],cusps[2],
-    cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],cusps[9],
-    cusps[10],cusps[11],cusps[12],ascmc[0],ascmc[1],ascmc[2],ascmc[3],
-    ascmc[4],ascmc[5],ascmc[6],ascmc[7]);
+    return pyswe_calc_pctr_impl(self, jd, pl, plctr, flag, out);
 }
 
-/* swisseph.houses_ex2 */
-PyDoc_STRVAR(pyswe_houses_ex2__doc__,
-"Calculate houses cusps and cusps speeds (UT).\n\n"
-":Args: float tjdut, float lat, float lon, bytes hsys=b'P', int flags=0\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - lat: geographic latitude, in degrees (northern positive)\n"
-" - lon: geographic longitude, in degrees (eastern positive)\n"
-" - hsys: house method identifier (1 byte)\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: (cusps), (ascmc), (cuspsspeed), (ascmcspeed)\n\n"
-" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
-" - ascmc: tuple of 8 float for additional points\n"
-" - cuspsspeed: tuple of 12 float for cusps speeds\n"
-" - ascmcspeed: tuple of 8 float for speeds of additional points\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_houses_ex2 FUNCARGS_KEYWDS
+#if PYSWE_FASTCALL
+static PyObject * pyswe_calc_pctr_fast FUNCARGS_FAST
 {
-    double jd, lat, lon, cusps[37], ascmc[10], cuspspeed[37], ascmcspeed[10];
-    int ret, hsys = 'P', flag = 0;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|ci", kwlist,
-                                     &jd, &lat, &lon, &hsys, &flag))
-        return NULL;
-    ret = swe_houses_ex2(jd, flag, lat, lon, hsys, cusps, ascmc,
-                         cuspspeed, ascmcspeed, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.houses_ex2: %s", err);
-    if (hsys == 71) /* Gauquelin sectors */
-        return Py_BuildValue("(dddddddddddddddddddddddddddddddddddd)(dddddddd)"
-                             "(dddddddddddddddddddddddddddddddddddd)(dddddddd)",
-        cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-        cusps[9],cusps[10],cusps[11],cusps[12],cusps[13],cusps[14],cusps[15],
-        cusps[16],cusps[17],cusps[18],cusps[19],cusps[20],cusps[21],cusps[22],
-        cusps[23],cusps[24],cusps[25],cusps[26],cusps[27],cusps[28],cusps[29],
-        cusps[30],cusps[31],cusps[32],cusps[33],cusps[34],cusps[35],cusps[36],
-        ascmc[0],ascmc[1],ascmc[2],ascmc[3],ascmc[4],ascmc[5],ascmc[6],ascmc[7],
-        cuspspeed[1],cuspspeed[2],cuspspeed[3],cuspspeed[4],cuspspeed[5],
-        cuspspeed[6],cuspspeed[7],cuspspeed[8],cuspspeed[9],cuspspeed[10],
-        cuspspeed[11],cuspspeed[12],cuspspeed[13],cuspspeed[14],cuspspeed[15],
-        cuspspeed[16],cuspspeed[17],cuspspeed[18],cuspspeed[19],cuspspeed[20],
-        cuspspeed[21],cuspspeed[22],cuspspeed[23],cuspspeed[24],cuspspeed[25],
-        cuspspeed[26],cuspspeed[27],cuspspeed[28],cuspspeed[29],cuspspeed[30],
-        cuspspeed[31],cuspspeed[32],cuspspeed[33],cuspspeed[34],cuspspeed[35],
-        cuspspeed[36],ascmcspeed[0],ascmcspeed[1],ascmcspeed[2],ascmcspeed[3],
-        ascmcspeed[4],ascmcspeed[5],ascmcspeed[6],ascmcspeed[7]);
-    return Py_BuildValue("(dddddddddddd)(dddddddd)(dddddddddddd)(dddddddd)",
-    cusps[1],cusps[2],cusps[3],cusps[4],cusps[5],cusps[6],cusps[7],cusps[8],
-    cusps[9],cusps[10],cusps[11],cusps[12],ascmc[0],ascmc[1],ascmc[2],ascmc[3],
-    ascmc[4],ascmc[5],ascmc[6],ascmc[7],cuspspeed[1],cuspspeed[2],cuspspeed[3],
-    cuspspeed[4],cuspspeed[5],cuspspeed[6],cuspspeed[7],cuspspeed[8],
-    cuspspeed[9],cuspspeed[10],cuspspeed[11],cuspspeed[12],ascmcspeed[0],
-    ascmcspeed[1],ascmcspeed[2],ascmcspeed[3],ascmcspeed[4],ascmcspeed[5],
-    ascmcspeed[6],ascmcspeed[7]);
+    PyObject *a[5];
+    double jd;
+    int pl, plctr, flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    static char *kwlist[] = {"tjdet", "planet", "center", "flags", "out",
+                             NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_d(a[0], &jd) || pyswe_fast_i(a[1], &pl)
+        || pyswe_fast_i(a[2], &plctr) || (a[3] && pyswe_fast_i(a[3], &flag)))
+        return pyswe_fast_fallback(pyswe_calc_pctr, self, args, nargs,
+                                   kwnames);
+    return pyswe_calc_pctr_impl(self, jd, pl, plctr, flag,
+                                a[4] ? a[4] : Py_None);
 }
+#endif
 
-/* swisseph.jdet_to_utc */
-PyDoc_STRVAR(pyswe_jdet_to_utc__doc__,
-"Convert ET Julian day number to UTC.\n\n"
-":Args: float tjdet, int cal=GREG_CAL\n\n"
-" - tjdet: Julian day number in ET (TT)\n"
-" - cal: calendar flag, either GREG_CAL or JUL_CAL\n\n"
-":Return: int year, int month, int day, int hour, int mins, float secs\n\n"
-" - year, month, day: returned date\n"
-" - hour, mins, secs: returned time\n\n"
-"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+/* swisseph.calc_ut */
+PyDoc_STRVAR(pyswe_calc_ut__doc__,
+"Calculate planetary positions (UT).\n\n"
+":Args: float tjdut, int planet, int flags=FLG_SWIEPH|FLG_SPEED, out=None\n\n"
+" - tjdut: julian day number, universal time\n"
+" - planet: body number\n"
+" - flags: bit flags indicating what kind of computation is wanted\n"
+" - out: optional writable buffer of 6 float64 to fill with the results\n\n"
+":Return: (xx), int retflags\n\n"
+" - xx: Position, tuple of 6 float for results (omitted if out is given)\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function can raise swisseph.Error in case of fatal error.");
 
-static PyObject * pyswe_jdet_to_utc FUNCARGS_KEYWDS
+/* Compute and build the result of calc_ut, after parsing */
+static PyObject * pyswe_calc_ut_impl(PyObject* self, double jd, int pl,
+                                     int flag, PyObject* out)
 {
-    int y, m, d, h, mi, flg = SE_GREG_CAL;
-    double s, et;
-    static char *kwlist[] = {"tjdet", "cal", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &et, &flg))
-        return NULL;
-    if (flg != SE_GREG_CAL && flg != SE_JUL_CAL)
-        return PyErr_Format(PyExc_ValueError,
-                            "swisseph.jdet_to_utc: invalid calendar (%d)", flg);
-    swe_jdet_to_utc(et, flg, &y, &m, &d, &h, &mi, &s);
-    return Py_BuildValue("iiiiid", y, m, d, h, mi, s);
+    double xx[6];
+    int ret;
+    char err[256] = {0};
+    ret = swe_calc_ut(jd, pl, flag, xx, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.calc_ut: %s", err);
+    if (out != Py_None)
+        return pyswe_out_d(out, xx, 6, "calc_ut") ? NULL : PyLong_FromLong(ret);
+    return pyswe_calc_result(pyswe_get_state(self), xx, ret);
 }
 
-/* swisseph.jdut1_to_utc */
-PyDoc_STRVAR(pyswe_jdut1_to_utc__doc__,
-"Convert UT1 Julian day number to UTC.\n\n"
-":Args: float tjdut, int cal=GREG_CAL\n\n"
-" - tjdut: Julian day number, in UT (UT1)\n"
-" - cal: either GREG_CAL or JUL_CAL\n\n"
-":Return: int year, int month, int day, int hour, int mins, float secs\n\n"
-" - year, month, day: returned date\n"
-" - hour, mins, secs: returned time\n\n"
-"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
-
-static PyObject * pyswe_jdut1_to_utc FUNCARGS_KEYWDS
+static PyObject * pyswe_calc_ut FUNCARGS_KEYWDS
 {
-    int y, m, d, h, mi, flg = SE_GREG_CAL;
-    double s, ut;
-    static char *kwlist[] = {"tjdut", "cal", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &ut, &flg))
+    double jd;
+    int pl, flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    PyObject *out = Py_None;
+    static char *kwlist[] = {"tjdut", "planet", "flags", "out", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|iO", kwlist,
+                                     &jd, &pl, &flag, &out))
         return NULL;
-    if (flg != SE_GREG_CAL && flg != SE_JUL_CAL)
-        return PyErr_Format(PyExc_ValueError,
-                           "swisseph.jdut1_to_utc: invalid calendar (%d)", flg);
-    swe_jdut1_to_utc(ut, flg, &y, &m, &d, &h, &mi, &s);
-    return Py_BuildValue("iiiiid", y, m, d, h, mi, s);
+    return pyswe_calc_ut_impl(self, jd, pl, flag, out);
 }
 
-/* swisseph.julday */
-PyDoc_STRVAR(pyswe_julday__doc__,
-"Calculate a Julian day number.\n\n"
-":Args: int year, int month, int day, float hour=12.0, int cal=GREG_CAL\n\n"
-" - year, month, day: the date\n"
-" - hour: the time of day, decimal with fraction\n"
-" - cal: either GREG_CAL (gregorian) or JUL_CAL (julian)\n\n"
-":Return: float jd\n\n"
-"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+#if PYSWE_FASTCALL
+static PyObject * pyswe_calc_ut_fast FUNCARGS_FAST
+{
+    PyObject *a[4];
+    double jd;
+    int pl, flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    static char *kwlist[] = {"tjdut", "planet", "flags", "out", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 2, a)
+        || pyswe_fast_d(a[0], &jd) || pyswe_fast_i(a[1], &pl)
+        || (a[2] && pyswe_fast_i(a[2], &flag)))
+        return pyswe_fast_fallback(pyswe_calc_ut, self, args, nargs, kwnames);
+    return pyswe_calc_ut_impl(self, jd, pl, flag, a[3] ? a[3] : Py_None);
+}
+#endif
 
-static PyObject * pyswe_julday FUNCARGS_KEYWDS
+/* swisseph.calc_ut_array */
+PyDoc_STRVAR(pyswe_calc_ut_array__doc__,
+"Calculate planetary positions for many dates (UT).\n\n"
+":Args: seq tjdut, int planet, int flags=FLG_SWIEPH|FLG_SPEED,"
+" str errors='raise', list errlist=None\n\n"
+" - tjdut: julian day numbers, universal time, as a sequence or a buffer of"
+" float64\n"
+" - planet: body number\n"
+" - flags: bit flags indicating what kind of computation is wanted\n"
+" - errors: policy for the dates in error:\n"
+"    - 'raise': raise swisseph.Error, for the first date in error\n"
+"    - 'mask': keep the results of libswe, with a retflag of -1 (ERR)\n"
+"    - 'nan': same as 'mask', with positions set to NaN\n"
+" - errlist: list where (index, message) of the dates in error are"
+" appended, if errors is not 'raise'\n\n"
+":Return: xx, retflags\n\n"
+" - xx: memoryview of float64 of shape (n, 6), the positions\n"
+" - retflags: memoryview of int32 of shape (n,), the returned flags\n\n"
+"Dates are computed in parallel by the thread pool (see set_num_threads), and"
+" results are in the order of the dates. The views can be given to"
+" numpy.asarray, or converted with tolist().");
+
+typedef struct {
+    const double* jd;
+    int pl;
+    int flag;
+    double* xx;
+    int* ret;
+} pyswe_CalcArray;
+
+static void pyswe_calc_ut_array_run(pyswe_Job* job, Py_ssize_t start,
+                                    Py_ssize_t end)
 {
-    int year, month, day;
-    double hour = 12.0;
-    int cal = SE_GREG_CAL;
-    static char *kwlist[] = {"year", "month", "day", "hour", "cal", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iii|di", kwlist,
-                                     &year, &month, &day, &hour, &cal))
+    pyswe_CalcArray* a = (pyswe_CalcArray*) job->data;
+    char err[256];
+    Py_ssize_t i;
+    for (i = start; i < end; ++i) {
+        err[0] = '\0';
+        a->ret[i] = swe_calc_ut(a->jd[i], a->pl, a->flag, a->xx + i * 6, err);
+        if (a->ret[i] < 0)
+            pyswe_job_error(job, i, err);
+    }
+}
+
+static PyObject * pyswe_calc_ut_array FUNCARGS_KEYWDS
+{
+    pyswe_CalcArray a;
+    pyswe_DArray jd;
+    pyswe_Job job;
+    PyObject *seq, *xx = NULL, *ret = NULL, *errlist = NULL;
+    char* errors = "raise";
+    static char *kwlist[] = {"tjdut", "planet", "flags", "errors", "errlist",
+                             NULL};
+    a.flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oi|isO", kwlist,
+                                     &seq, &a.pl, &a.flag, &errors, &errlist)
+        || pyswe_job_policy(&job, errors, errlist, "calc_ut_array"))
         return NULL;
-    if (cal != SE_GREG_CAL && cal != SE_JUL_CAL)
-        return PyErr_Format(PyExc_ValueError,
-                            "swisseph.julday: invalid calendar (%d)", cal);
-    return Py_BuildValue("d", swe_julday(year, month, day, hour, cal));
+    if (pyswe_darray_get(seq, &jd, "calc_ut_array", "tjdut"))
+        return NULL;
+    if (!(xx = pyswe_results_new(jd.n, 6, sizeof(double), (void**) &a.xx))
+        || !(ret = pyswe_results_new(jd.n, 1, sizeof(int), (void**) &a.ret))) {
+        pyswe_darray_release(&jd);
+        Py_XDECREF(xx);
+        return NULL;
+    }
+    a.jd = jd.d;
+    job.func = pyswe_calc_ut_array_run;
+    job.data = &a;
+    job.n = jd.n;
+    job.chunk = 32;
+    pyswe_pool_run(&job);
+    pyswe_darray_release(&jd);
+    if (pyswe_job_errors(&job, pyswe_error(self), "calc_ut_array", errlist)) {
+        Py_DECREF(xx);
+        Py_DECREF(ret);
+        return NULL;
+    }
+    if (job.errors == PYSWE_ERRORS_NAN)
+        pyswe_results_nan(a.xx, 6, a.ret, jd.n);
+    return Py_BuildValue("NN", pyswe_results_view(xx, "d", jd.n, 6),
+                         pyswe_results_view(ret, "i", jd.n, 0));
 }
 
-/* swisseph.lat_to_lmt */
-PyDoc_STRVAR(pyswe_lat_to_lmt__doc__,
-"Translate local apparent time (LAT) to local mean time (LMT).\n\n"
-":Args: float tjdlat, float geolon\n\n"
-" - tjdlat: Julian day number, local apparent time\n"
-" - geolon: geographic longitude, in degrees (eastern positive)\n\n"
-":Return: float tjdlmt\n\n"
-" - tjdlmt: returned Julian day number, local mean time\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.close */
+PyDoc_STRVAR(pyswe_close__doc__,
+"Close Swiss Ephemeris.\n\n"
+":Args: --\n"
+":Return: None\n\n"
+"At the end of your computations you can release all resources (open files and"
+" allocated memory) used by the swisseph module.\n\n"
+"After ``close()``, no swisseph functions should be used unless you call"
+" ``set_ephe_path()`` again and, if required, ``set_jpl_file()``.");
 
-static PyObject * pyswe_lat_to_lmt FUNCARGS_KEYWDS
+static PyObject * pyswe_close FUNCARGS_SELF
 {
-    int i;
-    double jd, lon, ret;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdlat", "geolon" , NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &jd, &lon))
-        return NULL;
-    i = swe_lat_to_lmt(jd, lon, &ret, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.lat_to_lmt: %s", err);
-    return Py_BuildValue("d", ret);
+    swe_close();
+#if PYSWE_USE_MMAP
+    pyswe_lock(&pyswe_mapped_lock);
+    pyswe_ephe_unmap();
+    pyswe_unlock(&pyswe_mapped_lock);
+#endif
+    Py_RETURN_NONE;
 }
 
-/* swisseph.lmt_to_lat */
-PyDoc_STRVAR(pyswe_lmt_to_lat__doc__,
-"Translate local mean time (LMT) to local apparent time (LAT).\n\n"
-":Args: float tjdlmt, float geolon\n\n"
-" - tjdlmt: Julian day number, local mean time\n"
-" - geolon: geographic longitude, in degrees (eastern positive)\n\n"
-":Return: float tjdlat\n\n"
-" - tjdlat: returned Julian day number, local apparent time\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.cotrans */
+PyDoc_STRVAR(pyswe_cotrans__doc__,
+"Coordinate transformation from ecliptic to equator or vice-versa.\n\n"
+":Args: seq coord, float eps\n\n"
+" - coord: tuple of 3 float for coordinates:\n"
+"    - 0: longitude\n"
+"    - 1: latitude\n"
+"    - 2: distance (unchanged, can be set to 1)\n"
+" - eps: obliquity of ecliptic, in degrees\n\n"
+":Return: float retlon, retlat, retdist\n\n"
+" - retlon: converted longitude\n"
+" - retlat: converted latitude\n"
+" - retdist: converted distance\n\n"
+"For equatorial to ecliptical, obliquity must be positive. From ecliptical to"
+" equatorial, obliquity must be negative. Longitude, latitude and obliquity"
+" are in positive degrees.");
 
-static PyObject * pyswe_lmt_to_lat FUNCARGS_KEYWDS
+static PyObject * pyswe_cotrans FUNCARGS_KEYWDS
 {
+    double xpo[3], xpn[3], eps;
+    PyObject *o;
     int i;
-    double jd, lon, ret;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdlmt", "geolon" , NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &jd, &lon))
+    char err[128] = {0};
+    static char *kwlist[] = {"coord", "eps", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Od", kwlist, &o, &eps))
         return NULL;
-    i = swe_lmt_to_lat(jd, lon, &ret, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.lmt_to_lat: %s", err);
-    return Py_BuildValue("d", ret);
+    /* extract coord */
+    i = py_seq2d(o, 3, xpo, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                           "swisseph.cotrans: coord: %s", err);
+    swe_cotrans(xpo, xpn, eps);
+    return Py_BuildValue("ddd", xpn[0], xpn[1], xpn[2]);
 }
 
-/* swisseph.lun_eclipse_how */
-PyDoc_STRVAR(pyswe_lun_eclipse_how__doc__,
-"Calculate attributes of a lunar eclipse (UTC).\n\n"
-":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - geopos: a sequence with:\n"
-"    - geographic longitude, in degrees (eastern positive)\n"
-"    - geographic latitude, in degrees (northern positive)\n"
-"    - geographic altitude above sea level, in meters\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: int retflag, (attr)\n\n"
-" - retflag: returned bit flags:\n"
-"    - 0 if there is no eclipse\n"
-"    - SE_ECL_TOTAL or ECL_PENUMBRAL or ECL_PARTIAL\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: umbral magnitude at tjd\n"
-"    - 1: penumbral magnitude\n"
-"    - 2: ?\n"
-"    - 3: ?\n"
-"    - 4: azimuth of moon at tjd\n"
-"    - 5: true altitude of moon above horizon at tjd\n"
-"    - 6: apparent altitude of moon above horizon at tjd\n"
-"    - 7: distance of moon from opposition in degrees\n"
-"    - 8: eclipse magnitude (equals attr[0])\n"
-"    - 9: saros series number (if available, otherwise -99999999)\n"
-"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.cotrans_sp */
+PyDoc_STRVAR(pyswe_cotrans_sp__doc__,
+"Coordinate transformation of position and speed, from ecliptic to equator"
+" or vice-versa.\n\n"
+":Args: seq coord, float eps\n\n"
+" - coord: tuple of 6 float for coordinates:\n"
+"    - 0: longitude\n"
+"    - 1: latitude\n"
+"    - 2: distance\n"
+"    - 3: longitude speed\n"
+"    - 4: latitude speed\n"
+"    - 5: distance speed\n"
+" - eps: obliquity of ecliptic, in degrees\n\n"
+":Return: float retlon, retlat, retdist, retlonsp, retlatsp, retdistsp\n\n"
+" - retlon, retlonsp: converted longitude and its speed\n"
+" - retlat, retlatsp: converted latitude and its speed\n"
+" - retdist, retdistsp: converted distance and its speed\n\n"
+"For equatorial to ecliptical, obliquity must be positive. From ecliptical to"
+" equatorial, obliquity must be negative. Longitude, latitude, their speeds"
+" and obliquity are in positive degrees.");
 
-static PyObject * pyswe_lun_eclipse_how FUNCARGS_KEYWDS
+static PyObject * pyswe_cotrans_sp FUNCARGS_KEYWDS
 {
-    double jd, geopos[3];
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    int i, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    PyObject *gp;
-    static char *kwlist[] = {"tjdut", "geopos", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|i", kwlist,
-                                     &jd, &gp, &flag))
+    double xpo[6], xpn[6], eps;
+    int i;
+    PyObject *o;
+    char err[128] = {0};
+    static char *kwlist[] = {"coord", "eps", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Od", kwlist, &o, &eps))
         return NULL;
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
+    /* extract coord */
+    i = py_seq2d(o, 6, xpo, err);
     if (i > 0)
         return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                "swisseph.lun_eclipse_how: geopos: %s", err);
-    /* setting topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_lun_eclipse_how(jd, flag, geopos, attr, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.lun_eclipse_how: %s", err);
-    return Py_BuildValue("i(dddddddddddddddddddd)", i,attr[0],attr[1],attr[2],
-        attr[3],attr[4],attr[5],attr[6],attr[7],attr[8],attr[9],attr[10],
-        attr[11],attr[12],attr[13],attr[14],attr[15],attr[16],attr[17],
-        attr[18],attr[19]);
+                                        "swisseph.cotrans_sp: coord: %s", err);
+    swe_cotrans_sp(xpo, xpn, eps);
+    return Py_BuildValue("dddddd", xpn[0],xpn[1],xpn[2],xpn[3],xpn[4],xpn[5]);
 }
 
-/* swisseph.lun_eclipse_when */
-PyDoc_STRVAR(pyswe_lun_eclipse_when__doc__,
-"Find the next lunar eclipse globally (UT).\n\n"
-":Args: float tjdut, int flags=FLG_SWIEPH, int ecltype=0, bool backwards=False\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flags: ephemeris flag\n"
-" - ecltype: bit flags for eclipse type wanted:\n"
-"    - ECL_TOTAL ECL_PARTIAL ECL_PENUMBRAL\n"
-"    - ECL_ALLTYPES_LUNAR or 0 for any type\n"
-" - backwards: boolean, set to True to search back in time\n\n"
-":Return: int retflag, (tret)\n\n"
-" - retflag: returned bit flag:\n"
-"    - ECL_TOTAL ECL_PARTIAL ECL_PENUMBRAL\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: time of maximum eclipse\n"
-"    - 1: ?\n"
-"    - 2: time of partial phase begin (indices consistent with solar eclipses)\n"
-"    - 3: time of partial phase end\n"
-"    - 4: time of totality begin\n"
-"    - 5: time of totality end\n"
-"    - 6: time of penumbral phase begin\n"
-"    - 7: time of penumbral phase end\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.cs2degstr */
+PyDoc_STRVAR(pyswe_cs2degstr__doc__,
+"Get degrees string from centiseconds.\n\n"
+":Args: int cs\n"
+":Return: str retstr");
 
-static PyObject * pyswe_lun_eclipse_when FUNCARGS_KEYWDS
+static PyObject * pyswe_cs2degstr FUNCARGS_KEYWDS
 {
-    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    int i, ecltype = 0, backw = 0, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "flags", "ecltype", "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|iii", kwlist,
-                                     &jd, &flag, &ecltype, &backw))
+    int cs;
+    char ret[9];
+    static char *kwlist[] = {"cs", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &cs))
         return NULL;
-    i = swe_lun_eclipse_when(jd, flag, ecltype, tret, backw, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.lun_eclipse_when: %s", err);
-    return Py_BuildValue("i(dddddddddd)", i,tret[0],tret[1],tret[2],tret[3],
-                         tret[4],tret[5],tret[6],tret[7],tret[8],tret[9]);
+    swe_cs2degstr(cs, ret);
+    return Py_BuildValue("s", ret);
 }
 
-/* swisseph.lun_eclipse_when_loc */
-PyDoc_STRVAR(pyswe_lun_eclipse_when_loc__doc__,
-"Find the next lunar eclipse observable from a given geographic position (UT).\n\n"
-":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH, bool backwards=False\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - geopos: a sequence with:\n"
-"    - geographic longitude, in degrees (eastern positive)\n"
-"    - geographic latitude, in degrees (northern positive)\n"
-"    - geographic altitude, in meters above sea level\n"
-" - flags: ephemeris flag, etc\n"
-" - backwards: boolean, set to True to search back in time\n\n"
-":Return: int retflag, (tret), (attr)\n\n"
-" - retflag: returned bit flags:\n"
-"    - ECL_TOTAL or ECL_PENUMBRAL or ECL_PARTIAL\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: time of maximum eclipse\n"
-"    - 1: ?\n"
-"    - 2: time of partial phase begin (indices consistent with solar eclipses)\n"
-"    - 3: time of partial phase end\n"
-"    - 4: time of totality begin\n"
-"    - 5: time of totality end\n"
-"    - 6: time of penumbral phase begin (eclipse begin)\n"
-"    - 7: time of penumbral phase end (eclipse end)\n"
-"    - 8: time of moonrise, if it occurs during the eclipse\n"
-"    - 9: time of moonset, if it occurs during the eclipse\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: umbral magnitude at tjd\n"
-"    - 1: penumbral magnitude\n"
-"    - 2: ?\n"
-"    - 3: ?\n"
-"    - 4: azimuth of moon at tjd\n"
-"    - 5: true altitude of moon above horizon at tjd\n"
-"    - 6: apparent altitude of moon above horizon at tjd\n"
-"    - 7: distance of moon from opposition in degrees (separation angle)\n"
-"    - 8: umbral magnitude at tjd (equals attr[0])\n"
-"    - 9: saros series number (if available; otherwise -99999999)\n"
-"    - 10: saros series member number (if available; otherwise -99999999)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.cs2lonlatstr */
+PyDoc_STRVAR(pyswe_cs2lonlatstr__doc__,
+"Get longitude or latitude string from centiseconds.\n\n"
+":Args: int cs, bytes plus, bytes minus\n"
+":Return: str retstr\n\n"
+"This function raises TypeError if plus or minus parameter length is not"
+" exactly 1 byte.");
 
-static PyObject * pyswe_lun_eclipse_when_loc FUNCARGS_KEYWDS
+static PyObject * pyswe_cs2lonlatstr FUNCARGS_KEYWDS
 {
-    double jd, geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    int i, backw = 0, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    PyObject *gp;
-    static char *kwlist[] = {"tjdut", "geopos", "flags", "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|ii", kwlist,
-                                     &jd, &gp, &flag, &backw))
+    int cs;
+    char ret[10], plus, minus;
+    static char *kwlist[] = {"cs", "plus", "minus", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "icc", kwlist,
+                                     &cs, &plus, &minus))
         return NULL;
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                            "swisseph.lun_eclipse_when_loc: geopos: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_lun_eclipse_when_loc(jd, flag, geopos, tret, attr, backw, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.lun_eclipse_when_loc: %s", err);
-    return Py_BuildValue("i(dddddddddd)(dddddddddddddddddddd)", i,tret[0],
-        tret[1],tret[2],tret[3],tret[4],tret[5],tret[6],tret[7],tret[8],tret[9],
-        attr[0],attr[1],attr[2],attr[3],attr[4],attr[5],attr[6],attr[7],
-        attr[8],attr[9],attr[10],attr[10],attr[10],attr[10],attr[10],attr[10],
-        attr[10],attr[10],attr[10],attr[10]);
+    swe_cs2lonlatstr(cs, plus, minus, ret);
+    return Py_BuildValue("s", ret);
 }
 
-/* swisseph.lun_occult_when_glob */
-PyDoc_STRVAR(pyswe_lun_occult_when_glob__doc__,
-"Find the next occultation of a planet or star by the moon globally (UT).\n\n"
-":Args: float tjdut, int or str body, int flags=FLG_SWIEPH, int ecltype=0,"
-" bool backwards=False\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - body: planet identifier (int) or star name (str)\n"
-" - flags: ephemeris flag, eventually ECL_ONE_TRY, etc\n"
-" - ecltype: bit flags for eclipse type wanted:\n"
-"    - ECL_CENTRAL ECL_NONCENTRAL ECL_TOTAL ECL_ANNULAR ECL_PARTIAL\n"
-"    - ECL_ANNULAR_TOTAL (equals ECL_HYBRID)\n"
-"    - 0 for any type\n"
-" - backwards: boolean, set to True to search back in time\n\n"
-":Return: int retflags, (tret)\n\n"
-" - retflags: returned bit flags:\n"
-"    - 0 if no occultation or eclipse found\n"
-"    - ECL_TOTAL or ECL_ANNULAR or ECL_PARTIAL or ECL_ANNULAR_TOTAL"
-"    - ECL_CENTRAL\n"
-"    - ECL_NONCENTRAL\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: time of maximum occultation/eclipse\n"
-"    - 1: time when occultation takes place at local apparent noon\n"
-"    - 2: time of occultation begin\n"
-"    - 3: time of occultation end\n"
-"    - 4: time of of totality begin\n"
-"    - 5: time of totality end\n"
-"    - 6: time of center line begin\n"
-"    - 7: time of center line end\n"
-"    - 8: time when annular-total occultation becomes total\n"
-"    - 9: time when annular-total occultation becomes annular again\n\n"
-"This function raises swisseph.Error in case of fatal error.\n\n"
-"If you want to have only one conjunction of the moon with the body tested,"
-" add the following flag: ECL_ONE_TRY. If this flag is not set, the function"
-" will search for an occultation until it finds one. For bodies with"
-" ecliptical latitudes > 5, the function may search successlessly until it"
-" reaches the end of the ephemeris.");
+/* swisseph.cs2timestr */
+PyDoc_STRVAR(pyswe_cs2timestr__doc__,
+"Get time string from centiseconds.\n\n"
+":Args: int cs, bytes sep, bool suppresszero=False\n"
+":Return: str retstr\n\n"
+"This function raises TypeError if sep parameter length is not exactly 1"
+" byte.");
 
-static PyObject * pyswe_lun_occult_when_glob FUNCARGS_KEYWDS
+static PyObject * pyswe_cs2timestr FUNCARGS_KEYWDS
 {
-    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    int i, pl, ecltype = 0, backw = 0, flag = SEFLG_SWIEPH;
-    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
-    PyObject *body;
-    static char *kwlist[] = {"tjdut", "body", "flags", "ecltype",
-                             "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|iii", kwlist,
-                                     &jd, &body, &flag, &ecltype, &backw))
+    int cs, sep, suppresszero = 0;
+    char ret[9];
+    static char *kwlist[] = {"cs", "sep", "suppresszero", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ic|i", kwlist,
+                                     &cs, &sep, &suppresszero))
         return NULL;
-    /* extract pl/star */
-    i = py_obj2plstar(body, &pl, &star);
-    if (i > 0) {
-        PyErr_SetString(PyExc_TypeError,
-                        "swisseph.lun_occult_when_glob: invalid body type");
+    swe_cs2timestr(cs, sep, suppresszero, ret);
+    return Py_BuildValue("s", ret);
+}
+
+/* swisseph.csnorm */
+PyDoc_STRVAR(pyswe_csnorm__doc__,
+"Normalization of any centisecond number to the range [0;360].\n\n"
+":Args: int cs\n"
+":Return: int retcs");
+
+static PyObject * pyswe_csnorm FUNCARGS_KEYWDS
+{
+    int cs;
+    static char *kwlist[] = {"cs", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &cs))
         return NULL;
-    }
-    if (star) {
-        memset(st, 0, (SE_MAX_STNAME*2)+1);
-        strncpy(st, star, SE_MAX_STNAME*2);
-    }
-    i = swe_lun_occult_when_glob(jd, pl, st, flag, ecltype, tret, backw, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.lun_occult_when_glob: %s", err);
-    return Py_BuildValue("i(dddddddddd)", i,tret[0],tret[1],tret[2],tret[3],
-                         tret[4],tret[5],tret[6],tret[7],tret[8],tret[9]);
+    return Py_BuildValue("i", swe_csnorm(cs));
 }
 
-/* swisseph.lun_occult_when_loc */
-PyDoc_STRVAR(pyswe_lun_occult_when_loc__doc__,
-"Find next occultation of a planet or star by the moon for a given geographic"
-" position (UT).\n\n"
-":Args: float tjdut, int or str body, seq geopos, int flags=FLG_SWIEPH,"
-" bool backwards=False\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - body: planet identifier (int) or star name (str)\n"
-" - geopos: a sequence with:\n"
-"    - geographic longitude, in degrees (eastern positive)\n"
-"    - geographic latitude, in degrees (northern positive)\n"
-"    - geographic altitude above sea level, in meters\n"
-" - flags: ephemeris flag, eventually ECL_ONE_TRY, etc\n"
-" - backwards: boolean, set to True for search back in time\n\n"
-":Return: int retflags, (tret), (attr)\n\n"
-" - retflags: returned bit flags:\n"
-"    - 0 if no occultation or eclipse found\n"
-"    - ECL_TOTAL or ECL_ANNULAR or ECL_PARTIAL,\n"
-"    - ECL_VISIBLE, ECL_MAX_VISIBLE, ECL_1ST_VISIBLE, ECL_2ND_VISIBLE,\n"
-"      ECL_3RD_VISIBLE, ECL_4TH_VISIBLE\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: time of maximum occultation\n"
-"    - 1: time of first contact\n"
-"    - 2: time of second contact\n"
-"    - 3: time of third contact\n"
-"    - 4: time of fourth contact\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: fraction of planet diameter covered by moon (magnitude)\n"
-"    - 1: ratio of lunar diameter to planet one\n"
-"    - 2: fraction of planet disc covered by moon (obscuration)\n"
-"    - 3: diameter of core shadow in km\n"
-"    - 4: azimuth of planet at tjd\n"
-"    - 5: true altitude of planet above horizon at tjd\n"
-"    - 6: apparent altitude of planet above horizon at tjd\n"
-"    - 7: elongation of moon in degrees (separation angle)\n\n"
-"This function raises swisseph.Error in case of fatal error.\n\n"
-"If you want to have only one conjunction of the moon with the body tested,"
-" add the following flag: ECL_ONE_TRY. If this flag is not set, the function"
-" will search for an occultation until it finds one. For bodies with"
-" ecliptical latitudes > 5, the function may search successlessly until it"
-" reaches the end of the ephemeris.");
+/* swisseph.csroundsec */
+PyDoc_STRVAR(pyswe_csroundsec__doc__,
+"Round centiseconds, but at 29.5959 always down.\n\n"
+":Args: int cs\n"
+":Return: int retcs");
 
-static PyObject * pyswe_lun_occult_when_loc FUNCARGS_KEYWDS
+static PyObject * pyswe_csroundsec FUNCARGS_KEYWDS
 {
-    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    double geopos[3];
-    int i, pl, backw = 0, flag = SEFLG_SWIEPH;
-    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
-    PyObject *body, *gp;
-    static char *kwlist[] = {"tjdut", "body", "geopos", "flags",
-                             "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOO|ii", kwlist,
-                                     &jd, &body, &gp, &flag, &backw))
+    int cs;
+    static char *kwlist[] = {"cs", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &cs))
         return NULL;
-    /* extract pl/star */
-    i = py_obj2plstar(body, &pl, &star);
-    if (i > 0) {
-        PyErr_SetString(PyExc_TypeError,
-            "swisseph.lun_occult_when_loc: invalid body type");
-        return NULL;
-    }
-    if (star) {
-        memset(st, 0, (SE_MAX_STNAME*2)+1);
-        strncpy(st, star, SE_MAX_STNAME*2);
-    }
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                            "swisseph.lun_occult_when_loc: geopos: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_lun_occult_when_loc(jd, pl, st, flag, geopos, tret,
-                                attr, backw, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.lun_occult_when_loc: %s", err);
-    /* fixes seen in perl extension */
-    if (attr[0] > 1) attr[0] = 1;
-    if (attr[2] > 1) attr[2] = 1;
-    return Py_BuildValue("i(dddddddddd)(dddddddddddddddddddd)", i,tret[0],
-        tret[1],tret[2],tret[3],tret[4],tret[5],tret[6],tret[7],tret[8],tret[9],
-        attr[0],attr[1],attr[2],attr[3],attr[4],attr[5],attr[6],attr[7],attr[8],
-        attr[9],attr[10],attr[11],attr[12],attr[13],attr[14],attr[15],attr[16],
-        attr[17],attr[18],attr[19]);
+    return Py_BuildValue("i", swe_csroundsec(cs));
 }
 
-/* swisseph.lun_occult_where */
-PyDoc_STRVAR(pyswe_lun_occult_where__doc__,
-"Find where a lunar occultation is central or maximal (UT).\n\n"
-":Args: float tjdut, int or str body, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - body: planet identifier (int) or star name (str)\n"
-" - flags: ephemeris flag\n\n"
-":Return: int retflags, (geopos), (attr)\n\n"
-" - retflags: returned bit flags:\n"
-"    - 0 if there is no occultation at tjd\n"
-"    - ECL_TOTAL\n"
-"    - ECL_ANNULAR\n"
-"    - ECL_TOTAL | ECL_CENTRAL\n"
-"    - ECL_TOTAL | ECL_NONCENTRAL\n"
-"    - ECL_ANNULAR | ECL_CENTRAL\n"
-"    - ECL_ANNULAR | ECL_NONCENTRAL\n"
-"    - ECL_PARTIAL\n"
-" - geopos: tuple of 10 float, of which:\n"
-"    - 0: geographic longitude of central line\n"
-"    - 1: geographic latitude of central line\n"
-"    - 2: geographic longitude of northern limit of umbra\n"
-"    - 3: geographic latitude of northern limit of umbra\n"
-"    - 4: geographic longitude of southern limit of umbra\n"
-"    - 5: geographic latitude of southern limit of umbra\n"
-"    - 6: geographic longitude of northern limit of penumbra\n"
-"    - 7: geographic latitude of northern limit of penumbra\n"
-"    - 8: geographic longitude of southern limit of penumbra\n"
-"    - 9: geographic latitude of southern limit of penumbra\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: fraction of object's diameter covered by moon (magnitude)\n"
-"    - 1: ratio of lunar diameter to object's diameter\n"
-"    - 2: fraction of object's disc covered by moon (obscuration)\n"
-"    - 3: diameter of core shadow in km\n"
-"    - 4: azimuth of object at tjd\n"
-"    - 5: true altitude of object above horizon at tjd\n"
-"    - 6: apparent altitude of object above horizon at tjd\n"
-"    - 7: angular distance of moon from object in degrees\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.d2l */
+PyDoc_STRVAR(pyswe_d2l__doc__,
+"Double to integer with rounding, no overflow check.\n\n"
+":Args: float d\n"
+":Return: int i");
 
-static PyObject * pyswe_lun_occult_where FUNCARGS_KEYWDS
+static PyObject * pyswe_d2l FUNCARGS_KEYWDS
 {
-    double jd, geopos[10] = {0,0,0,0,0,0,0,0,0,0};
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    int i, pl = 0, flag = SEFLG_SWIEPH;
-    char *star = NULL, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
-    PyObject *body;
-    static char *kwlist[] = {"tjdut", "body", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|i", kwlist,
-                                     &jd, &body, &flag))
-        return NULL;
-    /* extract pl/star */
-    i = py_obj2plstar(body, &pl, &star);
-    if (i > 0) {
-        PyErr_SetString(PyExc_TypeError,
-                        "swisseph.lun_occult_where: invalid body type");
+    double d;
+    static char *kwlist[] = {"d", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &d))
         return NULL;
-    }
-    if (star) {
-        memset(st, 0, (SE_MAX_STNAME*2)+1);
-        strncpy(st, star, SE_MAX_STNAME*2);
-    }
-    i = swe_lun_occult_where(jd, pl, st, flag, geopos, attr, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.lun_occult_where: %s", err);
-    return Py_BuildValue("i(dddddddddd)(dddddddddddddddddddd)", i,geopos[0],
-        geopos[1],geopos[2],geopos[3],geopos[4],geopos[5],geopos[6],geopos[7],
-        geopos[8],geopos[9],attr[0],attr[1],attr[2],attr[3],attr[4],attr[5],
-        attr[6],attr[7],attr[8],attr[9],attr[10],attr[11],attr[12],attr[13],
-        attr[14],attr[15],attr[16],attr[17],attr[18],attr[19]);
+    return Py_BuildValue("l", swe_d2l(d));
 }
 
-/* swisseph.mooncross */
-PyDoc_STRVAR(pyswe_mooncross__doc__,
-"Compute Moon crossing over some longitude (ET).\n\n"
-":Args: float x2cross, float tjdet, int flags=FLG_SWIEPH\n\n"
-" - x2cross: longitude to search\n"
-" - tjdet: start time of search, Julian day number, Ephemeris Time\n"
-" - flags: bit flags indicating what computation is wanted\n\n"
-":Return: float jd_cross\n\n"
-" - jd_cross: Julian day number found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.date_conversion */
+PyDoc_STRVAR(pyswe_date_conversion__doc__,
+"Calculate Julian day number with check wether input date is correct.\n\n"
+":Args: int year, int month, int day, float hour=12.0, bytes cal=b'g'\n\n"
+" - year, month, day: input date\n"
+" - hour: input time, decimal with fraction\n"
+" - cal: calendar type, gregorian (b'g') or julian (b'j')\n\n"
+":Return: bool isvalid, float jd, (dt)\n\n"
+" - isvalid: True if the input date and time are legal\n"
+" - jd: returned Julian day number\n"
+" - dt: a tuple for, if input was not valid, corrected year, month, day, hour;\n"
+"   if input was valid, contains input date and time\n\n"
+"This function raises TypeError if cal length is not exactly 1 byte.\n"
+"It raises ValueError if cal is not b'g' or b'j'.");
 
-static PyObject * pyswe_mooncross FUNCARGS_KEYWDS
+static PyObject * pyswe_date_conversion FUNCARGS_KEYWDS
 {
-    int flags = SEFLG_SWIEPH;
-    double x2, jd, res;
-    char err[256] = {0};
-    static char* kwlist[] = {"x2cross", "tjdet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
-                                     &x2, &jd, &flags))
+    int year, month, day, ret, y, m, d;
+    double jd, hour = 12.0, h;
+    char cal = 'g';
+    static char *kwlist[] = {"year", "month", "day", "hour", "cal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iii|dc", kwlist,
+                                     &year, &month, &day, &hour, &cal))
         return NULL;
-    if ((res = swe_mooncross(x2, jd, flags, err)) < jd)
-        return PyErr_Format(pyswe_Error, "mooncross: %s", err);
-    return Py_BuildValue("d", res);
+    if (cal != 'g' && cal != 'j')
+        return PyErr_Format(PyExc_ValueError, "swisseph.date_conversion:"
+                            " invalid calendar b'%c', must be b'g' or b'j'",
+                            cal);
+    ret = swe_date_conversion(year, month, day, hour, cal, &jd);
+    if (ret == 0) {
+        y = year;
+        m = month;
+        d = day;
+        h = hour;
+    }
+    else
+        swe_revjul(jd, cal == 'g' ? SE_GREG_CAL : SE_JUL_CAL, &y, &m, &d, &h);
+    return Py_BuildValue("Od(iiid)", ret == 0 ? Py_True : Py_False, jd,
+                         y, m, d, h);
 }
 
-/* swisseph.mooncross_node */
-PyDoc_STRVAR(pyswe_mooncross_node__doc__,
-"Compute next Moon crossing over node, by finding zero latitude crossing (ET).\n\n"
-":Args: float tjdet, int flags=FLG_SWIEPH\n\n"
-" - tjdet: start time of search, Julian day number, Ephemeris Time\n"
-" - flags: bit flags indicating what computation is wanted\n\n"
-":Return: float jd_cross, xlon, xlat\n\n"
-" - jd_cross: Julian day number found\n"
-" - xlon: Moon longitude found\n"
-" - xlat: Moon latitude found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.day_of_week */
+PyDoc_STRVAR(pyswe_day_of_week__doc__,
+"Calculate day of week number [0;6] from Julian day number (monday is 0).\n\n"
+":Args: float jd\n"
+":Return: int dow");
 
-static PyObject * pyswe_mooncross_node FUNCARGS_KEYWDS
+static PyObject * pyswe_day_of_week FUNCARGS_KEYWDS
 {
-    int flags = SEFLG_SWIEPH;
-    double jd, xlon, xlat, res;
-    char err[256] = {0};
-    static char* kwlist[] = {"tjdet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &flags))
+    double jd;
+    static char *kwlist[] = {"jd", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
         return NULL;
-    if ((res = swe_mooncross_node(jd, flags, &xlon, &xlat, err)) < jd)
-        return PyErr_Format(pyswe_Error, "mooncross_node: %s", err);
-    return Py_BuildValue("ddd", res, xlon, xlat);
+    return Py_BuildValue("i", swe_day_of_week(jd));
 }
 
-/* swisseph.mooncross_node_ut */
-PyDoc_STRVAR(pyswe_mooncross_node_ut__doc__,
-"Compute next Moon crossing over node, by finding zero latitude crossing (UT).\n\n"
-":Args: float tjdut, int flags=FLG_SWIEPH\n\n"
-" - tjdut: start time of search, Julian day number, Universal Time\n"
-" - flags: bit flags indicating what computation is wanted\n\n"
-":Return: float jd_cross, xlon, xlat\n\n"
-" - jd_cross: Julian day number found\n"
-" - xlon: Moon longitude found\n"
-" - xlat: Moon latitude found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.deg_midp */
+PyDoc_STRVAR(pyswe_deg_midp__doc__,
+"Calculate midpoint (in degrees).\n\n"
+":Args: float x1, float x2\n"
+":Return: float midp");
 
-static PyObject * pyswe_mooncross_node_ut FUNCARGS_KEYWDS
+static PyObject * pyswe_deg_midp FUNCARGS_KEYWDS
 {
-    int flags = SEFLG_SWIEPH;
-    double jd, xlon, xlat, res;
-    char err[256] = {0};
-    static char* kwlist[] = {"tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &flags))
+    double x1, x2;
+    static char *kwlist[] = {"x1", "x2", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &x1, &x2))
         return NULL;
-    if ((res = swe_mooncross_node(jd, flags, &xlon, &xlat, err)) < jd)
-        return PyErr_Format(pyswe_Error, "mooncross_node: %s", err);
-    return Py_BuildValue("ddd", res, xlon, xlat);
+    return Py_BuildValue("d", swe_deg_midp(x1, x2));
 }
 
-/* swisseph.mooncross_ut */
-PyDoc_STRVAR(pyswe_mooncross_ut__doc__,
-"Compute Moon crossing over some longitude (UT).\n\n"
-":Args: float x2cross, float tjdut, int flags=FLG_SWIEPH\n\n"
-" - x2cross: longitude to search\n"
-" - tjdut: start time of search, Julian day number, Universal Time\n"
-" - flags: bit flags indicating what computation is wanted\n\n"
-":Return: float jd_cross\n\n"
-" - jd_cross: Julian day number found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.degnorm */
+PyDoc_STRVAR(pyswe_degnorm__doc__,
+"Normalization of any degree number to the range [0;360[.\n\n"
+":Args: float x\n"
+":Return: float xnorm");
 
-static PyObject * pyswe_mooncross_ut FUNCARGS_KEYWDS
+static PyObject * pyswe_degnorm FUNCARGS_KEYWDS
 {
-    int flags = SEFLG_SWIEPH;
-    double x2, jd, res;
-    char err[256] = {0};
-    static char* kwlist[] = {"x2cross", "tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
-                                     &x2, &jd, &flags))
+    double x;
+    static char *kwlist[] = {"x", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &x))
         return NULL;
-    if ((res = swe_mooncross_ut(x2, jd, flags, err)) < jd)
-        return PyErr_Format(pyswe_Error, "mooncross_ut: %s", err);
-    return Py_BuildValue("d", res);
+    return Py_BuildValue("d", swe_degnorm(x));
 }
 
-/* swisseph.nod_aps */
-PyDoc_STRVAR(pyswe_nod_aps__doc__,
-"Calculate planetary nodes and apsides (ET).\n\n"
-":Args: float tjdet, int planet, int method=NODBIT_MEAN, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
-" - tjdet: input time, Julian day number, Ephemeris Time\n"
-" - planet: identifer of planet or object\n"
-" - method: bit flags NODBIT_MEAN, NODBIT_OSCU, NODBIT_OSCU_BAR, NODBIT_FOPOINT\n"
-" - flags: bit flags indicating what type of computation is wanted\n\n"
-":Return: (xnasc)(xndsc)(xperi)(xaphe)\n\n"
-" - xnasc: tuple of 6 float for ascending node\n"
-" - xndsc: tuple of 6 float for descending node\n"
-" - xperi: tuple of 6 float for perihelion\n"
-" - xaphe: tuple of 6 float for aphelion\n\n"
-"This function can raise swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_nod_aps FUNCARGS_KEYWDS
+#if PYSWE_FASTCALL
+static PyObject * pyswe_degnorm_fast FUNCARGS_FAST
 {
-    char err[256] = {0};
-    double jd, xasc[6], xdsc[6], xper[6], xaph[6];
-    int ret, planet, method = SE_NODBIT_MEAN, flags = SEFLG_SWIEPH|SEFLG_SPEED;
-    static char *kwlist[] = {"tjdet", "planet", "method", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|ii", kwlist,
-                                     &jd, &planet, &method, &flags))
-        return NULL;
-    ret = swe_nod_aps(jd, planet, flags, method, xasc, xdsc, xper, xaph, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.nod_aps: %s", err);
-    return Py_BuildValue("(dddddd)(dddddd)(dddddd)(dddddd)", xasc[0],xasc[1],
-        xasc[2],xasc[3],xasc[4],xasc[5],xdsc[0],xdsc[1],xdsc[2],xdsc[3],xdsc[4],
-        xdsc[5],xper[0],xper[1],xper[2],xper[3],xper[4],xper[5],xaph[0],xaph[1],
-        xaph[2],xaph[3],xaph[4],xaph[5]);
+    PyObject *a[1];
+    double x;
+    static char *kwlist[] = {"x", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 1, a)
+        || pyswe_fast_d(a[0], &x))
+        return pyswe_fast_fallback(pyswe_degnorm, self, args, nargs, kwnames);
+    return PyFloat_FromDouble(swe_degnorm(x));
 }
+#endif
 
-/* swisseph.nod_aps_ut */
-PyDoc_STRVAR(pyswe_nod_aps_ut__doc__,
-"Calculate planetary nodes and apsides (UT).\n\n"
-":Args: float tjdut, int planet, int method=NODBIT_MEAN, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - planet: identifer of planet or object\n"
-" - method: bit flags NODBIT_MEAN, NODBIT_OSCU, NODBIT_OSCU_BAR, NODBIT_FOPOINT\n"
-" - flags: bit flags indicating what type of computation is wanted\n\n"
-":Return: (xnasc)(xndsc)(xperi)(xaphe)\n\n"
-" - xnasc: tuple of 6 float for ascending node\n"
-" - xndsc: tuple of 6 float for descending node\n"
-" - xperi: tuple of 6 float for perihelion\n"
-" - xaphe: tuple of 6 float for aphelion\n\n"
-"This function can raise swisseph.Error in case of fatal error.");
+/* swisseph.deltat */
+PyDoc_STRVAR(pyswe_deltat__doc__,
+"Calculate value of delta T from Julian day number.\n\n"
+":Args: float tjdut\n\n"
+"- tjdut: input time, Julian day number, Universal Time\n\n"
+":Return: float deltat\n\n"
+" - deltat: returned delta T value\n\n"
+"Reminder::\n\n"
+"   tjdet == tjdut + deltat(tjdut)\n\n"
+"This function is safe only if your application consistently uses the same"
+" ephemeris flags, if your application consistently uses the same ephemeris"
+" files, if you first call ``set_ephe_path()`` (with flag ``FLG_SWIEPH``) or"
+" ``set_jpl_file()`` (with flag ``FLG_JPLEPH``).\n\n"
+"Also, it is safe if you first call ``set_tid_acc()`` with the tidal"
+" acceleration you want. However, do not use that function unless you know"
+" what you are doing.\n\n"
+"For best control of the values returned, use function ``deltat_ex()``"
+" instead.\n\n"
+"The calculation of ephemerides in UT depends on Delta T, which depends on the"
+" ephemeris-inherent value of the tidal acceleration of the Moon. In default"
+" mode, the function ``deltat()`` automatically tries to find the required"
+" values.\n\n"
+"Two warnings must be made, though:\n\n"
+" - It is not recommended to use a mix of old and new ephemeris files, because"
+" the old files were based on JPL Ephemeris DE406, whereas the new ones are"
+" based on DE431, and both ephemerides have a different inherent tidal"
+" acceleration of the Moon. A mixture of old and new ephemeris files may lead"
+" to inconsistent ephemeris output. Using old asteroid files ``se99999.se1``"
+" together with new ones, can be tolerated, though.\n"
+" - The function ``deltat()`` uses a default value of tidal acceleration"
+" (that of DE431). However, after calling some older ephemeris, like Moshier"
+" ephemeris, DE200, or DE406, ``deltat()`` might provide slightly different"
+" values.\n\n"
+"In case of troubles related to these two points, it is recommended to either"
+" use function ``deltat_ex()``, or control the value of the tidal acceleration"
+" using the functions ``set_tid_acc()`` and ``get_tid_acc()``.");
 
-static PyObject * pyswe_nod_aps_ut FUNCARGS_KEYWDS
+static PyObject * pyswe_deltat FUNCARGS_KEYWDS
 {
-    char err[256] = {0};
-    double jd, xasc[6], xdsc[6], xper[6], xaph[6];
-    int ret, planet, method = SE_NODBIT_MEAN, flags = SEFLG_SWIEPH|SEFLG_SPEED;
-    static char *kwlist[] = {"tjdut", "planet", "method", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|ii", kwlist,
-                                     &jd, &planet, &method, &flags))
+    double jd;
+    static char *kwlist[] = {"tjdut", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
         return NULL;
-    ret = swe_nod_aps_ut(jd, planet, flags, method, xasc, xdsc, xper, xaph, err);
-    if (ret < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.nod_aps_ut: %s", err);
-    return Py_BuildValue("(dddddd)(dddddd)(dddddd)(dddddd)", xasc[0],xasc[1],
-        xasc[2],xasc[3],xasc[4],xasc[5],xdsc[0],xdsc[1],xdsc[2],xdsc[3],xdsc[4],
-        xdsc[5],xper[0],xper[1],xper[2],xper[3],xper[4],xper[5],xaph[0],xaph[1],
-        xaph[2],xaph[3],xaph[4],xaph[5]);
+    return Py_BuildValue("d", swe_deltat(jd));
 }
 
-/* swisseph.orbit_max_min_true_distance */
-PyDoc_STRVAR(pyswe_orbit_max_min_true_distance__doc__,
-"Calculate the maximum possible distance, the minimum possible distance, and"
-" the current true distance of planet, the EMB, or an asteroid.\n\n"
-":Args: float tjdet, int planet, int flags\n\n"
-" - tjdet: input time, Julian day number, Ephemeris Time\n"
-" - planet: identifier of planet or object\n"
-" - flags: bit flags indicating what computation is wanted:\n"
-"    - ephemeris flag\n"
-"    - optional heliocentric flag FLG_HELIOCTR\n\n"
-":Return: float max_dist, float min_dist, float true_dist\n\n"
-" - max_dist: maximum distance\n"
-" - min_dist: minimum_distance\n"
-" - true_dist: true distance");
+/* swisseph.deltat_ex */
+PyDoc_STRVAR(pyswe_deltat_ex__doc__,
+"Calculate value of Delta T from Julian day number (extended).\n\n"
+":Args: float tjdut, int flag\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - flag: ephemeris flag, ``FLG_SWIEPH`` ``FLG_JPLEPH`` ``FLG_MOSEPH``\n\n"
+":Return: float deltat\n\n"
+" - deltat: returned delta T value\n\n"
+"Calling this function without a previous call of ``set_ephe_path()`` or "
+" ``set_jpl_file()`` will raise swisseph.Error.\n\n"
+"The calculation of ephemerides in UT depends on the ephemeris-inherent value"
+" of the tidal acceleration of the Moon. The function ``deltat_ex()`` can"
+" provide ephemeris-dependent values of Delta T and is therefore better than"
+" the old function ``deltat()``, which has to make un uncertain guess of what"
+" ephemeris is being used. One warning must be made, though:\n\n"
+"It is not recommended to use a mix of old and new ephemeris files, because the"
+" old files were based on JPL Ephemeris DE406, whereas the new ones are based"
+" on DE431, and both ephemerides have a different inherent tidal acceleration"
+" of the Moon. A mixture of old and new ephemeris files may lead to"
+" inconsistent ephemeris output. Using old asteroid files ``se99999.se1``"
+" together with new ones, can be tolerated, though.");
 
-static PyObject * pyswe_orbit_max_min_true_distance FUNCARGS_KEYWDS
+static PyObject * pyswe_deltat_ex FUNCARGS_KEYWDS
 {
-    int pl, flg, i;
-    double jd, dmax, dmin, dtrue;
+    double jd, ret;
+    int flag;
     char err[256] = {0};
-    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dii", kwlist,
-                                     &jd, &pl, &flg))
+    static char* kwlist[] = {"tjdut", "flag", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &flag))
         return NULL;
-    i = swe_orbit_max_min_true_distance(jd, pl, flg, &dmax, &dmin, &dtrue, err);
-    if (i == 0)
-        return Py_BuildValue("ddd", dmax, dmin, dtrue);
-    return PyErr_Format(pyswe_Error,
-                        "swisseph.orbit_max_min_true_distance: %s", err);
+    ret = swe_deltat_ex(jd, flag, err);
+    if (err[0] != 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.deltat_ex: %s", err);
+    return Py_BuildValue("d", ret);
 }
 
-/* swisseph.pheno */
-PyDoc_STRVAR(pyswe_pheno__doc__,
-"Calculate planetary phenomena (ET).\n\n"
-":Args: float tjdet, int planet, int flags=FLG_SWIEPH\n\n"
-" - tjdet: input time, Julian day number, Ephemeris Time\n"
-" - planet: object identifier\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: (attr)\n\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: phase angle (earth-planet-sun)\n"
-"    - 1: phase (illuminated fraction of disc)\n"
-"    - 2: elongation of planet\n"
-"    - 3: apparent diameter of disc\n"
-"    - 4: apparent magnitude\n"
-"    - 5: geocentric horizontal parallax (Moon)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.difcs2n */
+PyDoc_STRVAR(pyswe_difcs2n__doc__,
+"Calculate distance in centisecs p1 - p2 normalized to [-180;180].\n\n"
+":Args: int p1, int p2\n"
+":Return: int dist");
 
-static PyObject * pyswe_pheno FUNCARGS_KEYWDS
+static PyObject * pyswe_difcs2n FUNCARGS_KEYWDS
 {
-    double jd, attr[20];
-    int i, pl, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|i", kwlist,
-                                     &jd, &pl, &flag))
+    int p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ii", kwlist, &p1, &p2))
         return NULL;
-    i = swe_pheno(jd, pl, flag, attr, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.pheno: %s", err);
-    return Py_BuildValue("dddddddddddddddddddd", attr[0],attr[1],attr[2],
-        attr[3],attr[4],attr[5],attr[6],attr[7],attr[8],attr[9],attr[10],
-        attr[11],attr[12],attr[13],attr[14],attr[15],attr[16],attr[17],
-        attr[18],attr[19]);
+    return Py_BuildValue("i", swe_difcs2n(p1, p2));
 }
 
-/* swisseph.pheno_ut */
-PyDoc_STRVAR(pyswe_pheno_ut__doc__,
-"Calculate planetary phenomena (UT).\n\n"
-":Args: float tjdut, int planet, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - planet: object identifier\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: (attr)\n\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: phase angle (earth-planet-sun)\n"
-"    - 1: phase (illuminated fraction of disc)\n"
-"    - 2: elongation of planet\n"
-"    - 3: apparent diameter of disc\n"
-"    - 4: apparent magnitude\n"
-"    - 5: geocentric horizontal parallax (Moon)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.difcsn */
+PyDoc_STRVAR(pyswe_difcsn__doc__,
+"Calculate distance in centisecs p1 - p2.\n\n"
+":Args: int p1, int p2\n"
+":Return: int dist");
 
-static PyObject * pyswe_pheno_ut FUNCARGS_KEYWDS
+static PyObject * pyswe_difcsn FUNCARGS_KEYWDS
 {
-    double jd, attr[20];
-    int i, pl, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "planet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|i", kwlist,
-                                     &jd, &pl, &flag))
+    int p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ii", kwlist, &p1, &p2))
         return NULL;
-    i = swe_pheno_ut(jd, pl, flag, attr, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.pheno_ut: %s", err);
-    return Py_BuildValue("dddddddddddddddddddd", attr[0],attr[1],attr[2],
-        attr[3],attr[4],attr[5],attr[6],attr[7],attr[8],attr[9],attr[10],
-        attr[11],attr[12],attr[13],attr[14],attr[15],attr[16],attr[17],
-        attr[18],attr[19]);
+    return Py_BuildValue("i", swe_difcsn(p1, p2));
 }
 
-/* swisseph.rad_midp */
-PyDoc_STRVAR(pyswe_rad_midp__doc__,
-"Calculate midpoint (in radians).\n\n"
-"Args: float x, float y\n"
-"Return: float");
+/* swisseph.difdeg2n */
+PyDoc_STRVAR(pyswe_difdeg2n__doc__,
+"Calculate distance in degrees p1 - p2 normalized to [-180;180].\n\n"
+":Args: float p1, float p2\n"
+":Return: float dist");
 
-static PyObject * pyswe_rad_midp FUNCARGS_KEYWDS
+static PyObject * pyswe_difdeg2n FUNCARGS_KEYWDS
 {
-    double x, y;
-    static char *kwlist[] = {"x", "y", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &x, &y))
+    double p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &p1, &p2))
         return NULL;
-    return Py_BuildValue("d", swe_rad_midp(x, y));
+    return Py_BuildValue("d", swe_difdeg2n(p1, p2));
 }
 
-/* swisseph.radnorm */
-PyDoc_STRVAR(pyswe_radnorm__doc__,
-"Normalization of any radian number to the range [0;2*pi].\n\n"
-"Args: float x\n"
-"Return: float");
-
-static PyObject * pyswe_radnorm FUNCARGS_KEYWDS
+#if PYSWE_FASTCALL
+static PyObject * pyswe_difdeg2n_fast FUNCARGS_FAST
 {
-    double x;
-    static char *kwlist[] = {"x", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &x))
-        return NULL;
-    return Py_BuildValue("d", swe_radnorm(x));
+    PyObject *a[2];
+    double p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 2, a)
+        || pyswe_fast_d(a[0], &p1) || pyswe_fast_d(a[1], &p2))
+        return pyswe_fast_fallback(pyswe_difdeg2n, self, args, nargs, kwnames);
+    return PyFloat_FromDouble(swe_difdeg2n(p1, p2));
 }
+#endif
 
-/* swisseph.refrac */
-PyDoc_STRVAR(pyswe_refrac__doc__,
-"Calculate true altitude from apparent altitude, or vice-versa.\n\n"
-":Args: float alt, float atpress, float attemp, int flag\n\n"
-" - alt: altitude of object above geometric horizon in degrees,\n"
-"   where geometric horizon = plane perpendicular to gravity\n"
-" - atpress: atmospheric pressure in mbar (hPa)\n"
-" - attemp: atmospheric temperature in degrees Celsius\n"
-" - flag: either TRUE_TO_APP or APP_TO_TRUE\n\n"
-":Return: float retalt\n\n"
-" - retalt: converted altitude");
+/* swisseph.difdegn */
+PyDoc_STRVAR(pyswe_difdegn__doc__,
+"Calculate distance in degrees p1 - p2.\n\n"
+":Args: float p1, float p2\n"
+":Return: float dist");
 
-static PyObject * pyswe_refrac FUNCARGS_KEYWDS
+static PyObject * pyswe_difdegn FUNCARGS_KEYWDS
 {
-    double alt, press, temp;
-    int flag;
-    static char *kwlist[] = {"alt", "atpress", "attemp", "flag", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dddi", kwlist, &alt,
-                                     &press, &temp, &flag))
+    double p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &p1, &p2))
         return NULL;
-    return Py_BuildValue("d", swe_refrac(alt, press, temp, flag));
+    return Py_BuildValue("d", swe_difdegn(p1, p2));
 }
 
-/* swisseph.refrac_extended */
-PyDoc_STRVAR(pyswe_refrac_extended__doc__,
-"Calculate true altitude from apparent altitude, or vice-versa (extended).\n\n"
-":Args: float alt, float geoalt, float atpress, float attemp, float lapserate,"
-" int flag\n\n"
-" - alt: altitude of object above geometric horizon in degrees,\n"
-"   where geometric horizon = plane perpendicular to gravity\n"
-" - geoalt: altitude of observer above sea level, in meters\n"
-" - atpress: atmospheric pressure in mbar (hPa)\n"
-" - attemp: atmospheric temperature in degrees Celsius\n"
-" - lapserate: dattemp/dgeoalt [deg K/m]\n"
-" - flag: either TRUE_TO_APP or APP_TO_TRUE\n\n"
-":Return: float retalt, (dret)\n\n"
-" - retalt: converted altitude\n"
-" - dret: tuple of 4 float:\n"
-"    - 0: true altitude if possible, otherwise input value\n"
-"    - 1: apparent altitude if possible, otherwise input value\n"
-"    - 2: refraction\n"
-"    - 3: dip of the horizon");
+#if PYSWE_FASTCALL
+static PyObject * pyswe_difdegn_fast FUNCARGS_FAST
+{
+    PyObject *a[2];
+    double p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 2, a)
+        || pyswe_fast_d(a[0], &p1) || pyswe_fast_d(a[1], &p2))
+        return pyswe_fast_fallback(pyswe_difdegn, self, args, nargs, kwnames);
+    return PyFloat_FromDouble(swe_difdegn(p1, p2));
+}
+#endif
 
-static PyObject * pyswe_refrac_extended FUNCARGS_KEYWDS
+/* swisseph.difrad2n */
+PyDoc_STRVAR(pyswe_difrad2n__doc__,
+"Calculate distance in radians p1 - p2 normalized to [-180;180].\n\n"
+":Args: float p1, float p2\n"
+":Return: float dist");
+
+static PyObject * pyswe_difrad2n FUNCARGS_KEYWDS
 {
-    double alt, geoalt, lapserate, ret, dret[4], press, temp;
-    int flag;
-    static char *kwlist[] = {"alt", "geoalt", "atpress", "attemp", "lapserate",
-                             "flag", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dddddi", kwlist,
-                    &alt, &geoalt, &press, &temp, &lapserate, &flag))
+    double p1, p2;
+    static char *kwlist[] = {"p1", "p2", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &p1, &p2))
         return NULL;
-    ret = swe_refrac_extended(alt, geoalt, press, temp, lapserate, flag, dret);
-    return Py_BuildValue("d(dddd)", ret, dret[0], dret[1], dret[2], dret[3]);
+    return Py_BuildValue("d", swe_difrad2n(p1, p2));
 }
 
-/* swisseph.revjul */
-PyDoc_STRVAR(pyswe_revjul__doc__,
-"Calculate year, month, day, hour from Julian day number.\n\n"
-":Args: float jd, int cal=GREG_CAL\n\n"
-" - jd: Julian day number\n"
-" - cal: either GREG_CAL (gregorian) or JUL_CAL (julian)\n\n"
-":Return: int year, int month, int day, float hour\n\n"
-"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+/* Ephemeris tables
+ *
+ * A table holds positions of some bodies for a range of dates, in columns
+ * (one row per date and body, dates first), exported with the Arrow C Data
+ * Interface (https://arrow.apache.org/docs/format/CDataInterface.html) as
+ * PyCapsules, without copy. Columns are allocated with the raw allocator and
+ * reference counted without Python, as consumers may release the exported
+ * arrays without the GIL, from any thread.
+ */
 
-static PyObject * pyswe_revjul FUNCARGS_KEYWDS
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+#endif /* ARROW_C_DATA_INTERFACE */
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+    void (*release)(struct ArrowArrayStream*);
+    void* private_data;
+};
+#endif /* ARROW_C_STREAM_INTERFACE */
+
+enum { PYSWE_TC_JD, PYSWE_TC_BODY, PYSWE_TC_LON, PYSWE_TC_LAT, PYSWE_TC_DIST,
+       PYSWE_TC_LON_SPEED, PYSWE_TC_LAT_SPEED, PYSWE_TC_DIST_SPEED,
+       PYSWE_TC_RETFLAGS, PYSWE_TC_COUNT };
+
+/* Names and Arrow formats of the columns (int32 or float64) */
+static const struct {
+    const char* name;
+    const char* format;
+} pyswe_table_columns[PYSWE_TC_COUNT] = {
+    {"jd", "g"}, {"body", "i"}, {"lon", "g"}, {"lat", "g"}, {"dist", "g"},
+    {"lon_speed", "g"}, {"lat_speed", "g"}, {"dist_speed", "g"},
+    {"retflags", "i"}};
+
+#define pyswe_table_itemsize(c) \
+        (pyswe_table_columns[c].format[0] == 'i' ? sizeof(int32_t) \
+                                                 : sizeof(double))
+
+typedef struct {
+    Py_ssize_t refcnt; /* table and exported arrays */
+    Py_ssize_t nrows;
+    void* cols[PYSWE_TC_COUNT];
+} pyswe_TableData;
+
+static pyswe_lock_t pyswe_table_lock = PYSWE_LOCK_INIT;
+
+/* Allocate columns of nrows rows, with a reference
+ * Return NULL if out of memory.
+ */
+static pyswe_TableData * pyswe_table_data_new(Py_ssize_t nrows)
 {
-    int year, month, day, cal = SE_GREG_CAL;
-    double hour, jd;
-    static char *kwlist[] = {"jd", "cal", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &cal))
-        return NULL;
-    if (cal != SE_GREG_CAL && cal != SE_JUL_CAL)
-        return PyErr_Format(PyExc_ValueError,
-                            "swisseph.revjul: invalid calendar (%d)", cal);
-    swe_revjul(jd, cal, &year, &month, &day, &hour);
-    return Py_BuildValue("iiid", year, month, day, hour);
+    int i;
+    pyswe_TableData* d = PyMem_RawCalloc(1, sizeof(pyswe_TableData));
+    if (!d)
+        return NULL;
+    d->refcnt = 1;
+    d->nrows = nrows;
+    for (i = 0; i < PYSWE_TC_COUNT; ++i) {
+        d->cols[i] = PyMem_RawMalloc(pyswe_table_itemsize(i)
+                                     * (nrows ? nrows : 1));
+        if (!d->cols[i]) {
+            while (i--)
+                PyMem_RawFree(d->cols[i]);
+            PyMem_RawFree(d);
+            return NULL;
+        }
+    }
+    return d;
 }
 
-/* swisseph.rise_trans */
-PyDoc_STRVAR(pyswe_rise_trans__doc__,
-"Calculate times of rising, setting and meridian transits.\n\n"
-":Args: float tjdut, int or str body, int rsmi, seq geopos, float atpress=0.0,"
-" float attemp=0.0, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - body: planet identifier (int) or fixed star name (str)\n"
-" - rsmi: bit flag for rise, set, or one of the two meridian transits, etc\n"
-" - geopos: a sequence for:\n"
-"    - 0: geographic longitude, in degrees (eastern positive)\n"
-"    - 1: geographic latitude, in degrees (northern positive)\n"
-"    - 2: geographic altitude, in meters above sea level\n"
-" - atpress: atmospheric pressure in mbar/hPa\n"
-" - attemp: atmospheric temperature in degrees Celsius\n"
-" - flags: ephemeris flags etc\n\n"
-":Return: int res, (tret)\n\n"
-" - res: integer indicating:\n"
-"    - (0) event found\n"
-"    - (-2) event not found because the object is circumpolar\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: tjd of event\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+static void pyswe_table_data_incref(pyswe_TableData* d)
+{
+    pyswe_lock(&pyswe_table_lock);
+    ++d->refcnt;
+    pyswe_unlock(&pyswe_table_lock);
+}
 
-static PyObject * pyswe_rise_trans FUNCARGS_KEYWDS
+/* Release a reference, without the GIL possibly */
+static void pyswe_table_data_decref(pyswe_TableData* d)
 {
-    double jd, press = 0.0, temp = 0.0;
-    double geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    int i, res, pl, rsmi, flag = SEFLG_SWIEPH;
-    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
-    PyObject *body, *gp;
-    static char *kwlist[] = {"tjdut", "body", "rsmi", "geopos", "atpress",
-                             "attemp", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOiO|ddi", kwlist, &jd,
-                                     &body, &rsmi, &gp, &press, &temp, &flag))
-        return NULL;
-    /* extract pl/star */
-    i = py_obj2plstar(body, &pl, &star);
-    if (i > 0) {
-        PyErr_SetString(PyExc_TypeError,
-                        "swisseph.rise_trans: invalid body type");
-        return NULL;
+    int i;
+    Py_ssize_t n;
+    pyswe_lock(&pyswe_table_lock);
+    n = --d->refcnt;
+    pyswe_unlock(&pyswe_table_lock);
+    if (n)
+        return;
+    for (i = 0; i < PYSWE_TC_COUNT; ++i)
+        PyMem_RawFree(d->cols[i]);
+    PyMem_RawFree(d);
+}
+
+/* Computation of rows [row0 + start, row0 + end) of a table, in the columns
+ * at index [start, end)
+ */
+typedef struct {
+    double jd_start;
+    double step;
+    const int* bodies;
+    int nbodies;
+    int flag;
+    int ut; /* calc_ut, or calc */
+    int nan; /* NaN positions for rows in error */
+    Py_ssize_t row0;
+    void** cols;
+} pyswe_TableJob;
+
+static void pyswe_table_run(pyswe_Job* job, Py_ssize_t start, Py_ssize_t end)
+{
+    pyswe_TableJob* a = (pyswe_TableJob*) job->data;
+    double xx[6], jd;
+    char err[256];
+    int c, pl, ret;
+    Py_ssize_t i, row;
+    for (i = start; i < end; ++i) {
+        row = a->row0 + i;
+        jd = a->jd_start + (double) (row / a->nbodies) * a->step;
+        pl = a->bodies[row % a->nbodies];
+        err[0] = '\0';
+        ret = a->ut ? swe_calc_ut(jd, pl, a->flag, xx, err)
+            : swe_calc(jd, pl, a->flag, xx, err);
+        if (ret < 0 && a->nan)
+            xx[0] = xx[1] = xx[2] = xx[3] = xx[4] = xx[5] = Py_NAN;
+        ((double*) a->cols[PYSWE_TC_JD])[i] = jd;
+        ((int32_t*) a->cols[PYSWE_TC_BODY])[i] = pl;
+        for (c = 0; c < 6; ++c)
+            ((double*) a->cols[PYSWE_TC_LON + c])[i] = xx[c];
+        ((int32_t*) a->cols[PYSWE_TC_RETFLAGS])[i] = ret;
+        if (ret < 0)
+            pyswe_job_error(job, row, err);
     }
-    if (star) {
-        memset(st, 0, (SE_MAX_STNAME*2)+1);
-        strncpy(st, star, SE_MAX_STNAME*2);
+}
+
+/* Get the arguments of a table: bodies and number of dates
+ * Return -1 on error, with an exception set. *bodies is to be freed.
+ */
+static int pyswe_table_args(PyObject* seq, double start, double end,
+                            double step, const char* fn, int** bodies,
+                            int* nbodies, Py_ssize_t* ndates)
+{
+    double nd;
+    int i;
+    PyObject* o;
+    if (!(step > 0) || !(end >= start)) {
+        PyErr_Format(PyExc_ValueError, "swisseph.%s: invalid range of dates"
+                     " (step must be > 0, jd_end >= jd_start)", fn);
+        return -1;
     }
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.rise_trans: geopos: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    res = swe_rise_trans(jd, pl, st, flag, rsmi, geopos, press, temp, tret, err);
-    if (res == -1)
-        return PyErr_Format(pyswe_Error, "swisseph.rise_trans: %s", err);
-    return Py_BuildValue("i(dddddddddd)", res,tret[0],tret[1],tret[2],
-        tret[3],tret[4],tret[5],tret[6],tret[7],tret[8],tret[9]);
+    if (!(seq = PySequence_Fast(seq, ""))) {
+        PyErr_Format(PyExc_TypeError, "swisseph.%s: bodies: must be a"
+                     " sequence of int", fn);
+        return -1;
+    }
+    *nbodies = (int) PySequence_Fast_GET_SIZE(seq);
+    if (!*nbodies || *nbodies > 10000) {
+        Py_DECREF(seq);
+        PyErr_Format(PyExc_ValueError, "swisseph.%s: bodies: must have 1 to"
+                     " 10000 items", fn);
+        return -1;
+    }
+    if (!(*bodies = PyMem_Malloc(sizeof(int) * *nbodies))) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < *nbodies; ++i) {
+        o = PySequence_Fast_GET_ITEM(seq, i);
+        if (((*bodies)[i] = (int) PyLong_AsLong(o)) == -1 && PyErr_Occurred()) {
+            Py_DECREF(seq);
+            PyMem_Free(*bodies);
+            if (PyErr_ExceptionMatches(PyExc_TypeError)) {
+                PyErr_Clear();
+                PyErr_Format(PyExc_TypeError, "swisseph.%s: bodies: must be a"
+                             " sequence of int", fn);
+            }
+            return -1;
+        }
+    }
+    Py_DECREF(seq);
+    /* dates in [start, end), like range() */
+    nd = ceil((end - start) / step);
+    if (nd > 0 && start + (nd - 1) * step >= end)
+        nd -= 1;
+    if (nd * *nbodies > (double) (PY_SSIZE_T_MAX / 64)) {
+        PyMem_Free(*bodies);
+        PyErr_Format(PyExc_OverflowError, "swisseph.%s: too many rows", fn);
+        return -1;
+    }
+    *ndates = (Py_ssize_t) nd;
+    return 0;
 }
 
-/* swisseph.rise_trans_true_hor */
-PyDoc_STRVAR(pyswe_rise_trans_true_hor__doc__,
-"Calculate times of rising, setting and meridian transits (with altitude).\n\n"
-":Args: float tjdut, int or str body, int rsmi, seq geopos, float atpress=0.0,"
-" float attemp=0.0, float horhgt=0.0, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - body: planet identifier (int) or fixed star name (str)\n"
-" - rsmi: bit flag for rise, set, or one of the two meridian transits, etc\n"
-" - geopos: a sequence for:\n"
-"    - 0: geographic longitude (eastern positive)\n"
-"    - 1: geographic latitude (northern positive)\n"
-"    - 2: altitude above sea level, in meters\n"
-" - atpress: atmospheric pressure in mbar/hPa\n"
-" - attemp: atmospheric temperature in degrees Celsius\n"
-" - horhgt: height of local horizon in degrees (where body rises or sets)\n"
-" - flags: ephemeris flags etc\n\n"
-":Return: int res, (tret)\n\n"
-" - res: integer indicating:\n"
-"    - 0 event found\n"
-"    - -2 event not found because the object is circumpolar\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: tjd of event\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Arrow export */
 
-static PyObject * pyswe_rise_trans_true_hor FUNCARGS_KEYWDS
+static void pyswe_arrow_schema_release(struct ArrowSchema* s)
 {
-    double jd, press = 0.0, temp = 0.0, horhgt = 0.0;
-    double geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    int i, pl, rsmi, flag = SEFLG_SWIEPH;
-    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
-    PyObject *body, *gp;
-    static char *kwlist[] = {"tjdut", "body", "rsmi", "geopos", "atpress",
-                             "attemp", "horhgt", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOiO|dddi", kwlist, &jd,
-                            &body, &rsmi, &gp, &press, &temp, &horhgt, &flag))
-        return NULL;
-    /* extract pl/star */
-    i = py_obj2plstar(body, &pl, &star);
-    if (i > 0) {
-        PyErr_SetString(PyExc_TypeError,
-                        "swisseph.rise_trans_true_hor: invalid body type");
-        return NULL;
-    }
-    if (star) {
-        memset(st, 0, (SE_MAX_STNAME*2)+1);
-        strncpy(st, star, SE_MAX_STNAME*2);
+    int64_t i;
+    for (i = 0; i < s->n_children; ++i) {
+        if (s->children[i]->release)
+            s->children[i]->release(s->children[i]);
     }
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.rise_trans_true_hor: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_rise_trans_true_hor(jd, pl, st, flag, rsmi, geopos, press, temp,
-                                horhgt, tret, err);
-    if (i == -1)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.rise_trans_true_hor: %s", err);
-    return Py_BuildValue("i(dddddddddd)", i,tret[0],tret[1],tret[2],tret[3],
-                         tret[4],tret[5],tret[6],tret[7],tret[8],tret[9]);
+    PyMem_RawFree(s->private_data);
+    s->release = NULL;
 }
 
-/* swisseph.set_delta_t_userdef */
-PyDoc_STRVAR(pyswe_set_delta_t_userdef__doc__,
-"Set a fixed Deltat T value.\n\n"
-":Args: acc\n"
-":Return: None\n\n"
-"This function allows the user to set a fixed Delta T value that will be"
-" returned by ``deltat()`` or ``deltat_ex()``. The same Delta T value will"
-" then be used by ``calc_ut()``, eclipse functions, heliacal functions, and"
-" all functions that require UT as input time.\n\n"
-"In order to return to automatic Delta T, call this function with the"
-" following value: ``set_delta_t_userdef(DELTAT_AUTOMATIC)``.");
+static void pyswe_arrow_child_schema_release(struct ArrowSchema* s)
+{
+    s->release = NULL;
+}
 
-static PyObject * pyswe_set_delta_t_userdef FUNCARGS_KEYWDS
+/* Make the schema of a table (struct of columns)
+ * Return -1 if out of memory.
+ */
+static int pyswe_arrow_schema(struct ArrowSchema* out)
 {
-    double acc;
-    static char *kwlist[] = {"acc", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &acc))
-        return NULL;
-    swe_set_delta_t_userdef(acc);
-    Py_RETURN_NONE;
+    struct {
+        struct ArrowSchema* children[PYSWE_TC_COUNT];
+        struct ArrowSchema schemas[PYSWE_TC_COUNT];
+    } *p;
+    int i;
+    if (!(p = PyMem_RawCalloc(1, sizeof(*p))))
+        return -1;
+    for (i = 0; i < PYSWE_TC_COUNT; ++i) {
+        p->children[i] = &p->schemas[i];
+        p->schemas[i].format = pyswe_table_columns[i].format;
+        p->schemas[i].name = pyswe_table_columns[i].name;
+        p->schemas[i].release = pyswe_arrow_child_schema_release;
+    }
+    memset(out, 0, sizeof(struct ArrowSchema));
+    out->format = "+s";
+    out->name = "";
+    out->n_children = PYSWE_TC_COUNT;
+    out->children = p->children;
+    out->release = pyswe_arrow_schema_release;
+    out->private_data = p;
+    return 0;
 }
 
-/* swisseph.set_ephe_path */
-PyDoc_STRVAR(pyswe_set_ephe_path__doc__,
-"Set ephemeris files path.\n\n"
-":Args: str path=\"" PYSWE_DEFAULT_EPHE_PATH "\"\n"
-":Return: None\n\n"
-"It is possible to pass None as path, which is equivalent to an empty string.");
+typedef struct {
+    pyswe_TableData* data;
+    const void* buffers[2];
+} pyswe_ArrowColumn;
 
-static PyObject * pyswe_set_ephe_path FUNCARGS_KEYWDS
+typedef struct {
+    pyswe_TableData* data;
+    const void* buffers[1];
+    struct ArrowArray* children[PYSWE_TC_COUNT];
+    struct ArrowArray arrays[PYSWE_TC_COUNT];
+} pyswe_ArrowTable;
+
+/* Children have their own data, they can be moved by consumers */
+static void pyswe_arrow_child_release(struct ArrowArray* a)
 {
-    char *path = PYSWE_DEFAULT_EPHE_PATH;
-    static char *kwlist[] = {"path", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|z", kwlist, &path))
-        return NULL;
-    swe_set_ephe_path(path);
-    Py_RETURN_NONE;
+    pyswe_ArrowColumn* p = (pyswe_ArrowColumn*) a->private_data;
+    pyswe_table_data_decref(p->data);
+    PyMem_RawFree(p);
+    a->release = NULL;
 }
 
-/* swisseph.set_jpl_file */
-PyDoc_STRVAR(pyswe_set_jpl_file__doc__,
-"Set name of JPL ephemeris file.\n\n"
-":Args: str name\n"
-":Return: None\n\n"
-"If you work with the JPL ephemeris, SwissEph uses the default file name which"
-" is defined as ``FNAME_DFT``. Currently, it has the value ``de406.eph`` or"
-" ``de431.eph``.\n\n"
-"If a different JPL ephemeris file is required, call this function to make the"
-" file name known to the software, eg::\n\n"
-"    swe.set_jpl_file('de405.eph')\n\n"
-"This file must reside in the ephemeris path you are using for all your"
-" ephemeris files.");
+static void pyswe_arrow_array_release(struct ArrowArray* a)
+{
+    pyswe_ArrowTable* p = (pyswe_ArrowTable*) a->private_data;
+    int i;
+    for (i = 0; i < PYSWE_TC_COUNT; ++i) {
+        if (p->arrays[i].release)
+            p->arrays[i].release(&p->arrays[i]);
+    }
+    pyswe_table_data_decref(p->data);
+    PyMem_RawFree(p);
+    a->release = NULL;
+}
 
-static PyObject * pyswe_set_jpl_file FUNCARGS_KEYWDS
+/* Make the array of a table (struct of columns), referencing the data
+ * Return -1 if out of memory.
+ */
+static int pyswe_arrow_array(pyswe_TableData* d, struct ArrowArray* out)
 {
-    char *name;
-    static char *kwlist[] = {"name", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &name))
-        return NULL;
-    swe_set_jpl_file(name);
-    Py_RETURN_NONE;
+    pyswe_ArrowTable* p;
+    pyswe_ArrowColumn* col;
+    struct ArrowArray* a;
+    int i;
+    if (!(p = PyMem_RawCalloc(1, sizeof(pyswe_ArrowTable))))
+        return -1;
+    p->data = d;
+    pyswe_table_data_incref(d);
+    for (i = 0; i < PYSWE_TC_COUNT; ++i) {
+        if (!(col = PyMem_RawMalloc(sizeof(pyswe_ArrowColumn)))) {
+            while (i--)
+                p->arrays[i].release(&p->arrays[i]);
+            pyswe_table_data_decref(d);
+            PyMem_RawFree(p);
+            return -1;
+        }
+        col->data = d;
+        pyswe_table_data_incref(d);
+        col->buffers[0] = NULL; /* no nulls */
+        col->buffers[1] = d->cols[i];
+        a = p->children[i] = &p->arrays[i];
+        a->length = d->nrows;
+        a->n_buffers = 2;
+        a->buffers = col->buffers;
+        a->release = pyswe_arrow_child_release;
+        a->private_data = col;
+    }
+    memset(out, 0, sizeof(struct ArrowArray));
+    out->length = d->nrows;
+    out->n_buffers = 1;
+    out->buffers = p->buffers;
+    out->n_children = PYSWE_TC_COUNT;
+    out->children = p->children;
+    out->release = pyswe_arrow_array_release;
+    out->private_data = p;
+    return 0;
 }
 
-/* swisseph.set_lapse_rate */
-PyDoc_STRVAR(pyswe_set_lapse_rate__doc__,
-"Set lapse rate.\n\n"
-":Args: float lrate\n"
-":Return: None");
+/* Stream of one array */
+typedef struct {
+    pyswe_TableData* data;
+    int done;
+} pyswe_ArrowStream;
 
-static PyObject * pyswe_set_lapse_rate FUNCARGS_KEYWDS
+static int pyswe_arrow_stream_get_schema(struct ArrowArrayStream* s,
+                                         struct ArrowSchema* out)
 {
-    double lapserate;
-    static char *kwlist[] = {"lrate", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &lapserate))
-        return NULL;
-    swe_set_lapse_rate(lapserate);
-    Py_RETURN_NONE;
+    return pyswe_arrow_schema(out) ? ENOMEM : 0;
 }
 
-/* swisseph.set_sid_mode */
-PyDoc_STRVAR(pyswe_set_sid_mode__doc__,
-"Set sidereal mode.\n\n"
-":Args: int sidmode, float t0=0.0, float ayan_t0=0.0\n"
-":Return: None\n\n"
-"This function can be used to specify the mode for sidereal computations."
-" ``calc()`` or ``fixstar()`` has then to be called with the bit"
-" ``FLG_SIDEREAL``.\n\n"
-"If ``set_sid_mode()`` is not called, the default ayanamsha (Fagan/Bradley)"
-" is used.\n\n"
-"If a predefined mode is wanted, the parameter ``sidmode`` has to be set, while"
-" ``t0`` and ``ayan_t0`` are not considered, i.e. can be 0.\n\n"
-"For information about the sidereal modes, please read the chapter on sidereal"
-" calculations in the documentation.");
+static int pyswe_arrow_stream_get_next(struct ArrowArrayStream* s,
+                                       struct ArrowArray* out)
+{
+    pyswe_ArrowStream* p = (pyswe_ArrowStream*) s->private_data;
+    if (p->done) {
+        memset(out, 0, sizeof(struct ArrowArray)); /* end of stream */
+        return 0;
+    }
+    if (pyswe_arrow_array(p->data, out))
+        return ENOMEM;
+    p->done = 1;
+    return 0;
+}
 
-static PyObject * pyswe_set_sid_mode FUNCARGS_KEYWDS
+static const char* pyswe_arrow_stream_get_last_error(
+    struct ArrowArrayStream* s)
 {
-    int mode;
-    double t0 = 0.0, ayan_t0 = 0.0;
-    static char *kwlist[] = {"mode", "t0", "ayan_t0", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|dd", kwlist,
-                                     &mode, &t0, &ayan_t0))
-        return NULL;
-    swe_set_sid_mode(mode, t0, ayan_t0);
-    Py_RETURN_NONE;
+    return NULL;
 }
 
-/* swisseph.set_tid_acc */
-PyDoc_STRVAR(pyswe_set_tid_acc__doc__,
-"Set value of the tidal acceleration.\n\n"
-":Args: float acc\n\n"
-" - acc: the values possible are:\n"
-"    - TIDAL_DE200\n"
-"    - TIDAL_DE403\n"
-"    - TIDAL_DE404\n"
-"    - TIDAL_DE405\n"
-"    - TIDAL_DE406\n"
-"    - TIDAL_DE421\n"
-"    - TIDAL_DE422\n"
-"    - TIDAL_DE430\n"
-"    - TIDAL_DE431\n"
-"    - TIDAL_DE441\n"
-"    - TIDAL_26\n"
-"    - TIDAL_STEPHENSON_2016\n"
-"    - TIDAL_DEFAULT (equals TIDAL_DE431)\n"
-"    - TIDAL_MOSEPH (equals TIDAL_DE404)\n"
-"    - TIDAL_SWIEPH (equals TIDAL_DEFAULT)\n"
-"    - TIDAL_JPLEPH (equals TIDAL_DEFAULT)\n\n"
-":Return: None\n\n"
-"With Swiss Ephemeris versions until 1.80, this function had always to be used,"
-" if a nonstandard ephemeris like DE200 or DE421 was used.\n\n"
-"Since Swiss Ephemeris version 2.00, this function is usually not needed,"
-" because the value is automatically set according to the ephemeris files"
-" selected or available. However, under certain circumstances that are"
-" described in the documentation section for ``swe_deltat()``, the user may"
-" want to control the tidal acceleration himself.\n\n"
-"Once the function ``set_tid_acc()`` has been used, the automatic setting of"
-" tidal acceleration is blocked. In order to unblock it again, call"
-" ``set_tid_acc(TIDAL_AUTOMATIC)``.");
+static void pyswe_arrow_stream_release(struct ArrowArrayStream* s)
+{
+    pyswe_ArrowStream* p = (pyswe_ArrowStream*) s->private_data;
+    pyswe_table_data_decref(p->data);
+    PyMem_RawFree(p);
+    s->release = NULL;
+}
 
-static PyObject * pyswe_set_tid_acc FUNCARGS_KEYWDS
+/* Capsules own their struct, released if not moved by the consumer */
+static void pyswe_arrow_schema_capsule_free(PyObject* o)
 {
-    double acc;
-    static char *kwlist[] = {"acc", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &acc))
-        return NULL;
-    swe_set_tid_acc(acc);
-    Py_RETURN_NONE;
+    struct ArrowSchema* s = PyCapsule_GetPointer(o, "arrow_schema");
+    if (s && s->release)
+        s->release(s);
+    PyMem_RawFree(s);
 }
 
-/* swisseph.set_topo */
-PyDoc_STRVAR(pyswe_set_topo__doc__,
-"Set topocentric parameters.\n\n"
-":Args: float lon, float lat, float alt=0.0\n\n"
-" - lon: geographic longitude, in degrees (eastern positive)\n"
-" - lat: geographic latitude, in degrees (northern positive)\n"
-" - alt: geographic altitude in meters above sea level\n\n"
-":Return: None");
+static void pyswe_arrow_array_capsule_free(PyObject* o)
+{
+    struct ArrowArray* a = PyCapsule_GetPointer(o, "arrow_array");
+    if (a && a->release)
+        a->release(a);
+    PyMem_RawFree(a);
+}
 
-static PyObject * pyswe_set_topo FUNCARGS_KEYWDS
+static void pyswe_arrow_stream_capsule_free(PyObject* o)
 {
-    double lon, lat, alt = 0.0;
-    static char *kwlist[] = {"lon", "lat", "alt", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|d", kwlist,
-                                     &lon, &lat, &alt))
+    struct ArrowArrayStream* s = PyCapsule_GetPointer(o,
+                                                      "arrow_array_stream");
+    if (s && s->release)
+        s->release(s);
+    PyMem_RawFree(s);
+}
+
+static PyObject * pyswe_arrow_schema_capsule(void)
+{
+    PyObject* o;
+    struct ArrowSchema* s = PyMem_RawMalloc(sizeof(struct ArrowSchema));
+    if (!s || pyswe_arrow_schema(s)) {
+        PyMem_RawFree(s);
+        return PyErr_NoMemory();
+    }
+    if (!(o = PyCapsule_New(s, "arrow_schema",
+                            pyswe_arrow_schema_capsule_free))) {
+        s->release(s);
+        PyMem_RawFree(s);
+    }
+    return o;
+}
+
+static PyObject * pyswe_arrow_array_capsule(pyswe_TableData* d)
+{
+    PyObject* o;
+    struct ArrowArray* a = PyMem_RawMalloc(sizeof(struct ArrowArray));
+    if (!a || pyswe_arrow_array(d, a)) {
+        PyMem_RawFree(a);
+        return PyErr_NoMemory();
+    }
+    if (!(o = PyCapsule_New(a, "arrow_array",
+                            pyswe_arrow_array_capsule_free))) {
+        a->release(a);
+        PyMem_RawFree(a);
+    }
+    return o;
+}
+
+static PyObject * pyswe_arrow_stream_capsule(pyswe_TableData* d)
+{
+    PyObject* o;
+    pyswe_ArrowStream* p;
+    struct ArrowArrayStream* s = PyMem_RawMalloc(
+        sizeof(struct ArrowArrayStream));
+    if (!s || !(p = PyMem_RawMalloc(sizeof(pyswe_ArrowStream)))) {
+        PyMem_RawFree(s);
+        return PyErr_NoMemory();
+    }
+    p->data = d;
+    p->done = 0;
+    pyswe_table_data_incref(d);
+    s->get_schema = pyswe_arrow_stream_get_schema;
+    s->get_next = pyswe_arrow_stream_get_next;
+    s->get_last_error = pyswe_arrow_stream_get_last_error;
+    s->release = pyswe_arrow_stream_release;
+    s->private_data = p;
+    if (!(o = PyCapsule_New(s, "arrow_array_stream",
+                            pyswe_arrow_stream_capsule_free))) {
+        s->release(s);
+        PyMem_RawFree(s);
+    }
+    return o;
+}
+
+/* swisseph.EphemerisTable */
+PyDoc_STRVAR(pyswe_EphemerisTable__doc__,
+"Table of planetary positions for a range of dates.\n\n"
+":Args: seq bodies, float jd_start, float jd_end, float step,"
+" int flags=FLG_SWIEPH|FLG_SPEED, bool ut=True, str errors='raise',"
+" list errlist=None\n\n"
+" - bodies: sequence of body numbers\n"
+" - jd_start, jd_end: range of dates, Julian day numbers, jd_end excluded"
+" (like range)\n"
+" - step: interval between dates, in days\n"
+" - flags: bit flags indicating what kind of computation is wanted\n"
+" - ut: dates are universal time (calc_ut), else ephemeris time (calc)\n"
+" - errors: policy for the rows in error (see calc_ut_array)\n"
+" - errlist: list where (index, message) of the rows in error are appended,"
+" if errors is not 'raise'\n\n"
+"The table has one row per date and body (dates first), with columns jd"
+" (float64), body (int32), lon, lat, dist, lon_speed, lat_speed, dist_speed"
+" (float64) and retflags (int32). Rows are computed in parallel by the thread"
+" pool (see set_num_threads).\n\n"
+"The table implements the Arrow PyCapsule interface (__arrow_c_array__,"
+" __arrow_c_stream__), so that pyarrow, polars, duckdb... can use the"
+" columns without copy, e.g. ``pyarrow.table(t)`` or ``polars.from_arrow(t)``."
+" This function raises swisseph.Error in case of fatal error, with"
+" errors='raise'.");
+
+typedef struct {
+    PyObject_HEAD
+    pyswe_TableData* data;
+} pyswe_EphemerisTable;
+
+static PyObject * pyswe_EphemerisTable_new(PyTypeObject* tp, PyObject* args,
+                                           PyObject* kwds)
+{
+    pyswe_EphemerisTable* self = NULL;
+    pyswe_TableJob a;
+    pyswe_TableData* d;
+    pyswe_Job job;
+    PyObject *bodies, *errlist = NULL;
+    Py_ssize_t ndates;
+    double end;
+    int* pl;
+    char* errors = "raise";
+    static char* kwlist[] = {"bodies", "jd_start", "jd_end", "step", "flags",
+                             "ut", "errors", "errlist", NULL};
+    a.flag = SEFLG_SWIEPH|SEFLG_SPEED;
+    a.ut = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oddd|iisO", kwlist, &bodies,
+                                     &a.jd_start, &end, &a.step, &a.flag,
+                                     &a.ut, &errors, &errlist)
+        || pyswe_job_policy(&job, errors, errlist, "EphemerisTable")
+        || pyswe_table_args(bodies, a.jd_start, end, a.step, "EphemerisTable",
+                            &pl, &a.nbodies, &ndates))
+        return NULL;
+    a.bodies = pl;
+    if (!(d = pyswe_table_data_new(ndates * a.nbodies))) {
+        PyMem_Free(pl);
+        return PyErr_NoMemory();
+    }
+    a.nan = job.errors == PYSWE_ERRORS_NAN;
+    a.row0 = 0;
+    a.cols = d->cols;
+    job.func = pyswe_table_run;
+    job.data = &a;
+    job.n = d->nrows;
+    job.chunk = 32;
+    pyswe_pool_run(&job);
+    PyMem_Free(pl);
+    if (pyswe_job_errors(&job, pyswe_type_state(tp)->error, "EphemerisTable",
+                         errlist)
+        || !(self = (pyswe_EphemerisTable*) tp->tp_alloc(tp, 0))) {
+        pyswe_table_data_decref(d);
         return NULL;
-    swe_set_topo(lon, lat, alt);
-    Py_RETURN_NONE;
+    }
+    self->data = d;
+    return (PyObject*) self;
 }
 
-/* swisseph.sidtime */
-PyDoc_STRVAR(pyswe_sidtime__doc__,
-"Calculate sidereal time (UT).\n\n"
-":Args: float tjdut\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n\n"
-":Return: float sidtime");
+static void pyswe_EphemerisTable_dealloc(pyswe_EphemerisTable* self)
+{
+    PyTypeObject* tp = Py_TYPE(self);
+    if (self->data)
+        pyswe_table_data_decref(self->data);
+    tp->tp_free((PyObject*) self);
+    Py_DECREF(tp);
+}
 
-static PyObject * pyswe_sidtime FUNCARGS_KEYWDS
+static Py_ssize_t pyswe_EphemerisTable_len(pyswe_EphemerisTable* self)
 {
-    double jd;
-    static char *kwlist[] = {"tjdut", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
+    return self->data->nrows;
+}
+
+PyDoc_STRVAR(pyswe_EphemerisTable_column__doc__,
+"Get a column of the table (copy).\n\n"
+":Args: str name\n\n"
+" - name: column name\n\n"
+":Return: memoryview of float64 or int32, of shape (n,)\n\n"
+"This function raises KeyError if there is no such column.");
+
+static PyObject * pyswe_EphemerisTable_column(pyswe_EphemerisTable* self,
+                                              PyObject* args, PyObject* kwds)
+{
+    char* name;
+    void* buf;
+    int i;
+    size_t size;
+    PyObject* o;
+    static char *kwlist[] = {"name", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &name))
         return NULL;
-    return Py_BuildValue("d", swe_sidtime(jd));
+    for (i = 0; i < PYSWE_TC_COUNT; ++i) {
+        if (!strcmp(name, pyswe_table_columns[i].name))
+            break;
+    }
+    if (i == PYSWE_TC_COUNT)
+        return PyErr_Format(PyExc_KeyError, "%s", name);
+    size = pyswe_table_itemsize(i);
+    if (!(o = pyswe_results_new(self->data->nrows, 1, (int) size, &buf)))
+        return NULL;
+    memcpy(buf, self->data->cols[i], size * self->data->nrows);
+    return pyswe_results_view(o, size == sizeof(double) ? "d" : "i",
+                              self->data->nrows, 0);
 }
 
-/* swisseph.sidtime0 */
-PyDoc_STRVAR(pyswe_sidtime0__doc__,
-"Calculate sidereal time, given obliquity and nutation (UT).\n\n"
-":Args: float tjdut, float eps, float nutation\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - eps: obliquity, in degrees\n"
-" - nutation: nutation in longitude, in degrees\n\n"
-":Return: float sidtime");
+PyDoc_STRVAR(pyswe_EphemerisTable_arrow_c_schema__doc__,
+"Export the schema of the table (Arrow PyCapsule interface).\n\n"
+":Args: --\n"
+":Return: PyCapsule of an ArrowSchema");
 
-static PyObject * pyswe_sidtime0 FUNCARGS_KEYWDS
+static PyObject * pyswe_EphemerisTable_arrow_c_schema(
+    pyswe_EphemerisTable* self, PyObject* unused)
 {
-    double jd, obliquity, nutation;
-    static char *kwlist[] = {"tjdut", "eps", "nutation", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd", kwlist,
-                                     &jd, &obliquity, &nutation))
+    return pyswe_arrow_schema_capsule();
+}
+
+PyDoc_STRVAR(pyswe_EphemerisTable_arrow_c_array__doc__,
+"Export the table as a struct array (Arrow PyCapsule interface).\n\n"
+":Args: requested_schema=None\n\n"
+" - requested_schema: ignored, the columns are not cast\n\n"
+":Return: PyCapsule of an ArrowSchema, PyCapsule of an ArrowArray");
+
+static PyObject * pyswe_EphemerisTable_arrow_c_array(
+    pyswe_EphemerisTable* self, PyObject* args, PyObject* kwds)
+{
+    PyObject* requested = Py_None;
+    static char *kwlist[] = {"requested_schema", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", kwlist, &requested))
         return NULL;
-    return Py_BuildValue("d", swe_sidtime0(jd, obliquity, nutation));
+    return Py_BuildValue("NN", pyswe_arrow_schema_capsule(),
+                         pyswe_arrow_array_capsule(self->data));
 }
 
-/* swisseph.sol_eclipse_how */
-PyDoc_STRVAR(pyswe_sol_eclipse_how__doc__,
-"Calculate attributes of a solar eclipse for a given geographic position and"
-" time.\n\n"
-":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - geopos: a sequence with:\n"
-"    - geographic longitude, in degrees (eastern positive)\n"
-"    - geographic latitude, in degrees (northern positive)\n"
-"    - geographic altitude above sea level, in meters\n\n"
-" - flags: ephemeris flag, etc\n\n"
-":Return: int retflags, (attr)\n\n"
-" - retflags: returned bit flags:\n"
-"    - 0 if no eclipse is visible at position\n"
-"    - ECL_TOTAL ECL_ANNULAR ECL_PARTIAL\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: fraction of solar diameter covered by moon\n"
-"    - 1: ratio of lunar diameter to solar one\n"
-"    - 2: fraction of solar disc covered by moon (obscuration)\n"
-"    - 3: diameter of core shadow in km\n"
-"    - 4: azimuth of sun at tjd\n"
-"    - 5: true altitude of sun above horizon at tjd\n"
-"    - 6: apparent altitude of sun above horizon at tjd\n"
-"    - 7: elongation of moon in degrees (separation angle)\n"
-"    - 8: magnitude acc. to NASA (equals attr[0] for partial and attr[1] for"
-"      annular and total eclipses)\n"
-"    - 9: saros series number (if available, otherwise -99999999)\n"
-"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+PyDoc_STRVAR(pyswe_EphemerisTable_arrow_c_stream__doc__,
+"Export the table as a stream (Arrow PyCapsule interface).\n\n"
+":Args: requested_schema=None\n\n"
+" - requested_schema: ignored, the columns are not cast\n\n"
+":Return: PyCapsule of an ArrowArrayStream");
 
-static PyObject * pyswe_sol_eclipse_how FUNCARGS_KEYWDS
+static PyObject * pyswe_EphemerisTable_arrow_c_stream(
+    pyswe_EphemerisTable* self, PyObject* args, PyObject* kwds)
 {
-    double jd, geopos[3];
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    int i, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    PyObject *gp;
-    static char *kwlist[] = {"tjdut", "geopos", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|i", kwlist,
-                                     &jd, &gp, &flag))
+    PyObject* requested = Py_None;
+    static char *kwlist[] = {"requested_schema", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", kwlist, &requested))
         return NULL;
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                "swisseph.sol_eclipse_how: geopos: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_sol_eclipse_how(jd, flag, geopos, attr, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.sol_eclipse_how: %s", err);
-    return Py_BuildValue("i(dddddddddddddddddddd)", i,attr[0],attr[1],attr[2],
-        attr[3],attr[4],attr[5],attr[6],attr[7],attr[8],attr[9],attr[10],
-        attr[11],attr[12],attr[13],attr[14],attr[15],attr[16],attr[17],attr[18],
-        attr[19]);
+    return pyswe_arrow_stream_capsule(self->data);
 }
 
-/* swisseph.sol_eclipse_when_glob */
-PyDoc_STRVAR(pyswe_sol_eclipse_when_glob__doc__,
-"Find the next solar eclipse globally (UT).\n\n"
-":Args: float tjdut, int flags=FLG_SWIEPH, int ecltype=0, bool"
-" backwards=False\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flags: ephemeris flag\n"
-" - ecltype: bit flags for eclipse type wanted:\n"
-"    - ECL_CENTRAL ECL_NONCENTRAL ECL_TOTAL ECL_ANNULAR ECL_PARTIAL\n"
-"    - ECL_ANNULAR_TOTAL (equals ECL_HYBRID)\n"
-"    - ECL_ALLTYPES_SOLAR or 0 for any type\n"
-" - backwards: boolean, set to True to search back in time\n\n"
-":Return: int res, (tret)\n\n"
-" - res: returned bit flags:\n"
-"    - ECL_TOTAL ECL_ANNULAR ECL_PARTIAL ECL_ANNULAR_TOTAL\n"
-"    - ECL_CENTRAL\n"
-"    - ECL_NONCENTRAL\n\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: time of maximum eclipse\n"
-"    - 1: time when eclipse takes place at local apparent noon\n"
-"    - 2: time of eclipse begin\n"
-"    - 3: time of eclipse end\n"
-"    - 4: time of totality begin\n"
-"    - 5: time of totality end\n"
-"    - 6: time of center line begin\n"
-"    - 7: time of center line end\n"
-"    - 8: time when annular-total eclipse becomes total\n"
-"    - 9: time when annular-total eclipse becomes annular again\n\n"
-"This function raises swisseph.Error in case of fatal error.");
-
-static PyObject * pyswe_sol_eclipse_when_glob FUNCARGS_KEYWDS
+static PyObject * pyswe_EphemerisTable_get_column_names(
+    pyswe_EphemerisTable* self, void* cl)
 {
-    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    int res, ecltype = 0, backw = 0, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "flags", "ecltype", "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|iii", kwlist,
-            &jd, &flag, &ecltype, &backw))
-        return NULL;
-    res = swe_sol_eclipse_when_glob(jd, flag, ecltype, tret, backw, err);
-    if (res < 0)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.sol_eclipse_when_glob: %s", err);
-    return Py_BuildValue("i(dddddddddd)", res,tret[0],tret[1],tret[2],tret[3],
-        tret[4],tret[5],tret[6],tret[7],tret[8],tret[9]);
+    int i;
+    PyObject* o, *t = PyTuple_New(PYSWE_TC_COUNT);
+    for (i = 0; t && i < PYSWE_TC_COUNT; ++i) {
+        if (!(o = PyUnicode_FromString(pyswe_table_columns[i].name))) {
+            Py_CLEAR(t);
+            break;
+        }
+        PyTuple_SET_ITEM(t, i, o);
+    }
+    return t;
 }
 
-/* swisseph.sol_eclipse_when_loc */
-PyDoc_STRVAR(pyswe_sol_eclipse_when_loc__doc__,
-"Find the next solar eclipse for a given geographic position (UT).\n\n"
-":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH, bool backwards=False\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - geopos: a sequence with:\n"
-"    - geographic longitude, in degrees (eastern positive)\n"
-"    - geographic latitude, in degrees (northern positive)\n"
-"    - geographic altitude above sea level, in meters\n"
-" - flags: ephemeris flag, etc\n"
-" - backwards: boolean, set to True to search back in time\n\n"
-":Return: int retflags, (tret), (attr)\n\n"
-" - retflags: returned bit flags:\n"
-"    - ECL_TOTAL or ECL_ANNULAR or ECL_PARTIAL,\n"
-"    - ECL_VISIBLE, ECL_MAX_VISIBLE, ECL_1ST_VISIBLE, ECL_2ND_VISIBLE,\n"
-"      ECL_3RD_VISIBLE, ECL_4TH_VISIBLE\n"
-" - tret: tuple of 10 float, of which:\n"
-"    - 0: time of maximum eclipse\n"
-"    - 1: time of first contact\n"
-"    - 2: time of second contact\n"
-"    - 3: time of third contact\n"
-"    - 4: time of fourth contact\n"
-"    - 5: time of sunrise between first and fourth contact\n"
-"    - 6: time of sunset between first and fourth contact\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: fraction of solar diameter covered by moon; with total/annular\n"
-"      eclipse, it results in magnitude acc. to IMCCE.\n"
-"    - 1: ratio of lunar diameter to solar one\n"
-"    - 2: fraction of solar disc covered by moon (obscuration)\n"
-"    - 3: diameter of core shadow in km\n"
-"    - 4: azimuth of sun at tjd\n"
-"    - 5: true altitude of sun above horizon at tjd\n"
-"    - 6: apparent altitude of sun above horizon at tjd\n"
-"    - 7: elongation of moon in degrees (separation angle)\n"
-"    - 8: magnitude acc. to NASA (equals attr[0] for partial and attr[1] for"
-"      annular and total eclipses)\n"
-"    - 9: saros series number (if available, otherwise -99999999)\n"
-"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+static PyGetSetDef pyswe_EphemerisTable_getsetters[] = {
+{"column_names", (getter) pyswe_EphemerisTable_get_column_names, NULL,
+    "Tuple of column names", NULL},
+{NULL}
+};
 
-static PyObject * pyswe_sol_eclipse_when_loc FUNCARGS_KEYWDS
-{
-    double jd, geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    int i, backw = 0, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    PyObject *gp;
-    static char *kwlist[] = {"tjdut", "geopos", "flags", "backwards", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|ii", kwlist,
-                                     &jd, &gp, &flag, &backw))
-        return NULL;
-    /* extract geopos */
-    i = py_seq2d(gp, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                            "swisseph.sol_eclipse_when_loc: geopos: %s", err);
-    /* set topo params */
-    if (flag & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    i = swe_sol_eclipse_when_loc(jd, flag, geopos, tret, attr, backw, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error,
-                            "swisseph.sol_eclipse_when_loc: %s", err);
-    return Py_BuildValue("i(dddddddddd)(dddddddddddddddddddd)", i,
-        tret[0],tret[1],tret[2],tret[3],tret[4],tret[5],tret[6],tret[7],
-        tret[8],tret[9],attr[0],attr[1],attr[2],attr[3],attr[4],attr[5],
-        attr[6],attr[7],attr[8],attr[9],attr[10],attr[11],attr[12],attr[13],
-        attr[14],attr[15],attr[16],attr[17],attr[18],attr[19]);
-}
+static PyMethodDef pyswe_EphemerisTable_methods[] = {
+{"column", (PyCFunction) pyswe_EphemerisTable_column,
+    METH_VARARGS|METH_KEYWORDS, pyswe_EphemerisTable_column__doc__},
+{"__arrow_c_schema__", (PyCFunction) pyswe_EphemerisTable_arrow_c_schema,
+    METH_NOARGS, pyswe_EphemerisTable_arrow_c_schema__doc__},
+{"__arrow_c_array__", (PyCFunction) pyswe_EphemerisTable_arrow_c_array,
+    METH_VARARGS|METH_KEYWORDS, pyswe_EphemerisTable_arrow_c_array__doc__},
+{"__arrow_c_stream__", (PyCFunction) pyswe_EphemerisTable_arrow_c_stream,
+    METH_VARARGS|METH_KEYWORDS, pyswe_EphemerisTable_arrow_c_stream__doc__},
+{NULL}
+};
 
-/* swisseph.sol_eclipse_where */
-PyDoc_STRVAR(pyswe_sol_eclipse_where__doc__,
-"Find where a solar eclipse is central or maximal (UT).\n\n"
-":Args: float tjdut, int flags=FLG_SWIEPH\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - flags: ephemeris flag\n\n"
-":Return: int retflags, (geopos), (attr)\n\n"
-" - retflags: returned bit flags:\n"
-"    - ECL_TOTAL\n"
-"    - ECL_ANNULAR\n"
-"    - ECL_TOTAL | ECL_CENTRAL\n"
-"    - ECL_TOTAL | ECL_NONCENTRAL\n"
-"    - ECL_ANNULAR | ECL_CENTRAL\n"
-"    - ECL_ANNULAR | ECL_NONCENTRAL\n"
-"    - ECL_PARTIAL\n"
-" - geopos: tuple of 10 float for longitude/latitude of:\n"
-"    - 0: geographic longitude of central line\n"
-"    - 1: geographic latitude of central line\n"
-"    - 2: geographic longitude of northern limit of umbra\n"
-"    - 3: geographic latitude of northern limit of umbra\n"
-"    - 4: geographic longitude of southern limit of umbra\n"
-"    - 5: geographic latitude of southern limit of umbra\n"
-"    - 6: geographic longitude of northern limit of penumbra\n"
-"    - 7: geographic latitude of northern limit of penumbra\n"
-"    - 8: geographic longitude of southern limit of penumbra\n"
-"    - 9: geographic latitude of southern limit of penumbra\n"
-" - attr: tuple of 20 float, of which:\n"
-"    - 0: fraction of solar diameter covered by moon; with total/annular\n"
-"      eclipse, it results in magnitude acc. to IMCCE.\n"
-"    - 1: ratio of lunar diameter to solar one\n"
-"    - 2: fraction of solar disc covered by moon\n"
-"    - 3: diameter of core shadow in km\n"
-"    - 4: azimuth of sun at tjd\n"
-"    - 5: true altitude of sun above horizon at tjd\n"
-"    - 6: apparent altitude of sun above horizon at tjd\n"
-"    - 7: elongation of moon in degrees (separation angle)\n"
-"    - 8: magnitude acc. to NASA (equals attr[0] for partial and attr[1] for"
-"      annular and total eclipses)\n"
-"    - 9: saros series number (if available, otherwise -99999999)\n"
-"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+static PyType_Slot pyswe_EphemerisTable_slots[] = {
+    {Py_tp_doc, (void*) pyswe_EphemerisTable__doc__},
+    {Py_tp_new, pyswe_EphemerisTable_new},
+    {Py_tp_dealloc, pyswe_EphemerisTable_dealloc},
+    {Py_tp_methods, pyswe_EphemerisTable_methods},
+    {Py_tp_getset, pyswe_EphemerisTable_getsetters},
+    {Py_sq_length, pyswe_EphemerisTable_len},
+    {0, NULL}
+};
 
-static PyObject * pyswe_sol_eclipse_where FUNCARGS_KEYWDS
-{
-    double jd, geopos[10] = {0,0,0,0,0,0,0,0,0,0};
-    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    int i, flag = SEFLG_SWIEPH;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &flag))
-        return NULL;
-    i = swe_sol_eclipse_where(jd, flag, geopos, attr, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.sol_eclipse_where: %s", err);
-    return Py_BuildValue("i(dddddddddd)(dddddddddddddddddddd)",i,geopos[0],
-        geopos[1],geopos[2],geopos[3],geopos[4],geopos[5],geopos[6],geopos[7],
-        geopos[8],geopos[9],attr[0],attr[1],attr[2],attr[3],attr[4],attr[5],
-        attr[6],attr[7],attr[8],attr[9],attr[10],attr[11],attr[12],attr[13],
-        attr[14],attr[15],attr[16],attr[17],attr[18],attr[19]);
-}
+static PyType_Spec pyswe_EphemerisTable_spec = {
+    .name = "swisseph.EphemerisTable",
+    .basicsize = sizeof(pyswe_EphemerisTable),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = pyswe_EphemerisTable_slots,
+};
 
-/* swisseph.solcross */
-PyDoc_STRVAR(pyswe_solcross__doc__,
-"Compute next Sun crossing over some longitude (ET).\n\n"
-":Args: float x2cross, float tjdet, int flags=FLG_SWIEPH\n\n"
-" - x2cross: longitude to search\n"
-" - tjdet: start time of search, Julian day number, Ephemeris Time\n"
-" - flags: bit flags indicating what computation is wanted\n\n"
-":Return: float jdcross\n\n"
-" - jdcross: Julian day number found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* swisseph.ephemeris_table */
+PyDoc_STRVAR(pyswe_ephemeris_table__doc__,
+"Calculate a table of planetary positions for a range of dates.\n\n"
+":Args: seq bodies, float jd_start, float jd_end, float step,"
+" int flags=FLG_SWIEPH|FLG_SPEED, bool ut=True, str errors='raise',"
+" list errlist=None\n\n"
+":Return: EphemerisTable\n\n"
+"Same as EphemerisTable(...), see there.");
 
-static PyObject * pyswe_solcross FUNCARGS_KEYWDS
+static PyObject * pyswe_ephemeris_table FUNCARGS_KEYWDS
 {
-    int flags = SEFLG_SWIEPH;
-    double x2, jd, res;
-    char err[256] = {0};
-    static char* kwlist[] = {"x2cross", "tjdet", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
-                                     &x2, &jd, &flags))
-        return NULL;
-    if ((res = swe_solcross(x2, jd, flags, err)) < jd)
-        return PyErr_Format(pyswe_Error, "swisseph.solcross: %s", err);
-    return Py_BuildValue("d", res);
+    return PyObject_Call((PyObject*) pyswe_get_state(self)->table_type, args,
+                         kwds);
 }
 
-/* swisseph.solcross_ut */
-PyDoc_STRVAR(pyswe_solcross_ut__doc__,
-"Compute next Sun crossing over some longitude (UT).\n\n"
-":Args: float x2cross, float tjdut, int flags=FLG_SWIEPH\n\n"
-" - x2cross: longitude to search\n"
-" - tjdut: start time of search, Julian day number, Universal Time\n"
-" - flags: bit flags indicating what computation is wanted\n\n"
-":Return: float jdcross\n\n"
-" - jdcross: Julian day number found\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Compact ephemeris files
+ *
+ * A compact ephemeris holds Chebyshev coefficients of the longitude, latitude
+ * and distance of some bodies, for a fixed range of dates (UT). Segments have
+ * the same length for a given body, so that the evaluation needs no search.
+ *
+ * File layout (native byte order):
+ *  - header (pyswe_CEHeader)
+ *  - table of bodies (pyswe_CEBody * nbodies)
+ *  - for each body, for each segment: lon, lat, dist coefficients
+ */
 
-static PyObject * pyswe_solcross_ut FUNCARGS_KEYWDS
-{
-    int flags = SEFLG_SWIEPH;
-    double x2, jd, res;
-    char err[256] = {0};
-    static char* kwlist[] = {"x2cross", "tjdut", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
-                                     &x2, &jd, &flags))
-        return NULL;
-    if ((res = swe_solcross_ut(x2, jd, flags, err)) < jd)
-        return PyErr_Format(pyswe_Error, "swisseph.solcross_ut: %s", err);
-    return Py_BuildValue("d", res);
-}
+#define PYSWE_CE_MAGIC          "PYSWECE"
+#define PYSWE_CE_VERSION        2
+#define PYSWE_CE_BYTEORDER      0x01020304
+#define PYSWE_CE_NCOEFFS        12
+#define PYSWE_CE_MAXCOEFFS      32
+#define PYSWE_CE_MAXSEGLEN      256.0
+#define PYSWE_CE_MINSEGLEN      0.05
+#define PYSWE_CE_TRIALS         16
 
-/* swisseph.split_deg */
-PyDoc_STRVAR(pyswe_split_deg__doc__,
-"Provide sign or nakshatra, degree, minutes, seconds and fraction of second"
-" from decimal degree. Can also round to seconds, minutes, degrees.\n\n"
-":Args: float degree, int roundflag\n\n"
-" - degree: position in decimal degrees\n"
-" - roundflag: bit flags combination indicating how to round:\n"
-"    - 0: dont round\n"
-"    - SPLIT_DEG_ROUND_SEC: round to seconds\n"
-"    - SPLIT_DEG_ROUND_MIN: round to minutes\n"
-"    - SPLIT_DEG_ROUND_DEG: round to degrees\n"
-"    - SPLIT_DEG_ZODIACAL: with zodiac sign number\n"
-"    - SPLIT_DEG_NAKSHATRA: with nakshatra number\n"
-"    - SPLIT_DEG_KEEP_SIGN: dont round to next zodiac sign/nakshatra\n"
-"    - SPLIT_DEG_KEEP_DEG: dont round to next degree\n\n"
-":Return: deg, min, sec, secfr, sign\n\n"
-" - deg: returned degree\n"
-" - min: returned minutes\n"
-" - sec: returned seconds\n"
-" - secfr: returned fraction of second\n"
-" - sign: returned sign/nakshatra number");
+/* Ephemeris bits of flags */
+#define PYSWE_EPHMASK   (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH)
 
-static PyObject * pyswe_split_deg FUNCARGS_KEYWDS
-{
-    double ddeg, secfr;
-    int deg, min, sec, sign, flag;
-    static char *kwlist[] = {"degree", "roundflag", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &ddeg, &flag))
-        return NULL;
-    swe_split_deg(ddeg, flag, &deg, &min, &sec, &secfr, &sign);
-    return Py_BuildValue("iiidi", deg, min, sec, secfr, sign);
+#ifndef M_PI
+#define M_PI    3.14159265358979323846
+#endif
+
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t byteorder;
+    int32_t nbodies;
+    int32_t flags;
+    double jd_start;
+    double jd_end;
+    double tolerance;
+    int32_t sid_mode; /* with SEFLG_SIDEREAL */
+    int32_t reserved1;
+    double sid_t0;
+    double sid_ayan_t0;
+    char reserved[16];
+} pyswe_CEHeader;
+
+typedef struct {
+    int32_t ipl;
+    int32_t ncoeffs;
+    int32_t nsegments;
+    int32_t reserved;
+    double seglen;
+    int64_t offset;
+} pyswe_CEBody;
+
+/* Chebyshev coefficients of n values sampled at nodes cos(pi*(k+.5)/n) */
+static void pyswe_cheb_fit(const double* f, int n, double* c)
+{
+    int j, k;
+    double s;
+    for (j = 0; j < n; ++j) {
+        s = 0;
+        for (k = 0; k < n; ++k)
+            s += f[k] * cos(M_PI * j * (k + 0.5) / n);
+        c[j] = s * 2.0 / n;
+    }
+    c[0] /= 2.0;
 }
 
-/* swisseph.time_equ */
-PyDoc_STRVAR(pyswe_time_equ__doc__,
-"Calculate equation of time (UT).\n\n"
-":Args: float tjdut\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n\n"
-":Return: float e\n\n"
-" - e: difference between local apparent time and local mean time in days\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+/* Evaluate a Chebyshev series at x in [-1;1] (Clenshaw) */
+static double pyswe_cheb_eval(const double* c, int n, double x)
+{
+    int j;
+    double b1 = 0, b2 = 0, t;
+    for (j = n - 1; j >= 1; --j) {
+        t = 2.0 * x * b1 - b2 + c[j];
+        b2 = b1;
+        b1 = t;
+    }
+    return x * b1 - b2 + c[0];
+}
 
-static PyObject * pyswe_time_equ FUNCARGS_KEYWDS
+/* Evaluate the derivative (by x) of a Chebyshev series */
+static double pyswe_cheb_deriv(const double* c, int n, double x)
 {
-    int i;
-    double jd, ret;
-    char err[256] = {0};
-    static char *kwlist[] = {"tjdut", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
-        return NULL;
-    i = swe_time_equ(jd, &ret, err);
-    if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.time_equ: %s", err);
-    return Py_BuildValue("d", ret);
+    int j;
+    double d[PYSWE_CE_MAXCOEFFS + 1];
+    if (n < 2)
+        return 0;
+    d[n] = d[n - 1] = 0;
+    for (j = n - 2; j >= 0; --j)
+        d[j] = d[j + 2] + 2.0 * (j + 1) * c[j + 1];
+    d[0] /= 2.0;
+    return pyswe_cheb_eval(d, n - 1, x);
 }
 
-/* swisseph.utc_time_zone */
-PyDoc_STRVAR(pyswe_utc_time_zone__doc__,
-"Transform local time to UTC or UTC to local time.\n\n"
-":Args: int year, int month, int day, int hour, int minutes, float seconds,"
+/* Check the ephemeris used by a calculation, that must be the same for all
+ * (libswe falls back to Moshier without files)
+ * Return 1 on error
+ */
+static int pyswe_ce_eph(int ret, int* eph, char* err)
+{
+    if (ret < 0)
+        return 1;
+    if (!*eph)
+        *eph = ret & PYSWE_EPHMASK;
+    else if ((ret & PYSWE_EPHMASK) != *eph) {
+        strcpy(err, "ephemeris changed within the range (missing files?)");
+        return 1;
+    }
+    return 0;
+}
+
+/* Sample and fit one segment of a body, then check the fit at the extrema of
+ * the polynomial and between them
+ * Return 1 on ephemeris error, 0 otherwise with *ok set
+ */
+static int pyswe_ce_fit(int ipl, int flags, double start, double len, int n,
+                        double tol, double* coeffs, int* ok, int* eph,
+                        char* err)
+{
+    double f[3][PYSWE_CE_MAXCOEFFS], xx[6], x, prev = 0;
+    int i, k;
+    for (k = 0; k < n; ++k) {
+        x = cos(M_PI * (k + 0.5) / n);
+        if (pyswe_ce_eph(swe_calc_ut(start + (x + 1) * len / 2, ipl, flags,
+                                     xx, err), eph, err))
+            return 1;
+        /* nodes are in time order, unwrap longitude */
+        f[0][k] = k ? f[0][k - 1] + swe_difdeg2n(xx[0], prev) : xx[0];
+        f[1][k] = xx[1];
+        f[2][k] = xx[2];
+        prev = xx[0];
+    }
+    for (i = 0; i < 3; ++i)
+        pyswe_cheb_fit(f[i], n, coeffs + i * n);
+    *ok = 1;
+    for (k = 0; k <= 2 * n; ++k) {
+        x = cos(M_PI * k / (2 * n));
+        if (pyswe_ce_eph(swe_calc_ut(start + (x + 1) * len / 2, ipl, flags,
+                                     xx, err), eph, err))
+            return 1;
+        if (fabs(swe_difdeg2n(pyswe_cheb_eval(coeffs, n, x), xx[0])) > tol
+            || fabs(pyswe_cheb_eval(coeffs + n, n, x) - xx[1]) > tol
+            || fabs(pyswe_cheb_eval(coeffs + 2 * n, n, x) - xx[2])
+                > tol * (M_PI / 180) * fabs(xx[2])) {
+            *ok = 0;
+            break;
+        }
+    }
+    return 0;
+}
+
+/* Find segment length and write coefficients of one body
+ * Return 1 on ephemeris error, 2 on tolerance error, 3 on write error
+ */
+static int pyswe_ce_body(FILE* fd, pyswe_CEBody* bd, int flags, double start,
+                         double end, double tol, int* eph, char* err)
+{
+    double seglen, coeffs[3 * PYSWE_CE_MAXCOEFFS];
+    int i, nseg, ok, n = PYSWE_CE_NCOEFFS;
+    long pos = ftell(fd);
+    for (nseg = (int) ceil((end - start) / PYSWE_CE_MAXSEGLEN);; nseg *= 2) {
+        seglen = (end - start) / nseg;
+        if (seglen < PYSWE_CE_MINSEGLEN)
+            return 2;
+        /* try some segments first */
+        for (i = 0, ok = 1; ok && i < PYSWE_CE_TRIALS && i < nseg; ++i) {
+            if (pyswe_ce_fit(bd->ipl, flags,
+                             start + (nseg * i / PYSWE_CE_TRIALS) * seglen,
+                             seglen, n, tol, coeffs, &ok, eph, err))
+                return 1;
+        }
+        if (!ok)
+            continue;
+        if (fseek(fd, pos, SEEK_SET))
+            return 3;
+        for (i = 0; ok && i < nseg; ++i) {
+            if (pyswe_ce_fit(bd->ipl, flags, start + i * seglen, seglen, n,
+                             tol, coeffs, &ok, eph, err))
+                return 1;
+            if (ok && fwrite(coeffs, sizeof(double), 3 * n, fd)
+                != (size_t) (3 * n))
+                return 3;
+        }
+        if (ok)
+            break;
+    }
+    bd->ncoeffs = n;
+    bd->nsegments = nseg;
+    bd->seglen = seglen;
+    bd->offset = pos;
+    return 0;
+}
+
+/* swisseph.CompactEphemeris */
+PyDoc_STRVAR(pyswe_CompactEphemeris__doc__,
+"Compact ephemeris file reader.\n\n"
+":Args: str path\n\n"
+" - path: file written by ``export_compact()``\n\n"
+"The file is mapped in memory (read-only, shared between processes) where"
+" mmap is available. Positions are then evaluated without system calls.");
+
+typedef struct {
+    PyObject_HEAD
+    char* data;
+    size_t size;
+    int mapped;
+    const pyswe_CEHeader* hdr;
+    const pyswe_CEBody* bodies;
+} pyswe_CompactEphemeris;
+
+static void pyswe_CompactEphemeris_release(pyswe_CompactEphemeris* self)
+{
+    if (!self->data)
+        return;
+#if PYSWE_USE_MMAP
+    if (self->mapped)
+        munmap(self->data, self->size);
+    else
+#endif
+    PyMem_Free(self->data);
+    self->data = NULL;
+    self->size = 0;
+    self->hdr = NULL;
+    self->bodies = NULL;
+}
+
+/* Load file contents, return 1 with errno set on error */
+static int pyswe_CompactEphemeris_load(pyswe_CompactEphemeris* self,
+                                       const char* path)
+{
+#if PYSWE_USE_MMAP
+    int fd;
+    struct stat st;
+    void* addr;
+    if ((fd = open(path, O_RDONLY)) == -1)
+        return 1;
+    if (fstat(fd, &st)) {
+        close(fd);
+        return 1;
+    }
+    if (st.st_size < (off_t) sizeof(pyswe_CEHeader)) {
+        close(fd);
+        self->size = (size_t) st.st_size;
+        return 0;
+    }
+    addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return 1;
+    self->data = addr;
+    self->size = (size_t) st.st_size;
+    self->mapped = 1;
+    return 0;
+#else
+    FILE* fd;
+    long len;
+    if (!(fd = fopen(path, "rb")))
+        return 1;
+    if (fseek(fd, 0, SEEK_END) || (len = ftell(fd)) < 0
+        || fseek(fd, 0, SEEK_SET)) {
+        fclose(fd);
+        return 1;
+    }
+    if (!(self->data = PyMem_Malloc(len ? len : 1))) {
+        fclose(fd);
+        errno = ENOMEM;
+        return 1;
+    }
+    if (fread(self->data, 1, len, fd) != (size_t) len) {
+        fclose(fd);
+        PyMem_Free(self->data);
+        self->data = NULL;
+        return 1;
+    }
+    fclose(fd);
+    self->size = (size_t) len;
+    return 0;
+#endif
+}
+
+/* Check file contents, return 0 if valid */
+static int pyswe_CompactEphemeris_check(pyswe_CompactEphemeris* self)
+{
+    int i;
+    size_t end;
+    const pyswe_CEHeader* hdr = (const pyswe_CEHeader*) self->data;
+    const pyswe_CEBody* bd;
+    if (!self->data || self->size < sizeof(pyswe_CEHeader)
+        || memcmp(hdr->magic, PYSWE_CE_MAGIC, sizeof(PYSWE_CE_MAGIC))
+        || hdr->version != PYSWE_CE_VERSION
+        || hdr->byteorder != PYSWE_CE_BYTEORDER
+        || hdr->nbodies < 0
+        || (size_t) hdr->nbodies > (self->size - sizeof(pyswe_CEHeader))
+            / sizeof(pyswe_CEBody)
+        || !(hdr->jd_end > hdr->jd_start))
+        return 1;
+    bd = (const pyswe_CEBody*) (self->data + sizeof(pyswe_CEHeader));
+    for (i = 0; i < hdr->nbodies; ++i, ++bd) {
+        if (bd->ncoeffs < 1 || bd->ncoeffs > PYSWE_CE_MAXCOEFFS
+            || bd->nsegments < 1 || !(bd->seglen > 0)
+            || bd->offset < 0 || (size_t) bd->offset > self->size
+            || bd->offset % sizeof(double))
+            return 1;
+        end = (size_t) bd->offset
+            + sizeof(double) * 3 * bd->ncoeffs * (size_t) bd->nsegments;
+        if (end > self->size)
+            return 1;
+    }
+    self->hdr = hdr;
+    self->bodies = (const pyswe_CEBody*) (self->data + sizeof(pyswe_CEHeader));
+    return 0;
+}
+
+static PyObject * pyswe_CompactEphemeris_new(PyTypeObject* tp, PyObject* args,
+                                             PyObject* kwds)
+{
+    pyswe_CompactEphemeris* self;
+    char* path;
+    static char* kwlist[] = {"path", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &path))
+        return NULL;
+    if (!(self = (pyswe_CompactEphemeris*) tp->tp_alloc(tp, 0)))
+        return NULL;
+    if (pyswe_CompactEphemeris_load(self, path)) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        Py_DECREF(self);
+        return NULL;
+    }
+    if (pyswe_CompactEphemeris_check(self)) {
+        PyErr_Format(PyExc_ValueError,
+                     "swisseph.CompactEphemeris: invalid file (%s)", path);
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject*) self;
+}
+
+static void pyswe_CompactEphemeris_dealloc(pyswe_CompactEphemeris* self)
+{
+    PyTypeObject* tp = Py_TYPE(self);
+    pyswe_CompactEphemeris_release(self);
+    tp->tp_free((PyObject*) self);
+    Py_DECREF(tp);
+}
+
+PyDoc_STRVAR(pyswe_CompactEphemeris_calc_ut__doc__,
+"Calculate planetary positions (UT) from the compact ephemeris.\n\n"
+":Args: float tjdut, int planet\n\n"
+" - tjdut: julian day number, universal time\n"
+" - planet: body number\n\n"
+":Return: (xx), int retflags\n\n"
+" - xx: Position, tuple of 6 float for results\n"
+" - retflags: ephemeris flags the file was exported with\n\n"
+"Speeds are derived from the fitted positions. This function raises"
+" ValueError if the date is out of range or the body is not in the file.");
+
+/* Evaluate the position of a body
+ * Return 0 on success, 1 if closed, 2 if out of range, 3 if no such body
+ */
+static int pyswe_CompactEphemeris_eval(pyswe_CompactEphemeris* self,
+                                       double jd, int pl, double* xx)
+{
+    double x;
+    const double* c;
+    const pyswe_CEBody* bd;
+    int i, n, seg;
+    if (!self->hdr)
+        return 1;
+    if (!(jd >= self->hdr->jd_start && jd <= self->hdr->jd_end))
+        return 2;
+    for (i = 0, bd = self->bodies; i < self->hdr->nbodies; ++i, ++bd) {
+        if (bd->ipl == pl)
+            break;
+    }
+    if (i == self->hdr->nbodies)
+        return 3;
+    n = bd->ncoeffs;
+    seg = (int) ((jd - self->hdr->jd_start) / bd->seglen);
+    if (seg >= bd->nsegments)
+        seg = bd->nsegments - 1;
+    x = 2 * (jd - self->hdr->jd_start - seg * bd->seglen) / bd->seglen - 1;
+    c = (const double*) (self->data + bd->offset) + (size_t) seg * 3 * n;
+    for (i = 0; i < 3; ++i) {
+        xx[i] = pyswe_cheb_eval(c + i * n, n, x);
+        xx[i + 3] = pyswe_cheb_deriv(c + i * n, n, x) * 2 / bd->seglen;
+    }
+    xx[0] = swe_degnorm(xx[0]);
+    return 0;
+}
+
+static PyObject * pyswe_CompactEphemeris_calc_ut(pyswe_CompactEphemeris* self,
+                                                 PyObject* args, PyObject* kwds)
+{
+    double jd, xx[6];
+    int pl, ret, flags = 0;
+    static char *kwlist[] = {"tjdut", "planet", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &pl))
+        return NULL;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    ret = pyswe_CompactEphemeris_eval(self, jd, pl, xx);
+    if (!ret)
+        flags = self->hdr->flags;
+    Py_END_CRITICAL_SECTION();
+    switch (ret) {
+    case 1:
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.CompactEphemeris.calc_ut: closed file");
+    case 2:
+        return PyErr_Format(PyExc_ValueError,
+            "swisseph.CompactEphemeris.calc_ut: date out of range");
+    case 3:
+        return PyErr_Format(PyExc_ValueError,
+            "swisseph.CompactEphemeris.calc_ut: no such body (%d)", pl);
+    }
+    return pyswe_calc_result(pyswe_type_state(Py_TYPE(self)), xx, flags);
+}
+
+PyDoc_STRVAR(pyswe_CompactEphemeris_close__doc__,
+"Release the file.\n\n"
+":Args: --\n"
+":Return: None");
+
+static PyObject * pyswe_CompactEphemeris_close(pyswe_CompactEphemeris* self,
+                                               PyObject* unused)
+{
+    Py_BEGIN_CRITICAL_SECTION(self);
+    pyswe_CompactEphemeris_release(self);
+    Py_END_CRITICAL_SECTION();
+    Py_RETURN_NONE;
+}
+
+static PyObject * pyswe_CompactEphemeris_get_bodies(
+    pyswe_CompactEphemeris* self, void* cl)
+{
+    int i;
+    PyObject* o, *t;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    t = PyTuple_New(self->hdr ? self->hdr->nbodies : 0);
+    for (i = 0; t && self->hdr && i < self->hdr->nbodies; ++i) {
+        if (!(o = PyLong_FromLong(self->bodies[i].ipl))) {
+            Py_CLEAR(t);
+            break;
+        }
+        PyTuple_SET_ITEM(t, i, o);
+    }
+    Py_END_CRITICAL_SECTION();
+    return t;
+}
+
+static PyObject * pyswe_CompactEphemeris_get_double(
+    pyswe_CompactEphemeris* self, void* cl)
+{
+    PyObject* o = NULL;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (self->hdr)
+        o = PyFloat_FromDouble(*(const double*)
+                               ((const char*) self->hdr + (size_t) cl));
+    Py_END_CRITICAL_SECTION();
+    if (!o && !PyErr_Occurred())
+        Py_RETURN_NONE;
+    return o;
+}
+
+static PyObject * pyswe_CompactEphemeris_get_flags(
+    pyswe_CompactEphemeris* self, void* cl)
+{
+    PyObject* o = NULL;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (self->hdr)
+        o = PyLong_FromLong(self->hdr->flags);
+    Py_END_CRITICAL_SECTION();
+    if (!o && !PyErr_Occurred())
+        Py_RETURN_NONE;
+    return o;
+}
+
+static PyObject * pyswe_CompactEphemeris_get_sid_mode(
+    pyswe_CompactEphemeris* self, void* cl)
+{
+    PyObject* o = NULL;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (self->hdr && self->hdr->flags & SEFLG_SIDEREAL)
+        o = Py_BuildValue("(idd)", self->hdr->sid_mode, self->hdr->sid_t0,
+                          self->hdr->sid_ayan_t0);
+    Py_END_CRITICAL_SECTION();
+    if (!o && !PyErr_Occurred())
+        Py_RETURN_NONE;
+    return o;
+}
+
+static PyGetSetDef pyswe_CompactEphemeris_getsetters[] = {
+{"bodies", (getter) pyswe_CompactEphemeris_get_bodies, NULL,
+    "Tuple of body numbers", NULL},
+{"flags", (getter) pyswe_CompactEphemeris_get_flags, NULL,
+    "Ephemeris flags", NULL},
+{"jd_start", (getter) pyswe_CompactEphemeris_get_double, NULL,
+    "Start of range (UT)", (void*) offsetof(pyswe_CEHeader, jd_start)},
+{"jd_end", (getter) pyswe_CompactEphemeris_get_double, NULL,
+    "End of range (UT)", (void*) offsetof(pyswe_CEHeader, jd_end)},
+{"tolerance", (getter) pyswe_CompactEphemeris_get_double, NULL,
+    "Tolerance in degrees", (void*) offsetof(pyswe_CEHeader, tolerance)},
+{"sid_mode", (getter) pyswe_CompactEphemeris_get_sid_mode, NULL,
+    "Sidereal mode (mode, t0, ayan_t0), None if not sidereal", NULL},
+{NULL}
+};
+
+static PyMethodDef pyswe_CompactEphemeris_methods[] = {
+{"calc_ut", (PyCFunction) pyswe_CompactEphemeris_calc_ut,
+    METH_VARARGS|METH_KEYWORDS, pyswe_CompactEphemeris_calc_ut__doc__},
+{"close", (PyCFunction) pyswe_CompactEphemeris_close,
+    METH_NOARGS, pyswe_CompactEphemeris_close__doc__},
+{NULL}
+};
+
+static PyType_Slot pyswe_CompactEphemeris_slots[] = {
+    {Py_tp_doc, (void*) pyswe_CompactEphemeris__doc__},
+    {Py_tp_new, pyswe_CompactEphemeris_new},
+    {Py_tp_dealloc, pyswe_CompactEphemeris_dealloc},
+    {Py_tp_methods, pyswe_CompactEphemeris_methods},
+    {Py_tp_getset, pyswe_CompactEphemeris_getsetters},
+    {0, NULL}
+};
+
+static PyType_Spec pyswe_CompactEphemeris_spec = {
+    .name = "swisseph.CompactEphemeris",
+    .basicsize = sizeof(pyswe_CompactEphemeris),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = pyswe_CompactEphemeris_slots,
+};
+
+/* swisseph.export_compact */
+PyDoc_STRVAR(pyswe_export_compact__doc__,
+"Write a compact ephemeris file for a range of dates.\n\n"
+":Args: str path, seq bodies, float jd_start, float jd_end, float tolerance,"
+" int flags=FLG_SWIEPH\n\n"
+" - path: file to write\n"
+" - bodies: sequence of body numbers\n"
+" - jd_start, jd_end: range of dates, Julian day numbers, Universal Time\n"
+" - tolerance: maximum error of longitude and latitude, in degrees\n"
+" - flags: bit flags indicating what kind of computation is wanted\n\n"
+":Return: None\n\n"
+"The file holds Chebyshev coefficients of longitude, latitude and distance"
+" (distance errors are kept relative to ``tolerance``). Each body gets the"
+" longest segments that fit within tolerance (checked at 2n+1 points of"
+" each segment of n coefficients). Read it with ``CompactEphemeris``. Flags"
+" ``FLG_XYZ`` and ``FLG_RADIANS`` are not supported.\n\n"
+"The file records the flags returned by the calculations: with"
+" ``FLG_SWIEPH`` and no ephemeris files, libswe computes with the Moshier"
+" ephemeris, and the file has ``FLG_MOSEPH``. With ``FLG_SIDEREAL``, it also"
+" records the sidereal mode set by ``set_sid_mode()``.\n\n"
+"This function raises swisseph.Error in case of fatal error, or if the"
+" ephemeris used changes within the range (files missing for some dates).");
+
+static PyObject * pyswe_export_compact FUNCARGS_KEYWDS
+{
+    char *path, err[256] = {0};
+    double start, end, tol;
+    int i, x, pl = 0, nbodies, flag = SEFLG_SWIEPH, eph = 0, errnum;
+    FILE* fd;
+    PyObject *o, *seq;
+    pyswe_CEHeader hdr;
+    pyswe_CEBody* bodies;
+    static char *kwlist[] = {"path", "bodies", "jd_start", "jd_end",
+                             "tolerance", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sOddd|i", kwlist, &path,
+                                     &o, &start, &end, &tol, &flag))
+        return NULL;
+    if (!(end > start))
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.export_compact: invalid range");
+    if (!(tol > 0))
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.export_compact: invalid tolerance");
+    if (flag & (SEFLG_XYZ|SEFLG_RADIANS))
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.export_compact: unsupported flags");
+    if (!(seq = PySequence_Fast(o, "swisseph.export_compact: bodies: "
+                                "is not a sequence object")))
+        return NULL;
+    nbodies = (int) PySequence_Fast_GET_SIZE(seq);
+    if (!(bodies = PyMem_Calloc(nbodies ? nbodies : 1, sizeof(pyswe_CEBody)))) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < nbodies; ++i) {
+        bodies[i].ipl = (int) PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+        if (bodies[i].ipl == -1 && PyErr_Occurred()) {
+            Py_DECREF(seq);
+            PyMem_Free(bodies);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    memset(&hdr, 0, sizeof(pyswe_CEHeader));
+    memcpy(hdr.magic, PYSWE_CE_MAGIC, sizeof(PYSWE_CE_MAGIC));
+    hdr.version = PYSWE_CE_VERSION;
+    hdr.byteorder = PYSWE_CE_BYTEORDER;
+    hdr.nbodies = nbodies;
+    hdr.jd_start = start;
+    hdr.jd_end = end;
+    hdr.tolerance = tol;
+    if (flag & SEFLG_SIDEREAL) {
+        hdr.sid_mode = pyswe_settings.sid_mode;
+        hdr.sid_t0 = pyswe_settings.sid_t0;
+        hdr.sid_ayan_t0 = pyswe_settings.sid_ayan_t0;
+    }
+    if (!(fd = fopen(path, "wb"))) {
+        PyMem_Free(bodies);
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+#if PYSWE_SWE_TLS
+    /* libswe settings are those of this thread */
+    Py_BEGIN_ALLOW_THREADS
+#endif
+    x = fseek(fd, sizeof(pyswe_CEHeader) + sizeof(pyswe_CEBody) * nbodies,
+              SEEK_SET) ? 3 : 0;
+    /* positions are sampled without speeds, these are derived on reading */
+    for (i = 0; !x && i < nbodies; ++i) {
+        pl = bodies[i].ipl;
+        x = pyswe_ce_body(fd, &bodies[i], flag & ~SEFLG_SPEED, start, end,
+                          tol, &eph, err);
+    }
+    /* the ephemeris actually used */
+    hdr.flags = eph ? (flag & ~PYSWE_EPHMASK) | eph : flag;
+    if (!x && (fseek(fd, 0, SEEK_SET)
+        || fwrite(&hdr, sizeof(pyswe_CEHeader), 1, fd) != 1
+        || fwrite(bodies, sizeof(pyswe_CEBody), nbodies, fd)
+            != (size_t) nbodies))
+        x = 3;
+    if (fclose(fd) && !x)
+        x = 3;
+    errnum = errno;
+#if PYSWE_SWE_TLS
+    Py_END_ALLOW_THREADS
+#endif
+    PyMem_Free(bodies);
+    if (!x)
+        Py_RETURN_NONE;
+    remove(path);
+    switch (x) {
+    case 1:
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.export_compact: %s", err);
+    case 2:
+        return PyErr_Format(PyExc_ValueError,
+            "swisseph.export_compact: body %d: tolerance too small", pl);
+    default:
+        errno = errnum;
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+}
+
+/* swisseph.fixstar */
+PyDoc_STRVAR(pyswe_fixstar__doc__,
+"Calculate fixed star positions (ET).\n\n"
+":Args: str star, float tjdet, int flags=FLG_SWIEPH\n\n"
+" - star: name of fixed star to search for\n"
+" - tjdet: input time, Julian day number,  Ephemeris Time\n"
+" - flags: bit flags indicating what kind of computation is wanted\n\n"
+":Return: (xx), str stnam, int retflags\n\n"
+" - xx: Position, tuple of 6 float for results\n"
+" - stnam: returned star name\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_fixstar FUNCARGS_KEYWDS
+{
+    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
+    double jd, xx[6];
+    int ret, flag = SEFLG_SWIEPH;
+    static char *kwlist[] = {"star", "tjdet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
+                                     &star, &jd, &flag))
+        return NULL;
+    memset(st, 0, (SE_MAX_STNAME*2)+1);
+    strncpy(st, star, SE_MAX_STNAME*2);
+    ret = swe_fixstar(st, jd, flag, xx, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.fixstar: %s", err);
+    return Py_BuildValue("Nsi", pyswe_position(pyswe_get_state(self), xx), st,
+                         ret);
+}
+
+/* swisseph.fixstar2 */
+PyDoc_STRVAR(pyswe_fixstar2__doc__,
+"Calculate fixed star positions (faster version) (ET).\n\n"
+":Args: str star, float tjdet, int flags=FLG_SWIEPH\n\n"
+" - star: name of fixed star to search for\n"
+" - tjdet: input time, Julian day number, Ephemeris Time\n"
+" - flags: bit flags indicating what kind of computation is wanted\n\n"
+":Return: (xx), str stnam, int retflags\n\n"
+" - xx: Position, tuple of 6 float for results\n"
+" - stnam: returned star name\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_fixstar2 FUNCARGS_KEYWDS
+{
+    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
+    double jd, xx[6];
+    int ret, flag = SEFLG_SWIEPH;
+    static char *kwlist[] = {"star", "tjdet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
+                                     &star, &jd, &flag))
+        return NULL;
+    memset(st, 0, (SE_MAX_STNAME*2)+1);
+    strncpy(st, star, SE_MAX_STNAME*2);
+    ret = swe_fixstar2(st, jd, flag, xx, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.fixstar2: %s", err);
+    return Py_BuildValue("Nsi", pyswe_position(pyswe_get_state(self), xx), st,
+                         ret);
+}
+
+/* swisseph.fixstar2_mag */
+PyDoc_STRVAR(pyswe_fixstar2_mag__doc__,
+"Get fixed star magnitude (faster version).\n\n"
+":Args: str star\n\n"
+" - star: name of fixed star\n\n"
+":Return: float mag, str stnam\n\n"
+" - mag: returned magnitude\n"
+" - stnam: returned star name\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_fixstar2_mag FUNCARGS_KEYWDS
+{
+    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
+    int ret;
+    double mag;
+    static char *kwlist[] = {"star", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &star))
+        return NULL;
+    memset(st, 0, (SE_MAX_STNAME*2)+1);
+    strncpy(st, star, SE_MAX_STNAME*2);
+    ret = swe_fixstar2_mag(st, &mag, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.fixstar2_mag: %s", err);
+    return Py_BuildValue("ds", mag, st);
+}
+
+/* swisseph.fixstar2_ut */
+PyDoc_STRVAR(pyswe_fixstar2_ut__doc__,
+"Calculate fixed star positions (faster version) (UT).\n\n"
+":Args: str star, float tjdut, int flags=FLG_SWIEPH, out=None\n\n"
+" - star: name of fixed star to search for\n"
+" - tjdut: inputtime, Julian day nnumber, Universal Time\n"
+" - flags: bit flags indicating what kind of computation is wanted\n"
+" - out: optional writable buffer of 6 float64 to fill with the results\n\n"
+":Return: (xx), str stnam, int retflags\n\n"
+" - xx: Position, tuple of 6 float for results (omitted if out is given)\n"
+" - stnam: returned star name\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_fixstar2_ut FUNCARGS_KEYWDS
+{
+    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
+    double jd, xx[6];
+    int ret, flag = SEFLG_SWIEPH;
+    PyObject *out = Py_None;
+    static char *kwlist[] = {"star", "tjdut", "flags", "out", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|iO", kwlist,
+                                     &star, &jd, &flag, &out))
+        return NULL;
+    memset(st, 0, (SE_MAX_STNAME*2)+1);
+    strncpy(st, star, SE_MAX_STNAME*2);
+    ret = swe_fixstar2_ut(st, jd, flag, xx, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.fixstar2_ut: %s", err);
+    if (out != Py_None)
+        return pyswe_out_d(out, xx, 6, "fixstar2_ut") ? NULL
+            : Py_BuildValue("si", st, ret);
+    return Py_BuildValue("Nsi", pyswe_position(pyswe_get_state(self), xx), st,
+                         ret);
+}
+
+/* swisseph.fixstar_mag */
+PyDoc_STRVAR(pyswe_fixstar_mag__doc__,
+"Get fixed star magnitude.\n\n"
+":Args: str star\n\n"
+" - star: name of fixed star\n\n"
+":Return: float mag, str stnam\n\n"
+" - mag: returned magnitude\n"
+" - stnam: returned star name\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_fixstar_mag FUNCARGS_KEYWDS
+{
+    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
+    int ret;
+    double mag;
+    static char *kwlist[] = {"star", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &star))
+        return NULL;
+    memset(st, 0, (SE_MAX_STNAME*2)+1);
+    strncpy(st, star, SE_MAX_STNAME*2);
+    ret = swe_fixstar_mag(st, &mag, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.fixstar_mag: %s", err);
+    return Py_BuildValue("ds", mag, st);
+}
+
+/* swisseph.fixstar_ut */
+PyDoc_STRVAR(pyswe_fixstar_ut__doc__,
+"Calculate fixed star positions (UT).\n\n"
+":Args: str star, float tjdut, int flags=FLG_SWIEPH\n\n"
+" - star: name of fixed star to search for\n"
+" - tjdut: input time, Julian day number,  Universal Time\n"
+" - flags: bit flags indicating what kind of computation is wanted\n\n"
+":Return: (xx), str stnam, int retflags\n\n"
+" - xx: Position, tuple of 6 float for results\n"
+" - stnam: returned star name\n"
+" - retflags: bit flags indicating what kind of computation was done\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_fixstar_ut FUNCARGS_KEYWDS
+{
+    char *star, st[(SE_MAX_STNAME*2)+1], err[256] = {0};
+    double jd, xx[6];
+    int ret, flag = SEFLG_SWIEPH;
+    static char *kwlist[] = {"star", "tjdut", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sd|i", kwlist,
+                                     &star, &jd, &flag))
+        return NULL;
+    memset(st, 0, (SE_MAX_STNAME*2)+1);
+    strncpy(st, star, SE_MAX_STNAME*2);
+    ret = swe_fixstar_ut(st, jd, flag, xx, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.fixstar_ut: %s", err);
+    return Py_BuildValue("Nsi", pyswe_position(pyswe_get_state(self), xx), st,
+                         ret);
+}
+
+/* swisseph.gauquelin_sector */
+PyDoc_STRVAR(pyswe_gauquelin_sector__doc__,
+"Calculate Gauquelin sector position of a body (UT).\n\n"
+":Args: float tjdut, int or str body, int method, seq geopos,"
+" float atpress=0, float attemp=0, int flags=FLG_SWIEPH|FLG_TOPOCTR\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - body: planet number (int) or fixed star name (str)\n"
+" - method: number indicating which computation method is wanted:\n"
+"    - 0 with latitude\n"
+"    - 1 without latitude\n"
+"    - 2 from rising and setting times of the disc center of planet\n"
+"    - 3 from rising and setting times of disc center, incl. refraction\n"
+"    - 4 from rising and setting times of the disk edge of planet\n"
+"    - 5 from rising and setting times of disk edge, incl. refraction\n"
+" - geopos: a sequence containing:\n"
+"    - 0: geographic longitude, in degrees (eastern positive)\n"
+"    - 1: geographic latitude, in degrees (northern positive)\n"
+"    - 2: geographic altitude, in meters above sea level\n"
+" - atpress: atmospheric pressure (if 0, the default 1013.25 mbar is used)\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - flags: bit flags for ephemeris and FLG_TOPOCTR, etc\n\n"
+":Return: float sector\n\n"
+" - sector: [1;37[. Gauquelin sectors are numbered in clockwise direction.\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_gauquelin_sector FUNCARGS_KEYWDS
+{
+    double jd, geopos[3], ret, press = 0.0, temp = 0.0;
+    int i, pl, flag = SEFLG_SWIEPH|SEFLG_TOPOCTR, method;
+    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
+    PyObject *body, *seq;
+    static char *kwlist[] = {"tjdut", "body", "method", "geopos", "atpress",
+                             "attemp", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOiO|ddi", kwlist, &jd,
+                                   &body, &method, &seq, &press, &temp, &flag))
+        return NULL;
+    /* extract pl/star */
+    i = py_obj2plstar(body, &pl, &star);
+    if (i > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.gauquelin_sector: invalid body type");
+        return NULL;
+    }
+    if (star) {
+        memset(st, 0, (SE_MAX_STNAME*2)+1);
+        strncpy(st, star, SE_MAX_STNAME*2);
+    }
+    /* extract geopos */
+    i = py_seq2d(seq, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.gauquelin_sector: geopos: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_gauquelin_sector(jd, pl, st, flag, method,
+                             geopos, press, temp, &ret, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.gauquelin_sector: %s", err);
+    return Py_BuildValue("d", ret);
+}
+
+/* swisseph.get_ayanamsa */
+PyDoc_STRVAR(pyswe_get_ayanamsa__doc__,
+"Calculate ayanamsa (ET).\n\n"
+":Args: float tjdet\n\n"
+" - tjdet: input time, Julian day number, Ephemeris Time\n\n"
+":Return: float aya\n\n"
+" - aya: ayanamsa value, without nutation");
+
+static PyObject * pyswe_get_ayanamsa FUNCARGS_KEYWDS
+{
+    double jd;
+    static char *kwlist[] = {"tjdet", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
+        return NULL;
+    return Py_BuildValue("d", swe_get_ayanamsa(jd));
+}
+
+/* swisseph.get_ayanamsa_ex */
+PyDoc_STRVAR(pyswe_get_ayanamsa_ex__doc__,
+"Calculate ayanamsa, extended version (ET).\n\n"
+":Args: float tjdet, int flags\n\n"
+" - tjdet: input time, Julian day number, Ephemeris Time\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: int retflags, float aya\n\n"
+" - retflags: returned bit flags\n"
+" - aya: ayanamsa value\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_get_ayanamsa_ex FUNCARGS_KEYWDS
+{
+    int i, flags;
+    double jd, daya;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &flags))
+        return NULL;
+    i = swe_get_ayanamsa_ex(jd, flags, &daya, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.get_ayanamsa_ex: %s", err);
+    return Py_BuildValue("id", i, daya);
+}
+
+/* swisseph.get_ayanamsa_ex_ut */
+PyDoc_STRVAR(pyswe_get_ayanamsa_ex_ut__doc__,
+"Calculate ayanamsa, extended version (UT).\n\n"
+":Args: float tjdut, int flags\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: int retflags, float aya\n\n"
+" - retflags: returned bit flags\n"
+" - aya: ayanamsa value\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_get_ayanamsa_ex_ut FUNCARGS_KEYWDS
+{
+    int i, flags;
+    double jd, daya;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdut", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &jd, &flags))
+        return NULL;
+    i = swe_get_ayanamsa_ex_ut(jd, flags, &daya, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.get_ayanamsa_ex_ut: %s", err);
+    return Py_BuildValue("id", i, daya);
+}
+
+/* swisseph.get_ayanamsa_name */
+PyDoc_STRVAR(pyswe_get_ayanamsa_name__doc__,
+"Get ayanamsa name from sidereal mode constant.\n\n"
+":Args: int sidmode\n"
+":Return: str name\n\n"
+"If sidmode is not found (incorrect), returned string is empty.");
+
+static PyObject * pyswe_get_ayanamsa_name FUNCARGS_KEYWDS
+{
+    int mode;
+    char *name = NULL;
+    static char *kwlist[] = {"sidmode", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &mode))
+        return NULL;
+    name = (char*) swe_get_ayanamsa_name(mode);
+    return Py_BuildValue("s", name ? name : "");
+}
+
+/* swisseph.get_ayanamsa_ut */
+PyDoc_STRVAR(pyswe_get_ayanamsa_ut__doc__,
+"Calculate ayanamsa (UT).\n\n"
+":Args: float tjdut\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n\n"
+":Return: float aya\n\n"
+" - aya: ayanamsa value, without nutation");
+
+static PyObject * pyswe_get_ayanamsa_ut FUNCARGS_KEYWDS
+{
+    double jd;
+    static char *kwlist[] = {"tjdut", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
+        return NULL;
+    return Py_BuildValue("d", swe_get_ayanamsa_ut(jd));
+}
+
+/* swisseph.get_current_file_data */
+PyDoc_STRVAR(pyswe_get_current_file_data__doc__,
+"Find start and end date of an se1 ephemeris file after a function call.\n\n"
+":Args: int fno\n\n"
+" - fno: an integer indicating what type of file is searched:\n"
+"    - 0: planet file sepl_xxx, used for Sun etc, or jpl file\n"
+"    - 1: moon file semo_xxx\n"
+"    - 2: main asteroid file seas_xxx, if such an object was computed\n"
+"    - 3: other asteroid or planetary moon file, if such object was computed\n"
+"    - 4: star file\n\n"
+":Return: str path, float start, float end, int denum\n\n"
+" - path: full file path, or empty string if no data\n"
+" - start: start date of file\n"
+" - end: end date of file\n"
+" - denum: jpl ephemeris number 406 or 431 from which file was derived\n\n"
+"This can be used to find out the start and end date of an ``se1`` ephemeris"
+" file after a call of ``calc()``.\n\n"
+"The function returns data from internal file structures ``sweph.fidat`` used"
+" in the last call to ``calc()`` or ``fixstar()``. Data returned are"
+" (currently) 0 with JPL files and fixed star files. Thus, the function is"
+" only useful for ephemerides of planets or asteroids that are based on"
+" ``se1`` files.");
+
+static PyObject * pyswe_get_current_file_data FUNCARGS_KEYWDS
+{
+    int fno, denum = 0;
+    char* path = NULL;
+    double start = 0, end = 0;
+    static char* kwlist[] = {"fno", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &fno))
+        return NULL;
+    path = (char*) swe_get_current_file_data(fno, &start, &end, &denum);
+    return Py_BuildValue("sddi", path ? path : "", start, end, denum);
+}
+
+/* swisseph.get_library_path */
+PyDoc_STRVAR(pyswe_get_library_path__doc__,
+"Find the path of the executable or swisseph library (dll) actually in use.\n\n"
+":Args: --\n"
+":Return: str path\n\n"
+".. note::\n\n"
+"    This function may fail on Windows, and only find the executable path, not"
+" the dll.");
+
+static PyObject * pyswe_get_library_path FUNCARGS_SELF
+{
+    char buf[256];
+    memset(buf, 0, sizeof(char) * 256);
+    return Py_BuildValue("s", swe_get_library_path(buf));
+}
+
+/* swisseph.get_planet_name */
+PyDoc_STRVAR(pyswe_get_planet_name__doc__,
+"Get a planet or asteroid name.\n\n"
+":Args: int planet\n\n"
+" - planet: identifier of planet or object\n\n"
+":Return: str name\n\n"
+" - name: name found or empty string\n\n"
+"If an asteroid name is wanted, the function does the following:\n\n"
+"The name is first looked for in the asteroid ephemeris file.\n\n"
+"Because many asteroids, especially the ones with high catalogue numbers, have"
+" no names yet (or have only a preliminary designation like 1968 HB), and"
+" because the Minor Planet Center of the IAU add new names quite often, it"
+" happens that there is no name in the asteroid file although the asteroid"
+" has already been given a name.\n\n"
+"For this, we have the file ``seasnam.txt``, a file that contains a list of"
+" all named asteroid and is usually more up to date. If ``calc()`` finds a"
+" preliminary designation, it looks for a name in this file.\n\n"
+"The file ``seasnam.txt`` can be updated by the user. To do this, download the"
+" names list from the Minor Planet Center"
+" https://www.minorplanetcenter.net/iau/lists/MPNames.html,"
+" rename it as ``seasnam.txt`` and move it into your ephemeris directory.\n\n"
+"The file ``seasnam.txt`` need not be ordered in any way. There must be one"
+" asteroid per line, first its catalogue number, then its name. The asteroid"
+" number may or may not be in brackets.");
+
+static PyObject * pyswe_get_planet_name FUNCARGS_KEYWDS
+{
+    int pl;
+    char name[128], spl[128];
+    static char *kwlist[] = {"planet", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &pl))
+        return NULL;
+    snprintf(spl, 128, "%d", pl);
+    swe_get_planet_name(pl, name);
+    return Py_BuildValue("s",
+            !strcmp(name, spl) || strstr(name, "not found") ? "" : name);
+}
+
+/* swisseph.get_num_threads */
+PyDoc_STRVAR(pyswe_get_num_threads__doc__,
+"Get the number of threads of the batch functions.\n\n"
+":Args: --\n"
+":Return: int n");
+
+static PyObject * pyswe_get_num_threads FUNCARGS_SELF
+{
+    return PyLong_FromLong(pyswe_pool_size());
+}
+
+/* swisseph.get_orbital_elements */
+PyDoc_STRVAR(pyswe_get_orbital_elements__doc__,
+"Calculate osculating elements (Kepler elements) and orbital periods.\n\n"
+":Args: float tjdet, int planet, int flags\n\n"
+" - tjdet: input time, Julian day number, Ephemeris Time (TT)\n"
+" - planet: identifier of planet or object\n"
+" - flags: bit flags indicating what computation is wanted:\n"
+"    - ephemeris flag: FLG_JPLEPH, FLG_SWIEPH, FLG_MOSEPH, etc\n"
+"    - center:\n"
+"       - Sun: FLG_HELCTR (assumed as default) or\n"
+"       - SS Barycentre: FLG_BARYCTR (rel. to solar system barycentre)\n"
+"         Only possible for planets beyond Jupiter.\n"
+"         For elements of the Moon, the calculation is geocentric.\n"
+"    - sum all masses inside the orbit to be computed (method of\n"
+"      Astronomical Almanac): FLG_ORBEL_AA\n"
+"    - reference ecliptic: FLG_J2000\n\n"
+":Return: (elements)\n\n"
+" - elements: a tuple of 50 float, of which:\n"
+"    - 0: semimajor axis (a)\n"
+"    - 1: eccentricity (e)\n"
+"    - 2: inclination (in)\n"
+"    - 3: longitude of ascending node (upper-case omega OM)\n"
+"    - 4: argument of periapsis (lower-case omega om)\n"
+"    - 5: longitude of periapsis (peri)\n"
+"    - 6: mean anomaly at epoch (M0)\n"
+"    - 7: true anomaly at epoch (N0)\n"
+"    - 8: eccentric anomaly at epoch (E0)\n"
+"    - 9: mean longitude at epoch (LM)\n"
+"    - 10: sidereal orbital period in tropical years\n"
+"    - 11: mean daily motion\n"
+"    - 12: tropical period in years\n"
+"    - 13: synodic period in days, negative for inner planets or Moon\n"
+"    - 14: time of perihelion passage\n"
+"    - 15: perihelion distance\n"
+"    - 16: aphelion distance\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_get_orbital_elements FUNCARGS_KEYWDS
+{
+    int i, pl, flg;
+    double jd, dret[50];
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
+    if(!PyArg_ParseTupleAndKeywords(args, kwds, "dii", kwlist,
+                                    &jd, &pl, &flg))
+        return NULL;
+    memset(dret, 0, sizeof(double) * 50);
+    i = swe_get_orbital_elements(jd, pl, flg, dret, err);
+    if (i == 0)
+        return pyswe_dtuple(dret, 50);
+    return PyErr_Format(pyswe_error(self),
+                        "swisseph.get_orbital_elements: %s", err);
+}
+
+/* swisseph.get_tid_acc */
+PyDoc_STRVAR(pyswe_get_tid_acc__doc__,
+"Get current value of the tidal acceleration.\n\n"
+":Args: --\n"
+":Return: float tidacc");
+
+static PyObject * pyswe_get_tid_acc FUNCARGS_SELF
+{
+    return Py_BuildValue("d", swe_get_tid_acc());
+}
+
+/* swisseph.heliacal_pheno_ut */
+PyDoc_STRVAR(pyswe_heliacal_pheno_ut__doc__,
+"Provides data that are relevant for the calculation of heliacal risings and"
+" settings.\n\n"
+":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
+" int eventtype, int flags\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - 0: geographic longitude (eastern positive)\n"
+"    - 1: geographic latitude (northern positive)\n"
+"    - 2: altitude above sea level, in meters\n"
+" - atmo: a sequence with:\n"
+"    - 0: atmospheric pressure in mbar (hPa)\n"
+"    - 1: atmospheric temperature in degrees Celsius\n"
+"    - 2: relative humidity in %\n"
+"    - 3: if >= 1, Meteorological Range (km).\n"
+"      Between 1 and 0, total atmospheric coefficient (ktot).\n"
+"      If = 0, the other atmospheric parameters determine the total\n"
+"      atmospheric coefficient (ktot)\n"
+" - observer: a sequence with:\n"
+"    - 0: age of observer in years (default = 36)\n"
+"    - 1: snellen ratio of observers eyes (default = 1 = normal)\n"
+"    - The following parameters are only relevant if HELFLAG_OPTICAL_PARAMS\n"
+"      is set:\n"
+"    - 2: (0) = monocular, (1) = binocular (boolean)\n"
+"    - 3: telescope magnification, (0) = default to naked eye (binocular),\n"
+"      (1) = naked eye\n"
+"    - 4: optical aperture (telescope diameter) in mm\n"
+"    - 5: optical transmission\n"
+" - objname: name of planet or fixed star\n"
+" - eventtype: either:\n"
+"    - HELIACAL_RISING: morning first, for all visible planets and stars\n"
+"    - HELIACAL_SETTING: evening last, for all visible planets and stars\n"
+"    - EVENING_FIRST: evening first, for Mercury, Venus, Moon\n"
+"    - MORNING_LAST: morning last, for Mercury, Venus, Moon\n"
+" - flags: bit flags for ephemeris, and also:\n"
+"    - HELFLAG_OPTICAL_PARAMS: for optical instruments\n"
+"    - HELFLAG_NO_DETAILS: provide date, without details\n"
+"    - HELFLAG_VISLIM_DARK: behave as if Sun is at nadir\n"
+"    - HELFLAG_VISLIM_NOMOON: behave as if Moon is at nadir, i.e. the Moon as\n"
+"      a factor disturbing the observation is excluded, useful if one is not\n"
+"      interested in the heliacal date of that particular year, but in the\n"
+"      heliacal date of that epoch\n\n"
+":Return: (dret)\n\n"
+" - dret: HeliacalPheno, tuple of 50 float, of which:\n"
+"    - 0: AltO [deg] topocentric altitude of object (unrefracted)\n"
+"    - 1: AppAltO [deg] apparent altitude of object (refracted)\n"
+"    - 2: GeoAltO [deg] geocentric altitude of object\n"
+"    - 3: AziO [deg] azimuth of object\n"
+"    - 4: AltS [deg] topocentric altitude of Sun\n"
+"    - 5: AziS [deg] azimuth of Sun\n"
+"    - 6: TAVact [deg] actual topocentric arcus visionis\n"
+"    - 7: ARCVact [deg] actual (geocentric) arcus visionis\n"
+"    - 8: DAZact [deg] actual difference between object's and sun's azimuth\n"
+"    - 9: ARCLact [deg] actual longitude difference between object and sun\n"
+"    - 10: kact [-] extinction coefficient\n"
+"    - 11: minTAV [deg] smallest topocentric arcus visionis\n"
+"    - 12: TfistVR [JDN] first time object is visible, according to VR\n"
+"    - 13: TbVR [JDN] optimum time the object is visible, according to VR\n"
+"    - 14: TlastVR [JDN] last time object is visible, according to VR\n"
+"    - 15: TbYallop [JDN] best time the object is visible, according to Yallop\n"
+"    - 16: WMoon [deg] crescent width of Moon\n"
+"    - 17: qYal [-] q-test value of Yallop\n"
+"    - 18: qCrit [-] q-test criterion of Yallop\n"
+"    - 19: ParO [deg] parallax of object\n"
+"    - 20: Magn [-] magnitude of object\n"
+"    - 21: RiseO [JDN] rise/set time of object\n"
+"    - 22: RiseS [JDN] rise/set time of Sun\n"
+"    - 23: Lag [JDN] rise/set time of object minus rise/set time of Sun\n"
+"    - 24: TvisVR [JDN] visibility duration\n"
+"    - 25: LMoon [deg] crescent length of Moon\n"
+"    - 26: CVAact [deg]\n"
+"    - 27: Illum [%] new\n"
+"    - 28: CVAact [deg] new\n"
+"    - 29: MSk [-]\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_heliacal_pheno_ut FUNCARGS_KEYWDS
+{
+    double jd, geopos[3], atmo[4], observ[6], dret[50];
+    char err[256] = {0}, *obj;
+    int i, evnt, flg;
+    PyObject *o1, *o2, *o3;
+    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
+                             "eventtype", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsii", kwlist, &jd,
+                                     &o1, &o2, &o3, &obj, &evnt, &flg))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(o1, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.heliacal_pheno_ut: geopos: %s", err);
+    /* extract atmospheric */
+    i = py_seq2d(o2, 4, atmo, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.heliacal_pheno_ut: atmo: %s", err);
+    /* extract observer */
+    i = py_seq2d(o3, 6, observ, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                              "swisseph.heliacal_pheno_ut: observer: %s", err);
+    /* set topo params */
+    if (flg & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    memset(dret, 0, sizeof(double) * 50);
+    i = swe_heliacal_pheno_ut(jd, geopos, atmo, observ, obj, evnt,
+                              flg, dret, err);
+    if (i == 0)
+        return pyswe_fill_d(PyStructSequence_New(
+            pyswe_get_state(self)->heliacal_pheno_type), 0, dret, 50);
+    return PyErr_Format(pyswe_error(self),
+                        "swisseph.heliacal_pheno_ut: %s", err);
+}
+
+/* swisseph.heliacal_ut */
+PyDoc_STRVAR(pyswe_heliacal_ut__doc__,
+"Find the Julian day of the next heliacal phenomenon.\n\n"
+":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
+" int eventtype, int flags\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - 0: geographic longitude (eastern positive)\n"
+"    - 1: geographic latitude (northern positive)\n"
+"    - 2: altitude above sea level, in meters\n"
+" - atmo: a sequence with:\n"
+"    - 0: atmospheric pressure in mbar (hPa)\n"
+"    - 1: atmospheric temperature in degrees Celsius\n"
+"    - 2: relative humidity in %\n"
+"    - 3: if >= 1, Meteorological Range (km).\n"
+"      Between 1 and 0, total atmospheric coefficient (ktot).\n"
+"      If = 0, the other atmospheric parameters determine the total\n"
+"      atmospheric coefficient (ktot)\n"
+" - observer: a sequence with:\n"
+"    - 0: age of observer in years (default = 36)\n"
+"    - 1: snellen ratio of observers eyes (default = 1 = normal)\n"
+"    - The following parameters are only relevant if HELFLAG_OPTICAL_PARAMS\n"
+"      is set:\n"
+"    - 2: (0) = monocular, (1) = binocular (boolean)\n"
+"    - 3: telescope magnification, (0) = default to naked eye (binocular),\n"
+"      (1) = naked eye\n"
+"    - 4: optical aperture (telescope diameter) in mm\n"
+"    - 5: optical transmission\n"
+" - objname: name of planet or fixed star\n"
+" - eventtype: either:\n"
+"    - HELIACAL_RISING: morning first, for all visible planets and stars\n"
+"    - HELIACAL_SETTING: evening last, for all visible planets and stars\n"
+"    - EVENING_FIRST: evening first, for Mercury, Venus, Moon\n"
+"    - MORNING_LAST: morning last, for Mercury, Venus, Moon\n"
+" - flags: bit flags for ephemeris, and also:\n"
+"    - HELFLAG_OPTICAL_PARAMS: for optical instruments\n"
+"    - HELFLAG_NO_DETAILS: provide date, without details\n"
+"    - HELFLAG_VISLIM_DARK: behave as if Sun is at nadir\n"
+"    - HELFLAG_VISLIM_NOMOON: behave as if Moon is at nadir, i.e. the Moon as\n"
+"      a factor disturbing the observation is excluded, useful if one is not\n"
+"      interested in the heliacal date of that particular year, but in the\n"
+"      heliacal date of that epoch\n\n"
+":Return: (dret)\n\n"
+" - dret: tuple of 3 Julian days:\n"
+"    - 0: start visibility\n"
+"    - 1: optimum visibility, 0 if flags >= HELFLAG_AV\n"
+"    - 2: end of visibility, 0 if flags >= HELFLAG_AV\n\n"
+"It works between geographic latitudes 60s - 60n.\n\n"
+"Default values for ``atmo``: If this is too much for you, set all these"
+" values to 0. The software will then set the following defaults: Pressure"
+" 1013.25, temperature 15, relative humidity 40. The values will be modified"
+" depending on the altitude of the observer above sea level. If the extinction"
+" coefficient (meteorological range) ``datm[3]`` is 0, the software will"
+" calculate its value from ``datm[0..2]``.\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_heliacal_ut FUNCARGS_KEYWDS
+{
+    double jd, geopos[3], atmo[4], observ[6], dret[50];
+    char err[256] = {0}, *obj;
+    int i, evnt, flg;
+    PyObject *o1, *o2, *o3;
+    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
+                             "eventtype", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsii", kwlist,
+                                     &jd, &o1, &o2, &o3, &obj, &evnt, &flg))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(o1, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.heliacal_ut: geopos: %s", err);
+    /* extract atmospheric */
+    i = py_seq2d(o2, 4, atmo, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.heliacal_ut: atmo: %s", err);
+    /* extract observer */
+    i = py_seq2d(o3, 6, observ, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.heliacal_ut: observer: %s", err);
+    /* set topo params */
+    if (flg & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_heliacal_ut(jd, geopos, atmo, observ, obj,
+                        evnt, flg, dret, err);
+    if (i == 0)
+        return Py_BuildValue("ddd", dret[0], dret[1], dret[2]);
+    return PyErr_Format(pyswe_error(self), "swisseph.heliacal_ut: %s", err);
+}
+
+/* swisseph.helio_cross */
+PyDoc_STRVAR(pyswe_helio_cross__doc__,
+"Compute a planet heliocentric crossing over some longitude (ET).\n\n"
+":Args: int planet, float x2cross, float tjdet, int flags=FLG_SWIEPH,"
+" bool backwards=False\n\n"
+" - planet: planet number\n"
+" - x2cross: longitude to search\n"
+" - tjdet: start time of search, as Julian day number, Ephemeris Time\n"
+" - flags: bit flags indicating what computation is wanted\n"
+" - backwards: a boolean indicating if we search back in time\n\n"
+":Return: float jdcross\n\n"
+" - jdcross: Julian day found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_helio_cross FUNCARGS_KEYWDS
+{
+    int pl, flags = SEFLG_SWIEPH, backw = 0;
+    double x2, jd, jdcross;
+    char err[256] = {0};
+    static char* kwlist[] = {"planet", "x2cross", "tjdet", "flags",
+                             "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "idd|ii", kwlist,
+                                     &pl, &x2, &jd, &flags, &backw))
+        return NULL;
+    backw = backw ? -1 : 1;
+    if (swe_helio_cross(pl, x2, jd, flags, backw, &jdcross, err))
+        return PyErr_Format(pyswe_error(self), "swisseph.helio_cross: %s", err);
+    return Py_BuildValue("d", jdcross);
+}
+
+/* swisseph.helio_cross_ut */
+PyDoc_STRVAR(pyswe_helio_cross_ut__doc__,
+"Compute a planet heliocentric crossing over some longitude (UT).\n\n"
+":Args: int planet, float x2cross, float tjdut, int flags=FLG_SWIEPH,"
+" bool backwards=False\n\n"
+" - planet: planet number\n"
+" - x2cross: longitude to search\n"
+" - tjdut: start time of search, as Julian day number, Universal Time\n"
+" - flags: bit flags indicating what computation is wanted\n"
+" - backwards: a boolean indicating if we search back in time\n\n"
+":Return: float jdcross\n\n"
+" - jdcross: Julian day found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_helio_cross_ut FUNCARGS_KEYWDS
+{
+    int pl, flags = SEFLG_SWIEPH, backw = 0;
+    double x2, jd, jdcross;
+    char err[256] = {0};
+    static char* kwlist[] = {"planet", "x2cross", "tjdut", "flags",
+                             "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "idd|ii", kwlist,
+                                     &pl, &x2, &jd, &flags, &backw))
+        return NULL;
+    backw = backw ? -1 : 1;
+    if (swe_helio_cross_ut(pl, x2, jd, flags, backw, &jdcross, err))
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.helio_cross_ut: %s", err);
+    return Py_BuildValue("d", jdcross);
+}
+
+/* swisseph.house_name */
+PyDoc_STRVAR(pyswe_house_name__doc__,
+"Get the name of a house method.\n\n"
+":Args: bytes hsys\n\n"
+" - hsys: house system identifier (1 byte)\n\n"
+":Return: str hsysname\n\n"
+" - hsysname: house system name, empty string if not found");
+
+static PyObject * pyswe_house_name FUNCARGS_KEYWDS
+{
+    char h, *nam;
+    static char *kwlist[] = {"hsys", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "c", kwlist, &h))
+        return NULL;
+    if (h != 'i')
+        h = toupper(h);
+    nam = (char*) swe_house_name(h);
+    return Py_BuildValue("s", h != 'P' && !strcmp(nam, "Placidus") ? "" : nam);
+}
+
+/* swisseph.house_pos */
+PyDoc_STRVAR(pyswe_house_pos__doc__,
+"Calculate house position of a body.\n\n"
+":Args: float armc, float geolat, float eps, seq objcoord,"
+" bytes hsys=b'P'\n\n"
+" - armc: ARMC\n"
+" - geolat: geographic latitude, in degrees (northern positive)\n"
+" - eps: obliquity, in degrees\n"
+" - objcoord: a sequence for ecl. longitude and latitude of the planet,\n"
+"   in degrees\n"
+" - hsys: house method identifier (1 byte)\n\n"
+":Return: float hpos\n\n"
+" - hpos: value in [1:13[ (Gauquelin: [1:37[) indicating the house position\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_house_pos FUNCARGS_KEYWDS
+{
+    double armc, lat, obl, res, obj[2] = {0.0, 0.0};
+    int i, hsys = 'P';
+    char err[256] = {0};
+    PyObject* coord;
+    static char *kwlist[] = {"armc", "geolat", "eps", "objcoord", "hsys", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dddO|c", kwlist,
+                                     &armc, &lat, &obl, &coord, &hsys))
+        return NULL;
+    /* extract coord */
+    i = py_seq2d(coord, 2, obj, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.house_pos: objcoord: %s", err);
+    res = swe_house_pos(armc, lat, obl, hsys, obj, err);
+    if (res < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.house_pos: %s", err);
+    return Py_BuildValue("d", res);
+}
+
+/* Build the Houses result of the houses functions */
+static PyObject * pyswe_houses_result(pyswe_State* st, int hsys,
+                                      const double* cusps,
+                                      const double* ascmc)
+{
+    PyObject* o = PyStructSequence_New(st->houses_type);
+    if (!o)
+        return NULL;
+    PyStructSequence_SET_ITEM(o, 0, pyswe_dtuple(cusps + 1,
+                                                 hsys == 71 ? 36 : 12));
+    PyStructSequence_SET_ITEM(o, 1, pyswe_fill_d(
+        PyStructSequence_New(st->ascmc_type), 0, ascmc, 8));
+    if (!PyStructSequence_GET_ITEM(o, 0) || !PyStructSequence_GET_ITEM(o, 1)) {
+        Py_DECREF(o);
+        return NULL;
+    }
+    return o;
+}
+
+/* Build the HousesSpeed result of the houses functions */
+static PyObject * pyswe_houses_ex2_result(pyswe_State* st, int hsys,
+                                          const double* cusps,
+                                          const double* ascmc,
+                                          const double* cuspspeed,
+                                          const double* ascmcspeed)
+{
+    int i, n = hsys == 71 ? 36 : 12; /* Gauquelin sectors */
+    PyObject* o = PyStructSequence_New(st->houses_speed_type);
+    if (!o)
+        return NULL;
+    PyStructSequence_SET_ITEM(o, 0, pyswe_dtuple(cusps + 1, n));
+    PyStructSequence_SET_ITEM(o, 1, pyswe_fill_d(
+        PyStructSequence_New(st->ascmc_type), 0, ascmc, 8));
+    PyStructSequence_SET_ITEM(o, 2, pyswe_dtuple(cuspspeed + 1, n));
+    PyStructSequence_SET_ITEM(o, 3, pyswe_fill_d(
+        PyStructSequence_New(st->ascmc_type), 0, ascmcspeed, 8));
+    for (i = 0; i < 4; ++i) {
+        if (!PyStructSequence_GET_ITEM(o, i)) {
+            Py_DECREF(o);
+            return NULL;
+        }
+    }
+    return o;
+}
+
+/* swisseph.houses */
+PyDoc_STRVAR(pyswe_houses__doc__,
+"Calculate houses cusps (UT).\n\n"
+":Args: float tjdut, float lat, float lon, bytes hsys=b'P'\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - lon: geographic longitude, in degrees (eastern positive)\n"
+" - hsys: house method identifier (1 byte)\n\n"
+":Return: Houses (cusps), (ascmc)\n\n"
+" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
+" - ascmc: Ascmc, tuple of 8 float for additional points\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+/* Compute and build the result of houses, after parsing */
+static PyObject * pyswe_houses_impl(PyObject* self, double jd, double lat,
+                                    double lon, int hsys)
+{
+    double cusps[37], ascmc[10];
+    if (swe_houses(jd, lat, lon, hsys, cusps, ascmc) < 0) {
+        PyErr_SetString(pyswe_error(self), "swisseph.houses: error");
+        return NULL;
+    }
+    return pyswe_houses_result(pyswe_get_state(self), hsys, cusps, ascmc);
+}
+
+static PyObject * pyswe_houses FUNCARGS_KEYWDS
+{
+    double jd, lat, lon;
+    int hsys = 'P';
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|c", kwlist,
+                                     &jd, &lat, &lon, &hsys))
+        return NULL;
+    return pyswe_houses_impl(self, jd, lat, lon, hsys);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_houses_fast FUNCARGS_FAST
+{
+    PyObject *a[4];
+    double jd, lat, lon;
+    int hsys = 'P';
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_d(a[0], &jd) || pyswe_fast_d(a[1], &lat)
+        || pyswe_fast_d(a[2], &lon) || (a[3] && pyswe_fast_c(a[3], &hsys)))
+        return pyswe_fast_fallback(pyswe_houses, self, args, nargs, kwnames);
+    return pyswe_houses_impl(self, jd, lat, lon, hsys);
+}
+#endif
+
+/* swisseph.houses_armc */
+PyDoc_STRVAR(pyswe_houses_armc__doc__,
+"Calculate houses cusps with ARMC.\n\n"
+":Args: float armc, float lat, float eps, bytes hsys=b'P',"
+" float ascmc9=0.0\n\n"
+" - armc: ARMC\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - eps: obliquity, in degrees\n"
+" - hsys: house method identifier (1 byte)\n"
+" - ascmc9: optional parameter for Sunshine house system\n\n"
+":Return: Houses (cusps), (ascmc)\n\n"
+" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
+" - ascmc: Ascmc, tuple of 8 float for additional points\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+/* Compute and build the result of houses_armc, after parsing */
+static PyObject * pyswe_houses_armc_impl(PyObject* self, double armc,
+                                         double lat, double obl, int hsys,
+                                         double ascmc9)
+{
+    double cusps[37], ascmc[10];
+    ascmc[9] = ascmc9; /* sunshine hsys */
+    if (swe_houses_armc(armc, lat, obl, hsys, cusps, ascmc) < 0) {
+        PyErr_SetString(pyswe_error(self), "swisseph.houses_armc: error");
+        return NULL;
+    }
+    return pyswe_houses_result(pyswe_get_state(self), hsys, cusps, ascmc);
+}
+
+static PyObject * pyswe_houses_armc FUNCARGS_KEYWDS
+{
+    double armc, lat, obl, ascmc9 = 0;
+    int hsys = 'P';
+    static char *kwlist[] = {"armc", "lat", "eps", "hsys", "ascmc9", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|cd", kwlist,
+                                     &armc, &lat, &obl, &hsys, &ascmc9))
+        return NULL;
+    return pyswe_houses_armc_impl(self, armc, lat, obl, hsys, ascmc9);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_houses_armc_fast FUNCARGS_FAST
+{
+    PyObject *a[5];
+    double armc, lat, obl, ascmc9 = 0;
+    int hsys = 'P';
+    static char *kwlist[] = {"armc", "lat", "eps", "hsys", "ascmc9", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_d(a[0], &armc) || pyswe_fast_d(a[1], &lat)
+        || pyswe_fast_d(a[2], &obl) || (a[3] && pyswe_fast_c(a[3], &hsys))
+        || (a[4] && pyswe_fast_d(a[4], &ascmc9)))
+        return pyswe_fast_fallback(pyswe_houses_armc, self, args, nargs,
+                                   kwnames);
+    return pyswe_houses_armc_impl(self, armc, lat, obl, hsys, ascmc9);
+}
+#endif
+
+/* swisseph.houses_armc_ex2 */
+PyDoc_STRVAR(pyswe_houses_armc_ex2__doc__,
+"Calculate houses cusps and their speeds with ARMC.\n\n"
+":Args: float armc, float lat, float eps, bytes hsys=b'P',"
+" float ascmc9=0.0\n\n"
+" - armc: ARMC\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - eps: obliquity, in degrees\n"
+" - hsys: house method identifier (1 byte)\n"
+" - ascmc9: optional parameter for Sunshine house system\n\n"
+":Return: HousesSpeed (cusps), (ascmc), (cuspsspeed),"
+" (ascmcspeed)\n\n"
+" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
+" - ascmc: Ascmc, tuple of 8 float for additional points\n"
+" - cuspsspeed: tuple of 12 float for cusps speeds\n"
+" - ascmcspeed: Ascmc, tuple of 8 float for speeds of additional"
+" points\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+/* Compute and build the result of houses_armc_ex2, after parsing */
+static PyObject * pyswe_houses_armc_ex2_impl(PyObject* self, double armc,
+                                             double lat, double obl, int hsys,
+                                             double ascmc9)
+{
+    double cusps[37], ascmc[10], cuspspeed[37], ascmcspeed[10];
+    char err[256] = {0};
+    ascmc[9] = ascmc9; /* sunshine hsys */
+    if (swe_houses_armc_ex2(armc, lat, obl, hsys, cusps, ascmc,
+                            cuspspeed, ascmcspeed, err) < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.houses_armc_ex2: %s", err);
+    return pyswe_houses_ex2_result(pyswe_get_state(self), hsys, cusps, ascmc,
+                                   cuspspeed, ascmcspeed);
+}
+
+static PyObject * pyswe_houses_armc_ex2 FUNCARGS_KEYWDS
+{
+    double armc, lat, obl, ascmc9 = 0;
+    int hsys = 'P';
+    static char *kwlist[] = {"armc", "lat", "eps", "hsys", "ascmc9", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|cd", kwlist,
+                                     &armc, &lat, &obl, &hsys, &ascmc9))
+        return NULL;
+    return pyswe_houses_armc_ex2_impl(self, armc, lat, obl, hsys, ascmc9);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_houses_armc_ex2_fast FUNCARGS_FAST
+{
+    PyObject *a[5];
+    double armc, lat, obl, ascmc9 = 0;
+    int hsys = 'P';
+    static char *kwlist[] = {"armc", "lat", "eps", "hsys", "ascmc9", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_d(a[0], &armc) || pyswe_fast_d(a[1], &lat)
+        || pyswe_fast_d(a[2], &obl) || (a[3] && pyswe_fast_c(a[3], &hsys))
+        || (a[4] && pyswe_fast_d(a[4], &ascmc9)))
+        return pyswe_fast_fallback(pyswe_houses_armc_ex2, self, args, nargs,
+                                   kwnames);
+    return pyswe_houses_armc_ex2_impl(self, armc, lat, obl, hsys, ascmc9);
+}
+#endif
+
+/* swisseph.houses_array */
+PyDoc_STRVAR(pyswe_houses_array__doc__,
+"Calculate houses cusps for many dates (UT).\n\n"
+":Args: seq tjdut, float lat, float lon, bytes hsys=b'P', int flags=0,"
+" str errors='raise', list errlist=None\n\n"
+" - tjdut: julian day numbers, universal time, as a sequence or a buffer of"
+" float64\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - lon: geographic longitude, in degrees (eastern positive)\n"
+" - hsys: house method identifier (1 byte)\n"
+" - flags: ephemeris flag, etc\n"
+" - errors: policy for the dates in error (see calc_ut_array), libswe"
+" computes Porphyry houses when the method fails (polar circles)\n"
+" - errlist: list where (index, message) of the dates in error are"
+" appended, if errors is not 'raise'\n\n"
+":Return: cusps, ascmc, status\n\n"
+" - cusps: memoryview of float64 of shape (n, 12) (Gauquelin: (n, 36))\n"
+" - ascmc: memoryview of float64 of shape (n, 8), additional points\n"
+" - status: memoryview of int32 of shape (n,), 0 or -1 (ERR)\n\n"
+"Dates are computed in parallel by the thread pool (see set_num_threads), and"
+" results are in the order of the dates.");
+
+typedef struct {
+    const double* jd;
+    double lat;
+    double lon;
+    int hsys;
+    int flag;
+    int ncusps;
+    double* cusps;
+    double* ascmc;
+    int* status;
+} pyswe_HousesArray;
+
+static void pyswe_houses_array_run(pyswe_Job* job, Py_ssize_t start,
+                                   Py_ssize_t end)
+{
+    pyswe_HousesArray* a = (pyswe_HousesArray*) job->data;
+    double cusps[37], ascmc[10];
+    Py_ssize_t i;
+    for (i = start; i < end; ++i) {
+        a->status[i] = swe_houses_ex(a->jd[i], a->flag, a->lat, a->lon,
+                                     a->hsys, cusps, ascmc);
+        if (a->status[i] < 0)
+            pyswe_job_error(job, i, "error");
+        memcpy(a->cusps + i * a->ncusps, cusps + 1,
+               a->ncusps * sizeof(double));
+        memcpy(a->ascmc + i * 8, ascmc, 8 * sizeof(double));
+    }
+}
+
+static PyObject * pyswe_houses_array FUNCARGS_KEYWDS
+{
+    pyswe_HousesArray a;
+    pyswe_DArray jd;
+    pyswe_Job job;
+    PyObject *seq, *cusps = NULL, *ascmc = NULL, *status = NULL;
+    PyObject* errlist = NULL;
+    char hsys = 'P', *errors = "raise";
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags",
+                             "errors", "errlist", NULL};
+    a.flag = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Odd|cisO", kwlist, &seq,
+                                     &a.lat, &a.lon, &hsys, &a.flag, &errors,
+                                     &errlist)
+        || pyswe_job_policy(&job, errors, errlist, "houses_array"))
+        return NULL;
+    a.hsys = hsys;
+    a.ncusps = hsys == 'G' ? 36 : 12; /* Gauquelin sectors */
+    if (pyswe_darray_get(seq, &jd, "houses_array", "tjdut"))
+        return NULL;
+    if (!(cusps = pyswe_results_new(jd.n, a.ncusps, sizeof(double),
+                                    (void**) &a.cusps))
+        || !(ascmc = pyswe_results_new(jd.n, 8, sizeof(double),
+                                       (void**) &a.ascmc))
+        || !(status = pyswe_results_new(jd.n, 1, sizeof(int),
+                                        (void**) &a.status))) {
+        pyswe_darray_release(&jd);
+        Py_XDECREF(cusps);
+        Py_XDECREF(ascmc);
+        return NULL;
+    }
+    a.jd = jd.d;
+    job.func = pyswe_houses_array_run;
+    job.data = &a;
+    job.n = jd.n;
+    job.chunk = 16;
+    pyswe_pool_run(&job);
+    pyswe_darray_release(&jd);
+    if (pyswe_job_errors(&job, pyswe_error(self), "houses_array", errlist)) {
+        Py_DECREF(cusps);
+        Py_DECREF(ascmc);
+        Py_DECREF(status);
+        return NULL;
+    }
+    if (job.errors == PYSWE_ERRORS_NAN) {
+        pyswe_results_nan(a.cusps, a.ncusps, a.status, jd.n);
+        pyswe_results_nan(a.ascmc, 8, a.status, jd.n);
+    }
+    return Py_BuildValue("NNN", pyswe_results_view(cusps, "d", jd.n, a.ncusps),
+                         pyswe_results_view(ascmc, "d", jd.n, 8),
+                         pyswe_results_view(status, "i", jd.n, 0));
+}
+
+/* swisseph.houses_ex */
+PyDoc_STRVAR(pyswe_houses_ex__doc__,
+"Calculate houses cusps (extended) (UT).\n\n"
+":Args: float tjdut, float lat, float lon, bytes hsys=b'P', int flags=0\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - lon: geographic longitude, in degrees (eastern positive)\n"
+" - hsys: house method identifier (1 byte)\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: Houses (cusps), (ascmc)\n\n"
+" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
+" - ascmc: Ascmc, tuple of 8 float for additional points\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+/* Compute and build the result of houses_ex, after parsing */
+static PyObject * pyswe_houses_ex_impl(PyObject* self, double jd, double lat,
+                                       double lon, int hsys, int flag)
+{
+    double cusps[37], ascmc[10];
+    if (swe_houses_ex(jd, flag, lat, lon, hsys, cusps, ascmc) < 0) {
+        PyErr_SetString(pyswe_error(self), "swisseph.houses_ex: error");
+        return NULL;
+    }
+    return pyswe_houses_result(pyswe_get_state(self), hsys, cusps, ascmc);
+}
+
+static PyObject * pyswe_houses_ex FUNCARGS_KEYWDS
+{
+    double jd, lat, lon;
+    int hsys = 'P', flag = 0;
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|ci", kwlist,
+                                     &jd, &lat, &lon, &hsys, &flag))
+        return NULL;
+    return pyswe_houses_ex_impl(self, jd, lat, lon, hsys, flag);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_houses_ex_fast FUNCARGS_FAST
+{
+    PyObject *a[5];
+    double jd, lat, lon;
+    int hsys = 'P', flag = 0;
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_d(a[0], &jd) || pyswe_fast_d(a[1], &lat)
+        || pyswe_fast_d(a[2], &lon) || (a[3] && pyswe_fast_c(a[3], &hsys))
+        || (a[4] && pyswe_fast_i(a[4], &flag)))
+        return pyswe_fast_fallback(pyswe_houses_ex, self, args, nargs,
+                                   kwnames);
+    return pyswe_houses_ex_impl(self, jd, lat, lon, hsys, flag);
+}
+#endif
+
+/* swisseph.houses_ex2 */
+PyDoc_STRVAR(pyswe_houses_ex2__doc__,
+"Calculate houses cusps and cusps speeds (UT).\n\n"
+":Args: float tjdut, float lat, float lon, bytes hsys=b'P', int flags=0\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - lon: geographic longitude, in degrees (eastern positive)\n"
+" - hsys: house method identifier (1 byte)\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: HousesSpeed (cusps), (ascmc), (cuspsspeed),"
+" (ascmcspeed)\n\n"
+" - cusps: tuple of 12 float for cusps (except Gauquelin: 36 float)\n"
+" - ascmc: Ascmc, tuple of 8 float for additional points\n"
+" - cuspsspeed: tuple of 12 float for cusps speeds\n"
+" - ascmcspeed: Ascmc, tuple of 8 float for speeds of additional"
+" points\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+/* Compute and build the result of houses_ex2, after parsing */
+static PyObject * pyswe_houses_ex2_impl(PyObject* self, double jd, double lat,
+                                        double lon, int hsys, int flag)
+{
+    double cusps[37], ascmc[10], cuspspeed[37], ascmcspeed[10];
+    char err[256] = {0};
+    if (swe_houses_ex2(jd, flag, lat, lon, hsys, cusps, ascmc,
+                       cuspspeed, ascmcspeed, err) < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.houses_ex2: %s", err);
+    return pyswe_houses_ex2_result(pyswe_get_state(self), hsys, cusps, ascmc,
+                                   cuspspeed, ascmcspeed);
+}
+
+static PyObject * pyswe_houses_ex2 FUNCARGS_KEYWDS
+{
+    double jd, lat, lon;
+    int hsys = 'P', flag = 0;
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd|ci", kwlist,
+                                     &jd, &lat, &lon, &hsys, &flag))
+        return NULL;
+    return pyswe_houses_ex2_impl(self, jd, lat, lon, hsys, flag);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_houses_ex2_fast FUNCARGS_FAST
+{
+    PyObject *a[5];
+    double jd, lat, lon;
+    int hsys = 'P', flag = 0;
+    static char *kwlist[] = {"tjdut", "lat", "lon", "hsys", "flags", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_d(a[0], &jd) || pyswe_fast_d(a[1], &lat)
+        || pyswe_fast_d(a[2], &lon) || (a[3] && pyswe_fast_c(a[3], &hsys))
+        || (a[4] && pyswe_fast_i(a[4], &flag)))
+        return pyswe_fast_fallback(pyswe_houses_ex2, self, args, nargs,
+                                   kwnames);
+    return pyswe_houses_ex2_impl(self, jd, lat, lon, hsys, flag);
+}
+#endif
+
+/* swisseph.io_cache_stats */
+PyDoc_STRVAR(pyswe_io_cache_stats__doc__,
+"Get the hits and misses of the segment cache of libswe.\n\n"
+":Args: bool reset=False\n\n"
+" - reset: set the counters to zero after reading them\n\n"
+":Return: dict\n\n"
+" - calls: number of calls of calc, calc_ut and calc_pctr (and the array"
+" functions using them) computed with the Swiss or JPL ephemeris\n"
+" - hits: number of these calls that read no segment of coefficients\n"
+" - misses: number of these calls that read at least one segment\n"
+" - untracked: number of ephemeris files opened but not counted in"
+" ``io_stats()`` (out of memory)\n\n"
+"Libswe keeps the segment of coefficients last used of each body (per"
+" thread), a call that needs another one reads it from the file. Other"
+" functions reading ephemeris files (houses, eclipses...) are not counted"
+" here, but their reads are in ``io_stats()``. See ``io_stats()`` for the"
+" availability.");
+
+static PyObject * pyswe_io_cache_stats FUNCARGS_KEYWDS
+{
+    int reset = 0;
+    unsigned long long calls = 0, hits = 0, untracked = 0;
+    static char *kwlist[] = {"reset", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+        return NULL;
+#if PYSWE_USE_IO_STATS
+    pyswe_lock(&pyswe_io_lock);
+    calls = pyswe_io_calls;
+    hits = pyswe_io_hits;
+    untracked = pyswe_io_untracked;
+    if (reset)
+        pyswe_io_calls = pyswe_io_hits = pyswe_io_untracked = 0;
+    pyswe_unlock(&pyswe_io_lock);
+#endif
+    return Py_BuildValue("{s:K,s:K,s:K,s:K}", "calls", calls, "hits", hits,
+                         "misses", calls - hits, "untracked", untracked);
+}
+
+/* swisseph.io_stats */
+PyDoc_STRVAR(pyswe_io_stats__doc__,
+"Get ephemeris file I/O statistics.\n\n"
+":Args: bool reset=False\n\n"
+" - reset: set the counters to zero after reading them\n\n"
+":Return: dict\n\n"
+"The dict maps the paths of the ephemeris files opened so far to dicts of:\n\n"
+" - kind: 'planet', 'moon', 'asteroid', 'fixstar', 'jpl' or 'other'\n"
+" - opens: number of times the file was opened\n"
+" - reads: number of reads (fread and fgets calls)\n"
+" - bytes: number of bytes read\n"
+" - seeks: number of seeks (fseek calls), libswe seeks to the header and the"
+" index of a file when it opens it, and to each segment of coefficients it"
+" reads\n"
+" - segments: number of reads following a seek, these are the segments of"
+" coefficients not found in the cache of libswe (cache misses), plus a few"
+" header reads per open\n"
+" - time: time spent in opening, reading and seeking, in seconds\n\n"
+"All files opened by libswe are counted, in all threads, unless memory runs"
+" out (see ``io_cache_stats()``). Counting is available when pyswisseph is"
+" built with its bundled libswe and ``PYSWE_USE_IO_STATS`` (Linux by"
+" default). Otherwise the dict is always empty.");
+
+static PyObject * pyswe_io_stats FUNCARGS_KEYWDS
+{
+    int reset = 0;
+    PyObject* res;
+#if PYSWE_USE_IO_STATS
+    int i, n;
+    PyObject* d;
+    pyswe_IOFile f;
+#endif
+    static char *kwlist[] = {"reset", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset))
+        return NULL;
+    if (!(res = PyDict_New()))
+        return NULL;
+#if PYSWE_USE_IO_STATS
+    /* copy each file, the lock is not held while building the dict, files
+     * are never removed */
+    pyswe_lock(&pyswe_io_lock);
+    n = pyswe_io_nfiles;
+    pyswe_unlock(&pyswe_io_lock);
+    for (i = 0; i < n; ++i) {
+        pyswe_lock(&pyswe_io_lock);
+        f = *pyswe_io_files[i];
+        if (reset) {
+            pyswe_io_files[i]->opens = pyswe_io_files[i]->reads = 0;
+            pyswe_io_files[i]->bytes = pyswe_io_files[i]->seeks = 0;
+            pyswe_io_files[i]->segments = pyswe_io_files[i]->ns = 0;
+        }
+        pyswe_unlock(&pyswe_io_lock);
+        d = Py_BuildValue("{s:s,s:K,s:K,s:K,s:K,s:K,s:d}",
+                          "kind", pyswe_io_kinds[f.kind], "opens", f.opens,
+                          "reads", f.reads, "bytes", f.bytes,
+                          "seeks", f.seeks, "segments", f.segments,
+                          "time", f.ns * 1e-9);
+        if (!d || PyDict_SetItemString(res, f.path, d)) {
+            Py_XDECREF(d);
+            Py_DECREF(res);
+            return NULL;
+        }
+        Py_DECREF(d);
+    }
+#endif
+    return res;
+}
+
+/* swisseph.jdet_to_utc */
+PyDoc_STRVAR(pyswe_jdet_to_utc__doc__,
+"Convert ET Julian day number to UTC.\n\n"
+":Args: float tjdet, int cal=GREG_CAL\n\n"
+" - tjdet: Julian day number in ET (TT)\n"
+" - cal: calendar flag, either GREG_CAL or JUL_CAL\n\n"
+":Return: int year, int month, int day, int hour, int mins, float secs\n\n"
+" - year, month, day: returned date\n"
+" - hour, mins, secs: returned time\n\n"
+"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+
+static PyObject * pyswe_jdet_to_utc FUNCARGS_KEYWDS
+{
+    int y, m, d, h, mi, flg = SE_GREG_CAL;
+    double s, et;
+    static char *kwlist[] = {"tjdet", "cal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &et, &flg))
+        return NULL;
+    if (flg != SE_GREG_CAL && flg != SE_JUL_CAL)
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.jdet_to_utc: invalid calendar (%d)", flg);
+    swe_jdet_to_utc(et, flg, &y, &m, &d, &h, &mi, &s);
+    return Py_BuildValue("iiiiid", y, m, d, h, mi, s);
+}
+
+/* swisseph.jdut1_to_utc */
+PyDoc_STRVAR(pyswe_jdut1_to_utc__doc__,
+"Convert UT1 Julian day number to UTC.\n\n"
+":Args: float tjdut, int cal=GREG_CAL\n\n"
+" - tjdut: Julian day number, in UT (UT1)\n"
+" - cal: either GREG_CAL or JUL_CAL\n\n"
+":Return: int year, int month, int day, int hour, int mins, float secs\n\n"
+" - year, month, day: returned date\n"
+" - hour, mins, secs: returned time\n\n"
+"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+
+static PyObject * pyswe_jdut1_to_utc FUNCARGS_KEYWDS
+{
+    int y, m, d, h, mi, flg = SE_GREG_CAL;
+    double s, ut;
+    static char *kwlist[] = {"tjdut", "cal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &ut, &flg))
+        return NULL;
+    if (flg != SE_GREG_CAL && flg != SE_JUL_CAL)
+        return PyErr_Format(PyExc_ValueError,
+                           "swisseph.jdut1_to_utc: invalid calendar (%d)", flg);
+    swe_jdut1_to_utc(ut, flg, &y, &m, &d, &h, &mi, &s);
+    return Py_BuildValue("iiiiid", y, m, d, h, mi, s);
+}
+
+/* swisseph.julday */
+PyDoc_STRVAR(pyswe_julday__doc__,
+"Calculate a Julian day number.\n\n"
+":Args: int year, int month, int day, float hour=12.0, int cal=GREG_CAL\n\n"
+" - year, month, day: the date\n"
+" - hour: the time of day, decimal with fraction\n"
+" - cal: either GREG_CAL (gregorian) or JUL_CAL (julian)\n\n"
+":Return: float jd\n\n"
+"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+
+/* Compute the result of julday, after parsing */
+static PyObject * pyswe_julday_impl(int year, int month, int day, double hour,
+                                    int cal)
+{
+    if (cal != SE_GREG_CAL && cal != SE_JUL_CAL)
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.julday: invalid calendar (%d)", cal);
+    return PyFloat_FromDouble(swe_julday(year, month, day, hour, cal));
+}
+
+static PyObject * pyswe_julday FUNCARGS_KEYWDS
+{
+    int year, month, day;
+    double hour = 12.0;
+    int cal = SE_GREG_CAL;
+    static char *kwlist[] = {"year", "month", "day", "hour", "cal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iii|di", kwlist,
+                                     &year, &month, &day, &hour, &cal))
+        return NULL;
+    return pyswe_julday_impl(year, month, day, hour, cal);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_julday_fast FUNCARGS_FAST
+{
+    PyObject *a[5];
+    int year, month, day, cal = SE_GREG_CAL;
+    double hour = 12.0;
+    static char *kwlist[] = {"year", "month", "day", "hour", "cal", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 3, a)
+        || pyswe_fast_i(a[0], &year) || pyswe_fast_i(a[1], &month)
+        || pyswe_fast_i(a[2], &day) || (a[3] && pyswe_fast_d(a[3], &hour))
+        || (a[4] && pyswe_fast_i(a[4], &cal)))
+        return pyswe_fast_fallback(pyswe_julday, self, args, nargs, kwnames);
+    return pyswe_julday_impl(year, month, day, hour, cal);
+}
+#endif
+
+/* swisseph.lat_to_lmt */
+PyDoc_STRVAR(pyswe_lat_to_lmt__doc__,
+"Translate local apparent time (LAT) to local mean time (LMT).\n\n"
+":Args: float tjdlat, float geolon\n\n"
+" - tjdlat: Julian day number, local apparent time\n"
+" - geolon: geographic longitude, in degrees (eastern positive)\n\n"
+":Return: float tjdlmt\n\n"
+" - tjdlmt: returned Julian day number, local mean time\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_lat_to_lmt FUNCARGS_KEYWDS
+{
+    int i;
+    double jd, lon, ret;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdlat", "geolon" , NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &jd, &lon))
+        return NULL;
+    i = swe_lat_to_lmt(jd, lon, &ret, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.lat_to_lmt: %s", err);
+    return Py_BuildValue("d", ret);
+}
+
+/* swisseph.lmt_to_lat */
+PyDoc_STRVAR(pyswe_lmt_to_lat__doc__,
+"Translate local mean time (LMT) to local apparent time (LAT).\n\n"
+":Args: float tjdlmt, float geolon\n\n"
+" - tjdlmt: Julian day number, local mean time\n"
+" - geolon: geographic longitude, in degrees (eastern positive)\n\n"
+":Return: float tjdlat\n\n"
+" - tjdlat: returned Julian day number, local apparent time\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_lmt_to_lat FUNCARGS_KEYWDS
+{
+    int i;
+    double jd, lon, ret;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdlmt", "geolon" , NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &jd, &lon))
+        return NULL;
+    i = swe_lmt_to_lat(jd, lon, &ret, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.lmt_to_lat: %s", err);
+    return Py_BuildValue("d", ret);
+}
+
+/* swisseph.lun_eclipse_how */
+PyDoc_STRVAR(pyswe_lun_eclipse_how__doc__,
+"Calculate attributes of a lunar eclipse (UTC).\n\n"
+":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - geographic longitude, in degrees (eastern positive)\n"
+"    - geographic latitude, in degrees (northern positive)\n"
+"    - geographic altitude above sea level, in meters\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: int retflag, (attr)\n\n"
+" - retflag: returned bit flags:\n"
+"    - 0 if there is no eclipse\n"
+"    - SE_ECL_TOTAL or ECL_PENUMBRAL or ECL_PARTIAL\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: umbral magnitude at tjd\n"
+"    - 1: penumbral magnitude\n"
+"    - 2: ?\n"
+"    - 3: ?\n"
+"    - 4: azimuth of moon at tjd\n"
+"    - 5: true altitude of moon above horizon at tjd\n"
+"    - 6: apparent altitude of moon above horizon at tjd\n"
+"    - 7: distance of moon from opposition in degrees\n"
+"    - 8: eclipse magnitude (equals attr[0])\n"
+"    - 9: saros series number (if available, otherwise -99999999)\n"
+"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_lun_eclipse_how FUNCARGS_KEYWDS
+{
+    double jd, geopos[3];
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    int i, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    PyObject *gp;
+    static char *kwlist[] = {"tjdut", "geopos", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|i", kwlist,
+                                     &jd, &gp, &flag))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.lun_eclipse_how: geopos: %s", err);
+    /* setting topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_lun_eclipse_how(jd, flag, geopos, attr, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.lun_eclipse_how: %s", err);
+    return Py_BuildValue("iN", i, pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.lun_eclipse_when */
+PyDoc_STRVAR(pyswe_lun_eclipse_when__doc__,
+"Find the next lunar eclipse globally (UT).\n\n"
+":Args: float tjdut, int flags=FLG_SWIEPH, int ecltype=0, bool backwards=False\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - flags: ephemeris flag\n"
+" - ecltype: bit flags for eclipse type wanted:\n"
+"    - ECL_TOTAL ECL_PARTIAL ECL_PENUMBRAL\n"
+"    - ECL_ALLTYPES_LUNAR or 0 for any type\n"
+" - backwards: boolean, set to True to search back in time\n\n"
+":Return: int retflag, (tret)\n\n"
+" - retflag: returned bit flag:\n"
+"    - ECL_TOTAL ECL_PARTIAL ECL_PENUMBRAL\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: time of maximum eclipse\n"
+"    - 1: ?\n"
+"    - 2: time of partial phase begin (indices consistent with solar eclipses)\n"
+"    - 3: time of partial phase end\n"
+"    - 4: time of totality begin\n"
+"    - 5: time of totality end\n"
+"    - 6: time of penumbral phase begin\n"
+"    - 7: time of penumbral phase end\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_lun_eclipse_when FUNCARGS_KEYWDS
+{
+    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    int i, ecltype = 0, backw = 0, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdut", "flags", "ecltype", "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|iii", kwlist,
+                                     &jd, &flag, &ecltype, &backw))
+        return NULL;
+    i = swe_lun_eclipse_when(jd, flag, ecltype, tret, backw, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.lun_eclipse_when: %s", err);
+    return Py_BuildValue("iN", i, pyswe_dtuple(tret, 10));
+}
+
+/* swisseph.lun_eclipse_when_loc */
+PyDoc_STRVAR(pyswe_lun_eclipse_when_loc__doc__,
+"Find the next lunar eclipse observable from a given geographic position (UT).\n\n"
+":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH, bool backwards=False\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - geographic longitude, in degrees (eastern positive)\n"
+"    - geographic latitude, in degrees (northern positive)\n"
+"    - geographic altitude, in meters above sea level\n"
+" - flags: ephemeris flag, etc\n"
+" - backwards: boolean, set to True to search back in time\n\n"
+":Return: int retflag, (tret), (attr)\n\n"
+" - retflag: returned bit flags:\n"
+"    - ECL_TOTAL or ECL_PENUMBRAL or ECL_PARTIAL\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: time of maximum eclipse\n"
+"    - 1: ?\n"
+"    - 2: time of partial phase begin (indices consistent with solar eclipses)\n"
+"    - 3: time of partial phase end\n"
+"    - 4: time of totality begin\n"
+"    - 5: time of totality end\n"
+"    - 6: time of penumbral phase begin (eclipse begin)\n"
+"    - 7: time of penumbral phase end (eclipse end)\n"
+"    - 8: time of moonrise, if it occurs during the eclipse\n"
+"    - 9: time of moonset, if it occurs during the eclipse\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: umbral magnitude at tjd\n"
+"    - 1: penumbral magnitude\n"
+"    - 2: ?\n"
+"    - 3: ?\n"
+"    - 4: azimuth of moon at tjd\n"
+"    - 5: true altitude of moon above horizon at tjd\n"
+"    - 6: apparent altitude of moon above horizon at tjd\n"
+"    - 7: distance of moon from opposition in degrees (separation angle)\n"
+"    - 8: umbral magnitude at tjd (equals attr[0])\n"
+"    - 9: saros series number (if available; otherwise -99999999)\n"
+"    - 10: saros series member number (if available; otherwise -99999999)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_lun_eclipse_when_loc FUNCARGS_KEYWDS
+{
+    double jd, geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    int i, k, backw = 0, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    PyObject *gp;
+    static char *kwlist[] = {"tjdut", "geopos", "flags", "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|ii", kwlist,
+                                     &jd, &gp, &flag, &backw))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                            "swisseph.lun_eclipse_when_loc: geopos: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_lun_eclipse_when_loc(jd, flag, geopos, tret, attr, backw, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.lun_eclipse_when_loc: %s", err);
+    /* attr[10] is repeated in the last slots */
+    for (k = 11; k < 20; ++k)
+        attr[k] = attr[10];
+    return Py_BuildValue("iNN", i, pyswe_dtuple(tret, 10),
+                         pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.lun_occult_when_glob */
+PyDoc_STRVAR(pyswe_lun_occult_when_glob__doc__,
+"Find the next occultation of a planet or star by the moon globally (UT).\n\n"
+":Args: float tjdut, int or str body, int flags=FLG_SWIEPH, int ecltype=0,"
+" bool backwards=False\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - body: planet identifier (int) or star name (str)\n"
+" - flags: ephemeris flag, eventually ECL_ONE_TRY, etc\n"
+" - ecltype: bit flags for eclipse type wanted:\n"
+"    - ECL_CENTRAL ECL_NONCENTRAL ECL_TOTAL ECL_ANNULAR ECL_PARTIAL\n"
+"    - ECL_ANNULAR_TOTAL (equals ECL_HYBRID)\n"
+"    - 0 for any type\n"
+" - backwards: boolean, set to True to search back in time\n\n"
+":Return: int retflags, (tret)\n\n"
+" - retflags: returned bit flags:\n"
+"    - 0 if no occultation or eclipse found\n"
+"    - ECL_TOTAL or ECL_ANNULAR or ECL_PARTIAL or ECL_ANNULAR_TOTAL"
+"    - ECL_CENTRAL\n"
+"    - ECL_NONCENTRAL\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: time of maximum occultation/eclipse\n"
+"    - 1: time when occultation takes place at local apparent noon\n"
+"    - 2: time of occultation begin\n"
+"    - 3: time of occultation end\n"
+"    - 4: time of of totality begin\n"
+"    - 5: time of totality end\n"
+"    - 6: time of center line begin\n"
+"    - 7: time of center line end\n"
+"    - 8: time when annular-total occultation becomes total\n"
+"    - 9: time when annular-total occultation becomes annular again\n\n"
+"This function raises swisseph.Error in case of fatal error.\n\n"
+"If you want to have only one conjunction of the moon with the body tested,"
+" add the following flag: ECL_ONE_TRY. If this flag is not set, the function"
+" will search for an occultation until it finds one. For bodies with"
+" ecliptical latitudes > 5, the function may search successlessly until it"
+" reaches the end of the ephemeris.");
+
+static PyObject * pyswe_lun_occult_when_glob FUNCARGS_KEYWDS
+{
+    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    int i, pl, ecltype = 0, backw = 0, flag = SEFLG_SWIEPH;
+    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
+    PyObject *body;
+    static char *kwlist[] = {"tjdut", "body", "flags", "ecltype",
+                             "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|iii", kwlist,
+                                     &jd, &body, &flag, &ecltype, &backw))
+        return NULL;
+    /* extract pl/star */
+    i = py_obj2plstar(body, &pl, &star);
+    if (i > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.lun_occult_when_glob: invalid body type");
+        return NULL;
+    }
+    if (star) {
+        memset(st, 0, (SE_MAX_STNAME*2)+1);
+        strncpy(st, star, SE_MAX_STNAME*2);
+    }
+    i = swe_lun_occult_when_glob(jd, pl, st, flag, ecltype, tret, backw, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.lun_occult_when_glob: %s", err);
+    return Py_BuildValue("iN", i, pyswe_dtuple(tret, 10));
+}
+
+/* swisseph.lun_occult_when_loc */
+PyDoc_STRVAR(pyswe_lun_occult_when_loc__doc__,
+"Find next occultation of a planet or star by the moon for a given geographic"
+" position (UT).\n\n"
+":Args: float tjdut, int or str body, seq geopos, int flags=FLG_SWIEPH,"
+" bool backwards=False\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - body: planet identifier (int) or star name (str)\n"
+" - geopos: a sequence with:\n"
+"    - geographic longitude, in degrees (eastern positive)\n"
+"    - geographic latitude, in degrees (northern positive)\n"
+"    - geographic altitude above sea level, in meters\n"
+" - flags: ephemeris flag, eventually ECL_ONE_TRY, etc\n"
+" - backwards: boolean, set to True for search back in time\n\n"
+":Return: int retflags, (tret), (attr)\n\n"
+" - retflags: returned bit flags:\n"
+"    - 0 if no occultation or eclipse found\n"
+"    - ECL_TOTAL or ECL_ANNULAR or ECL_PARTIAL,\n"
+"    - ECL_VISIBLE, ECL_MAX_VISIBLE, ECL_1ST_VISIBLE, ECL_2ND_VISIBLE,\n"
+"      ECL_3RD_VISIBLE, ECL_4TH_VISIBLE\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: time of maximum occultation\n"
+"    - 1: time of first contact\n"
+"    - 2: time of second contact\n"
+"    - 3: time of third contact\n"
+"    - 4: time of fourth contact\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: fraction of planet diameter covered by moon (magnitude)\n"
+"    - 1: ratio of lunar diameter to planet one\n"
+"    - 2: fraction of planet disc covered by moon (obscuration)\n"
+"    - 3: diameter of core shadow in km\n"
+"    - 4: azimuth of planet at tjd\n"
+"    - 5: true altitude of planet above horizon at tjd\n"
+"    - 6: apparent altitude of planet above horizon at tjd\n"
+"    - 7: elongation of moon in degrees (separation angle)\n\n"
+"This function raises swisseph.Error in case of fatal error.\n\n"
+"If you want to have only one conjunction of the moon with the body tested,"
+" add the following flag: ECL_ONE_TRY. If this flag is not set, the function"
+" will search for an occultation until it finds one. For bodies with"
+" ecliptical latitudes > 5, the function may search successlessly until it"
+" reaches the end of the ephemeris.");
+
+static PyObject * pyswe_lun_occult_when_loc FUNCARGS_KEYWDS
+{
+    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    double geopos[3];
+    int i, pl, backw = 0, flag = SEFLG_SWIEPH;
+    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
+    PyObject *body, *gp;
+    static char *kwlist[] = {"tjdut", "body", "geopos", "flags",
+                             "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOO|ii", kwlist,
+                                     &jd, &body, &gp, &flag, &backw))
+        return NULL;
+    /* extract pl/star */
+    i = py_obj2plstar(body, &pl, &star);
+    if (i > 0) {
+        PyErr_SetString(PyExc_TypeError,
+            "swisseph.lun_occult_when_loc: invalid body type");
+        return NULL;
+    }
+    if (star) {
+        memset(st, 0, (SE_MAX_STNAME*2)+1);
+        strncpy(st, star, SE_MAX_STNAME*2);
+    }
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                            "swisseph.lun_occult_when_loc: geopos: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_lun_occult_when_loc(jd, pl, st, flag, geopos, tret,
+                                attr, backw, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.lun_occult_when_loc: %s", err);
+    /* fixes seen in perl extension */
+    if (attr[0] > 1) attr[0] = 1;
+    if (attr[2] > 1) attr[2] = 1;
+    return Py_BuildValue("iNN", i, pyswe_dtuple(tret, 10),
+                         pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.lun_occult_where */
+PyDoc_STRVAR(pyswe_lun_occult_where__doc__,
+"Find where a lunar occultation is central or maximal (UT).\n\n"
+":Args: float tjdut, int or str body, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - body: planet identifier (int) or star name (str)\n"
+" - flags: ephemeris flag\n\n"
+":Return: int retflags, (geopos), (attr)\n\n"
+" - retflags: returned bit flags:\n"
+"    - 0 if there is no occultation at tjd\n"
+"    - ECL_TOTAL\n"
+"    - ECL_ANNULAR\n"
+"    - ECL_TOTAL | ECL_CENTRAL\n"
+"    - ECL_TOTAL | ECL_NONCENTRAL\n"
+"    - ECL_ANNULAR | ECL_CENTRAL\n"
+"    - ECL_ANNULAR | ECL_NONCENTRAL\n"
+"    - ECL_PARTIAL\n"
+" - geopos: tuple of 10 float, of which:\n"
+"    - 0: geographic longitude of central line\n"
+"    - 1: geographic latitude of central line\n"
+"    - 2: geographic longitude of northern limit of umbra\n"
+"    - 3: geographic latitude of northern limit of umbra\n"
+"    - 4: geographic longitude of southern limit of umbra\n"
+"    - 5: geographic latitude of southern limit of umbra\n"
+"    - 6: geographic longitude of northern limit of penumbra\n"
+"    - 7: geographic latitude of northern limit of penumbra\n"
+"    - 8: geographic longitude of southern limit of penumbra\n"
+"    - 9: geographic latitude of southern limit of penumbra\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: fraction of object's diameter covered by moon (magnitude)\n"
+"    - 1: ratio of lunar diameter to object's diameter\n"
+"    - 2: fraction of object's disc covered by moon (obscuration)\n"
+"    - 3: diameter of core shadow in km\n"
+"    - 4: azimuth of object at tjd\n"
+"    - 5: true altitude of object above horizon at tjd\n"
+"    - 6: apparent altitude of object above horizon at tjd\n"
+"    - 7: angular distance of moon from object in degrees\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_lun_occult_where FUNCARGS_KEYWDS
+{
+    double jd, geopos[10] = {0,0,0,0,0,0,0,0,0,0};
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    int i, pl = 0, flag = SEFLG_SWIEPH;
+    char *star = NULL, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
+    PyObject *body;
+    static char *kwlist[] = {"tjdut", "body", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|i", kwlist,
+                                     &jd, &body, &flag))
+        return NULL;
+    /* extract pl/star */
+    i = py_obj2plstar(body, &pl, &star);
+    if (i > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.lun_occult_where: invalid body type");
+        return NULL;
+    }
+    if (star) {
+        memset(st, 0, (SE_MAX_STNAME*2)+1);
+        strncpy(st, star, SE_MAX_STNAME*2);
+    }
+    i = swe_lun_occult_where(jd, pl, st, flag, geopos, attr, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.lun_occult_where: %s", err);
+    return Py_BuildValue("iNN", i, pyswe_dtuple(geopos, 10),
+                         pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.mooncross */
+PyDoc_STRVAR(pyswe_mooncross__doc__,
+"Compute Moon crossing over some longitude (ET).\n\n"
+":Args: float x2cross, float tjdet, int flags=FLG_SWIEPH\n\n"
+" - x2cross: longitude to search\n"
+" - tjdet: start time of search, Julian day number, Ephemeris Time\n"
+" - flags: bit flags indicating what computation is wanted\n\n"
+":Return: float jd_cross\n\n"
+" - jd_cross: Julian day number found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_mooncross FUNCARGS_KEYWDS
+{
+    int flags = SEFLG_SWIEPH;
+    double x2, jd, res;
+    char err[256] = {0};
+    static char* kwlist[] = {"x2cross", "tjdet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
+                                     &x2, &jd, &flags))
+        return NULL;
+    if ((res = swe_mooncross(x2, jd, flags, err)) < jd)
+        return PyErr_Format(pyswe_error(self), "mooncross: %s", err);
+    return Py_BuildValue("d", res);
+}
+
+/* swisseph.mooncross_node */
+PyDoc_STRVAR(pyswe_mooncross_node__doc__,
+"Compute next Moon crossing over node, by finding zero latitude crossing (ET).\n\n"
+":Args: float tjdet, int flags=FLG_SWIEPH\n\n"
+" - tjdet: start time of search, Julian day number, Ephemeris Time\n"
+" - flags: bit flags indicating what computation is wanted\n\n"
+":Return: float jd_cross, xlon, xlat\n\n"
+" - jd_cross: Julian day number found\n"
+" - xlon: Moon longitude found\n"
+" - xlat: Moon latitude found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_mooncross_node FUNCARGS_KEYWDS
+{
+    int flags = SEFLG_SWIEPH;
+    double jd, xlon, xlat, res;
+    char err[256] = {0};
+    static char* kwlist[] = {"tjdet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &flags))
+        return NULL;
+    if ((res = swe_mooncross_node(jd, flags, &xlon, &xlat, err)) < jd)
+        return PyErr_Format(pyswe_error(self), "mooncross_node: %s", err);
+    return Py_BuildValue("ddd", res, xlon, xlat);
+}
+
+/* swisseph.mooncross_node_ut */
+PyDoc_STRVAR(pyswe_mooncross_node_ut__doc__,
+"Compute next Moon crossing over node, by finding zero latitude crossing (UT).\n\n"
+":Args: float tjdut, int flags=FLG_SWIEPH\n\n"
+" - tjdut: start time of search, Julian day number, Universal Time\n"
+" - flags: bit flags indicating what computation is wanted\n\n"
+":Return: float jd_cross, xlon, xlat\n\n"
+" - jd_cross: Julian day number found\n"
+" - xlon: Moon longitude found\n"
+" - xlat: Moon latitude found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_mooncross_node_ut FUNCARGS_KEYWDS
+{
+    int flags = SEFLG_SWIEPH;
+    double jd, xlon, xlat, res;
+    char err[256] = {0};
+    static char* kwlist[] = {"tjdut", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &flags))
+        return NULL;
+    if ((res = swe_mooncross_node(jd, flags, &xlon, &xlat, err)) < jd)
+        return PyErr_Format(pyswe_error(self), "mooncross_node: %s", err);
+    return Py_BuildValue("ddd", res, xlon, xlat);
+}
+
+/* swisseph.mooncross_ut */
+PyDoc_STRVAR(pyswe_mooncross_ut__doc__,
+"Compute Moon crossing over some longitude (UT).\n\n"
+":Args: float x2cross, float tjdut, int flags=FLG_SWIEPH\n\n"
+" - x2cross: longitude to search\n"
+" - tjdut: start time of search, Julian day number, Universal Time\n"
+" - flags: bit flags indicating what computation is wanted\n\n"
+":Return: float jd_cross\n\n"
+" - jd_cross: Julian day number found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_mooncross_ut FUNCARGS_KEYWDS
+{
+    int flags = SEFLG_SWIEPH;
+    double x2, jd, res;
+    char err[256] = {0};
+    static char* kwlist[] = {"x2cross", "tjdut", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
+                                     &x2, &jd, &flags))
+        return NULL;
+    if ((res = swe_mooncross_ut(x2, jd, flags, err)) < jd)
+        return PyErr_Format(pyswe_error(self), "mooncross_ut: %s", err);
+    return Py_BuildValue("d", res);
+}
+
+/* swisseph.nod_aps */
+PyDoc_STRVAR(pyswe_nod_aps__doc__,
+"Calculate planetary nodes and apsides (ET).\n\n"
+":Args: float tjdet, int planet, int method=NODBIT_MEAN, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
+" - tjdet: input time, Julian day number, Ephemeris Time\n"
+" - planet: identifer of planet or object\n"
+" - method: bit flags NODBIT_MEAN, NODBIT_OSCU, NODBIT_OSCU_BAR, NODBIT_FOPOINT\n"
+" - flags: bit flags indicating what type of computation is wanted\n\n"
+":Return: (xnasc)(xndsc)(xperi)(xaphe)\n\n"
+" - xnasc: Position for ascending node\n"
+" - xndsc: Position for descending node\n"
+" - xperi: Position for perihelion\n"
+" - xaphe: Position for aphelion\n\n"
+"This function can raise swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_nod_aps FUNCARGS_KEYWDS
+{
+    char err[256] = {0};
+    double jd, xasc[6], xdsc[6], xper[6], xaph[6];
+    int ret, planet, method = SE_NODBIT_MEAN, flags = SEFLG_SWIEPH|SEFLG_SPEED;
+    pyswe_State* st;
+    static char *kwlist[] = {"tjdet", "planet", "method", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|ii", kwlist,
+                                     &jd, &planet, &method, &flags))
+        return NULL;
+    ret = swe_nod_aps(jd, planet, flags, method, xasc, xdsc, xper, xaph, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.nod_aps: %s", err);
+    st = pyswe_get_state(self);
+    return Py_BuildValue("NNNN", pyswe_position(st, xasc),
+        pyswe_position(st, xdsc), pyswe_position(st, xper),
+        pyswe_position(st, xaph));
+}
+
+/* swisseph.nod_aps_ut */
+PyDoc_STRVAR(pyswe_nod_aps_ut__doc__,
+"Calculate planetary nodes and apsides (UT).\n\n"
+":Args: float tjdut, int planet, int method=NODBIT_MEAN, int flags=FLG_SWIEPH|FLG_SPEED\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - planet: identifer of planet or object\n"
+" - method: bit flags NODBIT_MEAN, NODBIT_OSCU, NODBIT_OSCU_BAR, NODBIT_FOPOINT\n"
+" - flags: bit flags indicating what type of computation is wanted\n\n"
+":Return: (xnasc)(xndsc)(xperi)(xaphe)\n\n"
+" - xnasc: Position for ascending node\n"
+" - xndsc: Position for descending node\n"
+" - xperi: Position for perihelion\n"
+" - xaphe: Position for aphelion\n\n"
+"This function can raise swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_nod_aps_ut FUNCARGS_KEYWDS
+{
+    char err[256] = {0};
+    double jd, xasc[6], xdsc[6], xper[6], xaph[6];
+    int ret, planet, method = SE_NODBIT_MEAN, flags = SEFLG_SWIEPH|SEFLG_SPEED;
+    pyswe_State* st;
+    static char *kwlist[] = {"tjdut", "planet", "method", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|ii", kwlist,
+                                     &jd, &planet, &method, &flags))
+        return NULL;
+    ret = swe_nod_aps_ut(jd, planet, flags, method, xasc, xdsc, xper, xaph, err);
+    if (ret < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.nod_aps_ut: %s", err);
+    st = pyswe_get_state(self);
+    return Py_BuildValue("NNNN", pyswe_position(st, xasc),
+        pyswe_position(st, xdsc), pyswe_position(st, xper),
+        pyswe_position(st, xaph));
+}
+
+/* swisseph.orbit_max_min_true_distance */
+PyDoc_STRVAR(pyswe_orbit_max_min_true_distance__doc__,
+"Calculate the maximum possible distance, the minimum possible distance, and"
+" the current true distance of planet, the EMB, or an asteroid.\n\n"
+":Args: float tjdet, int planet, int flags\n\n"
+" - tjdet: input time, Julian day number, Ephemeris Time\n"
+" - planet: identifier of planet or object\n"
+" - flags: bit flags indicating what computation is wanted:\n"
+"    - ephemeris flag\n"
+"    - optional heliocentric flag FLG_HELIOCTR\n\n"
+":Return: float max_dist, float min_dist, float true_dist\n\n"
+" - max_dist: maximum distance\n"
+" - min_dist: minimum_distance\n"
+" - true_dist: true distance");
+
+static PyObject * pyswe_orbit_max_min_true_distance FUNCARGS_KEYWDS
+{
+    int pl, flg, i;
+    double jd, dmax, dmin, dtrue;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dii", kwlist,
+                                     &jd, &pl, &flg))
+        return NULL;
+    i = swe_orbit_max_min_true_distance(jd, pl, flg, &dmax, &dmin, &dtrue, err);
+    if (i == 0)
+        return Py_BuildValue("ddd", dmax, dmin, dtrue);
+    return PyErr_Format(pyswe_error(self),
+                        "swisseph.orbit_max_min_true_distance: %s", err);
+}
+
+/* swisseph.pheno */
+PyDoc_STRVAR(pyswe_pheno__doc__,
+"Calculate planetary phenomena (ET).\n\n"
+":Args: float tjdet, int planet, int flags=FLG_SWIEPH\n\n"
+" - tjdet: input time, Julian day number, Ephemeris Time\n"
+" - planet: object identifier\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: (attr)\n\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: phase angle (earth-planet-sun)\n"
+"    - 1: phase (illuminated fraction of disc)\n"
+"    - 2: elongation of planet\n"
+"    - 3: apparent diameter of disc\n"
+"    - 4: apparent magnitude\n"
+"    - 5: geocentric horizontal parallax (Moon)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_pheno FUNCARGS_KEYWDS
+{
+    double jd, attr[20];
+    int i, pl, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdet", "planet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|i", kwlist,
+                                     &jd, &pl, &flag))
+        return NULL;
+    i = swe_pheno(jd, pl, flag, attr, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.pheno: %s", err);
+    return pyswe_dtuple(attr, 20);
+}
+
+/* swisseph.pheno_ut */
+PyDoc_STRVAR(pyswe_pheno_ut__doc__,
+"Calculate planetary phenomena (UT).\n\n"
+":Args: float tjdut, int planet, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - planet: object identifier\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: (attr)\n\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: phase angle (earth-planet-sun)\n"
+"    - 1: phase (illuminated fraction of disc)\n"
+"    - 2: elongation of planet\n"
+"    - 3: apparent diameter of disc\n"
+"    - 4: apparent magnitude\n"
+"    - 5: geocentric horizontal parallax (Moon)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_pheno_ut FUNCARGS_KEYWDS
+{
+    double jd, attr[20];
+    int i, pl, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdut", "planet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di|i", kwlist,
+                                     &jd, &pl, &flag))
+        return NULL;
+    i = swe_pheno_ut(jd, pl, flag, attr, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.pheno_ut: %s", err);
+    return pyswe_dtuple(attr, 20);
+}
+
+/* swisseph.rad_midp */
+PyDoc_STRVAR(pyswe_rad_midp__doc__,
+"Calculate midpoint (in radians).\n\n"
+"Args: float x, float y\n"
+"Return: float");
+
+static PyObject * pyswe_rad_midp FUNCARGS_KEYWDS
+{
+    double x, y;
+    static char *kwlist[] = {"x", "y", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd", kwlist, &x, &y))
+        return NULL;
+    return Py_BuildValue("d", swe_rad_midp(x, y));
+}
+
+/* swisseph.radnorm */
+PyDoc_STRVAR(pyswe_radnorm__doc__,
+"Normalization of any radian number to the range [0;2*pi].\n\n"
+"Args: float x\n"
+"Return: float");
+
+static PyObject * pyswe_radnorm FUNCARGS_KEYWDS
+{
+    double x;
+    static char *kwlist[] = {"x", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &x))
+        return NULL;
+    return Py_BuildValue("d", swe_radnorm(x));
+}
+
+/* swisseph.refrac */
+PyDoc_STRVAR(pyswe_refrac__doc__,
+"Calculate true altitude from apparent altitude, or vice-versa.\n\n"
+":Args: float alt, float atpress, float attemp, int flag\n\n"
+" - alt: altitude of object above geometric horizon in degrees,\n"
+"   where geometric horizon = plane perpendicular to gravity\n"
+" - atpress: atmospheric pressure in mbar (hPa)\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - flag: either TRUE_TO_APP or APP_TO_TRUE\n\n"
+":Return: float retalt\n\n"
+" - retalt: converted altitude");
+
+static PyObject * pyswe_refrac FUNCARGS_KEYWDS
+{
+    double alt, press, temp;
+    int flag;
+    static char *kwlist[] = {"alt", "atpress", "attemp", "flag", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dddi", kwlist, &alt,
+                                     &press, &temp, &flag))
+        return NULL;
+    return Py_BuildValue("d", swe_refrac(alt, press, temp, flag));
+}
+
+/* swisseph.refrac_extended */
+PyDoc_STRVAR(pyswe_refrac_extended__doc__,
+"Calculate true altitude from apparent altitude, or vice-versa (extended).\n\n"
+":Args: float alt, float geoalt, float atpress, float attemp, float lapserate,"
+" int flag\n\n"
+" - alt: altitude of object above geometric horizon in degrees,\n"
+"   where geometric horizon = plane perpendicular to gravity\n"
+" - geoalt: altitude of observer above sea level, in meters\n"
+" - atpress: atmospheric pressure in mbar (hPa)\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - lapserate: dattemp/dgeoalt [deg K/m]\n"
+" - flag: either TRUE_TO_APP or APP_TO_TRUE\n\n"
+":Return: float retalt, (dret)\n\n"
+" - retalt: converted altitude\n"
+" - dret: tuple of 4 float:\n"
+"    - 0: true altitude if possible, otherwise input value\n"
+"    - 1: apparent altitude if possible, otherwise input value\n"
+"    - 2: refraction\n"
+"    - 3: dip of the horizon");
+
+static PyObject * pyswe_refrac_extended FUNCARGS_KEYWDS
+{
+    double alt, geoalt, lapserate, ret, dret[4], press, temp;
+    int flag;
+    static char *kwlist[] = {"alt", "geoalt", "atpress", "attemp", "lapserate",
+                             "flag", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dddddi", kwlist,
+                    &alt, &geoalt, &press, &temp, &lapserate, &flag))
+        return NULL;
+    ret = swe_refrac_extended(alt, geoalt, press, temp, lapserate, flag, dret);
+    return Py_BuildValue("d(dddd)", ret, dret[0], dret[1], dret[2], dret[3]);
+}
+
+/* Call statistics and slow call hook
+ *
+ * When enabled (set_stats, or PYSWE_STATS in the environment on import), or
+ * when a slow call hook is set, the functions of the module and of
+ * swisseph.contrib are replaced in the module dicts by pyswe_Timed objects
+ * timing the calls. Disabling both puts the functions back, so that there is
+ * no cost when disabled.
+ */
+#define PYSWE_STATS_NBUCKETS    32
+
+typedef struct {
+    PyObject_HEAD
+    PyObject* func; /* wrapped function */
+    PyObject* name; /* 'calc_ut', 'contrib.next_aspect'... */
+    unsigned long long calls;
+    unsigned long long errors;
+    unsigned long long total; /* nanoseconds */
+    unsigned long long hist[PYSWE_STATS_NBUCKETS];
+#if PY_VERSION_HEX >= 0x03090000
+    vectorcallfunc vectorcall;
+#endif
+} pyswe_Timed;
+
+/* Count a call started at t0, return its duration
+ * Bucket i of the histogram counts calls of [2^i, 2^(i+1)) nanoseconds.
+ */
+static unsigned long long pyswe_Timed_record(pyswe_State* st,
+                                             pyswe_Timed* self,
+                                             unsigned long long t0,
+                                             PyObject* ret)
+{
+    unsigned long long dt = pyswe_clock_ns() - t0, x;
+    int i = 0;
+    if (!st->stats_enabled)
+        return dt;
+    for (x = dt >> 1; x && i < PYSWE_STATS_NBUCKETS - 1; x >>= 1)
+        ++i;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    ++self->calls;
+    if (!ret)
+        ++self->errors;
+    self->total += dt;
+    ++self->hist[i];
+    Py_END_CRITICAL_SECTION();
+    return dt;
+}
+
+/* Set while the slow call hook runs in this thread, so that the calls made
+ * by the hook do not call it again
+ */
+static PYSWE_THREAD_LOCAL int pyswe_slow_running = 0;
+
+/* Return a new reference to the slow call hook if a call of dt nanoseconds
+ * is to be reported, else NULL (without exception)
+ */
+static PyObject * pyswe_slow_hook(pyswe_State* st, unsigned long long dt)
+{
+    PyObject* hook = NULL;
+    if (pyswe_slow_running)
+        return NULL;
+    pyswe_state_lock(st);
+    if (st->slow_hook && dt >= st->slow_ns) {
+        hook = st->slow_hook;
+        Py_INCREF(hook);
+    }
+    pyswe_state_unlock(st);
+    return hook;
+}
+
+/* Call the hook of a slow call record (hook, (name, args, kwargs, elapsed))
+ * Errors of the hook are reported as unraisable. The reference to the record
+ * is stolen. Return 0 (pending call).
+ */
+static int pyswe_slow_run(void* arg)
+{
+    PyObject *rec = (PyObject*) arg, *ret;
+    int running = pyswe_slow_running;
+    pyswe_slow_running = 1;
+    ret = PyObject_Call(PyTuple_GET_ITEM(rec, 0), PyTuple_GET_ITEM(rec, 1),
+                        NULL);
+    if (ret)
+        Py_DECREF(ret);
+    else
+        PyErr_WriteUnraisable(PyTuple_GET_ITEM(rec, 0));
+    pyswe_slow_running = running;
+    Py_DECREF(rec);
+    return 0;
+}
+
+/* Report a slow call to the hook with (name, args, kwargs, elapsed ms)
+ * The hook is called later, as a pending call of the main thread, so that
+ * the slow call returns first, and the thread that made it is not delayed.
+ * Pending calls run in the main interpreter only: in subinterpreters, or if
+ * the pending calls are full, the hook is called now. The exception of the
+ * call, if any, is kept. The reference to hook is stolen.
+ */
+static void pyswe_slow_call(PyObject* hook, pyswe_Timed* self,
+                            PyObject* args, PyObject* kwds,
+                            unsigned long long dt)
+{
+    PyObject *type, *value, *tb, *rec;
+    PyErr_Fetch(&type, &value, &tb);
+    rec = Py_BuildValue("(N(OOOd))", hook, self->name, args,
+                        kwds ? kwds : Py_None, dt * 1e-6);
+    if (!rec)
+        PyErr_WriteUnraisable((PyObject*) self);
+#if PY_VERSION_HEX >= 0x03080000
+    else if (PyThreadState_Get()->interp != PyInterpreterState_Main()
+             || Py_AddPendingCall(pyswe_slow_run, rec))
+#else
+    else
+#endif
+        pyswe_slow_run(rec);
+    PyErr_Restore(type, value, tb);
+}
+
+/* Return a new reference to the wrapped function, that set_stats can replace
+ * from another thread
+ */
+static PyObject * pyswe_Timed_func(pyswe_Timed* self)
+{
+    PyObject* func;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    func = self->func;
+    Py_INCREF(func);
+    Py_END_CRITICAL_SECTION();
+    return func;
+}
+
+#if PY_VERSION_HEX >= 0x03090000
+static PyObject * pyswe_Timed_vectorcall(PyObject* self, PyObject *const *args,
+                                         size_t nargsf, PyObject* kwnames)
+{
+    Py_ssize_t i, nargs = PyVectorcall_NARGS(nargsf);
+    unsigned long long dt, t0 = pyswe_clock_ns();
+    pyswe_State* st = pyswe_type_state(Py_TYPE(self));
+    PyObject *tup = NULL, *kwds = NULL, *type, *value, *tb, *hook, *ret;
+    PyObject* func = pyswe_Timed_func((pyswe_Timed*) self);
+    ret = PyObject_Vectorcall(func, args, nargsf, kwnames);
+    Py_DECREF(func);
+    dt = pyswe_Timed_record(st, (pyswe_Timed*) self, t0, ret);
+    if (!(hook = pyswe_slow_hook(st, dt)))
+        return ret;
+    /* slow call, build the arguments for the hook */
+    PyErr_Fetch(&type, &value, &tb);
+    if (!(tup = PyTuple_New(nargs)))
+        goto error;
+    for (i = 0; i < nargs; ++i) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(tup, i, args[i]);
+    }
+    if (kwnames && PyTuple_GET_SIZE(kwnames)) {
+        if (!(kwds = PyDict_New()))
+            goto error;
+        for (i = 0; i < PyTuple_GET_SIZE(kwnames); ++i) {
+            if (PyDict_SetItem(kwds, PyTuple_GET_ITEM(kwnames, i),
+                               args[nargs + i]))
+                goto error;
+        }
+    }
+    pyswe_slow_call(hook, (pyswe_Timed*) self, tup, kwds, dt);
+    goto end;
+error:
+    PyErr_WriteUnraisable(self);
+    Py_DECREF(hook);
+end:
+    Py_XDECREF(tup);
+    Py_XDECREF(kwds);
+    PyErr_Restore(type, value, tb);
+    return ret;
+}
+#else
+static PyObject * pyswe_Timed_call(pyswe_Timed* self, PyObject* args,
+                                   PyObject* kwds)
+{
+    unsigned long long dt, t0 = pyswe_clock_ns();
+    pyswe_State* st = pyswe_type_state(Py_TYPE(self));
+    PyObject *hook, *func = pyswe_Timed_func(self);
+    PyObject* ret = PyObject_Call(func, args, kwds);
+    Py_DECREF(func);
+    dt = pyswe_Timed_record(st, self, t0, ret);
+    if ((hook = pyswe_slow_hook(st, dt)))
+        pyswe_slow_call(hook, self, args, kwds, dt);
+    return ret;
+}
+#endif
+
+/* Attributes (__name__, __doc__...) are those of the wrapped function */
+static PyObject * pyswe_Timed_getattro(pyswe_Timed* self, PyObject* name)
+{
+    if (PyUnicode_Check(name)
+        && !PyUnicode_CompareWithASCIIString(name, "__wrapped__")) {
+        Py_INCREF(self->func);
+        return self->func;
+    }
+    return PyObject_GetAttr(self->func, name);
+}
+
+static PyObject * pyswe_Timed_repr(pyswe_Timed* self)
+{
+    return PyObject_Repr(self->func);
+}
+
+static int pyswe_Timed_traverse(pyswe_Timed* self, visitproc visit, void* arg)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    Py_VISIT(Py_TYPE(self));
+#endif
+    Py_VISIT(self->func);
+    return 0;
+}
+
+static int pyswe_Timed_clear(pyswe_Timed* self)
+{
+    Py_CLEAR(self->func);
+    Py_CLEAR(self->name);
+    return 0;
+}
+
+static void pyswe_Timed_dealloc(pyswe_Timed* self)
+{
+    PyTypeObject* tp = Py_TYPE(self);
+    PyObject_GC_UnTrack(self);
+    pyswe_Timed_clear(self);
+    tp->tp_free((PyObject*) self);
+    Py_DECREF(tp);
+}
+
+#if PY_VERSION_HEX >= 0x03090000
+static PyMemberDef pyswe_Timed_members[] = {
+{"__vectorcalloffset__", T_PYSSIZET, offsetof(pyswe_Timed, vectorcall),
+    READONLY},
+{NULL}
+};
+#endif
+
+static PyType_Slot pyswe_Timed_slots[] = {
+#if PY_VERSION_HEX >= 0x03090000
+    {Py_tp_members, pyswe_Timed_members},
+    {Py_tp_call, PyVectorcall_Call},
+#else
+    {Py_tp_call, pyswe_Timed_call},
+#endif
+    {Py_tp_getattro, pyswe_Timed_getattro},
+    {Py_tp_repr, pyswe_Timed_repr},
+    {Py_tp_traverse, pyswe_Timed_traverse},
+    {Py_tp_clear, pyswe_Timed_clear},
+    {Py_tp_dealloc, pyswe_Timed_dealloc},
+    {0, NULL}
+};
+
+static PyType_Spec pyswe_Timed_spec = {
+    .name = "swisseph.Timed",
+    .basicsize = sizeof(pyswe_Timed),
+    .itemsize = 0,
+#if PY_VERSION_HEX >= 0x03090000
+    .flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_HAVE_GC|Py_TPFLAGS_HAVE_VECTORCALL,
+#else
+    .flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_HAVE_GC,
+#endif
+    .slots = pyswe_Timed_slots,
+};
+
+static PyObject * pyswe_Timed_new(pyswe_State* st, PyObject* func,
+                                  PyObject* name)
+{
+    pyswe_Timed* self = (pyswe_Timed*) st->timed_type->tp_alloc(
+        st->timed_type, 0);
+    if (!self)
+        return NULL;
+    Py_INCREF(func);
+    self->func = func;
+    Py_INCREF(name);
+    self->name = name;
+#if PY_VERSION_HEX >= 0x03090000
+    self->vectorcall = pyswe_Timed_vectorcall;
+#endif
+    return (PyObject*) self;
+}
+
+/* Replace the functions of a module by timed functions, or put them back
+ * Return -1 on error, with an exception set.
+ */
+static int pyswe_stats_wrap(pyswe_State* st, PyObject* m, const char* prefix,
+                            int on)
+{
+    Py_ssize_t pos = 0;
+    PyObject *dict = PyModule_GetDict(m), *key, *o, *name, *t;
+    while (PyDict_Next(dict, &pos, &key, &o)) {
+        if (!on) {
+            if (Py_TYPE(o) == st->timed_type
+                && PyDict_SetItem(dict, key, ((pyswe_Timed*) o)->func))
+                return -1;
+            continue;
+        }
+        if (!PyCFunction_Check(o) || PyCFunction_GET_SELF(o) != m
+            || PyUnicode_READ_CHAR(key, 0) == '_'
+            || !PyUnicode_CompareWithASCIIString(key, "stats")
+            || !PyUnicode_CompareWithASCIIString(key, "reset_stats")
+            || !PyUnicode_CompareWithASCIIString(key, "set_stats")
+            || !PyUnicode_CompareWithASCIIString(key, "set_slow_call_hook"))
+            continue;
+        if (!(name = PyUnicode_FromFormat("%s%U", prefix, key)))
+            return -1;
+        t = PyDict_GetItem(st->stats_registry, name);
+        if (t) {
+            Py_INCREF(t);
+            Py_INCREF(o);
+            Py_BEGIN_CRITICAL_SECTION(t);
+            Py_SETREF(((pyswe_Timed*) t)->func, o);
+            Py_END_CRITICAL_SECTION();
+        }
+        else if (!(t = pyswe_Timed_new(st, o, name))
+                 || PyDict_SetItem(st->stats_registry, name, t)) {
+            Py_XDECREF(t);
+            Py_DECREF(name);
+            return -1;
+        }
+        Py_DECREF(name);
+        if (PyDict_SetItem(dict, key, t)) {
+            Py_DECREF(t);
+            return -1;
+        }
+        Py_DECREF(t);
+    }
+    return 0;
+}
+
+/* Wrap or unwrap the functions, after enabling or disabling statistics or
+ * the slow call hook
+ * Return -1 on error, with an exception set.
+ */
+static int pyswe_stats_update(PyObject* m)
+{
+    pyswe_State* st = pyswe_get_state(m);
+    int x, on;
+#if PYSWE_USE_SWEPHELP
+    PyObject* m2;
+#endif
+    pyswe_state_lock(st);
+    on = st->stats_enabled || st->slow_hook;
+    pyswe_state_unlock(st);
+    if (!st->stats_registry && !(st->stats_registry = PyDict_New()))
+        return -1;
+    /* the registry is locked while wrapping, for concurrent calls */
+    Py_BEGIN_CRITICAL_SECTION(st->stats_registry);
+    x = pyswe_stats_wrap(st, m, "", on);
+#if PYSWE_USE_SWEPHELP
+    m2 = PyDict_GetItemString(PyModule_GetDict(m), "contrib");
+    if (!x && m2 && PyModule_Check(m2))
+        x = pyswe_stats_wrap(st, m2, "contrib.", on);
+#endif
+    Py_END_CRITICAL_SECTION();
+    return x;
+}
+
+/* swisseph.reset_stats */
+PyDoc_STRVAR(pyswe_reset_stats__doc__,
+"Reset call statistics.\n\n"
+":Args: --\n"
+":Return: None\n\n"
+"All counters of ``stats()`` are set to zero. This does not enable or disable"
+" statistics.");
+
+static PyObject * pyswe_reset_stats FUNCARGS_SELF
+{
+    Py_ssize_t pos = 0;
+    PyObject *key, *o;
+    pyswe_Timed* t;
+    pyswe_State* st = pyswe_get_state(self);
+    if (!st->stats_registry)
+        Py_RETURN_NONE;
+    Py_BEGIN_CRITICAL_SECTION(st->stats_registry);
+    while (PyDict_Next(st->stats_registry, &pos, &key, &o)) {
+        t = (pyswe_Timed*) o;
+        Py_BEGIN_CRITICAL_SECTION(t);
+        t->calls = t->errors = t->total = 0;
+        memset(t->hist, 0, sizeof(t->hist));
+        Py_END_CRITICAL_SECTION();
+    }
+    Py_END_CRITICAL_SECTION();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.revjul */
+PyDoc_STRVAR(pyswe_revjul__doc__,
+"Calculate year, month, day, hour from Julian day number.\n\n"
+":Args: float jd, int cal=GREG_CAL\n\n"
+" - jd: Julian day number\n"
+" - cal: either GREG_CAL (gregorian) or JUL_CAL (julian)\n\n"
+":Return: int year, int month, int day, float hour\n\n"
+"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.");
+
+/* Compute the result of revjul, after parsing */
+static PyObject * pyswe_revjul_impl(double jd, int cal)
+{
+    int year, month, day;
+    double hour;
+    if (cal != SE_GREG_CAL && cal != SE_JUL_CAL)
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.revjul: invalid calendar (%d)", cal);
+    swe_revjul(jd, cal, &year, &month, &day, &hour);
+    return Py_BuildValue("iiid", year, month, day, hour);
+}
+
+static PyObject * pyswe_revjul FUNCARGS_KEYWDS
+{
+    int cal = SE_GREG_CAL;
+    double jd;
+    static char *kwlist[] = {"jd", "cal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &cal))
+        return NULL;
+    return pyswe_revjul_impl(jd, cal);
+}
+
+#if PYSWE_FASTCALL
+static PyObject * pyswe_revjul_fast FUNCARGS_FAST
+{
+    PyObject *a[2];
+    int cal = SE_GREG_CAL;
+    double jd;
+    static char *kwlist[] = {"jd", "cal", NULL};
+    if (pyswe_fast_args(args, nargs, kwnames, kwlist, 1, a)
+        || pyswe_fast_d(a[0], &jd) || (a[1] && pyswe_fast_i(a[1], &cal)))
+        return pyswe_fast_fallback(pyswe_revjul, self, args, nargs, kwnames);
+    return pyswe_revjul_impl(jd, cal);
+}
+#endif
+
+/* swisseph.rise_trans */
+PyDoc_STRVAR(pyswe_rise_trans__doc__,
+"Calculate times of rising, setting and meridian transits.\n\n"
+":Args: float tjdut, int or str body, int rsmi, seq geopos, float atpress=0.0,"
+" float attemp=0.0, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - body: planet identifier (int) or fixed star name (str)\n"
+" - rsmi: bit flag for rise, set, or one of the two meridian transits, etc\n"
+" - geopos: a sequence for:\n"
+"    - 0: geographic longitude, in degrees (eastern positive)\n"
+"    - 1: geographic latitude, in degrees (northern positive)\n"
+"    - 2: geographic altitude, in meters above sea level\n"
+" - atpress: atmospheric pressure in mbar/hPa\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - flags: ephemeris flags etc\n\n"
+":Return: int res, (tret)\n\n"
+" - res: integer indicating:\n"
+"    - (0) event found\n"
+"    - (-2) event not found because the object is circumpolar\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: tjd of event\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_rise_trans FUNCARGS_KEYWDS
+{
+    double jd, press = 0.0, temp = 0.0;
+    double geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    int i, res, pl, rsmi, flag = SEFLG_SWIEPH;
+    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
+    PyObject *body, *gp;
+    static char *kwlist[] = {"tjdut", "body", "rsmi", "geopos", "atpress",
+                             "attemp", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOiO|ddi", kwlist, &jd,
+                                     &body, &rsmi, &gp, &press, &temp, &flag))
+        return NULL;
+    /* extract pl/star */
+    i = py_obj2plstar(body, &pl, &star);
+    if (i > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.rise_trans: invalid body type");
+        return NULL;
+    }
+    if (star) {
+        memset(st, 0, (SE_MAX_STNAME*2)+1);
+        strncpy(st, star, SE_MAX_STNAME*2);
+    }
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.rise_trans: geopos: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    res = swe_rise_trans(jd, pl, st, flag, rsmi, geopos, press, temp, tret, err);
+    if (res == -1)
+        return PyErr_Format(pyswe_error(self), "swisseph.rise_trans: %s", err);
+    return Py_BuildValue("iN", res, pyswe_dtuple(tret, 10));
+}
+
+/* swisseph.rise_trans_array */
+PyDoc_STRVAR(pyswe_rise_trans_array__doc__,
+"Calculate times of rising, setting and meridian transits for many start"
+" dates.\n\n"
+":Args: seq tjdut, int or str body, int rsmi, seq geopos, float atpress=0.0,"
+" float attemp=0.0, int flags=FLG_SWIEPH, str errors='raise',"
+" list errlist=None\n\n"
+" - tjdut: julian day numbers, universal time, as a sequence or a buffer of"
+" float64\n"
+" - body: planet identifier (int) or fixed star name (str)\n"
+" - rsmi: bit flag for rise, set, or one of the two meridian transits, etc\n"
+" - geopos: a sequence for longitude, latitude, altitude\n"
+" - atpress: atmospheric pressure in mbar/hPa\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - flags: ephemeris flags etc\n"
+" - errors: policy for the dates in error (see calc_ut_array)\n"
+" - errlist: list where (index, message) of the dates in error are"
+" appended, if errors is not 'raise'\n\n"
+":Return: res, tret\n\n"
+" - res: memoryview of int32 of shape (n,), 0 if the event was found, -2 if"
+" the object is circumpolar, -1 (ERR) in case of error\n"
+" - tret: memoryview of float64 of shape (n,), the times of the events\n\n"
+"This is rise_trans for each start date, computed in parallel by the thread"
+" pool (see set_num_threads), with results in the order of the dates.");
+
+typedef struct {
+    const double* jd;
+    int pl;
+    const char* star;
+    int rsmi;
+    int flag;
+    double geopos[3];
+    double press;
+    double temp;
+    int* res;
+    double* tret;
+} pyswe_RiseArray;
+
+static void pyswe_rise_trans_array_run(pyswe_Job* job, Py_ssize_t start,
+                                       Py_ssize_t end)
+{
+    pyswe_RiseArray* a = (pyswe_RiseArray*) job->data;
+    double tret[10];
+    char st[(SE_MAX_STNAME*2)+1], err[256];
+    Py_ssize_t i;
+    for (i = start; i < end; ++i) {
+        memset(st, 0, sizeof(st));
+        if (a->star)
+            strncpy(st, a->star, SE_MAX_STNAME*2);
+        err[0] = '\0';
+        tret[0] = 0;
+        a->res[i] = swe_rise_trans(a->jd[i], a->pl, st, a->flag, a->rsmi,
+                                   a->geopos, a->press, a->temp, tret, err);
+        a->tret[i] = tret[0];
+        if (a->res[i] == -1)
+            pyswe_job_error(job, i, err);
+    }
+}
+
+static PyObject * pyswe_rise_trans_array FUNCARGS_KEYWDS
+{
+    pyswe_RiseArray a;
+    pyswe_DArray jd;
+    pyswe_Job job;
+    int i;
+    char *star, *errors = "raise", err[128] = {0};
+    PyObject *seq, *body, *gp, *res = NULL, *tret = NULL, *errlist = NULL;
+    static char *kwlist[] = {"tjdut", "body", "rsmi", "geopos", "atpress",
+                             "attemp", "flags", "errors", "errlist", NULL};
+    a.press = a.temp = 0.0;
+    a.flag = SEFLG_SWIEPH;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOiO|ddisO", kwlist, &seq,
+                                     &body, &a.rsmi, &gp, &a.press, &a.temp,
+                                     &a.flag, &errors, &errlist)
+        || pyswe_job_policy(&job, errors, errlist, "rise_trans_array"))
+        return NULL;
+    if (py_obj2plstar(body, &a.pl, &star) > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.rise_trans_array: invalid body type");
+        return NULL;
+    }
+    a.star = star;
+    i = py_seq2d(gp, 3, a.geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.rise_trans_array: geopos: %s", err);
+    /* set topo params, for the workers too */
+    if (a.flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(a.geopos);
+    if (pyswe_darray_get(seq, &jd, "rise_trans_array", "tjdut"))
+        return NULL;
+    if (!(res = pyswe_results_new(jd.n, 1, sizeof(int), (void**) &a.res))
+        || !(tret = pyswe_results_new(jd.n, 1, sizeof(double),
+                                      (void**) &a.tret))) {
+        pyswe_darray_release(&jd);
+        Py_XDECREF(res);
+        return NULL;
+    }
+    a.jd = jd.d;
+    job.func = pyswe_rise_trans_array_run;
+    job.data = &a;
+    job.n = jd.n;
+    job.chunk = 1;
+    pyswe_pool_run(&job);
+    pyswe_darray_release(&jd);
+    if (pyswe_job_errors(&job, pyswe_error(self), "rise_trans_array",
+                         errlist)) {
+        Py_DECREF(res);
+        Py_DECREF(tret);
+        return NULL;
+    }
+    if (job.errors == PYSWE_ERRORS_NAN)
+        pyswe_results_nan(a.tret, 1, a.res, jd.n);
+    return Py_BuildValue("NN", pyswe_results_view(res, "i", jd.n, 0),
+                         pyswe_results_view(tret, "d", jd.n, 0));
+}
+
+/* swisseph.rise_trans_true_hor */
+PyDoc_STRVAR(pyswe_rise_trans_true_hor__doc__,
+"Calculate times of rising, setting and meridian transits (with altitude).\n\n"
+":Args: float tjdut, int or str body, int rsmi, seq geopos, float atpress=0.0,"
+" float attemp=0.0, float horhgt=0.0, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - body: planet identifier (int) or fixed star name (str)\n"
+" - rsmi: bit flag for rise, set, or one of the two meridian transits, etc\n"
+" - geopos: a sequence for:\n"
+"    - 0: geographic longitude (eastern positive)\n"
+"    - 1: geographic latitude (northern positive)\n"
+"    - 2: altitude above sea level, in meters\n"
+" - atpress: atmospheric pressure in mbar/hPa\n"
+" - attemp: atmospheric temperature in degrees Celsius\n"
+" - horhgt: height of local horizon in degrees (where body rises or sets)\n"
+" - flags: ephemeris flags etc\n\n"
+":Return: int res, (tret)\n\n"
+" - res: integer indicating:\n"
+"    - 0 event found\n"
+"    - -2 event not found because the object is circumpolar\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: tjd of event\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_rise_trans_true_hor FUNCARGS_KEYWDS
+{
+    double jd, press = 0.0, temp = 0.0, horhgt = 0.0;
+    double geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    int i, pl, rsmi, flag = SEFLG_SWIEPH;
+    char *star, st[(SE_MAX_STNAME*2)+1] = {0}, err[256] = {0};
+    PyObject *body, *gp;
+    static char *kwlist[] = {"tjdut", "body", "rsmi", "geopos", "atpress",
+                             "attemp", "horhgt", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOiO|dddi", kwlist, &jd,
+                            &body, &rsmi, &gp, &press, &temp, &horhgt, &flag))
+        return NULL;
+    /* extract pl/star */
+    i = py_obj2plstar(body, &pl, &star);
+    if (i > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.rise_trans_true_hor: invalid body type");
+        return NULL;
+    }
+    if (star) {
+        memset(st, 0, (SE_MAX_STNAME*2)+1);
+        strncpy(st, star, SE_MAX_STNAME*2);
+    }
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.rise_trans_true_hor: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_rise_trans_true_hor(jd, pl, st, flag, rsmi, geopos, press, temp,
+                                horhgt, tret, err);
+    if (i == -1)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.rise_trans_true_hor: %s", err);
+    return Py_BuildValue("iN", i, pyswe_dtuple(tret, 10));
+}
+
+/* swisseph.set_delta_t_userdef */
+PyDoc_STRVAR(pyswe_set_delta_t_userdef__doc__,
+"Set a fixed Deltat T value.\n\n"
+":Args: acc\n"
+":Return: None\n\n"
+"This function allows the user to set a fixed Delta T value that will be"
+" returned by ``deltat()`` or ``deltat_ex()``. The same Delta T value will"
+" then be used by ``calc_ut()``, eclipse functions, heliacal functions, and"
+" all functions that require UT as input time.\n\n"
+"In order to return to automatic Delta T, call this function with the"
+" following value: ``set_delta_t_userdef(DELTAT_AUTOMATIC)``.");
+
+static PyObject * pyswe_set_delta_t_userdef FUNCARGS_KEYWDS
+{
+    double acc;
+    static char *kwlist[] = {"acc", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &acc))
+        return NULL;
+    swe_set_delta_t_userdef(acc);
+    pyswe_settings.delta_t = acc;
+    pyswe_settings_touch();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_ephe_path */
+PyDoc_STRVAR(pyswe_set_ephe_path__doc__,
+"Set ephemeris files path.\n\n"
+":Args: str path=\"" PYSWE_DEFAULT_EPHE_PATH "\", bool mmap=False\n\n"
+" - path: ephemeris files path\n"
+" - mmap: map the ephemeris files in memory\n\n"
+":Return: None\n\n"
+"It is possible to pass None as path, which is equivalent to an empty string.\n\n"
+"With ``mmap``, all ``*.se1`` files found in the path directories are mapped"
+" read-only and shared, until ``close()`` or the next call to this function."
+" When pyswisseph is built with its bundled libswe and ``PYSWE_USE_IO_STATS``"
+" (Linux by default), libswe then reads these files from the mapping, without"
+" system calls. Otherwise the files are only read ahead in the page cache."
+" The pages are those of the page cache in both cases, shared by all"
+" processes, and libswe still copies the segments of coefficients it uses in"
+" its own buffers: the memory used per process is not reduced. Asteroid"
+" subdirectories are not mapped. This option is ignored on platforms without"
+" mmap.");
+
+static PyObject * pyswe_set_ephe_path FUNCARGS_KEYWDS
+{
+    char *path = PYSWE_DEFAULT_EPHE_PATH;
+    int map = 0;
+    static char *kwlist[] = {"path", "mmap", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|zi", kwlist, &path, &map))
+        return NULL;
+    pyswe_ephe_pending = 0;
+    swe_set_ephe_path(path);
+    pyswe_settings_path(path);
+#if PYSWE_USE_MMAP
+    pyswe_lock(&pyswe_mapped_lock);
+    pyswe_ephe_unmap();
+    if (map && pyswe_ephe_map(path)) {
+        pyswe_ephe_unmap();
+        pyswe_unlock(&pyswe_mapped_lock);
+        return PyErr_NoMemory();
+    }
+    pyswe_unlock(&pyswe_mapped_lock);
+#endif
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_jpl_file */
+PyDoc_STRVAR(pyswe_set_jpl_file__doc__,
+"Set name of JPL ephemeris file.\n\n"
+":Args: str name\n"
+":Return: None\n\n"
+"If you work with the JPL ephemeris, SwissEph uses the default file name which"
+" is defined as ``FNAME_DFT``. Currently, it has the value ``de406.eph`` or"
+" ``de431.eph``.\n\n"
+"If a different JPL ephemeris file is required, call this function to make the"
+" file name known to the software, eg::\n\n"
+"    swe.set_jpl_file('de405.eph')\n\n"
+"This file must reside in the ephemeris path you are using for all your"
+" ephemeris files.");
+
+static PyObject * pyswe_set_jpl_file FUNCARGS_KEYWDS
+{
+    char *name;
+    static char *kwlist[] = {"name", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &name))
+        return NULL;
+    swe_set_jpl_file(name);
+    pyswe_settings.jpl_file[0] = '\0';
+    strncat(pyswe_settings.jpl_file, name,
+            sizeof(pyswe_settings.jpl_file) - 1);
+    pyswe_settings_touch();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_lapse_rate */
+PyDoc_STRVAR(pyswe_set_lapse_rate__doc__,
+"Set lapse rate.\n\n"
+":Args: float lrate\n"
+":Return: None");
+
+static PyObject * pyswe_set_lapse_rate FUNCARGS_KEYWDS
+{
+    double lapserate;
+    static char *kwlist[] = {"lrate", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &lapserate))
+        return NULL;
+    swe_set_lapse_rate(lapserate);
+    pyswe_settings.lapse_rate = lapserate;
+    pyswe_settings_touch();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_num_threads */
+PyDoc_STRVAR(pyswe_set_num_threads__doc__,
+"Set the number of threads of the batch functions.\n\n"
+":Args: int n\n\n"
+" - n: number of threads computing a batch, including the calling thread\n\n"
+":Return: None\n\n"
+"Batch functions (calc_ut_array, houses_array, rise_trans_array) split their"
+" dates in chunks computed by a pool of threads, process wide. The default is"
+" the number of processors, or the environment variable PYSWE_NUM_THREADS on"
+" import. With 1, batches are computed by the calling thread only, as when"
+" libswe is built without thread local storage (TLSOFF, macOS, system"
+" libswe). Libswe"
+" settings of the calling thread (ephemeris path, sidereal mode, topocentric"
+" position, delta t, lapse rate) are used by the threads of the pool.");
+
+static PyObject * pyswe_set_num_threads FUNCARGS_KEYWDS
+{
+    int n;
+    static char *kwlist[] = {"n", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &n))
+        return NULL;
+    if (n < 1)
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.set_num_threads: invalid number (%d)", n);
+    pyswe_pool_resize(n);
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_sid_mode */
+PyDoc_STRVAR(pyswe_set_sid_mode__doc__,
+"Set sidereal mode.\n\n"
+":Args: int sidmode, float t0=0.0, float ayan_t0=0.0\n"
+":Return: None\n\n"
+"This function can be used to specify the mode for sidereal computations."
+" ``calc()`` or ``fixstar()`` has then to be called with the bit"
+" ``FLG_SIDEREAL``.\n\n"
+"If ``set_sid_mode()`` is not called, the default ayanamsha (Fagan/Bradley)"
+" is used.\n\n"
+"If a predefined mode is wanted, the parameter ``sidmode`` has to be set, while"
+" ``t0`` and ``ayan_t0`` are not considered, i.e. can be 0.\n\n"
+"For information about the sidereal modes, please read the chapter on sidereal"
+" calculations in the documentation.");
+
+static PyObject * pyswe_set_sid_mode FUNCARGS_KEYWDS
+{
+    int mode;
+    double t0 = 0.0, ayan_t0 = 0.0;
+    static char *kwlist[] = {"mode", "t0", "ayan_t0", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|dd", kwlist,
+                                     &mode, &t0, &ayan_t0))
+        return NULL;
+    swe_set_sid_mode(mode, t0, ayan_t0);
+    pyswe_settings.sid_mode = mode;
+    pyswe_settings.sid_t0 = t0;
+    pyswe_settings.sid_ayan_t0 = ayan_t0;
+    pyswe_settings_touch();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_slow_call_hook */
+PyDoc_STRVAR(pyswe_set_slow_call_hook__doc__,
+"Set a function called after slow calls.\n\n"
+":Args: callback, float threshold_ms=100.0\n\n"
+" - callback: function called as callback(name, args, kwargs, elapsed), or"
+" None to remove the hook\n"
+" - threshold_ms: calls taking at least that many milliseconds are reported\n\n"
+":Return: None\n\n"
+"The callback receives the name of the function (``'heliacal_ut'``,"
+" ``'contrib.next_aspect'``...), the tuple of positional arguments, the dict"
+" of keyword arguments (or None) and the elapsed time in milliseconds. It is"
+" called only for slow calls, asynchronously: the slow call returns (or"
+" raises) first, and the callback runs soon after in the main thread, as the"
+" signal handlers (a subinterpreter calls it before the slow call returns)."
+" A callback removed can still receive the calls reported before. Exceptions"
+" raised by the callback are printed and ignored, and calls made from the"
+" callback are not reported.\n\n"
+"As with ``set_stats()``, the functions are replaced by timing wrappers, so a"
+" function bound to another name before is not checked.");
+
+static PyObject * pyswe_set_slow_call_hook FUNCARGS_KEYWDS
+{
+    double ms = 100.0;
+    PyObject *cb, *old;
+    pyswe_State* st = pyswe_get_state(self);
+    static char *kwlist[] = {"callback", "threshold_ms", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|d", kwlist, &cb, &ms))
+        return NULL;
+    if (cb != Py_None && !PyCallable_Check(cb)) {
+        PyErr_SetString(PyExc_TypeError,
+            "swisseph.set_slow_call_hook: callback must be callable or None");
+        return NULL;
+    }
+    if (!(ms >= 0)) {
+        PyErr_SetString(PyExc_ValueError,
+            "swisseph.set_slow_call_hook: threshold_ms must be >= 0");
+        return NULL;
+    }
+    if (cb == Py_None)
+        cb = NULL;
+    Py_XINCREF(cb);
+    pyswe_state_lock(st);
+    old = st->slow_hook;
+    st->slow_hook = cb;
+    st->slow_ns = (unsigned long long) (ms * 1e6);
+    pyswe_state_unlock(st);
+    Py_XDECREF(old);
+    if (pyswe_stats_update(self))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_stats */
+PyDoc_STRVAR(pyswe_set_stats__doc__,
+"Enable or disable call statistics.\n\n"
+":Args: bool enable\n\n"
+" - enable: True to collect statistics, False to stop\n\n"
+":Return: None\n\n"
+"Statistics are read with ``stats()``. Set the environment variable"
+" ``PYSWE_STATS`` (to anything but ``0``) to enable statistics on import."
+" Disabling restores the original functions, and keeps the statistics"
+" collected.\n\n"
+"Limitation: when enabled, the functions of the module and of"
+" ``swisseph.contrib`` are replaced by timing wrappers in the module dicts,"
+" the functions themselves do not count their calls. Calls through a name"
+" bound before enabling are not counted, as with ``from swisseph import"
+" calc_ut`` (or ``f = swe.calc_ut``) followed by ``set_stats(True)``. Call"
+" the functions as attributes of the module (``swe.calc_ut``), or enable"
+" statistics with ``PYSWE_STATS`` before such imports.");
+
+static PyObject * pyswe_set_stats FUNCARGS_KEYWDS
+{
+    int on;
+    static char *kwlist[] = {"enable", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "p", kwlist, &on))
+        return NULL;
+    pyswe_get_state(self)->stats_enabled = on;
+    if (pyswe_stats_update(self))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_tid_acc */
+PyDoc_STRVAR(pyswe_set_tid_acc__doc__,
+"Set value of the tidal acceleration.\n\n"
+":Args: float acc\n\n"
+" - acc: the values possible are:\n"
+"    - TIDAL_DE200\n"
+"    - TIDAL_DE403\n"
+"    - TIDAL_DE404\n"
+"    - TIDAL_DE405\n"
+"    - TIDAL_DE406\n"
+"    - TIDAL_DE421\n"
+"    - TIDAL_DE422\n"
+"    - TIDAL_DE430\n"
+"    - TIDAL_DE431\n"
+"    - TIDAL_DE441\n"
+"    - TIDAL_26\n"
+"    - TIDAL_STEPHENSON_2016\n"
+"    - TIDAL_DEFAULT (equals TIDAL_DE431)\n"
+"    - TIDAL_MOSEPH (equals TIDAL_DE404)\n"
+"    - TIDAL_SWIEPH (equals TIDAL_DEFAULT)\n"
+"    - TIDAL_JPLEPH (equals TIDAL_DEFAULT)\n\n"
+":Return: None\n\n"
+"With Swiss Ephemeris versions until 1.80, this function had always to be used,"
+" if a nonstandard ephemeris like DE200 or DE421 was used.\n\n"
+"Since Swiss Ephemeris version 2.00, this function is usually not needed,"
+" because the value is automatically set according to the ephemeris files"
+" selected or available. However, under certain circumstances that are"
+" described in the documentation section for ``swe_deltat()``, the user may"
+" want to control the tidal acceleration himself.\n\n"
+"Once the function ``set_tid_acc()`` has been used, the automatic setting of"
+" tidal acceleration is blocked. In order to unblock it again, call"
+" ``set_tid_acc(TIDAL_AUTOMATIC)``.");
+
+static PyObject * pyswe_set_tid_acc FUNCARGS_KEYWDS
+{
+    double acc;
+    static char *kwlist[] = {"acc", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &acc))
+        return NULL;
+    swe_set_tid_acc(acc);
+    pyswe_settings.tid_acc = acc;
+    pyswe_settings_touch();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.set_topo */
+PyDoc_STRVAR(pyswe_set_topo__doc__,
+"Set topocentric parameters.\n\n"
+":Args: float lon, float lat, float alt=0.0\n\n"
+" - lon: geographic longitude, in degrees (eastern positive)\n"
+" - lat: geographic latitude, in degrees (northern positive)\n"
+" - alt: geographic altitude in meters above sea level\n\n"
+":Return: None");
+
+static PyObject * pyswe_set_topo FUNCARGS_KEYWDS
+{
+    double lon, lat, alt = 0.0;
+    static char *kwlist[] = {"lon", "lat", "alt", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|d", kwlist,
+                                     &lon, &lat, &alt))
+        return NULL;
+    swe_set_topo(lon, lat, alt);
+    pyswe_settings.topo[0] = lon;
+    pyswe_settings.topo[1] = lat;
+    pyswe_settings.topo[2] = alt;
+    pyswe_settings_touch();
+    Py_RETURN_NONE;
+}
+
+/* swisseph.sidtime */
+PyDoc_STRVAR(pyswe_sidtime__doc__,
+"Calculate sidereal time (UT).\n\n"
+":Args: float tjdut\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n\n"
+":Return: float sidtime");
+
+static PyObject * pyswe_sidtime FUNCARGS_KEYWDS
+{
+    double jd;
+    static char *kwlist[] = {"tjdut", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
+        return NULL;
+    return Py_BuildValue("d", swe_sidtime(jd));
+}
+
+/* swisseph.sidtime0 */
+PyDoc_STRVAR(pyswe_sidtime0__doc__,
+"Calculate sidereal time, given obliquity and nutation (UT).\n\n"
+":Args: float tjdut, float eps, float nutation\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - eps: obliquity, in degrees\n"
+" - nutation: nutation in longitude, in degrees\n\n"
+":Return: float sidtime");
+
+static PyObject * pyswe_sidtime0 FUNCARGS_KEYWDS
+{
+    double jd, obliquity, nutation;
+    static char *kwlist[] = {"tjdut", "eps", "nutation", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ddd", kwlist,
+                                     &jd, &obliquity, &nutation))
+        return NULL;
+    return Py_BuildValue("d", swe_sidtime0(jd, obliquity, nutation));
+}
+
+/* swisseph.sol_eclipse_how */
+PyDoc_STRVAR(pyswe_sol_eclipse_how__doc__,
+"Calculate attributes of a solar eclipse for a given geographic position and"
+" time.\n\n"
+":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - geographic longitude, in degrees (eastern positive)\n"
+"    - geographic latitude, in degrees (northern positive)\n"
+"    - geographic altitude above sea level, in meters\n\n"
+" - flags: ephemeris flag, etc\n\n"
+":Return: int retflags, (attr)\n\n"
+" - retflags: returned bit flags:\n"
+"    - 0 if no eclipse is visible at position\n"
+"    - ECL_TOTAL ECL_ANNULAR ECL_PARTIAL\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: fraction of solar diameter covered by moon\n"
+"    - 1: ratio of lunar diameter to solar one\n"
+"    - 2: fraction of solar disc covered by moon (obscuration)\n"
+"    - 3: diameter of core shadow in km\n"
+"    - 4: azimuth of sun at tjd\n"
+"    - 5: true altitude of sun above horizon at tjd\n"
+"    - 6: apparent altitude of sun above horizon at tjd\n"
+"    - 7: elongation of moon in degrees (separation angle)\n"
+"    - 8: magnitude acc. to NASA (equals attr[0] for partial and attr[1] for"
+"      annular and total eclipses)\n"
+"    - 9: saros series number (if available, otherwise -99999999)\n"
+"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_sol_eclipse_how FUNCARGS_KEYWDS
+{
+    double jd, geopos[3];
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    int i, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    PyObject *gp;
+    static char *kwlist[] = {"tjdut", "geopos", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|i", kwlist,
+                                     &jd, &gp, &flag))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.sol_eclipse_how: geopos: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_sol_eclipse_how(jd, flag, geopos, attr, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.sol_eclipse_how: %s", err);
+    return Py_BuildValue("iN", i, pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.sol_eclipse_when_glob */
+PyDoc_STRVAR(pyswe_sol_eclipse_when_glob__doc__,
+"Find the next solar eclipse globally (UT).\n\n"
+":Args: float tjdut, int flags=FLG_SWIEPH, int ecltype=0, bool"
+" backwards=False\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - flags: ephemeris flag\n"
+" - ecltype: bit flags for eclipse type wanted:\n"
+"    - ECL_CENTRAL ECL_NONCENTRAL ECL_TOTAL ECL_ANNULAR ECL_PARTIAL\n"
+"    - ECL_ANNULAR_TOTAL (equals ECL_HYBRID)\n"
+"    - ECL_ALLTYPES_SOLAR or 0 for any type\n"
+" - backwards: boolean, set to True to search back in time\n\n"
+":Return: int res, (tret)\n\n"
+" - res: returned bit flags:\n"
+"    - ECL_TOTAL ECL_ANNULAR ECL_PARTIAL ECL_ANNULAR_TOTAL\n"
+"    - ECL_CENTRAL\n"
+"    - ECL_NONCENTRAL\n\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: time of maximum eclipse\n"
+"    - 1: time when eclipse takes place at local apparent noon\n"
+"    - 2: time of eclipse begin\n"
+"    - 3: time of eclipse end\n"
+"    - 4: time of totality begin\n"
+"    - 5: time of totality end\n"
+"    - 6: time of center line begin\n"
+"    - 7: time of center line end\n"
+"    - 8: time when annular-total eclipse becomes total\n"
+"    - 9: time when annular-total eclipse becomes annular again\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_sol_eclipse_when_glob FUNCARGS_KEYWDS
+{
+    double jd, tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    int res, ecltype = 0, backw = 0, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdut", "flags", "ecltype", "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|iii", kwlist,
+            &jd, &flag, &ecltype, &backw))
+        return NULL;
+    res = swe_sol_eclipse_when_glob(jd, flag, ecltype, tret, backw, err);
+    if (res < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.sol_eclipse_when_glob: %s", err);
+    return Py_BuildValue("iN", res, pyswe_dtuple(tret, 10));
+}
+
+/* swisseph.sol_eclipse_when_loc */
+PyDoc_STRVAR(pyswe_sol_eclipse_when_loc__doc__,
+"Find the next solar eclipse for a given geographic position (UT).\n\n"
+":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH, bool backwards=False\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - geographic longitude, in degrees (eastern positive)\n"
+"    - geographic latitude, in degrees (northern positive)\n"
+"    - geographic altitude above sea level, in meters\n"
+" - flags: ephemeris flag, etc\n"
+" - backwards: boolean, set to True to search back in time\n\n"
+":Return: int retflags, (tret), (attr)\n\n"
+" - retflags: returned bit flags:\n"
+"    - ECL_TOTAL or ECL_ANNULAR or ECL_PARTIAL,\n"
+"    - ECL_VISIBLE, ECL_MAX_VISIBLE, ECL_1ST_VISIBLE, ECL_2ND_VISIBLE,\n"
+"      ECL_3RD_VISIBLE, ECL_4TH_VISIBLE\n"
+" - tret: tuple of 10 float, of which:\n"
+"    - 0: time of maximum eclipse\n"
+"    - 1: time of first contact\n"
+"    - 2: time of second contact\n"
+"    - 3: time of third contact\n"
+"    - 4: time of fourth contact\n"
+"    - 5: time of sunrise between first and fourth contact\n"
+"    - 6: time of sunset between first and fourth contact\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: fraction of solar diameter covered by moon; with total/annular\n"
+"      eclipse, it results in magnitude acc. to IMCCE.\n"
+"    - 1: ratio of lunar diameter to solar one\n"
+"    - 2: fraction of solar disc covered by moon (obscuration)\n"
+"    - 3: diameter of core shadow in km\n"
+"    - 4: azimuth of sun at tjd\n"
+"    - 5: true altitude of sun above horizon at tjd\n"
+"    - 6: apparent altitude of sun above horizon at tjd\n"
+"    - 7: elongation of moon in degrees (separation angle)\n"
+"    - 8: magnitude acc. to NASA (equals attr[0] for partial and attr[1] for"
+"      annular and total eclipses)\n"
+"    - 9: saros series number (if available, otherwise -99999999)\n"
+"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_sol_eclipse_when_loc FUNCARGS_KEYWDS
+{
+    double jd, geopos[3], tret[10] = {0,0,0,0,0,0,0,0,0,0};
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    int i, backw = 0, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    PyObject *gp;
+    static char *kwlist[] = {"tjdut", "geopos", "flags", "backwards", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|ii", kwlist,
+                                     &jd, &gp, &flag, &backw))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(gp, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                            "swisseph.sol_eclipse_when_loc: geopos: %s", err);
+    /* set topo params */
+    if (flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    i = swe_sol_eclipse_when_loc(jd, flag, geopos, tret, attr, backw, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.sol_eclipse_when_loc: %s", err);
+    return Py_BuildValue("iNN", i, pyswe_dtuple(tret, 10),
+                         pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.sol_eclipse_where */
+PyDoc_STRVAR(pyswe_sol_eclipse_where__doc__,
+"Find where a solar eclipse is central or maximal (UT).\n\n"
+":Args: float tjdut, int flags=FLG_SWIEPH\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - flags: ephemeris flag\n\n"
+":Return: int retflags, (geopos), (attr)\n\n"
+" - retflags: returned bit flags:\n"
+"    - ECL_TOTAL\n"
+"    - ECL_ANNULAR\n"
+"    - ECL_TOTAL | ECL_CENTRAL\n"
+"    - ECL_TOTAL | ECL_NONCENTRAL\n"
+"    - ECL_ANNULAR | ECL_CENTRAL\n"
+"    - ECL_ANNULAR | ECL_NONCENTRAL\n"
+"    - ECL_PARTIAL\n"
+" - geopos: tuple of 10 float for longitude/latitude of:\n"
+"    - 0: geographic longitude of central line\n"
+"    - 1: geographic latitude of central line\n"
+"    - 2: geographic longitude of northern limit of umbra\n"
+"    - 3: geographic latitude of northern limit of umbra\n"
+"    - 4: geographic longitude of southern limit of umbra\n"
+"    - 5: geographic latitude of southern limit of umbra\n"
+"    - 6: geographic longitude of northern limit of penumbra\n"
+"    - 7: geographic latitude of northern limit of penumbra\n"
+"    - 8: geographic longitude of southern limit of penumbra\n"
+"    - 9: geographic latitude of southern limit of penumbra\n"
+" - attr: tuple of 20 float, of which:\n"
+"    - 0: fraction of solar diameter covered by moon; with total/annular\n"
+"      eclipse, it results in magnitude acc. to IMCCE.\n"
+"    - 1: ratio of lunar diameter to solar one\n"
+"    - 2: fraction of solar disc covered by moon\n"
+"    - 3: diameter of core shadow in km\n"
+"    - 4: azimuth of sun at tjd\n"
+"    - 5: true altitude of sun above horizon at tjd\n"
+"    - 6: apparent altitude of sun above horizon at tjd\n"
+"    - 7: elongation of moon in degrees (separation angle)\n"
+"    - 8: magnitude acc. to NASA (equals attr[0] for partial and attr[1] for"
+"      annular and total eclipses)\n"
+"    - 9: saros series number (if available, otherwise -99999999)\n"
+"    - 10: saros series member number (if available, otherwise -99999999)\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_sol_eclipse_where FUNCARGS_KEYWDS
+{
+    double jd, geopos[10] = {0,0,0,0,0,0,0,0,0,0};
+    double attr[20] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    int i, flag = SEFLG_SWIEPH;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdut", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &flag))
+        return NULL;
+    i = swe_sol_eclipse_where(jd, flag, geopos, attr, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self),
+                            "swisseph.sol_eclipse_where: %s", err);
+    return Py_BuildValue("iNN", i, pyswe_dtuple(geopos, 10),
+                         pyswe_dtuple(attr, 20));
+}
+
+/* swisseph.solcross */
+PyDoc_STRVAR(pyswe_solcross__doc__,
+"Compute next Sun crossing over some longitude (ET).\n\n"
+":Args: float x2cross, float tjdet, int flags=FLG_SWIEPH\n\n"
+" - x2cross: longitude to search\n"
+" - tjdet: start time of search, Julian day number, Ephemeris Time\n"
+" - flags: bit flags indicating what computation is wanted\n\n"
+":Return: float jdcross\n\n"
+" - jdcross: Julian day number found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_solcross FUNCARGS_KEYWDS
+{
+    int flags = SEFLG_SWIEPH;
+    double x2, jd, res;
+    char err[256] = {0};
+    static char* kwlist[] = {"x2cross", "tjdet", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
+                                     &x2, &jd, &flags))
+        return NULL;
+    if ((res = swe_solcross(x2, jd, flags, err)) < jd)
+        return PyErr_Format(pyswe_error(self), "swisseph.solcross: %s", err);
+    return Py_BuildValue("d", res);
+}
+
+/* swisseph.solcross_ut */
+PyDoc_STRVAR(pyswe_solcross_ut__doc__,
+"Compute next Sun crossing over some longitude (UT).\n\n"
+":Args: float x2cross, float tjdut, int flags=FLG_SWIEPH\n\n"
+" - x2cross: longitude to search\n"
+" - tjdut: start time of search, Julian day number, Universal Time\n"
+" - flags: bit flags indicating what computation is wanted\n\n"
+":Return: float jdcross\n\n"
+" - jdcross: Julian day number found\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_solcross_ut FUNCARGS_KEYWDS
+{
+    int flags = SEFLG_SWIEPH;
+    double x2, jd, res;
+    char err[256] = {0};
+    static char* kwlist[] = {"x2cross", "tjdut", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
+                                     &x2, &jd, &flags))
+        return NULL;
+    if ((res = swe_solcross_ut(x2, jd, flags, err)) < jd)
+        return PyErr_Format(pyswe_error(self), "swisseph.solcross_ut: %s", err);
+    return Py_BuildValue("d", res);
+}
+
+/* swisseph.split_deg */
+PyDoc_STRVAR(pyswe_split_deg__doc__,
+"Provide sign or nakshatra, degree, minutes, seconds and fraction of second"
+" from decimal degree. Can also round to seconds, minutes, degrees.\n\n"
+":Args: float degree, int roundflag\n\n"
+" - degree: position in decimal degrees\n"
+" - roundflag: bit flags combination indicating how to round:\n"
+"    - 0: dont round\n"
+"    - SPLIT_DEG_ROUND_SEC: round to seconds\n"
+"    - SPLIT_DEG_ROUND_MIN: round to minutes\n"
+"    - SPLIT_DEG_ROUND_DEG: round to degrees\n"
+"    - SPLIT_DEG_ZODIACAL: with zodiac sign number\n"
+"    - SPLIT_DEG_NAKSHATRA: with nakshatra number\n"
+"    - SPLIT_DEG_KEEP_SIGN: dont round to next zodiac sign/nakshatra\n"
+"    - SPLIT_DEG_KEEP_DEG: dont round to next degree\n\n"
+":Return: deg, min, sec, secfr, sign\n\n"
+" - deg: returned degree\n"
+" - min: returned minutes\n"
+" - sec: returned seconds\n"
+" - secfr: returned fraction of second\n"
+" - sign: returned sign/nakshatra number");
+
+static PyObject * pyswe_split_deg FUNCARGS_KEYWDS
+{
+    double ddeg, secfr;
+    int deg, min, sec, sign, flag;
+    static char *kwlist[] = {"degree", "roundflag", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "di", kwlist, &ddeg, &flag))
+        return NULL;
+    swe_split_deg(ddeg, flag, &deg, &min, &sec, &secfr, &sign);
+    return Py_BuildValue("iiidi", deg, min, sec, secfr, sign);
+}
+
+/* swisseph.stats */
+PyDoc_STRVAR(pyswe_stats__doc__,
+"Get call statistics.\n\n"
+":Args: --\n"
+":Return: dict\n\n"
+"Statistics are collected after ``set_stats(True)``. The dict maps the names"
+" of the functions called (``'calc_ut'``, ``'contrib.next_aspect'``...) to"
+" dicts of:\n\n"
+" - calls: number of calls\n"
+" - errors: number of calls that raised an exception\n"
+" - time: cumulative time, in seconds\n"
+" - histogram: tuple of 32 counts, item i is the number of calls that took"
+" at least 2**i and less than 2**(i+1) nanoseconds (the first item counts"
+" shorter calls too, and the last one longer calls)");
+
+static PyObject * pyswe_stats FUNCARGS_SELF
+{
+    int i, err = 0;
+    Py_ssize_t pos = 0;
+    PyObject *res, *key, *o, *h, *d;
+    pyswe_Timed* t;
+    pyswe_Timed c; /* copy of the counters */
+    pyswe_State* st = pyswe_get_state(self);
+    if (!(res = PyDict_New()))
+        return NULL;
+    if (!st->stats_registry)
+        return res;
+    Py_BEGIN_CRITICAL_SECTION(st->stats_registry);
+    while (!err && PyDict_Next(st->stats_registry, &pos, &key, &o)) {
+        t = (pyswe_Timed*) o;
+        Py_BEGIN_CRITICAL_SECTION(t);
+        c.calls = t->calls;
+        c.errors = t->errors;
+        c.total = t->total;
+        memcpy(c.hist, t->hist, sizeof(c.hist));
+        Py_END_CRITICAL_SECTION();
+        if (!c.calls)
+            continue;
+        err = 1;
+        if (!(h = PyTuple_New(PYSWE_STATS_NBUCKETS)))
+            break;
+        for (i = 0; i < PYSWE_STATS_NBUCKETS; ++i) {
+            if (!(o = PyLong_FromUnsignedLongLong(c.hist[i])))
+                break;
+            PyTuple_SET_ITEM(h, i, o);
+        }
+        if (i < PYSWE_STATS_NBUCKETS) {
+            Py_DECREF(h);
+            break;
+        }
+        d = Py_BuildValue("{s:K,s:K,s:d,s:N}", "calls", c.calls,
+                          "errors", c.errors, "time", c.total * 1e-9,
+                          "histogram", h);
+        if (!d || PyDict_SetItem(res, key, d)) {
+            Py_XDECREF(d);
+            break;
+        }
+        Py_DECREF(d);
+        err = 0;
+    }
+    Py_END_CRITICAL_SECTION();
+    if (err)
+        Py_CLEAR(res);
+    return res;
+}
+
+/* swisseph.time_equ */
+PyDoc_STRVAR(pyswe_time_equ__doc__,
+"Calculate equation of time (UT).\n\n"
+":Args: float tjdut\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n\n"
+":Return: float e\n\n"
+" - e: difference between local apparent time and local mean time in days\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_time_equ FUNCARGS_KEYWDS
+{
+    int i;
+    double jd, ret;
+    char err[256] = {0};
+    static char *kwlist[] = {"tjdut", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d", kwlist, &jd))
+        return NULL;
+    i = swe_time_equ(jd, &ret, err);
+    if (i < 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.time_equ: %s", err);
+    return Py_BuildValue("d", ret);
+}
+
+/* swisseph.utc_time_zone */
+PyDoc_STRVAR(pyswe_utc_time_zone__doc__,
+"Transform local time to UTC or UTC to local time.\n\n"
+":Args: int year, int month, int day, int hour, int minutes, float seconds,"
 " float offset\n\n"
 " - year, month, day, hour, minutes, seconds: date and time\n"
 " - offset: timezone offset in hours (east of greenwich positive)\n\n"
@@ -3431,786 +8329,2902 @@ PyDoc_STRVAR(pyswe_utc_time_zone__doc__,
 "For conversion from local time to UTC, use +(offset). For conversion from"
 " UTC to local time, use -(offset).");
 
-static PyObject * pyswe_utc_time_zone FUNCARGS_KEYWDS
+static PyObject * pyswe_utc_time_zone FUNCARGS_KEYWDS
+{
+    int y, m, d, h, mi, y2, m2, d2, h2, mi2;
+    double s, tz, s2;
+    static char *kwlist[] = {"year", "month", "day", "hour", "minutes",
+                             "seconds", "offset", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iiiiidd", kwlist,
+                                     &y, &m, &d, &h, &mi, &s, &tz))
+        return NULL;
+    swe_utc_time_zone(y, m, d, h, mi, s, tz, &y2, &m2, &d2, &h2, &mi2, &s2);
+    return Py_BuildValue("iiiiid", y2, m2, d2, h2, mi2, s2);
+}
+
+/* swisseph.utc_to_jd */
+PyDoc_STRVAR(pyswe_utc_to_jd__doc__,
+"Convert UTC to julian day.\n\n"
+":Args: int year, int month, int day, int hour, int minutes, float seconds,"
+" int cal=GREG_CAL\n\n"
+" - year, month, day, hour, minutes, seconds: date and time\n"
+" - cal: either GREG_CAL or JUL_CAL\n\n"
+":Return: float jdet, float jdut\n\n"
+" - jdet: Julian day in ET (TT)\n"
+" - jdut: Julian day in UT (UT1)\n\n"
+"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.\n"
+"It raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_utc_to_jd FUNCARGS_KEYWDS
+{
+    int i, y, m, d, h, mi, flg = SE_GREG_CAL;
+    double s, dret[2];
+    char err[256] = {0};
+    static char *kwlist[] = {"year", "month", "day", "hour", "minutes",
+                             "seconds", "cal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iiiiid|i", kwlist,
+                                     &y, &m, &d, &h, &mi, &s, &flg))
+        return NULL;
+    if (flg != SE_GREG_CAL && flg != SE_JUL_CAL)
+        return PyErr_Format(PyExc_ValueError,
+                            "swisseph.utc_to_jd: invalid calendar (%d)", flg);
+    i = swe_utc_to_jd(y, m, d, h, mi, s, flg, dret, err);
+    if (i != 0)
+        return PyErr_Format(pyswe_error(self), "swisseph.utc_to_jd: %s", err);
+    return Py_BuildValue("dd", dret[0], dret[1]);
+}
+
+/* swisseph.vis_limit_mag */
+PyDoc_STRVAR(pyswe_vis_limit_mag__doc__,
+"Find the limiting visual magnitude in dark skies.\n\n"
+":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
+" int flags\n\n"
+" - tjdut: input time, Julian day number, Universal Time\n"
+" - geopos: a sequence with:\n"
+"    - 0: geographic longitude (eastern positive)\n"
+"    - 1: geographic latitude (northern positive)\n"
+"    - 2: altitude above sea level, in meters\n"
+" - atmo: a sequence with:\n"
+"    - 0: atmospheric pressure in mbar (hPa)\n"
+"    - 1: atmospheric temperature in degrees Celsius\n"
+"    - 2: relative humidity in %\n"
+"    - 3: if >= 1, Meteorological Range (km).\n"
+"      Between 1 and 0, total atmospheric coefficient (ktot).\n"
+"      If = 0, the other atmospheric parameters determine the total\n"
+"      atmospheric coefficient (ktot)\n"
+" - observer: a sequence with:\n"
+"    - 0: age of observer in years (default = 36)\n"
+"    - 1: snellen ratio of observers eyes (default = 1 = normal)\n"
+"    - The following parameters are only relevant if HELFLAG_OPTICAL_PARAMS\n"
+"      is set:\n"
+"    - 2: (0) = monocular, (1) = binocular (boolean)\n"
+"    - 3: telescope magnification, (0) = default to naked eye (binocular),\n"
+"      (1) = naked eye\n"
+"    - 4: optical aperture (telescope diameter) in mm\n"
+"    - 5: optical transmission\n"
+" - objname: name of planet or fixed star\n"
+" - flags: bit flags for ephemeris, and also:\n"
+"    - HELFLAG_OPTICAL_PARAMS: for optical instruments\n"
+"    - HELFLAG_NO_DETAILS: provide date, without details\n"
+"    - HELFLAG_VISLIM_DARK: behave as if Sun is at nadir\n"
+"    - HELFLAG_VISLIM_NOMOON: behave as if Moon is at nadir, i.e. the Moon as\n"
+"      a factor disturbing the observation is excluded, useful if one is not\n"
+"      interested in the heliacal date of that particular year, but in the\n"
+"      heliacal date of that epoch\n\n"
+":Return: float res, (dret)\n\n"
+" - res: result:\n"
+"    - (-2): object is below horizon\n"
+"    - (0): OK, photopic vision\n"
+"    - (1): OK, scotopic vision\n"
+"    - (2): OK, near limit photopic/scotopic vision\n"
+" - dret: a tuple of 10 float, of which:\n"
+"    - 0: limiting visual magnitude (if > magnitude of object, then the\n"
+"      object is visible)\n"
+"    - 1: altitude of object\n"
+"    - 2: azimuth of object\n"
+"    - 3: altitude of sun\n"
+"    - 4: azimuth of sun\n"
+"    - 5: altitude of moon\n"
+"    - 6: azimuth of moon\n"
+"    - 7: magnitude of object\n\n"
+"This function raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_vis_limit_mag FUNCARGS_KEYWDS
+{
+    double jd, geopos[3], atmo[4], observ[6], dres;
+    double dret[10] = {0,0,0,0,0,0,0,0,0,0};
+    char err[256] = {0}, *obj;
+    int i, flg;
+    PyObject *o1, *o2, *o3;
+    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
+                             "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsi", kwlist, &jd, &o1,
+                                     &o2, &o3, &obj, &flg))
+        return NULL;
+    /* extract geopos */
+    i = py_seq2d(o1, 3, geopos, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.vis_limit_mag: geopos: %s", err);
+    /* extract atmo */
+    i = py_seq2d(o2, 4, atmo, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                    "swisseph.vis_limit_mag: atmo: %s", err);
+    /* extract observer */
+    i = py_seq2d(o3, 6, observ, err);
+    if (i > 0)
+        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
+                                "swisseph.vis_limit_mag: observer: %s", err);
+    /* set topo params */
+    if (flg & SEFLG_TOPOCTR)
+        pyswe_settings_topo(geopos);
+    dres = swe_vis_limit_mag(jd, geopos, atmo, observ, obj, flg, dret, err);
+    if (dres != -1)
+        return Py_BuildValue("dN", dres, pyswe_dtuple(dret, 10));
+    return PyErr_Format(pyswe_error(self), "swisseph.vis_limit_mag: %s", err);
+}
+
+/* swisseph.write_ephemeris_table */
+PyDoc_STRVAR(pyswe_write_ephemeris_table__doc__,
+"Calculate a table of planetary positions for a range of dates, and write it"
+" to a file.\n\n"
+":Args: file, seq bodies, float jd_start, float jd_end, float step,"
+" int flags=FLG_SWIEPH|FLG_SPEED, bool ut=True, str format='csv',"
+" int chunk=16384, str errors='raise', list errlist=None\n\n"
+" - file: path of the file to write, or file descriptor (int, or object with"
+" a fileno() method, and its flush() method called before), written from its"
+" position and not closed\n"
+" - bodies, jd_start, jd_end, step, flags, ut: as EphemerisTable\n"
+" - format: 'csv' or 'binary'\n"
+" - chunk: number of rows computed at once\n"
+" - errors: policy for the rows in error (see calc_ut_array)\n"
+" - errlist: list where (index, message) of the rows in error are appended,"
+" if errors is not 'raise'\n\n"
+":Return: int, number of rows written\n\n"
+"Rows are the rows of EphemerisTable. They are computed by chunks by the"
+" thread pool, while the previous chunk is written, so that memory does not"
+" depend on the range of dates.\n\n"
+"The csv format has a header line with the column names, and floats written"
+" with 17 significant digits. The binary format (native byte order) has:\n\n"
+" - a header of 48 bytes: magic 'PYSWETB' (8 bytes with a null byte),"
+" int32 version (1), int32"
+" 0x01020304 (byte order), int32 number of columns (9), int32 number of"
+" bodies, int32 flags, int32 ut, float64 jd_start, float64 step\n"
+" - int32 body numbers, padded to 8 bytes\n"
+" - blocks of rows until the end of file: int64 number of rows, then each"
+" column, float64 or int32 values, padded to 8 bytes\n\n"
+"The flags of the binary header are those returned by the calculations of"
+" the first chunk: with ``FLG_SWIEPH`` and no ephemeris files, libswe"
+" computes with the Moshier ephemeris, and the header has ``FLG_MOSEPH``."
+" If the ephemeris used changes within the table (files missing for some"
+" dates), swisseph.Error is raised.\n\n"
+"With errors='raise', this function raises swisseph.Error for the first row"
+" in error, after the rows of the previous chunks were written. A file"
+" given by path is then removed.");
+
+#define PYSWE_TB_MAGIC          "PYSWETB"
+#define PYSWE_TB_VERSION        1
+#define PYSWE_TB_BYTEORDER      0x01020304
+
+/* Maximum length of a csv row: 7 floats (%.17g), 2 int, separators */
+#define PYSWE_CSV_ROW           (7 * 25 + 2 * 12 + 10)
+
+enum { PYSWE_TB_CSV, PYSWE_TB_BINARY };
+
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t byteorder;
+    int32_t ncols;
+    int32_t nbodies;
+    int32_t flags;
+    int32_t ut;
+    double jd_start;
+    double step;
+} pyswe_TBHeader;
+
+#ifdef WIN32
+#define pyswe_dup(fd)           _dup(fd)
+#define pyswe_fdopen(fd, mode)  _fdopen(fd, mode)
+#define pyswe_close(fd)         _close(fd)
+#else
+#define pyswe_dup(fd)           dup(fd)
+#define pyswe_fdopen(fd, mode)  fdopen(fd, mode)
+#define pyswe_close(fd)         close(fd)
+#endif
+
+/* A chunk of rows, computed, then written */
+typedef struct {
+    pyswe_TableJob t; /* first, for pyswe_table_run */
+    void* cols[PYSWE_TC_COUNT];
+    char* text; /* csv rows, PYSWE_CSV_ROW bytes each */
+    unsigned short* len; /* lengths of the csv rows */
+    Py_ssize_t n; /* rows */
+    int format;
+    FILE* fd;
+    int written; /* 1 when written (or failed) */
+    int err; /* errno of the write */
+    pyswe_Job job; /* of the write */
+} pyswe_TableChunk;
+
+/* Compute rows, and format them for csv */
+static void pyswe_table_chunk_run(pyswe_Job* job, Py_ssize_t start,
+                                  Py_ssize_t end)
+{
+    pyswe_TableChunk* a = (pyswe_TableChunk*) job->data;
+    Py_ssize_t i;
+    int k;
+    double** d = (double**) a->cols;
+    char* s;
+    pyswe_table_run(job, start, end);
+    if (a->format != PYSWE_TB_CSV)
+        return;
+    for (i = start; i < end; ++i) {
+        s = a->text + i * PYSWE_CSV_ROW;
+        k = snprintf(s, PYSWE_CSV_ROW, "%.17g,%d,%.17g,%.17g,%.17g,%.17g,%.17g,"
+                     "%.17g,%d\n", d[PYSWE_TC_JD][i],
+                     (int) ((int32_t*) a->cols[PYSWE_TC_BODY])[i],
+                     d[PYSWE_TC_LON][i], d[PYSWE_TC_LAT][i],
+                     d[PYSWE_TC_DIST][i], d[PYSWE_TC_LON_SPEED][i],
+                     d[PYSWE_TC_LAT_SPEED][i], d[PYSWE_TC_DIST_SPEED][i],
+                     (int) ((int32_t*) a->cols[PYSWE_TC_RETFLAGS])[i]);
+        a->len[i] = (unsigned short) (k < PYSWE_CSV_ROW ? k
+                                      : PYSWE_CSV_ROW - 1);
+    }
+}
+
+/* Write 0 bytes of padding to a multiple of 8 bytes
+ * Return 0 on success.
+ */
+static int pyswe_write_pad(FILE* fd, size_t size)
+{
+    static const char zeros[8] = {0};
+    size %= 8;
+    return size && fwrite(zeros, 8 - size, 1, fd) != 1;
+}
+
+/* Write the rows of a chunk, in a worker */
+static void pyswe_table_chunk_write(pyswe_Job* job, Py_ssize_t start,
+                                    Py_ssize_t end)
+{
+    pyswe_TableChunk* a = (pyswe_TableChunk*) job->data;
+    Py_ssize_t i;
+    int64_t n = a->n;
+    size_t size;
+    int x = 0;
+    if (a->format == PYSWE_TB_CSV) {
+        for (i = 0; !x && i < a->n; ++i)
+            x = fwrite(a->text + i * PYSWE_CSV_ROW, a->len[i], 1, a->fd) != 1;
+    }
+    else {
+        x = fwrite(&n, sizeof(int64_t), 1, a->fd) != 1;
+        for (i = 0; !x && i < PYSWE_TC_COUNT; ++i) {
+            size = pyswe_table_itemsize(i) * a->n;
+            x = (size && fwrite(a->cols[i], size, 1, a->fd) != 1)
+                || pyswe_write_pad(a->fd, size);
+        }
+    }
+    a->err = x ? (errno ? errno : EIO) : 0;
+}
+
+static void pyswe_table_chunk_written(pyswe_Job* job)
+{
+    pyswe_lock(&pyswe_pool.lock);
+    ((pyswe_TableChunk*) job->data)->written = 1;
+    --pyswe_pool.pending;
+    pyswe_cond_broadcast(&pyswe_pool.done);
+    pyswe_unlock(&pyswe_pool.lock);
+}
+
+/* Start the write of a chunk, by a worker if possible */
+static void pyswe_table_chunk_submit(pyswe_TableChunk* a)
+{
+    a->written = 0;
+    a->job.func = pyswe_table_chunk_write;
+    a->job.complete = pyswe_table_chunk_written;
+    a->job.data = a;
+    a->job.n = 1;
+    if (!pyswe_pool_submit(&a->job))
+        return;
+    Py_BEGIN_ALLOW_THREADS
+    pyswe_table_chunk_write(&a->job, 0, 1);
+    Py_END_ALLOW_THREADS
+    a->written = 1;
+}
+
+/* Wait for the write of a chunk, if any */
+static void pyswe_table_chunk_wait(pyswe_TableChunk* a)
+{
+    if (a->written)
+        return;
+    Py_BEGIN_ALLOW_THREADS
+    pyswe_lock(&pyswe_pool.lock);
+    while (!a->written)
+        pyswe_cond_wait(&pyswe_pool.done, &pyswe_pool.lock);
+    pyswe_unlock(&pyswe_pool.lock);
+    Py_END_ALLOW_THREADS
+}
+
+/* Write the header of the table (csv column names, or binary header)
+ * Return 0 on success.
+ */
+static int pyswe_table_header(FILE* fd, int format, pyswe_TBHeader* hdr,
+                              const int* pl)
+{
+    int i, x = 0;
+    if (format == PYSWE_TB_CSV) {
+        for (i = 0; !x && i < PYSWE_TC_COUNT; ++i)
+            x = fputs(pyswe_table_columns[i].name, fd) == EOF
+                || fputc(i == PYSWE_TC_COUNT - 1 ? '\n' : ',', fd) == EOF;
+        return x;
+    }
+    memcpy(hdr->magic, PYSWE_TB_MAGIC, sizeof(PYSWE_TB_MAGIC));
+    hdr->version = PYSWE_TB_VERSION;
+    hdr->byteorder = PYSWE_TB_BYTEORDER;
+    hdr->ncols = PYSWE_TC_COUNT;
+    return fwrite(hdr, sizeof(pyswe_TBHeader), 1, fd) != 1
+        || fwrite(pl, sizeof(int), hdr->nbodies, fd) != (size_t) hdr->nbodies
+        || pyswe_write_pad(fd, sizeof(int) * hdr->nbodies);
+}
+
+/* Check the ephemeris used by the rows of a chunk (rows in error skipped),
+ * that must be the same for all. *eph is 0 until known.
+ * Return 1 if it changed.
+ */
+static int pyswe_table_chunk_eph(pyswe_TableChunk* a, int* eph)
+{
+    Py_ssize_t i;
+    int32_t r, *ret = (int32_t*) a->cols[PYSWE_TC_RETFLAGS];
+    for (i = 0; i < a->n; ++i) {
+        if ((r = ret[i]) < 0)
+            continue;
+        if (!*eph)
+            *eph = r & PYSWE_EPHMASK;
+        else if ((r & PYSWE_EPHMASK) != *eph)
+            return 1;
+    }
+    return 0;
+}
+
+/* Open the file to write, by path or file descriptor
+ * Return NULL on error, with an exception set. *path is to be released.
+ */
+static FILE * pyswe_table_open(PyObject* file, PyObject** path)
+{
+    FILE* fd;
+    PyObject* o;
+    int i;
+    *path = NULL;
+    if (PyLong_Check(file) || PyObject_HasAttrString(file, "fileno")) {
+        /* data buffered by Python goes before the table */
+        if (!PyLong_Check(file) && PyObject_HasAttrString(file, "flush")) {
+            if (!(o = PyObject_CallMethod(file, "flush", NULL)))
+                return NULL;
+            Py_DECREF(o);
+        }
+        if ((i = PyObject_AsFileDescriptor(file)) < 0)
+            return NULL;
+        if ((i = pyswe_dup(i)) < 0)
+            return (FILE*) PyErr_SetFromErrno(PyExc_OSError);
+        if (!(fd = pyswe_fdopen(i, "wb"))) {
+            PyErr_SetFromErrno(PyExc_OSError);
+            pyswe_close(i);
+        }
+        return fd;
+    }
+    if (!PyUnicode_FSConverter(file, path))
+        return NULL;
+    if (!(fd = fopen(PyBytes_AS_STRING(*path), "wb")))
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, file);
+    return fd;
+}
+
+static PyObject * pyswe_write_ephemeris_table FUNCARGS_KEYWDS
+{
+    pyswe_TableChunk chunks[2], *a;
+    pyswe_TBHeader hdr;
+    pyswe_Job job;
+    PyObject *file, *bodies, *path = NULL, *errlist = NULL;
+    Py_ssize_t ndates, nrows, row = 0, size = 16384;
+    double end;
+    int i, k, x = 0, ut = 1, flag = SEFLG_SWIEPH|SEFLG_SPEED, nbodies, *pl;
+    int eph = 0;
+    char *format = "csv", *errors = "raise";
+    FILE* fd;
+    static char *kwlist[] = {"file", "bodies", "jd_start", "jd_end", "step",
+                             "flags", "ut", "format", "chunk", "errors",
+                             "errlist", NULL};
+    memset(chunks, 0, sizeof(chunks));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOddd|iisnsO", kwlist,
+                                     &file, &bodies, &hdr.jd_start, &end,
+                                     &hdr.step, &flag, &ut, &format, &size,
+                                     &errors, &errlist)
+        || pyswe_job_policy(&job, errors, errlist, "write_ephemeris_table"))
+        return NULL;
+    if (strcmp(format, "csv") && strcmp(format, "binary"))
+        return PyErr_Format(PyExc_ValueError, "swisseph.write_ephemeris_table:"
+                            " format: must be 'csv' or 'binary', not '%s'",
+                            format);
+    if (size < 1 || size > 1 << 24)
+        return PyErr_Format(PyExc_ValueError, "swisseph.write_ephemeris_table:"
+                            " chunk: must be in 1..%d", 1 << 24);
+    if (pyswe_table_args(bodies, hdr.jd_start, end, hdr.step,
+                         "write_ephemeris_table", &pl, &nbodies, &ndates))
+        return NULL;
+    nrows = ndates * nbodies;
+    for (k = 0; k < 2; ++k) {
+        a = &chunks[k];
+        a->written = 1;
+        a->format = *format == 'c' ? PYSWE_TB_CSV : PYSWE_TB_BINARY;
+        a->t.jd_start = hdr.jd_start;
+        a->t.step = hdr.step;
+        a->t.bodies = pl;
+        a->t.nbodies = nbodies;
+        a->t.flag = flag;
+        a->t.ut = ut;
+        a->t.nan = job.errors == PYSWE_ERRORS_NAN;
+        a->t.cols = a->cols;
+        for (i = 0; !x && i < PYSWE_TC_COUNT; ++i)
+            x = !(a->cols[i] = PyMem_RawMalloc(pyswe_table_itemsize(i) * size));
+        if (!x && a->format == PYSWE_TB_CSV)
+            x = !(a->text = PyMem_RawMalloc(PYSWE_CSV_ROW * size))
+                || !(a->len = PyMem_RawMalloc(sizeof(unsigned short) * size));
+    }
+    if (x) {
+        PyErr_NoMemory();
+        goto end;
+    }
+    if (!(fd = pyswe_table_open(file, &path))) {
+        x = 1;
+        goto end;
+    }
+    hdr.nbodies = nbodies;
+    hdr.flags = flag;
+    hdr.ut = ut;
+    /* compute a chunk while the previous one is written, the header is
+     * written with the flags returned by the first one */
+    for (k = 0; row < nrows; k ^= 1) {
+        a = &chunks[k];
+        a->fd = fd;
+        a->n = nrows - row < size ? nrows - row : size;
+        a->t.row0 = row;
+        job.func = pyswe_table_chunk_run;
+        job.data = a;
+        job.n = a->n;
+        job.chunk = 32;
+        pyswe_pool_run(&job);
+        pyswe_table_chunk_wait(&chunks[k ^ 1]);
+        if ((x = chunks[k ^ 1].err) != 0) {
+            errno = x;
+            PyErr_SetFromErrno(PyExc_OSError);
+            goto close;
+        }
+        if ((x = pyswe_job_errors(&job, pyswe_error(self),
+                                  "write_ephemeris_table", errlist)))
+            goto close;
+        if ((x = pyswe_table_chunk_eph(a, &eph))) {
+            PyErr_SetString(pyswe_error(self), "swisseph.write_ephemeris_table:"
+                            " ephemeris changed within the table (missing"
+                            " files?)");
+            goto close;
+        }
+        if (row == 0) {
+            if (eph)
+                hdr.flags = (flag & ~PYSWE_EPHMASK) | eph;
+            Py_BEGIN_ALLOW_THREADS
+            x = pyswe_table_header(fd, a->format, &hdr, pl);
+            Py_END_ALLOW_THREADS
+            if (x) {
+                PyErr_SetFromErrno(PyExc_OSError);
+                goto close;
+            }
+        }
+        pyswe_table_chunk_submit(a);
+        row += a->n;
+    }
+    pyswe_table_chunk_wait(&chunks[k ^ 1]);
+    if ((x = chunks[k ^ 1].err) != 0) {
+        errno = x;
+        PyErr_SetFromErrno(PyExc_OSError);
+    }
+close:
+    if (fclose(fd) && !x) {
+        x = 1;
+        PyErr_SetFromErrno(PyExc_OSError);
+    }
+    if (x && path)
+        remove(PyBytes_AS_STRING(path));
+end:
+    for (k = 0; k < 2; ++k) {
+        for (i = 0; i < PYSWE_TC_COUNT; ++i)
+            PyMem_RawFree(chunks[k].cols[i]);
+        PyMem_RawFree(chunks[k].text);
+        PyMem_RawFree(chunks[k].len);
+    }
+    PyMem_Free(pl);
+    Py_XDECREF(path);
+    return x ? NULL : PyLong_FromSsize_t(nrows);
+}
+
+#if PYSWE_USE_SWEPHELP /* Pyswisseph contrib submodule */
+
+/* swisseph.contrib.Error (module exception type) */
+#define pyswh_error(m)      (pyswh_get_state(m)->contrib_error)
+
+/* The atlas and astro database connections of swephelp are process wide,
+ * calls using them hold this lock.
+ */
+static pyswe_lock_t pyswh_db_lock = PYSWE_LOCK_INIT;
+
+#define PYSWH_DB_CALL(x) do { \
+        pyswe_lock_nogil(&pyswh_db_lock); \
+        x; \
+        pyswe_unlock(&pyswh_db_lock); \
+    } while (0)
+
+/* Same, without the GIL (x must not use the Python API) */
+#define PYSWH_DB_CALL_NOGIL(x) do { \
+        Py_BEGIN_ALLOW_THREADS \
+        pyswe_lock(&pyswh_db_lock); \
+        x; \
+        pyswe_unlock(&pyswh_db_lock); \
+        Py_END_ALLOW_THREADS \
+    } while (0)
+
+/* Same, in a critical section of op (x may use the Python API)
+ * Releasing the GIL would suspend the critical section, and let another
+ * thread change op during the call. The lock is waited for outside of it,
+ * and x runs when it is taken inside.
+ */
+#define PYSWH_DB_CALL_OBJ(op, x) do { \
+        int pyswh_done_ = 0; \
+        while (!pyswh_done_) { \
+            Py_BEGIN_CRITICAL_SECTION(op); \
+            if (pyswe_trylock(&pyswh_db_lock)) { \
+                x; \
+                pyswe_unlock(&pyswh_db_lock); \
+                pyswh_done_ = 1; \
+            } \
+            Py_END_CRITICAL_SECTION(); \
+            if (!pyswh_done_) { \
+                Py_BEGIN_ALLOW_THREADS \
+                pyswe_lock(&pyswh_db_lock); \
+                pyswe_unlock(&pyswh_db_lock); \
+                Py_END_ALLOW_THREADS \
+            } \
+        } \
+    } while (0)
+
+/* Rows of strings, collected without the GIL, made Python objects after */
+typedef struct {
+    int ncols;
+    int nomem; /* memory error */
+    Py_ssize_t nrows;
+    Py_ssize_t size;
+    char** cells; /* row i at cells + i * ncols */
+} pyswh_Rows;
+
+#define pyswh_rows_init(r, n) do { \
+        (r)->ncols = (n); \
+        (r)->nomem = 0; \
+        (r)->nrows = (r)->size = 0; \
+        (r)->cells = NULL; \
+    } while (0)
+
+#define pyswh_rows_get(r, i)    ((r)->cells + (i) * (r)->ncols)
+
+/* Add a row (NULL values are empty strings)
+ * Return > 0 on memory error
+ */
+static int pyswh_rows_add(pyswh_Rows* r, const char* const* values)
+{
+    char** row, **p;
+    Py_ssize_t n;
+    int i;
+    if (r->nrows == r->size) {
+        n = r->size ? r->size * 2 : 16;
+        if (!(p = PyMem_RawRealloc(r->cells, sizeof(char*) * n * r->ncols))) {
+            r->nomem = 1;
+            return 1;
+        }
+        r->cells = p;
+        r->size = n;
+    }
+    row = pyswh_rows_get(r, r->nrows);
+    for (i = 0; i < r->ncols; ++i) {
+        n = values[i] ? strlen(values[i]) : 0;
+        if (!(row[i] = PyMem_RawMalloc(n + 1))) {
+            while (i--)
+                PyMem_RawFree(row[i]);
+            r->nomem = 1;
+            return 1;
+        }
+        memcpy(row[i], values[i] ? values[i] : "", n);
+        row[i][n] = '\0';
+    }
+    ++r->nrows;
+    return 0;
+}
+
+static void pyswh_rows_free(pyswh_Rows* r)
+{
+    Py_ssize_t i;
+    for (i = 0; i < r->nrows * r->ncols; ++i)
+        PyMem_RawFree(r->cells[i]);
+    PyMem_RawFree(r->cells);
+    r->cells = NULL;
+    r->nrows = r->size = 0;
+}
+
+/* Callback of swephelp queries, collecting pyswh_Rows */
+static int pyswh_rows_cb(void* p, int argc, char** argv, char** cols)
+{
+    pyswh_Rows* r = (pyswh_Rows*) p;
+    if (argc < r->ncols)
+        return 1;
+    return pyswh_rows_add(r, (const char* const*) argv);
+}
+
+/* Pool of read connections
+ *
+ * Queries of the astro database written in this module (swephelp runs its
+ * own on its connection) take a read-only connection of this pool, to run
+ * without pyswh_db_lock, and without the GIL. A connection is used by one
+ * thread at a time, with the statements it prepared. The astro database is
+ * put in WAL mode, so that reads do not wait for the writes of swephelp.
+ * Connections of a previous database are closed when given back.
+ */
+#define PYSWH_POOL_IDLE     8 /* connections kept */
+#define PYSWH_POOL_STMTS    8 /* statements kept by a connection */
+
+typedef struct {
+    sqlite3* db;
+    unsigned long gen; /* of the pool when opened */
+    int nstmts;
+    const char* sql[PYSWH_POOL_STMTS];
+    sqlite3_stmt* stmts[PYSWH_POOL_STMTS];
+} pyswh_Conn;
+
+static struct {
+    pyswe_lock_t lock;
+    char* path; /* of the astro database, NULL if unknown */
+    unsigned long gen; /* changed with the path */
+    int nidle;
+    pyswh_Conn* idle[PYSWH_POOL_IDLE];
+} pyswh_pool = {PYSWE_LOCK_INIT, NULL, 0, 0, {NULL}};
+
+static void pyswh_conn_close(pyswh_Conn* c)
+{
+    int i;
+    for (i = 0; i < c->nstmts; ++i)
+        sqlite3_finalize(c->stmts[i]);
+    sqlite3_close(c->db);
+    PyMem_RawFree(c);
+}
+
+/* Set the path of the astro database (NULL when closed)
+ * Without a path (or memory), the pool is unused.
+ */
+static void pyswh_pool_set_path(const char* path)
+{
+    pyswh_Conn* idle[PYSWH_POOL_IDLE];
+    char* p = NULL;
+    int i, n;
+    /* a file, not a temporary or in-memory database */
+    if (path && *path && strcmp(path, ":memory:")
+        && (p = PyMem_RawMalloc(strlen(path) + 1)))
+        strcpy(p, path);
+    pyswe_lock(&pyswh_pool.lock);
+    PyMem_RawFree(pyswh_pool.path);
+    pyswh_pool.path = p;
+    ++pyswh_pool.gen;
+    n = pyswh_pool.nidle;
+    memcpy(idle, pyswh_pool.idle, sizeof(pyswh_Conn*) * n);
+    pyswh_pool.nidle = 0;
+    pyswe_unlock(&pyswh_pool.lock);
+    for (i = 0; i < n; ++i)
+        pyswh_conn_close(idle[i]);
+}
+
+/* Take a connection of the pool
+ * Return 0, -1 if there is no pool, or > 0 on error (err set)
+ */
+static int pyswh_pool_get(pyswh_Conn** c, char* err)
+{
+    char* path = NULL;
+    unsigned long gen;
+    *c = NULL;
+    pyswe_lock(&pyswh_pool.lock);
+    if (pyswh_pool.nidle)
+        *c = pyswh_pool.idle[--pyswh_pool.nidle];
+    else if (pyswh_pool.path
+             && (path = PyMem_RawMalloc(strlen(pyswh_pool.path) + 1)))
+        strcpy(path, pyswh_pool.path);
+    gen = pyswh_pool.gen;
+    pyswe_unlock(&pyswh_pool.lock);
+    if (*c)
+        return 0;
+    if (!path)
+        return -1;
+    if (!(*c = PyMem_RawMalloc(sizeof(pyswh_Conn)))) {
+        PyMem_RawFree(path);
+        strcpy(err, "out of memory");
+        return 1;
+    }
+    (*c)->gen = gen;
+    (*c)->nstmts = 0;
+    if (sqlite3_open_v2(path, &(*c)->db, SQLITE_OPEN_READONLY
+                        |SQLITE_OPEN_NOMUTEX, NULL) != SQLITE_OK) {
+        snprintf(err, 512, "%s: %s", path, (*c)->db ?
+                 sqlite3_errmsg((*c)->db) : "out of memory");
+        PyMem_RawFree(path);
+        pyswh_conn_close(*c);
+        *c = NULL;
+        return 1;
+    }
+    PyMem_RawFree(path);
+    sqlite3_busy_timeout((*c)->db, 5000);
+    return 0;
+}
+
+/* Give back a connection to the pool */
+static void pyswh_pool_put(pyswh_Conn* c)
+{
+    pyswe_lock(&pyswh_pool.lock);
+    if (c->gen == pyswh_pool.gen && pyswh_pool.nidle < PYSWH_POOL_IDLE) {
+        pyswh_pool.idle[pyswh_pool.nidle++] = c;
+        c = NULL;
+    }
+    pyswe_unlock(&pyswh_pool.lock);
+    if (c)
+        pyswh_conn_close(c);
+}
+
+/* Get a statement of a connection, prepared once (sql is static)
+ * Return NULL on error (err set)
+ */
+static sqlite3_stmt * pyswh_conn_stmt(pyswh_Conn* c, const char* sql,
+                                      char* err)
+{
+    sqlite3_stmt* stmt;
+    int i;
+    for (i = 0; i < c->nstmts; ++i) {
+        if (c->sql[i] == sql)
+            return c->stmts[i];
+    }
+    if (sqlite3_prepare_v2(c->db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        snprintf(err, 512, "%s", sqlite3_errmsg(c->db));
+        return NULL;
+    }
+    if (c->nstmts == PYSWH_POOL_STMTS) {
+        /* forget the oldest */
+        sqlite3_finalize(c->stmts[0]);
+        memmove(c->sql, c->sql + 1, sizeof(char*) * (PYSWH_POOL_STMTS - 1));
+        memmove(c->stmts, c->stmts + 1,
+                sizeof(sqlite3_stmt*) * (PYSWH_POOL_STMTS - 1));
+        --c->nstmts;
+    }
+    c->sql[c->nstmts] = sql;
+    c->stmts[c->nstmts++] = stmt;
+    return stmt;
+}
+
+/* Run a query of the astro database, without arguments, into rows
+ * With the pool, or else the connection of swephelp. Without the GIL.
+ * Return > 0 on error (err set, or rows->nomem)
+ */
+static int pyswh_db_rows(const char* sql, pyswh_Rows* rows, char* err)
+{
+    pyswh_Conn* c;
+    sqlite3_stmt* stmt;
+    const char* values[16];
+    int i, x;
+    if ((x = pyswh_pool_get(&c, err)) < 0) {
+        pyswe_lock(&pyswh_db_lock);
+        x = swh_db_exec(sql, &pyswh_rows_cb, rows, err);
+        pyswe_unlock(&pyswh_db_lock);
+        return x;
+    }
+    if (x)
+        return x;
+    if (!(stmt = pyswh_conn_stmt(c, sql, err))) {
+        pyswh_pool_put(c);
+        return 1;
+    }
+    while ((x = sqlite3_step(stmt)) == SQLITE_ROW) {
+        for (i = 0; i < rows->ncols && i < 16; ++i)
+            values[i] = (const char*) sqlite3_column_text(stmt, i);
+        if (pyswh_rows_add(rows, values))
+            break;
+    }
+    if (x != SQLITE_DONE && !rows->nomem)
+        snprintf(err, 512, "%s", sqlite3_errmsg(c->db));
+    sqlite3_reset(stmt);
+    pyswh_pool_put(c);
+    return x != SQLITE_DONE;
+}
+
+/* generic object holding a pointer */
+
+#define pyswh_Object_new(tp)    ((pyswh_Object*) (tp)->tp_alloc((tp), 0))
+#define pyswh_Object_dealloc(o) do { \
+        PyTypeObject* tp_ = Py_TYPE(o); \
+        tp_->tp_free((PyObject*)o); \
+        Py_DECREF(tp_); /* heap type */ \
+    } while (0)
+
+typedef struct {
+    PyObject_HEAD
+    void* p;
+} pyswh_Object;
+
+/* get-setters */
+
+typedef struct {
+    double (*get)(void*);
+    int (*set)(void*, double);
+} pyswh_double_getsetter;
+
+typedef struct {
+    long (*get)(void*);
+    int (*set)(void*, long);
+} pyswh_long_getsetter;
+
+typedef struct {
+    const char* (*get)(void*);
+    int (*set)(void*, const char*);
+} pyswh_string_getsetter;
+
+typedef struct {
+    unsigned long (*get)(void*);
+    int (*set)(void*, unsigned long);
+} pyswh_ulong_getsetter;
+
+static PyObject * pyswh_Object_get_double(pyswh_Object* self, void* cl)
+{
+    double d;
+    PyObject* o;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    d = ((pyswh_double_getsetter*)cl)->get(self->p);
+    Py_END_CRITICAL_SECTION();
+    o = PyFloat_FromDouble(d);
+    return o ? o : PyErr_NoMemory();
+}
+
+static int pyswh_Object_set_double(pyswh_Object* self, PyObject* val, void* cl)
+{
+    int x;
+    double d;
+    if (PyFloat_Check(val))
+        d = PyFloat_AsDouble(val);
+    else if (PyLong_Check(val))
+        d = PyLong_AsDouble(val);
+    else {
+        PyErr_SetString(PyExc_TypeError, "must be a float");
+        return -1;
+    }
+    if (d == -1 && PyErr_Occurred())
+        return -1;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if ((x = ((pyswh_double_getsetter*)cl)->set(self->p, d))) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
+        swhxx_clear_error(self->p);
+    }
+    Py_END_CRITICAL_SECTION();
+    return x ? -1 : 0;
+}
+
+static PyObject * pyswh_Object_get_long(pyswh_Object* self, void* cl)
+{
+    long i;
+    PyObject* o;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    i = ((pyswh_long_getsetter*)cl)->get(self->p);
+    Py_END_CRITICAL_SECTION();
+    o = PyLong_FromLong(i);
+    return o ? o : PyErr_NoMemory();
+}
+
+static int pyswh_Object_set_long(pyswh_Object* self, PyObject* val, void* cl)
+{
+    int x;
+    long i;
+    if (!PyLong_Check(val)) {
+        PyErr_SetString(PyExc_TypeError, "must be an int");
+        return -1;
+    }
+    i = PyLong_AsLong(val);
+    if (i == -1 && PyErr_Occurred())
+        return -1;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if ((x = ((pyswh_long_getsetter*)cl)->set(self->p, i))) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
+        swhxx_clear_error(self->p);
+    }
+    Py_END_CRITICAL_SECTION();
+    return x ? -1 : 0;
+}
+
+static PyObject * pyswh_Object_get_string(pyswh_Object* self, void* cl)
+{
+    PyObject* o;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    o = PyUnicode_FromString(((pyswh_string_getsetter*)cl)->get(self->p));
+    Py_END_CRITICAL_SECTION();
+    return o ? o : PyErr_NoMemory();
+}
+
+static int pyswh_Object_set_string(pyswh_Object* self, PyObject* val, void* cl)
+{
+    int x;
+    char* str;
+    if (!PyUnicode_Check(val)) {
+        PyErr_SetString(PyExc_TypeError, "must be a string");
+        return -1;
+    }
+    str = (char*) PyUnicode_AsUTF8(val);
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if ((x = ((pyswh_string_getsetter*)cl)->set(self->p, str))) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
+        swhxx_clear_error(self->p);
+    }
+    Py_END_CRITICAL_SECTION();
+    return x ? -1 : 0;
+}
+
+static PyObject * pyswh_Object_get_ulong(pyswh_Object* self, void* cl)
+{
+    unsigned long i;
+    PyObject* o;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    i = ((pyswh_ulong_getsetter*)cl)->get(self->p);
+    Py_END_CRITICAL_SECTION();
+    o = PyLong_FromUnsignedLong(i);
+    return o ? o : PyErr_NoMemory();
+}
+#if 0
+static int pyswh_Object_set_ulong(pyswh_Object* self, PyObject* val, void* cl)
+{
+    int x;
+    unsigned long i;
+    if (!PyLong_Check(val)) {
+        PyErr_SetString(PyExc_TypeError, "must be an int");
+        return -1;
+    }
+    i = PyLong_AsUnsignedLong(val);
+    if (i == -1 && PyErr_Occurred())
+        return -1;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if ((x = ((pyswh_ulong_getsetter*)cl)->set(self->p, i))) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
+        swhxx_clear_error(self->p);
+    }
+    Py_END_CRITICAL_SECTION();
+    return x ? -1 : 0;
+}
+#endif
+static int pyswh_Object_set_readonly(pyswh_Object* s, PyObject* val, void* cl)
+{
+    PyErr_SetString(PyExc_AttributeError, "read-only attribute");
+    return -1;
+}
+
+/* swisseph.contrib.User */
+PyDoc_STRVAR(pyswh_User__doc__,
+"User of the database");
+PyDoc_STRVAR(pyswh_User_idx__doc__,
+"User idx");
+PyDoc_STRVAR(pyswh_User_name__doc__,
+"User name");
+PyDoc_STRVAR(pyswh_User_pswd__doc__,
+"User password");
+PyDoc_STRVAR(pyswh_User_mail__doc__,
+"User mail");
+PyDoc_STRVAR(pyswh_User_info__doc__,
+"User info");
+PyDoc_STRVAR(pyswh_User_drop__doc__,
+"Delete the user from database.\n\n"
+":Args: --\n"
+":Return: None\n\n"
+"Raises KeyError if not found.");
+PyDoc_STRVAR(pyswh_User_list__doc__,
+"List all users in database.\n\n"
+":Args: str orderby='name'\n\n"
+" - orderby: order by index ('idx'), by name ('name')\n\n"
+":Return: list of swh.User instances");
+PyDoc_STRVAR(pyswh_User_root__doc__,
+"Load the default user (root) from database\n\n"
+":Args: --\n"
+":Return: swh.User instance");
+PyDoc_STRVAR(pyswh_User_save__doc__,
+"Save user in database.\n\n"
+":Args: --\n"
+":Return: None\n\n"
+"Raises KeyError if duplicate or name is invalid.");
+PyDoc_STRVAR(pyswh_User_select__doc__,
+"Load a user from database\n\n"
+":Args: str name\n"
+":Return: swh.User instance\n\n"
+"Raises KeyError if not found or name is invalid.");
+
+static PyObject * pyswh_User_new(PyTypeObject* tp, PyObject* args, PyObject* kwds)
+{
+    pyswh_Object* self = pyswh_Object_new(tp);
+    if (self) {
+        swhxx_db_user_new(&self->p);
+        if (!self->p) {
+            pyswh_Object_dealloc(self);
+            self = NULL;
+        }
+    }
+    return (PyObject*) self;
+}
+
+static void pyswh_User_dealloc(pyswh_Object* self)
+{
+    if (self->p)
+        swhxx_db_user_dealloc(&self->p);
+    pyswh_Object_dealloc(self);
+}
+
+static int pyswh_User_init(pyswh_Object* self, PyObject* args, PyObject* kwds)
+{
+    char* name = "?", *pswd = "", *mail = "", *info = "";
+    static char* kwlist[] = {"name", "pswd", "mail", "info", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ssss", kwlist,
+                                     &name, &pswd, &mail, &info))
+        return -1;
+    if (swhxx_db_user_set_name(self->p, name)
+        || swhxx_db_user_set_pswd(self->p, pswd)
+        || swhxx_db_user_set_mail(self->p, mail)
+        || swhxx_db_user_set_info(self->p, info)) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
+        swhxx_clear_error(self->p);
+        return -1;
+    }
+    return 0;
+}
+
+static pyswh_ulong_getsetter pyswh_User_getset_idx = {
+    &swhxx_db_user_get_idx, NULL
+};
+static pyswh_string_getsetter pyswh_User_getset_name = {
+    &swhxx_db_user_get_name, &swhxx_db_user_set_name
+};
+static pyswh_string_getsetter pyswh_User_getset_pswd = {
+    &swhxx_db_user_get_pswd, &swhxx_db_user_set_pswd
+};
+static pyswh_string_getsetter pyswh_User_getset_mail = {
+    &swhxx_db_user_get_mail, &swhxx_db_user_set_mail
+};
+static pyswh_string_getsetter pyswh_User_getset_info = {
+    &swhxx_db_user_get_info, &swhxx_db_user_set_info
+};
+
+static PyGetSetDef pyswh_User_getsetters[] = {
+{"_idx", (getter) pyswh_Object_get_ulong, (setter) pyswh_Object_set_readonly,
+    pyswh_User_idx__doc__, &pyswh_User_getset_idx},
+{"name", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_User_name__doc__, &pyswh_User_getset_name},
+{"pswd", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_User_pswd__doc__, &pyswh_User_getset_pswd},
+{"mail", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_User_mail__doc__, &pyswh_User_getset_mail},
+{"info", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_User_info__doc__, &pyswh_User_getset_info},
+{NULL}
+};
+
+static PyObject * pyswh_User_drop FUNCARGS_SELF;
+static PyObject * pyswh_User_list FUNCARGS_KEYWDS;
+static PyObject * pyswh_User_root FUNCARGS_SELF;
+static PyObject * pyswh_User_save FUNCARGS_SELF;
+static PyObject * pyswh_User_select FUNCARGS_KEYWDS;
+
+static PyMethodDef pyswh_User_methods[] = {
+{"drop", (PyCFunction) pyswh_User_drop,
+    METH_NOARGS, pyswh_User_drop__doc__},
+{"list", (PyCFunction) pyswh_User_list,
+    METH_CLASS|METH_VARARGS|METH_KEYWORDS, pyswh_User_list__doc__},
+{"root", (PyCFunction) pyswh_User_root,
+    METH_CLASS|METH_NOARGS, pyswh_User_root__doc__},
+{"save", (PyCFunction) pyswh_User_save,
+    METH_NOARGS, pyswh_User_save__doc__},
+{"select", (PyCFunction) pyswh_User_select,
+    METH_CLASS|METH_VARARGS|METH_KEYWORDS, pyswh_User_select__doc__},
+{NULL}
+};
+
+static PyType_Slot pyswh_User_slots[] = {
+    {Py_tp_doc, (void*) pyswh_User__doc__},
+    {Py_tp_new, pyswh_User_new},
+    {Py_tp_init, pyswh_User_init},
+    {Py_tp_dealloc, pyswh_User_dealloc},
+    {Py_tp_methods, pyswh_User_methods},
+    {Py_tp_getset, pyswh_User_getsetters},
+    {0, NULL}
+};
+
+static PyType_Spec pyswh_User_spec = {
+    .name = "swisseph.contrib.User",
+    .basicsize = sizeof(pyswh_Object),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+    .slots = pyswh_User_slots,
+};
+
+static PyObject * pyswh_User_drop FUNCARGS_SELF
+{
+    pyswh_Object* o = (pyswh_Object*) self;
+    int x;
+    PYSWH_DB_CALL_OBJ(self,
+        if ((x = swhxx_db_user_drop(o->p))) {
+            PyErr_SetString(x == 1 ? PyExc_KeyError
+                            : pyswe_type_state(Py_TYPE(self))->contrib_error,
+                            swhxx_get_error(o->p));
+            swhxx_clear_error(o->p);
+        });
+    if (x)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+/* Argument of pyswh_User_list_cb */
+typedef struct {
+    PyObject* lst;
+    PyTypeObject* tp;
+} pyswh_UserList;
+
+static int pyswh_User_list_cb(void* p, int argc, char** argv, char** cols)
+{
+    PyObject* lst = ((pyswh_UserList*) p)->lst;
+    pyswh_Object* u = pyswh_Object_new(((pyswh_UserList*) p)->tp);
+    if (!u) {
+        PyErr_NoMemory();
+        return 1;
+    }
+    swhxx_db_user_new(&u->p);
+    if (!u->p) {
+        PyErr_NoMemory();
+        pyswh_Object_dealloc(u);
+        return 1;
+    }
+    if (swhxx_db_user_set_idx(u->p, strtoul(argv[0], NULL, 10))
+        || swhxx_db_user_set_name(u->p, argv[1])
+        || swhxx_db_user_set_pswd(u->p, argv[2])
+        || swhxx_db_user_set_mail(u->p, argv[3])
+        || swhxx_db_user_set_info(u->p, argv[4])) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(u->p));
+        pyswh_Object_dealloc(u);
+        return 1;
+    }
+    if (PyList_Append(lst, (PyObject*) u)) {
+        Py_DECREF(u);
+        return 1;
+    }
+    Py_DECREF(u);
+    return 0;
+}
+
+static PyObject * pyswh_User_list FUNCARGS_KEYWDS
+{
+    int order, x;
+    char* orderby = NULL;
+    char err[512] = {0};
+    PyObject* lst = NULL;
+    Py_ssize_t i;
+    pyswe_State* st = pyswe_type_state((PyTypeObject*) self);
+    pyswh_UserList ul;
+    pyswh_Rows rows;
+    static char* kwlist[] = {"orderby", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|z", kwlist, &orderby))
+        return NULL;
+    if (!orderby || !strcmp(orderby, "name"))
+        order = 0;
+    else if (!strcmp(orderby, "idx"))
+        order = 1;
+    else
+        return PyErr_Format(PyExc_ValueError, "invalid orderby (%s)", orderby);
+    if (!(lst = PyList_New(0)))
+        return PyErr_NoMemory();
+    ul.lst = lst;
+    ul.tp = st->user_type;
+    pyswh_rows_init(&rows, 5);
+    Py_BEGIN_ALLOW_THREADS
+    x = pyswh_db_rows(order == 0 ?
+                      "select * from Users order by name;" :
+                      "select * from Users order by _idx;", &rows, err);
+    Py_END_ALLOW_THREADS
+    if (rows.nomem)
+        PyErr_NoMemory();
+    for (i = 0; !x && i < rows.nrows; ++i)
+        x = pyswh_User_list_cb(&ul, 5, pyswh_rows_get(&rows, i), NULL);
+    pyswh_rows_free(&rows);
+    if (x) {
+        if (!PyErr_Occurred())
+            PyErr_SetString(st->contrib_error, *err ? err : "error?");
+        Py_DECREF(lst);
+        return NULL;
+    }
+    return lst;
+}
+
+static PyObject * pyswh_User_root FUNCARGS_SELF
 {
-    int y, m, d, h, mi, y2, m2, d2, h2, mi2;
-    double s, tz, s2;
-    static char *kwlist[] = {"year", "month", "day", "hour", "minutes",
-                             "seconds", "offset", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iiiiidd", kwlist,
-                                     &y, &m, &d, &h, &mi, &s, &tz))
+    void* p = NULL;
+    pyswh_Object* o;
+    int x;
+    char err[512] = {0};
+    pyswe_State* st = pyswe_type_state((PyTypeObject*) self);
+    PYSWH_DB_CALL(x = swhxx_db_user_root(&p, err));
+    if (x) {
+        switch (x) {
+        case 4:
+            return PyErr_NoMemory();
+        case 3:
+            assert(p);
+            PyErr_SetString(st->contrib_error,
+                            swhxx_has_error(p) ? swhxx_get_error(p) : "error");
+            swhxx_db_user_dealloc(&p);
+            break;
+        case 2:
+            PyErr_SetString(st->contrib_error, err);
+            break;
+        case 1:
+            PyErr_SetString(PyExc_KeyError, err);
+            break;
+        default:
+            Py_FatalError("oops");
+        }
         return NULL;
-    swe_utc_time_zone(y, m, d, h, mi, s, tz, &y2, &m2, &d2, &h2, &mi2, &s2);
-    return Py_BuildValue("iiiiid", y2, m2, d2, h2, mi2, s2);
+    }
+    if (!(o = pyswh_Object_new(st->user_type))) {
+        swhxx_db_user_dealloc(&p);
+        return PyErr_NoMemory();
+    }
+    o->p = p;
+    return (PyObject*) o;
 }
 
-/* swisseph.utc_to_jd */
-PyDoc_STRVAR(pyswe_utc_to_jd__doc__,
-"Convert UTC to julian day.\n\n"
-":Args: int year, int month, int day, int hour, int minutes, float seconds,"
-" int cal=GREG_CAL\n\n"
-" - year, month, day, hour, minutes, seconds: date and time\n"
-" - cal: either GREG_CAL or JUL_CAL\n\n"
-":Return: float jdet, float jdut\n\n"
-" - jdet: Julian day in ET (TT)\n"
-" - jdut: Julian day in UT (UT1)\n\n"
-"This function raises ValueError if cal is not GREG_CAL or JUL_CAL.\n"
-"It raises swisseph.Error in case of fatal error.");
+static PyObject * pyswh_User_save FUNCARGS_SELF
+{
+    pyswh_Object* o = (pyswh_Object*) self;
+    int x;
+    PYSWH_DB_CALL_OBJ(self,
+        if ((x = swhxx_db_user_save(o->p))) {
+            PyErr_SetString(x == 1 ? PyExc_KeyError
+                            : pyswe_type_state(Py_TYPE(self))->contrib_error,
+                            swhxx_get_error(o->p));
+            swhxx_clear_error(o->p);
+        });
+    if (x)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject * pyswh_User_select FUNCARGS_KEYWDS
+{
+    char* name;
+    void* p = NULL;
+    pyswh_Object* o;
+    int x;
+    char err[512] = {0};
+    pyswe_State* st = pyswe_type_state((PyTypeObject*) self);
+    static char* kwlist[] = {"name", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &name))
+        return NULL;
+    PYSWH_DB_CALL(x = swhxx_db_user_select(name, &p, err));
+    if (x) {
+        switch (x) {
+        case 4:
+            return PyErr_NoMemory();
+        case 3:
+            assert(p);
+            PyErr_SetString(st->contrib_error,
+                            swhxx_has_error(p) ? swhxx_get_error(p) : "");
+            swhxx_db_user_dealloc(&p);
+            break;
+        case 2:
+            PyErr_SetString(st->contrib_error, err);
+            break;
+        case 1:
+            PyErr_SetString(PyExc_KeyError, err);
+            break;
+        default:
+            Py_FatalError("oops");
+        }
+        return NULL;
+    }
+    if (!p)
+        return PyErr_Format(PyExc_KeyError, "no such user (%s)", name);
+    if (!(o = pyswh_Object_new(st->user_type))) {
+        swhxx_db_user_dealloc(&p);
+        return PyErr_NoMemory();
+    }
+    o->p = p;
+    return (PyObject*) o;
+}
+
+/* swisseph.contrib.Data */
+PyDoc_STRVAR(pyswh_Data__doc__,
+"Astro data");
+PyDoc_STRVAR(pyswh_Data_idx__doc__,
+"Data idx");
+PyDoc_STRVAR(pyswh_Data_useridx__doc__,
+"Data user idx");
+PyDoc_STRVAR(pyswh_Data_title__doc__,
+"Data title");
+PyDoc_STRVAR(pyswh_Data_jd__doc__,
+"Data julian day");
+PyDoc_STRVAR(pyswh_Data_latitude__doc__,
+"Data latitude");
+PyDoc_STRVAR(pyswh_Data_longitude__doc__,
+"Data longitude");
+PyDoc_STRVAR(pyswh_Data_altitude__doc__,
+"Data altitude");
+PyDoc_STRVAR(pyswh_Data_datetime__doc__,
+"Data date and time");
+PyDoc_STRVAR(pyswh_Data_timezone__doc__,
+"Data timezone");
+PyDoc_STRVAR(pyswh_Data_isdst__doc__,
+"Data isdst");
+PyDoc_STRVAR(pyswh_Data_location__doc__,
+"Data location");
+PyDoc_STRVAR(pyswh_Data_country__doc__,
+"Data country");
+PyDoc_STRVAR(pyswh_Data_owner__doc__,
+"Get the owner of data\n\n"
+":Args: --\n"
+":Return: swh.User found, or None");
+
+static PyObject * pyswh_Data_new(PyTypeObject* tp, PyObject* args, PyObject* kwds)
+{
+    pyswh_Object* self = pyswh_Object_new(tp);
+    if (self) {
+        swhxx_db_data_new(&self->p);
+        if (!self->p) {
+            pyswh_Object_dealloc(self);
+            self = NULL;
+        }
+    }
+    return (PyObject*) self;
+}
+
+static void pyswh_Data_dealloc(pyswh_Object* self)
+{
+    if (self->p)
+        swhxx_db_data_dealloc(&self->p);
+    pyswh_Object_dealloc(self);
+}
+
+static int pyswh_Data_init(pyswh_Object* self, PyObject* args, PyObject* kwds)
+{
+    char* title = "now", *dt = "", *tz = "", *loc = "", *ctry = "";
+    double jd = swh_jdnow(), lat = 0, lon = 0;
+    long alt = 0, isdst = -1;
+    static char* kwlist[] = {"title", "jd", "latitude", "longitude", "altitude",
+                             "datetime", "timezone", "isdst", "location",
+                             "country", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sdddississ", kwlist,
+                &title, &jd, &lat, &lon, &alt, &dt, &tz, &loc, &ctry))
+        return -1;
+    if (swhxx_db_data_set_title(self->p, title)
+        || swhxx_db_data_set_jd(self->p, jd)
+        || swhxx_db_data_set_latitude(self->p, lat)
+        || swhxx_db_data_set_longitude(self->p, lon)
+        || swhxx_db_data_set_altitude(self->p, alt)
+        || swhxx_db_data_set_datetime(self->p, dt)
+        || swhxx_db_data_set_timezone(self->p, tz)
+        || swhxx_db_data_set_isdst(self->p, isdst)
+        || swhxx_db_data_set_location(self->p, loc)
+        || swhxx_db_data_set_country(self->p, ctry)) {
+        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
+        swhxx_clear_error(self->p);
+        return -1;
+    }
+    return 0;
+}
+
+static pyswh_ulong_getsetter pyswh_Data_getset_idx = {
+    &swhxx_db_data_get_idx, NULL
+};
+static pyswh_ulong_getsetter pyswh_Data_getset_useridx = {
+    &swhxx_db_data_get_useridx, NULL
+};
+static pyswh_string_getsetter pyswh_Data_getset_title = {
+    &swhxx_db_data_get_title, &swhxx_db_data_set_title
+};
+static pyswh_double_getsetter pyswh_Data_getset_jd = {
+    &swhxx_db_data_get_jd, &swhxx_db_data_set_jd
+};
+static pyswh_double_getsetter pyswh_Data_getset_latitude = {
+    &swhxx_db_data_get_latitude, &swhxx_db_data_set_latitude
+};
+static pyswh_double_getsetter pyswh_Data_getset_longitude = {
+    &swhxx_db_data_get_longitude, &swhxx_db_data_set_longitude
+};
+static pyswh_long_getsetter pyswh_Data_getset_altitude = {
+    &swhxx_db_data_get_altitude, &swhxx_db_data_set_altitude
+};
+static pyswh_string_getsetter pyswh_Data_getset_datetime = {
+    &swhxx_db_data_get_datetime, &swhxx_db_data_set_datetime
+};
+static pyswh_string_getsetter pyswh_Data_getset_timezone = {
+    &swhxx_db_data_get_timezone, &swhxx_db_data_set_timezone
+};
+static pyswh_long_getsetter pyswh_Data_getset_isdst = {
+    &swhxx_db_data_get_isdst, &swhxx_db_data_set_isdst
+};
+static pyswh_string_getsetter pyswh_Data_getset_location = {
+    &swhxx_db_data_get_location, &swhxx_db_data_set_location
+};
+static pyswh_string_getsetter pyswh_Data_getset_country = {
+    &swhxx_db_data_get_country, &swhxx_db_data_set_country
+};
+
+static PyGetSetDef pyswh_Data_getsetters[] = {
+{"_idx", (getter) pyswh_Object_get_ulong, (setter) pyswh_Object_set_readonly,
+    pyswh_Data_idx__doc__, &pyswh_Data_getset_idx},
+{"_useridx", (getter) pyswh_Object_get_ulong, (setter) pyswh_Object_set_readonly,
+    pyswh_Data_useridx__doc__, &pyswh_Data_getset_useridx},
+{"title", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_Data_title__doc__, &pyswh_Data_getset_title},
+{"jd", (getter) pyswh_Object_get_double, (setter) pyswh_Object_set_double,
+    pyswh_Data_jd__doc__, &pyswh_Data_getset_jd},
+{"latitude", (getter) pyswh_Object_get_double, (setter) pyswh_Object_set_double,
+    pyswh_Data_latitude__doc__, &pyswh_Data_getset_latitude},
+{"longitude", (getter) pyswh_Object_get_double, (setter) pyswh_Object_set_double,
+    pyswh_Data_longitude__doc__, &pyswh_Data_getset_longitude},
+{"altitude", (getter) pyswh_Object_get_long, (setter) pyswh_Object_set_long,
+    pyswh_Data_altitude__doc__, &pyswh_Data_getset_altitude},
+{"datetime", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_Data_datetime__doc__, &pyswh_Data_getset_datetime},
+{"timezone", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_Data_timezone__doc__, &pyswh_Data_getset_timezone},
+{"isdst", (getter) pyswh_Object_get_long, (setter) pyswh_Object_set_long,
+    pyswh_Data_isdst__doc__, &pyswh_Data_getset_isdst},
+{"location", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_Data_location__doc__, &pyswh_Data_getset_location},
+{"country", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
+    pyswh_Data_country__doc__, &pyswh_Data_getset_country},
+{NULL}
+};
+
+static PyObject * pyswh_Data_owner FUNCARGS_SELF;
+
+static PyMethodDef pyswh_Data_methods[] = {
+{"owner", (PyCFunction) pyswh_Data_owner,
+    METH_NOARGS, pyswh_Data_owner__doc__},
+{NULL}
+};
 
-static PyObject * pyswe_utc_to_jd FUNCARGS_KEYWDS
-{
-    int i, y, m, d, h, mi, flg = SE_GREG_CAL;
-    double s, dret[2];
-    char err[256] = {0};
-    static char *kwlist[] = {"year", "month", "day", "hour", "minutes",
-                             "seconds", "cal", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "iiiiid|i", kwlist,
-                                     &y, &m, &d, &h, &mi, &s, &flg))
-        return NULL;
-    if (flg != SE_GREG_CAL && flg != SE_JUL_CAL)
-        return PyErr_Format(PyExc_ValueError,
-                            "swisseph.utc_to_jd: invalid calendar (%d)", flg);
-    i = swe_utc_to_jd(y, m, d, h, mi, s, flg, dret, err);
-    if (i != 0)
-        return PyErr_Format(pyswe_Error, "swisseph.utc_to_jd: %s", err);
-    return Py_BuildValue("dd", dret[0], dret[1]);
-}
+static PyType_Slot pyswh_Data_slots[] = {
+    {Py_tp_doc, (void*) pyswh_Data__doc__},
+    {Py_tp_new, pyswh_Data_new},
+    {Py_tp_init, pyswh_Data_init},
+    {Py_tp_dealloc, pyswh_Data_dealloc},
+    {Py_tp_methods, pyswh_Data_methods},
+    {Py_tp_getset, pyswh_Data_getsetters},
+    {0, NULL}
+};
 
-/* swisseph.vis_limit_mag */
-PyDoc_STRVAR(pyswe_vis_limit_mag__doc__,
-"Find the limiting visual magnitude in dark skies.\n\n"
-":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
-" int flags\n\n"
-" - tjdut: input time, Julian day number, Universal Time\n"
-" - geopos: a sequence with:\n"
-"    - 0: geographic longitude (eastern positive)\n"
-"    - 1: geographic latitude (northern positive)\n"
-"    - 2: altitude above sea level, in meters\n"
-" - atmo: a sequence with:\n"
-"    - 0: atmospheric pressure in mbar (hPa)\n"
-"    - 1: atmospheric temperature in degrees Celsius\n"
-"    - 2: relative humidity in %\n"
-"    - 3: if >= 1, Meteorological Range (km).\n"
-"      Between 1 and 0, total atmospheric coefficient (ktot).\n"
-"      If = 0, the other atmospheric parameters determine the total\n"
-"      atmospheric coefficient (ktot)\n"
-" - observer: a sequence with:\n"
-"    - 0: age of observer in years (default = 36)\n"
-"    - 1: snellen ratio of observers eyes (default = 1 = normal)\n"
-"    - The following parameters are only relevant if HELFLAG_OPTICAL_PARAMS\n"
-"      is set:\n"
-"    - 2: (0) = monocular, (1) = binocular (boolean)\n"
-"    - 3: telescope magnification, (0) = default to naked eye (binocular),\n"
-"      (1) = naked eye\n"
-"    - 4: optical aperture (telescope diameter) in mm\n"
-"    - 5: optical transmission\n"
-" - objname: name of planet or fixed star\n"
-" - flags: bit flags for ephemeris, and also:\n"
-"    - HELFLAG_OPTICAL_PARAMS: for optical instruments\n"
-"    - HELFLAG_NO_DETAILS: provide date, without details\n"
-"    - HELFLAG_VISLIM_DARK: behave as if Sun is at nadir\n"
-"    - HELFLAG_VISLIM_NOMOON: behave as if Moon is at nadir, i.e. the Moon as\n"
-"      a factor disturbing the observation is excluded, useful if one is not\n"
-"      interested in the heliacal date of that particular year, but in the\n"
-"      heliacal date of that epoch\n\n"
-":Return: float res, (dret)\n\n"
-" - res: result:\n"
-"    - (-2): object is below horizon\n"
-"    - (0): OK, photopic vision\n"
-"    - (1): OK, scotopic vision\n"
-"    - (2): OK, near limit photopic/scotopic vision\n"
-" - dret: a tuple of 10 float, of which:\n"
-"    - 0: limiting visual magnitude (if > magnitude of object, then the\n"
-"      object is visible)\n"
-"    - 1: altitude of object\n"
-"    - 2: azimuth of object\n"
-"    - 3: altitude of sun\n"
-"    - 4: azimuth of sun\n"
-"    - 5: altitude of moon\n"
-"    - 6: azimuth of moon\n"
-"    - 7: magnitude of object\n\n"
-"This function raises swisseph.Error in case of fatal error.");
+static PyType_Spec pyswh_Data_spec = {
+    .name = "swisseph.contrib.Data",
+    .basicsize = sizeof(pyswh_Object),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
+    .slots = pyswh_Data_slots,
+};
 
-static PyObject * pyswe_vis_limit_mag FUNCARGS_KEYWDS
+static PyObject * pyswh_Data_owner FUNCARGS_SELF
 {
-    double jd, geopos[3], atmo[4], observ[6], dres;
-    double dret[10] = {0,0,0,0,0,0,0,0,0,0};
-    char err[256] = {0}, *obj;
-    int i, flg;
-    PyObject *o1, *o2, *o3;
-    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
-                             "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsi", kwlist, &jd, &o1,
-                                     &o2, &o3, &obj, &flg))
+    pyswh_Object* o = (pyswh_Object*) self;
+    void* p;
+    int x;
+    char err[512] = {0};
+    pyswe_State* st = pyswe_type_state(Py_TYPE(self));
+    PYSWH_DB_CALL_OBJ(self, x = swhxx_db_data_owner(o->p, &p, err));
+    if (x) {
+        switch (x) {
+        case 3:
+            return PyErr_NoMemory();
+        case 2:
+            PyErr_SetString(st->contrib_error, err);
+            break;
+        case 1:
+            PyErr_SetString(PyExc_KeyError, err);
+            break;
+        default:
+            Py_FatalError("oops");
+        }
         return NULL;
-    /* extract geopos */
-    i = py_seq2d(o1, 3, geopos, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.vis_limit_mag: geopos: %s", err);
-    /* extract atmo */
-    i = py_seq2d(o2, 4, atmo, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                    "swisseph.vis_limit_mag: atmo: %s", err);
-    /* extract observer */
-    i = py_seq2d(o3, 6, observ, err);
-    if (i > 0)
-        return i > 3 ? NULL : PyErr_Format(PyExc_TypeError,
-                                "swisseph.vis_limit_mag: observer: %s", err);
-    /* set topo params */
-    if (flg & SEFLG_TOPOCTR)
-        swe_set_topo(geopos[0], geopos[1], geopos[2]);
-    dres = swe_vis_limit_mag(jd, geopos, atmo, observ, obj, flg, dret, err);
-    if (dres != -1)
-        return Py_BuildValue("d(dddddddddd)", dres,dret[0],dret[1],dret[2],
-                             dret[3],dret[4],dret[5],dret[6],
-                             dret[7],dret[8],dret[9]);
-    return PyErr_Format(pyswe_Error, "swisseph.vis_limit_mag: %s", err);
+    }
+    if (!p)
+        Py_RETURN_NONE;
+    if (!(o = pyswh_Object_new(st->user_type))) {
+        swhxx_db_user_dealloc(&p);
+        return PyErr_NoMemory();
+    }
+    o->p = p;
+    return (PyObject*) o;
 }
 
-#if PYSWE_USE_SWEPHELP /* Pyswisseph contrib submodule */
-
-/* swisseph.contrib.Error (module exception type) */
-static PyObject * pyswh_Error;
+/* Atlas index
+ *
+ * The places of the atlas database, loaded once in memory for searches that
+ * run no SQL query. The names of a place (name, asciiname, and each of its
+ * alternatenames) are keys folded to ASCII lowercase, sorted by country then
+ * by key: the places of a country having a name that starts with a prefix
+ * are a range of keys found by binary search, like a trie flattened in an
+ * array. Strings are allocated in blocks freed with the index, that is not
+ * modified once built.
+ */
 
-/* generic object holding a pointer */
+#define PYSWH_BLOCK_SIZE    65536
 
-#define pyswh_Object_new(tp)    ((pyswh_Object*) (tp)->tp_alloc((tp), 0))
-#define pyswh_Object_dealloc(o) Py_TYPE(o)->tp_free((PyObject*)o)
+typedef struct pyswh_Block {
+    struct pyswh_Block* next;
+    size_t len;
+    size_t size;
+    char buf[1];
+} pyswh_Block;
 
 typedef struct {
-    PyObject_HEAD
-    void* p;
-} pyswh_Object;
+    const char* name;
+    const char* asciiname;
+    const char* alternatenames;
+    const char* timezone;
+    double lat;
+    double lon;
+    int elevation;
+    int country; /* index in countries */
+} pyswh_Place;
 
-/* get-setters */
+typedef struct {
+    const char* key; /* lowercase */
+    short country;
+    short alt; /* of alternatenames only */
+    int place;
+} pyswh_AtlasKey;
 
 typedef struct {
-    double (*get)(void*);
-    int (*set)(void*, double);
-} pyswh_double_getsetter;
+    char code[3];
+    const char* name;
+    Py_ssize_t start; /* range of its keys */
+    Py_ssize_t end;
+} pyswh_Country;
 
 typedef struct {
-    long (*get)(void*);
-    int (*set)(void*, long);
-} pyswh_long_getsetter;
+    double p[3]; /* point of the unit sphere */
+    int place;
+    int axis; /* of the split */
+} pyswh_KdNode;
 
 typedef struct {
-    const char* (*get)(void*);
-    int (*set)(void*, const char*);
-} pyswh_string_getsetter;
+    PyObject_HEAD
+    pyswh_Block* strings;
+    pyswh_Country* countries;
+    pyswh_Place* places;
+    pyswh_AtlasKey* keys;
+    pyswh_KdNode* tree; /* built by nearest() */
+    Py_ssize_t ncountries;
+    Py_ssize_t nplaces;
+    Py_ssize_t nkeys;
+    Py_ssize_t countries_size;
+    Py_ssize_t places_size;
+    Py_ssize_t keys_size;
+} pyswh_AtlasIndex;
+
+static PyStructSequence_Field pyswh_AtlasPlace_fields[] = {
+    {"name", "name of the place"},
+    {"asciiname", "name in plain ascii"},
+    {"alternatenames", "comma separated alternate names"},
+    {"countrycode", "ISO country code"},
+    {"latitude", "latitude (deg)"},
+    {"longitude", "longitude (deg)"},
+    {"elevation", "elevation (m)"},
+    {"timezone", "timezone name"},
+    {NULL}
+};
+
+static PyStructSequence_Desc pyswh_AtlasPlace_desc = {
+    "swisseph.contrib.AtlasPlace",
+    "Place of the atlas, as in the tuples of atlas_search.",
+    pyswh_AtlasPlace_fields,
+    8
+};
+
+/* Create the AtlasPlace type
+ * Return a new reference, or NULL on error
+ */
+static PyTypeObject * pyswh_new_place_type(void)
+{
+#if PY_VERSION_HEX >= 0x03080000
+    return PyStructSequence_NewType(&pyswh_AtlasPlace_desc);
+#else
+    /* heap struct sequences are broken before Python 3.8 */
+    static PyTypeObject tp;
+    if (!tp.tp_name
+        && PyStructSequence_InitType2(&tp, &pyswh_AtlasPlace_desc) < 0)
+        return NULL;
+    Py_INCREF(&tp);
+    return &tp;
+#endif
+}
+
+/* Make room for one more item of an array
+ * Return > 0 on memory error, with MemoryError raised
+ */
+static int pyswh_reserve(void** p, Py_ssize_t* size, Py_ssize_t n,
+                         size_t itemsize)
+{
+    void* q;
+    Py_ssize_t sz;
+    if (n < *size)
+        return 0;
+    sz = *size ? *size * 2 : 64;
+    if (!(q = PyMem_Realloc(*p, sz * itemsize))) {
+        PyErr_NoMemory();
+        return 1;
+    }
+    *p = q;
+    *size = sz;
+    return 0;
+}
+
+/* Copy n chars of a string in the blocks of the index
+ * Return NULL on memory error, with MemoryError raised
+ */
+static const char * pyswh_AtlasIndex_str(pyswh_AtlasIndex* self,
+                                         const char* s, size_t n, int lower)
+{
+    pyswh_Block* b = self->strings;
+    char* p;
+    size_t i;
+    if (!b || b->size - b->len <= n) {
+        i = n < PYSWH_BLOCK_SIZE ? PYSWH_BLOCK_SIZE : n + 1;
+        if (!(b = PyMem_Malloc(offsetof(pyswh_Block, buf) + i))) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        b->next = self->strings;
+        b->len = 0;
+        b->size = i;
+        self->strings = b;
+    }
+    p = b->buf + b->len;
+    for (i = 0; i < n; ++i)
+        p[i] = lower ? Py_TOLOWER(s[i]) : s[i];
+    p[n] = '\0';
+    b->len += n + 1;
+    return p;
+}
+
+#define pyswh_AtlasIndex_strdup(self, s) \
+        pyswh_AtlasIndex_str((self), (s), strlen(s), 0)
+
+/* sqlite callbacks get NULL for NULL values */
+#define pyswh_argv(argv, i)     ((argv)[i] ? (argv)[i] : "")
+
+static int pyswh_AtlasIndex_countries_cb(void* p, int argc, char** argv,
+                                         char** cols)
+{
+    pyswh_AtlasIndex* self = (pyswh_AtlasIndex*) p;
+    pyswh_Country* c;
+    if (self->ncountries == SHRT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "too many countries");
+        return 1;
+    }
+    if (pyswh_reserve((void**) &self->countries, &self->countries_size,
+                      self->ncountries, sizeof(pyswh_Country)))
+        return 1;
+    c = &self->countries[self->ncountries];
+    c->code[0] = '\0';
+    strncat(c->code, pyswh_argv(argv, 1), 2);
+    c->start = c->end = 0;
+    if (!(c->name = pyswh_AtlasIndex_strdup(self, pyswh_argv(argv, 5))))
+        return 1;
+    ++self->ncountries;
+    return 0;
+}
 
+/* Argument of pyswh_AtlasIndex_places_cb */
 typedef struct {
-    unsigned long (*get)(void*);
-    int (*set)(void*, unsigned long);
-} pyswh_ulong_getsetter;
+    pyswh_AtlasIndex* self;
+    int country;
+} pyswh_AtlasLoad;
 
-static PyObject * pyswh_Object_get_double(pyswh_Object* self, void* cl)
+static int pyswh_AtlasIndex_places_cb(void* p, int argc, char** argv,
+                                      char** cols)
 {
-    double d = ((pyswh_double_getsetter*)cl)->get(self->p);
-    PyObject* o = PyFloat_FromDouble(d);
-    return o ? o : PyErr_NoMemory();
+    pyswh_AtlasIndex* self = ((pyswh_AtlasLoad*) p)->self;
+    pyswh_Place* pl;
+    if (pyswh_reserve((void**) &self->places, &self->places_size,
+                      self->nplaces, sizeof(pyswh_Place)))
+        return 1;
+    pl = &self->places[self->nplaces];
+    if (!(pl->name = pyswh_AtlasIndex_strdup(self, pyswh_argv(argv, 0)))
+        || !(pl->asciiname = pyswh_AtlasIndex_strdup(self,
+                                                     pyswh_argv(argv, 1)))
+        || !(pl->alternatenames = pyswh_AtlasIndex_strdup(self,
+                                                     pyswh_argv(argv, 2)))
+        || !(pl->timezone = pyswh_AtlasIndex_strdup(self,
+                                                    pyswh_argv(argv, 7))))
+        return 1;
+    pl->lat = atof(pyswh_argv(argv, 4));
+    pl->lon = atof(pyswh_argv(argv, 5));
+    pl->elevation = atoi(pyswh_argv(argv, 6));
+    pl->country = ((pyswh_AtlasLoad*) p)->country;
+    ++self->nplaces;
+    return 0;
 }
 
-static int pyswh_Object_set_double(pyswh_Object* self, PyObject* val, void* cl)
+/* Add the key of n chars of a name of a place
+ * Return > 0 on memory error
+ */
+static int pyswh_AtlasIndex_add_key(pyswh_AtlasIndex* self, int place,
+                                    const char* s, size_t n, int alt)
+{
+    pyswh_AtlasKey* k;
+    if (!n)
+        return 0;
+    if (pyswh_reserve((void**) &self->keys, &self->keys_size, self->nkeys,
+                      sizeof(pyswh_AtlasKey)))
+        return 1;
+    k = &self->keys[self->nkeys];
+    if (!(k->key = pyswh_AtlasIndex_str(self, s, n, 1)))
+        return 1;
+    k->country = (short) self->places[place].country;
+    k->alt = (short) alt;
+    k->place = place;
+    ++self->nkeys;
+    return 0;
+}
+
+static int pyswh_AtlasKey_cmp(const void* a, const void* b)
 {
-    double d;
-    if (PyFloat_Check(val))
-        d = PyFloat_AsDouble(val);
-    else if (PyLong_Check(val))
-        d = PyLong_AsDouble(val);
-    else {
-        PyErr_SetString(PyExc_TypeError, "must be a float");
-        return -1;
+    const pyswh_AtlasKey* x = a, *y = b;
+    int i;
+    if (x->country != y->country)
+        return x->country < y->country ? -1 : 1;
+    if ((i = strcmp(x->key, y->key)))
+        return i;
+    return x->place < y->place ? -1 : x->place > y->place;
+}
+
+/* Load the atlas (connected) and sort the keys
+ * Return > 0 on error, with an exception set
+ */
+static int pyswh_AtlasIndex_load(pyswh_AtlasIndex* self, PyObject* error)
+{
+    int x;
+    Py_ssize_t i, j;
+    const char* s, *e;
+    char err[512] = {0};
+    pyswh_AtlasLoad load;
+    load.self = self;
+    pyswe_lock_nogil(&pyswh_db_lock);
+    x = swh_atlas_countries_list(&pyswh_AtlasIndex_countries_cb, self, err);
+    for (i = 0; !x && i < self->ncountries; ++i) {
+        load.country = (int) i;
+        x = swh_atlas_search("", self->countries[i].code,
+                             &pyswh_AtlasIndex_places_cb, &load, err);
     }
-    if (d == -1 && PyErr_Occurred())
-        return -1;
-    if (((pyswh_double_getsetter*)cl)->set(self->p, d)) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
-        swhxx_clear_error(self->p);
-        return -1;
+    pyswe_unlock(&pyswh_db_lock);
+    if (x) {
+        if (!PyErr_Occurred())
+            PyErr_Format(error, "swisseph.contrib.AtlasIndex: %s",
+                         *err ? err : "error");
+        return 1;
+    }
+    for (i = 0; i < self->nplaces; ++i) {
+        if (pyswh_AtlasIndex_add_key(self, (int) i, self->places[i].name,
+                                     strlen(self->places[i].name), 0)
+            || pyswh_AtlasIndex_add_key(self, (int) i,
+                                        self->places[i].asciiname,
+                                        strlen(self->places[i].asciiname), 0))
+            return 1;
+        for (s = self->places[i].alternatenames; *s; s = *e ? e + 1 : e) {
+            if (!(e = strchr(s, ',')))
+                e = s + strlen(s);
+            if (pyswh_AtlasIndex_add_key(self, (int) i, s, e - s, 1))
+                return 1;
+        }
+    }
+    qsort(self->keys, self->nkeys, sizeof(pyswh_AtlasKey),
+          &pyswh_AtlasKey_cmp);
+    /* drop duplicates (name and asciiname often are the same) */
+    for (i = j = 0; i < self->nkeys; ++i) {
+        if (j && !pyswh_AtlasKey_cmp(&self->keys[j - 1], &self->keys[i])) {
+            self->keys[j - 1].alt &= self->keys[i].alt;
+            continue;
+        }
+        self->keys[j++] = self->keys[i];
+    }
+    self->nkeys = j;
+    for (i = 0; i < self->nkeys; i = j) {
+        for (j = i; j < self->nkeys
+             && self->keys[j].country == self->keys[i].country; ++j)
+            ;
+        self->countries[self->keys[i].country].start = i;
+        self->countries[self->keys[i].country].end = j;
     }
     return 0;
 }
 
-static PyObject * pyswh_Object_get_long(pyswh_Object* self, void* cl)
+PyDoc_STRVAR(pyswh_AtlasIndex__doc__,
+"In-memory index of the atlas database.\n\n"
+":Args: --\n\n"
+"All places of the connected atlas are loaded, once, with their names (name,"
+" asciiname and alternatenames) sorted by country. Searches then run no SQL"
+" query and return AtlasPlace records, with float latitude and longitude."
+" The nearest places of points are found with a spatial index, built on first"
+" use. index[i] is the place number i."
+" The index is not updated with the database. See also atlas_index(), that"
+" keeps one for the connected atlas.\n\n"
+"Usage example:\n\n"
+"\t>>> idx = swh.atlas_index()\n"
+"\t>>> lst = idx.search('zurich', 'ch')");
+
+static PyObject * pyswh_AtlasIndex_new(PyTypeObject* tp, PyObject* args,
+                                       PyObject* kwds)
 {
-    long i = ((pyswh_long_getsetter*)cl)->get(self->p);
-    PyObject* o = PyLong_FromLong(i);
-    return o ? o : PyErr_NoMemory();
+    pyswh_AtlasIndex* self;
+    static char* kwlist[] = {NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, ":AtlasIndex", kwlist))
+        return NULL;
+    if (!(self = (pyswh_AtlasIndex*) tp->tp_alloc(tp, 0)))
+        return NULL;
+    if (pyswh_AtlasIndex_load(self, pyswe_type_state(tp)->contrib_error)) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject*) self;
+}
+
+static void pyswh_AtlasIndex_dealloc(pyswh_AtlasIndex* self)
+{
+    pyswh_Block* b;
+    while ((b = self->strings)) {
+        self->strings = b->next;
+        PyMem_Free(b);
+    }
+    PyMem_Free(self->countries);
+    PyMem_Free(self->places);
+    PyMem_Free(self->keys);
+    PyMem_Free(self->tree);
+    pyswh_Object_dealloc(self);
+}
+
+static Py_ssize_t pyswh_AtlasIndex_len(pyswh_AtlasIndex* self)
+{
+    return self->nplaces;
+}
+
+/* Make the AtlasPlace of a place
+ * Return NULL on error
+ */
+static PyObject * pyswh_AtlasIndex_place(pyswh_AtlasIndex* self,
+                                         pyswe_State* st, int i)
+{
+    const pyswh_Place* pl = &self->places[i];
+    PyObject* o = PyStructSequence_New(st->place_type);
+    PyObject* items[8];
+    int j;
+    if (!o)
+        return NULL;
+    items[0] = PyUnicode_FromString(pl->name);
+    items[1] = PyUnicode_FromString(pl->asciiname);
+    items[2] = PyUnicode_FromString(pl->alternatenames);
+    items[3] = PyUnicode_FromString(self->countries[pl->country].code);
+    items[4] = PyFloat_FromDouble(pl->lat);
+    items[5] = PyFloat_FromDouble(pl->lon);
+    items[6] = PyLong_FromLong(pl->elevation);
+    items[7] = PyUnicode_FromString(pl->timezone);
+    for (j = 0; j < 8; ++j) {
+        if (!items[j]) {
+            for (; j < 8; ++j)
+                Py_XDECREF(items[j]);
+            Py_DECREF(o);
+            return NULL;
+        }
+        PyStructSequence_SET_ITEM(o, j, items[j]);
+    }
+    return o;
 }
 
-static int pyswh_Object_set_long(pyswh_Object* self, PyObject* val, void* cl)
+/* Check a country matches the country argument of searches (n chars) */
+static int pyswh_country_match(const pyswh_Country* c, const char* ctry,
+                               size_t n)
 {
-    long i;
-    if (!PyLong_Check(val)) {
-        PyErr_SetString(PyExc_TypeError, "must be an int");
-        return -1;
-    }
-    i = PyLong_AsLong(val);
-    if (i == -1 && PyErr_Occurred())
-        return -1;
-    if (((pyswh_long_getsetter*)cl)->set(self->p, i)) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
-        swhxx_clear_error(self->p);
-        return -1;
-    }
-    return 0;
+    if (!n)
+        return 1;
+    if (n == 2)
+        return Py_TOLOWER(c->code[0]) == Py_TOLOWER(ctry[0])
+            && Py_TOLOWER(c->code[1]) == Py_TOLOWER(ctry[1]);
+    return !PyOS_strnicmp(c->name, ctry, (Py_ssize_t) n);
 }
 
-static PyObject * pyswh_Object_get_string(pyswh_Object* self, void* cl)
+static int pyswh_int_cmp(const void* a, const void* b)
 {
-    const char* s = ((pyswh_string_getsetter*)cl)->get(self->p);
-    PyObject* o = PyUnicode_FromString(s);
-    return o ? o : PyErr_NoMemory();
+    int x = *(const int*) a, y = *(const int*) b;
+    return x < y ? -1 : x > y;
 }
 
-static int pyswh_Object_set_string(pyswh_Object* self, PyObject* val, void* cl)
-{
-    char* str;
-    if (!PyUnicode_Check(val)) {
-        PyErr_SetString(PyExc_TypeError, "must be a string");
-        return -1;
+/* Find the places of a country with a name starting with loc (lowercase),
+ * appended to ids
+ * Return > 0 on memory error
+ */
+static int pyswh_AtlasIndex_find(pyswh_AtlasIndex* self,
+                                 const pyswh_Country* c, const char* loc,
+                                 size_t n, int** ids, Py_ssize_t* nids,
+                                 Py_ssize_t* size)
+{
+    Py_ssize_t lo = c->start, hi = c->end, mid;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (strcmp(self->keys[mid].key, loc) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-    str = (char*) PyUnicode_AsUTF8(val);
-    if (((pyswh_string_getsetter*)cl)->set(self->p, str)) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
-        swhxx_clear_error(self->p);
-        return -1;
+    for (; lo < c->end && !strncmp(self->keys[lo].key, loc, n); ++lo) {
+        if (pyswh_reserve((void**) ids, size, *nids, sizeof(int)))
+            return 1;
+        (*ids)[(*nids)++] = self->keys[lo].place;
     }
     return 0;
 }
 
-static PyObject * pyswh_Object_get_ulong(pyswh_Object* self, void* cl)
-{
-    unsigned long i = ((pyswh_ulong_getsetter*)cl)->get(self->p);
-    PyObject* o = PyLong_FromUnsignedLong(i);
-    return o ? o : PyErr_NoMemory();
-}
-#if 0
-static int pyswh_Object_set_ulong(pyswh_Object* self, PyObject* val, void* cl)
-{
-    unsigned long i;
-    if (!PyLong_Check(val)) {
-        PyErr_SetString(PyExc_TypeError, "must be an int");
+/* Search places, as ordered in the database (without duplicates)
+ * Return the number of places in ids (to free), or -1 on memory error
+ */
+static Py_ssize_t pyswh_AtlasIndex_lookup(pyswh_AtlasIndex* self,
+                                          const char* loc, const char* ctry,
+                                          int** ids)
+{
+    Py_ssize_t i, j, nids = 0, size = 0;
+    size_t n = strlen(loc), nc = strlen(ctry);
+    char buf[256], *q = buf;
+    *ids = NULL;
+    if (n >= sizeof(buf) && !(q = PyMem_Malloc(n + 1))) {
+        PyErr_NoMemory();
         return -1;
     }
-    i = PyLong_AsUnsignedLong(val);
-    if (i == -1 && PyErr_Occurred())
-        return -1;
-    if (((pyswh_ulong_getsetter*)cl)->set(self->p, i)) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
-        swhxx_clear_error(self->p);
-        return -1;
+    for (i = 0; i <= (Py_ssize_t) n; ++i)
+        q[i] = Py_TOLOWER(loc[i]);
+    for (i = 0; i < self->ncountries; ++i) {
+        if (pyswh_country_match(&self->countries[i], ctry, nc)
+            && pyswh_AtlasIndex_find(self, &self->countries[i], q, n, ids,
+                                     &nids, &size)) {
+            nids = -1;
+            break;
+        }
     }
-    return 0;
+    if (q != buf)
+        PyMem_Free(q);
+    if (nids <= 0)
+        return nids;
+    qsort(*ids, nids, sizeof(int), &pyswh_int_cmp);
+    for (i = j = 1; i < nids; ++i) {
+        if ((*ids)[i] != (*ids)[j - 1])
+            (*ids)[j++] = (*ids)[i];
+    }
+    return j;
+}
+
+PyDoc_STRVAR(pyswh_AtlasIndex_search__doc__,
+"Search for a location in the index.\n\n"
+":Args: str location, str country='', int limit=0\n\n"
+" - location: beginning of a name, asciiname or alternate name\n"
+" - country: ISO country code (2 characters), beginning of a country name,"
+" or empty for all countries\n"
+" - limit: maximum number of places returned, 0 for no limit\n\n"
+":Return: list of AtlasPlace\n\n"
+"Names are compared without case (for ascii letters only).");
+
+static PyObject * pyswh_AtlasIndex_search FUNCARGS_KEYWDS
+{
+    char* loc, *ctry = "";
+    int* ids;
+    Py_ssize_t i, n, limit = 0;
+    PyObject* lst, *o;
+    pyswe_State* st = pyswe_type_state(Py_TYPE(self));
+    static char* kwlist[] = {"location", "country", "limit", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|sn", kwlist, &loc, &ctry,
+                                     &limit))
+        return NULL;
+    if (limit < 0)
+        return PyErr_Format(PyExc_ValueError,
+            "swisseph.contrib.AtlasIndex.search: invalid limit (%zd)", limit);
+    n = pyswh_AtlasIndex_lookup((pyswh_AtlasIndex*) self, loc, ctry, &ids);
+    if (n < 0)
+        return NULL;
+    if (limit && n > limit)
+        n = limit;
+    if (!(lst = PyList_New(n))) {
+        PyMem_Free(ids);
+        return NULL;
+    }
+    for (i = 0; i < n; ++i) {
+        if (!(o = pyswh_AtlasIndex_place((pyswh_AtlasIndex*) self, st,
+                                         ids[i]))) {
+            Py_DECREF(lst);
+            lst = NULL;
+            break;
+        }
+        PyList_SET_ITEM(lst, i, o);
+    }
+    PyMem_Free(ids);
+    return lst;
 }
-#endif
-static int pyswh_Object_set_readonly(pyswh_Object* s, PyObject* val, void* cl)
-{
-    PyErr_SetString(PyExc_AttributeError, "read-only attribute");
-    return -1;
+
+/* Find the best place for a location, in the countries matching ctry
+ * Locations and countries are stripped of spaces. The score of a key is 1
+ * for a name or asciiname, 0.9 for an alternate name, times the fraction of
+ * the key matched. For equal scores, the first place of the atlas is best.
+ * Return the place, or -1 if none, or -2 on memory error. Without the GIL.
+ */
+static int pyswh_AtlasIndex_best(pyswh_AtlasIndex* self, const char* loc,
+                                 const char* ctry, double* score)
+{
+    const pyswh_AtlasKey* k;
+    Py_ssize_t i, lo, hi, mid;
+    size_t n, nc;
+    char buf[256], *q = buf;
+    double sc;
+    int best = -1;
+    *score = 0;
+    while (Py_ISSPACE(*loc))
+        ++loc;
+    for (n = strlen(loc); n && Py_ISSPACE(loc[n - 1]); --n)
+        ;
+    while (Py_ISSPACE(*ctry))
+        ++ctry;
+    for (nc = strlen(ctry); nc && Py_ISSPACE(ctry[nc - 1]); --nc)
+        ;
+    if (!n)
+        return -1;
+    if (n >= sizeof(buf) && !(q = PyMem_RawMalloc(n + 1)))
+        return -2;
+    for (i = 0; i < (Py_ssize_t) n; ++i)
+        q[i] = Py_TOLOWER(loc[i]);
+    q[n] = '\0';
+    for (i = 0; i < self->ncountries; ++i) {
+        if (!pyswh_country_match(&self->countries[i], ctry, nc))
+            continue;
+        lo = self->countries[i].start;
+        hi = self->countries[i].end;
+        while (lo < hi) {
+            mid = lo + (hi - lo) / 2;
+            if (strcmp(self->keys[mid].key, q) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        for (k = &self->keys[lo]; lo < self->countries[i].end
+             && !strncmp(k->key, q, n); ++k, ++lo) {
+            sc = (k->alt ? 0.9 : 1.0) * n / strlen(k->key);
+            if (sc > *score || (sc == *score && k->place < best)) {
+                *score = sc;
+                best = k->place;
+            }
+        }
+    }
+    if (q != buf)
+        PyMem_RawFree(q);
+    return best;
 }
 
-/* swisseph.contrib.User */
-PyDoc_STRVAR(pyswh_User__doc__,
-"User of the database");
-PyDoc_STRVAR(pyswh_User_idx__doc__,
-"User idx");
-PyDoc_STRVAR(pyswh_User_name__doc__,
-"User name");
-PyDoc_STRVAR(pyswh_User_pswd__doc__,
-"User password");
-PyDoc_STRVAR(pyswh_User_mail__doc__,
-"User mail");
-PyDoc_STRVAR(pyswh_User_info__doc__,
-"User info");
-PyDoc_STRVAR(pyswh_User_drop__doc__,
-"Delete the user from database.\n\n"
-":Args: --\n"
-":Return: None\n\n"
-"Raises KeyError if not found.");
-PyDoc_STRVAR(pyswh_User_list__doc__,
-"List all users in database.\n\n"
-":Args: str orderby='name'\n\n"
-" - orderby: order by index ('idx'), by name ('name')\n\n"
-":Return: list of swh.User instances");
-PyDoc_STRVAR(pyswh_User_root__doc__,
-"Load the default user (root) from database\n\n"
-":Args: --\n"
-":Return: swh.User instance");
-PyDoc_STRVAR(pyswh_User_save__doc__,
-"Save user in database.\n\n"
-":Args: --\n"
-":Return: None\n\n"
-"Raises KeyError if duplicate or name is invalid.");
-PyDoc_STRVAR(pyswh_User_select__doc__,
-"Load a user from database\n\n"
-":Args: str name\n"
-":Return: swh.User instance\n\n"
-"Raises KeyError if not found or name is invalid.");
+/* A distinct query of search_many */
+typedef struct {
+    const char* loc;
+    const char* ctry;
+    int place;
+    double score;
+} pyswh_AtlasQuery;
 
-static PyObject * pyswh_User_new(PyTypeObject* tp, PyObject* args, PyObject* kwds)
-{
-    pyswh_Object* self = pyswh_Object_new(tp);
-    if (self) {
-        swhxx_db_user_new(&self->p);
-        if (!self->p) {
-            pyswh_Object_dealloc(self);
-            self = NULL;
+typedef struct {
+    pyswh_AtlasIndex* self;
+    pyswh_AtlasQuery* q;
+} pyswh_SearchMany;
+
+static void pyswh_search_many_run(pyswe_Job* job, Py_ssize_t start,
+                                  Py_ssize_t end)
+{
+    pyswh_SearchMany* a = (pyswh_SearchMany*) job->data;
+    pyswh_AtlasQuery* q;
+    Py_ssize_t i;
+    for (i = start; i < end; ++i) {
+        q = &a->q[i];
+        q->place = pyswh_AtlasIndex_best(a->self, q->loc, q->ctry, &q->score);
+        if (q->place == -2) {
+            q->place = -1;
+            pyswe_job_error(job, i, "out of memory");
         }
     }
-    return (PyObject*) self;
 }
 
-static void pyswh_User_dealloc(pyswh_Object* self)
+/* Get the string of an item of search_many
+ * Return NULL on error
+ */
+static const char * pyswh_search_many_str(PyObject* o, const char* fn,
+                                          const char* name, Py_ssize_t i)
 {
-    if (self->p)
-        swhxx_db_user_dealloc(&self->p);
-    pyswh_Object_dealloc(self);
+    if (!PyUnicode_Check(o)) {
+        PyErr_Format(PyExc_TypeError, "swisseph.contrib.%s: %s: item %zd:"
+                     " must be str", fn, name, i);
+        return NULL;
+    }
+    return PyUnicode_AsUTF8(o);
 }
 
-static int pyswh_User_init(pyswh_Object* self, PyObject* args, PyObject* kwds)
-{
-    char* name = "?", *pswd = "", *mail = "", *info = "";
-    static char* kwlist[] = {"name", "pswd", "mail", "info", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ssss", kwlist,
-                                     &name, &pswd, &mail, &info))
-        return -1;
-    if (swhxx_db_user_set_name(self->p, name)
-        || swhxx_db_user_set_pswd(self->p, pswd)
-        || swhxx_db_user_set_mail(self->p, mail)
-        || swhxx_db_user_set_info(self->p, info)) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
-        swhxx_clear_error(self->p);
-        return -1;
+/* Get the best places of locations, as arrays
+ * Return NULL on error
+ */
+static PyObject * pyswh_AtlasIndex_search_arrays(pyswh_AtlasIndex* self,
+                                                 PyObject* locations,
+                                                 PyObject* countries,
+                                                 const char* fn)
+{
+    pyswh_SearchMany a;
+    pyswe_Job job;
+    PyObject* locs = NULL, *ctrs = NULL, *all = NULL, *seen = NULL, *key;
+    PyObject* places = NULL, *lats = NULL, *lons = NULL, *scores = NULL;
+    PyObject* loc, *ctry, *uid;
+    const char* sloc, *sctry;
+    Py_ssize_t i, j, n, nq = 0, *qid = NULL;
+    int* pl;
+    double* lat, *lon, *sc;
+    char msg[128];
+    a.q = NULL;
+    snprintf(msg, sizeof(msg), "swisseph.contrib.%s: locations: must be a"
+             " sequence of str", fn);
+    if (!(locs = PySequence_Fast(locations, msg)))
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(locs);
+    if (countries && countries != Py_None && !PyUnicode_Check(countries)) {
+        snprintf(msg, sizeof(msg), "swisseph.contrib.%s: countries: must be"
+                 " str, or a sequence of str", fn);
+        if (!(ctrs = PySequence_Fast(countries, msg)))
+            goto error;
+        if (PySequence_Fast_GET_SIZE(ctrs) != n) {
+            PyErr_Format(PyExc_ValueError, "swisseph.contrib.%s: locations and"
+                         " countries: lengths differ (%zd, %zd)", fn, n,
+                         PySequence_Fast_GET_SIZE(ctrs));
+            goto error;
+        }
     }
-    return 0;
-}
+    else if (countries && countries != Py_None) {
+        all = countries;
+        Py_INCREF(all);
+    }
+    else if (!(all = PyUnicode_FromString("")))
+        goto error;
+    /* distinct (location, country) are searched once */
+    if (!(seen = PyDict_New())
+        || !(a.q = PyMem_Malloc(sizeof(pyswh_AtlasQuery) * (n ? n : 1)))
+        || !(qid = PyMem_Malloc(sizeof(Py_ssize_t) * (n ? n : 1)))) {
+        if (seen)
+            PyErr_NoMemory();
+        goto error;
+    }
+    for (i = 0; i < n; ++i) {
+        loc = PySequence_Fast_GET_ITEM(locs, i);
+        ctry = ctrs ? PySequence_Fast_GET_ITEM(ctrs, i) : all;
+        if (!(sloc = pyswh_search_many_str(loc, fn, "locations", i))
+            || !(sctry = pyswh_search_many_str(ctry, fn, "countries", i))
+            || !(key = PyTuple_Pack(2, loc, ctry)))
+            goto error;
+        if ((uid = PyDict_GetItemWithError(seen, key))) {
+            qid[i] = PyLong_AsSsize_t(uid);
+            Py_DECREF(key);
+            continue;
+        }
+        if (PyErr_Occurred() || !(uid = PyLong_FromSsize_t(nq))
+            || PyDict_SetItem(seen, key, uid)) {
+            Py_XDECREF(uid);
+            Py_DECREF(key);
+            goto error;
+        }
+        Py_DECREF(uid);
+        Py_DECREF(key);
+        /* the strings are kept alive by seen */
+        a.q[nq].loc = sloc;
+        a.q[nq].ctry = sctry;
+        qid[i] = nq++;
+    }
+    a.self = self;
+    job.func = pyswh_search_many_run;
+    job.data = &a;
+    job.n = nq;
+    job.chunk = 64;
+    job.errors = PYSWE_ERRORS_RAISE;
+    job.errlist = 0;
+    if (pyswe_pool_run(&job))
+        goto error;
+    if (job.err_index >= 0) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    if (!(places = pyswe_results_new(n, 1, sizeof(int), (void**) &pl))
+        || !(lats = pyswe_results_new(n, 1, sizeof(double), (void**) &lat))
+        || !(lons = pyswe_results_new(n, 1, sizeof(double), (void**) &lon))
+        || !(scores = pyswe_results_new(n, 1, sizeof(double), (void**) &sc)))
+        goto error;
+    for (i = 0; i < n; ++i) {
+        j = qid[i];
+        pl[i] = a.q[j].place;
+        sc[i] = a.q[j].score;
+        if (pl[i] < 0)
+            lat[i] = lon[i] = Py_NAN;
+        else {
+            lat[i] = self->places[pl[i]].lat;
+            lon[i] = self->places[pl[i]].lon;
+        }
+    }
+    PyMem_Free(a.q);
+    PyMem_Free(qid);
+    Py_DECREF(seen);
+    Py_XDECREF(ctrs);
+    Py_XDECREF(all);
+    Py_DECREF(locs);
+    return Py_BuildValue("NNNN", pyswe_results_view(places, "i", n, 0),
+                         pyswe_results_view(lats, "d", n, 0),
+                         pyswe_results_view(lons, "d", n, 0),
+                         pyswe_results_view(scores, "d", n, 0));
+error:
+    PyMem_Free(a.q);
+    PyMem_Free(qid);
+    Py_XDECREF(seen);
+    Py_XDECREF(ctrs);
+    Py_XDECREF(all);
+    Py_DECREF(locs);
+    Py_XDECREF(places);
+    Py_XDECREF(lats);
+    Py_XDECREF(lons);
+    Py_XDECREF(scores);
+    return NULL;
+}
+
+PyDoc_STRVAR(pyswh_AtlasIndex_search_many__doc__,
+"Search for the best place of many locations.\n\n"
+":Args: seq locations, countries=None\n\n"
+" - locations: sequence of str, beginnings of names as in search()\n"
+" - countries: str for all locations, or sequence of str of the same length,"
+" or None for all countries\n\n"
+":Return: places, latitudes, longitudes, scores\n\n"
+" - places: memoryview of int32, numbers of the places (index[i] is the"
+" AtlasPlace), -1 if not found\n"
+" - latitudes, longitudes: memoryviews of float64, NaN if not found\n"
+" - scores: memoryview of float64, quality of the matches: 1 for a name or"
+" asciiname equal to the location, 0.9 for an alternate name, times the"
+" fraction of the name matched if the location is its beginning, 0 if not"
+" found\n\n"
+"Locations and countries are stripped of spaces. The same (location, country)"
+" is searched once, by the thread pool. For equal scores, the first place of"
+" the atlas is chosen.");
+
+static PyObject * pyswh_AtlasIndex_search_many FUNCARGS_KEYWDS
+{
+    PyObject* locations, *countries = NULL;
+    static char* kwlist[] = {"locations", "countries", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", kwlist, &locations,
+                                     &countries))
+        return NULL;
+    return pyswh_AtlasIndex_search_arrays((pyswh_AtlasIndex*) self, locations,
+                                          countries, "AtlasIndex.search_many");
+}
+
+/* Nearest places
+ *
+ * Places are points of the unit sphere, in a k-d tree built on first use:
+ * the nodes of the range [lo, hi) split it at mid = (lo + hi) / 2, on the
+ * axis where points spread most, with the points before mid not greater on
+ * that axis, the points after not less. The nearest places by chord are the
+ * nearest by great circle. The tree can be saved to a file, checked on load
+ * with a hash of the coordinates of the places.
+ */
 
-static pyswh_ulong_getsetter pyswh_User_getset_idx = {
-    &swhxx_db_user_get_idx, NULL
-};
-static pyswh_string_getsetter pyswh_User_getset_name = {
-    &swhxx_db_user_get_name, &swhxx_db_user_set_name
-};
-static pyswh_string_getsetter pyswh_User_getset_pswd = {
-    &swhxx_db_user_get_pswd, &swhxx_db_user_set_pswd
-};
-static pyswh_string_getsetter pyswh_User_getset_mail = {
-    &swhxx_db_user_get_mail, &swhxx_db_user_set_mail
-};
-static pyswh_string_getsetter pyswh_User_getset_info = {
-    &swhxx_db_user_get_info, &swhxx_db_user_set_info
-};
+#define PYSWH_KD_MAGIC      "PYSWHKD"
+#define PYSWH_KD_VERSION    1
+#define PYSWH_KD_BYTEORDER  0x01020304
+#define PYSWH_KD_MAXK       1000
+#define PYSWH_EARTH_RADIUS  6371.0088 /* mean, km */
 
-static PyGetSetDef pyswh_User_getsetters[] = {
-{"_idx", (getter) pyswh_Object_get_ulong, (setter) pyswh_Object_set_readonly,
-    pyswh_User_idx__doc__, &pyswh_User_getset_idx},
-{"name", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_User_name__doc__, &pyswh_User_getset_name},
-{"pswd", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_User_pswd__doc__, &pyswh_User_getset_pswd},
-{"mail", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_User_mail__doc__, &pyswh_User_getset_mail},
-{"info", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_User_info__doc__, &pyswh_User_getset_info},
-{NULL}
-};
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t byteorder;
+    int64_t nplaces;
+    uint64_t hash;
+} pyswh_KdHeader;
 
-static PyObject * pyswh_User_drop FUNCARGS_SELF;
-static PyObject * pyswh_User_list FUNCARGS_KEYWDS;
-static PyObject * pyswh_User_root FUNCARGS_SELF;
-static PyObject * pyswh_User_save FUNCARGS_SELF;
-static PyObject * pyswh_User_select FUNCARGS_KEYWDS;
+typedef struct {
+    int32_t place;
+    int32_t axis;
+} pyswh_KdEntry;
+
+/* Point of the unit sphere */
+static void pyswh_kd_point(double lat, double lon, double* p)
+{
+    lat *= M_PI / 180;
+    lon *= M_PI / 180;
+    p[0] = cos(lat) * cos(lon);
+    p[1] = cos(lat) * sin(lon);
+    p[2] = sin(lat);
+}
+
+/* Great circle distance (km) of a squared chord */
+static double pyswh_kd_km(double d2)
+{
+    double c = sqrt(d2) / 2;
+    return 2 * PYSWH_EARTH_RADIUS * asin(c < 1 ? c : 1);
+}
+
+/* Put the node of rank k of [lo, hi) in place, on an axis */
+static void pyswh_kd_select(pyswh_KdNode* t, Py_ssize_t lo, Py_ssize_t hi,
+                            Py_ssize_t k, int axis)
+{
+    pyswh_KdNode tmp;
+    double pivot;
+    Py_ssize_t i, j;
+    for (--hi; lo < hi; ) {
+        pivot = t[lo + (hi - lo) / 2].p[axis];
+        for (i = lo, j = hi; i <= j; ) {
+            while (t[i].p[axis] < pivot)
+                ++i;
+            while (t[j].p[axis] > pivot)
+                --j;
+            if (i <= j) {
+                tmp = t[i];
+                t[i++] = t[j];
+                t[j--] = tmp;
+            }
+        }
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;
+    }
+}
 
-static PyMethodDef pyswh_User_methods[] = {
-{"drop", (PyCFunction) pyswh_User_drop,
-    METH_NOARGS, pyswh_User_drop__doc__},
-{"list", (PyCFunction) pyswh_User_list,
-    METH_STATIC|METH_VARARGS|METH_KEYWORDS, pyswh_User_list__doc__},
-{"root", (PyCFunction) pyswh_User_root,
-    METH_STATIC|METH_NOARGS, pyswh_User_root__doc__},
-{"save", (PyCFunction) pyswh_User_save,
-    METH_NOARGS, pyswh_User_save__doc__},
-{"select", (PyCFunction) pyswh_User_select,
-    METH_STATIC|METH_VARARGS|METH_KEYWORDS, pyswh_User_select__doc__},
-{NULL}
-};
+static void pyswh_kd_build(pyswh_KdNode* t, Py_ssize_t lo, Py_ssize_t hi)
+{
+    double min[3], max[3];
+    Py_ssize_t i, mid;
+    int j, axis;
+    while (hi - lo > 1) {
+        for (j = 0; j < 3; ++j)
+            min[j] = max[j] = t[lo].p[j];
+        for (i = lo + 1; i < hi; ++i) {
+            for (j = 0; j < 3; ++j) {
+                if (t[i].p[j] < min[j])
+                    min[j] = t[i].p[j];
+                else if (t[i].p[j] > max[j])
+                    max[j] = t[i].p[j];
+            }
+        }
+        axis = 0;
+        for (j = 1; j < 3; ++j) {
+            if (max[j] - min[j] > max[axis] - min[axis])
+                axis = j;
+        }
+        mid = lo + (hi - lo) / 2;
+        pyswh_kd_select(t, lo, hi, mid, axis);
+        t[mid].axis = axis;
+        pyswh_kd_build(t, lo, mid);
+        lo = mid + 1;
+    }
+    if (hi - lo == 1)
+        t[lo].axis = 0;
+}
 
-static PyTypeObject pyswh_User_type = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "swisseph.contrib.User",
-    .tp_doc = pyswh_User__doc__,
-    .tp_basicsize = sizeof(pyswh_Object),
-    .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
-    .tp_new = pyswh_User_new,
-    .tp_init = (initproc) pyswh_User_init,
-    .tp_dealloc = (destructor) pyswh_User_dealloc,
-    /*.tp_members = pyswh_User_members,*/
-    .tp_methods = pyswh_User_methods,
-    .tp_getset = pyswh_User_getsetters,
-};
+/* The k nearest places found, by increasing squared chord */
+typedef struct {
+    int k;
+    int n;
+    double* d2;
+    int* place;
+} pyswh_Knn;
 
-static PyObject * pyswh_User_drop FUNCARGS_SELF
+static void pyswh_knn_add(pyswh_Knn* h, double d2, int place)
 {
-    pyswh_Object* o = (pyswh_Object*) self;
-    int x;
-    if ((x = swhxx_db_user_drop(o->p))) {
-        PyErr_SetString(x == 1 ? PyExc_KeyError : pyswh_Error,
-                        swhxx_get_error(o->p));
-        swhxx_clear_error(o->p);
-        return NULL;
+    int i;
+    if (h->n == h->k) {
+        if (!(d2 < h->d2[h->k - 1]))
+            return;
+        --h->n;
+    }
+    for (i = h->n++; i > 0 && h->d2[i - 1] > d2; --i) {
+        h->d2[i] = h->d2[i - 1];
+        h->place[i] = h->place[i - 1];
+    }
+    h->d2[i] = d2;
+    h->place[i] = place;
+}
+
+static void pyswh_kd_search(const pyswh_KdNode* t, Py_ssize_t lo,
+                            Py_ssize_t hi, const double* q, pyswh_Knn* h)
+{
+    Py_ssize_t mid;
+    double d, d2;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        d = q[0] - t[mid].p[0];
+        d2 = d * d;
+        d = q[1] - t[mid].p[1];
+        d2 += d * d;
+        d = q[2] - t[mid].p[2];
+        d2 += d * d;
+        pyswh_knn_add(h, d2, t[mid].place);
+        d = q[t[mid].axis] - t[mid].p[t[mid].axis];
+        /* nearest side first, the other if it can hold nearer places */
+        if (d < 0) {
+            pyswh_kd_search(t, lo, mid, q, h);
+            if (h->n == h->k && d * d >= h->d2[h->k - 1])
+                return;
+            lo = mid + 1;
+        }
+        else {
+            pyswh_kd_search(t, mid + 1, hi, q, h);
+            if (h->n == h->k && d * d >= h->d2[h->k - 1])
+                return;
+            hi = mid;
+        }
     }
-    Py_RETURN_NONE;
 }
 
-static int pyswh_User_list_cb(void* p, int argc, char** argv, char** cols)
+/* Find the k nearest places of a point (h->k set)
+ * Distances are converted to km, h->n places are found.
+ */
+static void pyswh_AtlasIndex_knn(pyswh_AtlasIndex* self, double lat,
+                                 double lon, pyswh_Knn* h)
 {
-    PyObject* lst = (PyObject*) p;
-    pyswh_Object* u = pyswh_Object_new(&pyswh_User_type);
-    if (!u) {
-        PyErr_NoMemory();
-        return 1;
+    double q[3];
+    int i;
+    h->n = 0;
+    if (!isfinite(lat) || !isfinite(lon))
+        return;
+    pyswh_kd_point(lat, lon, q);
+    pyswh_kd_search(self->tree, 0, self->nplaces, q, h);
+    for (i = 0; i < h->n; ++i)
+        h->d2[i] = pyswh_kd_km(h->d2[i]);
+}
+
+/* Hash (FNV-1a) of the coordinates of the places */
+static uint64_t pyswh_AtlasIndex_hash(pyswh_AtlasIndex* self)
+{
+    uint64_t x = 14695981039346656037ULL;
+    const unsigned char* s;
+    Py_ssize_t i;
+    size_t j;
+    for (i = 0; i < self->nplaces; ++i) {
+        s = (const unsigned char*) &self->places[i].lat;
+        for (j = 0; j < sizeof(double); ++j)
+            x = (x ^ s[j]) * 1099511628211ULL;
+        s = (const unsigned char*) &self->places[i].lon;
+        for (j = 0; j < sizeof(double); ++j)
+            x = (x ^ s[j]) * 1099511628211ULL;
     }
-    swhxx_db_user_new(&u->p);
-    if (!u->p) {
+    return x;
+}
+
+/* Allocate the tree, with its nodes in the order of places
+ * Return > 0 on memory error, with MemoryError raised
+ */
+static int pyswh_AtlasIndex_tree_new(pyswh_AtlasIndex* self,
+                                     pyswh_KdNode** tree)
+{
+    Py_ssize_t i;
+    if (!(*tree = PyMem_Malloc(sizeof(pyswh_KdNode)
+                               * (self->nplaces ? self->nplaces : 1)))) {
         PyErr_NoMemory();
-        pyswh_Object_dealloc(u);
         return 1;
     }
-    if (swhxx_db_user_set_idx(u->p, strtoul(argv[0], NULL, 10))
-        || swhxx_db_user_set_name(u->p, argv[1])
-        || swhxx_db_user_set_pswd(u->p, argv[2])
-        || swhxx_db_user_set_mail(u->p, argv[3])
-        || swhxx_db_user_set_info(u->p, argv[4])) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(u->p));
-        pyswh_Object_dealloc(u);
+    for (i = 0; i < self->nplaces; ++i) {
+        pyswh_kd_point(self->places[i].lat, self->places[i].lon,
+                       (*tree)[i].p);
+        (*tree)[i].place = (int) i;
+        (*tree)[i].axis = 0;
+    }
+    return 0;
+}
+
+/* Build the tree, if not done
+ * Return > 0 on memory error, with MemoryError raised
+ */
+static int pyswh_AtlasIndex_tree(pyswh_AtlasIndex* self)
+{
+    pyswh_KdNode* tree;
+    int x = 0;
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (!self->tree && !(x = pyswh_AtlasIndex_tree_new(self, &tree))) {
+        pyswh_kd_build(tree, 0, self->nplaces);
+        self->tree = tree;
+    }
+    Py_END_CRITICAL_SECTION();
+    return x;
+}
+
+/* Save the tree (built) to a file
+ * Return > 0 on error, with errno set
+ */
+static int pyswh_AtlasIndex_save_tree_file(pyswh_AtlasIndex* self,
+                                           const char* path)
+{
+    FILE* fd;
+    pyswh_KdHeader hdr;
+    pyswh_KdEntry e;
+    Py_ssize_t i;
+    int x = 0, err;
+    memset(&hdr, 0, sizeof(pyswh_KdHeader));
+    memcpy(hdr.magic, PYSWH_KD_MAGIC, sizeof(PYSWH_KD_MAGIC));
+    hdr.version = PYSWH_KD_VERSION;
+    hdr.byteorder = PYSWH_KD_BYTEORDER;
+    hdr.nplaces = self->nplaces;
+    hdr.hash = pyswh_AtlasIndex_hash(self);
+    if (!(fd = fopen(path, "wb")))
         return 1;
+    if (fwrite(&hdr, sizeof(pyswh_KdHeader), 1, fd) != 1)
+        x = 1;
+    for (i = 0; !x && i < self->nplaces; ++i) {
+        e.place = self->tree[i].place;
+        e.axis = self->tree[i].axis;
+        if (fwrite(&e, sizeof(pyswh_KdEntry), 1, fd) != 1)
+            x = 1;
+    }
+    if (fclose(fd) && !x)
+        x = 1;
+    if (x) {
+        err = errno;
+        remove(path);
+        errno = err;
     }
-    if (PyList_Append(lst, (PyObject*) u)) {
-        pyswh_Object_dealloc(u);
+    return x;
+}
+
+/* Load the tree from a file
+ * Return 0 if loaded, -1 if the file does not match the index, or > 0 on
+ * error (errno set, or MemoryError raised)
+ */
+static int pyswh_AtlasIndex_load_tree_file(pyswh_AtlasIndex* self,
+                                           const char* path)
+{
+    FILE* fd;
+    pyswh_KdHeader hdr;
+    pyswh_KdEntry e;
+    pyswh_KdNode* tree = NULL, *nodes = NULL;
+    Py_ssize_t i;
+    int x = 0;
+    if (!(fd = fopen(path, "rb")))
         return 1;
+    if (fread(&hdr, sizeof(pyswh_KdHeader), 1, fd) != 1
+        || memcmp(hdr.magic, PYSWH_KD_MAGIC, sizeof(PYSWH_KD_MAGIC))
+        || hdr.version != PYSWH_KD_VERSION
+        || hdr.byteorder != PYSWH_KD_BYTEORDER
+        || hdr.nplaces != self->nplaces
+        || hdr.hash != pyswh_AtlasIndex_hash(self))
+        x = -1;
+    else if (pyswh_AtlasIndex_tree_new(self, &nodes))
+        x = 1;
+    else if (!(tree = PyMem_Malloc(sizeof(pyswh_KdNode)
+                                   * (self->nplaces ? self->nplaces : 1)))) {
+        PyErr_NoMemory();
+        x = 1;
+    }
+    for (i = 0; !x && i < self->nplaces; ++i) {
+        if (fread(&e, sizeof(pyswh_KdEntry), 1, fd) != 1
+            || e.place < 0 || e.place >= self->nplaces
+            || e.axis < 0 || e.axis > 2)
+            x = -1;
+        else {
+            tree[i] = nodes[e.place];
+            tree[i].axis = e.axis;
+        }
+    }
+    fclose(fd);
+    PyMem_Free(nodes);
+    if (x) {
+        PyMem_Free(tree);
+        return x;
     }
+    /* a tree in use is kept, as good as the file */
+    Py_BEGIN_CRITICAL_SECTION(self);
+    if (!self->tree) {
+        self->tree = tree;
+        tree = NULL;
+    }
+    Py_END_CRITICAL_SECTION();
+    PyMem_Free(tree);
     return 0;
 }
 
-static PyObject * pyswh_User_list FUNCARGS_KEYWDS
+/* Make the list of (AtlasPlace, distance) of the nearest places */
+static PyObject * pyswh_AtlasIndex_knn_list(pyswh_AtlasIndex* self,
+                                            pyswe_State* st, pyswh_Knn* h)
 {
-    int order;
-    char* orderby = NULL;
-    char err[512] = {0};
-    PyObject* lst = NULL;
-    static char* kwlist[] = {"orderby", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|z", kwlist, &orderby))
-        return NULL;
-    if (!orderby || !strcmp(orderby, "name"))
-        order = 0;
-    else if (!strcmp(orderby, "idx"))
-        order = 1;
-    else
-        return PyErr_Format(PyExc_ValueError, "invalid orderby (%s)", orderby);
-    if (!(lst = PyList_New(0)))
-        return PyErr_NoMemory();
-    if (swh_db_exec(order == 0 ? "select * from Users order by name;" :
-                    "select * from Users order by _idx;", &pyswh_User_list_cb,
-                    lst, err)) {
-        if (!PyErr_Occurred())
-            PyErr_SetString(pyswh_Error, *err ? err : "error?");
-        Py_DECREF(lst);
+    PyObject* lst, *o;
+    int i;
+    if (!(lst = PyList_New(h->n)))
         return NULL;
+    for (i = 0; i < h->n; ++i) {
+        if (!(o = pyswh_AtlasIndex_place(self, st, h->place[i]))
+            || !(o = Py_BuildValue("(Nd)", o, h->d2[i]))) {
+            Py_DECREF(lst);
+            return NULL;
+        }
+        PyList_SET_ITEM(lst, i, o);
     }
     return lst;
 }
 
-static PyObject * pyswh_User_root FUNCARGS_SELF
+/* Get the k nearest places of a point, as a list
+ * Return NULL on error
+ */
+static PyObject * pyswh_AtlasIndex_nearest_list(pyswh_AtlasIndex* self,
+                                                pyswe_State* st, double lat,
+                                                double lon, int k,
+                                                const char* fn)
 {
-    void* p = NULL;
-    pyswh_Object* o;
-    int x;
-    char err[512] = {0};
-    if ((x = swhxx_db_user_root(&p, err))) {
-        switch (x) {
-        case 4:
-            return PyErr_NoMemory();
-        case 3:
-            assert(p);
-            PyErr_SetString(pyswh_Error,
-                            swhxx_has_error(p) ? swhxx_get_error(p) : "error");
-            swhxx_db_user_dealloc(&p);
-            break;
-        case 2:
-            PyErr_SetString(pyswh_Error, err);
-            break;
-        case 1:
-            PyErr_SetString(PyExc_KeyError, err);
-            break;
-        default:
-            Py_FatalError("oops");
-        }
-        return NULL;
-    }
-    if (!(o = pyswh_Object_new(&pyswh_User_type))) {
-        swhxx_db_user_dealloc(&p);
+    pyswh_Knn h;
+    PyObject* lst;
+    if (k < 1 || k > PYSWH_KD_MAXK)
+        return PyErr_Format(PyExc_ValueError, "swisseph.contrib.%s: invalid"
+                            " k (%d)", fn, k);
+    if (!isfinite(lat) || !isfinite(lon))
+        return PyErr_Format(PyExc_ValueError, "swisseph.contrib.%s: invalid"
+                            " coordinates", fn);
+    if (pyswh_AtlasIndex_tree(self))
+        return NULL;
+    h.k = k;
+    h.d2 = PyMem_Malloc(sizeof(double) * k);
+    h.place = PyMem_Malloc(sizeof(int) * k);
+    if (!h.d2 || !h.place) {
+        PyMem_Free(h.d2);
+        PyMem_Free(h.place);
         return PyErr_NoMemory();
     }
-    o->p = p;
-    return (PyObject*) o;
+    pyswh_AtlasIndex_knn(self, lat, lon, &h);
+    lst = pyswh_AtlasIndex_knn_list(self, st, &h);
+    PyMem_Free(h.d2);
+    PyMem_Free(h.place);
+    return lst;
 }
 
-static PyObject * pyswh_User_save FUNCARGS_SELF
+PyDoc_STRVAR(pyswh_AtlasIndex_nearest__doc__,
+"Get the nearest places of a point.\n\n"
+":Args: float lat, float lon, int k=1\n\n"
+" - lat: latitude (deg)\n"
+" - lon: longitude (deg)\n"
+" - k: number of places (1 to 1000)\n\n"
+":Return: list of (AtlasPlace, distance), nearest first\n\n"
+" - distance: great circle distance (km)\n\n"
+"The spatial index (a k-d tree) is built on first call.");
+
+static PyObject * pyswh_AtlasIndex_nearest FUNCARGS_KEYWDS
 {
-    pyswh_Object* o = (pyswh_Object*) self;
-    int x;
-    if ((x = swhxx_db_user_save(o->p))) {
-        PyErr_SetString(x == 1 ? PyExc_KeyError : pyswh_Error,
-                        swhxx_get_error(o->p));
-        swhxx_clear_error(o->p);
+    double lat, lon;
+    int k = 1;
+    static char* kwlist[] = {"lat", "lon", "k", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist, &lat, &lon,
+                                     &k))
         return NULL;
-    }
-    Py_RETURN_NONE;
+    return pyswh_AtlasIndex_nearest_list((pyswh_AtlasIndex*) self,
+                                         pyswe_type_state(Py_TYPE(self)),
+                                         lat, lon, k, "AtlasIndex.nearest");
 }
 
-static PyObject * pyswh_User_select FUNCARGS_KEYWDS
-{
-    char* name;
-    void* p = NULL;
-    pyswh_Object* o;
-    int x;
-    char err[512] = {0};
-    static char* kwlist[] = {"name", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &name))
-        return NULL;
-    if ((x = swhxx_db_user_select(name, &p, err))) {
-        switch (x) {
-        case 4:
-            return PyErr_NoMemory();
-        case 3:
-            assert(p);
-            PyErr_SetString(pyswh_Error,
-                            swhxx_has_error(p) ? swhxx_get_error(p) : "");
-            swhxx_db_user_dealloc(&p);
-            break;
-        case 2:
-            PyErr_SetString(pyswh_Error, err);
-            break;
-        case 1:
-            PyErr_SetString(PyExc_KeyError, err);
-            break;
-        default:
-            Py_FatalError("oops");
+typedef struct {
+    pyswh_AtlasIndex* self;
+    const double* lat;
+    const double* lon;
+    int k;
+    int* places;
+    double* dist;
+} pyswh_NearestArray;
+
+static void pyswh_nearest_many_run(pyswe_Job* job, Py_ssize_t start,
+                                   Py_ssize_t end)
+{
+    pyswh_NearestArray* a = (pyswh_NearestArray*) job->data;
+    pyswh_Knn h;
+    Py_ssize_t i;
+    int j;
+    h.k = a->k;
+    for (i = start; i < end; ++i) {
+        /* found in the rows of results */
+        h.d2 = a->dist + i * a->k;
+        h.place = a->places + i * a->k;
+        pyswh_AtlasIndex_knn(a->self, a->lat[i], a->lon[i], &h);
+        for (j = h.n; j < a->k; ++j) {
+            h.d2[j] = Py_NAN;
+            h.place[j] = -1;
         }
-        return NULL;
     }
-    if (!p)
-        return PyErr_Format(PyExc_KeyError, "no such user (%s)", name);
-    if (!(o = pyswh_Object_new(&pyswh_User_type))) {
-        swhxx_db_user_dealloc(&p);
-        return PyErr_NoMemory();
-    }
-    o->p = p;
-    return (PyObject*) o;
 }
 
-/* swisseph.contrib.Data */
-PyDoc_STRVAR(pyswh_Data__doc__,
-"Astro data");
-PyDoc_STRVAR(pyswh_Data_idx__doc__,
-"Data idx");
-PyDoc_STRVAR(pyswh_Data_useridx__doc__,
-"Data user idx");
-PyDoc_STRVAR(pyswh_Data_title__doc__,
-"Data title");
-PyDoc_STRVAR(pyswh_Data_jd__doc__,
-"Data julian day");
-PyDoc_STRVAR(pyswh_Data_latitude__doc__,
-"Data latitude");
-PyDoc_STRVAR(pyswh_Data_longitude__doc__,
-"Data longitude");
-PyDoc_STRVAR(pyswh_Data_altitude__doc__,
-"Data altitude");
-PyDoc_STRVAR(pyswh_Data_datetime__doc__,
-"Data date and time");
-PyDoc_STRVAR(pyswh_Data_timezone__doc__,
-"Data timezone");
-PyDoc_STRVAR(pyswh_Data_isdst__doc__,
-"Data isdst");
-PyDoc_STRVAR(pyswh_Data_location__doc__,
-"Data location");
-PyDoc_STRVAR(pyswh_Data_country__doc__,
-"Data country");
-PyDoc_STRVAR(pyswh_Data_owner__doc__,
-"Get the owner of data\n\n"
-":Args: --\n"
-":Return: swh.User found, or None");
+/* Get the k nearest places of points, as arrays
+ * Return NULL on error
+ */
+static PyObject * pyswh_AtlasIndex_nearest_arrays(pyswh_AtlasIndex* self,
+                                                  PyObject* lats,
+                                                  PyObject* lons, int k,
+                                                  const char* fn)
+{
+    pyswh_NearestArray a;
+    pyswe_DArray lat, lon;
+    pyswe_Job job;
+    PyObject* places = NULL, *dist = NULL;
+    char name[64];
+    snprintf(name, sizeof(name), "contrib.%s", fn);
+    if (k < 1 || k > PYSWH_KD_MAXK)
+        return PyErr_Format(PyExc_ValueError, "swisseph.contrib.%s: invalid"
+                            " k (%d)", fn, k);
+    if (pyswh_AtlasIndex_tree(self)
+        || pyswe_darray_get(lats, &lat, name, "lats"))
+        return NULL;
+    if (pyswe_darray_get(lons, &lon, name, "lons")) {
+        pyswe_darray_release(&lat);
+        return NULL;
+    }
+    if (lat.n != lon.n) {
+        PyErr_Format(PyExc_ValueError, "swisseph.contrib.%s: lats and lons:"
+                     " lengths differ (%zd, %zd)", fn, lat.n, lon.n);
+        goto error;
+    }
+    if (!(places = pyswe_results_new(lat.n, k, sizeof(int),
+                                      (void**) &a.places))
+        || !(dist = pyswe_results_new(lat.n, k, sizeof(double),
+                                      (void**) &a.dist)))
+        goto error;
+    a.self = self;
+    a.lat = lat.d;
+    a.lon = lon.d;
+    a.k = k;
+    job.func = pyswh_nearest_many_run;
+    job.data = &a;
+    job.n = lat.n;
+    job.chunk = 256;
+    job.errors = PYSWE_ERRORS_RAISE;
+    job.errlist = 0;
+    if (pyswe_pool_run(&job))
+        goto error;
+    pyswe_darray_release(&lat);
+    pyswe_darray_release(&lon);
+    return Py_BuildValue("NN", pyswe_results_view(places, "i", lat.n, k),
+                         pyswe_results_view(dist, "d", lat.n, k));
+error:
+    pyswe_darray_release(&lat);
+    pyswe_darray_release(&lon);
+    Py_XDECREF(places);
+    Py_XDECREF(dist);
+    return NULL;
+}
+
+PyDoc_STRVAR(pyswh_AtlasIndex_nearest_many__doc__,
+"Get the nearest places of many points.\n\n"
+":Args: seq lats, seq lons, int k=1\n\n"
+" - lats: latitudes (deg), as a sequence or a buffer of float64\n"
+" - lons: longitudes (deg), of the same length\n"
+" - k: number of places per point (1 to 1000)\n\n"
+":Return: places, distances\n\n"
+" - places: memoryview of int32 of shape (n, k), numbers of the places"
+" (index[i] is the AtlasPlace), nearest first, -1 if none\n"
+" - distances: memoryview of float64 of shape (n, k), great circle"
+" distances (km), NaN if none\n\n"
+"Points are searched in parallel by the thread pool. Points with NaN"
+" coordinates have no places.");
+
+static PyObject * pyswh_AtlasIndex_nearest_many FUNCARGS_KEYWDS
+{
+    PyObject* lats, *lons;
+    int k = 1;
+    static char* kwlist[] = {"lats", "lons", "k", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|i", kwlist, &lats, &lons,
+                                     &k))
+        return NULL;
+    return pyswh_AtlasIndex_nearest_arrays((pyswh_AtlasIndex*) self, lats,
+                                           lons, k, "AtlasIndex.nearest_many");
+}
+
+PyDoc_STRVAR(pyswh_AtlasIndex_save_tree__doc__,
+"Save the spatial index of nearest() to a file.\n\n"
+":Args: str path\n\n"
+":Return: None\n\n"
+"The tree is built if not done.");
 
-static PyObject * pyswh_Data_new(PyTypeObject* tp, PyObject* args, PyObject* kwds)
+static PyObject * pyswh_AtlasIndex_save_tree FUNCARGS_KEYWDS
 {
-    pyswh_Object* self = pyswh_Object_new(tp);
-    if (self) {
-        swhxx_db_data_new(&self->p);
-        if (!self->p) {
-            pyswh_Object_dealloc(self);
-            self = NULL;
-        }
-    }
-    return (PyObject*) self;
+    char* path;
+    static char* kwlist[] = {"path", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &path)
+        || pyswh_AtlasIndex_tree((pyswh_AtlasIndex*) self))
+        return NULL;
+    if (pyswh_AtlasIndex_save_tree_file((pyswh_AtlasIndex*) self, path))
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    Py_RETURN_NONE;
 }
 
-static void pyswh_Data_dealloc(pyswh_Object* self)
+PyDoc_STRVAR(pyswh_AtlasIndex_load_tree__doc__,
+"Load the spatial index of nearest() from a file.\n\n"
+":Args: str path\n\n"
+" - path: file written by save_tree()\n\n"
+":Return: True if loaded, False if the file is not for the places of the"
+" index (another atlas, or another version)\n\n"
+"A tree already built is kept.");
+
+static PyObject * pyswh_AtlasIndex_load_tree FUNCARGS_KEYWDS
 {
-    if (self->p)
-        swhxx_db_data_dealloc(&self->p);
-    pyswh_Object_dealloc(self);
+    char* path;
+    int x;
+    static char* kwlist[] = {"path", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &path))
+        return NULL;
+    x = pyswh_AtlasIndex_load_tree_file((pyswh_AtlasIndex*) self, path);
+    if (x > 0)
+        return PyErr_Occurred() ? NULL
+            : PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    return PyBool_FromLong(!x);
 }
 
-static int pyswh_Data_init(pyswh_Object* self, PyObject* args, PyObject* kwds)
+static PyObject * pyswh_AtlasIndex_item(pyswh_AtlasIndex* self, Py_ssize_t i)
 {
-    char* title = "now", *dt = "", *tz = "", *loc = "", *ctry = "";
-    double jd = swh_jdnow(), lat = 0, lon = 0;
-    long alt = 0, isdst = -1;
-    static char* kwlist[] = {"title", "jd", "latitude", "longitude", "altitude",
-                             "datetime", "timezone", "isdst", "location",
-                             "country", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sdddississ", kwlist,
-                &title, &jd, &lat, &lon, &alt, &dt, &tz, &loc, &ctry))
-        return -1;
-    if (swhxx_db_data_set_title(self->p, title)
-        || swhxx_db_data_set_jd(self->p, jd)
-        || swhxx_db_data_set_latitude(self->p, lat)
-        || swhxx_db_data_set_longitude(self->p, lon)
-        || swhxx_db_data_set_altitude(self->p, alt)
-        || swhxx_db_data_set_datetime(self->p, dt)
-        || swhxx_db_data_set_timezone(self->p, tz)
-        || swhxx_db_data_set_isdst(self->p, isdst)
-        || swhxx_db_data_set_location(self->p, loc)
-        || swhxx_db_data_set_country(self->p, ctry)) {
-        PyErr_SetString(PyExc_AttributeError, swhxx_get_error(self->p));
-        swhxx_clear_error(self->p);
-        return -1;
+    if (i < 0 || i >= self->nplaces) {
+        PyErr_SetString(PyExc_IndexError, "AtlasIndex index out of range");
+        return NULL;
     }
-    return 0;
-}
-
-static pyswh_ulong_getsetter pyswh_Data_getset_idx = {
-    &swhxx_db_data_get_idx, NULL
-};
-static pyswh_ulong_getsetter pyswh_Data_getset_useridx = {
-    &swhxx_db_data_get_useridx, NULL
-};
-static pyswh_string_getsetter pyswh_Data_getset_title = {
-    &swhxx_db_data_get_title, &swhxx_db_data_set_title
-};
-static pyswh_double_getsetter pyswh_Data_getset_jd = {
-    &swhxx_db_data_get_jd, &swhxx_db_data_set_jd
-};
-static pyswh_double_getsetter pyswh_Data_getset_latitude = {
-    &swhxx_db_data_get_latitude, &swhxx_db_data_set_latitude
-};
-static pyswh_double_getsetter pyswh_Data_getset_longitude = {
-    &swhxx_db_data_get_longitude, &swhxx_db_data_set_longitude
-};
-static pyswh_long_getsetter pyswh_Data_getset_altitude = {
-    &swhxx_db_data_get_altitude, &swhxx_db_data_set_altitude
-};
-static pyswh_string_getsetter pyswh_Data_getset_datetime = {
-    &swhxx_db_data_get_datetime, &swhxx_db_data_set_datetime
-};
-static pyswh_string_getsetter pyswh_Data_getset_timezone = {
-    &swhxx_db_data_get_timezone, &swhxx_db_data_set_timezone
-};
-static pyswh_long_getsetter pyswh_Data_getset_isdst = {
-    &swhxx_db_data_get_isdst, &swhxx_db_data_set_isdst
-};
-static pyswh_string_getsetter pyswh_Data_getset_location = {
-    &swhxx_db_data_get_location, &swhxx_db_data_set_location
-};
-static pyswh_string_getsetter pyswh_Data_getset_country = {
-    &swhxx_db_data_get_country, &swhxx_db_data_set_country
-};
-
-static PyGetSetDef pyswh_Data_getsetters[] = {
-{"_idx", (getter) pyswh_Object_get_ulong, (setter) pyswh_Object_set_readonly,
-    pyswh_Data_idx__doc__, &pyswh_Data_getset_idx},
-{"_useridx", (getter) pyswh_Object_get_ulong, (setter) pyswh_Object_set_readonly,
-    pyswh_Data_useridx__doc__, &pyswh_Data_getset_useridx},
-{"title", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_Data_title__doc__, &pyswh_Data_getset_title},
-{"jd", (getter) pyswh_Object_get_double, (setter) pyswh_Object_set_double,
-    pyswh_Data_jd__doc__, &pyswh_Data_getset_jd},
-{"latitude", (getter) pyswh_Object_get_double, (setter) pyswh_Object_set_double,
-    pyswh_Data_latitude__doc__, &pyswh_Data_getset_latitude},
-{"longitude", (getter) pyswh_Object_get_double, (setter) pyswh_Object_set_double,
-    pyswh_Data_longitude__doc__, &pyswh_Data_getset_longitude},
-{"altitude", (getter) pyswh_Object_get_long, (setter) pyswh_Object_set_long,
-    pyswh_Data_altitude__doc__, &pyswh_Data_getset_altitude},
-{"datetime", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_Data_datetime__doc__, &pyswh_Data_getset_datetime},
-{"timezone", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_Data_timezone__doc__, &pyswh_Data_getset_timezone},
-{"isdst", (getter) pyswh_Object_get_long, (setter) pyswh_Object_set_long,
-    pyswh_Data_isdst__doc__, &pyswh_Data_getset_isdst},
-{"location", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_Data_location__doc__, &pyswh_Data_getset_location},
-{"country", (getter) pyswh_Object_get_string, (setter) pyswh_Object_set_string,
-    pyswh_Data_country__doc__, &pyswh_Data_getset_country},
+    return pyswh_AtlasIndex_place(self, pyswe_type_state(Py_TYPE(self)),
+                                  (int) i);
+}
+
+static PyMethodDef pyswh_AtlasIndex_methods[] = {
+{"load_tree", (PyCFunction) pyswh_AtlasIndex_load_tree,
+    METH_VARARGS|METH_KEYWORDS, pyswh_AtlasIndex_load_tree__doc__},
+{"nearest", (PyCFunction) pyswh_AtlasIndex_nearest,
+    METH_VARARGS|METH_KEYWORDS, pyswh_AtlasIndex_nearest__doc__},
+{"nearest_many", (PyCFunction) pyswh_AtlasIndex_nearest_many,
+    METH_VARARGS|METH_KEYWORDS, pyswh_AtlasIndex_nearest_many__doc__},
+{"save_tree", (PyCFunction) pyswh_AtlasIndex_save_tree,
+    METH_VARARGS|METH_KEYWORDS, pyswh_AtlasIndex_save_tree__doc__},
+{"search", (PyCFunction) pyswh_AtlasIndex_search,
+    METH_VARARGS|METH_KEYWORDS, pyswh_AtlasIndex_search__doc__},
+{"search_many", (PyCFunction) pyswh_AtlasIndex_search_many,
+    METH_VARARGS|METH_KEYWORDS, pyswh_AtlasIndex_search_many__doc__},
 {NULL}
 };
-
-static PyObject * pyswh_Data_owner FUNCARGS_SELF;
-
-static PyMethodDef pyswh_Data_methods[] = {
-{"owner", (PyCFunction) pyswh_Data_owner,
-    METH_NOARGS, pyswh_Data_owner__doc__},
-{NULL}
+
+static PyType_Slot pyswh_AtlasIndex_slots[] = {
+    {Py_tp_doc, (void*) pyswh_AtlasIndex__doc__},
+    {Py_tp_new, pyswh_AtlasIndex_new},
+    {Py_tp_dealloc, pyswh_AtlasIndex_dealloc},
+    {Py_tp_methods, pyswh_AtlasIndex_methods},
+    {Py_sq_length, pyswh_AtlasIndex_len},
+    {Py_sq_item, pyswh_AtlasIndex_item},
+    {0, NULL}
 };
 
-static PyTypeObject pyswh_Data_type = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "swisseph.contrib.Data",
-    .tp_doc = pyswh_Data__doc__,
-    .tp_basicsize = sizeof(pyswh_Object),
-    .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT|Py_TPFLAGS_BASETYPE,
-    .tp_new = pyswh_Data_new,
-    .tp_init = (initproc) pyswh_Data_init,
-    .tp_dealloc = (destructor) pyswh_Data_dealloc,
-    /*.tp_members = pyswh_Data_members,*/
-    .tp_methods = pyswh_Data_methods,
-    .tp_getset = pyswh_Data_getsetters,
+static PyType_Spec pyswh_AtlasIndex_spec = {
+    .name = "swisseph.contrib.AtlasIndex",
+    .basicsize = sizeof(pyswh_AtlasIndex),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = pyswh_AtlasIndex_slots,
 };
 
-static PyObject * pyswh_Data_owner FUNCARGS_SELF
+/* Drop the index of atlas_index(), before the atlas changes */
+static void pyswh_atlas_index_reset(PyObject* m)
 {
-    pyswh_Object* o = (pyswh_Object*) self;
-    void* p;
-    int x;
-    char err[512] = {0};
-    if ((x = swhxx_db_data_owner(o->p, &p, err))) {
-        switch (x) {
-        case 3:
-            return PyErr_NoMemory();
-        case 2:
-            PyErr_SetString(pyswh_Error, err);
-            break;
-        case 1:
-            PyErr_SetString(PyExc_KeyError, err);
-            break;
-        default:
-            Py_FatalError("oops");
-        }
-        return NULL;
-    }
-    if (!p)
-        Py_RETURN_NONE;
-    if (!(o = pyswh_Object_new(&pyswh_User_type))) {
-        swhxx_db_user_dealloc(&p);
-        return PyErr_NoMemory();
-    }
-    o->p = p;
-    return (PyObject*) o;
+    pyswe_State* st = pyswh_get_state(m);
+    PyObject* o;
+    pyswe_state_lock(st);
+    o = st->atlas_index;
+    st->atlas_index = NULL;
+    pyswe_state_unlock(st);
+    Py_XDECREF(o);
 }
 
 /* swisseph.contrib.antiscion */
@@ -4251,10 +11265,31 @@ PyDoc_STRVAR(pyswh_atlas_close__doc__,
 ":Args: --\n"
 ":Return: None");
 
+/* Path of the connected atlas, NULL if unknown (with pyswh_db_lock) */
+static char* pyswh_atlas_path = NULL;
+
+/* Keep the path of the atlas connected, or NULL when closed
+ * As in swephelp, SWH_ATLAS_PATH overrides the path given.
+ */
+static void pyswh_atlas_set_path(const char* p)
+{
+    const char* env = getenv("SWH_ATLAS_PATH");
+    PyMem_RawFree(pyswh_atlas_path);
+    pyswh_atlas_path = NULL;
+    if (p && env && *env)
+        p = env;
+    if (p && *p && (pyswh_atlas_path = PyMem_RawMalloc(strlen(p) + 1)))
+        strcpy(pyswh_atlas_path, p);
+}
+
 static PyObject * pyswh_atlas_close FUNCARGS_SELF
 {
-    if (swh_atlas_close()) {
-        PyErr_SetString(pyswh_Error, "swisseph.contrib.atlas_close: error");
+    int x;
+    pyswh_atlas_index_reset(self);
+    PYSWH_DB_CALL(x = swh_atlas_close(); pyswh_atlas_set_path(NULL));
+    if (x) {
+        PyErr_SetString(pyswh_error(self),
+                        "swisseph.contrib.atlas_close: error");
         return NULL;
     }
     Py_RETURN_NONE;
@@ -4271,12 +11306,17 @@ PyDoc_STRVAR(pyswh_atlas_connect__doc__,
 
 static PyObject * pyswh_atlas_connect FUNCARGS_KEYWDS
 {
+    int x;
     char* p = NULL;
     static char* kwlist[] = {"path", NULL};
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "|z", kwlist, &p))
         return NULL;
-    if (swh_atlas_connect(p)) {
-        PyErr_SetString(pyswh_Error, "swisseph.contrib.atlas_connect: error");
+    pyswh_atlas_index_reset(self);
+    PYSWH_DB_CALL(x = swh_atlas_connect(p);
+                  pyswh_atlas_set_path(x ? NULL : p ? p : ""));
+    if (x) {
+        PyErr_SetString(pyswh_error(self),
+                        "swisseph.contrib.atlas_connect: error");
         return NULL;
     }
     Py_RETURN_NONE;
@@ -4306,10 +11346,11 @@ static PyObject * pyswh_atlas_countries_list FUNCARGS_SELF
     PyObject* p = PyList_New(0);
     if (!p)
         return PyErr_NoMemory();
-    x = swh_atlas_countries_list(&pyswh_atlas_countries_list_cb, p, err);
+    PYSWH_DB_CALL(x = swh_atlas_countries_list(&pyswh_atlas_countries_list_cb,
+                                               p, err));
     if (x) {
         if (!PyErr_Occurred())
-            PyErr_Format(pyswh_Error,
+            PyErr_Format(pyswh_error(self),
                          "swisseph.contrib.atlas_countries_list: %s",
                          *err ? err : "error");
         Py_DECREF(p);
@@ -4318,6 +11359,166 @@ static PyObject * pyswh_atlas_countries_list FUNCARGS_SELF
     return p;
 }
 
+/* swisseph.contrib.atlas_index */
+PyDoc_STRVAR(pyswh_atlas_index__doc__,
+"Get the in-memory index of the connected atlas database\n\n"
+":Args: bool rebuild=False, bool persist=False\n\n"
+" - rebuild: load the atlas again, if it was modified\n"
+" - persist: load the spatial index of atlas_nearest() from the file of the"
+" atlas with a .kdtree suffix, or build it and save it there (if possible)\n\n"
+":Return: AtlasIndex\n\n"
+"The index is built on first call, and kept until the atlas is closed or"
+" connected again. Persisting needs the path of the atlas, given to"
+" atlas_connect() or in ``SWH_ATLAS_PATH``.\n\n"
+"Usage example:\n\n"
+"\t>>> lst = swh.atlas_index().search('zurich', 'ch')");
+
+/* Get the index of atlas_index()
+ * Return a new reference, or NULL on error
+ */
+static PyObject * pyswh_atlas_index_get(PyObject* m, int rebuild)
+{
+    PyObject* o, *old;
+    pyswe_State* st = pyswh_get_state(m);
+    pyswe_state_lock(st);
+    o = st->atlas_index;
+    Py_XINCREF(o);
+    pyswe_state_unlock(st);
+    if (o && !rebuild)
+        return o;
+    Py_XDECREF(o);
+    /* built without the state lock, concurrent calls may build it twice */
+    if (!(o = PyObject_CallObject((PyObject*) st->atlas_index_type, NULL)))
+        return NULL;
+    Py_INCREF(o);
+    pyswe_state_lock(st);
+    old = st->atlas_index;
+    st->atlas_index = o;
+    pyswe_state_unlock(st);
+    Py_XDECREF(old);
+    return o;
+}
+
+/* Load the tree of an index next to the atlas, or build and save it there
+ * Return > 0 on error, with an exception set
+ */
+static int pyswh_atlas_index_persist(pyswh_AtlasIndex* o)
+{
+    char* path = NULL;
+    int x, known;
+    if (o->tree)
+        return 0; /* built, loaded or saved before */
+    pyswe_lock_nogil(&pyswh_db_lock);
+    if ((known = pyswh_atlas_path != NULL)
+        && (path = PyMem_RawMalloc(strlen(pyswh_atlas_path) + 8)))
+        sprintf(path, "%s.kdtree", pyswh_atlas_path);
+    pyswe_unlock(&pyswh_db_lock);
+    if (!path) {
+        if (known)
+            PyErr_NoMemory();
+        else
+            PyErr_SetString(PyExc_ValueError, "swisseph.contrib.atlas_index:"
+                            " persist: path of the atlas unknown");
+        return 1;
+    }
+    x = pyswh_AtlasIndex_load_tree_file(o, path);
+    if (x > 0 && PyErr_Occurred()) {
+        PyMem_RawFree(path);
+        return 1;
+    }
+    if (x) {
+        if (pyswh_AtlasIndex_tree(o)) {
+            PyMem_RawFree(path);
+            return 1;
+        }
+        pyswh_AtlasIndex_save_tree_file(o, path);
+    }
+    PyMem_RawFree(path);
+    return 0;
+}
+
+static PyObject * pyswh_atlas_index FUNCARGS_KEYWDS
+{
+    int rebuild = 0, persist = 0;
+    PyObject* o;
+    static char* kwlist[] = {"rebuild", "persist", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|pp", kwlist, &rebuild,
+                                     &persist))
+        return NULL;
+    o = pyswh_atlas_index_get(self, rebuild);
+    if (o && persist && pyswh_atlas_index_persist((pyswh_AtlasIndex*) o)) {
+        Py_DECREF(o);
+        return NULL;
+    }
+    return o;
+}
+
+/* swisseph.contrib.atlas_nearest */
+PyDoc_STRVAR(pyswh_atlas_nearest__doc__,
+"Get the nearest places of a point, in the connected atlas database\n\n"
+":Args: float lat, float lon, int k=1\n\n"
+" - lat: latitude (deg)\n"
+" - lon: longitude (deg)\n"
+" - k: number of places (1 to 1000)\n\n"
+":Return: list of (AtlasPlace, distance), nearest first\n\n"
+" - distance: great circle distance (km)\n\n"
+"Same as atlas_index().nearest(...). The spatial index is built on first call,"
+" see atlas_index() to persist it.\n\n"
+"Usage example:\n\n"
+"\t>>> (place, km), = swh.atlas_nearest(47.37, 8.54)\n"
+"\t>>> place.timezone\n"
+"\t'Europe/Zurich'");
+
+static PyObject * pyswh_atlas_nearest FUNCARGS_KEYWDS
+{
+    double lat, lon;
+    int k = 1;
+    PyObject* o, *res;
+    static char* kwlist[] = {"lat", "lon", "k", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist, &lat, &lon,
+                                     &k)
+        || !(o = pyswh_atlas_index_get(self, 0)))
+        return NULL;
+    res = pyswh_AtlasIndex_nearest_list((pyswh_AtlasIndex*) o,
+                                        pyswh_get_state(self), lat, lon, k,
+                                        "atlas_nearest");
+    Py_DECREF(o);
+    return res;
+}
+
+/* swisseph.contrib.atlas_nearest_many */
+PyDoc_STRVAR(pyswh_atlas_nearest_many__doc__,
+"Get the nearest places of many points, in the connected atlas database\n\n"
+":Args: seq lats, seq lons, int k=1\n\n"
+" - lats: latitudes (deg), as a sequence or a buffer of float64\n"
+" - lons: longitudes (deg), of the same length\n"
+" - k: number of places per point (1 to 1000)\n\n"
+":Return: places, distances\n\n"
+" - places: memoryview of int32 of shape (n, k), numbers of the places in"
+" atlas_index(), nearest first, -1 if none\n"
+" - distances: memoryview of float64 of shape (n, k), great circle"
+" distances (km), NaN if none\n\n"
+"Same as atlas_index().nearest_many(...).\n\n"
+"Usage example:\n\n"
+"\t>>> places, km = swh.atlas_nearest_many(lats, lons)\n"
+"\t>>> idx = swh.atlas_index()\n"
+"\t>>> tz = [idx[i].timezone for i in places.tolist()[0]]");
+
+static PyObject * pyswh_atlas_nearest_many FUNCARGS_KEYWDS
+{
+    PyObject* lats, *lons, *o, *res;
+    int k = 1;
+    static char* kwlist[] = {"lats", "lons", "k", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|i", kwlist, &lats, &lons,
+                                     &k)
+        || !(o = pyswh_atlas_index_get(self, 0)))
+        return NULL;
+    res = pyswh_AtlasIndex_nearest_arrays((pyswh_AtlasIndex*) o, lats, lons,
+                                          k, "atlas_nearest_many");
+    Py_DECREF(o);
+    return res;
+}
+
 /* swisseph.contrib.atlas_search */
 PyDoc_STRVAR(pyswh_atlas_search__doc__,
 "Search for a location in the atlas database.\n\n"
@@ -4328,7 +11529,7 @@ PyDoc_STRVAR(pyswh_atlas_search__doc__,
 " longitude, elevation, timezone)\n\n"
 "Location and country names can be abbreviated. If country is a 2-character"
 " string, it will be evaluated as an ISO country code, and the search will be"
-" faster.\n\n"
+" faster. See also atlas_index(), for searches without SQL queries.\n\n"
 "Usage example:\n\n"
 "\t>>> lst = swh.atlas_search('zurich', 'swi')\n"
 "\t>>> lst = swh.atlas_search('zurich', 'ch')");
@@ -4350,17 +11551,27 @@ static PyObject * pyswh_atlas_search FUNCARGS_KEYWDS
 {
     char* loc, *ctry;
     int x;
+    Py_ssize_t i;
     char err[512] = {0};
     PyObject* p = NULL;
+    pyswh_Rows rows;
     static char* kwlist[] = {"location", "country", NULL};
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "ss", kwlist, &loc, &ctry))
         return NULL;
     if (!(p = PyList_New(0)))
         return PyErr_NoMemory();
-    x = swh_atlas_search(loc, ctry, &pyswh_atlas_search_cb, p, err);
+    /* rows are collected without the GIL, then converted */
+    pyswh_rows_init(&rows, 8);
+    PYSWH_DB_CALL_NOGIL(x = swh_atlas_search(loc, ctry, &pyswh_rows_cb, &rows,
+                                             err));
+    if (rows.nomem)
+        PyErr_NoMemory();
+    for (i = 0; !x && i < rows.nrows; ++i)
+        x = pyswh_atlas_search_cb(p, 8, pyswh_rows_get(&rows, i), NULL);
+    pyswh_rows_free(&rows);
     if (x) {
         if (!PyErr_Occurred())
-            PyErr_Format(pyswh_Error, "swisseph.contrib.atlas_search: %s",
+            PyErr_Format(pyswh_error(self), "swisseph.contrib.atlas_search: %s",
                          *err ? err : "error");
         Py_DECREF(p);
         return NULL;
@@ -4368,6 +11579,40 @@ static PyObject * pyswh_atlas_search FUNCARGS_KEYWDS
     return p;
 }
 
+/* swisseph.contrib.atlas_search_many */
+PyDoc_STRVAR(pyswh_atlas_search_many__doc__,
+"Search for the best place of many locations, in the connected atlas"
+" database\n\n"
+":Args: seq locations, countries=None\n\n"
+" - locations: sequence of str, beginnings of names as in atlas_search()\n"
+" - countries: str for all locations, or sequence of str of the same length,"
+" or None for all countries\n\n"
+":Return: places, latitudes, longitudes, scores\n\n"
+" - places: memoryview of int32, numbers of the places in atlas_index(), -1 if"
+" not found\n"
+" - latitudes, longitudes: memoryviews of float64, NaN if not found\n"
+" - scores: memoryview of float64, quality of the matches, from 1 (the name of"
+" a place) to 0 (not found)\n\n"
+"Same as atlas_index().search_many(...), see there.\n\n"
+"Usage example:\n\n"
+"\t>>> places, lat, lon, score = swh.atlas_search_many(cities, countries)\n"
+"\t>>> idx = swh.atlas_index()\n"
+"\t>>> tz = [idx[i].timezone if i >= 0 else None for i in places.tolist()]");
+
+static PyObject * pyswh_atlas_search_many FUNCARGS_KEYWDS
+{
+    PyObject* locations, *countries = NULL, *o, *res;
+    static char* kwlist[] = {"locations", "countries", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", kwlist, &locations,
+                                     &countries)
+        || !(o = pyswh_atlas_index_get(self, 0)))
+        return NULL;
+    res = pyswh_AtlasIndex_search_arrays((pyswh_AtlasIndex*) o, locations,
+                                         countries, "atlas_search_many");
+    Py_DECREF(o);
+    return res;
+}
+
 /* swisseph.contrib.calc_ut */
 PyDoc_STRVAR(pyswh_calc_ut__doc__,
 "Calculate positions of a planet or fixed star or special point.\n\n"
@@ -4397,13 +11642,14 @@ static PyObject * pyswh_calc_ut FUNCARGS_KEYWDS
     /* extract pl/star */
     i = py_obj2plstar(p, &pl, &star);
     if (i > 0) {
-        PyErr_SetString(pyswh_Error,
+        PyErr_SetString(pyswh_error(self),
                         "swisseph.contrib.calc_ut: invalid body type");
         return NULL;
     }
     i = swh_calc_ut(t, pl, star, flags, res, st, err);
     if (i < 0)
-        return PyErr_Format(pyswe_Error, "swisseph.contrib.calc_ut: %s", err);
+        return PyErr_Format(pyswh_get_state(self)->error,
+                            "swisseph.contrib.calc_ut: %s", err);
     return star ?
         Py_BuildValue("(dddddd)si",res[0],res[1],res[2],res[3],res[4],res[5],
                 st, i)
@@ -4419,8 +11665,10 @@ PyDoc_STRVAR(pyswh_db_close__doc__,
 
 static PyObject * pyswh_db_close FUNCARGS_SELF
 {
-    if (swh_db_close()) {
-        PyErr_SetString(pyswh_Error, "swisseph.contrib.db_close: error");
+    int x;
+    PYSWH_DB_CALL(x = swh_db_close(); pyswh_pool_set_path(NULL));
+    if (x) {
+        PyErr_SetString(pyswh_error(self), "swisseph.contrib.db_close: error");
         return NULL;
     }
     Py_RETURN_NONE;
@@ -4429,22 +11677,50 @@ static PyObject * pyswh_db_close FUNCARGS_SELF
 /* swisseph.contrib.db_connect */
 PyDoc_STRVAR(pyswh_db_connect__doc__,
 "Connect to astro database file\n\n"
-":Args: str path='', bool check=True\n\n"
+":Args: str path='', bool check=True, bool wal=True\n\n"
 " - path: path to astro database file\n"
-" - check: verify database version\n\n"
+" - check: verify database version\n"
+" - wal: use write-ahead logging (journal mode WAL)\n\n"
 ":Return: None\n\n"
-"If it does not exist, the database file will be created.");
+"If it does not exist, the database file will be created. Queries made by"
+" this module (User.list) then use a pool of read-only connections, and run"
+" concurrently without the GIL. With WAL, they are not blocked by writes.");
+
+/* Get the file of the main database, from PRAGMA database_list
+ * The path is allocated (NULL if out of memory, the pool is then unused).
+ */
+static int pyswh_db_file_cb(void* p, int argc, char** argv, char** cols)
+{
+    char** path = (char**) p;
+    if (path && argc > 2 && argv[1] && !strcmp(argv[1], "main") && argv[2]
+        && !*path && (*path = PyMem_RawMalloc(strlen(argv[2]) + 1)))
+        strcpy(*path, argv[2]);
+    return 0;
+}
 
 static PyObject * pyswh_db_connect FUNCARGS_KEYWDS
 {
-    int check = 1;
-    char* p = NULL;
+    int x, check = 1, wal = 1;
+    char* p = NULL, *path = NULL;
     char err[512];
-    static char* kwlist[] = {"path", "check", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|zp", kwlist, &p, &check))
-        return NULL;
-    if (swh_db_connect(p, check, err))
-        return PyErr_Format(pyswh_Error,
+    static char* kwlist[] = {"path", "check", "wal", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|zpp", kwlist, &p, &check,
+                                     &wal))
+        return NULL;
+    PYSWH_DB_CALL(
+        if (!(x = swh_db_connect(p, check, err))) {
+            /* journal mode is unchanged on failure (eg in-memory) */
+            if (wal)
+                swh_db_exec("PRAGMA journal_mode=WAL;", &pyswh_db_file_cb,
+                            NULL, err);
+            /* the file actually opened (empty if temporary) */
+            swh_db_exec("PRAGMA database_list;", &pyswh_db_file_cb, &path,
+                        err);
+            pyswh_pool_set_path(path);
+            PyMem_RawFree(path);
+        });
+    if (x)
+        return PyErr_Format(pyswh_error(self),
                             "swisseph.contrib.db_connect: %s", err);
     Py_RETURN_NONE;
 }
@@ -4495,7 +11771,7 @@ static PyObject * pyswh_dt2i FUNCARGS_KEYWDS
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &dt))
         return NULL;
     x = swh_dt2i(dt, ret);
-    return x ? PyErr_Format(pyswh_Error,
+    return x ? PyErr_Format(pyswh_error(self),
                     "swisseph.contrib.dt2i: invalid datetime string (%s)", dt)
         : Py_BuildValue("iiiiii",ret[0],ret[1],ret[2],ret[3],ret[4],ret[5]);
 }
@@ -4528,7 +11804,7 @@ static PyObject * pyswh_geoc2d FUNCARGS_KEYWDS
     static char *kwlist[] = {"coord", NULL};
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &coord))
         return NULL;
-    return swh_geoc2d(coord, &ret) ? PyErr_Format(pyswh_Error,
+    return swh_geoc2d(coord, &ret) ? PyErr_Format(pyswh_error(self),
                 "swisseph.contrib.geoc2d: invalid coord string (%s)", coord)
         : Py_BuildValue("d", ret);
 }
@@ -4549,7 +11825,8 @@ static PyObject * pyswh_geolat2c FUNCARGS_KEYWDS
         return NULL;
     i = swh_geolat2c(lat, ret);
     if (i == -1) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.geolat2c: invalid latitude");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.geolat2c: invalid latitude");
         return NULL;
     }
     return Py_BuildValue("s", ret);
@@ -4571,7 +11848,8 @@ static PyObject * pyswh_geolon2c FUNCARGS_KEYWDS
         return NULL;
     i = swh_geolon2c(lon, ret);
     if (i == -1) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.geolon2c: invalid longitude");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.geolon2c: invalid longitude");
         return NULL;
     }
     return Py_BuildValue("s", ret);
@@ -4591,7 +11869,8 @@ static PyObject * pyswh_get_nakshatra_name FUNCARGS_KEYWDS
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", kwlist, &nak))
         return NULL;
     if (swh_get_nakshatra_name(nak, ret) == -1) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.get_nakshatra_name: invalid nakshatra number");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.get_nakshatra_name: invalid nakshatra number");
         return NULL;
     }
     return Py_BuildValue("s", ret);
@@ -4612,7 +11891,7 @@ static PyObject * pyswh_house_system_name FUNCARGS_KEYWDS
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &hsys))
         return NULL;
     if (strlen(hsys) != 1 || swh_house_system_name(*hsys, str)) {
-        PyErr_SetString(pyswe_Error,
+        PyErr_SetString(pyswh_get_state(self)->error,
             "swisseph.contrib.house_system_name: invalid house system identifier");
         return NULL;
     }
@@ -4634,7 +11913,8 @@ static PyObject * pyswh_jd2isostr FUNCARGS_KEYWDS
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|i", kwlist, &jd, &cal))
         return NULL;
     if (swh_jd2isostr(jd, cal, ret)) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.jd2isostr: error");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.jd2isostr: error");
         return NULL;
     }
     return Py_BuildValue("s", ret);
@@ -4748,7 +12028,8 @@ static PyObject * pyswh_lord FUNCARGS_KEYWDS
         return NULL;
     i = swh_lord(sign);
     if (i == -1) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.lord: invalid sign number");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.lord: invalid sign number");
         return NULL;
     }
     return Py_BuildValue("i", i);
@@ -4858,7 +12139,8 @@ static PyObject * pyswh_naisargika_relation FUNCARGS_KEYWDS
         return NULL;
     i = swh_naisargika_relation(gr1, gr2, &ret);
     if (i == -1) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.naisargika_relation: invalid planet");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.naisargika_relation: invalid planet");
         return NULL;
     }
     return Py_BuildValue("i", ret);
@@ -4889,7 +12171,7 @@ static PyObject * pyswh_next_aspect FUNCARGS_KEYWDS
         &jdret, posret, err);
     switch (i) {
     case 1: /* internal error */
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     case 2: /* time limit reached */
         return Py_BuildValue("O(OOOOOO)", Py_None, Py_None, Py_None, Py_None,
@@ -4921,7 +12203,7 @@ static PyObject * pyswh_next_aspect2 FUNCARGS_KEYWDS
         &jdret, posret, err);
     switch (res) {
     case 1: /* internal error */
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     case 2: /* time limit reached */
         return Py_BuildValue("O(OOOOOO)", Py_None, Py_None, Py_None, Py_None,
@@ -4967,14 +12249,14 @@ static PyObject * pyswh_next_aspect_cusp FUNCARGS_KEYWDS
         star = PyString_AsString(body);
 #endif
     else {
-        PyErr_SetString(pyswe_Error,
+        PyErr_SetString(pyswh_get_state(self)->error,
             "swisseph.contrib.next_aspect_cusp: invalid body type");
         return NULL;
     }
     res = swh_next_aspect_cusp(plnt, star, asp, cusp, jd, lat, lon, hsys,
         backw, flag, &jdret, posret, cusps, ascmc, err);
     if (res == 1) {
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     }
     assert(!res);
@@ -5028,14 +12310,14 @@ static PyObject * pyswh_next_aspect_cusp2 FUNCARGS_KEYWDS
         star = PyString_AsString(body);
 #endif
     else {
-        PyErr_SetString(pyswe_Error,
+        PyErr_SetString(pyswh_get_state(self)->error,
             "swisseph.contrib.next_aspect_cusp2: invalid body type");
         return NULL;
     }
     res = swh_next_aspect_cusp2(plnt, star, asp, cusp, jd, lat, lon, hsys,
         backw, flag, &jdret, posret, cusps, ascmc, err);
     if (res == 1) {
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     }
     assert(!res);
@@ -5092,7 +12374,7 @@ static PyObject * pyswh_next_aspect_with FUNCARGS_KEYWDS
         star = PyString_AsString(body);
 #endif
     else {
-        PyErr_SetString(pyswe_Error,
+        PyErr_SetString(pyswh_get_state(self)->error,
             "swisseph.contrib.next_aspect_with: invalid body type");
         return NULL;
     }
@@ -5100,7 +12382,7 @@ static PyObject * pyswh_next_aspect_with FUNCARGS_KEYWDS
         flag, &jdret, posret0, posret1, err);
     switch (res) {
     case 1: /* internal error */
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     case 2: /* time limit reached */
         return Py_BuildValue("O(OOOOOO)(OOOOOO)", Py_None, Py_None, Py_None,
@@ -5143,7 +12425,7 @@ static PyObject * pyswh_next_aspect_with2 FUNCARGS_KEYWDS
         star = PyString_AsString(body);
 #endif
     else {
-        PyErr_SetString(pyswe_Error,
+        PyErr_SetString(pyswh_get_state(self)->error,
             "swisseph.contrib.next_aspect_with2: invalid body type");
         return NULL;
     }
@@ -5151,7 +12433,7 @@ static PyObject * pyswh_next_aspect_with2 FUNCARGS_KEYWDS
         flag, &jdret, posret0, posret1, err);
     switch (res) {
     case 1: /* internal error */
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     case 2: /* time limit reached */
         return Py_BuildValue("O(OOOOOO)(OOOOOO)", Py_None, Py_None, Py_None,
@@ -5187,7 +12469,7 @@ static PyObject * pyswh_next_retro FUNCARGS_KEYWDS
     switch (res) {
     case 1: /* internal error */
     case 3: /* bad argument */
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     case 2: /* time limit reached */
         return Py_BuildValue("O(OOOOOO)", Py_None, Py_None, Py_None, Py_None,
@@ -5213,7 +12495,8 @@ static PyObject * pyswh_ochchabala FUNCARGS_KEYWDS
         return NULL;
     d = swh_ochchabala(pl, lon);
     if (d == -1) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.ochchabala: invalid planet");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.ochchabala: invalid planet");
         return NULL;
     }
     return Py_BuildValue("d", d);
@@ -5298,7 +12581,8 @@ static PyObject * pyswh_residential_strength FUNCARGS_KEYWDS
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO", kwlist, &plon, &seq))
         return NULL;
     if ((PySequence_Check(seq) != 1) || (PySequence_Length(seq) < 12)) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.residential_strength: invalid bhavas");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.residential_strength: invalid bhavas");
         return NULL;
     }
     for (i = 0; i < 12; ++i) { /* check sequence has 12 numbers */
@@ -5312,13 +12596,15 @@ static PyObject * pyswh_residential_strength FUNCARGS_KEYWDS
             bh[i] = PyInt_AS_LONG(p);
 #endif
         else {
-            PyErr_SetString(pyswe_Error, "swisseph.contrib.residential_strength: invalid bhavas type");
+            PyErr_SetString(pyswh_get_state(self)->error,
+                            "swisseph.contrib.residential_strength: invalid bhavas type");
             return NULL;
         }
     }
     i = swh_residential_strength(plon, bh, &ret);
     if (i == -1) { /* should not happen... */
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.residential_strength: invalid error");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.residential_strength: invalid error");
         return NULL;
     }
     return Py_BuildValue("d", ret);
@@ -5358,7 +12644,7 @@ static PyObject * pyswh_saturn_4_stars FUNCARGS_KEYWDS
         return NULL;
     res = swh_saturn_4_stars(jd, flag, ret, err);
     if (res < 0) {
-        PyErr_SetString(pyswe_Error, err);
+        PyErr_SetString(pyswh_get_state(self)->error, err);
         return NULL;
     }
     return Py_BuildValue("(dddddd)", ret[0],ret[1],ret[2],ret[3],ret[4],ret[5]);
@@ -5379,7 +12665,8 @@ static PyObject * pyswh_signtostr FUNCARGS_KEYWDS
         return NULL;
     res = swh_signtostr(sign, str);
     if (res < 0) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.signtostr: invalid sign number");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.signtostr: invalid sign number");
         return NULL;
     }
     return Py_BuildValue("s", str);
@@ -5406,7 +12693,8 @@ static PyObject * pyswh_t2i FUNCARGS_KEYWDS
         return NULL;
     x = swh_t2i(t, ret);
     if (x) {
-        PyErr_SetString(pyswe_Error, "swisseph.contrib.t2i: invalid string");
+        PyErr_SetString(pyswh_get_state(self)->error,
+                        "swisseph.contrib.t2i: invalid string");
         return NULL;
     }
     return Py_BuildValue("iii",ret[0],ret[1],ret[2]);
@@ -5470,62 +12758,665 @@ PyDoc_STRVAR(pyswh_tzabbr_list__doc__,
 "Args: -\n"
 "Return: list of (name, description, iso, hours, minutes)");
 
-static PyObject * pyswh_tzabbr_list FUNCARGS_SELF
+static PyObject * pyswh_tzabbr_list FUNCARGS_SELF
+{
+    size_t i = 0;
+    struct swh_tzabbr* p = (struct swh_tzabbr*) swh_tzabbrlist;
+    PyObject* lst = PyList_New(SWH_TZABBR_NUM);
+    if (!lst)
+        return PyErr_NoMemory();
+    for (; i < SWH_TZABBR_NUM; ++p) {
+        PyObject* tup = Py_BuildValue("(sssii)", p->name, p->desc, p->iso,
+                                      p->hours, p->minutes);
+        if (!tup) {
+            Py_DECREF(lst);
+            return PyErr_NoMemory();
+        }
+        PyList_SET_ITEM(lst, i++, tup);
+    }
+    return lst;
+}
+
+/* swisseph.contrib.years_diff */
+PyDoc_STRVAR(pyswh_years_diff__doc__,
+"Get number of 'astrological' years between two Julian days.\n\n"
+"Args: float jd1, float jd2, int flags=FLG_SWIEPH|FLG_SPEED|FLG_NOGDEFL\n"
+"Return: float");
+
+static PyObject * pyswh_years_diff FUNCARGS_KEYWDS
+{
+    double jd1, jd2, years = 0;
+    int flags = SEFLG_SWIEPH|SEFLG_SPEED|SEFLG_NOGDEFL, res;
+    char err[256];
+    static char *kwlist[] = {"jd1", "jd2", "flags", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
+        &jd1, &jd2, &flags))
+        return NULL;
+    res = swh_years_diff(jd1, jd2, flags, &years, err);
+    if (res) {
+        PyErr_SetString(pyswh_get_state(self)->error, err);
+        return NULL;
+    }
+    return Py_BuildValue("d", years);
+}
+
+#endif /* PYSWE_USE_SWEPHELP */
+
+/* swisseph._C_API
+ *
+ * Functions of the capsule (see pyswisseph.h). With libswe thread local
+ * storage, a thread that did not set anything with the module takes the
+ * settings of the thread that imported it (the main thread usually) before
+ * computing, not those of any other thread. Without it, the calls hold the
+ * GIL, as the functions of the module.
+ */
+#if PYSWE_SWE_TLS
+/* Settings applied in this thread, by the C API */
+static PYSWE_THREAD_LOCAL pyswe_Settings pyswe_capi_applied;
+
+static void pyswe_capi_sync(void)
+{
+    pyswe_Settings s;
+    /* the setters of this thread applied its settings */
+    if (pyswe_settings.gen)
+        return;
+    pyswe_lock(&pyswe_pool.lock);
+    if (pyswe_settings_main.gen == pyswe_capi_applied.gen) {
+        pyswe_unlock(&pyswe_pool.lock);
+        return;
+    }
+    s = pyswe_settings_main;
+    pyswe_unlock(&pyswe_pool.lock);
+    pyswe_settings_apply(&s, &pyswe_capi_applied);
+}
+
+#define PYSWE_CAPI_BEGIN    pyswe_capi_sync();
+#define PYSWE_CAPI_END
+#else
+#define PYSWE_CAPI_BEGIN    { PyGILState_STATE gil = PyGILState_Ensure();
+#define PYSWE_CAPI_END      PyGILState_Release(gil); }
+#endif
+
+static int pyswe_capi_calc(double tjd, int ipl, int iflag, double* xx,
+                           char* serr)
+{
+    int ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_calc(tjd, ipl, iflag, xx, serr);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static int pyswe_capi_calc_ut(double tjd, int ipl, int iflag, double* xx,
+                              char* serr)
+{
+    int ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_calc_ut(tjd, ipl, iflag, xx, serr);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static int pyswe_capi_fixstar2_ut(char* star, double tjd, int iflag,
+                                  double* xx, char* serr)
+{
+    int ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_fixstar2_ut(star, tjd, iflag, xx, serr);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static int pyswe_capi_houses_ex2(double tjd, int iflag, double geolat,
+                                 double geolon, int hsys, double* cusps,
+                                 double* ascmc, double* cusp_speed,
+                                 double* ascmc_speed, char* serr)
+{
+    int ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_houses_ex2(tjd, iflag, geolat, geolon, hsys, cusps, ascmc,
+                         cusp_speed, ascmc_speed, serr);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static int pyswe_capi_get_ayanamsa_ex_ut(double tjd, int iflag, double* daya,
+                                         char* serr)
+{
+    int ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_get_ayanamsa_ex_ut(tjd, iflag, daya, serr);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static double pyswe_capi_deltat_ex(double tjd, int iflag, char* serr)
+{
+    double ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_deltat_ex(tjd, iflag, serr);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static double pyswe_capi_sidtime(double tjd)
+{
+    double ret;
+    PYSWE_CAPI_BEGIN
+    ret = swe_sidtime(tjd);
+    PYSWE_CAPI_END
+    return ret;
+}
+
+static double pyswe_capi_julday(int year, int month, int day, double hour,
+                                int gregflag)
+{
+    return swe_julday(year, month, day, hour, gregflag);
+}
+
+static void pyswe_capi_revjul(double jd, int gregflag, int* year, int* month,
+                              int* day, double* hour)
+{
+    swe_revjul(jd, gregflag, year, month, day, hour);
+}
+
+static void pyswe_capi_set_ephe_path(const char* path)
+{
+    PYSWE_CAPI_BEGIN
+    pyswe_ephe_pending = 0;
+    swe_set_ephe_path(path);
+    pyswe_settings_path(path);
+    PYSWE_CAPI_END
+}
+
+static void pyswe_capi_set_sid_mode(int mode, double t0, double ayan_t0)
+{
+    PYSWE_CAPI_BEGIN
+    swe_set_sid_mode(mode, t0, ayan_t0);
+    pyswe_settings.sid_mode = mode;
+    pyswe_settings.sid_t0 = t0;
+    pyswe_settings.sid_ayan_t0 = ayan_t0;
+    pyswe_settings_touch();
+    PYSWE_CAPI_END
+}
+
+static void pyswe_capi_set_topo(double lon, double lat, double alt)
+{
+    double geopos[3];
+    geopos[0] = lon;
+    geopos[1] = lat;
+    geopos[2] = alt;
+    PYSWE_CAPI_BEGIN
+    pyswe_settings_topo(geopos);
+    PYSWE_CAPI_END
+}
+
+/* Shared by the users of the capsule, that must not write to it */
+static PySwe_CAPI pyswe_capi = {
+    PYSWE_CAPI_VERSION,
+    sizeof(PySwe_CAPI),
+    pyswe_capi_calc,
+    pyswe_capi_calc_ut,
+    pyswe_capi_fixstar2_ut,
+    pyswe_capi_houses_ex2,
+    pyswe_capi_get_ayanamsa_ex_ut,
+    pyswe_capi_deltat_ex,
+    pyswe_capi_sidtime,
+    pyswe_capi_julday,
+    pyswe_capi_revjul,
+    pyswe_capi_set_ephe_path,
+    pyswe_capi_set_sid_mode,
+    pyswe_capi_set_topo
+};
+
+/* swisseph.aio
+ *
+ * Awaitable variants of the slow searches. The functions return an asyncio
+ * future, and submit the search to the thread pool. The worker finishing it
+ * takes a thread state of the interpreter of the caller, builds the result,
+ * and hands it to the event loop with call_soon_threadsafe. When the search
+ * cannot run in a worker (no libswe thread local storage), it is done in the
+ * calling thread, and the future is returned completed.
+ */
+enum { PYSWE_AIO_HELIACAL_UT, PYSWE_AIO_SOL_ECLIPSE_WHEN_LOC,
+       PYSWE_AIO_LUN_OCCULT_WHEN_GLOB };
+
+static const char* pyswe_aio_names[] = {
+    "heliacal_ut", "sol_eclipse_when_loc", "lun_occult_when_glob"};
+
+typedef struct {
+    pyswe_Job job;
+    int kind;
+    PyInterpreterState* interp; /* of the caller */
+    PyObject* module; /* swisseph */
+    PyObject* loop;
+    PyObject* future;
+    double jd;
+    double geopos[3];
+    double atmo[4];
+    double observ[6];
+    char obj[(SE_MAX_STNAME*2)+1]; /* object or star name */
+    int pl;
+    int evnt;
+    int ecltype;
+    int backw;
+    int flag;
+    int ret;
+    double tret[50];
+    double attr[20];
+    char err[256];
+} pyswe_AioJob;
+
+static pyswe_AioJob * pyswe_aio_new(int kind)
+{
+    pyswe_AioJob* a = PyMem_RawCalloc(1, sizeof(pyswe_AioJob));
+    if (!a) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    a->kind = kind;
+    return a;
+}
+
+/* Release a search, with the GIL of its interpreter */
+static void pyswe_aio_free(pyswe_AioJob* a)
+{
+    Py_XDECREF(a->module);
+    Py_XDECREF(a->loop);
+    Py_XDECREF(a->future);
+    PyMem_RawFree(a);
+}
+
+static void pyswe_aio_run(pyswe_Job* job, Py_ssize_t start, Py_ssize_t end)
+{
+    pyswe_AioJob* a = (pyswe_AioJob*) job;
+    switch (a->kind) {
+    case PYSWE_AIO_HELIACAL_UT:
+        a->ret = swe_heliacal_ut(a->jd, a->geopos, a->atmo, a->observ, a->obj,
+                                 a->evnt, a->flag, a->tret, a->err);
+        break;
+    case PYSWE_AIO_SOL_ECLIPSE_WHEN_LOC:
+        a->ret = swe_sol_eclipse_when_loc(a->jd, a->flag, a->geopos, a->tret,
+                                          a->attr, a->backw, a->err);
+        break;
+    case PYSWE_AIO_LUN_OCCULT_WHEN_GLOB:
+        a->ret = swe_lun_occult_when_glob(a->jd, a->pl, a->obj, a->flag,
+                                          a->ecltype, a->tret, a->backw,
+                                          a->err);
+        break;
+    }
+}
+
+/* Build the result of a search, as the synchronous function
+ * *ok is set to 0 if the result is the swisseph.Error to raise.
+ */
+static PyObject * pyswe_aio_result(pyswe_AioJob* a, int* ok)
+{
+    *ok = 1;
+    switch (a->kind) {
+    case PYSWE_AIO_HELIACAL_UT:
+        if (a->ret == 0)
+            return Py_BuildValue("ddd", a->tret[0], a->tret[1], a->tret[2]);
+        break;
+    case PYSWE_AIO_SOL_ECLIPSE_WHEN_LOC:
+        if (a->ret >= 0)
+            return Py_BuildValue("iNN", a->ret, pyswe_dtuple(a->tret, 10),
+                                 pyswe_dtuple(a->attr, 20));
+        break;
+    case PYSWE_AIO_LUN_OCCULT_WHEN_GLOB:
+        if (a->ret >= 0)
+            return Py_BuildValue("iN", a->ret, pyswe_dtuple(a->tret, 10));
+        break;
+    }
+    *ok = 0;
+    return PyObject_CallFunction(pyswe_error(a->module), "N",
+                                 PyUnicode_FromFormat("swisseph.%s: %s",
+                                        pyswe_aio_names[a->kind], a->err));
+}
+
+/* Set the result (ok) or exception of a future, in the loop thread
+ * A future cancelled meanwhile is left alone.
+ */
+static PyObject * pyswe_aio_set_future(PyObject* self, PyObject* args)
+{
+    PyObject *fut, *value, *o;
+    int ok, done;
+    if (!PyArg_ParseTuple(args, "OiO", &fut, &ok, &value))
+        return NULL;
+    if (!(o = PyObject_CallMethod(fut, "done", NULL)))
+        return NULL;
+    done = PyObject_IsTrue(o);
+    Py_DECREF(o);
+    if (done < 0)
+        return NULL;
+    if (done)
+        Py_RETURN_NONE;
+    return PyObject_CallMethod(fut, ok ? "set_result" : "set_exception",
+                               "(O)", value);
+}
+
+static PyMethodDef pyswe_aio_set_future_def = {
+    "_set_future", (PyCFunction) pyswe_aio_set_future, METH_VARARGS, NULL};
+
+/* Wait for the searches submitted, registered with atexit */
+static PyObject * pyswe_aio_wait(PyObject* self, PyObject* unused)
+{
+    Py_BEGIN_ALLOW_THREADS
+    pyswe_lock(&pyswe_pool.lock);
+    while (pyswe_pool.pending)
+        pyswe_cond_wait(&pyswe_pool.done, &pyswe_pool.lock);
+    pyswe_unlock(&pyswe_pool.lock);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef pyswe_aio_wait_def = {
+    "_wait", (PyCFunction) pyswe_aio_wait, METH_NOARGS, NULL};
+
+/* Complete the future of a search, called by the worker without the GIL */
+static void pyswe_aio_complete(pyswe_Job* job)
+{
+    pyswe_AioJob* a = (pyswe_AioJob*) job;
+    PyThreadState* ts = PyThreadState_New(a->interp);
+    PyObject *res, *o;
+    int ok;
+    PyEval_RestoreThread(ts);
+    if ((res = pyswe_aio_result(a, &ok))) {
+        o = PyObject_CallMethod(a->loop, "call_soon_threadsafe", "OOiO",
+                                pyswe_get_state(a->module)->aio_set_future,
+                                a->future, ok, res);
+        Py_XDECREF(o);
+        Py_DECREF(res);
+    }
+    /* the loop may be closed, nobody waits for the future then */
+    PyErr_Clear();
+    pyswe_aio_free(a);
+    PyThreadState_Clear(ts);
+    PyEval_ReleaseThread(ts);
+    PyThreadState_Delete(ts);
+    pyswe_pool_completed();
+}
+
+/* Import asyncio on first use
+ * Return -1 on error, with an exception set
+ */
+static int pyswe_aio_init(pyswe_State* st)
+{
+    PyObject *mod, *o;
+    if (st->aio_get_loop)
+        return 0;
+    if (!st->aio_set_future
+        && !(st->aio_set_future = PyCFunction_New(&pyswe_aio_set_future_def,
+                                                  NULL)))
+        return -1;
+    /* pending searches complete before the interpreter is finalized */
+    if (!(mod = PyImport_ImportModule("atexit")))
+        return -1;
+    o = PyCFunction_New(&pyswe_aio_wait_def, NULL);
+    if (o) {
+        Py_SETREF(o, PyObject_CallMethod(mod, "register", "(O)", o));
+    }
+    Py_DECREF(mod);
+    if (!o)
+        return -1;
+    Py_DECREF(o);
+    if (!(mod = PyImport_ImportModule("asyncio")))
+        return -1;
+    st->aio_get_loop = PyObject_GetAttrString(mod, "get_running_loop");
+    Py_DECREF(mod);
+    return st->aio_get_loop ? 0 : -1;
+}
+
+/* Submit a search, return its future
+ * The search is released on error.
+ */
+static PyObject * pyswe_aio_submit(PyObject* m, pyswe_AioJob* a)
+{
+    pyswe_State* st = pyswe_get_state(m);
+    PyObject *fut = NULL, *res, *o;
+    int ok;
+    Py_INCREF(m);
+    a->module = m;
+    if (pyswe_aio_init(st)
+        || !(a->loop = PyObject_CallObject(st->aio_get_loop, NULL))
+        || !(a->future = PyObject_CallMethod(a->loop, "create_future", NULL)))
+        goto end;
+    fut = a->future;
+    Py_INCREF(fut);
+#if PY_VERSION_HEX >= 0x03090000
+    a->interp = PyInterpreterState_Get();
+#else
+    a->interp = PyThreadState_Get()->interp;
+#endif
+    a->job.func = pyswe_aio_run;
+    a->job.complete = pyswe_aio_complete;
+    a->job.n = 1;
+    if (!pyswe_pool_submit(&a->job))
+        return fut;
+    /* no worker, run the search here */
+    pyswe_aio_run(&a->job, 0, 1);
+    if (!(res = pyswe_aio_result(a, &ok)))
+        Py_CLEAR(fut);
+    else {
+        o = PyObject_CallFunction(st->aio_set_future, "OiO", fut, ok, res);
+        Py_DECREF(res);
+        if (!o)
+            Py_CLEAR(fut);
+        Py_XDECREF(o);
+    }
+end:
+    pyswe_aio_free(a);
+    return fut;
+}
+
+/* swisseph.aio.heliacal_ut */
+PyDoc_STRVAR(pyswe_aio_heliacal_ut__doc__,
+"Find the Julian day of the next heliacal phenomenon (awaitable).\n\n"
+":Args: float tjdut, seq geopos, seq atmo, seq observer, str objname,"
+" int eventtype, int flags\n\n"
+":Return: asyncio.Future of (dret)\n\n"
+"Same as swisseph.heliacal_ut, computed by the thread pool, while the event"
+" loop keeps running. Must be called from a coroutine. The future raises"
+" swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_aio_heliacal_ut FUNCARGS_KEYWDS
+{
+    pyswe_AioJob* a;
+    char *obj, err[128] = {0};
+    int i;
+    PyObject *o1, *o2, *o3;
+    static char *kwlist[] = {"tjdut", "geopos", "atmo", "observer", "objname",
+                             "eventtype", "flags", NULL};
+    if (!(a = pyswe_aio_new(PYSWE_AIO_HELIACAL_UT)))
+        return NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOOOsii", kwlist, &a->jd,
+                                     &o1, &o2, &o3, &obj, &a->evnt, &a->flag))
+        goto error;
+    /* extract geopos */
+    i = py_seq2d(o1, 3, a->geopos, err);
+    if (i > 0) {
+        if (i < 4)
+            PyErr_Format(PyExc_TypeError, "swisseph.heliacal_ut: geopos: %s",
+                         err);
+        goto error;
+    }
+    /* extract atmospheric */
+    i = py_seq2d(o2, 4, a->atmo, err);
+    if (i > 0) {
+        if (i < 4)
+            PyErr_Format(PyExc_TypeError, "swisseph.heliacal_ut: atmo: %s",
+                         err);
+        goto error;
+    }
+    /* extract observer */
+    i = py_seq2d(o3, 6, a->observ, err);
+    if (i > 0) {
+        if (i < 4)
+            PyErr_Format(PyExc_TypeError,
+                         "swisseph.heliacal_ut: observer: %s", err);
+        goto error;
+    }
+    strncpy(a->obj, obj, SE_MAX_STNAME*2);
+    /* set topo params */
+    if (a->flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(a->geopos);
+    return pyswe_aio_submit(self, a);
+error:
+    PyMem_RawFree(a);
+    return NULL;
+}
+
+/* swisseph.aio.lun_occult_when_glob */
+PyDoc_STRVAR(pyswe_aio_lun_occult_when_glob__doc__,
+"Find the next occultation of a planet or star by the moon globally"
+" (awaitable).\n\n"
+":Args: float tjdut, int or str body, int flags=FLG_SWIEPH, int ecltype=0,"
+" bool backwards=False\n\n"
+":Return: asyncio.Future of int retflags, (tret)\n\n"
+"Same as swisseph.lun_occult_when_glob, computed by the thread pool, while"
+" the event loop keeps running. Must be called from a coroutine. The future"
+" raises swisseph.Error in case of fatal error.");
+
+static PyObject * pyswe_aio_lun_occult_when_glob FUNCARGS_KEYWDS
 {
-    size_t i = 0;
-    struct swh_tzabbr* p = (struct swh_tzabbr*) swh_tzabbrlist;
-    PyObject* lst = PyList_New(SWH_TZABBR_NUM);
-    if (!lst)
-        return PyErr_NoMemory();
-    for (; i < SWH_TZABBR_NUM; ++p) {
-        PyObject* tup = Py_BuildValue("(sssii)", p->name, p->desc, p->iso,
-                                      p->hours, p->minutes);
-        if (!tup) {
-            Py_DECREF(lst);
-            return PyErr_NoMemory();
-        }
-        PyList_SET_ITEM(lst, i++, tup);
+    pyswe_AioJob* a;
+    char *star;
+    PyObject *body;
+    static char *kwlist[] = {"tjdut", "body", "flags", "ecltype",
+                             "backwards", NULL};
+    if (!(a = pyswe_aio_new(PYSWE_AIO_LUN_OCCULT_WHEN_GLOB)))
+        return NULL;
+    a->flag = SEFLG_SWIEPH;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|iii", kwlist, &a->jd,
+                                     &body, &a->flag, &a->ecltype, &a->backw))
+        goto error;
+    /* extract pl/star */
+    if (py_obj2plstar(body, &a->pl, &star) > 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "swisseph.lun_occult_when_glob: invalid body type");
+        goto error;
     }
-    return lst;
-}
-
-/* swisseph.contrib.years_diff */
-PyDoc_STRVAR(pyswh_years_diff__doc__,
-"Get number of 'astrological' years between two Julian days.\n\n"
-"Args: float jd1, float jd2, int flags=FLG_SWIEPH|FLG_SPEED|FLG_NOGDEFL\n"
-"Return: float");
+    if (star)
+        strncpy(a->obj, star, SE_MAX_STNAME*2);
+    return pyswe_aio_submit(self, a);
+error:
+    PyMem_RawFree(a);
+    return NULL;
+}
+
+/* swisseph.aio.sol_eclipse_when_loc */
+PyDoc_STRVAR(pyswe_aio_sol_eclipse_when_loc__doc__,
+"Find the next solar eclipse for a given geographic position"
+" (awaitable).\n\n"
+":Args: float tjdut, seq geopos, int flags=FLG_SWIEPH, bool backwards=False\n\n"
+":Return: asyncio.Future of int retflags, (tret), (attr)\n\n"
+"Same as swisseph.sol_eclipse_when_loc, computed by the thread pool, while"
+" the event loop keeps running. Must be called from a coroutine. The future"
+" raises swisseph.Error in case of fatal error.");
 
-static PyObject * pyswh_years_diff FUNCARGS_KEYWDS
+static PyObject * pyswe_aio_sol_eclipse_when_loc FUNCARGS_KEYWDS
 {
-    double jd1, jd2, years = 0;
-    int flags = SEFLG_SWIEPH|SEFLG_SPEED|SEFLG_NOGDEFL, res;
-    char err[256];
-    static char *kwlist[] = {"jd1", "jd2", "flags", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dd|i", kwlist,
-        &jd1, &jd2, &flags))
-        return NULL;
-    res = swh_years_diff(jd1, jd2, flags, &years, err);
-    if (res) {
-        PyErr_SetString(pyswe_Error, err);
+    pyswe_AioJob* a;
+    char err[128] = {0};
+    int i;
+    PyObject *gp;
+    static char *kwlist[] = {"tjdut", "geopos", "flags", "backwards", NULL};
+    if (!(a = pyswe_aio_new(PYSWE_AIO_SOL_ECLIPSE_WHEN_LOC)))
         return NULL;
+    a->flag = SEFLG_SWIEPH;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dO|ii", kwlist, &a->jd, &gp,
+                                     &a->flag, &a->backw))
+        goto error;
+    /* extract geopos */
+    i = py_seq2d(gp, 3, a->geopos, err);
+    if (i > 0) {
+        if (i < 4)
+            PyErr_Format(PyExc_TypeError,
+                         "swisseph.sol_eclipse_when_loc: geopos: %s", err);
+        goto error;
     }
-    return Py_BuildValue("d", years);
+    /* set topo params */
+    if (a->flag & SEFLG_TOPOCTR)
+        pyswe_settings_topo(a->geopos);
+    return pyswe_aio_submit(self, a);
+error:
+    PyMem_RawFree(a);
+    return NULL;
+}
+
+/* Functions of swisseph.aio, bound to swisseph */
+static struct PyMethodDef pyswe_aio_methods[] = {
+    {"heliacal_ut", (PyCFunction) pyswe_aio_heliacal_ut,
+        METH_VARARGS|METH_KEYWORDS, pyswe_aio_heliacal_ut__doc__},
+    {"lun_occult_when_glob", (PyCFunction) pyswe_aio_lun_occult_when_glob,
+        METH_VARARGS|METH_KEYWORDS, pyswe_aio_lun_occult_when_glob__doc__},
+    {"sol_eclipse_when_loc", (PyCFunction) pyswe_aio_sol_eclipse_when_loc,
+        METH_VARARGS|METH_KEYWORDS, pyswe_aio_sol_eclipse_when_loc__doc__},
+    {NULL, NULL, 0, NULL}
+};
+
+PyDoc_STRVAR(pyswe_aio_documentation,
+"Awaitable variants of the slow searches of swisseph.\n\n"
+"The searches are computed by the thread pool of the batch functions (see"
+" swisseph.set_num_threads), without blocking the event loop.");
+
+/* Create swisseph.aio
+ * Return -1 on error, with an exception set
+ */
+static int pyswe_aio_create(PyObject* m)
+{
+    PyObject *aio, *name, *f, *doc;
+    PyMethodDef* def;
+    if (!(aio = PyModule_New("swisseph.aio")))
+        return -1;
+    if (!(doc = PyUnicode_FromString(pyswe_aio_documentation))
+        || PyModule_AddObject(aio, "__doc__", doc) < 0) {
+        Py_XDECREF(doc);
+        Py_DECREF(aio);
+        return -1;
+    }
+    name = PyModule_GetNameObject(aio);
+    for (def = pyswe_aio_methods; name && def->ml_name; ++def) {
+        f = PyCFunction_NewEx(def, m, name);
+        if (!f || PyModule_AddObject(aio, def->ml_name, f) < 0) {
+            Py_XDECREF(f);
+            Py_CLEAR(name);
+        }
+    }
+    if (!name || PyModule_AddObject(m, "aio", aio) < 0) {
+        Py_XDECREF(name);
+        Py_DECREF(aio);
+        return -1;
+    }
+    Py_DECREF(name);
+    return 0;
 }
 
-#endif /* PYSWE_USE_SWEPHELP */
+#if PYSWE_LAZY_ATTRS
+static PyObject * pyswe___getattr__(PyObject* self, PyObject* name);
+static PyObject * pyswe___dir__ FUNCARGS_SELF;
+#endif
 
 /* Methods */
 static struct PyMethodDef pyswe_methods[] = {
+#if PYSWE_LAZY_ATTRS
+    {"__dir__", (PyCFunction) pyswe___dir__, METH_NOARGS, NULL},
+    {"__getattr__", (PyCFunction) pyswe___getattr__, METH_O, NULL},
+#endif
     {"azalt", (PyCFunction) pyswe_azalt,
         METH_VARARGS|METH_KEYWORDS, pyswe_azalt__doc__},
     {"azalt_rev", (PyCFunction) pyswe_azalt_rev,
         METH_VARARGS|METH_KEYWORDS, pyswe_azalt_rev__doc__},
-    {"calc", (PyCFunction) pyswe_calc,
-        METH_VARARGS|METH_KEYWORDS, pyswe_calc__doc__},
-    {"calc_pctr", (PyCFunction) pyswe_calc_pctr,
-        METH_VARARGS|METH_KEYWORDS, pyswe_calc_pctr__doc__},
-    {"calc_ut", (PyCFunction) pyswe_calc_ut,
-        METH_VARARGS|METH_KEYWORDS, pyswe_calc_ut__doc__},
+    {"batch", (PyCFunction) pyswe_batch,
+        METH_VARARGS|METH_KEYWORDS, pyswe_batch__doc__},
+    {"calc", PYSWE_FAST(pyswe_calc),
+        PYSWE_METH_FAST, pyswe_calc__doc__},
+    {"calc_pctr", PYSWE_FAST(pyswe_calc_pctr),
+        PYSWE_METH_FAST, pyswe_calc_pctr__doc__},
+    {"calc_ut", PYSWE_FAST(pyswe_calc_ut),
+        PYSWE_METH_FAST, pyswe_calc_ut__doc__},
+    {"calc_ut_array", (PyCFunction) pyswe_calc_ut_array,
+        METH_VARARGS|METH_KEYWORDS, pyswe_calc_ut_array__doc__},
     {"close", (PyCFunction) pyswe_close,
         METH_NOARGS, pyswe_close__doc__},
     {"cotrans", (PyCFunction) pyswe_cotrans,
@@ -5550,8 +13441,8 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_day_of_week__doc__},
     {"deg_midp", (PyCFunction) pyswe_deg_midp,
         METH_VARARGS|METH_KEYWORDS, pyswe_deg_midp__doc__},
-    {"degnorm", (PyCFunction) pyswe_degnorm,
-        METH_VARARGS|METH_KEYWORDS, pyswe_degnorm__doc__},
+    {"degnorm", PYSWE_FAST(pyswe_degnorm),
+        PYSWE_METH_FAST, pyswe_degnorm__doc__},
     {"deltat", (PyCFunction) pyswe_deltat,
         METH_VARARGS|METH_KEYWORDS, pyswe_deltat__doc__},
     {"deltat_ex", (PyCFunction) pyswe_deltat_ex,
@@ -5560,12 +13451,16 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_difcs2n__doc__},
     {"difcsn", (PyCFunction) pyswe_difcsn,
         METH_VARARGS|METH_KEYWORDS, pyswe_difcsn__doc__},
-    {"difdeg2n", (PyCFunction) pyswe_difdeg2n,
-        METH_VARARGS|METH_KEYWORDS, pyswe_difdeg2n__doc__},
-    {"difdegn", (PyCFunction) pyswe_difdegn,
-        METH_VARARGS|METH_KEYWORDS, pyswe_difdegn__doc__},
+    {"difdeg2n", PYSWE_FAST(pyswe_difdeg2n),
+        PYSWE_METH_FAST, pyswe_difdeg2n__doc__},
+    {"difdegn", PYSWE_FAST(pyswe_difdegn),
+        PYSWE_METH_FAST, pyswe_difdegn__doc__},
     {"difrad2n", (PyCFunction) pyswe_difrad2n,
         METH_VARARGS|METH_KEYWORDS, pyswe_difrad2n__doc__},
+    {"ephemeris_table", (PyCFunction) pyswe_ephemeris_table,
+        METH_VARARGS|METH_KEYWORDS, pyswe_ephemeris_table__doc__},
+    {"export_compact", (PyCFunction) pyswe_export_compact,
+        METH_VARARGS|METH_KEYWORDS, pyswe_export_compact__doc__},
     {"fixstar", (PyCFunction) pyswe_fixstar,
         METH_VARARGS|METH_KEYWORDS, pyswe_fixstar__doc__},
     {"fixstar2", (PyCFunction) pyswe_fixstar2,
@@ -5594,6 +13489,8 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_get_current_file_data__doc__},
     {"get_library_path", (PyCFunction) pyswe_get_library_path,
         METH_NOARGS, pyswe_get_library_path__doc__},
+    {"get_num_threads", (PyCFunction) pyswe_get_num_threads,
+        METH_NOARGS, pyswe_get_num_threads__doc__},
     {"get_orbital_elements", (PyCFunction) pyswe_get_orbital_elements,
         METH_VARARGS|METH_KEYWORDS, pyswe_get_orbital_elements__doc__},
     {"get_planet_name", (PyCFunction) pyswe_get_planet_name,
@@ -5612,22 +13509,28 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_house_name__doc__},
     {"house_pos", (PyCFunction) pyswe_house_pos,
         METH_VARARGS|METH_KEYWORDS, pyswe_house_pos__doc__},
-    {"houses", (PyCFunction) pyswe_houses,
-        METH_VARARGS|METH_KEYWORDS, pyswe_houses__doc__},
-    {"houses_armc", (PyCFunction) pyswe_houses_armc,
-        METH_VARARGS|METH_KEYWORDS, pyswe_houses_armc__doc__},
-    {"houses_armc_ex2", (PyCFunction) pyswe_houses_armc_ex2,
-        METH_VARARGS|METH_KEYWORDS, pyswe_houses_armc_ex2__doc__},
-    {"houses_ex", (PyCFunction) pyswe_houses_ex,
-        METH_VARARGS|METH_KEYWORDS, pyswe_houses_ex__doc__},
-    {"houses_ex2", (PyCFunction) pyswe_houses_ex2,
-        METH_VARARGS|METH_KEYWORDS, pyswe_houses_ex2__doc__},
+    {"houses", PYSWE_FAST(pyswe_houses),
+        PYSWE_METH_FAST, pyswe_houses__doc__},
+    {"houses_armc", PYSWE_FAST(pyswe_houses_armc),
+        PYSWE_METH_FAST, pyswe_houses_armc__doc__},
+    {"houses_armc_ex2", PYSWE_FAST(pyswe_houses_armc_ex2),
+        PYSWE_METH_FAST, pyswe_houses_armc_ex2__doc__},
+    {"houses_array", (PyCFunction) pyswe_houses_array,
+        METH_VARARGS|METH_KEYWORDS, pyswe_houses_array__doc__},
+    {"houses_ex", PYSWE_FAST(pyswe_houses_ex),
+        PYSWE_METH_FAST, pyswe_houses_ex__doc__},
+    {"houses_ex2", PYSWE_FAST(pyswe_houses_ex2),
+        PYSWE_METH_FAST, pyswe_houses_ex2__doc__},
+    {"io_cache_stats", (PyCFunction) pyswe_io_cache_stats,
+        METH_VARARGS|METH_KEYWORDS, pyswe_io_cache_stats__doc__},
+    {"io_stats", (PyCFunction) pyswe_io_stats,
+        METH_VARARGS|METH_KEYWORDS, pyswe_io_stats__doc__},
     {"jdet_to_utc", (PyCFunction) pyswe_jdet_to_utc,
         METH_VARARGS|METH_KEYWORDS, pyswe_jdet_to_utc__doc__},
     {"jdut1_to_utc", (PyCFunction) pyswe_jdut1_to_utc,
         METH_VARARGS|METH_KEYWORDS, pyswe_jdut1_to_utc__doc__},
-    {"julday", (PyCFunction) pyswe_julday,
-        METH_VARARGS|METH_KEYWORDS, pyswe_julday__doc__},
+    {"julday", PYSWE_FAST(pyswe_julday),
+        PYSWE_METH_FAST, pyswe_julday__doc__},
     {"lat_to_lmt", (PyCFunction) pyswe_lat_to_lmt,
         METH_VARARGS|METH_KEYWORDS, pyswe_lat_to_lmt__doc__},
     {"lmt_to_lat", (PyCFunction) pyswe_lmt_to_lat,
@@ -5670,10 +13573,14 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_refrac__doc__},
     {"refrac_extended", (PyCFunction) pyswe_refrac_extended,
         METH_VARARGS|METH_KEYWORDS, pyswe_refrac_extended__doc__},
-    {"revjul", (PyCFunction) pyswe_revjul,
-        METH_VARARGS|METH_KEYWORDS, pyswe_revjul__doc__},
+    {"reset_stats", (PyCFunction) pyswe_reset_stats,
+        METH_NOARGS, pyswe_reset_stats__doc__},
+    {"revjul", PYSWE_FAST(pyswe_revjul),
+        PYSWE_METH_FAST, pyswe_revjul__doc__},
     {"rise_trans", (PyCFunction) pyswe_rise_trans,
         METH_VARARGS|METH_KEYWORDS, pyswe_rise_trans__doc__},
+    {"rise_trans_array", (PyCFunction) pyswe_rise_trans_array,
+        METH_VARARGS|METH_KEYWORDS, pyswe_rise_trans_array__doc__},
     {"rise_trans_true_hor", (PyCFunction) pyswe_rise_trans_true_hor,
         METH_VARARGS|METH_KEYWORDS, pyswe_rise_trans_true_hor__doc__},
     {"set_delta_t_userdef", (PyCFunction) pyswe_set_delta_t_userdef,
@@ -5684,8 +13591,14 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_set_jpl_file__doc__},
     {"set_lapse_rate", (PyCFunction) pyswe_set_lapse_rate,
         METH_VARARGS|METH_KEYWORDS, pyswe_set_lapse_rate__doc__},
+    {"set_num_threads", (PyCFunction) pyswe_set_num_threads,
+        METH_VARARGS|METH_KEYWORDS, pyswe_set_num_threads__doc__},
     {"set_sid_mode", (PyCFunction) pyswe_set_sid_mode,
         METH_VARARGS|METH_KEYWORDS, pyswe_set_sid_mode__doc__},
+    {"set_slow_call_hook", (PyCFunction) pyswe_set_slow_call_hook,
+        METH_VARARGS|METH_KEYWORDS, pyswe_set_slow_call_hook__doc__},
+    {"set_stats", (PyCFunction) pyswe_set_stats,
+        METH_VARARGS|METH_KEYWORDS, pyswe_set_stats__doc__},
     {"set_tid_acc", (PyCFunction) pyswe_set_tid_acc,
         METH_VARARGS|METH_KEYWORDS, pyswe_set_tid_acc__doc__},
     {"set_topo", (PyCFunction) pyswe_set_topo,
@@ -5708,6 +13621,8 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_solcross_ut__doc__},
     {"split_deg", (PyCFunction) pyswe_split_deg,
         METH_VARARGS|METH_KEYWORDS, pyswe_split_deg__doc__},
+    {"stats", (PyCFunction) pyswe_stats,
+        METH_NOARGS, pyswe_stats__doc__},
     {"time_equ", (PyCFunction) pyswe_time_equ,
         METH_VARARGS|METH_KEYWORDS, pyswe_time_equ__doc__},
     {"utc_time_zone", (PyCFunction) pyswe_utc_time_zone,
@@ -5716,6 +13631,8 @@ static struct PyMethodDef pyswe_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswe_utc_to_jd__doc__},
     {"vis_limit_mag", (PyCFunction) pyswe_vis_limit_mag,
         METH_VARARGS|METH_KEYWORDS, pyswe_vis_limit_mag__doc__},
+    {"write_ephemeris_table", (PyCFunction) pyswe_write_ephemeris_table,
+        METH_VARARGS|METH_KEYWORDS, pyswe_write_ephemeris_table__doc__},
     {NULL, (PyCFunction) NULL, 0, NULL}
 };
 
@@ -5728,8 +13645,16 @@ static struct PyMethodDef pyswh_methods[] = {
         METH_VARARGS|METH_KEYWORDS, pyswh_atlas_connect__doc__},
     {"atlas_countries_list", (PyCFunction) pyswh_atlas_countries_list,
         METH_NOARGS, pyswh_atlas_countries_list__doc__},
+    {"atlas_index", (PyCFunction) pyswh_atlas_index,
+        METH_VARARGS|METH_KEYWORDS, pyswh_atlas_index__doc__},
+    {"atlas_nearest", (PyCFunction) pyswh_atlas_nearest,
+        METH_VARARGS|METH_KEYWORDS, pyswh_atlas_nearest__doc__},
+    {"atlas_nearest_many", (PyCFunction) pyswh_atlas_nearest_many,
+        METH_VARARGS|METH_KEYWORDS, pyswh_atlas_nearest_many__doc__},
     {"atlas_search", (PyCFunction) pyswh_atlas_search,
         METH_VARARGS|METH_KEYWORDS, pyswh_atlas_search__doc__},
+    {"atlas_search_many", (PyCFunction) pyswh_atlas_search_many,
+        METH_VARARGS|METH_KEYWORDS, pyswh_atlas_search_many__doc__},
     {"antiscion", (PyCFunction) pyswh_antiscion,
         METH_VARARGS|METH_KEYWORDS, pyswh_antiscion__doc__},
     {"calc_ut", (PyCFunction) pyswh_calc_ut,
@@ -5829,24 +13754,38 @@ PyDoc_STRVAR(pyswh_module_documentation,
 "\tfrom swisseph import contrib as swh\n"
 "\t...");
 
-#if PY_MAJOR_VERSION >= 3
+static int pyswh_traverse(PyObject* m, visitproc visit, void* arg)
+{
+    Py_VISIT(((pyswh_State*) PyModule_GetState(m))->parent);
+    return 0;
+}
+
+static int pyswh_clear(PyObject* m)
+{
+    Py_CLEAR(((pyswh_State*) PyModule_GetState(m))->parent);
+    return 0;
+}
+
+/* Created by the exec function of swisseph, not imported */
 struct PyModuleDef pyswh_module =
 {
     PyModuleDef_HEAD_INIT,
     "swisseph.contrib", /* module name */
     pyswh_module_documentation, /* module docstring */
-    -1, /* size of per-interpreter state of the module,
-        or -1 if the module keeps state in global variables. */
-    pyswh_methods
+    sizeof(pyswh_State), /* size of per-interpreter state of the module */
+    pyswh_methods,
+    NULL, /* slots */
+    pyswh_traverse,
+    pyswh_clear,
+    NULL /* free */
 };
-#endif
 #endif /* PYSWE_USE_SWEPHELP */
 
 #if PYSWE_AUTO_SET_EPHE_PATH
 PyDoc_STRVAR(pyswe_module_documentation,
 "Python extension to AstroDienst Swiss Ephemeris library.\n\n"
 "Import of this extension module does automagicaly set the ephemeris path"
-" to \"" PYSWE_DEFAULT_EPHE_PATH "\".\n\n"
+" to \"" PYSWE_DEFAULT_EPHE_PATH "\", before the first calculation.\n\n"
 "    Pyswisseph homepage: https://astrorigin.com/pyswisseph/\n"
 "    AstroDienst: https://www.astro.com/swisseph/\n"
 "    PyPI: https://pypi.org/project/pyswisseph/");
@@ -5858,440 +13797,536 @@ PyDoc_STRVAR(pyswe_module_documentation,
 "    PyPI: https://pypi.org/project/pyswisseph/");
 #endif
 
-#if PY_MAJOR_VERSION >= 3
-struct PyModuleDef pyswe_module =
-{
-    PyModuleDef_HEAD_INIT,
-    "swisseph", /* module name */
-    pyswe_module_documentation, /* module docstring */
-    -1, /* size of per-interpreter state of the module,
-        or -1 if the module keeps state in global variables. */
-    pyswe_methods
-};
-
-PyMODINIT_FUNC PyInit_swisseph(void)
-#elif PY_MAJOR_VERSION < 3
-PyMODINIT_FUNC initswisseph(void)
-#endif
-{
-    PyObject *m;
+static int pyswe_traverse(PyObject* m, visitproc visit, void* arg)
+{
+    pyswe_State* st = pyswe_get_state(m);
+    Py_VISIT(st->error);
+    Py_VISIT(st->position_type);
+    Py_VISIT(st->ascmc_type);
+    Py_VISIT(st->houses_type);
+    Py_VISIT(st->houses_speed_type);
+    Py_VISIT(st->heliacal_pheno_type);
+    Py_VISIT(st->compact_type);
+    Py_VISIT(st->table_type);
+    Py_VISIT(st->timed_type);
+    Py_VISIT(st->stats_registry);
+    Py_VISIT(st->slow_hook);
+    Py_VISIT(st->aio_get_loop);
+    Py_VISIT(st->aio_set_future);
 #if PYSWE_USE_SWEPHELP
-    PyObject *m2;
+    Py_VISIT(st->contrib_error);
+    Py_VISIT(st->user_type);
+    Py_VISIT(st->data_type);
+    Py_VISIT(st->place_type);
+    Py_VISIT(st->atlas_index_type);
+    Py_VISIT(st->atlas_index);
 #endif
-    char buf[256]; /* for swe_version */
+    return 0;
+}
 
-    memset(buf, 0, sizeof(char) * 256);
+static int pyswe_clear(PyObject* m)
+{
+    pyswe_State* st = pyswe_get_state(m);
+    Py_CLEAR(st->error);
+    Py_CLEAR(st->position_type);
+    Py_CLEAR(st->ascmc_type);
+    Py_CLEAR(st->houses_type);
+    Py_CLEAR(st->houses_speed_type);
+    Py_CLEAR(st->heliacal_pheno_type);
+    Py_CLEAR(st->compact_type);
+    Py_CLEAR(st->table_type);
+    Py_CLEAR(st->timed_type);
+    Py_CLEAR(st->stats_registry);
+    Py_CLEAR(st->slow_hook);
+    Py_CLEAR(st->aio_get_loop);
+    Py_CLEAR(st->aio_set_future);
+#if PYSWE_USE_SWEPHELP
+    Py_CLEAR(st->contrib_error);
+    Py_CLEAR(st->user_type);
+    Py_CLEAR(st->data_type);
+    Py_CLEAR(st->place_type);
+    Py_CLEAR(st->atlas_index_type);
+    Py_CLEAR(st->atlas_index);
+#endif
+    return 0;
+}
 
-#if PY_MAJOR_VERSION >= 3
-    m = PyModule_Create(&pyswe_module);
-    if (m == NULL)
-        Py_FatalError("Can't create module swisseph!");
-#elif PY_MAJOR_VERSION < 3
-    m = Py_InitModule4("swisseph", pyswe_methods,
-        pyswe_module_documentation,
-        (PyObject*) NULL, PYTHON_API_VERSION);
+static void pyswe_free(void* m)
+{
+#if PY_VERSION_HEX < 0x03090000
+    if (pyswe_last_state == pyswe_get_state((PyObject*) m))
+        pyswe_last_state = NULL;
 #endif
+    pyswe_clear((PyObject*) m);
+}
 
-    /* Initialize exception */
-    pyswe_Error = PyErr_NewException("swisseph.Error", NULL, NULL);
-    Py_INCREF(pyswe_Error);
-    PyModule_AddObject(m, "Error", pyswe_Error);
-
-    /* Constants */
-
-    PyModule_AddFloatConstant(m, "AUNIT_TO_KM", SE_AUNIT_TO_KM);
-    PyModule_AddFloatConstant(m, "AUNIT_TO_LIGHTYEAR", SE_AUNIT_TO_LIGHTYEAR);
-    PyModule_AddFloatConstant(m, "AUNIT_TO_PARSEC", SE_AUNIT_TO_PARSEC);
-
-    PyModule_AddIntConstant(m, "JUL_CAL", SE_JUL_CAL);
-    PyModule_AddIntConstant(m, "GREG_CAL", SE_GREG_CAL);
-
-    PyModule_AddIntConstant(m, "ECL_NUT", SE_ECL_NUT);
-    PyModule_AddIntConstant(m, "SUN", SE_SUN);
-    PyModule_AddIntConstant(m, "MOON", SE_MOON);
-    PyModule_AddIntConstant(m, "MERCURY", SE_MERCURY);
-    PyModule_AddIntConstant(m, "VENUS", SE_VENUS);
-    PyModule_AddIntConstant(m, "MARS", SE_MARS);
-    PyModule_AddIntConstant(m, "JUPITER", SE_JUPITER);
-    PyModule_AddIntConstant(m, "SATURN", SE_SATURN);
-    PyModule_AddIntConstant(m, "URANUS", SE_URANUS);
-    PyModule_AddIntConstant(m, "NEPTUNE", SE_NEPTUNE);
-    PyModule_AddIntConstant(m, "PLUTO", SE_PLUTO);
-    PyModule_AddIntConstant(m, "MEAN_NODE", SE_MEAN_NODE);
-    PyModule_AddIntConstant(m, "TRUE_NODE", SE_TRUE_NODE);
-    PyModule_AddIntConstant(m, "MEAN_APOG", SE_MEAN_APOG);
-    PyModule_AddIntConstant(m, "OSCU_APOG", SE_OSCU_APOG);
-    PyModule_AddIntConstant(m, "EARTH", SE_EARTH);
-    PyModule_AddIntConstant(m, "CHIRON", SE_CHIRON);
-    PyModule_AddIntConstant(m, "PHOLUS", SE_PHOLUS);
-    PyModule_AddIntConstant(m, "CERES", SE_CERES);
-    PyModule_AddIntConstant(m, "PALLAS", SE_PALLAS);
-    PyModule_AddIntConstant(m, "JUNO", SE_JUNO);
-    PyModule_AddIntConstant(m, "VESTA", SE_VESTA);
-    PyModule_AddIntConstant(m, "INTP_APOG", SE_INTP_APOG);
-    PyModule_AddIntConstant(m, "INTP_PERG", SE_INTP_PERG);
-
-    PyModule_AddIntConstant(m, "NPLANETS", SE_NPLANETS);
-
-    PyModule_AddIntConstant(m, "PLMOON_OFFSET", SE_PLMOON_OFFSET);
-    PyModule_AddIntConstant(m, "AST_OFFSET", SE_AST_OFFSET);
-    PyModule_AddIntConstant(m, "VARUNA", SE_VARUNA);
-    PyModule_AddIntConstant(m, "FICT_OFFSET", SE_FICT_OFFSET);
-    PyModule_AddIntConstant(m, "FICT_OFFSET_1", SE_FICT_OFFSET_1);
-    PyModule_AddIntConstant(m, "FICT_MAX", SE_FICT_MAX);
-    PyModule_AddIntConstant(m, "NFICT_ELEM", SE_NFICT_ELEM);
-    PyModule_AddIntConstant(m, "COMET_OFFSET", SE_COMET_OFFSET);
-    PyModule_AddIntConstant(m, "NALL_NAT_POINTS", SE_NALL_NAT_POINTS);
-
-    PyModule_AddIntConstant(m, "CUPIDO", SE_CUPIDO);
-    PyModule_AddIntConstant(m, "HADES", SE_HADES);
-    PyModule_AddIntConstant(m, "ZEUS", SE_ZEUS);
-    PyModule_AddIntConstant(m, "KRONOS", SE_KRONOS);
-    PyModule_AddIntConstant(m, "APOLLON", SE_APOLLON);
-    PyModule_AddIntConstant(m, "ADMETOS", SE_ADMETOS);
-    PyModule_AddIntConstant(m, "VULKANUS", SE_VULKANUS);
-    PyModule_AddIntConstant(m, "POSEIDON", SE_POSEIDON);
-
-    PyModule_AddIntConstant(m, "ISIS", SE_ISIS);
-    PyModule_AddIntConstant(m, "NIBIRU", SE_NIBIRU);
-    PyModule_AddIntConstant(m, "HARRINGTON", SE_HARRINGTON);
-    PyModule_AddIntConstant(m, "NEPTUNE_LEVERRIER", SE_NEPTUNE_LEVERRIER);
-    PyModule_AddIntConstant(m, "NEPTUNE_ADAMS", SE_NEPTUNE_ADAMS);
-    PyModule_AddIntConstant(m, "PLUTO_LOWELL", SE_PLUTO_LOWELL);
-    PyModule_AddIntConstant(m, "PLUTO_PICKERING", SE_PLUTO_PICKERING);
-    PyModule_AddIntConstant(m, "VULCAN", SE_VULCAN);
-    PyModule_AddIntConstant(m, "WHITE_MOON", SE_WHITE_MOON);
-    PyModule_AddIntConstant(m, "PROSERPINA", SE_PROSERPINA);
-    PyModule_AddIntConstant(m, "WALDEMATH", SE_WALDEMATH);
-
-    PyModule_AddIntConstant(m, "FIXSTAR", SE_FIXSTAR);
-
-    PyModule_AddIntConstant(m, "ASC", SE_ASC);
-    PyModule_AddIntConstant(m, "MC", SE_MC);
-    PyModule_AddIntConstant(m, "ARMC", SE_ARMC);
-    PyModule_AddIntConstant(m, "VERTEX", SE_VERTEX);
-    PyModule_AddIntConstant(m, "EQUASC", SE_EQUASC);
-    PyModule_AddIntConstant(m, "COASC1", SE_COASC1);
-    PyModule_AddIntConstant(m, "COASC2", SE_COASC2);
-    PyModule_AddIntConstant(m, "POLASC", SE_POLASC);
-    PyModule_AddIntConstant(m, "NASCMC", SE_NASCMC);
-
-    PyModule_AddIntConstant(m, "FLG_JPLEPH", SEFLG_JPLEPH);
-    PyModule_AddIntConstant(m, "FLG_SWIEPH", SEFLG_SWIEPH);
-    PyModule_AddIntConstant(m, "FLG_MOSEPH", SEFLG_MOSEPH);
-
-    PyModule_AddIntConstant(m, "FLG_HELCTR", SEFLG_HELCTR);
-    PyModule_AddIntConstant(m, "FLG_TRUEPOS", SEFLG_TRUEPOS);
-    PyModule_AddIntConstant(m, "FLG_J2000", SEFLG_J2000);
-    PyModule_AddIntConstant(m, "FLG_NONUT", SEFLG_NONUT);
-    PyModule_AddIntConstant(m, "FLG_SPEED3", SEFLG_SPEED3);
-    PyModule_AddIntConstant(m, "FLG_SPEED", SEFLG_SPEED);
-    PyModule_AddIntConstant(m, "FLG_NOGDEFL", SEFLG_NOGDEFL);
-    PyModule_AddIntConstant(m, "FLG_NOABERR", SEFLG_NOABERR);
-    PyModule_AddIntConstant(m, "FLG_ASTROMETRIC", SEFLG_ASTROMETRIC);
-    PyModule_AddIntConstant(m, "FLG_EQUATORIAL", SEFLG_EQUATORIAL);
-    PyModule_AddIntConstant(m, "FLG_XYZ", SEFLG_XYZ);
-    PyModule_AddIntConstant(m, "FLG_RADIANS", SEFLG_RADIANS);
-    PyModule_AddIntConstant(m, "FLG_BARYCTR", SEFLG_BARYCTR);
-    PyModule_AddIntConstant(m, "FLG_TOPOCTR", SEFLG_TOPOCTR);
-    PyModule_AddIntConstant(m, "FLG_ORBEL_AA", SEFLG_ORBEL_AA);
-    PyModule_AddIntConstant(m, "FLG_TROPICAL", SEFLG_TROPICAL);
-    PyModule_AddIntConstant(m, "FLG_SIDEREAL", SEFLG_SIDEREAL);
-    PyModule_AddIntConstant(m, "FLG_ICRS", SEFLG_ICRS);
-    PyModule_AddIntConstant(m, "FLG_DPSIDEPS_1980", SEFLG_DPSIDEPS_1980);
-    PyModule_AddIntConstant(m, "FLG_JPLHOR", SEFLG_JPLHOR);
-    PyModule_AddIntConstant(m, "FLG_JPLHOR_APPROX", SEFLG_JPLHOR_APPROX);
-    PyModule_AddIntConstant(m, "FLG_CENTER_BODY", SEFLG_CENTER_BODY);
-    PyModule_AddIntConstant(m, "FLG_TEST_PLMOON", SEFLG_TEST_PLMOON);
-
-    PyModule_AddIntConstant(m, "SIDBITS", SE_SIDBITS);
-    PyModule_AddIntConstant(m, "SIDBIT_ECL_T0", SE_SIDBIT_ECL_T0);
-    PyModule_AddIntConstant(m, "SIDBIT_SSY_PLANE", SE_SIDBIT_SSY_PLANE);
-    PyModule_AddIntConstant(m, "SIDBIT_USER_UT", SE_SIDBIT_USER_UT);
-    PyModule_AddIntConstant(m, "SIDBIT_ECL_DATE", SE_SIDBIT_ECL_DATE);
-    PyModule_AddIntConstant(m, "SIDBIT_NO_PREC_OFFSET", SE_SIDBIT_NO_PREC_OFFSET);
-    PyModule_AddIntConstant(m, "SIDBIT_PREC_ORIG", SE_SIDBIT_PREC_ORIG);
-
-    PyModule_AddIntConstant(m, "SIDM_FAGAN_BRADLEY", SE_SIDM_FAGAN_BRADLEY);
-    PyModule_AddIntConstant(m, "SIDM_LAHIRI", SE_SIDM_LAHIRI);
-    PyModule_AddIntConstant(m, "SIDM_DELUCE", SE_SIDM_DELUCE);
-    PyModule_AddIntConstant(m, "SIDM_RAMAN", SE_SIDM_RAMAN);
-    PyModule_AddIntConstant(m, "SIDM_USHASHASHI", SE_SIDM_USHASHASHI);
-    PyModule_AddIntConstant(m, "SIDM_KRISHNAMURTI", SE_SIDM_KRISHNAMURTI);
-    PyModule_AddIntConstant(m, "SIDM_DJWHAL_KHUL", SE_SIDM_DJWHAL_KHUL);
-    PyModule_AddIntConstant(m, "SIDM_YUKTESHWAR", SE_SIDM_YUKTESHWAR);
-    PyModule_AddIntConstant(m, "SIDM_JN_BHASIN", SE_SIDM_JN_BHASIN);
-    PyModule_AddIntConstant(m, "SIDM_BABYL_KUGLER1", SE_SIDM_BABYL_KUGLER1);
-    PyModule_AddIntConstant(m, "SIDM_BABYL_KUGLER2", SE_SIDM_BABYL_KUGLER2);
-    PyModule_AddIntConstant(m, "SIDM_BABYL_KUGLER3", SE_SIDM_BABYL_KUGLER3);
-    PyModule_AddIntConstant(m, "SIDM_BABYL_HUBER", SE_SIDM_BABYL_HUBER);
-    PyModule_AddIntConstant(m, "SIDM_BABYL_ETPSC", SE_SIDM_BABYL_ETPSC);
-    PyModule_AddIntConstant(m, "SIDM_ALDEBARAN_15TAU", SE_SIDM_ALDEBARAN_15TAU);
-    PyModule_AddIntConstant(m, "SIDM_HIPPARCHOS", SE_SIDM_HIPPARCHOS);
-    PyModule_AddIntConstant(m, "SIDM_SASSANIAN", SE_SIDM_SASSANIAN);
-    PyModule_AddIntConstant(m, "SIDM_GALCENT_0SAG", SE_SIDM_GALCENT_0SAG);
-    PyModule_AddIntConstant(m, "SIDM_J2000", SE_SIDM_J2000);
-    PyModule_AddIntConstant(m, "SIDM_J1900", SE_SIDM_J1900);
-    PyModule_AddIntConstant(m, "SIDM_B1950", SE_SIDM_B1950);
-    PyModule_AddIntConstant(m, "SIDM_SURYASIDDHANTA", SE_SIDM_SURYASIDDHANTA);
-    PyModule_AddIntConstant(m, "SIDM_SURYASIDDHANTA_MSUN", SE_SIDM_SURYASIDDHANTA_MSUN);
-    PyModule_AddIntConstant(m, "SIDM_ARYABHATA", SE_SIDM_ARYABHATA);
-    PyModule_AddIntConstant(m, "SIDM_ARYABHATA_MSUN", SE_SIDM_ARYABHATA_MSUN);
-    PyModule_AddIntConstant(m, "SIDM_SS_REVATI", SE_SIDM_SS_REVATI);
-    PyModule_AddIntConstant(m, "SIDM_SS_CITRA", SE_SIDM_SS_CITRA);
-    PyModule_AddIntConstant(m, "SIDM_TRUE_CITRA", SE_SIDM_TRUE_CITRA);
-    PyModule_AddIntConstant(m, "SIDM_TRUE_REVATI", SE_SIDM_TRUE_REVATI);
-    PyModule_AddIntConstant(m, "SIDM_TRUE_PUSHYA", SE_SIDM_TRUE_PUSHYA);
-    PyModule_AddIntConstant(m, "SIDM_GALCENT_RGILBRAND", SE_SIDM_GALCENT_RGILBRAND);
-    PyModule_AddIntConstant(m, "SIDM_GALEQU_IAU1958", SE_SIDM_GALEQU_IAU1958);
-    PyModule_AddIntConstant(m, "SIDM_GALEQU_TRUE", SE_SIDM_GALEQU_TRUE);
-    PyModule_AddIntConstant(m, "SIDM_GALEQU_MULA", SE_SIDM_GALEQU_MULA);
-    PyModule_AddIntConstant(m, "SIDM_GALALIGN_MARDYKS", SE_SIDM_GALALIGN_MARDYKS);
-    PyModule_AddIntConstant(m, "SIDM_TRUE_MULA", SE_SIDM_TRUE_MULA);
-    PyModule_AddIntConstant(m, "SIDM_GALCENT_MULA_WILHELM", SE_SIDM_GALCENT_MULA_WILHELM);
-    PyModule_AddIntConstant(m, "SIDM_ARYABHATA_522", SE_SIDM_ARYABHATA_522);
-    PyModule_AddIntConstant(m, "SIDM_BABYL_BRITTON", SE_SIDM_BABYL_BRITTON);
-    PyModule_AddIntConstant(m, "SIDM_TRUE_SHEORAN", SE_SIDM_TRUE_SHEORAN);
-    PyModule_AddIntConstant(m, "SIDM_GALCENT_COCHRANE", SE_SIDM_GALCENT_COCHRANE);
-    PyModule_AddIntConstant(m, "SIDM_GALEQU_FIORENZA", SE_SIDM_GALEQU_FIORENZA);
-    PyModule_AddIntConstant(m, "SIDM_VALENS_MOON", SE_SIDM_VALENS_MOON);
-    PyModule_AddIntConstant(m, "SIDM_LAHIRI_1940", SE_SIDM_LAHIRI_1940);
-    PyModule_AddIntConstant(m, "SIDM_LAHIRI_VP285", SE_SIDM_LAHIRI_VP285);
-    PyModule_AddIntConstant(m, "SIDM_KRISHNAMURTI_VP291", SE_SIDM_KRISHNAMURTI_VP291);
-    PyModule_AddIntConstant(m, "SIDM_LAHIRI_ICRC", SE_SIDM_LAHIRI_ICRC);
-    PyModule_AddIntConstant(m, "SIDM_USER", SE_SIDM_USER);
-
-    PyModule_AddIntConstant(m, "NSIDM_PREDEF", SE_NSIDM_PREDEF);
-
-    PyModule_AddIntConstant(m, "NODBIT_MEAN", SE_NODBIT_MEAN);
-    PyModule_AddIntConstant(m, "NODBIT_OSCU", SE_NODBIT_OSCU);
-    PyModule_AddIntConstant(m, "NODBIT_OSCU_BAR", SE_NODBIT_OSCU_BAR);
-    PyModule_AddIntConstant(m, "NODBIT_FOPOINT", SE_NODBIT_FOPOINT);
-
-    PyModule_AddIntConstant(m, "FLG_DEFAULTEPH", SEFLG_DEFAULTEPH);
-
-    PyModule_AddIntConstant(m, "MAX_STNAME", SE_MAX_STNAME);
-
-    PyModule_AddIntConstant(m, "ECL_CENTRAL", SE_ECL_CENTRAL);
-    PyModule_AddIntConstant(m, "ECL_NONCENTRAL", SE_ECL_NONCENTRAL);
-    PyModule_AddIntConstant(m, "ECL_TOTAL", SE_ECL_TOTAL);
-    PyModule_AddIntConstant(m, "ECL_ANNULAR", SE_ECL_ANNULAR);
-    PyModule_AddIntConstant(m, "ECL_PARTIAL", SE_ECL_PARTIAL);
-    PyModule_AddIntConstant(m, "ECL_ANNULAR_TOTAL", SE_ECL_ANNULAR_TOTAL);
-    PyModule_AddIntConstant(m, "ECL_HYBRID", SE_ECL_HYBRID);
-    PyModule_AddIntConstant(m, "ECL_PENUMBRAL", SE_ECL_PENUMBRAL);
-    PyModule_AddIntConstant(m, "ECL_ALLTYPES_SOLAR", SE_ECL_ALLTYPES_SOLAR);
-    PyModule_AddIntConstant(m, "ECL_ALLTYPES_LUNAR", SE_ECL_ALLTYPES_LUNAR);
-    PyModule_AddIntConstant(m, "ECL_VISIBLE", SE_ECL_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_MAX_VISIBLE", SE_ECL_MAX_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_1ST_VISIBLE", SE_ECL_1ST_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_PARTBEG_VISIBLE", SE_ECL_PARTBEG_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_2ND_VISIBLE", SE_ECL_2ND_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_TOTBEG_VISIBLE", SE_ECL_TOTBEG_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_3RD_VISIBLE", SE_ECL_3RD_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_TOTEND_VISIBLE", SE_ECL_TOTEND_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_4TH_VISIBLE", SE_ECL_4TH_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_PARTEND_VISIBLE", SE_ECL_PARTEND_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_PENUMBBEG_VISIBLE", SE_ECL_PENUMBBEG_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_PENUMBEND_VISIBLE", SE_ECL_PENUMBEND_VISIBLE);
-    PyModule_AddIntConstant(m, "ECL_OCC_BEG_DAYLIGHT", SE_ECL_OCC_BEG_DAYLIGHT);
-    PyModule_AddIntConstant(m, "ECL_OCC_END_DAYLIGHT", SE_ECL_OCC_END_DAYLIGHT);
-    PyModule_AddIntConstant(m, "ECL_ONE_TRY", SE_ECL_ONE_TRY);
-
-    PyModule_AddIntConstant(m, "CALC_RISE", SE_CALC_RISE);
-    PyModule_AddIntConstant(m, "CALC_SET", SE_CALC_SET);
-    PyModule_AddIntConstant(m, "CALC_MTRANSIT", SE_CALC_MTRANSIT);
-    PyModule_AddIntConstant(m, "CALC_ITRANSIT", SE_CALC_ITRANSIT);
-    PyModule_AddIntConstant(m, "BIT_DISC_CENTER", SE_BIT_DISC_CENTER);
-    PyModule_AddIntConstant(m, "BIT_DISC_BOTTOM", SE_BIT_DISC_BOTTOM);
-    PyModule_AddIntConstant(m, "BIT_NO_REFRACTION", SE_BIT_NO_REFRACTION);
-    PyModule_AddIntConstant(m, "BIT_CIVIL_TWILIGHT", SE_BIT_CIVIL_TWILIGHT);
-    PyModule_AddIntConstant(m, "BIT_NAUTIC_TWILIGHT", SE_BIT_NAUTIC_TWILIGHT);
-    PyModule_AddIntConstant(m, "BIT_ASTRO_TWILIGHT", SE_BIT_ASTRO_TWILIGHT);
-    PyModule_AddIntConstant(m, "BIT_FIXED_DISC_SIZE", SE_BIT_FIXED_DISC_SIZE);
-    PyModule_AddIntConstant(m, "BIT_FORCE_SLOW_METHOD", SE_BIT_FORCE_SLOW_METHOD);
-    PyModule_AddIntConstant(m, "BIT_HINDU_RISING", SE_BIT_HINDU_RISING);
-
-    PyModule_AddIntConstant(m, "ECL2HOR", SE_ECL2HOR);
-    PyModule_AddIntConstant(m, "EQU2HOR", SE_EQU2HOR);
-    PyModule_AddIntConstant(m, "HOR2ECL", SE_HOR2ECL);
-    PyModule_AddIntConstant(m, "HOR2EQU", SE_HOR2EQU);
-
-    PyModule_AddIntConstant(m, "TRUE_TO_APP", SE_TRUE_TO_APP);
-    PyModule_AddIntConstant(m, "APP_TO_TRUE", SE_APP_TO_TRUE);
-
-    PyModule_AddIntConstant(m, "DE_NUMBER", SE_DE_NUMBER);
-    PyModule_AddStringConstant(m, "FNAME_DE200", SE_FNAME_DE200);
-    PyModule_AddStringConstant(m, "FNAME_DE403", SE_FNAME_DE403);
-    PyModule_AddStringConstant(m, "FNAME_DE404", SE_FNAME_DE404);
-    PyModule_AddStringConstant(m, "FNAME_DE405", SE_FNAME_DE405);
-    PyModule_AddStringConstant(m, "FNAME_DE406", SE_FNAME_DE406);
-    PyModule_AddStringConstant(m, "SE_FNAME_DE431", SE_FNAME_DE431);
-    PyModule_AddStringConstant(m, "FNAME_DFT", SE_FNAME_DFT);
-    PyModule_AddStringConstant(m, "FNAME_DFT2", SE_FNAME_DFT2);
-    PyModule_AddStringConstant(m, "STARFILE_OLD", SE_STARFILE_OLD);
-    PyModule_AddStringConstant(m, "STARFILE", SE_STARFILE);
-    PyModule_AddStringConstant(m, "ASTNAMFILE", SE_ASTNAMFILE);
-    PyModule_AddStringConstant(m, "FICTFILE", SE_FICTFILE);
-
-    PyModule_AddStringConstant(m, "EPHE_PATH", SE_EPHE_PATH);
-
-    PyModule_AddIntConstant(m, "SPLIT_DEG_ROUND_SEC", SE_SPLIT_DEG_ROUND_SEC);
-    PyModule_AddIntConstant(m, "SPLIT_DEG_ROUND_MIN", SE_SPLIT_DEG_ROUND_MIN);
-    PyModule_AddIntConstant(m, "SPLIT_DEG_ROUND_DEG", SE_SPLIT_DEG_ROUND_DEG);
-    PyModule_AddIntConstant(m, "SPLIT_DEG_ZODIACAL", SE_SPLIT_DEG_ZODIACAL);
-    PyModule_AddIntConstant(m, "SPLIT_DEG_NAKSHATRA", SE_SPLIT_DEG_NAKSHATRA);
-    PyModule_AddIntConstant(m, "SPLIT_DEG_KEEP_SIGN", SE_SPLIT_DEG_KEEP_SIGN);
-    PyModule_AddIntConstant(m, "SPLIT_DEG_KEEP_DEG", SE_SPLIT_DEG_KEEP_DEG);
-
-    PyModule_AddIntConstant(m, "HELIACAL_RISING", SE_HELIACAL_RISING);
-    PyModule_AddIntConstant(m, "HELIACAL_SETTING", SE_HELIACAL_SETTING);
-    PyModule_AddIntConstant(m, "EVENING_FIRST", SE_EVENING_FIRST);
-    PyModule_AddIntConstant(m, "EVENING_LAST", SE_EVENING_LAST);
-    PyModule_AddIntConstant(m, "MORNING_LAST", SE_MORNING_LAST);
-    PyModule_AddIntConstant(m, "MORNING_FIRST", SE_MORNING_FIRST);
-    PyModule_AddIntConstant(m, "ACRONYCHAL_RISING", SE_ACRONYCHAL_RISING);
-    PyModule_AddIntConstant(m, "COSMICAL_SETTING", SE_COSMICAL_SETTING);
-    PyModule_AddIntConstant(m, "ACRONYCHAL_SETTING", SE_ACRONYCHAL_SETTING);
-
-    PyModule_AddIntConstant(m, "HELFLAG_LONG_SEARCH", SE_HELFLAG_LONG_SEARCH);
-    PyModule_AddIntConstant(m, "HELFLAG_HIGH_PRECISION", SE_HELFLAG_HIGH_PRECISION);
-    PyModule_AddIntConstant(m, "HELFLAG_OPTICAL_PARAMS", SE_HELFLAG_OPTICAL_PARAMS);
-    PyModule_AddIntConstant(m, "HELFLAG_NO_DETAILS", SE_HELFLAG_NO_DETAILS);
-    PyModule_AddIntConstant(m, "HELFLAG_SEARCH_1_PERIOD", SE_HELFLAG_SEARCH_1_PERIOD);
-    PyModule_AddIntConstant(m, "HELFLAG_VISLIM_DARK", SE_HELFLAG_VISLIM_DARK);
-    PyModule_AddIntConstant(m, "HELFLAG_VISLIM_NOMOON", SE_HELFLAG_VISLIM_NOMOON);
-    PyModule_AddIntConstant(m, "HELFLAG_VISLIM_PHOTOPIC", SE_HELFLAG_VISLIM_PHOTOPIC);
-    PyModule_AddIntConstant(m, "HELFLAG_AV", SE_HELFLAG_AV);
-    PyModule_AddIntConstant(m, "HELFLAG_AVKIND_VR", SE_HELFLAG_AVKIND_VR);
-    PyModule_AddIntConstant(m, "HELFLAG_AVKIND_PTO", SE_HELFLAG_AVKIND_PTO);
-    PyModule_AddIntConstant(m, "HELFLAG_AVKIND_MIN7", SE_HELFLAG_AVKIND_MIN7);
-    PyModule_AddIntConstant(m, "HELFLAG_AVKIND_MIN9", SE_HELFLAG_AVKIND_MIN9);
-    PyModule_AddIntConstant(m, "HELFLAG_AVKIND", SE_HELFLAG_AVKIND);
-    PyModule_AddFloatConstant(m, "TJD_INVALID", TJD_INVALID);
-    PyModule_AddIntConstant(m, "SIMULATE_VICTORVB", SIMULATE_VICTORVB);
+/* Constants of swisseph
+ * With a module __getattr__, they are added to the module on first access,
+ * instead of on import.
+ */
+typedef struct {
+    const char* name;
+    char type; /* 'i', 'd' or 's' */
+    long i;
+    double d;
+    const char* s;
+} pyswe_Constant;
+
+#define PYSWE_INT(name, v)      {name, 'i', v, 0, NULL}
+#define PYSWE_FLOAT(name, v)    {name, 'd', 0, v, NULL}
+#define PYSWE_STRING(name, v)   {name, 's', 0, 0, v}
+
+static const pyswe_Constant pyswe_constants[] = {
+    PYSWE_FLOAT("AUNIT_TO_KM", SE_AUNIT_TO_KM),
+    PYSWE_FLOAT("AUNIT_TO_LIGHTYEAR", SE_AUNIT_TO_LIGHTYEAR),
+    PYSWE_FLOAT("AUNIT_TO_PARSEC", SE_AUNIT_TO_PARSEC),
+
+    PYSWE_INT("JUL_CAL", SE_JUL_CAL),
+    PYSWE_INT("GREG_CAL", SE_GREG_CAL),
+
+    PYSWE_INT("ECL_NUT", SE_ECL_NUT),
+    PYSWE_INT("SUN", SE_SUN),
+    PYSWE_INT("MOON", SE_MOON),
+    PYSWE_INT("MERCURY", SE_MERCURY),
+    PYSWE_INT("VENUS", SE_VENUS),
+    PYSWE_INT("MARS", SE_MARS),
+    PYSWE_INT("JUPITER", SE_JUPITER),
+    PYSWE_INT("SATURN", SE_SATURN),
+    PYSWE_INT("URANUS", SE_URANUS),
+    PYSWE_INT("NEPTUNE", SE_NEPTUNE),
+    PYSWE_INT("PLUTO", SE_PLUTO),
+    PYSWE_INT("MEAN_NODE", SE_MEAN_NODE),
+    PYSWE_INT("TRUE_NODE", SE_TRUE_NODE),
+    PYSWE_INT("MEAN_APOG", SE_MEAN_APOG),
+    PYSWE_INT("OSCU_APOG", SE_OSCU_APOG),
+    PYSWE_INT("EARTH", SE_EARTH),
+    PYSWE_INT("CHIRON", SE_CHIRON),
+    PYSWE_INT("PHOLUS", SE_PHOLUS),
+    PYSWE_INT("CERES", SE_CERES),
+    PYSWE_INT("PALLAS", SE_PALLAS),
+    PYSWE_INT("JUNO", SE_JUNO),
+    PYSWE_INT("VESTA", SE_VESTA),
+    PYSWE_INT("INTP_APOG", SE_INTP_APOG),
+    PYSWE_INT("INTP_PERG", SE_INTP_PERG),
+
+    PYSWE_INT("NPLANETS", SE_NPLANETS),
+
+    PYSWE_INT("PLMOON_OFFSET", SE_PLMOON_OFFSET),
+    PYSWE_INT("AST_OFFSET", SE_AST_OFFSET),
+    PYSWE_INT("VARUNA", SE_VARUNA),
+    PYSWE_INT("FICT_OFFSET", SE_FICT_OFFSET),
+    PYSWE_INT("FICT_OFFSET_1", SE_FICT_OFFSET_1),
+    PYSWE_INT("FICT_MAX", SE_FICT_MAX),
+    PYSWE_INT("NFICT_ELEM", SE_NFICT_ELEM),
+    PYSWE_INT("COMET_OFFSET", SE_COMET_OFFSET),
+    PYSWE_INT("NALL_NAT_POINTS", SE_NALL_NAT_POINTS),
+
+    PYSWE_INT("CUPIDO", SE_CUPIDO),
+    PYSWE_INT("HADES", SE_HADES),
+    PYSWE_INT("ZEUS", SE_ZEUS),
+    PYSWE_INT("KRONOS", SE_KRONOS),
+    PYSWE_INT("APOLLON", SE_APOLLON),
+    PYSWE_INT("ADMETOS", SE_ADMETOS),
+    PYSWE_INT("VULKANUS", SE_VULKANUS),
+    PYSWE_INT("POSEIDON", SE_POSEIDON),
+
+    PYSWE_INT("ISIS", SE_ISIS),
+    PYSWE_INT("NIBIRU", SE_NIBIRU),
+    PYSWE_INT("HARRINGTON", SE_HARRINGTON),
+    PYSWE_INT("NEPTUNE_LEVERRIER", SE_NEPTUNE_LEVERRIER),
+    PYSWE_INT("NEPTUNE_ADAMS", SE_NEPTUNE_ADAMS),
+    PYSWE_INT("PLUTO_LOWELL", SE_PLUTO_LOWELL),
+    PYSWE_INT("PLUTO_PICKERING", SE_PLUTO_PICKERING),
+    PYSWE_INT("VULCAN", SE_VULCAN),
+    PYSWE_INT("WHITE_MOON", SE_WHITE_MOON),
+    PYSWE_INT("PROSERPINA", SE_PROSERPINA),
+    PYSWE_INT("WALDEMATH", SE_WALDEMATH),
+
+    PYSWE_INT("FIXSTAR", SE_FIXSTAR),
+
+    PYSWE_INT("ASC", SE_ASC),
+    PYSWE_INT("MC", SE_MC),
+    PYSWE_INT("ARMC", SE_ARMC),
+    PYSWE_INT("VERTEX", SE_VERTEX),
+    PYSWE_INT("EQUASC", SE_EQUASC),
+    PYSWE_INT("COASC1", SE_COASC1),
+    PYSWE_INT("COASC2", SE_COASC2),
+    PYSWE_INT("POLASC", SE_POLASC),
+    PYSWE_INT("NASCMC", SE_NASCMC),
+
+    PYSWE_INT("FLG_JPLEPH", SEFLG_JPLEPH),
+    PYSWE_INT("FLG_SWIEPH", SEFLG_SWIEPH),
+    PYSWE_INT("FLG_MOSEPH", SEFLG_MOSEPH),
+
+    PYSWE_INT("FLG_HELCTR", SEFLG_HELCTR),
+    PYSWE_INT("FLG_TRUEPOS", SEFLG_TRUEPOS),
+    PYSWE_INT("FLG_J2000", SEFLG_J2000),
+    PYSWE_INT("FLG_NONUT", SEFLG_NONUT),
+    PYSWE_INT("FLG_SPEED3", SEFLG_SPEED3),
+    PYSWE_INT("FLG_SPEED", SEFLG_SPEED),
+    PYSWE_INT("FLG_NOGDEFL", SEFLG_NOGDEFL),
+    PYSWE_INT("FLG_NOABERR", SEFLG_NOABERR),
+    PYSWE_INT("FLG_ASTROMETRIC", SEFLG_ASTROMETRIC),
+    PYSWE_INT("FLG_EQUATORIAL", SEFLG_EQUATORIAL),
+    PYSWE_INT("FLG_XYZ", SEFLG_XYZ),
+    PYSWE_INT("FLG_RADIANS", SEFLG_RADIANS),
+    PYSWE_INT("FLG_BARYCTR", SEFLG_BARYCTR),
+    PYSWE_INT("FLG_TOPOCTR", SEFLG_TOPOCTR),
+    PYSWE_INT("FLG_ORBEL_AA", SEFLG_ORBEL_AA),
+    PYSWE_INT("FLG_TROPICAL", SEFLG_TROPICAL),
+    PYSWE_INT("FLG_SIDEREAL", SEFLG_SIDEREAL),
+    PYSWE_INT("FLG_ICRS", SEFLG_ICRS),
+    PYSWE_INT("FLG_DPSIDEPS_1980", SEFLG_DPSIDEPS_1980),
+    PYSWE_INT("FLG_JPLHOR", SEFLG_JPLHOR),
+    PYSWE_INT("FLG_JPLHOR_APPROX", SEFLG_JPLHOR_APPROX),
+    PYSWE_INT("FLG_CENTER_BODY", SEFLG_CENTER_BODY),
+    PYSWE_INT("FLG_TEST_PLMOON", SEFLG_TEST_PLMOON),
+
+    PYSWE_INT("SIDBITS", SE_SIDBITS),
+    PYSWE_INT("SIDBIT_ECL_T0", SE_SIDBIT_ECL_T0),
+    PYSWE_INT("SIDBIT_SSY_PLANE", SE_SIDBIT_SSY_PLANE),
+    PYSWE_INT("SIDBIT_USER_UT", SE_SIDBIT_USER_UT),
+    PYSWE_INT("SIDBIT_ECL_DATE", SE_SIDBIT_ECL_DATE),
+    PYSWE_INT("SIDBIT_NO_PREC_OFFSET", SE_SIDBIT_NO_PREC_OFFSET),
+    PYSWE_INT("SIDBIT_PREC_ORIG", SE_SIDBIT_PREC_ORIG),
+
+    PYSWE_INT("SIDM_FAGAN_BRADLEY", SE_SIDM_FAGAN_BRADLEY),
+    PYSWE_INT("SIDM_LAHIRI", SE_SIDM_LAHIRI),
+    PYSWE_INT("SIDM_DELUCE", SE_SIDM_DELUCE),
+    PYSWE_INT("SIDM_RAMAN", SE_SIDM_RAMAN),
+    PYSWE_INT("SIDM_USHASHASHI", SE_SIDM_USHASHASHI),
+    PYSWE_INT("SIDM_KRISHNAMURTI", SE_SIDM_KRISHNAMURTI),
+    PYSWE_INT("SIDM_DJWHAL_KHUL", SE_SIDM_DJWHAL_KHUL),
+    PYSWE_INT("SIDM_YUKTESHWAR", SE_SIDM_YUKTESHWAR),
+    PYSWE_INT("SIDM_JN_BHASIN", SE_SIDM_JN_BHASIN),
+    PYSWE_INT("SIDM_BABYL_KUGLER1", SE_SIDM_BABYL_KUGLER1),
+    PYSWE_INT("SIDM_BABYL_KUGLER2", SE_SIDM_BABYL_KUGLER2),
+    PYSWE_INT("SIDM_BABYL_KUGLER3", SE_SIDM_BABYL_KUGLER3),
+    PYSWE_INT("SIDM_BABYL_HUBER", SE_SIDM_BABYL_HUBER),
+    PYSWE_INT("SIDM_BABYL_ETPSC", SE_SIDM_BABYL_ETPSC),
+    PYSWE_INT("SIDM_ALDEBARAN_15TAU", SE_SIDM_ALDEBARAN_15TAU),
+    PYSWE_INT("SIDM_HIPPARCHOS", SE_SIDM_HIPPARCHOS),
+    PYSWE_INT("SIDM_SASSANIAN", SE_SIDM_SASSANIAN),
+    PYSWE_INT("SIDM_GALCENT_0SAG", SE_SIDM_GALCENT_0SAG),
+    PYSWE_INT("SIDM_J2000", SE_SIDM_J2000),
+    PYSWE_INT("SIDM_J1900", SE_SIDM_J1900),
+    PYSWE_INT("SIDM_B1950", SE_SIDM_B1950),
+    PYSWE_INT("SIDM_SURYASIDDHANTA", SE_SIDM_SURYASIDDHANTA),
+    PYSWE_INT("SIDM_SURYASIDDHANTA_MSUN", SE_SIDM_SURYASIDDHANTA_MSUN),
+    PYSWE_INT("SIDM_ARYABHATA", SE_SIDM_ARYABHATA),
+    PYSWE_INT("SIDM_ARYABHATA_MSUN", SE_SIDM_ARYABHATA_MSUN),
+    PYSWE_INT("SIDM_SS_REVATI", SE_SIDM_SS_REVATI),
+    PYSWE_INT("SIDM_SS_CITRA", SE_SIDM_SS_CITRA),
+    PYSWE_INT("SIDM_TRUE_CITRA", SE_SIDM_TRUE_CITRA),
+    PYSWE_INT("SIDM_TRUE_REVATI", SE_SIDM_TRUE_REVATI),
+    PYSWE_INT("SIDM_TRUE_PUSHYA", SE_SIDM_TRUE_PUSHYA),
+    PYSWE_INT("SIDM_GALCENT_RGILBRAND", SE_SIDM_GALCENT_RGILBRAND),
+    PYSWE_INT("SIDM_GALEQU_IAU1958", SE_SIDM_GALEQU_IAU1958),
+    PYSWE_INT("SIDM_GALEQU_TRUE", SE_SIDM_GALEQU_TRUE),
+    PYSWE_INT("SIDM_GALEQU_MULA", SE_SIDM_GALEQU_MULA),
+    PYSWE_INT("SIDM_GALALIGN_MARDYKS", SE_SIDM_GALALIGN_MARDYKS),
+    PYSWE_INT("SIDM_TRUE_MULA", SE_SIDM_TRUE_MULA),
+    PYSWE_INT("SIDM_GALCENT_MULA_WILHELM", SE_SIDM_GALCENT_MULA_WILHELM),
+    PYSWE_INT("SIDM_ARYABHATA_522", SE_SIDM_ARYABHATA_522),
+    PYSWE_INT("SIDM_BABYL_BRITTON", SE_SIDM_BABYL_BRITTON),
+    PYSWE_INT("SIDM_TRUE_SHEORAN", SE_SIDM_TRUE_SHEORAN),
+    PYSWE_INT("SIDM_GALCENT_COCHRANE", SE_SIDM_GALCENT_COCHRANE),
+    PYSWE_INT("SIDM_GALEQU_FIORENZA", SE_SIDM_GALEQU_FIORENZA),
+    PYSWE_INT("SIDM_VALENS_MOON", SE_SIDM_VALENS_MOON),
+    PYSWE_INT("SIDM_LAHIRI_1940", SE_SIDM_LAHIRI_1940),
+    PYSWE_INT("SIDM_LAHIRI_VP285", SE_SIDM_LAHIRI_VP285),
+    PYSWE_INT("SIDM_KRISHNAMURTI_VP291", SE_SIDM_KRISHNAMURTI_VP291),
+    PYSWE_INT("SIDM_LAHIRI_ICRC", SE_SIDM_LAHIRI_ICRC),
+    PYSWE_INT("SIDM_USER", SE_SIDM_USER),
+
+    PYSWE_INT("NSIDM_PREDEF", SE_NSIDM_PREDEF),
+
+    PYSWE_INT("NODBIT_MEAN", SE_NODBIT_MEAN),
+    PYSWE_INT("NODBIT_OSCU", SE_NODBIT_OSCU),
+    PYSWE_INT("NODBIT_OSCU_BAR", SE_NODBIT_OSCU_BAR),
+    PYSWE_INT("NODBIT_FOPOINT", SE_NODBIT_FOPOINT),
+
+    PYSWE_INT("FLG_DEFAULTEPH", SEFLG_DEFAULTEPH),
+
+    PYSWE_INT("MAX_STNAME", SE_MAX_STNAME),
+
+    PYSWE_INT("ECL_CENTRAL", SE_ECL_CENTRAL),
+    PYSWE_INT("ECL_NONCENTRAL", SE_ECL_NONCENTRAL),
+    PYSWE_INT("ECL_TOTAL", SE_ECL_TOTAL),
+    PYSWE_INT("ECL_ANNULAR", SE_ECL_ANNULAR),
+    PYSWE_INT("ECL_PARTIAL", SE_ECL_PARTIAL),
+    PYSWE_INT("ECL_ANNULAR_TOTAL", SE_ECL_ANNULAR_TOTAL),
+    PYSWE_INT("ECL_HYBRID", SE_ECL_HYBRID),
+    PYSWE_INT("ECL_PENUMBRAL", SE_ECL_PENUMBRAL),
+    PYSWE_INT("ECL_ALLTYPES_SOLAR", SE_ECL_ALLTYPES_SOLAR),
+    PYSWE_INT("ECL_ALLTYPES_LUNAR", SE_ECL_ALLTYPES_LUNAR),
+    PYSWE_INT("ECL_VISIBLE", SE_ECL_VISIBLE),
+    PYSWE_INT("ECL_MAX_VISIBLE", SE_ECL_MAX_VISIBLE),
+    PYSWE_INT("ECL_1ST_VISIBLE", SE_ECL_1ST_VISIBLE),
+    PYSWE_INT("ECL_PARTBEG_VISIBLE", SE_ECL_PARTBEG_VISIBLE),
+    PYSWE_INT("ECL_2ND_VISIBLE", SE_ECL_2ND_VISIBLE),
+    PYSWE_INT("ECL_TOTBEG_VISIBLE", SE_ECL_TOTBEG_VISIBLE),
+    PYSWE_INT("ECL_3RD_VISIBLE", SE_ECL_3RD_VISIBLE),
+    PYSWE_INT("ECL_TOTEND_VISIBLE", SE_ECL_TOTEND_VISIBLE),
+    PYSWE_INT("ECL_4TH_VISIBLE", SE_ECL_4TH_VISIBLE),
+    PYSWE_INT("ECL_PARTEND_VISIBLE", SE_ECL_PARTEND_VISIBLE),
+    PYSWE_INT("ECL_PENUMBBEG_VISIBLE", SE_ECL_PENUMBBEG_VISIBLE),
+    PYSWE_INT("ECL_PENUMBEND_VISIBLE", SE_ECL_PENUMBEND_VISIBLE),
+    PYSWE_INT("ECL_OCC_BEG_DAYLIGHT", SE_ECL_OCC_BEG_DAYLIGHT),
+    PYSWE_INT("ECL_OCC_END_DAYLIGHT", SE_ECL_OCC_END_DAYLIGHT),
+    PYSWE_INT("ECL_ONE_TRY", SE_ECL_ONE_TRY),
+
+    PYSWE_INT("CALC_RISE", SE_CALC_RISE),
+    PYSWE_INT("CALC_SET", SE_CALC_SET),
+    PYSWE_INT("CALC_MTRANSIT", SE_CALC_MTRANSIT),
+    PYSWE_INT("CALC_ITRANSIT", SE_CALC_ITRANSIT),
+    PYSWE_INT("BIT_DISC_CENTER", SE_BIT_DISC_CENTER),
+    PYSWE_INT("BIT_DISC_BOTTOM", SE_BIT_DISC_BOTTOM),
+    PYSWE_INT("BIT_NO_REFRACTION", SE_BIT_NO_REFRACTION),
+    PYSWE_INT("BIT_CIVIL_TWILIGHT", SE_BIT_CIVIL_TWILIGHT),
+    PYSWE_INT("BIT_NAUTIC_TWILIGHT", SE_BIT_NAUTIC_TWILIGHT),
+    PYSWE_INT("BIT_ASTRO_TWILIGHT", SE_BIT_ASTRO_TWILIGHT),
+    PYSWE_INT("BIT_FIXED_DISC_SIZE", SE_BIT_FIXED_DISC_SIZE),
+    PYSWE_INT("BIT_FORCE_SLOW_METHOD", SE_BIT_FORCE_SLOW_METHOD),
+    PYSWE_INT("BIT_HINDU_RISING", SE_BIT_HINDU_RISING),
+
+    PYSWE_INT("ECL2HOR", SE_ECL2HOR),
+    PYSWE_INT("EQU2HOR", SE_EQU2HOR),
+    PYSWE_INT("HOR2ECL", SE_HOR2ECL),
+    PYSWE_INT("HOR2EQU", SE_HOR2EQU),
+
+    PYSWE_INT("TRUE_TO_APP", SE_TRUE_TO_APP),
+    PYSWE_INT("APP_TO_TRUE", SE_APP_TO_TRUE),
+
+    PYSWE_INT("DE_NUMBER", SE_DE_NUMBER),
+    PYSWE_STRING("FNAME_DE200", SE_FNAME_DE200),
+    PYSWE_STRING("FNAME_DE403", SE_FNAME_DE403),
+    PYSWE_STRING("FNAME_DE404", SE_FNAME_DE404),
+    PYSWE_STRING("FNAME_DE405", SE_FNAME_DE405),
+    PYSWE_STRING("FNAME_DE406", SE_FNAME_DE406),
+    PYSWE_STRING("SE_FNAME_DE431", SE_FNAME_DE431),
+    PYSWE_STRING("FNAME_DFT", SE_FNAME_DFT),
+    PYSWE_STRING("FNAME_DFT2", SE_FNAME_DFT2),
+    PYSWE_STRING("STARFILE_OLD", SE_STARFILE_OLD),
+    PYSWE_STRING("STARFILE", SE_STARFILE),
+    PYSWE_STRING("ASTNAMFILE", SE_ASTNAMFILE),
+    PYSWE_STRING("FICTFILE", SE_FICTFILE),
+
+    PYSWE_STRING("EPHE_PATH", SE_EPHE_PATH),
+
+    PYSWE_INT("SPLIT_DEG_ROUND_SEC", SE_SPLIT_DEG_ROUND_SEC),
+    PYSWE_INT("SPLIT_DEG_ROUND_MIN", SE_SPLIT_DEG_ROUND_MIN),
+    PYSWE_INT("SPLIT_DEG_ROUND_DEG", SE_SPLIT_DEG_ROUND_DEG),
+    PYSWE_INT("SPLIT_DEG_ZODIACAL", SE_SPLIT_DEG_ZODIACAL),
+    PYSWE_INT("SPLIT_DEG_NAKSHATRA", SE_SPLIT_DEG_NAKSHATRA),
+    PYSWE_INT("SPLIT_DEG_KEEP_SIGN", SE_SPLIT_DEG_KEEP_SIGN),
+    PYSWE_INT("SPLIT_DEG_KEEP_DEG", SE_SPLIT_DEG_KEEP_DEG),
+
+    PYSWE_INT("HELIACAL_RISING", SE_HELIACAL_RISING),
+    PYSWE_INT("HELIACAL_SETTING", SE_HELIACAL_SETTING),
+    PYSWE_INT("EVENING_FIRST", SE_EVENING_FIRST),
+    PYSWE_INT("EVENING_LAST", SE_EVENING_LAST),
+    PYSWE_INT("MORNING_LAST", SE_MORNING_LAST),
+    PYSWE_INT("MORNING_FIRST", SE_MORNING_FIRST),
+    PYSWE_INT("ACRONYCHAL_RISING", SE_ACRONYCHAL_RISING),
+    PYSWE_INT("COSMICAL_SETTING", SE_COSMICAL_SETTING),
+    PYSWE_INT("ACRONYCHAL_SETTING", SE_ACRONYCHAL_SETTING),
+
+    PYSWE_INT("HELFLAG_LONG_SEARCH", SE_HELFLAG_LONG_SEARCH),
+    PYSWE_INT("HELFLAG_HIGH_PRECISION", SE_HELFLAG_HIGH_PRECISION),
+    PYSWE_INT("HELFLAG_OPTICAL_PARAMS", SE_HELFLAG_OPTICAL_PARAMS),
+    PYSWE_INT("HELFLAG_NO_DETAILS", SE_HELFLAG_NO_DETAILS),
+    PYSWE_INT("HELFLAG_SEARCH_1_PERIOD", SE_HELFLAG_SEARCH_1_PERIOD),
+    PYSWE_INT("HELFLAG_VISLIM_DARK", SE_HELFLAG_VISLIM_DARK),
+    PYSWE_INT("HELFLAG_VISLIM_NOMOON", SE_HELFLAG_VISLIM_NOMOON),
+    PYSWE_INT("HELFLAG_VISLIM_PHOTOPIC", SE_HELFLAG_VISLIM_PHOTOPIC),
+    PYSWE_INT("HELFLAG_AV", SE_HELFLAG_AV),
+    PYSWE_INT("HELFLAG_AVKIND_VR", SE_HELFLAG_AVKIND_VR),
+    PYSWE_INT("HELFLAG_AVKIND_PTO", SE_HELFLAG_AVKIND_PTO),
+    PYSWE_INT("HELFLAG_AVKIND_MIN7", SE_HELFLAG_AVKIND_MIN7),
+    PYSWE_INT("HELFLAG_AVKIND_MIN9", SE_HELFLAG_AVKIND_MIN9),
+    PYSWE_INT("HELFLAG_AVKIND", SE_HELFLAG_AVKIND),
+    PYSWE_FLOAT("TJD_INVALID", TJD_INVALID),
+    PYSWE_INT("SIMULATE_VICTORVB", SIMULATE_VICTORVB),
 #if 0 /* Unused */
-    PyModule_AddIntConstant(m, "HELIACAL_LONG_SEARCH", SE_HELIACAL_LONG_SEARCH);
-    PyModule_AddIntConstant(m, "HELIACAL_HIGH_PRECISION", SE_HELIACAL_HIGH_PRECISION);
-    PyModule_AddIntConstant(m, "HELIACAL_OPTICAL_PARAMS", SE_HELIACAL_OPTICAL_PARAMS);
-    PyModule_AddIntConstant(m, "HELIACAL_NO_DETAILS", SE_HELIACAL_NO_DETAILS);
-    PyModule_AddIntConstant(m, "HELIACAL_SEARCH_1_PERIOD", SE_HELIACAL_SEARCH_1_PERIOD);
-    PyModule_AddIntConstant(m, "HELIACAL_VISLIM_DARK", SE_HELIACAL_VISLIM_DARK);
-    PyModule_AddIntConstant(m, "HELIACAL_VISLIM_NOMOON", SE_HELIACAL_VISLIM_NOMOON);
-    PyModule_AddIntConstant(m, "HELIACAL_VISLIM_PHOTOPIC", SE_HELIACAL_VISLIM_PHOTOPIC);
-    PyModule_AddIntConstant(m, "HELIACAL_AVKIND_VR", SE_HELIACAL_AVKIND_VR);
-    PyModule_AddIntConstant(m, "HELIACAL_AVKIND_PTO", SE_HELIACAL_AVKIND_PTO);
-    PyModule_AddIntConstant(m, "HELIACAL_AVKIND_MIN7", SE_HELIACAL_AVKIND_MIN7);
-    PyModule_AddIntConstant(m, "HELIACAL_AVKIND_MIN9", SE_HELIACAL_AVKIND_MIN9);
-    PyModule_AddIntConstant(m, "HELIACAL_AVKIND", SE_HELIACAL_AVKIND);
+    PYSWE_INT("HELIACAL_LONG_SEARCH", SE_HELIACAL_LONG_SEARCH),
+    PYSWE_INT("HELIACAL_HIGH_PRECISION", SE_HELIACAL_HIGH_PRECISION),
+    PYSWE_INT("HELIACAL_OPTICAL_PARAMS", SE_HELIACAL_OPTICAL_PARAMS),
+    PYSWE_INT("HELIACAL_NO_DETAILS", SE_HELIACAL_NO_DETAILS),
+    PYSWE_INT("HELIACAL_SEARCH_1_PERIOD", SE_HELIACAL_SEARCH_1_PERIOD),
+    PYSWE_INT("HELIACAL_VISLIM_DARK", SE_HELIACAL_VISLIM_DARK),
+    PYSWE_INT("HELIACAL_VISLIM_NOMOON", SE_HELIACAL_VISLIM_NOMOON),
+    PYSWE_INT("HELIACAL_VISLIM_PHOTOPIC", SE_HELIACAL_VISLIM_PHOTOPIC),
+    PYSWE_INT("HELIACAL_AVKIND_VR", SE_HELIACAL_AVKIND_VR),
+    PYSWE_INT("HELIACAL_AVKIND_PTO", SE_HELIACAL_AVKIND_PTO),
+    PYSWE_INT("HELIACAL_AVKIND_MIN7", SE_HELIACAL_AVKIND_MIN7),
+    PYSWE_INT("HELIACAL_AVKIND_MIN9", SE_HELIACAL_AVKIND_MIN9),
+    PYSWE_INT("HELIACAL_AVKIND", SE_HELIACAL_AVKIND),
 #endif
-    PyModule_AddIntConstant(m, "PHOTOPIC_FLAG", SE_PHOTOPIC_FLAG);
-    PyModule_AddIntConstant(m, "SCOTOPIC_FLAG", SE_SCOTOPIC_FLAG);
-    PyModule_AddIntConstant(m, "MIXEDOPIC_FLAG", SE_MIXEDOPIC_FLAG);
-
-    PyModule_AddFloatConstant(m, "TIDAL_DE200", SE_TIDAL_DE200);
-    PyModule_AddFloatConstant(m, "TIDAL_DE403", SE_TIDAL_DE403);
-    PyModule_AddFloatConstant(m, "TIDAL_DE404", SE_TIDAL_DE404);
-    PyModule_AddFloatConstant(m, "TIDAL_DE405", SE_TIDAL_DE405);
-    PyModule_AddFloatConstant(m, "TIDAL_DE406", SE_TIDAL_DE406);
-    PyModule_AddFloatConstant(m, "TIDAL_DE421", SE_TIDAL_DE421);
-    PyModule_AddFloatConstant(m, "TIDAL_DE422", SE_TIDAL_DE422);
-    PyModule_AddFloatConstant(m, "TIDAL_DE430", SE_TIDAL_DE430);
-    PyModule_AddFloatConstant(m, "TIDAL_DE431", SE_TIDAL_DE431);
-    PyModule_AddFloatConstant(m, "TIDAL_DE441", SE_TIDAL_DE441);
-    PyModule_AddFloatConstant(m, "TIDAL_26", SE_TIDAL_26);
-    PyModule_AddFloatConstant(m, "TIDAL_STEPHENSON_2016", SE_TIDAL_STEPHENSON_2016);
-    PyModule_AddFloatConstant(m, "TIDAL_DEFAULT", SE_TIDAL_DEFAULT);
-    PyModule_AddIntConstant(m, "TIDAL_AUTOMATIC", SE_TIDAL_AUTOMATIC);
-    PyModule_AddFloatConstant(m, "TIDAL_MOSEPH", SE_TIDAL_MOSEPH);
-    PyModule_AddFloatConstant(m, "TIDAL_SWIEPH", SE_TIDAL_SWIEPH);
-    PyModule_AddFloatConstant(m, "TIDAL_JPLEPH", SE_TIDAL_JPLEPH);
-
-    PyModule_AddFloatConstant(m, "DELTAT_AUTOMATIC", SE_DELTAT_AUTOMATIC);
-    PyModule_AddIntConstant(m, "MODEL_DELTAT", SE_MODEL_DELTAT);
-    PyModule_AddIntConstant(m, "MODEL_PREC_LONGTERM", SE_MODEL_PREC_LONGTERM);
-    PyModule_AddIntConstant(m, "MODEL_PREC_SHORTTERM", SE_MODEL_PREC_SHORTTERM);
-    PyModule_AddIntConstant(m, "MODEL_NUT", SE_MODEL_NUT);
-    PyModule_AddIntConstant(m, "MODEL_BIAS", SE_MODEL_BIAS);
-    PyModule_AddIntConstant(m, "MODEL_JPLHOR_MODE", SE_MODEL_JPLHOR_MODE);
-    PyModule_AddIntConstant(m, "MODEL_JPLHORA_MODE", SE_MODEL_JPLHORA_MODE);
-    PyModule_AddIntConstant(m, "MODEL_SIDT", SE_MODEL_SIDT);
-    PyModule_AddIntConstant(m, "NSE_MODELS", NSE_MODELS);
-
-    PyModule_AddIntConstant(m, "MOD_NPREC", SEMOD_NPREC);
-    PyModule_AddIntConstant(m, "MOD_PREC_IAU_1976", SEMOD_PREC_IAU_1976);
-    PyModule_AddIntConstant(m, "MOD_PREC_LASKAR_1986", SEMOD_PREC_LASKAR_1986);
-    PyModule_AddIntConstant(m, "MOD_PREC_WILL_EPS_LASK", SEMOD_PREC_WILL_EPS_LASK);
-    PyModule_AddIntConstant(m, "MOD_PREC_WILLIAMS_1994",SEMOD_PREC_WILLIAMS_1994);
-    PyModule_AddIntConstant(m, "MOD_PREC_SIMON_1994",SEMOD_PREC_SIMON_1994);
-    PyModule_AddIntConstant(m, "MOD_PREC_IAU_2000", SEMOD_PREC_IAU_2000);
-    PyModule_AddIntConstant(m, "MOD_PREC_BRETAGNON_2003", SEMOD_PREC_BRETAGNON_2003);
-    PyModule_AddIntConstant(m, "MOD_PREC_IAU_2006", SEMOD_PREC_IAU_2006);
-    PyModule_AddIntConstant(m, "MOD_PREC_VONDRAK_2011", SEMOD_PREC_VONDRAK_2011);
-    PyModule_AddIntConstant(m, "MOD_PREC_OWEN_1990", SEMOD_PREC_OWEN_1990);
-    PyModule_AddIntConstant(m, "MOD_PREC_NEWCOMB", SEMOD_PREC_NEWCOMB);
-    PyModule_AddIntConstant(m, "MOD_PREC_DEFAULT", SEMOD_PREC_DEFAULT);
-    PyModule_AddIntConstant(m, "MOD_PREC_DEFAULT_SHORT", SEMOD_PREC_DEFAULT_SHORT);
-
-    PyModule_AddIntConstant(m, "MOD_NNUT", SEMOD_NNUT);
-    PyModule_AddIntConstant(m, "MOD_NUT_IAU_1980", SEMOD_NUT_IAU_1980);
-    PyModule_AddIntConstant(m, "MOD_NUT_IAU_CORR_1987", SEMOD_NUT_IAU_CORR_1987);
-    PyModule_AddIntConstant(m, "MOD_NUT_IAU_2000A", SEMOD_NUT_IAU_2000A);
-    PyModule_AddIntConstant(m, "MOD_NUT_IAU_2000B", SEMOD_NUT_IAU_2000B);
-    PyModule_AddIntConstant(m, "MOD_NUT_WOOLARD", SEMOD_NUT_WOOLARD);
-    PyModule_AddIntConstant(m, "MOD_NUT_DEFAULT", SEMOD_NUT_DEFAULT);
-
-    PyModule_AddIntConstant(m, "MOD_NBIAS", SEMOD_NBIAS);
-    PyModule_AddIntConstant(m, "MOD_BIAS_NONE", SEMOD_BIAS_NONE);
-    PyModule_AddIntConstant(m, "MOD_BIAS_IAU2000", SEMOD_BIAS_IAU2000);
-    PyModule_AddIntConstant(m, "MOD_BIAS_IAU2006", SEMOD_BIAS_IAU2006);
-    PyModule_AddIntConstant(m, "MOD_BIAS_DEFAULT", SEMOD_BIAS_DEFAULT);
-
-    PyModule_AddIntConstant(m, "MOD_NJPLHOR", SEMOD_NJPLHOR);
-    PyModule_AddIntConstant(m, "MOD_JPLHOR_LONG_AGREEMENT", SEMOD_JPLHOR_LONG_AGREEMENT);
-    PyModule_AddIntConstant(m, "MOD_JPLHOR_DEFAULT", SEMOD_JPLHOR_DEFAULT);
-    PyModule_AddIntConstant(m, "MOD_NJPLHORA", SEMOD_NJPLHORA);
-    PyModule_AddIntConstant(m, "MOD_JPLHORA_1", SEMOD_JPLHORA_1);
-    PyModule_AddIntConstant(m, "MOD_JPLHORA_2", SEMOD_JPLHORA_2);
-    PyModule_AddIntConstant(m, "MOD_JPLHORA_3", SEMOD_JPLHORA_3);
-    PyModule_AddIntConstant(m, "MOD_JPLHORA_DEFAULT", SEMOD_JPLHORA_DEFAULT);
-
-    PyModule_AddIntConstant(m, "MOD_NDELTAT", SEMOD_NDELTAT);
-    PyModule_AddIntConstant(m, "MOD_DELTAT_STEPHENSON_MORRISON_1984", SEMOD_DELTAT_STEPHENSON_MORRISON_1984);
-    PyModule_AddIntConstant(m, "MOD_DELTAT_STEPHENSON_1997", SEMOD_DELTAT_STEPHENSON_1997);
-    PyModule_AddIntConstant(m, "MOD_DELTAT_STEPHENSON_MORRISON_2004", SEMOD_DELTAT_STEPHENSON_MORRISON_2004);
-    PyModule_AddIntConstant(m, "MOD_DELTAT_ESPENAK_MEEUS_2006", SEMOD_DELTAT_ESPENAK_MEEUS_2006);
-    PyModule_AddIntConstant(m, "MOD_DELTAT_STEPHENSON_ETC_2016", SEMOD_DELTAT_STEPHENSON_ETC_2016);
-    PyModule_AddIntConstant(m, "MOD_DELTAT_DEFAULT", SEMOD_DELTAT_DEFAULT);
-
-    /* Swephelp module */
+    PYSWE_INT("PHOTOPIC_FLAG", SE_PHOTOPIC_FLAG),
+    PYSWE_INT("SCOTOPIC_FLAG", SE_SCOTOPIC_FLAG),
+    PYSWE_INT("MIXEDOPIC_FLAG", SE_MIXEDOPIC_FLAG),
+
+    PYSWE_FLOAT("TIDAL_DE200", SE_TIDAL_DE200),
+    PYSWE_FLOAT("TIDAL_DE403", SE_TIDAL_DE403),
+    PYSWE_FLOAT("TIDAL_DE404", SE_TIDAL_DE404),
+    PYSWE_FLOAT("TIDAL_DE405", SE_TIDAL_DE405),
+    PYSWE_FLOAT("TIDAL_DE406", SE_TIDAL_DE406),
+    PYSWE_FLOAT("TIDAL_DE421", SE_TIDAL_DE421),
+    PYSWE_FLOAT("TIDAL_DE422", SE_TIDAL_DE422),
+    PYSWE_FLOAT("TIDAL_DE430", SE_TIDAL_DE430),
+    PYSWE_FLOAT("TIDAL_DE431", SE_TIDAL_DE431),
+    PYSWE_FLOAT("TIDAL_DE441", SE_TIDAL_DE441),
+    PYSWE_FLOAT("TIDAL_26", SE_TIDAL_26),
+    PYSWE_FLOAT("TIDAL_STEPHENSON_2016", SE_TIDAL_STEPHENSON_2016),
+    PYSWE_FLOAT("TIDAL_DEFAULT", SE_TIDAL_DEFAULT),
+    PYSWE_INT("TIDAL_AUTOMATIC", SE_TIDAL_AUTOMATIC),
+    PYSWE_FLOAT("TIDAL_MOSEPH", SE_TIDAL_MOSEPH),
+    PYSWE_FLOAT("TIDAL_SWIEPH", SE_TIDAL_SWIEPH),
+    PYSWE_FLOAT("TIDAL_JPLEPH", SE_TIDAL_JPLEPH),
+
+    PYSWE_FLOAT("DELTAT_AUTOMATIC", SE_DELTAT_AUTOMATIC),
+    PYSWE_INT("MODEL_DELTAT", SE_MODEL_DELTAT),
+    PYSWE_INT("MODEL_PREC_LONGTERM", SE_MODEL_PREC_LONGTERM),
+    PYSWE_INT("MODEL_PREC_SHORTTERM", SE_MODEL_PREC_SHORTTERM),
+    PYSWE_INT("MODEL_NUT", SE_MODEL_NUT),
+    PYSWE_INT("MODEL_BIAS", SE_MODEL_BIAS),
+    PYSWE_INT("MODEL_JPLHOR_MODE", SE_MODEL_JPLHOR_MODE),
+    PYSWE_INT("MODEL_JPLHORA_MODE", SE_MODEL_JPLHORA_MODE),
+    PYSWE_INT("MODEL_SIDT", SE_MODEL_SIDT),
+    PYSWE_INT("NSE_MODELS", NSE_MODELS),
+
+    PYSWE_INT("MOD_NPREC", SEMOD_NPREC),
+    PYSWE_INT("MOD_PREC_IAU_1976", SEMOD_PREC_IAU_1976),
+    PYSWE_INT("MOD_PREC_LASKAR_1986", SEMOD_PREC_LASKAR_1986),
+    PYSWE_INT("MOD_PREC_WILL_EPS_LASK", SEMOD_PREC_WILL_EPS_LASK),
+    PYSWE_INT("MOD_PREC_WILLIAMS_1994", SEMOD_PREC_WILLIAMS_1994),
+    PYSWE_INT("MOD_PREC_SIMON_1994", SEMOD_PREC_SIMON_1994),
+    PYSWE_INT("MOD_PREC_IAU_2000", SEMOD_PREC_IAU_2000),
+    PYSWE_INT("MOD_PREC_BRETAGNON_2003", SEMOD_PREC_BRETAGNON_2003),
+    PYSWE_INT("MOD_PREC_IAU_2006", SEMOD_PREC_IAU_2006),
+    PYSWE_INT("MOD_PREC_VONDRAK_2011", SEMOD_PREC_VONDRAK_2011),
+    PYSWE_INT("MOD_PREC_OWEN_1990", SEMOD_PREC_OWEN_1990),
+    PYSWE_INT("MOD_PREC_NEWCOMB", SEMOD_PREC_NEWCOMB),
+    PYSWE_INT("MOD_PREC_DEFAULT", SEMOD_PREC_DEFAULT),
+    PYSWE_INT("MOD_PREC_DEFAULT_SHORT", SEMOD_PREC_DEFAULT_SHORT),
+
+    PYSWE_INT("MOD_NNUT", SEMOD_NNUT),
+    PYSWE_INT("MOD_NUT_IAU_1980", SEMOD_NUT_IAU_1980),
+    PYSWE_INT("MOD_NUT_IAU_CORR_1987", SEMOD_NUT_IAU_CORR_1987),
+    PYSWE_INT("MOD_NUT_IAU_2000A", SEMOD_NUT_IAU_2000A),
+    PYSWE_INT("MOD_NUT_IAU_2000B", SEMOD_NUT_IAU_2000B),
+    PYSWE_INT("MOD_NUT_WOOLARD", SEMOD_NUT_WOOLARD),
+    PYSWE_INT("MOD_NUT_DEFAULT", SEMOD_NUT_DEFAULT),
+
+    PYSWE_INT("MOD_NBIAS", SEMOD_NBIAS),
+    PYSWE_INT("MOD_BIAS_NONE", SEMOD_BIAS_NONE),
+    PYSWE_INT("MOD_BIAS_IAU2000", SEMOD_BIAS_IAU2000),
+    PYSWE_INT("MOD_BIAS_IAU2006", SEMOD_BIAS_IAU2006),
+    PYSWE_INT("MOD_BIAS_DEFAULT", SEMOD_BIAS_DEFAULT),
+
+    PYSWE_INT("MOD_NJPLHOR", SEMOD_NJPLHOR),
+    PYSWE_INT("MOD_JPLHOR_LONG_AGREEMENT", SEMOD_JPLHOR_LONG_AGREEMENT),
+    PYSWE_INT("MOD_JPLHOR_DEFAULT", SEMOD_JPLHOR_DEFAULT),
+    PYSWE_INT("MOD_NJPLHORA", SEMOD_NJPLHORA),
+    PYSWE_INT("MOD_JPLHORA_1", SEMOD_JPLHORA_1),
+    PYSWE_INT("MOD_JPLHORA_2", SEMOD_JPLHORA_2),
+    PYSWE_INT("MOD_JPLHORA_3", SEMOD_JPLHORA_3),
+    PYSWE_INT("MOD_JPLHORA_DEFAULT", SEMOD_JPLHORA_DEFAULT),
+
+    PYSWE_INT("MOD_NDELTAT", SEMOD_NDELTAT),
+    PYSWE_INT("MOD_DELTAT_STEPHENSON_MORRISON_1984", SEMOD_DELTAT_STEPHENSON_MORRISON_1984),
+    PYSWE_INT("MOD_DELTAT_STEPHENSON_1997", SEMOD_DELTAT_STEPHENSON_1997),
+    PYSWE_INT("MOD_DELTAT_STEPHENSON_MORRISON_2004", SEMOD_DELTAT_STEPHENSON_MORRISON_2004),
+    PYSWE_INT("MOD_DELTAT_ESPENAK_MEEUS_2006", SEMOD_DELTAT_ESPENAK_MEEUS_2006),
+    PYSWE_INT("MOD_DELTAT_STEPHENSON_ETC_2016", SEMOD_DELTAT_STEPHENSON_ETC_2016),
+    PYSWE_INT("MOD_DELTAT_DEFAULT", SEMOD_DELTAT_DEFAULT),
+    {NULL, 0, 0, 0, NULL}
+};
+
+static PyObject * pyswe_constant_value(const pyswe_Constant* k)
+{
+    switch (k->type) {
+    case 'i':
+        return PyLong_FromLong(k->i);
+    case 'd':
+        return PyFloat_FromDouble(k->d);
+    default:
+        return PyUnicode_FromString(k->s);
+    }
+}
+
+/* Add a constant to the module
+ * Return a new reference to its value, or NULL with an exception set.
+ */
+static PyObject * pyswe_constant_add(PyObject* m, const pyswe_Constant* k)
+{
+    PyObject *o = pyswe_constant_value(k);
+    if (o) {
+        Py_INCREF(o);
+        if (PyModule_AddObject(m, k->name, o) < 0) {
+            Py_DECREF(o);
+            Py_CLEAR(o);
+        }
+    }
+    return o;
+}
+
 #if PYSWE_USE_SWEPHELP
-#if PY_MAJOR_VERSION >= 3
+/* Create swisseph.contrib, on first access
+ * Return a new reference, or NULL with an exception set.
+ */
+static PyObject * pyswh_create(PyObject* m)
+{
+    pyswe_State* st = pyswe_get_state(m);
+    PyObject *m2;
+
+    /* left by a previous attempt that failed */
+    Py_CLEAR(st->contrib_error);
+    Py_CLEAR(st->user_type);
+    Py_CLEAR(st->data_type);
+    Py_CLEAR(st->place_type);
+    Py_CLEAR(st->atlas_index_type);
+
     m2 = PyModule_Create(&pyswh_module);
     if (m2 == NULL)
-        Py_FatalError("Can't create module swisseph.contrib!");
-#elif PY_MAJOR_VERSION < 3
-    m2 = Py_InitModule4("swisseph.contrib", pyswh_methods,
-        pyswh_module_documentation,
-        (PyObject*) NULL, PYTHON_API_VERSION);
+        return NULL;
+    Py_INCREF(m);
+    ((pyswh_State*) PyModule_GetState(m2))->parent = m;
+#if defined(Py_GIL_DISABLED) && PYSWE_SWE_TLS
+    PyUnstable_Module_SetGIL(m2, Py_MOD_GIL_NOT_USED);
 #endif
 
     /* Initialize exception */
-    pyswh_Error = PyErr_NewException("swisseph.contrib.Error", NULL, NULL);
-    Py_INCREF(pyswh_Error);
-    PyModule_AddObject(m2, "Error", pyswh_Error);
-
-    /* Initialize types */
+    st->contrib_error = PyErr_NewException("swisseph.contrib.Error", NULL,
+                                           NULL);
+    if (!st->contrib_error) {
+        Py_DECREF(m2);
+        return NULL;
+    }
+    Py_INCREF(st->contrib_error);
+    PyModule_AddObject(m2, "Error", st->contrib_error);
 
-    if (PyType_Ready(&pyswh_User_type) < 0)
-        Py_FatalError("User type not ready!");
-    Py_INCREF(&pyswh_User_type);
-    PyModule_AddObject(m2, "User", (PyObject*) &pyswh_User_type);
+    /* Initialize types (of swisseph, for their state) */
 
-    if (PyType_Ready(&pyswh_Data_type) < 0)
-        Py_FatalError("Data type not ready!");
-    Py_INCREF(&pyswh_Data_type);
-    PyModule_AddObject(m2, "Data", (PyObject*) &pyswh_Data_type);
+    if (!(st->user_type = pyswe_new_type(m, &pyswh_User_spec))
+        || !(st->data_type = pyswe_new_type(m, &pyswh_Data_spec))) {
+        Py_DECREF(m2);
+        return NULL;
+    }
+    Py_INCREF(st->user_type);
+    PyModule_AddObject(m2, "User", (PyObject*) st->user_type);
+    Py_INCREF(st->data_type);
+    PyModule_AddObject(m2, "Data", (PyObject*) st->data_type);
+    if (!(st->atlas_index_type = pyswe_new_type(m, &pyswh_AtlasIndex_spec))
+        || !(st->place_type = pyswh_new_place_type())) {
+        Py_DECREF(m2);
+        return NULL;
+    }
+    Py_INCREF(st->atlas_index_type);
+    PyModule_AddObject(m2, "AtlasIndex", (PyObject*) st->atlas_index_type);
+    Py_INCREF(st->place_type);
+    PyModule_AddObject(m2, "AtlasPlace", (PyObject*) st->place_type);
 
     /* *** Additional constants -- not swiss ephemeris ***/
 
@@ -6400,23 +14435,317 @@ PyMODINIT_FUNC initswisseph(void)
     PyModule_AddIntConstant(m2, "UTTARABHADRA", SWH_UTTARABHADRA);
     PyModule_AddIntConstant(m2, "REVATHI", SWH_REVATHI);
 
-    PyModule_AddObject(m, "contrib", m2);
+    return m2;
+}
+#endif /* PYSWE_USE_SWEPHELP */
+
+#if PYSWE_LAZY_ATTRS
+#if PYSWE_USE_SWEPHELP
+/* Get swisseph.contrib, created on first access
+ * Return a new reference, or NULL with an exception set.
+ */
+static PyObject * pyswh_get(PyObject* m)
+{
+    PyObject *m2;
+    Py_BEGIN_CRITICAL_SECTION(m);
+    /* created meanwhile by another thread */
+    m2 = PyDict_GetItemString(PyModule_GetDict(m), "contrib");
+    if (m2)
+        Py_INCREF(m2);
+    else if ((m2 = pyswh_create(m))) {
+        Py_INCREF(m2);
+        if (PyModule_AddObject(m, "contrib", m2) < 0) {
+            Py_DECREF(m2);
+            Py_CLEAR(m2);
+        }
+        /* for call statistics already enabled */
+        else if (pyswe_get_state(m)->stats_registry
+                 && pyswe_stats_update(m))
+            Py_CLEAR(m2);
+    }
+    Py_END_CRITICAL_SECTION();
+    return m2;
+}
 #endif /* PYSWE_USE_SWEPHELP */
 
+/* Names of the module, including the ones not created yet
+ * Return a new list, without the private names if public.
+ */
+static PyObject * pyswe_names(PyObject* m, int public)
+{
+    Py_ssize_t pos = 0;
+    PyObject *dict = PyModule_GetDict(m), *key, *o, *lst = PyList_New(0);
+    const pyswe_Constant* k;
+    if (!lst)
+        return NULL;
+    while (PyDict_Next(dict, &pos, &key, &o)) {
+        if (public && PyUnicode_Check(key)
+            && PyUnicode_READ_CHAR(key, 0) == '_')
+            continue;
+        if (PyList_Append(lst, key))
+            goto error;
+    }
+    for (k = pyswe_constants; k->name; ++k) {
+        if (PyDict_GetItemString(dict, k->name))
+            continue;
+        if (!(o = PyUnicode_FromString(k->name)) || PyList_Append(lst, o)) {
+            Py_XDECREF(o);
+            goto error;
+        }
+        Py_DECREF(o);
+    }
+#if PYSWE_USE_SWEPHELP
+    if (!PyDict_GetItemString(dict, "contrib")) {
+        if (!(o = PyUnicode_FromString("contrib")) || PyList_Append(lst, o)) {
+            Py_XDECREF(o);
+            goto error;
+        }
+        Py_DECREF(o);
+    }
+#endif
+    return lst;
+error:
+    Py_DECREF(lst);
+    return NULL;
+}
+
+/* swisseph.__getattr__ (PEP 562), for attributes not found in the module */
+static PyObject * pyswe___getattr__(PyObject* self, PyObject* name)
+{
+    const char* s = PyUnicode_Check(name) ? PyUnicode_AsUTF8(name) : NULL;
+    const pyswe_Constant* k;
+    if (!s) {
+        if (!PyErr_Occurred())
+            PyErr_SetObject(PyExc_AttributeError, name);
+        return NULL;
+    }
+    /* for "from swisseph import *" */
+    if (!strcmp(s, "__all__"))
+        return pyswe_names(self, 1);
+#if PYSWE_USE_SWEPHELP
+    if (!strcmp(s, "contrib"))
+        return pyswh_get(self);
+#endif
+    for (k = pyswe_constants; k->name; ++k) {
+        if (*k->name == *s && !strcmp(k->name, s))
+            return pyswe_constant_add(self, k);
+    }
+    return PyErr_Format(PyExc_AttributeError,
+                        "module 'swisseph' has no attribute '%s'", s);
+}
+
+/* swisseph.__dir__ */
+static PyObject * pyswe___dir__ FUNCARGS_SELF
+{
+    return pyswe_names(self, 0);
+}
+#endif /* PYSWE_LAZY_ATTRS */
+
+#ifndef WIN32
+/* Fork handlers
+ *
+ * A thread of the pool (or any other) can hold a process wide lock when
+ * another thread forks, and the child would wait for it forever. The locks
+ * are taken before the fork and released after, in the parent and in the
+ * child. pyswh_db_lock is held while waiting for the GIL (PYSWH_DB_CALL),
+ * so it is reinitialized in the child instead. Threads do not survive the
+ * fork: the child starts without workers, and without the read connections
+ * of the parent.
+ */
+static void pyswe_atfork_prepare(void)
+{
+    pyswe_lock(&pyswe_pool.lock);
+#if PYSWE_USE_MMAP
+    pyswe_lock(&pyswe_mapped_lock);
+#endif
+#if PYSWE_USE_IO_STATS
+    pyswe_lock(&pyswe_io_lock);
+#endif
+    pyswe_lock(&pyswe_table_lock);
+#if PYSWE_USE_SWEPHELP
+    pyswe_lock(&pyswh_pool.lock);
+#endif
+}
+
+static void pyswe_atfork_parent(void)
+{
+#if PYSWE_USE_SWEPHELP
+    pyswe_unlock(&pyswh_pool.lock);
+#endif
+    pyswe_unlock(&pyswe_table_lock);
+#if PYSWE_USE_IO_STATS
+    pyswe_unlock(&pyswe_io_lock);
+#endif
+#if PYSWE_USE_MMAP
+    pyswe_unlock(&pyswe_mapped_lock);
+#endif
+    pyswe_unlock(&pyswe_pool.lock);
+}
+
+static void pyswe_atfork_child(void)
+{
+#if PYSWE_USE_SWEPHELP
+    /* connections opened by the parent are not used (nor closed) */
+    pyswh_pool.nidle = 0;
+    ++pyswh_pool.gen;
+    pthread_mutex_init(&pyswh_db_lock, NULL);
+#endif
+    pthread_cond_init(&pyswe_pool.work, NULL);
+    pthread_cond_init(&pyswe_pool.done, NULL);
+    pyswe_pool.queue = NULL;
+    pyswe_pool.nworkers = 0;
+    pyswe_pool.pending = 0;
+    pyswe_atfork_parent();
+}
+#endif
+
+/* Execute the module (PEP 489), once per interpreter
+ * Return -1 on error
+ */
+static int pyswe_exec(PyObject* m)
+{
+    pyswe_State* st = pyswe_get_state(m);
+#if PYSWE_USE_SWEPHELP && !PYSWE_LAZY_ATTRS
+    PyObject *m2;
+#endif
+#if !PYSWE_LAZY_ATTRS
+    const pyswe_Constant* k;
+    PyObject *o;
+#endif
+    char buf[256]; /* for swe_version */
+    const char* env;
+
+    memset(buf, 0, sizeof(char) * 256);
+#if PY_VERSION_HEX < 0x03090000
+    pyswe_last_state = st;
+#endif
+
+    /* The C API follows the settings of the first importing thread */
+    pyswe_lock(&pyswe_pool.lock);
+    if (!pyswe_settings_main_thread) {
+        pyswe_settings_main_thread = PyThread_get_thread_ident();
+#ifndef WIN32
+        pthread_atfork(pyswe_atfork_prepare, pyswe_atfork_parent,
+                       pyswe_atfork_child);
+#endif
+    }
+    pyswe_unlock(&pyswe_pool.lock);
+
+    /* Initialize exception */
+    st->error = PyErr_NewException("swisseph.Error", NULL, NULL);
+    if (!st->error)
+        return -1;
+    Py_INCREF(st->error);
+    PyModule_AddObject(m, "Error", st->error);
+
+    /* Initialize types */
+    if (!(st->compact_type = pyswe_new_type(m, &pyswe_CompactEphemeris_spec)))
+        return -1;
+    Py_INCREF(st->compact_type);
+    PyModule_AddObject(m, "CompactEphemeris", (PyObject*) st->compact_type);
+
+    if (!(st->table_type = pyswe_new_type(m, &pyswe_EphemerisTable_spec)))
+        return -1;
+    Py_INCREF(st->table_type);
+    PyModule_AddObject(m, "EphemerisTable", (PyObject*) st->table_type);
+
+    if (pyswe_init_structseq(m, st))
+        return -1;
+
+    if (!(st->timed_type = pyswe_new_type(m, &pyswe_Timed_spec)))
+        return -1;
+
+#if !PYSWE_LAZY_ATTRS
+    /* Constants, no module __getattr__ */
+    for (k = pyswe_constants; k->name; ++k) {
+        if (!(o = pyswe_constant_add(m, k)))
+            return -1;
+        Py_DECREF(o);
+    }
+
+#endif
+#if PYSWE_USE_SWEPHELP && !PYSWE_LAZY_ATTRS
+    /* No module __getattr__, create swisseph.contrib now */
+    if (!(m2 = pyswh_create(m))
+        || PyModule_AddObject(m, "contrib", m2) < 0) {
+        Py_XDECREF(m2);
+        return -1;
+    }
+#endif
+
+    /* C API of the module (pyswisseph.h) */
+    if (PyModule_AddObject(m, "_C_API",
+                           PyCapsule_New(&pyswe_capi,
+                                         PYSWE_CAPI_NAME, NULL)) < 0)
+        return -1;
+
+    /* Submodule swisseph.aio */
+    if (pyswe_aio_create(m))
+        return -1;
+
     PyModule_AddIntConstant(m, "__version__", PYSWISSEPH_VERSION);
     PyModule_AddStringConstant(m, "version", swe_version(buf));
 
+    /* Enable call statistics on import */
+    env = getenv("PYSWE_STATS");
+    if (env && *env && strcmp(env, "0")) {
+        st->stats_enabled = 1;
+        if (pyswe_stats_update(m))
+            return -1;
+    }
+
+    /* Size of the thread pool */
+    env = getenv("PYSWE_NUM_THREADS");
+    if (env && atoi(env) > 0)
+        pyswe_pool_resize(atoi(env));
+
     if (PyErr_Occurred())
-        Py_FatalError("Can't initialize module swisseph!");
+        return -1;
 
 #if PYSWE_AUTO_SET_EPHE_PATH
-    /* Automaticly set ephemeris path on module import */
-    swe_set_ephe_path(PYSWE_DEFAULT_EPHE_PATH);
+    /* Automaticly set ephemeris path, on the first calculation */
+    pyswe_ephe_pending = 1;
+    pyswe_settings_path(PYSWE_DEFAULT_EPHE_PATH);
 #endif /* PYSWE_AUTO_SET_EPHE_PATH */
 
-#if PY_MAJOR_VERSION >= 3
-    return m;
+    return 0;
+}
+
+static PyModuleDef_Slot pyswe_slots[] = {
+    {Py_mod_exec, (void*) pyswe_exec},
+#if PY_VERSION_HEX >= 0x030C0000
+#if PYSWE_SWE_TLS
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#else
+    {Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED},
+#endif
+#endif
+#if PY_VERSION_HEX >= 0x030D0000
+#if PYSWE_SWE_TLS
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#else
+    {Py_mod_gil, Py_MOD_GIL_USED},
 #endif
+#endif
+    {0, NULL}
+};
+
+struct PyModuleDef pyswe_module =
+{
+    PyModuleDef_HEAD_INIT,
+    "swisseph", /* module name */
+    pyswe_module_documentation, /* module docstring */
+    sizeof(pyswe_State), /* size of per-interpreter state of the module */
+    pyswe_methods,
+    pyswe_slots,
+    pyswe_traverse,
+    pyswe_clear,
+    pyswe_free
+};
+
+PyMODINIT_FUNC PyInit_swisseph(void)
+{
+    return PyModuleDef_Init(&pyswe_module);
 }
 
 /* vi: set fenc=utf-8 ff=unix et sw=4 ts=4 sts=4 : */
@@ -0,0 +1,109 @@
+/*
+    This file is part of Pyswisseph.
+
+    Copyright (c) 2007-2023 Stanislas Marquis <stan@astrorigin.com>
+
+    Pyswisseph is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Pyswisseph is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with Pyswisseph.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/**
+ *  \file pyswisseph.h
+ *
+ *  C API of the swisseph module, for other extensions
+ *
+ *  The module exports a capsule (swisseph._C_API) holding a table of
+ *  functions of the libswe linked in the module, with the arguments of the
+ *  libswe functions of the same name. They can be called without the GIL,
+ *  from any thread. With libswe thread local storage, a thread that did not
+ *  set anything with the module computes with the settings (ephemeris path,
+ *  sidereal mode...) of the thread that imported it, made from Python or
+ *  with the setters below. Settings made in other threads are not seen: a
+ *  thread calls the setters itself to use its own. Without thread local
+ *  storage, the calls take the GIL, as libswe is not thread safe.
+ *
+ *  The table is shared by all the users of the module, do not write to it.
+ *
+ *  Usage (the module must have been initialized with Python):
+ *
+ *      PySwe_CAPI* swe = PySwe_Import();
+ *      if (!swe)
+ *          return NULL;
+ *      ...
+ *      Py_BEGIN_ALLOW_THREADS
+ *      ret = swe->calc_ut(jd, 0, 0, xx, serr);
+ *      Py_END_ALLOW_THREADS
+ */
+
+#ifndef PYSWISSEPH_H
+#define PYSWISSEPH_H
+
+#include <Python.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented when functions are added at the end of the table */
+#define PYSWE_CAPI_VERSION  1
+
+#define PYSWE_CAPI_NAME     "swisseph._C_API"
+
+typedef struct {
+    int version; /* PYSWE_CAPI_VERSION of the module */
+    size_t size; /* sizeof(PySwe_CAPI) of the module */
+
+    /* Computations */
+    int (*calc)(double tjd_et, int ipl, int iflag, double* xx, char* serr);
+    int (*calc_ut)(double tjd_ut, int ipl, int iflag, double* xx,
+                   char* serr);
+    int (*fixstar2_ut)(char* star, double tjd_ut, int iflag, double* xx,
+                       char* serr);
+    int (*houses_ex2)(double tjd_ut, int iflag, double geolat, double geolon,
+                      int hsys, double* cusps, double* ascmc,
+                      double* cusp_speed, double* ascmc_speed, char* serr);
+    int (*get_ayanamsa_ex_ut)(double tjd_ut, int iflag, double* daya,
+                              char* serr);
+    double (*deltat_ex)(double tjd, int iflag, char* serr);
+    double (*sidtime)(double tjd_ut);
+    double (*julday)(int year, int month, int day, double hour,
+                     int gregflag);
+    void (*revjul)(double jd, int gregflag, int* year, int* month, int* day,
+                   double* hour);
+
+    /* Settings, seen by the module as if made from Python */
+    void (*set_ephe_path)(const char* path);
+    void (*set_sid_mode)(int sid_mode, double t0, double ayan_t0);
+    void (*set_topo)(double geolon, double geolat, double altitude);
+} PySwe_CAPI;
+
+/* Import the module and get its C API
+ * Return NULL with an exception set if not found, or too old.
+ */
+static inline PySwe_CAPI* PySwe_Import(void)
+{
+    PySwe_CAPI* api = (PySwe_CAPI*) PyCapsule_Import(PYSWE_CAPI_NAME, 0);
+    if (api && api->version < PYSWE_CAPI_VERSION) {
+        PyErr_Format(PyExc_ImportError, "%s: version %d, %d needed",
+                     PYSWE_CAPI_NAME, api->version, PYSWE_CAPI_VERSION);
+        return NULL;
+    }
+    return api;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PYSWISSEPH_H */
@@ -174,7 +174,14 @@ if not libswe_found: # using internal libswe
         'libswe/swephexp.h',
         'libswe/swephlib.h']
     swe_libs = []
-    swe_defines = []
+    swe_defines = [('PYSWE_BUNDLED_LIBSWE', 1)]
+
+# Ephemeris file I/O statistics (io_stats)
+# Needs the internal libswe and GNU ld.
+if not libswe_found and sys.platform.startswith('linux'):
+    swe_defines += [('PYSWE_USE_IO_STATS', 1)]
+    ldflags.append('-Wl,--wrap=fopen,--wrap=fclose,--wrap=fread,'
+                   '--wrap=fseek,--wrap=fseeko,--wrap=fgets')
 
 # Find sqlite3
 sqlite3_found = False
@@ -241,7 +248,7 @@ if use_swephelp:
     sources += sqlite3_sources
 
 # Depends
-depends = swe_depends
+depends = swe_depends + ['pyswisseph.h']
 if use_swephelp:
     depends += glob('swephelp/*.h')
     depends += glob('swephelp/*.hpp')
@@ -289,6 +296,7 @@ setup(
         ],
     keywords = 'Astrology Ephemeris Swisseph',
     ext_modules = [swemodule],
+    headers = ['pyswisseph.h'],
     setup_requires = ['wheel'],
     python_requires = '>=3.5',
     test_suite = 'tests'
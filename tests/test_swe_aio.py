@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import asyncio
+import swisseph as swe
+import unittest
+
+JD = 2451545.0
+GEOPOS = (6.6, 46.5, 400)
+FLAGS = swe.FLG_MOSEPH
+
+class TestSweAio(unittest.TestCase):
+
+    def test_01(self):
+        dates = [JD + i * 100 for i in range(4)]
+        expected = [swe.sol_eclipse_when_loc(jd, GEOPOS, FLAGS)
+                    for jd in dates]
+        async def main():
+            return await asyncio.gather(*[
+                swe.aio.sol_eclipse_when_loc(jd, GEOPOS, FLAGS)
+                for jd in dates])
+        self.assertEqual(asyncio.run(main()), expected)
+
+    def test_lun_occult_when_glob(self):
+        expected = swe.lun_occult_when_glob(JD, swe.VENUS, FLAGS)
+        async def main():
+            return await swe.aio.lun_occult_when_glob(JD, swe.VENUS, FLAGS)
+        self.assertEqual(asyncio.run(main()), expected)
+
+    def test_heliacal_ut(self):
+        args = (JD, GEOPOS, (1013.25, 15, 40, 0), (25, 1, 0, 0, 0, 0),
+                'Venus', swe.HELIACAL_RISING, FLAGS)
+        expected = swe.heliacal_ut(*args)
+        async def main():
+            return await swe.aio.heliacal_ut(*args)
+        self.assertEqual(asyncio.run(main()), expected)
+
+    def test_errors(self):
+        self.assertRaises(RuntimeError, swe.aio.sol_eclipse_when_loc,
+                          JD, GEOPOS)
+        async def main():
+            self.assertRaises(TypeError, swe.aio.sol_eclipse_when_loc,
+                              JD, (1, 2))
+            self.assertRaises(TypeError, swe.aio.lun_occult_when_glob,
+                              JD, 1.5)
+        asyncio.run(main())
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
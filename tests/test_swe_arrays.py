@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import array
+import os
+import swisseph as swe
+import threading
+import unittest
+import warnings
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+DATES = [JD + i * 0.37 for i in range(500)]
+GEOPOS = (6.6, 46.5, 400.0)
+
+class TestSweArrays(unittest.TestCase):
+
+    def setUp(self):
+        self.nthreads = swe.get_num_threads()
+
+    def tearDown(self):
+        swe.set_num_threads(self.nthreads)
+
+    def test_calc_ut_array(self):
+        xx, retflags = swe.calc_ut_array(DATES, swe.MOON, FLAGS)
+        self.assertEqual(xx.shape, (len(DATES), 6))
+        self.assertEqual(retflags.shape, (len(DATES),))
+        for i, jd in enumerate(DATES):
+            res, ret = swe.calc_ut(jd, swe.MOON, FLAGS)
+            self.assertEqual(tuple(xx.tolist()[i]), tuple(res))
+            self.assertEqual(retflags[i], ret)
+
+    def test_threads(self):
+        swe.set_num_threads(1)
+        self.assertEqual(swe.get_num_threads(), 1)
+        xx1 = swe.calc_ut_array(array.array('d', DATES), swe.MARS, FLAGS)[0]
+        swe.set_num_threads(4)
+        xx4 = swe.calc_ut_array(array.array('d', DATES), swe.MARS, FLAGS)[0]
+        self.assertEqual(xx1.tolist(), xx4.tolist())
+        self.assertRaises(ValueError, swe.set_num_threads, 0)
+
+    def test_houses_array(self):
+        cusps, ascmc, status = swe.houses_array(DATES[:50], 46.5, 6.6, b'P',
+                                                swe.FLG_MOSEPH)
+        self.assertEqual(cusps.shape, (50, 12))
+        self.assertEqual(ascmc.shape, (50, 8))
+        self.assertEqual(status.tolist(), [0] * 50)
+        res = swe.houses_ex(DATES[10], 46.5, 6.6, b'P', swe.FLG_MOSEPH)
+        self.assertEqual(tuple(cusps.tolist()[10]), tuple(res[0]))
+        self.assertEqual(tuple(ascmc.tolist()[10]), tuple(res[1]))
+        cusps, ascmc, status = swe.houses_array(DATES[:5], 46.5, 6.6, b'G')
+        self.assertEqual(cusps.shape, (5, 36))
+
+    def test_rise_trans_array(self):
+        res, tret = swe.rise_trans_array(DATES[:20], swe.SUN, swe.CALC_RISE,
+                                         GEOPOS, flags=swe.FLG_MOSEPH)
+        self.assertEqual(res.shape, (20,))
+        r, t = swe.rise_trans(DATES[3], swe.SUN, swe.CALC_RISE, GEOPOS,
+                              flags=swe.FLG_MOSEPH)
+        self.assertEqual(res[3], r)
+        self.assertEqual(tret[3], t[0])
+
+    def test_topo_from_geopos(self):
+        swe.set_num_threads(4)
+        flags = FLAGS|swe.FLG_TOPOCTR
+        try:
+            # the observer of rise_trans is the topocentric position after
+            swe.rise_trans(JD, swe.SUN, swe.CALC_RISE, GEOPOS, flags=flags)
+            xx = swe.calc_ut_array(DATES, swe.MOON, flags)[0]
+            for i, jd in enumerate(DATES):
+                self.assertEqual(tuple(xx.tolist()[i]),
+                                 tuple(swe.calc_ut(jd, swe.MOON, flags)[0]))
+        finally:
+            swe.set_topo(0, 0, 0)
+
+    def test_rise_trans_lapse_rate(self):
+        swe.set_num_threads(4)
+        swe.set_lapse_rate(0.0098)
+        try:
+            res, tret = swe.rise_trans_array(DATES[:40], swe.SUN,
+                                             swe.CALC_RISE, GEOPOS,
+                                             flags=swe.FLG_MOSEPH)
+            for i, jd in enumerate(DATES[:40]):
+                r, t = swe.rise_trans(jd, swe.SUN, swe.CALC_RISE, GEOPOS,
+                                      flags=swe.FLG_MOSEPH)
+                self.assertEqual(res[i], r)
+                self.assertEqual(tret[i], t[0])
+        finally:
+            swe.set_lapse_rate(0.0065)
+
+    @unittest.skipUnless(hasattr(os, 'fork'), 'requires os.fork')
+    def test_fork(self):
+        swe.set_num_threads(4)
+        stop = threading.Event()
+        def target():
+            while not stop.is_set():
+                swe.calc_ut_array(DATES, swe.MOON, FLAGS)
+        t = threading.Thread(target=target)
+        t.start()
+        try:
+            with warnings.catch_warnings():
+                # forking a process with threads
+                warnings.simplefilter('ignore', DeprecationWarning)
+                for i in range(20):
+                    pid = os.fork()
+                    if pid == 0:
+                        xx = swe.calc_ut_array(DATES[:10], swe.MOON, FLAGS)[0]
+                        os._exit(0 if xx.shape == (10, 6) else 1)
+                    self.assertEqual(os.waitpid(pid, 0)[1], 0)
+        finally:
+            stop.set()
+            t.join()
+
+    def test_errors_policy(self):
+        dates = [JD, 1e9, JD + 1, 1e9]
+        self.assertRaises(swe.Error, swe.calc_ut_array, dates, swe.SUN, FLAGS)
+        errlist = []
+        xx, retflags = swe.calc_ut_array(dates, swe.SUN, FLAGS,
+                                         errors='mask', errlist=errlist)
+        self.assertEqual(retflags.tolist()[1::2], [-1, -1])
+        self.assertEqual([i for i, msg in errlist], [1, 3])
+        self.assertEqual(tuple(xx.tolist()[2]),
+                         tuple(swe.calc_ut(JD + 1, swe.SUN, FLAGS)[0]))
+        xx, retflags = swe.calc_ut_array(dates, swe.SUN, FLAGS, errors='nan')
+        self.assertTrue(all(x != x for x in xx.tolist()[3]))
+        self.assertFalse(any(x != x for x in xx.tolist()[0]))
+        cusps, ascmc, status = swe.houses_array([JD, JD + 1], 80, 0, b'P',
+                                                errors='nan')
+        self.assertEqual(status.tolist(), [-1, -1])
+        self.assertTrue(all(x != x for x in cusps.tolist()[0]))
+        self.assertRaises(ValueError, swe.calc_ut_array, dates, swe.SUN,
+                          errors='ignore')
+        self.assertRaises(TypeError, swe.calc_ut_array, dates, swe.SUN,
+                          errors='mask', errlist=())
+
+    def test_errors(self):
+        self.assertEqual(swe.calc_ut_array([], swe.SUN)[0].tolist(), [])
+        self.assertRaises(TypeError, swe.calc_ut_array, ['x'], swe.SUN)
+        self.assertRaises(TypeError, swe.calc_ut_array, None, swe.SUN)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import math
+import os
+import swisseph as swe
+import tempfile
+import unittest
+
+def atlas():
+    """Return contrib with the atlas connected, or None."""
+    try:
+        swh = swe.contrib
+        swh.atlas_connect()
+        if swh.atlas_countries_list():
+            return swh
+    except Exception:
+        pass
+    return None
+
+swh = atlas()
+
+@unittest.skipIf(swh is None, 'no atlas database')
+class TestAtlasIndex(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.countries = swh.atlas_countries_list()
+        cls.code = cls.countries[0][1]
+        cls.places = swh.atlas_search('', cls.code)
+
+    def test_cached(self):
+        idx = swh.atlas_index()
+        self.assertIsInstance(idx, swh.AtlasIndex)
+        self.assertIs(swh.atlas_index(), idx)
+        self.assertIsNot(swh.atlas_index(rebuild=True), idx)
+        self.assertGreaterEqual(len(idx), len(self.places))
+
+    def test_search(self):
+        idx = swh.atlas_index()
+        for place in self.places[:20]:
+            for loc in (place[1], place[1][:3].upper()):
+                for ctry in (self.code, self.code.lower()):
+                    res = idx.search(loc, ctry)
+                    self.assertIsInstance(res[0], swh.AtlasPlace)
+                    self.assertIn(tuple(place), [tuple(x) for x in res])
+
+    def test_records(self):
+        p = swh.atlas_index().search(self.places[0][1], self.code, limit=1)
+        self.assertEqual(len(p), 1)
+        p = p[0]
+        self.assertIsInstance(p.latitude, float)
+        self.assertIsInstance(p.longitude, float)
+        self.assertIsInstance(p.elevation, int)
+        self.assertEqual(p.countrycode, self.code)
+
+    def test_country(self):
+        idx = swh.atlas_index()
+        name = self.countries[0][0]
+        self.assertEqual(idx.search('', name[:4]), idx.search('', name))
+        self.assertEqual(len(idx.search('', self.code)), len(self.places))
+        self.assertGreaterEqual(len(idx.search(self.places[0][1])), 1)
+        self.assertEqual(idx.search('\x01no such place'), [])
+        self.assertRaises(ValueError, idx.search, 'a', limit=-1)
+
+    def test_reset(self):
+        idx = swh.atlas_index()
+        swh.atlas_close()
+        try:
+            self.assertRaises(swh.Error, swh.atlas_index)
+            self.assertTrue(len(idx.search('')) > 0) # still usable
+        finally:
+            swh.atlas_connect()
+        self.assertIsNot(swh.atlas_index(), idx)
+
+@unittest.skipIf(swh is None, 'no atlas database')
+class TestAtlasNearest(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.idx = swh.atlas_index()
+        cls.sample = [cls.idx[i] for i in range(0, len(cls.idx),
+                                                  max(1, len(cls.idx) // 20))]
+
+    def test_nearest(self):
+        for p in self.sample:
+            res = swh.atlas_nearest(p.latitude, p.longitude, k=3)
+            self.assertEqual(len(res), min(3, len(self.idx)))
+            self.assertAlmostEqual(res[0][1], 0, places=6)
+            self.assertEqual((res[0][0].latitude, res[0][0].longitude),
+                             (p.latitude, p.longitude))
+            dist = [d for _, d in res]
+            self.assertEqual(dist, sorted(dist))
+
+    def test_brute_force(self):
+        def km(lat1, lon1, lat2, lon2):
+            lat1, lon1, lat2, lon2 = map(math.radians,
+                                         (lat1, lon1, lat2, lon2))
+            h = (math.sin((lat2 - lat1) / 2) ** 2 + math.cos(lat1)
+                 * math.cos(lat2) * math.sin((lon2 - lon1) / 2) ** 2)
+            return 2 * 6371.0088 * math.asin(math.sqrt(h))
+        places = [self.idx[i] for i in range(min(len(self.idx), 2000))]
+        for lat, lon in ((0, 0), (47.4, 8.5), (-33.9, 151.2), (89, -179)):
+            near = self.idx.nearest(lat, lon)[0]
+            best = min(km(lat, lon, p.latitude, p.longitude) for p in places)
+            if len(places) == len(self.idx):
+                self.assertAlmostEqual(near[1], best, places=6)
+            else:
+                self.assertLessEqual(near[1], best + 1e-6)
+
+    def test_many(self):
+        lats = [p.latitude + 0.01 for p in self.sample] + [float('nan')]
+        lons = [p.longitude for p in self.sample] + [0]
+        places, dist = swh.atlas_nearest_many(lats, lons, k=2)
+        self.assertEqual(places.shape, (len(lats), 2))
+        self.assertEqual(dist.format, 'd')
+        for i, (lat, lon) in enumerate(zip(lats[:-1], lons[:-1])):
+            res = self.idx.nearest(lat, lon, k=2)
+            self.assertEqual(dist.tolist()[i], [d for _, d in res])
+            self.assertEqual([self.idx[j] for j in places.tolist()[i]],
+                             [p for p, _ in res])
+        self.assertEqual(places.tolist()[-1], [-1, -1])
+        self.assertTrue(all(math.isnan(d) for d in dist.tolist()[-1]))
+        self.assertRaises(ValueError, swh.atlas_nearest_many, [0], [])
+
+    def test_errors(self):
+        self.assertRaises(ValueError, swh.atlas_nearest, 0, 0, k=0)
+        self.assertRaises(ValueError, swh.atlas_nearest, 0, 0, k=1001)
+        self.assertRaises(ValueError, swh.atlas_nearest, float('nan'), 0)
+        self.assertRaises(IndexError, self.idx.__getitem__, len(self.idx))
+
+    def test_tree_file(self):
+        fd, path = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            self.idx.save_tree(path)
+            idx = swh.AtlasIndex()
+            self.assertTrue(idx.load_tree(path))
+            for p in self.sample:
+                self.assertEqual(idx.nearest(p.latitude, p.longitude, k=2),
+                    self.idx.nearest(p.latitude, p.longitude, k=2))
+            with open(path, 'r+b') as f:
+                f.write(b'X')
+            self.assertFalse(swh.AtlasIndex().load_tree(path))
+        finally:
+            os.remove(path)
+        self.assertRaises(OSError, swh.AtlasIndex().load_tree, path)
+
+@unittest.skipIf(swh is None, 'no atlas database')
+class TestAtlasSearchMany(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.idx = swh.atlas_index()
+        cls.sample = [cls.idx[i] for i in range(0, len(cls.idx),
+                                                  max(1, len(cls.idx) // 20))]
+
+    def test_search_many(self):
+        locs = [p.asciiname for p in self.sample]
+        ctrs = [p.countrycode for p in self.sample]
+        places, lats, lons, scores = swh.atlas_search_many(locs * 2, ctrs * 2)
+        n = len(locs)
+        self.assertEqual(len(places), 2 * n)
+        self.assertEqual(places.tolist()[:n], places.tolist()[n:])
+        for i, p in enumerate(self.sample):
+            best = self.idx[places[i]]
+            self.assertEqual(scores[i], 1.0)
+            self.assertEqual(best.asciiname.lower(), p.asciiname.lower())
+            self.assertEqual(best.countrycode, p.countrycode)
+            self.assertEqual((lats[i], lons[i]),
+                             (best.latitude, best.longitude))
+            self.assertIn(best, self.idx.search(p.asciiname, p.countrycode))
+
+    def test_scores(self):
+        p = self.sample[0]
+        loc = p.asciiname
+        res = swh.atlas_search_many([loc, ' %s ' % loc.upper(), loc[:2],
+                                     '\x01no such place', ''], p.countrycode)
+        places, lats, lons, scores = [x.tolist() for x in res]
+        self.assertEqual(scores[:2], [1.0, 1.0])
+        self.assertEqual(places[0], places[1])
+        self.assertTrue(0 < scores[2] <= 1)
+        self.assertEqual(places[3:], [-1, -1])
+        self.assertEqual(scores[3:], [0, 0])
+        self.assertTrue(all(math.isnan(x) for x in lats[3:] + lons[3:]))
+
+    def test_countries(self):
+        locs = [p.asciiname for p in self.sample]
+        a = swh.atlas_search_many(locs)[3].tolist()
+        b = swh.atlas_search_many(locs, None)[3].tolist()
+        c = swh.atlas_search_many(locs, '')[3].tolist()
+        self.assertEqual(a, b)
+        self.assertEqual(a, c)
+        self.assertEqual(swh.atlas_search_many([])[0].tolist(), [])
+
+    def test_errors(self):
+        self.assertRaises(TypeError, swh.atlas_search_many, 'abc', 0)
+        self.assertRaises(TypeError, swh.atlas_search_many, ['a', 1])
+        self.assertRaises(TypeError, swh.atlas_search_many, ['a'], [1])
+        self.assertRaises(ValueError, swh.atlas_search_many, ['a'], ['a', 'b'])
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
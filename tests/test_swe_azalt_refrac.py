@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 # -*- coding: utf-8 -*-
 
+import array
 import swisseph as swe
 import unittest
 
@@ -42,6 +43,22 @@ class TestSweAzaltRefrac(unittest.TestCase):
         self.assertAlmostEqual(dret[2], -0.0035866976067475092)
         self.assertAlmostEqual(dret[3], -0.5828252112086314)
 
+    def test_sequences(self):
+        xin = (317.1, 0.0, 1.0)
+        res = swe.azalt(tjdut, swe.ECL2HOR, geo, atpress, attemp, xin)
+        for g in (list(geo), array.array('d', geo),
+                  memoryview(array.array('d', geo))):
+            self.assertEqual(swe.azalt(tjdut, swe.ECL2HOR, g, atpress,
+                                       attemp, list(xin)), res)
+        g = (12, 49, 330)
+        self.assertEqual(swe.azalt(tjdut, swe.ECL2HOR, array.array('i', g),
+                                   atpress, attemp, xin),
+                         swe.azalt(tjdut, swe.ECL2HOR, g, atpress, attemp,
+                                   xin))
+        for g in (geo[:2], (12.1, '49', 330), array.array('d', geo[:2]), 12):
+            with self.assertRaises(TypeError):
+                swe.azalt(tjdut, swe.ECL2HOR, g, atpress, attemp, xin)
+
 if __name__ == '__main__':
     unittest.main()
 
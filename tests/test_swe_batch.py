@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import random
+import swisseph as swe
+import unittest
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+
+def requests():
+    reqs = []
+    for i in range(20):
+        jd = JD + (i % 7) * 1.5
+        reqs.append(('calc_ut', jd, swe.SUN + i % 3, FLAGS))
+        reqs.append(('calc', jd, swe.MARS))
+        reqs.append(('fixstar_ut', jd, 'Aldebaran', swe.FLG_MOSEPH))
+    random.Random(1).shuffle(reqs)
+    return reqs
+
+class TestSweBatch(unittest.TestCase):
+
+    def test_batch(self):
+        reqs = requests()
+        xx, retflags = swe.batch(reqs)
+        self.assertEqual(xx.shape, (len(reqs), 6))
+        self.assertEqual(retflags.shape, (len(reqs),))
+        for i, req in enumerate(reqs):
+            kind, jd, body = req[:3]
+            flags = req[3] if len(req) > 3 else swe.FLG_SWIEPH|swe.FLG_SPEED
+            if kind == 'fixstar_ut':
+                res, _, ret = swe.fixstar2_ut(body, jd, flags)
+            else:
+                res, ret = getattr(swe, kind)(jd, body, flags)
+            self.assertEqual(tuple(xx.tolist()[i]), tuple(res))
+            self.assertEqual(retflags[i], ret)
+
+    def test_errors(self):
+        self.assertEqual(swe.batch([])[0].tolist(), [])
+        self.assertRaises(TypeError, swe.batch, None)
+        self.assertRaises(TypeError, swe.batch, [1])
+        self.assertRaises(ValueError, swe.batch, [('x', JD, swe.SUN)])
+        self.assertRaises(TypeError, swe.batch, [('calc_ut', 'x', swe.SUN)])
+        self.assertRaises(TypeError, swe.batch, [('fixstar_ut', JD, 1)])
+        self.assertRaises(swe.Error, swe.batch, [('calc_ut', JD, -10)])
+
+    def test_errors_policy(self):
+        reqs = [('calc_ut', 1e9, swe.SUN, FLAGS), ('calc_ut', JD, swe.SUN),
+                ('calc_ut', 1e9, swe.SUN, FLAGS)]
+        self.assertRaises(swe.Error, swe.batch, reqs)
+        errlist = []
+        xx, retflags = swe.batch(reqs, errors='nan', errlist=errlist)
+        self.assertEqual(retflags[0], -1)
+        self.assertEqual(retflags[2], -1)
+        self.assertEqual([i for i, msg in errlist], [0, 2])
+        self.assertTrue(all(x != x for x in xx.tolist()[2]))
+        self.assertFalse(any(x != x for x in xx.tolist()[1]))
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
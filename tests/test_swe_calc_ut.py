@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 # -*- coding: utf-8 -*-
 
+import array
 import swisseph as swe
 import unittest
 
@@ -25,10 +26,52 @@ class TestSweCalcUt(unittest.TestCase):
         self.assertAlmostEqual(xx[4], 1.7232637573749195e-05)
         self.assertAlmostEqual(xx[5], -1.0220875853441474e-05)
 
+    def test_position(self):
+        xx, retflags = swe.calc_ut(2452275.499255786, swe.SUN)
+        self.assertIsInstance(xx, swe.Position)
+        self.assertEqual(tuple(xx), (xx.lon, xx.lat, xx.dist, xx.lon_speed,
+                                     xx.lat_speed, xx.dist_speed))
+        lon, lat, dist, lonspd, latspd, distspd = xx
+        self.assertEqual(lon, xx[0])
+
+    def test_out(self):
+        res = swe.calc_ut(2452275.499255786, swe.SUN)
+        out = array.array('d', bytes(48))
+        retflags = swe.calc_ut(2452275.499255786, swe.SUN, out=out)
+        self.assertEqual(retflags, res[1])
+        self.assertEqual(tuple(out), res[0])
+        view = memoryview(bytearray(56)).cast('d')
+        retflags = swe.calc_ut(2452275.499255786, swe.SUN, out=view)
+        self.assertEqual(tuple(view[:6]), res[0])
+        self.assertEqual(view[6], 0)
+        for out in (array.array('f', bytes(24)), array.array('d', bytes(40)),
+                    bytes(48), 1.0):
+            with self.assertRaises(TypeError):
+                swe.calc_ut(2452275.499255786, swe.SUN, out=out)
+
     def test_exception(self):
         with self.assertRaises(swe.Error):
             swe.calc_ut(2452275.499255786, -2)
 
+    def test_arguments(self):
+        jd = 2452275.499255786
+        res = swe.calc_ut(jd, swe.SUN, swe.FLG_SWIEPH)
+        self.assertEqual(swe.calc_ut(jd, swe.SUN, flags=swe.FLG_SWIEPH), res)
+        self.assertEqual(swe.calc_ut(planet=swe.SUN, tjdut=jd,
+                                     flags=swe.FLG_SWIEPH), res)
+        self.assertEqual(swe.calc_ut(jd, True, swe.FLG_SWIEPH),
+                         swe.calc_ut(jd, 1, swe.FLG_SWIEPH))
+        with self.assertRaises(TypeError):
+            swe.calc_ut(jd, 0.5)
+        with self.assertRaises(TypeError):
+            swe.calc_ut(jd, swe.SUN, tjdut=jd)
+        with self.assertRaises(TypeError):
+            swe.calc_ut(jd, swe.SUN, flag=0)
+        with self.assertRaises(TypeError):
+            swe.calc_ut(jd)
+        with self.assertRaises(OverflowError):
+            swe.calc_ut(jd, 2**40)
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import ctypes
+import swisseph as swe
+import threading
+import unittest
+
+D = ctypes.c_double
+I = ctypes.c_int
+P = ctypes.POINTER
+
+class CAPI(ctypes.Structure):
+    """First members of PySwe_CAPI (pyswisseph.h)."""
+    _fields_ = [
+        ('version', I),
+        ('size', ctypes.c_size_t),
+        ('calc', ctypes.CFUNCTYPE(I, D, I, I, P(D), ctypes.c_char_p)),
+        ('calc_ut', ctypes.CFUNCTYPE(I, D, I, I, P(D), ctypes.c_char_p)),
+        ('fixstar2_ut', ctypes.c_void_p),
+        ('houses_ex2', ctypes.c_void_p),
+        ('get_ayanamsa_ex_ut', ctypes.c_void_p),
+        ('deltat_ex', ctypes.c_void_p),
+        ('sidtime', ctypes.c_void_p),
+        ('julday', ctypes.CFUNCTYPE(D, I, I, I, D, I)),
+    ]
+
+def capi():
+    get = ctypes.pythonapi.PyCapsule_GetPointer
+    get.restype = ctypes.c_void_p
+    get.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    return CAPI.from_address(get(swe._C_API, b'swisseph._C_API'))
+
+class TestSweCAPI(unittest.TestCase):
+
+    def test_01(self):
+        api = capi()
+        self.assertGreaterEqual(api.version, 1)
+        self.assertGreaterEqual(api.size, ctypes.sizeof(CAPI))
+        self.assertEqual(api.julday(2000, 1, 1, 12.0, swe.GREG_CAL),
+                         swe.julday(2000, 1, 1, 12.0))
+
+    def test_calc_ut(self):
+        api = capi()
+        jd, flags = 2451545.0, swe.FLG_MOSEPH|swe.FLG_SPEED
+        expected = swe.calc_ut(jd, swe.MOON, flags)[0]
+        res = []
+        def target():
+            xx, serr = (D * 6)(), ctypes.create_string_buffer(256)
+            api.calc_ut(jd, swe.MOON, flags, xx, serr)
+            res.append(tuple(xx))
+        t = threading.Thread(target=target)
+        t.start()
+        t.join()
+        self.assertEqual(res, [tuple(expected)])
+
+    def test_settings(self):
+        api = capi()
+        jd, flags = 2451545.0, swe.FLG_MOSEPH|swe.FLG_TOPOCTR
+        swe.set_topo(10, 20, 0)
+        try:
+            # settings of another thread are not used
+            t = threading.Thread(target=swe.set_topo, args=(50, 20, 0))
+            t.start()
+            t.join()
+            expected = swe.calc_ut(jd, swe.MOON, flags)[0]
+            res = []
+            def target():
+                xx, serr = (D * 6)(), ctypes.create_string_buffer(256)
+                api.calc_ut(jd, swe.MOON, flags, xx, serr)
+                res.append(tuple(xx))
+            t = threading.Thread(target=target)
+            t.start()
+            t.join()
+            self.assertEqual(res, [tuple(expected)])
+        finally:
+            swe.set_topo(0, 0, 0)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
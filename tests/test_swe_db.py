@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import os
+import sqlite3
+import swisseph as swe
+import tempfile
+import threading
+import time
+import unittest
+
+def contrib():
+    """Return contrib, or None."""
+    try:
+        return swe.contrib
+    except Exception:
+        return None
+
+swh = contrib()
+
+USERS = [('user%d' % i, 'pswd%d' % i, 'user%d@example.org' % i, 'info %d' % i)
+         for i in range(5)]
+
+def opened(path):
+    """Return the number of file descriptors of path, or None."""
+    try:
+        fds = os.listdir('/proc/self/fd')
+    except OSError:
+        return None
+    n = 0
+    for fd in fds:
+        try:
+            if os.path.samefile(os.readlink('/proc/self/fd/' + fd), path):
+                n += 1
+        except OSError:
+            pass
+    return n
+
+@unittest.skipIf(swh is None, 'no contrib submodule')
+class TestDbPool(unittest.TestCase):
+
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.tmp.name, 'astro.db')
+        try:
+            swh.db_connect(self.path)
+        except swh.Error as e:
+            self.tmp.cleanup()
+            self.skipTest(str(e))
+        for u in USERS:
+            swh.User(*u).save()
+
+    def tearDown(self):
+        swh.db_close()
+        self.tmp.cleanup()
+
+    def test_wal(self):
+        with sqlite3.connect(self.path) as db:
+            mode = db.execute('PRAGMA journal_mode;').fetchone()[0]
+        self.assertEqual(mode.lower(), 'wal')
+
+    def users(self):
+        """Return the fields of the users, without root."""
+        return [(u.name, u.pswd, u.mail, u.info) for u in swh.User.list('idx')
+                if u.name != 'root']
+
+    def test_user_list(self):
+        lst = swh.User.list()
+        self.assertIsInstance(lst, list)
+        for u in lst:
+            self.assertIsInstance(u, swh.User)
+        self.assertEqual([u._idx for u in swh.User.list('idx')],
+                         sorted(u._idx for u in lst))
+        self.assertEqual(self.users(), USERS)
+
+    def test_pool(self):
+        n = opened(self.path)
+        if n is None:
+            self.skipTest('no /proc/self/fd')
+        self.assertEqual(self.users(), USERS)
+        # a read connection was opened, besides the one of swephelp
+        self.assertGreater(opened(self.path), n)
+        swh.db_close()
+        self.assertEqual(opened(self.path), 0)
+        swh.db_connect(self.path)
+
+    def test_long_path(self):
+        d = self.tmp.name
+        while len(d) < 400: # sqlite opens at most 512 on unix
+            d = os.path.join(d, 'x' * 100)
+        os.makedirs(d)
+        path = os.path.join(d, 'astro.db')
+        swh.db_close()
+        swh.db_connect(path)
+        swh.User(*USERS[0]).save()
+        self.assertEqual(self.users(), USERS[:1])
+        n = opened(path)
+        if n is not None:
+            self.assertGreater(n, 1)
+
+    def test_write_transaction(self):
+        db = sqlite3.connect(self.path, isolation_level=None, timeout=0)
+        try:
+            db.execute('BEGIN EXCLUSIVE;')
+            db.execute("INSERT INTO Users (name) VALUES ('pending');")
+            t = time.perf_counter()
+            self.assertEqual(self.users(), USERS)
+            self.assertLess(time.perf_counter() - t, 1)
+            db.execute('COMMIT;')
+        finally:
+            db.close()
+        self.assertEqual(self.users()[-1][0], 'pending')
+
+    def test_threads(self):
+        res, errors = [], []
+        def run():
+            try:
+                for _ in range(50):
+                    res.append(self.users())
+            except Exception as e:
+                errors.append(e)
+        threads = [threading.Thread(target=run) for _ in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(errors, [])
+        self.assertEqual(len(res), 400)
+        for r in res:
+            self.assertEqual(r, USERS)
+
+    def test_reconnect(self):
+        swh.User.list()
+        swh.db_close()
+        other = os.path.join(self.tmp.name, 'other.db')
+        swh.db_connect(other, wal=False)
+        self.assertIsInstance(swh.User.list(), list)
+        with sqlite3.connect(other) as db:
+            mode = db.execute('PRAGMA journal_mode;').fetchone()[0]
+        self.assertNotEqual(mode.lower(), 'wal')
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
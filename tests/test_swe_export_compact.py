@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import math
+import os
+import random
+import swisseph as swe
+import tempfile
+import unittest
+
+class TestSweExportCompact(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        swe.set_ephe_path()
+        fd, cls.path = tempfile.mkstemp(suffix='.ce')
+        os.close(fd)
+        swe.export_compact(cls.path, (swe.SUN, swe.MOON, swe.MARS),
+                           2451545.0, 2455197.5, 1e-5, swe.FLG_MOSEPH)
+
+    @classmethod
+    def tearDownClass(cls):
+        os.remove(cls.path)
+
+    def test_01(self):
+        ce = swe.CompactEphemeris(self.path)
+        self.assertEqual(ce.bodies, (swe.SUN, swe.MOON, swe.MARS))
+        self.assertEqual(ce.jd_start, 2451545.0)
+        self.assertEqual(ce.jd_end, 2455197.5)
+        self.assertEqual(ce.tolerance, 1e-5)
+        self.assertEqual(ce.flags, swe.FLG_MOSEPH)
+        ce.close()
+
+    def test_between_nodes(self):
+        # dates not aligned on the segments or their nodes
+        ce = swe.CompactEphemeris(self.path)
+        rnd = random.Random(1)
+        dates = [rnd.uniform(ce.jd_start, ce.jd_end) for _ in range(300)]
+        dates += [ce.jd_start, ce.jd_end]
+        tol = ce.tolerance
+        for jd in dates:
+            for pl in ce.bodies:
+                xx, retflags = ce.calc_ut(jd, pl)
+                yy, _ = swe.calc_ut(jd, pl, swe.FLG_MOSEPH|swe.FLG_SPEED)
+                self.assertEqual(retflags, swe.FLG_MOSEPH)
+                self.assertLessEqual(abs(swe.difdeg2n(xx[0], yy[0])), tol)
+                self.assertLessEqual(abs(xx[1] - yy[1]), tol)
+                self.assertLessEqual(abs(xx[2] - yy[2]),
+                                     tol * math.pi / 180 * yy[2])
+                self.assertAlmostEqual(xx[3], yy[3], places=2)
+        ce.close()
+
+    def test_returned_flags(self):
+        # without files, libswe falls back to moshier: so does the header
+        xx, ret = swe.calc_ut(2451545.0, swe.SUN, swe.FLG_SWIEPH)
+        if ret & swe.FLG_SWIEPH:
+            self.skipTest('ephemeris files found')
+        path = self.path + '.sw'
+        try:
+            swe.export_compact(path, (swe.SUN,), 2451545.0, 2451645.0, 1e-4)
+            ce = swe.CompactEphemeris(path)
+            self.assertEqual(ce.flags, swe.FLG_MOSEPH)
+            self.assertEqual(ce.calc_ut(2451600.0, swe.SUN)[1],
+                             swe.FLG_MOSEPH)
+            ce.close()
+        finally:
+            if os.path.exists(path):
+                os.remove(path)
+
+    def test_header(self):
+        path = self.path + '.sid'
+        flags = swe.FLG_MOSEPH|swe.FLG_SPEED|swe.FLG_SIDEREAL
+        swe.set_sid_mode(swe.SIDM_USER, 2451545.0, 23.5)
+        try:
+            swe.export_compact(path, (swe.SUN,), 2451545.0, 2451645.0, 1e-4,
+                               flags)
+            ce = swe.CompactEphemeris(path)
+            self.assertEqual(ce.flags, flags)
+            self.assertEqual(ce.sid_mode, (swe.SIDM_USER, 2451545.0, 23.5))
+            ce.close()
+        finally:
+            swe.set_sid_mode(swe.SIDM_FAGAN_BRADLEY)
+            if os.path.exists(path):
+                os.remove(path)
+        ce = swe.CompactEphemeris(self.path)
+        self.assertIsNone(ce.sid_mode)
+        ce.close()
+
+    def test_range(self):
+        ce = swe.CompactEphemeris(self.path)
+        with self.assertRaises(ValueError):
+            ce.calc_ut(2451544.0, swe.SUN)
+        with self.assertRaises(ValueError):
+            ce.calc_ut(2451546.0, swe.VENUS)
+
+    def test_exception(self):
+        with self.assertRaises(swe.Error):
+            swe.export_compact(self.path + '.x', (-2,), 2451545.0, 2451546.0,
+                               1e-5)
+        self.assertFalse(os.path.exists(self.path + '.x'))
+        with self.assertRaises(ValueError):
+            swe.CompactEphemeris(__file__)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 # -*- coding: utf-8 -*-
 
+import array
 import swisseph as swe
 import unittest
 
@@ -25,6 +26,13 @@ class TestSweFixstar2Ut(unittest.TestCase):
         self.assertEqual(retflags, 2306)
         self.assertEqual(retflags, flags)
 
+    def test_out(self):
+        xx, retnam, retflags = swe.fixstar2_ut('Polaris', 2452275.5)
+        out = array.array('d', bytes(48))
+        res = swe.fixstar2_ut('Polaris', 2452275.5, out=out)
+        self.assertEqual(res, (retnam, retflags))
+        self.assertEqual(tuple(out), xx)
+
     def test_notfound(self):
         with self.assertRaises(swe.Error):
             xx, retnam, retflags = swe.fixstar2_ut('xyz7', 2452275.5)
@@ -35,6 +35,18 @@ class TestSweHouses(unittest.TestCase):
         for i in range(8):
             self.assertAlmostEqual(ascmc[i], t2[i])
 
+    def test_fields(self):
+        res = swe.houses(2452275.499255786, 0, 0, b'P')
+        self.assertIsInstance(res, swe.Houses)
+        self.assertIsInstance(res, tuple)
+        self.assertIsInstance(res.ascmc, swe.Ascmc)
+        self.assertEqual(res.cusps, res[0])
+        self.assertEqual(res.ascmc.asc, res[1][swe.ASC])
+        self.assertEqual(res.ascmc.mc, res[1][swe.MC])
+        self.assertEqual(res.ascmc.polasc, res[1][swe.POLASC])
+        self.assertEqual(len(swe.houses(2452275.499255786, 0, 0, b'G').cusps),
+                         36)
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import swisseph as swe
+import unittest
+
+class TestSweImport(unittest.TestCase):
+
+    def test_constants(self):
+        self.assertEqual(swe.MOON, 1)
+        self.assertIsInstance(swe.AUNIT_TO_KM, float)
+        self.assertIsInstance(swe.FNAME_DFT, str)
+        self.assertIn('FLG_SPEED', dir(swe))
+        self.assertRaises(AttributeError, getattr, swe, 'NO_SUCH_CONSTANT')
+
+    def test_import_all(self):
+        ns = {}
+        exec('from swisseph import *', ns)
+        self.assertEqual(ns['SUN'], swe.SUN)
+        self.assertIs(ns['calc_ut'], swe.calc_ut)
+
+    def test_contrib(self):
+        self.assertIn('contrib', dir(swe))
+        from swisseph import contrib
+        self.assertIs(contrib, swe.contrib)
+        self.assertTrue(issubclass(swe.contrib.Error, Exception))
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import swisseph as swe
+import unittest
+
+JD = 2451545.0
+
+def totals(st):
+    """Sum the counters of all files."""
+    res = {}
+    for d in st.values():
+        for k, v in d.items():
+            if k != 'kind':
+                res[k] = res.get(k, 0) + v
+    return res
+
+class TestSweIoStats(unittest.TestCase):
+
+    def setUp(self):
+        # reopen the files, the first call reads a segment
+        swe.close()
+        swe.set_ephe_path()
+        xx, ret = swe.calc_ut(JD, swe.MOON, swe.FLG_SWIEPH)
+        if not ret & swe.FLG_SWIEPH:
+            self.skipTest('no ephemeris files')
+        if not swe.io_stats():
+            self.skipTest('io_stats not available')
+
+    def test_01(self):
+        swe.calc_ut(2451545.0, swe.MOON)
+        st = swe.io_stats(reset=True)
+        self.assertIsInstance(st, dict)
+        for path, d in st.items():
+            self.assertIn(d['kind'], ('planet', 'moon', 'asteroid', 'fixstar',
+                                      'jpl', 'other'))
+            self.assertGreaterEqual(d['opens'], 0)
+            self.assertGreaterEqual(d['bytes'], 0)
+        for d in swe.io_stats().values():
+            self.assertEqual(d['opens'], 0)
+            self.assertEqual(d['reads'], 0)
+            self.assertEqual(d['seeks'], 0)
+            self.assertEqual(d['segments'], 0)
+
+    def test_reads(self):
+        swe.io_stats(reset=True)
+        swe.io_cache_stats(reset=True)
+        swe.close()
+        swe.set_ephe_path()
+        swe.calc_ut(JD, swe.MOON, swe.FLG_SWIEPH)
+        t = totals(swe.io_stats())
+        self.assertGreater(t['opens'], 0)
+        self.assertGreater(t['reads'], 0)
+        self.assertGreater(t['bytes'], 0)
+        self.assertGreater(t['segments'], 0)
+        self.assertGreater(t['time'], 0)
+        c = swe.io_cache_stats()
+        self.assertEqual(c['calls'], 1)
+        self.assertEqual(c['misses'], 1)
+
+    def test_hits(self):
+        swe.calc_ut(JD, swe.MOON, swe.FLG_SWIEPH)
+        swe.io_cache_stats(reset=True)
+        t0 = totals(swe.io_stats())
+        for i in range(10):
+            swe.calc_ut(JD + i * 0.01, swe.MOON, swe.FLG_SWIEPH)
+        c = swe.io_cache_stats(reset=True)
+        self.assertEqual(c['calls'], 10)
+        self.assertEqual(c['hits'], 10)
+        self.assertEqual(c['misses'], 0)
+        self.assertEqual(totals(swe.io_stats())['segments'], t0['segments'])
+        # moshier calls are not counted
+        swe.calc_ut(JD, swe.MOON, swe.FLG_MOSEPH)
+        self.assertEqual(swe.io_cache_stats()['calls'], 0)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
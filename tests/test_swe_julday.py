@@ -10,6 +10,16 @@ class TestSweJulday(unittest.TestCase):
         jd = swe.julday(2002, 1, 1, 0, swe.GREG_CAL)
         self.assertEqual(jd, 2452275.5)
 
+    def test_arguments(self):
+        self.assertEqual(swe.julday(2002, 1, 1), 2452276.0)
+        self.assertEqual(swe.julday(2002, 1, 1, hour=0), 2452275.5)
+        self.assertEqual(swe.julday(2002, 1, 1, cal=swe.GREG_CAL, hour=0.0),
+                         2452275.5)
+        with self.assertRaises(TypeError):
+            swe.julday(2002, 1, 1.0)
+        with self.assertRaises(ValueError):
+            swe.julday(2002, 1, 1, 0, -1)
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -1,9 +1,27 @@
 #!/usr/bin/env python3
 # -*- coding: utf-8 -*-
 
+import os
 import swisseph as swe
 import unittest
 
+def se1_files():
+    """Return the se1 files of the default ephemeris path."""
+    path = os.environ.get('SE_EPHE_PATH') or \
+        '/usr/share/swisseph:/usr/local/share/swisseph'
+    res = set()
+    for d in path.split(os.pathsep):
+        if os.path.isdir(d):
+            res.update(os.path.realpath(os.path.join(d, f))
+                       for f in os.listdir(d) if f.endswith('.se1'))
+    return res
+
+def mapped(files):
+    """Wether one of the files is mapped in the process."""
+    with open('/proc/self/maps') as f:
+        return any(line.split()[-1] in files for line in f
+                   if line.rstrip().endswith('.se1'))
+
 class TestSweSetEphePath(unittest.TestCase):
 
     def test_none(self):
@@ -15,6 +33,24 @@ class TestSweSetEphePath(unittest.TestCase):
     def test_param(self):
         self.assertIsNone(swe.set_ephe_path("/path"))
 
+    def test_mmap(self):
+        files = se1_files()
+        if not files or not os.path.exists('/proc/self/maps'):
+            self.skipTest('no ephemeris files, or no /proc')
+        jds = [2452275.5 + i * 7.3 for i in range(50)]
+        swe.close()
+        swe.set_ephe_path()
+        want = [swe.calc_ut(jd, swe.MOON, swe.FLG_SWIEPH) for jd in jds]
+        swe.close()
+        self.assertIsNone(swe.set_ephe_path(mmap=True))
+        self.assertTrue(mapped(files))
+        got = [swe.calc_ut(jd, swe.MOON, swe.FLG_SWIEPH) for jd in jds]
+        self.assertEqual(got, want)
+        self.assertEqual(got[0][1], swe.FLG_SWIEPH)
+        self.assertIsNone(swe.close())
+        self.assertFalse(mapped(files))
+        self.assertIsNone(swe.set_ephe_path())
+
 if __name__ == '__main__':
     unittest.main()
 
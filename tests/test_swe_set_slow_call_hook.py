@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import swisseph as swe
+import threading
+import time
+import unittest
+
+def wait(calls, n):
+    """Let the pending calls run, the hook is called asynchronously."""
+    for i in range(1000):
+        if len(calls) >= n:
+            break
+        time.sleep(0.001)
+
+class TestSweSetSlowCallHook(unittest.TestCase):
+
+    def tearDown(self):
+        swe.set_slow_call_hook(None)
+
+    def test_01(self):
+        calls = []
+        swe.set_slow_call_hook(lambda *a: calls.append(a), 0)
+        swe.julday(2000, 1, 1, hour=12.0)
+        with self.assertRaises(TypeError):
+            swe.julday()
+        wait(calls, 2)
+        self.assertEqual(len(calls), 2)
+        name, args, kwargs, elapsed = calls[0]
+        self.assertEqual(name, 'julday')
+        self.assertEqual(args, (2000, 1, 1))
+        self.assertEqual(kwargs, {'hour': 12.0})
+        self.assertGreaterEqual(elapsed, 0)
+        self.assertEqual(calls[1][1:3], ((), None))
+
+    def test_thread(self):
+        # a slow call of a thread is reported in the main thread
+        calls = []
+        swe.set_slow_call_hook(
+            lambda *a: calls.append(threading.get_ident()), 0)
+        t = threading.Thread(target=swe.julday, args=(2000, 1, 1))
+        t.start()
+        t.join()
+        wait(calls, 1)
+        self.assertEqual(calls, [threading.main_thread().ident])
+
+    def test_threshold(self):
+        calls = []
+        swe.set_slow_call_hook(calls.append, 1e6)
+        swe.julday(2000, 1, 1)
+        swe.set_slow_call_hook(None)
+        self.assertEqual(calls, [])
+
+    def test_arguments(self):
+        with self.assertRaises(TypeError):
+            swe.set_slow_call_hook(1)
+        with self.assertRaises(ValueError):
+            swe.set_slow_call_hook(print, -1)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
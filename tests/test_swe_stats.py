@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import swisseph as swe
+import unittest
+
+class TestSweStats(unittest.TestCase):
+
+    def setUp(self):
+        swe.reset_stats()
+        swe.set_stats(True)
+
+    def tearDown(self):
+        swe.set_stats(False)
+        swe.reset_stats()
+
+    def test_01(self):
+        swe.julday(2000, 1, 1)
+        swe.julday(2000, 1, 1, hour=12.0)
+        with self.assertRaises(TypeError):
+            swe.julday()
+        st = swe.stats()['julday']
+        self.assertEqual(st['calls'], 3)
+        self.assertEqual(st['errors'], 1)
+        self.assertEqual(len(st['histogram']), 32)
+        self.assertEqual(sum(st['histogram']), 3)
+        self.assertGreater(st['time'], 0)
+
+    def test_disable(self):
+        self.assertEqual(swe.calc_ut.__name__, 'calc_ut')
+        swe.calc_ut(2451545.0, swe.SUN, swe.FLG_MOSEPH)
+        swe.set_stats(False)
+        swe.calc_ut(2451545.0, swe.SUN, swe.FLG_MOSEPH)
+        self.assertEqual(swe.stats()['calc_ut']['calls'], 1)
+        swe.reset_stats()
+        self.assertEqual(swe.stats(), {})
+
+    def test_bound_before(self):
+        # names bound before set_stats(True) are not counted (see doc)
+        swe.set_stats(False)
+        julday = swe.julday
+        swe.set_stats(True)
+        julday(2000, 1, 1)
+        self.assertNotIn('julday', swe.stats())
+        swe.julday(2000, 1, 1)
+        self.assertEqual(swe.stats()['julday']['calls'], 1)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
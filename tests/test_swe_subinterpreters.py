@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import swisseph as swe
+import unittest
+
+try:
+    import _interpreters as interpreters
+except ImportError:
+    try:
+        import _xxsubinterpreters as interpreters
+    except ImportError:
+        interpreters = None
+
+CODE = '''
+import swisseph as swe
+xx, ret = swe.calc_ut(2451545.0, swe.SUN, swe.FLG_MOSEPH)
+assert type(xx).__name__ == 'Position'
+swe.set_stats(True)
+swe.julday(2000, 1, 1)
+assert 'julday' in swe.stats()
+'''
+
+@unittest.skipIf(interpreters is None, 'no subinterpreters')
+class TestSweSubinterpreters(unittest.TestCase):
+
+    def run_code(self, code):
+        iid = interpreters.create()
+        try:
+            interpreters.run_string(iid, code)
+        finally:
+            interpreters.destroy(iid)
+
+    def test_01(self):
+        swe.reset_stats()
+        for i in range(2):
+            self.run_code(CODE)
+        # state of this interpreter is not shared
+        self.assertNotIn('julday', swe.stats())
+
+    def test_types(self):
+        self.assertIs(type(swe.calc_ut(2451545.0, swe.SUN,
+                                       swe.FLG_MOSEPH)[0]), swe.Position)
+        self.assertTrue(issubclass(swe.Error, Exception))
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import ctypes
+import os
+import struct
+import swisseph as swe
+import tempfile
+import unittest
+
+try:
+    import pyarrow
+except ImportError:
+    pyarrow = None
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+BODIES = (swe.SUN, swe.MOON, swe.MARS)
+P = ctypes.POINTER
+
+class ArrowSchema(ctypes.Structure):
+    pass
+
+ArrowSchema._fields_ = [
+    ('format', ctypes.c_char_p),
+    ('name', ctypes.c_char_p),
+    ('metadata', ctypes.c_char_p),
+    ('flags', ctypes.c_int64),
+    ('n_children', ctypes.c_int64),
+    ('children', P(P(ArrowSchema))),
+    ('dictionary', ctypes.c_void_p),
+    ('release', ctypes.c_void_p),
+    ('private_data', ctypes.c_void_p),
+]
+
+class ArrowArray(ctypes.Structure):
+    pass
+
+ArrowArray._fields_ = [
+    ('length', ctypes.c_int64),
+    ('null_count', ctypes.c_int64),
+    ('offset', ctypes.c_int64),
+    ('n_buffers', ctypes.c_int64),
+    ('n_children', ctypes.c_int64),
+    ('buffers', P(ctypes.c_void_p)),
+    ('children', P(P(ArrowArray))),
+    ('dictionary', ctypes.c_void_p),
+    ('release', ctypes.c_void_p),
+    ('private_data', ctypes.c_void_p),
+]
+
+def capsule(o, name, tp):
+    get = ctypes.pythonapi.PyCapsule_GetPointer
+    get.restype = ctypes.c_void_p
+    get.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    return tp.from_address(get(o, name))
+
+class TestSweTable(unittest.TestCase):
+
+    def test_columns(self):
+        t = swe.ephemeris_table(BODIES, JD, JD + 10, 0.5, FLAGS)
+        self.assertEqual(len(t), 20 * len(BODIES))
+        self.assertEqual(t.column_names, ('jd', 'body', 'lon', 'lat', 'dist',
+                         'lon_speed', 'lat_speed', 'dist_speed', 'retflags'))
+        jd, body = t.column('jd').tolist(), t.column('body').tolist()
+        self.assertEqual(jd[:4], [JD, JD, JD, JD + 0.5])
+        self.assertEqual(body[:4], [swe.SUN, swe.MOON, swe.MARS, swe.SUN])
+        xx, ret = swe.calc_ut(JD + 3.5, swe.MARS, FLAGS)
+        self.assertEqual(t.column('lon')[23], xx[0])
+        self.assertEqual(t.column('dist_speed')[23], xx[5])
+        self.assertEqual(t.column('retflags')[23], ret)
+        self.assertRaises(KeyError, t.column, 'x')
+        t = swe.EphemerisTable([swe.MOON], JD, JD + 1, 0.25, FLAGS, ut=False)
+        self.assertEqual(t.column('lon')[1],
+                         swe.calc(JD + 0.25, swe.MOON, FLAGS)[0][0])
+
+    def test_arrow(self):
+        t = swe.ephemeris_table(BODIES, JD, JD + 2, 1, FLAGS)
+        sc, ac = t.__arrow_c_array__()
+        schema = capsule(sc, b'arrow_schema', ArrowSchema)
+        array = capsule(ac, b'arrow_array', ArrowArray)
+        self.assertEqual(schema.format, b'+s')
+        self.assertEqual(schema.n_children, 9)
+        self.assertEqual(schema.children[2].contents.name, b'lon')
+        self.assertEqual(schema.children[2].contents.format, b'g')
+        self.assertEqual(array.length, 6)
+        self.assertEqual(array.n_children, 9)
+        lon = array.children[2].contents
+        self.assertEqual(lon.length, 6)
+        data = ctypes.cast(lon.buffers[1], P(ctypes.c_double))
+        x = t.column('lon')[4]
+        self.assertEqual(data[4], x)
+        del t # the array keeps the columns
+        self.assertEqual(data[4], x)
+        self.assertTrue(swe.EphemerisTable.__arrow_c_schema__)
+        self.assertTrue(capsule(swe.ephemeris_table(BODIES, JD, JD + 1, 1)
+                                .__arrow_c_stream__(), b'arrow_array_stream',
+                                ctypes.c_void_p * 5))
+
+    @unittest.skipIf(pyarrow is None, 'pyarrow not installed')
+    def test_pyarrow(self):
+        t = swe.ephemeris_table(BODIES, JD, JD + 2, 1, FLAGS)
+        tbl = pyarrow.table(t)
+        self.assertEqual(tbl.num_rows, 6)
+        self.assertEqual(tbl.column('lon').to_pylist(),
+                         t.column('lon').tolist())
+
+    def test_errors(self):
+        t = swe.ephemeris_table(BODIES, JD, JD, 1)
+        self.assertEqual(len(t), 0)
+        self.assertRaises(ValueError, swe.ephemeris_table, BODIES, JD, JD + 1, 0)
+        self.assertRaises(ValueError, swe.ephemeris_table, [], JD, JD + 1, 1)
+        self.assertRaises(TypeError, swe.ephemeris_table, ['x'], JD, JD + 1, 1)
+        self.assertRaises(swe.Error, swe.ephemeris_table, BODIES, 1e9 - 1,
+                          1e9, 0.5, FLAGS)
+        errlist = []
+        t = swe.ephemeris_table(BODIES, 1e9 - 1, 1e9, 0.5, FLAGS, errors='nan',
+                                errlist=errlist)
+        self.assertEqual(len(errlist), len(t))
+        self.assertTrue(all(x != x for x in t.column('lon').tolist()))
+
+    def test_write_csv(self):
+        t = swe.ephemeris_table(BODIES, JD, JD + 10, 0.25, FLAGS)
+        with tempfile.TemporaryDirectory() as d:
+            path = os.path.join(d, 't.csv')
+            n = swe.write_ephemeris_table(path, BODIES, JD, JD + 10, 0.25,
+                                          FLAGS, chunk=7)
+            self.assertEqual(n, len(t))
+            with open(path) as f:
+                rows = [l.split(',') for l in f.read().splitlines()]
+        self.assertEqual(tuple(rows[0]), t.column_names)
+        self.assertEqual(len(rows), len(t) + 1)
+        for name, conv in (('jd', float), ('body', int), ('lon', float),
+                           ('dist_speed', float), ('retflags', int)):
+            i = t.column_names.index(name)
+            self.assertEqual([conv(r[i]) for r in rows[1:]],
+                             t.column(name).tolist())
+
+    def test_write_binary(self):
+        t = swe.ephemeris_table(BODIES, JD, JD + 10, 0.25, FLAGS)
+        with tempfile.TemporaryFile() as f:
+            n = swe.write_ephemeris_table(f.fileno(), BODIES, JD, JD + 10,
+                                          0.25, FLAGS, format='binary',
+                                          chunk=25)
+            self.assertEqual(n, len(t))
+            f.seek(0)
+            data = f.read()
+        hdr = struct.unpack('=8s6i2d', data[:48])
+        self.assertEqual(hdr, (b'PYSWETB\0', 1, 0x01020304, 9, len(BODIES),
+                               FLAGS, 1, JD, 0.25))
+        pos = 48 + 8 * ((4 * len(BODIES) + 7) // 8)
+        lon = []
+        while pos < len(data):
+            k = struct.unpack('=q', data[pos:pos + 8])[0]
+            pos += 8
+            for i in range(9):
+                size = (4 if i in (1, 8) else 8) * k
+                if i == 2:
+                    lon += struct.unpack('=%dd' % k, data[pos:pos + size])
+                pos += (size + 7) // 8 * 8
+        self.assertEqual(lon, t.column('lon').tolist())
+
+    def test_write_flush(self):
+        # data buffered by the file object goes before the table
+        with tempfile.TemporaryFile('w+') as f:
+            f.write('# table\n')
+            n = swe.write_ephemeris_table(f, BODIES, JD, JD + 1, 1, FLAGS)
+            f.seek(0)
+            lines = f.read().splitlines()
+        self.assertEqual(lines[0], '# table')
+        self.assertTrue(lines[1].startswith('jd,body,'))
+        self.assertEqual(len(lines), 2 + n)
+
+    def test_write_returned_flags(self):
+        # without files, libswe falls back to moshier: so does the header
+        xx, ret = swe.calc_ut(JD, swe.SUN, swe.FLG_SWIEPH)
+        if ret & swe.FLG_SWIEPH:
+            self.skipTest('ephemeris files found')
+        with tempfile.TemporaryFile() as f:
+            swe.write_ephemeris_table(f.fileno(), BODIES, JD, JD + 1, 1,
+                                      swe.FLG_SWIEPH|swe.FLG_SPEED,
+                                      format='binary')
+            f.seek(0)
+            hdr = struct.unpack('=8s6i2d', f.read(48))
+        self.assertEqual(hdr[5], swe.FLG_MOSEPH|swe.FLG_SPEED)
+
+    def test_write_errors(self):
+        with tempfile.TemporaryDirectory() as d:
+            path = os.path.join(d, 't.csv')
+            self.assertRaises(swe.Error, swe.write_ephemeris_table, path,
+                              BODIES, 1e9 - 1, 1e9, 0.5, FLAGS)
+            self.assertFalse(os.path.exists(path))
+            errlist = []
+            swe.write_ephemeris_table(path, BODIES, 1e9 - 1, 1e9, 0.5, FLAGS,
+                                      errors='nan', errlist=errlist)
+            self.assertEqual(len(errlist), 2 * len(BODIES))
+            self.assertRaises(ValueError, swe.write_ephemeris_table, path,
+                              BODIES, JD, JD + 1, 1, format='xml')
+            self.assertRaises(OSError, swe.write_ephemeris_table,
+                              os.path.join(d, 'x', 't.csv'), BODIES, JD,
+                              JD + 1, 1)
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et
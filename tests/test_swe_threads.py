@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+import swisseph as swe
+import threading
+import unittest
+
+JD = 2451545.0
+FLAGS = swe.FLG_MOSEPH|swe.FLG_SPEED
+
+def compute(dates):
+    return [swe.calc_ut(jd, pl, FLAGS)[0]
+            for jd in dates for pl in range(swe.SUN, swe.PLUTO + 1)]
+
+class TestSweThreads(unittest.TestCase):
+
+    def run_threads(self, func, n=8):
+        res = [None] * n
+        def target(i):
+            res[i] = func(i)
+        threads = [threading.Thread(target=target, args=(i,))
+                   for i in range(n)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        return res
+
+    def test_01(self):
+        dates = [JD + i * 0.37 for i in range(200)]
+        expected = compute(dates)
+        res = self.run_threads(lambda i: compute(dates))
+        for r in res:
+            self.assertEqual(r, expected)
+
+    def test_stats(self):
+        swe.reset_stats()
+        swe.set_stats(True)
+        try:
+            self.run_threads(lambda i: [swe.julday(2000, 1, 1)
+                                        for _ in range(100)])
+            self.assertEqual(swe.stats()['julday']['calls'], 800)
+        finally:
+            swe.set_stats(False)
+            swe.reset_stats()
+
+if __name__ == '__main__':
+    unittest.main()
+
+# vi: sw=4 ts=4 et